@@ -0,0 +1,128 @@
+"""
+Run the scaling benchmark over a range of processor and thread counts
+and collect the results into a single JSON file.
+
+Strong scaling keeps the mesh size fixed while weak scaling keeps the
+mesh size per processor fixed. The collected results can be compared
+against a baseline file from a previous release to catch performance
+regressions:
+
+python run_scaling.py --mesh plate --nx 100 --ny 100 --np 1 2 4 --output new.json
+python run_scaling.py --compare old.json new.json --tol 0.1
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+
+def run_case(args, nprocs, nthreads):
+    """Run a single case of the benchmark and return the parsed result"""
+    fd, output = tempfile.mkstemp(suffix=".json")
+    os.close(fd)
+
+    cmd = args.mpirun.split() + ["-np", str(nprocs), args.exe]
+    cmd += [
+        "mesh=%s" % args.mesh,
+        "nx=%d" % args.nx,
+        "ny=%d" % args.ny,
+        "nz=%d" % args.nz,
+        "scaling=%s" % args.scaling,
+        "threads=%d" % nthreads,
+        "reps=%d" % args.reps,
+        "num_eigs=%d" % args.num_eigs,
+        "output=%s" % output,
+    ]
+    if args.no_f5:
+        cmd.append("f5=0")
+    if args.element_order:
+        cmd.append("element_order=1")
+
+    print(" ".join(cmd))
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+
+    with open(output, "r") as fp:
+        result = json.load(fp)
+    os.remove(output)
+
+    return result
+
+
+def compare(baseline, current, tol):
+    """Compare the timings and function values of two result files"""
+    base_cases = {}
+    for case in baseline["cases"]:
+        base_cases[(case["num_procs"], case["num_threads"])] = case
+
+    fail = False
+    for case in current["cases"]:
+        key = (case["num_procs"], case["num_threads"])
+        if key not in base_cases:
+            continue
+        base = base_cases[key]
+
+        for phase, timing in case["timings"].items():
+            if phase not in base["timings"]:
+                continue
+            t0 = base["timings"][phase]["max"]
+            t1 = timing["max"]
+            if t0 > 0.0 and t1 > (1.0 + tol) * t0:
+                print(
+                    "np=%d threads=%d %-12s %10.4e -> %10.4e (%+.1f%%)"
+                    % (key[0], key[1], phase, t0, t1, 100.0 * (t1 / t0 - 1.0))
+                )
+                fail = True
+
+        for name, value in case["functions"].items():
+            if name not in base["functions"]:
+                continue
+            v0 = base["functions"][name]
+            if abs(value - v0) > 1e-8 * max(abs(v0), 1.0):
+                print(
+                    "np=%d threads=%d function %s changed: %.12e -> %.12e"
+                    % (key[0], key[1], name, v0, value)
+                )
+                fail = True
+
+    return fail
+
+
+parser = argparse.ArgumentParser(description="TACS scaling benchmark driver")
+parser.add_argument("--exe", default="./scaling")
+parser.add_argument("--mpirun", default="mpirun")
+parser.add_argument("--mesh", default="plate", choices=["plate", "wingbox", "solid"])
+parser.add_argument("--nx", type=int, default=50)
+parser.add_argument("--ny", type=int, default=50)
+parser.add_argument("--nz", type=int, default=8)
+parser.add_argument("--scaling", default="strong", choices=["strong", "weak"])
+parser.add_argument("--np", type=int, nargs="+", default=[1])
+parser.add_argument("--threads", type=int, nargs="+", default=[1])
+parser.add_argument("--reps", type=int, default=3)
+parser.add_argument("--num_eigs", type=int, default=5)
+parser.add_argument("--no_f5", action="store_true", default=False)
+parser.add_argument("--element_order", action="store_true", default=False)
+parser.add_argument("--output", default="scaling_results.json")
+parser.add_argument("--compare", nargs=2, metavar=("BASELINE", "CURRENT"))
+parser.add_argument("--tol", type=float, default=0.1)
+args = parser.parse_args()
+
+if args.compare:
+    with open(args.compare[0], "r") as fp:
+        baseline = json.load(fp)
+    with open(args.compare[1], "r") as fp:
+        current = json.load(fp)
+
+    if compare(baseline, current, args.tol):
+        sys.exit(1)
+    print("No regressions found")
+else:
+    cases = []
+    for nprocs in args.np:
+        for nthreads in args.threads:
+            cases.append(run_case(args, nprocs, nthreads))
+
+    with open(args.output, "w") as fp:
+        json.dump({"cases": cases}, fp, indent=2)
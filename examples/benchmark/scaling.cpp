@@ -0,0 +1,885 @@
+/*
+  Strong and weak scaling benchmark for the full TACS analysis pipeline.
+
+  The mesh is generated in memory on the root processor and
+  partitioned with TACSCreator. The following phases are timed:
+
+  setup:         partitioning, reordering and initialization
+  residual:      residual assembly
+  jacobian:      Jacobian assembly
+  factor:        factorization of the preconditioner
+  solve:         GMRES solution of the linear system
+  functions:     evaluation of the KS failure and mass functions
+  sensitivity:   adjoint solves and total derivatives of the functions
+  modal:         Lanczos natural frequency analysis
+  buckling:      Lanczos linearized buckling analysis (shell meshes)
+  output:        writing the solution to an .f5 file
+
+  Options are passed as key=value arguments:
+
+  mesh=plate|wingbox|solid  the type of mesh (default plate)
+  nx=, ny=, nz=             the number of elements in each direction
+  scaling=strong|weak       for weak scaling, ny (plate and wingbox)
+                            or nz (solid) is multiplied by the number
+                            of processors
+  threads=                  the number of threads used for assembly
+  reps=                     the number of repetitions of the cheap phases
+  num_eigs=                 the number of eigenvalues (0 to skip)
+  ordering=ND|AMD|RCM|TACS_AMD|NATURAL
+  element_order=0|1         group the elements by type for assembly
+  f5=0|1                    write the .f5 file
+  output=file.json          write the results to a file instead of stdout
+
+  The results are written as a single JSON object containing the
+  min/max/avg time of each phase over the processors, together with
+  the function values and eigenvalues so that changes in the results
+  can be detected along with changes in performance. The max over the
+  processors of the peak memory recorded by TACS and of the process
+  peak resident set size are also written, together with the memory
+  for the preconditioner predicted in dry-run mode and the actual
+  memory used by the preconditioner.
+
+  Usage:
+  mpirun -np 4 ./scaling mesh=wingbox nx=40 ny=100 nz=8 threads=2
+*/
+
+#include "TACSBuckling.h"
+#include "TACSCreator.h"
+#include "TACSElement3D.h"
+#include "TACSHexaBasis.h"
+#include "TACSIsoShellConstitutive.h"
+#include "TACSKSFailure.h"
+#include "TACSLinearElasticity.h"
+#include "TACSMemoryTracker.h"
+#include "TACSProfiler.h"
+#include "TACSShellElementDefs.h"
+#include "TACSStructuralMass.h"
+#include "TACSToFH5.h"
+
+// The phases of the benchmark
+enum BenchmarkPhase {
+  SETUP_PHASE,
+  REORDERING_PHASE,
+  INITIALIZE_PHASE,
+  RESIDUAL_PHASE,
+  JACOBIAN_PHASE,
+  FACTOR_PHASE,
+  SOLVE_PHASE,
+  FUNCTIONS_PHASE,
+  SENSITIVITY_PHASE,
+  MODAL_PHASE,
+  BUCKLING_PHASE,
+  OUTPUT_PHASE,
+  NUM_PHASES
+};
+
+static const char *phase_names[] = {
+    "setup",     "reordering", "initialize", "residual",
+    "jacobian",  "factor",     "solve",      "functions",
+    "sensitivity", "modal",    "buckling",   "output"};
+
+/*
+  Options for the benchmark
+*/
+class BenchmarkOptions {
+ public:
+  BenchmarkOptions() {
+    mesh = "plate";
+    nx = 50;
+    ny = 50;
+    nz = 4;
+    weak = 0;
+    threads = 1;
+    reps = 3;
+    num_eigs = 5;
+    write_f5 = 1;
+    element_order = 0;
+    ordering = "ND";
+    output = NULL;
+    num_nodes = num_elements = 0;
+  }
+
+  void parse(int argc, char *argv[]) {
+    for (int k = 1; k < argc; k++) {
+      if (strncmp(argv[k], "mesh=", 5) == 0) {
+        mesh = &argv[k][5];
+      } else if (strncmp(argv[k], "ordering=", 9) == 0) {
+        ordering = &argv[k][9];
+      } else if (strncmp(argv[k], "output=", 7) == 0) {
+        output = &argv[k][7];
+      } else if (strcmp(argv[k], "scaling=weak") == 0) {
+        weak = 1;
+      } else if (strcmp(argv[k], "scaling=strong") == 0) {
+        weak = 0;
+      }
+      sscanf(argv[k], "nx=%d", &nx);
+      sscanf(argv[k], "ny=%d", &ny);
+      sscanf(argv[k], "nz=%d", &nz);
+      sscanf(argv[k], "threads=%d", &threads);
+      sscanf(argv[k], "reps=%d", &reps);
+      sscanf(argv[k], "num_eigs=%d", &num_eigs);
+      sscanf(argv[k], "f5=%d", &write_f5);
+      sscanf(argv[k], "element_order=%d", &element_order);
+    }
+    if (nx < 1) {
+      nx = 1;
+    }
+    if (ny < 1) {
+      ny = 1;
+    }
+    if (nz < 1) {
+      nz = 1;
+    }
+    if (threads < 1) {
+      threads = 1;
+    }
+    if (reps < 1) {
+      reps = 1;
+    }
+  }
+
+  int isSolid() { return strcmp(mesh, "solid") == 0; }
+
+  TACSAssembler::OrderingType getOrderingType() {
+    if (strcmp(ordering, "AMD") == 0) {
+      return TACSAssembler::AMD_ORDER;
+    } else if (strcmp(ordering, "RCM") == 0) {
+      return TACSAssembler::RCM_ORDER;
+    } else if (strcmp(ordering, "TACS_AMD") == 0) {
+      return TACSAssembler::TACS_AMD_ORDER;
+    } else if (strcmp(ordering, "NATURAL") == 0) {
+      return TACSAssembler::NATURAL_ORDER;
+    }
+    return TACSAssembler::ND_ORDER;
+  }
+
+  const char *mesh;
+  int nx, ny, nz;
+  int weak;
+  int threads;
+  int reps;
+  int num_eigs;
+  int write_f5;
+  int element_order;
+  const char *ordering;
+  const char *output;
+
+  // The size of the generated mesh
+  int num_nodes, num_elements;
+};
+
+/*
+  The global mesh data generated on the root processor
+*/
+class BenchmarkMesh {
+ public:
+  BenchmarkMesh() {
+    num_nodes = num_elements = num_components = 0;
+    num_bcs = num_loads = 0;
+    ptr = conn = ids = bcs = loads = NULL;
+    Xpts = NULL;
+  }
+  ~BenchmarkMesh() {
+    delete[] ptr;
+    delete[] conn;
+    delete[] ids;
+    delete[] bcs;
+    delete[] loads;
+    delete[] Xpts;
+  }
+
+  void allocate(int _num_nodes, int _num_elements, int nodes_per_elem) {
+    num_nodes = _num_nodes;
+    num_elements = _num_elements;
+    ptr = new int[num_elements + 1];
+    conn = new int[nodes_per_elem * num_elements];
+    ids = new int[num_elements];
+    Xpts = new TacsScalar[3 * num_nodes];
+    memset(Xpts, 0, 3 * num_nodes * sizeof(TacsScalar));
+    ptr[0] = 0;
+  }
+
+  void addElement(int elem, int id, int n, const int nodes[]) {
+    ids[elem] = id;
+    memcpy(&conn[ptr[elem]], nodes, n * sizeof(int));
+    ptr[elem + 1] = ptr[elem] + n;
+  }
+
+  int num_nodes, num_elements, num_components;
+  int *ptr, *conn, *ids;
+  TacsScalar *Xpts;
+
+  // The clamped nodes and the nodes where the load is applied
+  int num_bcs, num_loads;
+  int *bcs, *loads;
+
+  // The direction of the applied load
+  TacsScalar load_dir[3];
+};
+
+/*
+  A flat plate in the x-y plane, clamped at x = 0 and compressed by a
+  load applied at x = 1.
+*/
+void createPlate(int nx, int ny, BenchmarkMesh *mesh) {
+  const int num_components = 4;
+  mesh->num_components = num_components;
+  mesh->allocate((nx + 1) * (ny + 1), nx * ny, 4);
+
+  for (int j = 0; j <= ny; j++) {
+    for (int i = 0; i <= nx; i++) {
+      int n = i + (nx + 1) * j;
+      mesh->Xpts[3 * n] = 1.0 * i / nx;
+      mesh->Xpts[3 * n + 1] = 1.0 * j / ny;
+    }
+  }
+
+  for (int j = 0, elem = 0; j < ny; j++) {
+    for (int i = 0; i < nx; i++, elem++) {
+      int n = i + (nx + 1) * j;
+      int nodes[4] = {n, n + 1, n + nx + 1, n + nx + 2};
+      mesh->addElement(elem, (num_components * j) / ny, 4, nodes);
+    }
+  }
+
+  mesh->num_bcs = mesh->num_loads = ny + 1;
+  mesh->bcs = new int[ny + 1];
+  mesh->loads = new int[ny + 1];
+  for (int j = 0; j <= ny; j++) {
+    mesh->bcs[j] = (nx + 1) * j;
+    mesh->loads[j] = nx + (nx + 1) * j;
+  }
+  mesh->load_dir[0] = -1.0;
+  mesh->load_dir[1] = 0.0;
+  mesh->load_dir[2] = 0.0;
+}
+
+/*
+  A rectangular wing box with nc elements along the chord, nh elements
+  through the height and ns elements along the span. Ribs are placed
+  every four elements along the span. The box is clamped at the root
+  and loaded in the vertical direction at the tip.
+*/
+void createWingBox(int nc, int ns, int nh, BenchmarkMesh *mesh) {
+  const double chord = 1.0, height = 0.15, span = 5.0;
+  const int rib_spacing = 4;
+
+  // The number of nodes around the perimeter of the cross-section
+  int np = 2 * (nc + nh);
+  int num_ribs = ns / rib_spacing + 1;
+  int num_rib_interior = (nc - 1) * (nh - 1);
+
+  // The skins and spars are components 0 to 3, the ribs are component 4
+  mesh->num_components = 5;
+  int num_nodes = np * (ns + 1) + num_ribs * num_rib_interior;
+  int num_elements = np * ns + num_ribs * nc * nh;
+  mesh->allocate(num_nodes, num_elements, 4);
+
+  // Set the node locations around the perimeter at each station
+  for (int s = 0; s <= ns; s++) {
+    for (int p = 0; p < np; p++) {
+      double x, z;
+      if (p < nc) {
+        x = chord * p / nc;
+        z = 0.0;
+      } else if (p < nc + nh) {
+        x = chord;
+        z = height * (p - nc) / nh;
+      } else if (p < 2 * nc + nh) {
+        x = chord * (2 * nc + nh - p) / nc;
+        z = height;
+      } else {
+        x = 0.0;
+        z = height * (np - p) / nh;
+      }
+      int n = p + np * s;
+      mesh->Xpts[3 * n] = x;
+      mesh->Xpts[3 * n + 1] = span * s / ns;
+      mesh->Xpts[3 * n + 2] = z;
+    }
+  }
+
+  // Add the skin and spar elements
+  int elem = 0;
+  for (int s = 0; s < ns; s++) {
+    for (int p = 0; p < np; p++, elem++) {
+      int q = (p + 1) % np;
+      int nodes[4] = {p + np * s, q + np * s, p + np * (s + 1),
+                      q + np * (s + 1)};
+      int id = 0;
+      if (p >= nc + nh + nc) {
+        id = 3;
+      } else if (p >= nc + nh) {
+        id = 2;
+      } else if (p >= nc) {
+        id = 1;
+      }
+      mesh->addElement(elem, id, 4, nodes);
+    }
+  }
+
+  // Add the ribs
+  int *rib = new int[(nc + 1) * (nh + 1)];
+  for (int r = 0; r < num_ribs; r++) {
+    int s = r * rib_spacing;
+    int offset = np * (ns + 1) + r * num_rib_interior;
+    for (int k = 0; k <= nh; k++) {
+      for (int i = 0; i <= nc; i++) {
+        int p = -1;
+        if (k == 0) {
+          p = i;
+        } else if (i == nc) {
+          p = nc + k;
+        } else if (k == nh) {
+          p = nc + nh + (nc - i);
+        } else if (i == 0) {
+          p = (2 * nc + nh + (nh - k)) % np;
+        }
+
+        int n = 0;
+        if (p >= 0) {
+          n = p + np * s;
+        } else {
+          n = offset + (i - 1) + (nc - 1) * (k - 1);
+          mesh->Xpts[3 * n] = chord * i / nc;
+          mesh->Xpts[3 * n + 1] = span * s / ns;
+          mesh->Xpts[3 * n + 2] = height * k / nh;
+        }
+        rib[i + (nc + 1) * k] = n;
+      }
+    }
+
+    for (int k = 0; k < nh; k++) {
+      for (int i = 0; i < nc; i++, elem++) {
+        int n = i + (nc + 1) * k;
+        int nodes[4] = {rib[n], rib[n + 1], rib[n + nc + 1], rib[n + nc + 2]};
+        mesh->addElement(elem, 4, 4, nodes);
+      }
+    }
+  }
+  delete[] rib;
+
+  mesh->num_bcs = mesh->num_loads = np;
+  mesh->bcs = new int[np];
+  mesh->loads = new int[np];
+  for (int p = 0; p < np; p++) {
+    mesh->bcs[p] = p;
+    mesh->loads[p] = p + np * ns;
+  }
+  mesh->load_dir[0] = 0.0;
+  mesh->load_dir[1] = 0.0;
+  mesh->load_dir[2] = 1.0;
+}
+
+/*
+  A solid column clamped at z = 0 and loaded axially at the top
+*/
+void createSolid(int nx, int ny, int nz, BenchmarkMesh *mesh) {
+  const int num_components = 4;
+  mesh->num_components = num_components;
+  mesh->allocate((nx + 1) * (ny + 1) * (nz + 1), nx * ny * nz, 8);
+
+  const double lx = 1.0, ly = 1.0, lz = 1.0 * nz / nx;
+  for (int k = 0; k <= nz; k++) {
+    for (int j = 0; j <= ny; j++) {
+      for (int i = 0; i <= nx; i++) {
+        int n = i + (nx + 1) * (j + (ny + 1) * k);
+        mesh->Xpts[3 * n] = lx * i / nx;
+        mesh->Xpts[3 * n + 1] = ly * j / ny;
+        mesh->Xpts[3 * n + 2] = lz * k / nz;
+      }
+    }
+  }
+
+  for (int k = 0, elem = 0; k < nz; k++) {
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++, elem++) {
+        int nodes[8];
+        for (int kk = 0, c = 0; kk < 2; kk++) {
+          for (int jj = 0; jj < 2; jj++) {
+            for (int ii = 0; ii < 2; ii++, c++) {
+              nodes[c] = (i + ii) + (nx + 1) * ((j + jj) + (ny + 1) * (k + kk));
+            }
+          }
+        }
+        mesh->addElement(elem, (num_components * k) / nz, 8, nodes);
+      }
+    }
+  }
+
+  int nface = (nx + 1) * (ny + 1);
+  mesh->num_bcs = mesh->num_loads = nface;
+  mesh->bcs = new int[nface];
+  mesh->loads = new int[nface];
+  for (int n = 0; n < nface; n++) {
+    mesh->bcs[n] = n;
+    mesh->loads[n] = n + nface * nz;
+  }
+  mesh->load_dir[0] = 0.0;
+  mesh->load_dir[1] = 0.0;
+  mesh->load_dir[2] = -1.0;
+}
+
+/*
+  Create the elements for each component
+*/
+void createElements(int solid, int num_components, TACSElement **elems) {
+  TacsScalar rho = 2700.0, specific_heat = 921.0;
+  TacsScalar E = 70e9, nu = 0.3, ys = 270e6;
+  TacsScalar cte = 24e-6, kappa = 230.0;
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(rho, specific_heat, E, nu, ys, cte, kappa);
+
+  if (solid) {
+    TACSElementBasis *basis = new TACSLinearHexaBasis();
+    for (int i = 0; i < num_components; i++) {
+      TACSSolidConstitutive *con =
+          new TACSSolidConstitutive(props, 1.0, i, 0.1, 10.0);
+      TACSLinearElasticity3D *model =
+          new TACSLinearElasticity3D(con, TACS_LINEAR_STRAIN);
+      elems[i] = new TACSElement3D(model, basis);
+    }
+  } else {
+    TACSShellTransform *transform = new TACSShellNaturalTransform();
+    for (int i = 0; i < num_components; i++) {
+      TACSShellConstitutive *con =
+          new TACSIsoShellConstitutive(props, 0.01, i, 1e-3, 0.1);
+      elems[i] = new TACSQuad4Shell(transform, con);
+    }
+  }
+}
+
+/*
+  Record the time for one phase on this processor
+*/
+class BenchmarkTimer {
+ public:
+  BenchmarkTimer(MPI_Comm _comm) {
+    comm = _comm;
+    for (int i = 0; i < NUM_PHASES; i++) {
+      times[i] = -1.0;
+    }
+  }
+  void start() {
+    MPI_Barrier(comm);
+    t0 = MPI_Wtime();
+  }
+  void stop(BenchmarkPhase phase, int reps = 1) {
+    times[phase] = (MPI_Wtime() - t0) / reps;
+  }
+  void set(BenchmarkPhase phase, double t) { times[phase] = t; }
+
+  MPI_Comm comm;
+  double t0;
+  double times[NUM_PHASES];
+};
+
+/*
+  Write the results as a JSON object
+*/
+void writeResults(FILE *fp, BenchmarkOptions *opts, int size,
+                  TACSAssembler *assembler, double tmin[], double tmax[],
+                  double tavg[], int num_funcs, const char *func_names[],
+                  TacsScalar fvals[], int num_freqs, TacsScalar freqs[],
+                  int num_buckling, TacsScalar buckling[], double mem[]) {
+  fprintf(fp, "{\n");
+  fprintf(fp, "  \"benchmark\": \"tacs_scaling\",\n");
+#ifdef TACS_USE_COMPLEX
+  fprintf(fp, "  \"scalar\": \"complex\",\n");
+#else
+  fprintf(fp, "  \"scalar\": \"real\",\n");
+#endif
+  fprintf(fp, "  \"mesh\": \"%s\",\n", opts->mesh);
+  fprintf(fp, "  \"scaling\": \"%s\",\n", opts->weak ? "weak" : "strong");
+  fprintf(fp, "  \"nx\": %d,\n  \"ny\": %d,\n  \"nz\": %d,\n", opts->nx,
+          opts->ny, opts->nz);
+  fprintf(fp, "  \"ordering\": \"%s\",\n", opts->ordering);
+  fprintf(fp, "  \"element_order\": %d,\n", opts->element_order);
+  fprintf(fp, "  \"num_procs\": %d,\n", size);
+  fprintf(fp, "  \"num_threads\": %d,\n", opts->threads);
+  fprintf(fp, "  \"reps\": %d,\n", opts->reps);
+  fprintf(fp, "  \"num_elements\": %d,\n", opts->num_elements);
+  fprintf(fp, "  \"num_nodes\": %d,\n", opts->num_nodes);
+  fprintf(fp, "  \"num_dof\": %d,\n",
+          opts->num_nodes * assembler->getVarsPerNode());
+
+  fprintf(fp, "  \"timings\": {\n");
+  int first = 1;
+  for (int i = 0; i < NUM_PHASES; i++) {
+    if (tmax[i] >= 0.0) {
+      fprintf(fp, "%s    \"%s\": {\"min\": %.6e, \"max\": %.6e, \"avg\": %.6e}",
+              first ? "" : ",\n", phase_names[i], tmin[i], tmax[i], tavg[i]);
+      first = 0;
+    }
+  }
+  fprintf(fp, "\n  },\n");
+
+  const char *mem_names[] = {"peak", "process_peak", "pc_predicted",
+                             "pc_actual"};
+  fprintf(fp, "  \"memory\": {");
+  for (int i = 0; i < 4; i++) {
+    fprintf(fp, "%s\"%s\": %.0f", i == 0 ? "" : ", ", mem_names[i], mem[i]);
+  }
+  fprintf(fp, "},\n");
+
+  fprintf(fp, "  \"functions\": {");
+  for (int i = 0; i < num_funcs; i++) {
+    fprintf(fp, "%s\"%s\": %.15e", i == 0 ? "" : ", ", func_names[i],
+            TacsRealPart(fvals[i]));
+  }
+  fprintf(fp, "},\n");
+
+  fprintf(fp, "  \"frequencies\": [");
+  for (int i = 0; i < num_freqs; i++) {
+    fprintf(fp, "%s%.15e", i == 0 ? "" : ", ", TacsRealPart(freqs[i]));
+  }
+  fprintf(fp, "],\n");
+
+  fprintf(fp, "  \"buckling\": [");
+  for (int i = 0; i < num_buckling; i++) {
+    fprintf(fp, "%s%.15e", i == 0 ? "" : ", ", TacsRealPart(buckling[i]));
+  }
+  fprintf(fp, "]\n");
+  fprintf(fp, "}\n");
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+  MPI_Comm comm = MPI_COMM_WORLD;
+
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  BenchmarkOptions opts;
+  opts.parse(argc, argv);
+
+  // Scale the problem with the number of processors
+  int nx = opts.nx, ny = opts.ny, nz = opts.nz;
+  if (opts.weak) {
+    if (opts.isSolid()) {
+      nz *= size;
+    } else {
+      ny *= size;
+    }
+  }
+
+  int vars_per_node = 6;
+  if (opts.isSolid()) {
+    vars_per_node = 3;
+  }
+
+  // Create the mesh on the root processor
+  BenchmarkMesh mesh;
+  if (rank == 0) {
+    if (opts.isSolid()) {
+      createSolid(nx, ny, nz, &mesh);
+    } else if (strcmp(opts.mesh, "wingbox") == 0) {
+      createWingBox(nx, ny, nz, &mesh);
+    } else {
+      createPlate(nx, ny, &mesh);
+    }
+  }
+  MPI_Bcast(&mesh.num_components, 1, MPI_INT, 0, comm);
+  MPI_Bcast(&mesh.num_nodes, 1, MPI_INT, 0, comm);
+  MPI_Bcast(&mesh.num_elements, 1, MPI_INT, 0, comm);
+  MPI_Bcast(mesh.load_dir, 3, TACS_MPI_TYPE, 0, comm);
+  opts.num_nodes = mesh.num_nodes;
+  opts.num_elements = mesh.num_elements;
+
+  TACSCreator *creator = new TACSCreator(comm, vars_per_node);
+  creator->incref();
+  if (rank == 0) {
+    creator->setGlobalConnectivity(mesh.num_nodes, mesh.num_elements, mesh.ptr,
+                                   mesh.conn, mesh.ids);
+    creator->setBoundaryConditions(mesh.num_bcs, mesh.bcs);
+    creator->setNodes(mesh.Xpts);
+  }
+  TACSElement **elems = new TACSElement *[mesh.num_components];
+  createElements(opts.isSolid(), mesh.num_components, elems);
+  creator->setElements(mesh.num_components, elems);
+  delete[] elems;
+  creator->setReorderingType(opts.getOrderingType(),
+                             TACSAssembler::DIRECT_SCHUR);
+
+  BenchmarkTimer timer(comm);
+
+  // Create the assembler. The profiler is used to time the reordering
+  // and initialization within the setup.
+  TACSProfiler::setEnabled(1);
+  timer.start();
+  TACSAssembler *assembler = creator->createTACS();
+  assembler->incref();
+  timer.stop(SETUP_PHASE);
+  timer.set(REORDERING_PHASE,
+            TACSProfiler::getTime("TACSAssembler::computeReordering"));
+  timer.set(INITIALIZE_PHASE,
+            TACSProfiler::getTime("TACSAssembler::initialize"));
+  TACSProfiler::setEnabled(0);
+  assembler->setNumThreads(opts.threads);
+  if (opts.element_order) {
+    assembler->computeElementOrdering();
+  }
+
+  // Convert the loaded nodes to the partitioned node numbers
+  MPI_Bcast(&mesh.num_loads, 1, MPI_INT, 0, comm);
+  int *load_nodes = new int[mesh.num_loads];
+  if (rank == 0) {
+    const int *new_nodes;
+    creator->getNodeNums(&new_nodes);
+    for (int i = 0; i < mesh.num_loads; i++) {
+      load_nodes[i] = new_nodes[mesh.loads[i]];
+    }
+  }
+  MPI_Bcast(load_nodes, mesh.num_loads, MPI_INT, 0, comm);
+
+  // Apply the reordering and set the load on the nodes owned by this
+  // processor. Nodes owned by other processors are set to -1.
+  assembler->reorderNodes(mesh.num_loads, load_nodes);
+  TACSBVec *force = assembler->createVec();
+  force->incref();
+  TacsScalar f[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  for (int j = 0; j < 3; j++) {
+    f[j] = 1e3 * mesh.load_dir[j] / mesh.num_loads;
+  }
+  for (int i = 0; i < mesh.num_loads; i++) {
+    if (load_nodes[i] >= 0) {
+      force->setValues(1, &load_nodes[i], f, TACS_INSERT_VALUES);
+    }
+  }
+  delete[] load_nodes;
+  assembler->applyBCs(force);
+
+  // Create the matrix, preconditioner and solver
+  TACSSchurMat *mat = assembler->createSchurMat();
+  mat->incref();
+  int lev_fill = 10000, reorder_schur = 1;
+  double fill = 10.0;
+
+  // Predict the memory for the preconditioner before creating it
+  double mem[4];
+  TACSMemoryTracker::setDryRun(1);
+  TACSSchurPc *dry_pc = new TACSSchurPc(mat, lev_fill, fill, reorder_schur);
+  dry_pc->incref();
+  mem[2] = (TACSMemoryTracker::getCurrentBytes("TACSSchurPc", 1) +
+            TACSMemoryTracker::getCurrentBytes("TACSBlockCyclicMat", 1));
+  dry_pc->decref();
+  TACSMemoryTracker::setDryRun(0);
+
+  TACSSchurPc *pc = new TACSSchurPc(mat, lev_fill, fill, reorder_schur);
+  pc->incref();
+  mem[3] = (TACSMemoryTracker::getCurrentBytes("TACSSchurPc") +
+            TACSMemoryTracker::getCurrentBytes("TACSBlockCyclicMat"));
+  int gmres_iters = 15, nrestart = 2, is_flexible = 0;
+  GMRES *ksm = new GMRES(mat, pc, gmres_iters, nrestart, is_flexible);
+  ksm->incref();
+  ksm->setTolerances(1e-12, 1e-30);
+
+  TACSBVec *res = assembler->createVec();
+  TACSBVec *ans = assembler->createVec();
+  res->incref();
+  ans->incref();
+
+  assembler->zeroVariables();
+  timer.start();
+  for (int k = 0; k < opts.reps; k++) {
+    assembler->assembleRes(res);
+  }
+  timer.stop(RESIDUAL_PHASE, opts.reps);
+
+  timer.start();
+  for (int k = 0; k < opts.reps; k++) {
+    assembler->assembleJacobian(1.0, 0.0, 0.0, res, mat);
+  }
+  timer.stop(JACOBIAN_PHASE, opts.reps);
+
+  timer.start();
+  for (int k = 0; k < opts.reps; k++) {
+    pc->factor();
+  }
+  timer.stop(FACTOR_PHASE, opts.reps);
+
+  // Solve K*u = f for the static solution
+  res->axpy(-1.0, force);
+  timer.start();
+  for (int k = 0; k < opts.reps; k++) {
+    ksm->solve(res, ans);
+  }
+  timer.stop(SOLVE_PHASE, opts.reps);
+  ans->scale(-1.0);
+  assembler->setVariables(ans);
+
+  // Evaluate the functions
+  const int num_funcs = 2;
+  const char *func_names[num_funcs] = {"ks_failure", "mass"};
+  TACSFunction *funcs[num_funcs];
+  funcs[0] = new TACSKSFailure(assembler, 100.0);
+  funcs[1] = new TACSStructuralMass(assembler);
+  TacsScalar fvals[num_funcs];
+  for (int i = 0; i < num_funcs; i++) {
+    funcs[i]->incref();
+  }
+
+  timer.start();
+  for (int k = 0; k < opts.reps; k++) {
+    assembler->evalFunctions(num_funcs, funcs, fvals);
+  }
+  timer.stop(FUNCTIONS_PHASE, opts.reps);
+
+  // Evaluate the total derivatives using the adjoint method
+  TACSBVec *dfdu[num_funcs], *adjoint[num_funcs];
+  TACSBVec *dfdx[num_funcs], *dfdX[num_funcs];
+  for (int i = 0; i < num_funcs; i++) {
+    dfdu[i] = assembler->createVec();
+    adjoint[i] = assembler->createVec();
+    dfdx[i] = assembler->createDesignVec();
+    dfdX[i] = assembler->createNodeVec();
+    dfdu[i]->incref();
+    adjoint[i]->incref();
+    dfdx[i]->incref();
+    dfdX[i]->incref();
+  }
+
+  timer.start();
+  for (int k = 0; k < opts.reps; k++) {
+    for (int i = 0; i < num_funcs; i++) {
+      dfdu[i]->zeroEntries();
+      dfdx[i]->zeroEntries();
+      dfdX[i]->zeroEntries();
+    }
+    assembler->addSVSens(1.0, 0.0, 0.0, num_funcs, funcs, dfdu);
+    for (int i = 0; i < num_funcs; i++) {
+      ksm->solve(dfdu[i], adjoint[i]);
+    }
+    assembler->addDVSens(1.0, num_funcs, funcs, dfdx);
+    assembler->addAdjointResProducts(-1.0, num_funcs, adjoint, dfdx);
+    assembler->addXptSens(1.0, num_funcs, funcs, dfdX);
+    assembler->addAdjointResXptSensProducts(-1.0, num_funcs, adjoint, dfdX);
+    for (int i = 0; i < num_funcs; i++) {
+      dfdx[i]->beginSetValues(TACS_ADD_VALUES);
+      dfdX[i]->beginSetValues(TACS_ADD_VALUES);
+      dfdx[i]->endSetValues(TACS_ADD_VALUES);
+      dfdX[i]->endSetValues(TACS_ADD_VALUES);
+    }
+  }
+  timer.stop(SENSITIVITY_PHASE, opts.reps);
+
+  // Write the output file
+  if (opts.write_f5) {
+    ElementType etype = TACS_BEAM_OR_SHELL_ELEMENT;
+    if (opts.isSolid()) {
+      etype = TACS_SOLID_ELEMENT;
+    }
+    int write_flag = (TACS_OUTPUT_CONNECTIVITY | TACS_OUTPUT_NODES |
+                      TACS_OUTPUT_DISPLACEMENTS | TACS_OUTPUT_STRAINS |
+                      TACS_OUTPUT_STRESSES | TACS_OUTPUT_EXTRAS);
+    TACSToFH5 *f5 = new TACSToFH5(assembler, etype, write_flag);
+    f5->incref();
+    timer.start();
+    f5->writeToFile("scaling_benchmark.f5");
+    timer.stop(OUTPUT_PHASE);
+    f5->decref();
+  }
+
+  // Perform the modal and buckling analysis
+  int num_freqs = 0, num_buckling = 0;
+  TacsScalar *freqs = NULL, *buckling = NULL;
+  if (opts.num_eigs > 0) {
+    int max_lanczos = 4 * opts.num_eigs + 20;
+    double eig_tol = 1e-8;
+
+    TACSSchurMat *mmat = assembler->createSchurMat();
+    TACSFrequencyAnalysis *freq = new TACSFrequencyAnalysis(
+        assembler, 0.0, mmat, mat, ksm, max_lanczos, opts.num_eigs, eig_tol);
+    freq->incref();
+    timer.start();
+    freq->solve();
+    timer.stop(MODAL_PHASE);
+
+    num_freqs = opts.num_eigs;
+    freqs = new TacsScalar[num_freqs];
+    for (int i = 0; i < num_freqs; i++) {
+      TacsScalar error;
+      freqs[i] = freq->extractEigenvalue(i, &error);
+    }
+    freq->decref();
+
+    if (!opts.isSolid()) {
+      TACSSchurMat *kmat = assembler->createSchurMat();
+      TACSSchurMat *gmat = assembler->createSchurMat();
+      TACSLinearBuckling *buck =
+          new TACSLinearBuckling(assembler, 10.0, gmat, kmat, mat, ksm,
+                                 max_lanczos, opts.num_eigs, eig_tol);
+      buck->incref();
+      timer.start();
+      buck->solve(force);
+      timer.stop(BUCKLING_PHASE);
+
+      num_buckling = opts.num_eigs;
+      buckling = new TacsScalar[num_buckling];
+      for (int i = 0; i < num_buckling; i++) {
+        TacsScalar error;
+        buckling[i] = buck->extractEigenvalue(i, &error);
+      }
+      buck->decref();
+    }
+  }
+
+  // Compute the min/max/avg times over all processors
+  double tmin[NUM_PHASES], tmax[NUM_PHASES], tavg[NUM_PHASES];
+  MPI_Reduce(timer.times, tmin, NUM_PHASES, MPI_DOUBLE, MPI_MIN, 0, comm);
+  MPI_Reduce(timer.times, tmax, NUM_PHASES, MPI_DOUBLE, MPI_MAX, 0, comm);
+  MPI_Reduce(timer.times, tavg, NUM_PHASES, MPI_DOUBLE, MPI_SUM, 0, comm);
+
+  // Compute the max memory over all processors
+  mem[0] = TACSMemoryTracker::getPeakBytes();
+  mem[1] = TACSMemoryTracker::getProcessPeakBytes();
+  double mem_max[4];
+  MPI_Reduce(mem, mem_max, 4, MPI_DOUBLE, MPI_MAX, 0, comm);
+
+  if (rank == 0) {
+    for (int i = 0; i < NUM_PHASES; i++) {
+      tavg[i] /= size;
+    }
+
+    FILE *fp = stdout;
+    if (opts.output) {
+      fp = fopen(opts.output, "w");
+      if (!fp) {
+        fprintf(stderr, "scaling: Could not open file %s\n", opts.output);
+        fp = stdout;
+      }
+    }
+    writeResults(fp, &opts, size, assembler, tmin, tmax, tavg, num_funcs,
+                 func_names, fvals, num_freqs, freqs, num_buckling, buckling,
+                 mem_max);
+    if (fp != stdout) {
+      fclose(fp);
+    }
+  }
+
+  if (freqs) {
+    delete[] freqs;
+  }
+  if (buckling) {
+    delete[] buckling;
+  }
+  for (int i = 0; i < num_funcs; i++) {
+    funcs[i]->decref();
+    dfdu[i]->decref();
+    adjoint[i]->decref();
+    dfdx[i]->decref();
+    dfdX[i]->decref();
+  }
+  force->decref();
+  res->decref();
+  ans->decref();
+  ksm->decref();
+  pc->decref();
+  mat->decref();
+  assembler->decref();
+  creator->decref();
+
+  MPI_Finalize();
+  return 0;
+}
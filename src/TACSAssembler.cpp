@@ -18,7 +18,12 @@
 
 #include "TACSAssembler.h"
 
+#include <limits.h>
+
+#include <typeinfo>
+
 #include "TACSElementVerification.h"
+#include "TACSProfiler.h"
 #include "TacsUtilities.h"
 
 // Reordering implementation
@@ -69,6 +74,12 @@ TACSAssembler::TACSAssembler(MPI_Comm _tacs_comm, int _varsPerNode,
   tacsPInfo = new TACSAssemblerPthreadInfo();
   numCompletedElements = 0;
 
+  // The arenas are allocated on the first assembly call
+  numArenasInUse = 0;
+  for (int k = 0; k < TACSThreadInfo::TACS_MAX_NUM_THREADS; k++) {
+    threadArenas[k] = NULL;
+  }
+
   // copy data to be used later in the program
   varsPerNode = _varsPerNode;
   numElements = _numElements;
@@ -164,6 +175,13 @@ TACSAssembler::TACSAssembler(MPI_Comm _tacs_comm, int _varsPerNode,
   // Set the local element data to NULL
   elementData = NULL;
   elementIData = NULL;
+
+  // The elements are assembled in their natural order by default
+  numElementGroups = 0;
+  elementGroupPtr = NULL;
+  elementOrder = NULL;
+  elementOrderNodeIndex = NULL;
+  elementOrderTacsNodes = NULL;
   elementSensData = NULL;
   elementSensIData = NULL;
 
@@ -275,6 +293,12 @@ TACSAssembler::~TACSAssembler() {
   if (elementIData) {
     delete[] elementIData;
   }
+  if (elementOrder) {
+    delete[] elementGroupPtr;
+    delete[] elementOrder;
+    delete[] elementOrderNodeIndex;
+    delete[] elementOrderTacsNodes;
+  }
   if (elementSensData) {
     delete[] elementSensData;
   }
@@ -293,12 +317,24 @@ TACSAssembler::~TACSAssembler() {
     ddvars0->decref();
   }
 
+  // Free the arenas for the temporary arrays
+  for (int k = 0; k < TACSThreadInfo::TACS_MAX_NUM_THREADS; k++) {
+    if (threadArenas[k]) {
+      threadArenas[k]->decref();
+    }
+  }
+
   // Decref the thread information class
   thread_info->decref();
 }
 
 const char *TACSAssembler::tacsName = "TACSAssembler";
 
+/**
+   Return the name of the TACSAssembler object
+*/
+const char *TACSAssembler::getObjectName() { return tacsName; }
+
 /**
    Return the MPI communicator for the TACSAssembler object
 
@@ -1122,6 +1158,7 @@ int TACSAssembler::computeExtNodes() {
 */
 void TACSAssembler::computeReordering(OrderingType order_type,
                                       MatrixOrderingType mat_type) {
+  TACS_PROFILE_SCOPE("TACSAssembler::computeReordering");
   // Return if the element connectivity not set
   if (!elementNodeIndex) {
     fprintf(stderr, "[%d] Must define element connectivity before reordering\n",
@@ -2517,6 +2554,7 @@ int TACSAssembler::computeCouplingElements(int **_couplingElems) {
   @return Fail flag indicating if a failure occured
 */
 int TACSAssembler::initialize() {
+  TACS_PROFILE_SCOPE("TACSAssembler::initialize");
   if (meshInitializedFlag) {
     fprintf(stderr, "[%d] Cannot call initialize() more than once!\n", mpiRank);
     return 1;
@@ -2615,6 +2653,18 @@ int TACSAssembler::initialize() {
   elementSensData = new TacsScalar[designVarsPerNode * maxElementDesignVars];
   elementSensIData = new int[maxElementDesignVars];
 
+  // Record the memory for the connectivity and the working arrays,
+  // and attribute the state vectors to this object
+  int connSize = numElements + 1 + elementNodeIndex[numElements];
+  double bytes = (connSize + idataSize + maxElementDesignVars) * sizeof(int);
+  bytes += (1.0 * dataSize + designVarsPerNode * maxElementDesignVars) *
+           sizeof(TacsScalar);
+  addMemoryUsage(bytes);
+  varsVec->setMemoryOwner(tacsName);
+  dvarsVec->setMemoryOwner(tacsName);
+  ddvarsVec->setMemoryOwner(tacsName);
+  xptVec->setMemoryOwner(tacsName);
+
   // Create the design variable node mapping
   if (!designNodeMap) {
     // Get the number of design variables
@@ -2868,6 +2918,268 @@ void TACSAssembler::scatterExternalBCs(TACSBcMap *bcs) {
   delete[] extBCs;
 }
 
+/*
+  The types that define an element group and the sort key of an element
+*/
+class TACSElementGroupType {
+ public:
+  const std::type_info *types[3];
+};
+
+class TACSElementOrderEntry {
+ public:
+  int group;
+  int node;
+  int index;
+};
+
+static int TacsCompareElementOrder(const void *a, const void *b) {
+  const TACSElementOrderEntry *ea = (const TACSElementOrderEntry *)a;
+  const TACSElementOrderEntry *eb = (const TACSElementOrderEntry *)b;
+  if (ea->group != eb->group) {
+    return ea->group - eb->group;
+  }
+  if (ea->node != eb->node) {
+    return (ea->node < eb->node ? -1 : 1);
+  }
+  return ea->index - eb->index;
+}
+
+static int TacsSameType(const std::type_info *a, const std::type_info *b) {
+  if (a && b) {
+    return (*a == *b);
+  }
+  return (a == b);
+}
+
+/**
+  Compute the order in which the elements are assembled.
+
+  The elements are grouped by their type, the type of their element
+  model and the type of the constitutive object of the model (when
+  these are available), in the order in which the groups first appear.
+  Within each group, the elements are sorted by their lowest node
+  number. When the nodes have been reordered with computeReordering(),
+  this traverses each group in the same order as the nodes so that
+  neighbouring elements access neighbouring entries of the vectors
+  and the matrix. The connectivity is packed in the assembly order.
+
+  The element indices are not changed: the elements, functions and
+  auxiliary elements all still use the original element numbering.
+  The residual and matrix assembly operations visit the elements in
+  the new order. This must be called after initialize().
+*/
+void TACSAssembler::computeElementOrdering() {
+  if (!meshInitializedFlag) {
+    fprintf(stderr,
+            "[%d] Cannot call computeElementOrdering() before initialize()\n",
+            mpiRank);
+    return;
+  }
+
+  // The memory required for the ordering
+  double bytes = (2.0 * numElements + elementNodeIndex[numElements] + 1) *
+                 sizeof(int);
+
+  // Free the previous ordering, if any
+  if (elementOrder) {
+    delete[] elementGroupPtr;
+    delete[] elementOrder;
+    delete[] elementOrderNodeIndex;
+    delete[] elementOrderTacsNodes;
+    addMemoryUsage(-(bytes + (numElementGroups + 1) * sizeof(int)));
+  }
+
+  // Assign each element to a group
+  TACSElementGroupType *groups = new TACSElementGroupType[numElements];
+  TACSElementOrderEntry *entries = new TACSElementOrderEntry[numElements];
+  numElementGroups = 0;
+  for (int i = 0; i < numElements; i++) {
+    TACSElementGroupType elemType;
+    elemType.types[0] = &typeid(*elements[i]);
+    elemType.types[1] = elemType.types[2] = NULL;
+    TACSElementModel *model = elements[i]->getElementModel();
+    if (model) {
+      elemType.types[1] = &typeid(*model);
+      TACSConstitutive *con = model->getConstitutive();
+      if (con) {
+        elemType.types[2] = &typeid(*con);
+      }
+    }
+
+    // Search the existing groups - there are only a few
+    int group = 0;
+    for (; group < numElementGroups; group++) {
+      if (TacsSameType(groups[group].types[0], elemType.types[0]) &&
+          TacsSameType(groups[group].types[1], elemType.types[1]) &&
+          TacsSameType(groups[group].types[2], elemType.types[2])) {
+        break;
+      }
+    }
+    if (group == numElementGroups) {
+      groups[group] = elemType;
+      numElementGroups++;
+    }
+
+    // Find the lowest node number, ignoring the dependent nodes
+    int node = INT_MAX;
+    for (int j = elementNodeIndex[i]; j < elementNodeIndex[i + 1]; j++) {
+      if (elementTacsNodes[j] >= 0 && elementTacsNodes[j] < node) {
+        node = elementTacsNodes[j];
+      }
+    }
+
+    entries[i].group = group;
+    entries[i].node = node;
+    entries[i].index = i;
+  }
+
+  qsort(entries, numElements, sizeof(TACSElementOrderEntry),
+        TacsCompareElementOrder);
+
+  // Set the order and the pointer into each group
+  elementGroupPtr = new int[numElementGroups + 1];
+  elementOrder = new int[numElements];
+  elementGroupPtr[0] = 0;
+  for (int k = 0, group = 0; k < numElements; k++) {
+    elementOrder[k] = entries[k].index;
+    while (group < entries[k].group) {
+      group++;
+      elementGroupPtr[group] = k;
+    }
+  }
+  elementGroupPtr[numElementGroups] = numElements;
+
+  // Pack the connectivity in the assembly order
+  elementOrderNodeIndex = new int[numElements + 1];
+  elementOrderTacsNodes = new int[elementNodeIndex[numElements]];
+  elementOrderNodeIndex[0] = 0;
+  for (int k = 0; k < numElements; k++) {
+    int i = elementOrder[k];
+    int ptr = elementNodeIndex[i];
+    int len = elementNodeIndex[i + 1] - ptr;
+    memcpy(&elementOrderTacsNodes[elementOrderNodeIndex[k]],
+           &elementTacsNodes[ptr], len * sizeof(int));
+    elementOrderNodeIndex[k + 1] = elementOrderNodeIndex[k] + len;
+  }
+
+  delete[] groups;
+  delete[] entries;
+
+  addMemoryUsage(bytes + (numElementGroups + 1) * sizeof(int));
+}
+
+/**
+  Get the order in which the elements are assembled
+
+  The elements elementOrder[groupPtr[g]] to elementOrder[groupPtr[g+1]-1]
+  are all of the same type, element model and constitutive class.
+
+  @param groupPtr Pointer into the order array for each group (NULL if
+  no ordering has been computed)
+  @param order The element indices in the assembly order
+  @return The number of groups, zero if no ordering has been computed
+  or if there are no local elements
+*/
+int TACSAssembler::getElementOrdering(const int **groupPtr,
+                                      const int **order) {
+  if (groupPtr) {
+    *groupPtr = elementGroupPtr;
+  }
+  if (order) {
+    *order = elementOrder;
+  }
+  return numElementGroups;
+}
+
+/**
+  Find the first auxiliary element with an index that is not less
+  than the given element index.
+
+  The auxiliary elements are sorted by element index. When the
+  elements are visited in their natural order, the search proceeds
+  from the last position. Otherwise a bisection search is used.
+
+  @param elemIndex The element index
+  @param start The position of the last search
+  @param naux The number of auxiliary elements
+  @param aux The sorted auxiliary elements
+  @return The position of the first auxiliary element
+*/
+int TACSAssembler::findAuxElement(int elemIndex, int start, int naux,
+                                  const TACSAuxElem *aux) {
+  if (!elementOrder) {
+    while (start < naux && aux[start].num < elemIndex) {
+      start++;
+    }
+    return start;
+  }
+
+  int low = 0, high = naux;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (aux[mid].num < elemIndex) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/*
+  Estimate the floating point operations in the residual or Jacobian
+  kernel of an element. At each quadrature point, the kernel
+  interpolates the states and their derivatives along each parametric
+  direction and adds the weak form back to the residual, at a cost of
+  about 4*(d + 1)*n for n element variables. The Jacobian adds the
+  outer product of the weak form derivatives at about 2*(d + 1)*n^2.
+  The cost of the constitutive model is not included.
+*/
+static double TacsEstimateElementFlops(TACSElement *element, int jacobian) {
+  double nvars = element->getNumVariables();
+  double nparams = 3.0;
+  TACSElementBasis *basis = element->getElementBasis();
+  if (basis) {
+    nparams = basis->getNumParameters();
+  }
+
+  double flops = 4.0 * (nparams + 1.0) * nvars;
+  if (jacobian) {
+    flops += 2.0 * (nparams + 1.0) * nvars * nvars;
+  }
+  return element->getNumQuadraturePoints() * flops;
+}
+
+/**
+  Add an estimate of the floating point operations in the residual or
+  Jacobian kernels of the elements and the auxiliary elements to the
+  current profiler scope.
+
+  The profiler is not thread-safe, so this is called once from the
+  main thread for each assembly operation.
+
+  @param jacobian Flag indicating whether the Jacobian is assembled
+*/
+void TACSAssembler::addElementFlops(int jacobian) {
+  if (!TACSProfiler::isEnabled()) {
+    return;
+  }
+
+  double flops = 0.0;
+  for (int i = 0; i < numElements; i++) {
+    flops += TacsEstimateElementFlops(elements[i], jacobian);
+  }
+  if (auxElements) {
+    TACSAuxElem *aux = NULL;
+    int naux = auxElements->getAuxElements(&aux);
+    for (int k = 0; k < naux; k++) {
+      flops += TacsEstimateElementFlops(aux[k].elem, jacobian);
+    }
+  }
+  TACSProfiler::addCounts(0.0, flops);
+}
+
 /**
   Get pointers to the element data. This code provides a way to
   automatically segment an array to avoid coding mistakes.
@@ -3240,6 +3552,7 @@ void TACSAssembler::getDesignVars(TACSBVec *dvs) {
   @param dvs The design variable values
 */
 void TACSAssembler::setDesignVars(TACSBVec *dvs) {
+  TACS_PROFILE_SCOPE("TACSAssembler::setDesignVars");
   // Distribute the non-local design variable values
   dvs->beginDistributeValues();
   dvs->endDistributeValues();
@@ -3957,6 +4270,7 @@ void TACSAssembler::zeroDDotVariables() { ddvarsVec->zeroEntries(); }
 */
 void TACSAssembler::setVariables(TACSBVec *vars, TACSBVec *dvars,
                                  TACSBVec *ddvars) {
+  TACS_PROFILE_SCOPE("TACSAssembler::setVariables");
   // Copy the values to the array.
   if (vars) {
     varsVec->copyValues(vars);
@@ -4132,6 +4446,7 @@ void TACSAssembler::evalEnergies(TacsScalar *Te, TacsScalar *Pe) {
 */
 void TACSAssembler::assembleRes(TACSBVec *residual, const TacsScalar lambda,
                                 const bool applyBCs) {
+  TACS_PROFILE_SCOPE("TACSAssembler::assembleRes");
   // Sort the list of auxiliary elements - this only performs the
   // sort if it is required (if new elements are added)
   if (auxElements) {
@@ -4142,9 +4457,13 @@ void TACSAssembler::assembleRes(TACSBVec *residual, const TacsScalar lambda,
   residual->zeroEntries();
 
   if (thread_info->getNumThreads() > 1) {
+    TACS_PROFILE_SCOPE("elements");
+    addElementFlops(0);
     // Set the number of completed elements to zero
     numCompletedElements = 0;
+    initThreadArenas();
     tacsPInfo->assembler = this;
+    tacsPInfo->res = residual;
     tacsPInfo->lambda = lambda;
 
     // Create the joinable attribute
@@ -4165,6 +4484,8 @@ void TACSAssembler::assembleRes(TACSBVec *residual, const TacsScalar lambda,
     // Destroy the attribute
     pthread_attr_destroy(&attr);
   } else {
+    TACS_PROFILE_SCOPE("elements");
+    addElementFlops(0);
     // Retrieve pointers to temporary storage
     TacsScalar *vars, *dvars, *ddvars, *elemRes, *elemXpts;
     getDataPointers(elementData, &vars, &dvars, &ddvars, &elemRes, &elemXpts,
@@ -4183,14 +4504,15 @@ void TACSAssembler::assembleRes(TACSBVec *residual, const TacsScalar lambda,
     TacsScalar *auxElemRes = NULL;
     bool scaleAux = lambda != TacsScalar(1.0) && naux > 0;
     if (scaleAux) {
-      auxElemRes = new TacsScalar[maxNVar];
+      initThreadArenas();
+      auxElemRes = threadArenas[0]->allocateScalars(maxNVar);
     }
 
     // Go through and add the residuals from all the elements
-    for (int i = 0; i < numElements; i++) {
-      int ptr = elementNodeIndex[i];
-      int len = elementNodeIndex[i + 1] - ptr;
-      const int *nodes = &elementTacsNodes[ptr];
+    for (int k = 0; k < numElements; k++) {
+      int len;
+      const int *nodes;
+      int i = getAssemblyElement(k, &len, &nodes);
       xptVec->getValues(len, nodes, elemXpts);
       varsVec->getValues(len, nodes, vars);
       dvarsVec->getValues(len, nodes, dvars);
@@ -4201,6 +4523,9 @@ void TACSAssembler::assembleRes(TACSBVec *residual, const TacsScalar lambda,
       memset(elemRes, 0, nvars * sizeof(TacsScalar));
       elements[i]->addResidual(i, time, elemXpts, vars, dvars, ddvars, elemRes);
 
+      // Find the auxiliary elements for this element, if any
+      aux_count = findAuxElement(i, aux_count, naux, aux);
+
       // Add the residual from any auxiliary elements, if the load factor is 1
       // they can be added straight to the elemRes, otherwise they need to be
       // scaled first
@@ -4225,10 +4550,6 @@ void TACSAssembler::assembleRes(TACSBVec *residual, const TacsScalar lambda,
       // Add the residual values
       residual->setValues(len, nodes, elemRes, TACS_ADD_VALUES);
     }
-
-    if (scaleAux) {
-      delete[] auxElemRes;
-    }
   }
 
   // Finish transmitting the residual
@@ -4293,6 +4614,7 @@ void TACSAssembler::assembleJacobian(TacsScalar alpha, TacsScalar beta,
                                      TACSMat *A, MatrixOrientation matOr,
                                      const TacsScalar lambda,
                                      const bool applyBCs) {
+  TACS_PROFILE_SCOPE("TACSAssembler::assembleJacobian");
   // Zero the residual and the matrix
   if (residual) {
     residual->zeroEntries();
@@ -4307,8 +4629,11 @@ void TACSAssembler::assembleJacobian(TacsScalar alpha, TacsScalar beta,
 
   // Run the p-threaded version of the assembly code
   if (thread_info->getNumThreads() > 1) {
+    TACS_PROFILE_SCOPE("elements");
+    addElementFlops(1);
     // Set the number of completed elements to zero
     numCompletedElements = 0;
+    initThreadArenas();
     tacsPInfo->assembler = this;
     tacsPInfo->res = residual;
     tacsPInfo->mat = A;
@@ -4336,6 +4661,8 @@ void TACSAssembler::assembleJacobian(TacsScalar alpha, TacsScalar beta,
     // Destroy the attribute
     pthread_attr_destroy(&attr);
   } else {
+    TACS_PROFILE_SCOPE("elements");
+    addElementFlops(1);
     // Retrieve pointers to temporary storage
     TacsScalar *vars, *dvars, *ddvars, *elemRes, *elemXpts;
     TacsScalar *elemWeights, *elemMat;
@@ -4349,10 +4676,10 @@ void TACSAssembler::assembleJacobian(TacsScalar alpha, TacsScalar beta,
       naux = auxElements->getAuxElements(&aux);
     }
 
-    for (int i = 0; i < numElements; i++) {
-      int ptr = elementNodeIndex[i];
-      int len = elementNodeIndex[i + 1] - ptr;
-      const int *nodes = &elementTacsNodes[ptr];
+    for (int k = 0; k < numElements; k++) {
+      int len;
+      const int *nodes;
+      int i = getAssemblyElement(k, &len, &nodes);
       xptVec->getValues(len, nodes, elemXpts);
       varsVec->getValues(len, nodes, vars);
       dvarsVec->getValues(len, nodes, dvars);
@@ -4369,6 +4696,7 @@ void TACSAssembler::assembleJacobian(TacsScalar alpha, TacsScalar beta,
 
       // Add the contribution to the residual and the Jacobian from the
       // auxiliary elements - if any, this is scaled by the loadFactor lambda
+      aux_count = findAuxElement(i, aux_count, naux, aux);
       while (aux_count < naux && aux[aux_count].num == i) {
         aux[aux_count].elem->addJacobian(i, time, alpha * lambda, beta * lambda,
                                          gamma * lambda, elemXpts, vars, dvars,
@@ -4419,12 +4747,14 @@ void TACSAssembler::assembleMatType(ElementMatrixType matType, TACSMat *A,
                                     MatrixOrientation matOr,
                                     const TacsScalar lambda,
                                     const bool applyBCs) {
+  TACS_PROFILE_SCOPE("TACSAssembler::assembleMatType");
   // Zero the matrix
   A->zeroEntries();
 
   if (thread_info->getNumThreads() > 1) {
     // Set the number of completed elements to zero
     numCompletedElements = 0;
+    initThreadArenas();
     tacsPInfo->assembler = this;
     tacsPInfo->mat = A;
     tacsPInfo->matType = matType;
@@ -4464,14 +4794,16 @@ void TACSAssembler::assembleMatType(ElementMatrixType matType, TACSMat *A,
     // To avoid allocating memory inside the element loop, make the aux element
     // contribution mat big enough for the largest element
     int maxNVar = this->maxElementSize;
-    TacsScalar *auxElemMat = new TacsScalar[maxNVar * maxNVar];
+    initThreadArenas();
+    TacsScalar *auxElemMat =
+        threadArenas[0]->allocateScalars(maxNVar * maxNVar);
 
-    for (int i = 0; i < numElements; i++) {
+    for (int k = 0; k < numElements; k++) {
       // Retrieve the element variables and node locations
-      int ptr = elementNodeIndex[i];
-      int len = elementNodeIndex[i + 1] - ptr;
+      int len;
+      const int *nodes;
+      int i = getAssemblyElement(k, &len, &nodes);
       int nvars = elements[i]->getNumVariables();
-      const int *nodes = &elementTacsNodes[ptr];
       xptVec->getValues(len, nodes, elemXpts);
       varsVec->getValues(len, nodes, vars);
 
@@ -4480,6 +4812,7 @@ void TACSAssembler::assembleMatType(ElementMatrixType matType, TACSMat *A,
 
       // Add the contribution from any auxiliary elements,  they need to be
       // scaled first
+      aux_count = findAuxElement(i, aux_count, naux, aux);
       while (aux_count < naux && aux[aux_count].num == i) {
         aux[aux_count].elem->getMatType(matType, i, time, elemXpts, vars,
                                         auxElemMat);
@@ -4492,7 +4825,6 @@ void TACSAssembler::assembleMatType(ElementMatrixType matType, TACSMat *A,
       // Add the values into the element
       addMatValues(A, i, elemMat, elementIData, elemWeights, matOr);
     }
-    delete[] auxElemMat;
   }
 
   A->beginAssembly();
@@ -4520,6 +4852,7 @@ void TACSAssembler::assembleMatCombo(ElementMatrixType matTypes[],
                                      TacsScalar scale[], int nmats, TACSMat *A,
                                      MatrixOrientation matOr, TacsScalar lambda,
                                      const bool applyBCs) {
+  TACS_PROFILE_SCOPE("TACSAssembler::assembleMatCombo");
   // Zero the matrix
   A->zeroEntries();
 
@@ -4541,17 +4874,21 @@ void TACSAssembler::assembleMatCombo(ElementMatrixType matTypes[],
   TacsScalar *auxElemMat = NULL;
   bool scaleAux = lambda != TacsScalar(1.0) && naux > 0;
   if (scaleAux) {
-    auxElemMat = new TacsScalar[maxNVar * maxNVar];
+    initThreadArenas();
+    auxElemMat = threadArenas[0]->allocateScalars(maxNVar * maxNVar);
   }
 
-  for (int i = 0; i < numElements; i++) {
+  for (int k = 0; k < numElements; k++) {
     // Retrieve the element variables and node locations
-    int ptr = elementNodeIndex[i];
-    int len = elementNodeIndex[i + 1] - ptr;
-    const int *nodes = &elementTacsNodes[ptr];
+    int len;
+    const int *nodes;
+    int i = getAssemblyElement(k, &len, &nodes);
     xptVec->getValues(len, nodes, elemXpts);
     varsVec->getValues(len, nodes, vars);
 
+    // Find the auxiliary elements for this element, if any
+    aux_count = findAuxElement(i, aux_count, naux, aux);
+
     for (int j = 0; j < nmats; j++) {
       // Get the element matrix
       elements[i]->getMatType(matTypes[j], i, time, elemXpts, vars, elemMat);
@@ -4588,9 +4925,6 @@ void TACSAssembler::assembleMatCombo(ElementMatrixType matTypes[],
       addMatValues(A, i, elemMat, elementIData, elemWeights, matOr);
     }
   }
-  if (scaleAux) {
-    delete[] auxElemMat;
-  }
 
   A->beginAssembly();
   A->endAssembly();
@@ -4616,6 +4950,7 @@ void TACSAssembler::assembleMatCombo(ElementMatrixType matTypes[],
 */
 void TACSAssembler::evalFunctions(int numFuncs, TACSFunction **funcs,
                                   TacsScalar *funcVals) {
+  TACS_PROFILE_SCOPE("TACSAssembler::evalFunctions");
   // Here we will use time-independent formulation
   TacsScalar tcoef = 1.0;
 
@@ -4732,6 +5067,226 @@ void TACSAssembler::integrateFunctions(TacsScalar tcoef,
   }
 }
 
+/*
+  Work data for the fused evaluation of the function sensitivities
+
+  The sensitivity routines loop over the elements and evaluate the
+  contributions from all the functions whose domain includes the
+  element, so the element data is only gathered once per element.
+
+  Functions that aggregate a single point-wise quantity (see
+  TACSFunction::getPointQuantityType) are grouped by the type of
+  quantity. The quantity is evaluated once at each quadrature point
+  for the whole group, and the derivatives for all the functions in
+  the group are added with a single call to the element.
+*/
+class TACSFunctionSensWork {
+ public:
+  static const int LD = TACSFunction::MAX_POINT_QUANTITY_SIZE;
+
+  TACSFunctionSensWork(int _numFuncs, TACSFunction **_funcs, int numElements,
+                       TACSElement **elements) {
+    numFuncs = _numFuncs;
+    funcs = _funcs;
+
+    // Count up the number of functions on each element
+    elemPtr = new int[numElements + 1];
+    memset(elemPtr, 0, (numElements + 1) * sizeof(int));
+    for (int k = 0; k < numFuncs; k++) {
+      if (funcs[k]) {
+        if (funcs[k]->getDomainType() == TACSFunction::ENTIRE_DOMAIN) {
+          for (int i = 0; i < numElements; i++) {
+            elemPtr[i + 1]++;
+          }
+        } else if (funcs[k]->getDomainType() == TACSFunction::SUB_DOMAIN) {
+          const int *elemNums;
+          int size = funcs[k]->getElementNums(&elemNums);
+          for (int i = 0; i < size; i++) {
+            if (elemNums[i] >= 0 && elemNums[i] < numElements) {
+              elemPtr[elemNums[i] + 1]++;
+            }
+          }
+        }
+      }
+    }
+
+    for (int i = 0; i < numElements; i++) {
+      elemPtr[i + 1] += elemPtr[i];
+    }
+
+    // Fill in the functions in the order they are passed in
+    elemFuncs = new int[elemPtr[numElements]];
+    for (int k = 0; k < numFuncs; k++) {
+      if (funcs[k]) {
+        if (funcs[k]->getDomainType() == TACSFunction::ENTIRE_DOMAIN) {
+          for (int i = 0; i < numElements; i++) {
+            elemFuncs[elemPtr[i]] = k;
+            elemPtr[i]++;
+          }
+        } else if (funcs[k]->getDomainType() == TACSFunction::SUB_DOMAIN) {
+          const int *elemNums;
+          int size = funcs[k]->getElementNums(&elemNums);
+          for (int i = 0; i < size; i++) {
+            int elem = elemNums[i];
+            if (elem >= 0 && elem < numElements) {
+              elemFuncs[elemPtr[elem]] = k;
+              elemPtr[elem]++;
+            }
+          }
+        }
+      }
+    }
+
+    for (int i = numElements; i > 0; i--) {
+      elemPtr[i] = elemPtr[i - 1];
+    }
+    elemPtr[0] = 0;
+
+    // Find the maximum number of functions and quadrature points
+    maxFuncs = 0;
+    maxPts = 0;
+    for (int i = 0; i < numElements; i++) {
+      int nf = elemPtr[i + 1] - elemPtr[i];
+      if (nf > 0) {
+        if (nf > maxFuncs) {
+          maxFuncs = nf;
+        }
+        int npts = elements[i]->getNumQuadraturePoints();
+        if (npts > maxPts) {
+          maxPts = npts;
+        }
+      }
+    }
+
+    // Allocate the work arrays
+    numGroup = 0;
+    group = new int[maxFuncs];
+    flags = new int[maxFuncs];
+    pts = new double[3 * maxPts];
+    weights = new double[maxPts];
+    counts = new int[maxPts];
+    detXd = new TacsScalar[maxPts];
+    quantity = new TacsScalar[LD * maxPts];
+    funcdfdq = new TacsScalar[LD * maxPts * maxFuncs];
+    funcdfddetXd = new TacsScalar[maxPts * maxFuncs];
+    dfdq = new TacsScalar[LD * maxFuncs];
+    dfddetXd = new TacsScalar[maxFuncs];
+  }
+  ~TACSFunctionSensWork() {
+    delete[] elemPtr;
+    delete[] elemFuncs;
+    delete[] group;
+    delete[] flags;
+    delete[] pts;
+    delete[] weights;
+    delete[] counts;
+    delete[] detXd;
+    delete[] quantity;
+    delete[] funcdfdq;
+    delete[] funcdfddetXd;
+    delete[] dfdq;
+    delete[] dfddetXd;
+  }
+
+  // Get the maximum number of functions on any element
+  int getMaxNumFuncs() { return maxFuncs; }
+
+  // Get the functions defined on the element and reset the groups
+  int getElementFuncs(int elemNum, const int **funcNums) {
+    int nf = elemPtr[elemNum + 1] - elemPtr[elemNum];
+    *funcNums = &elemFuncs[elemPtr[elemNum]];
+    memset(flags, 0, nf * sizeof(int));
+    return nf;
+  }
+
+  // Find the next group of functions on the element that share a point
+  // quantity and evaluate their derivatives w.r.t. the quantity
+  int evalNextGroup(int elemNum, TACSElement *element, double time,
+                    const TacsScalar Xpts[], const TacsScalar vars[],
+                    const TacsScalar dvars[], const TacsScalar ddvars[],
+                    int *quantityType, const int **_group) {
+    const int nf = elemPtr[elemNum + 1] - elemPtr[elemNum];
+    const int *funcNums = &elemFuncs[elemPtr[elemNum]];
+
+    numGroup = 0;
+    int qtype = -1;
+    for (int j = 0; j < nf; j++) {
+      if (!flags[j]) {
+        int type = funcs[funcNums[j]]->getPointQuantityType();
+        if (type >= 0 && (numGroup == 0 || type == qtype)) {
+          qtype = type;
+          flags[j] = 1;
+          group[numGroup] = j;
+          numGroup++;
+        }
+      }
+    }
+
+    if (numGroup > 0) {
+      // Evaluate the quantity at each quadrature point
+      numPts = element->getNumQuadraturePoints();
+      memset(quantity, 0, LD * numPts * sizeof(TacsScalar));
+      for (int n = 0; n < numPts; n++) {
+        weights[n] = element->getQuadraturePoint(n, &pts[3 * n]);
+        detXd[n] = 0.0;
+        counts[n] = element->evalPointQuantity(
+            elemNum, qtype, time, n, &pts[3 * n], Xpts, vars, dvars, ddvars,
+            &detXd[n], &quantity[LD * n]);
+      }
+
+      // Evaluate the derivatives for each function in the group
+      for (int g = 0; g < numGroup; g++) {
+        TACSFunction *func = funcs[funcNums[group[g]]];
+        func->getElementPointQuantitySens(
+            elemNum, element, numPts, weights, counts, detXd, quantity,
+            &funcdfdq[LD * maxPts * g], &funcdfddetXd[maxPts * g]);
+      }
+    }
+
+    *quantityType = qtype;
+    *_group = group;
+    return numGroup;
+  }
+
+  // Get the derivatives for the group at the quadrature point. This
+  // returns zero if the quantity is not defined at the point.
+  int getPointSens(int n, double **pt, const TacsScalar **_dfdq,
+                   const TacsScalar **_dfddetXd) {
+    if (counts[n] < 1) {
+      return 0;
+    }
+    for (int g = 0; g < numGroup; g++) {
+      memcpy(&dfdq[LD * g], &funcdfdq[LD * (maxPts * g + n)],
+             LD * sizeof(TacsScalar));
+      dfddetXd[g] = funcdfddetXd[maxPts * g + n];
+    }
+    *pt = &pts[3 * n];
+    *_dfdq = dfdq;
+    *_dfddetXd = dfddetXd;
+    return 1;
+  }
+
+ private:
+  // The functions
+  int numFuncs;
+  TACSFunction **funcs;
+
+  // The functions defined on each element
+  int *elemPtr, *elemFuncs;
+  int maxFuncs, maxPts;
+
+  // The current group of functions
+  int numGroup, numPts;
+  int *group, *flags;
+
+  // Point data and derivatives for the current group
+  double *pts, *weights;
+  int *counts;
+  TacsScalar *detXd, *quantity;
+  TacsScalar *funcdfdq, *funcdfddetXd;
+  TacsScalar *dfdq, *dfddetXd;
+};
+
 /**
   Evaluate the derivative of a list of functions w.r.t. the design
   variables.
@@ -4755,6 +5310,9 @@ void TACSAssembler::integrateFunctions(TacsScalar tcoef,
   The material-dependent design variables are handled on an
   element-by-element and traction-by-traction dependent basis.
 
+  All the functions are evaluated in a single pass over the elements
+  so it is more efficient to pass all the functions at once.
+
   Note that this function distributes the result to the processors
   through a collective communication call. No further parallel
   communication is required.
@@ -4766,156 +5324,389 @@ void TACSAssembler::integrateFunctions(TacsScalar tcoef,
 */
 void TACSAssembler::addDVSens(TacsScalar coef, int numFuncs,
                               TACSFunction **funcs, TACSBVec **dfdx) {
-  // Retrieve pointers to temporary storage
-  TacsScalar *vars, *dvars, *ddvars, *elemXpts;
-  getDataPointers(elementData, &vars, &dvars, &ddvars, NULL, &elemXpts, NULL,
-                  NULL, NULL);
-
-  // Get the design variables from the elements on this process
-  const int maxDVs = maxElementDesignVars;
-  TacsScalar *fdvSens = elementSensData;
-  int *dvNums = elementSensIData;
-
-  // For each function, evaluate the derivative w.r.t. the
-  // design variables for each element
-  for (int k = 0; k < numFuncs; k++) {
-    if (funcs[k]) {
-      if (funcs[k]->getDomainType() == TACSFunction::SUB_DOMAIN) {
-        // Get the funcs[k] sub-domain
-        const int *elemSubList;
-        int numSubElems = funcs[k]->getElementNums(&elemSubList);
-
-        for (int i = 0; i < numSubElems; i++) {
-          int elemNum = elemSubList[i];
-          // Determine the values of the state variables for subElem
-          int ptr = elementNodeIndex[elemNum];
-          int len = elementNodeIndex[elemNum + 1] - ptr;
-          const int *nodes = &elementTacsNodes[ptr];
-          xptVec->getValues(len, nodes, elemXpts);
-          varsVec->getValues(len, nodes, vars);
-          dvarsVec->getValues(len, nodes, dvars);
-          ddvarsVec->getValues(len, nodes, ddvars);
+  addDVSens(coef, numFuncs, funcs, dfdx, NULL);
+}
 
-          // Get the design variables for this element
-          int numDVs =
-              elements[elemNum]->getDesignVarNums(elemNum, maxDVs, dvNums);
+/**
+  Create an interleaved design vector that stores several design vectors
+
+  The interleaved vector shares the parallel layout of the design vector
+  and collects the values of all numVecs vectors with a single parallel
+  reduction. Each design node only stores values for the vectors that
+  are non-zero at the node (see TACSInterleavedBVec). The pattern follows
+  the design variables of the elements: when funcs is given, vector k is
+  only stored at the design variables of the elements in the domain of
+  funcs[k]. Vectors with a NULL function, or all the vectors when funcs
+  is NULL, are stored at the design variables of all the elements,
+  including the auxiliary elements.
+
+  Note that the products of the adjoint vectors with the derivative of
+  the residual are non-zero for the design variables of all the
+  elements. Vectors used with addAdjointResProductsInterleaved() must be
+  created with a NULL function.
+
+  @param numVecs The number of interleaved design vectors
+  @param funcs The functions that define the pattern of each vector
+  @return The interleaved design vector
+*/
+TACSInterleavedBVec *TACSAssembler::createInterleavedDesignVec(
+    int numVecs, TACSFunction **funcs) {
+  if (!meshInitializedFlag) {
+    fprintf(
+        stderr,
+        "[%d] Cannot call createInterleavedDesignVec() before initialize()\n",
+        mpiRank);
+    return NULL;
+  }
+  if (numVecs < 1) {
+    numVecs = 1;
+  }
 
-          // Evaluate the element-wise sensitivity of the function
-          memset(fdvSens, 0, numDVs * designVarsPerNode * sizeof(TacsScalar));
-          funcs[k]->addElementDVSens(elemNum, elements[elemNum], time, coef,
-                                     elemXpts, vars, dvars, ddvars, maxDVs,
-                                     fdvSens);
+  // Sort the auxiliary elements and add them as additional blocks
+  int naux = 0;
+  TACSAuxElem *aux = NULL;
+  if (auxElements) {
+    auxElements->sort();
+    naux = auxElements->getAuxElements(&aux);
+  }
+  const int nblocks = numElements + naux;
 
-          // Add the derivative values
-          dfdx[k]->setValues(numDVs, dvNums, fdvSens, TACS_ADD_VALUES);
-        }
-      } else if (funcs[k]->getDomainType() == TACSFunction::ENTIRE_DOMAIN) {
-        for (int elemNum = 0; elemNum < numElements; elemNum++) {
-          // Determine the values of the state variables for elemNum
-          int ptr = elementNodeIndex[elemNum];
-          int len = elementNodeIndex[elemNum + 1] - ptr;
-          const int *nodes = &elementTacsNodes[ptr];
-          xptVec->getValues(len, nodes, elemXpts);
-          varsVec->getValues(len, nodes, vars);
-          dvarsVec->getValues(len, nodes, dvars);
-          ddvarsVec->getValues(len, nodes, ddvars);
+  // Find the design variables of each element
+  const int maxDVs = maxElementDesignVars;
+  int *blockPtr = new int[nblocks + 1];
+  int *blockNodes = new int[nblocks * maxDVs];
+  blockPtr[0] = 0;
+  for (int i = 0; i < nblocks; i++) {
+    int *dvNums = &blockNodes[blockPtr[i]];
+    int numDVs = 0;
+    if (i < numElements) {
+      numDVs = elements[i]->getDesignVarNums(i, maxDVs, dvNums);
+    } else {
+      TACSAuxElem *a = &aux[i - numElements];
+      numDVs = a->elem->getDesignVarNums(a->num, maxDVs, dvNums);
+    }
+    blockPtr[i + 1] = blockPtr[i] + numDVs;
+  }
 
-          // Get the design variables for this element
-          int numDVs =
-              elements[elemNum]->getDesignVarNums(elemNum, maxDVs, dvNums);
+  // Find the vectors that are non-zero on each element
+  int *vecPtr = NULL, *blockVecs = NULL;
+  if (funcs) {
+    int numNull = 0;
+    for (int k = 0; k < numVecs; k++) {
+      if (!funcs[k]) {
+        numNull++;
+      }
+    }
 
-          // Evaluate the element-wise sensitivity of the function
-          memset(fdvSens, 0, numDVs * designVarsPerNode * sizeof(TacsScalar));
-          funcs[k]->addElementDVSens(elemNum, elements[elemNum], time, coef,
-                                     elemXpts, vars, dvars, ddvars, maxDVs,
-                                     fdvSens);
+    TACSFunctionSensWork work(numVecs, funcs, numElements, elements);
+    vecPtr = new int[nblocks + 1];
+    vecPtr[0] = 0;
+    for (int i = 0; i < nblocks; i++) {
+      vecPtr[i + 1] = vecPtr[i] + numNull;
+      if (i < numElements) {
+        const int *funcNums;
+        vecPtr[i + 1] += work.getElementFuncs(i, &funcNums);
+      }
+    }
 
-          // Add the derivative values
-          dfdx[k]->setValues(numDVs, dvNums, fdvSens, TACS_ADD_VALUES);
+    blockVecs = new int[vecPtr[nblocks]];
+    for (int i = 0; i < nblocks; i++) {
+      int *vecs = &blockVecs[vecPtr[i]];
+      for (int k = 0; k < numVecs; k++) {
+        if (!funcs[k]) {
+          vecs[0] = k;
+          vecs++;
         }
       }
+      if (i < numElements) {
+        const int *funcNums;
+        int nf = work.getElementFuncs(i, &funcNums);
+        memcpy(vecs, funcNums, nf * sizeof(int));
+      }
     }
   }
+
+  TACSInterleavedBVec *vec = new TACSInterleavedBVec(
+      designNodeMap, designVarsPerNode, numVecs, designExtDist, designDepNodes,
+      nblocks, blockPtr, blockNodes, vecPtr, blockVecs);
+
+  delete[] blockPtr;
+  delete[] blockNodes;
+  if (vecPtr) {
+    delete[] vecPtr;
+    delete[] blockVecs;
+  }
+
+  return vec;
 }
 
 /**
-  Evaluate the derivative of the function w.r.t. the owned nodes.
+  Copy the values from an interleaved design vector to individual vectors
 
-  This code evaluates the sensitivity of the function w.r.t. the
-  owned nodes for all elements in the function domain.
+  Only the locally owned values are copied. The interleaved vector should
+  be finalized with beginSetValues()/endSetValues() before calling this
+  function. Entries of vecs that are NULL are skipped.
 
-  Note that a function should be evaluated - using evalFunction - before
-  its derivatives can be evaluated.
+  @param interleaved The interleaved design vector
+  @param numVecs The number of vectors stored in the interleaved vector
+  @param vecs The design vectors
+*/
+void TACSAssembler::splitInterleavedDesignVec(TACSInterleavedBVec *interleaved,
+                                              int numVecs, TACSBVec **vecs) {
+  if (interleaved->getNumVecs() != numVecs ||
+      interleaved->getBlockSize() != designVarsPerNode) {
+    fprintf(stderr,
+            "[%d] TACSAssembler::splitInterleavedDesignVec: Interleaved "
+            "vector does not match the number of vectors\n",
+            mpiRank);
+    return;
+  }
 
-  This function should be preferred to the use of evalDVSens without a
-  list of functions since it is more efficient!
+  for (int k = 0; k < numVecs; k++) {
+    if (vecs[k]) {
+      TacsScalar *x;
+      vecs[k]->getArray(&x);
+      interleaved->getValues(k, x);
+    }
+  }
+}
+
+/**
+  Evaluate the derivative of several functions w.r.t. the design
+  variables and add the result to an interleaved design vector.
+
+  The interleaved vector must be created by createInterleavedDesignVec() with
+  numFuncs vectors, either with the same functions or with the full
+  pattern. The contributions to design variables owned by other
+  processors are communicated for all the functions at once by a single
+  call to beginSetValues() and endSetValues() on the interleaved vector.
 
   @param coef The coefficient applied to the derivative
   @param numFuncs The number of functions - size of funcs array
   @param funcs The TACSFunction function objects
-  @param dfdXpt The derivative vector
+  @param dfdx The interleaved derivative vector
 */
-void TACSAssembler::addXptSens(TacsScalar coef, int numFuncs,
-                               TACSFunction **funcs, TACSBVec **dfdXpt) {
-  // First check if this is the right assembly object
-  for (int k = 0; k < numFuncs; k++) {
-    if (funcs[k] && this != funcs[k]->getAssembler()) {
-      fprintf(stderr, "[%d] Cannot evaluate function %s, wrong TACS object\n",
-              mpiRank, funcs[k]->getObjectName());
-    }
+void TACSAssembler::addDVSensInterleaved(TacsScalar coef, int numFuncs,
+                                         TACSFunction **funcs,
+                                         TACSInterleavedBVec *dfdx) {
+  if (dfdx->getNumVecs() != numFuncs ||
+      dfdx->getBlockSize() != designVarsPerNode) {
+    fprintf(stderr,
+            "[%d] TACSAssembler::addDVSensInterleaved: Interleaved vector "
+            "does not match the number of functions\n",
+            mpiRank);
+    return;
   }
+  addDVSens(coef, numFuncs, funcs, NULL, dfdx);
+}
 
+/*
+  Add the derivatives of the functions to either the individual
+  design vectors or the interleaved design vector
+*/
+void TACSAssembler::addDVSens(TacsScalar coef, int numFuncs,
+                              TACSFunction **funcs, TACSBVec **dfdx,
+                              TACSInterleavedBVec *interleaved) {
+  TACS_PROFILE_SCOPE("TACSAssembler::addDVSens");
   // Retrieve pointers to temporary storage
-  TacsScalar *vars, *dvars, *ddvars;
-  TacsScalar *elemXpts, *elemXptSens;
-  getDataPointers(elementData, &vars, &dvars, &ddvars, NULL, &elemXpts,
-                  &elemXptSens, NULL, NULL);
+  TacsScalar *vars, *dvars, *ddvars, *elemXpts;
+  getDataPointers(elementData, &vars, &dvars, &ddvars, NULL, &elemXpts, NULL,
+                  NULL, NULL);
 
-  // For each function, evaluate the derivative w.r.t. the
-  // nodal locations for all elements or part of the domain
-  for (int k = 0; k < numFuncs; k++) {
-    if (funcs[k]) {
-      if (funcs[k]->getDomainType() == TACSFunction::SUB_DOMAIN) {
-        // Get the function sub-domain
-        const int *elemSubList;
-        int numSubElems = funcs[k]->getElementNums(&elemSubList);
-        for (int i = 0; i < numSubElems; i++) {
-          int elemNum = elemSubList[i];
-          // Determine the values of the state variables for subElem
-          int ptr = elementNodeIndex[elemNum];
-          int len = elementNodeIndex[elemNum + 1] - ptr;
-          const int *nodes = &elementTacsNodes[ptr];
-          xptVec->getValues(len, nodes, elemXpts);
-          varsVec->getValues(len, nodes, vars);
-          dvarsVec->getValues(len, nodes, dvars);
-          ddvarsVec->getValues(len, nodes, ddvars);
+  // Get the design variables from the elements on this process
+  const int maxDVs = maxElementDesignVars;
+  const int dvSize = designVarsPerNode * maxDVs;
+  int *dvNums = elementSensIData;
+
+  // Determine the functions defined on each element
+  TACSFunctionSensWork work(numFuncs, funcs, numElements, elements);
+  const int maxFuncs = work.getMaxNumFuncs();
+  TacsScalar *fdvSens = new TacsScalar[maxFuncs * dvSize];
+  TacsScalar **sens = new TacsScalar *[maxFuncs];
+  int nmissing = 0;
+
+  for (int elemNum = 0; elemNum < numElements; elemNum++) {
+    const int *funcNums;
+    int nf = work.getElementFuncs(elemNum, &funcNums);
+    if (nf == 0) {
+      continue;
+    }
+
+    // Determine the values of the state variables for elemNum
+    int ptr = elementNodeIndex[elemNum];
+    int len = elementNodeIndex[elemNum + 1] - ptr;
+    const int *nodes = &elementTacsNodes[ptr];
+    xptVec->getValues(len, nodes, elemXpts);
+    varsVec->getValues(len, nodes, vars);
+    dvarsVec->getValues(len, nodes, dvars);
+    ddvarsVec->getValues(len, nodes, ddvars);
+
+    // Get the design variables for this element
+    int numDVs = elements[elemNum]->getDesignVarNums(elemNum, maxDVs, dvNums);
+
+    // Evaluate the element-wise sensitivity of the functions that do
+    // not share a point quantity
+    for (int j = 0; j < nf; j++) {
+      TACSFunction *func = funcs[funcNums[j]];
+      memset(&fdvSens[j * dvSize], 0,
+             numDVs * designVarsPerNode * sizeof(TacsScalar));
+      if (func->getPointQuantityType() < 0) {
+        func->addElementDVSens(elemNum, elements[elemNum], time, coef,
+                               elemXpts, vars, dvars, ddvars, maxDVs,
+                               &fdvSens[j * dvSize]);
+      }
+    }
+
+    // Add the sensitivities for each group of functions that share a
+    // point quantity
+    int quantityType, numGroup;
+    const int *group;
+    while ((numGroup = work.evalNextGroup(
+                elemNum, elements[elemNum], time, elemXpts, vars, dvars,
+                ddvars, &quantityType, &group)) > 0) {
+      for (int g = 0; g < numGroup; g++) {
+        sens[g] = &fdvSens[group[g] * dvSize];
+      }
 
-          // Evaluate the element-wise sensitivity of the function
-          funcs[k]->getElementXptSens(elemNum, elements[elemNum], time, coef,
-                                      elemXpts, vars, dvars, ddvars,
-                                      elemXptSens);
-          dfdXpt[k]->setValues(len, nodes, elemXptSens, TACS_ADD_VALUES);
+      int numPts = elements[elemNum]->getNumQuadraturePoints();
+      for (int n = 0; n < numPts; n++) {
+        double *pt;
+        const TacsScalar *dfdq, *dfddetXd;
+        if (work.getPointSens(n, &pt, &dfdq, &dfddetXd)) {
+          elements[elemNum]->addPointQuantityDVSensBatch(
+              elemNum, quantityType, time, coef, n, pt, elemXpts, vars, dvars,
+              ddvars, numGroup, TACSFunctionSensWork::LD, dfdq, maxDVs, sens);
         }
-      } else if (funcs[k]->getDomainType() == TACSFunction::ENTIRE_DOMAIN) {
-        for (int elemNum = 0; elemNum < numElements; elemNum++) {
-          // Determine the values of the state variables for elemNum
-          int ptr = elementNodeIndex[elemNum];
-          int len = elementNodeIndex[elemNum + 1] - ptr;
-          const int *nodes = &elementTacsNodes[ptr];
-          xptVec->getValues(len, nodes, elemXpts);
-          varsVec->getValues(len, nodes, vars);
-          dvarsVec->getValues(len, nodes, dvars);
-          ddvarsVec->getValues(len, nodes, ddvars);
+      }
+    }
+
+    // Add the derivative values
+    if (interleaved) {
+      for (int j = 0; j < nf; j++) {
+        nmissing += interleaved->addValues(funcNums[j], numDVs, dvNums,
+                                           &fdvSens[j * dvSize]);
+      }
+    } else {
+      for (int j = 0; j < nf; j++) {
+        dfdx[funcNums[j]]->setValues(numDVs, dvNums, &fdvSens[j * dvSize],
+                                     TACS_ADD_VALUES);
+      }
+    }
+  }
+
+  delete[] fdvSens;
+  delete[] sens;
+
+  if (nmissing > 0) {
+    fprintf(stderr,
+            "[%d] TACSAssembler::addDVSensInterleaved: %d design variables "
+            "are not in the pattern of the interleaved vector\n",
+            mpiRank, nmissing);
+  }
+}
+
+/**
+  Evaluate the derivative of the function w.r.t. the owned nodes.
+
+  This code evaluates the sensitivity of the function w.r.t. the
+  owned nodes for all elements in the function domain.
+
+  Note that a function should be evaluated - using evalFunction - before
+  its derivatives can be evaluated.
+
+  This function should be preferred to the use of evalDVSens without a
+  list of functions since it is more efficient!
+
+  @param coef The coefficient applied to the derivative
+  @param numFuncs The number of functions - size of funcs array
+  @param funcs The TACSFunction function objects
+  @param dfdXpt The derivative vector
+*/
+void TACSAssembler::addXptSens(TacsScalar coef, int numFuncs,
+                               TACSFunction **funcs, TACSBVec **dfdXpt) {
+  TACS_PROFILE_SCOPE("TACSAssembler::addXptSens");
+  // First check if this is the right assembly object
+  for (int k = 0; k < numFuncs; k++) {
+    if (funcs[k] && this != funcs[k]->getAssembler()) {
+      fprintf(stderr, "[%d] Cannot evaluate function %s, wrong TACS object\n",
+              mpiRank, funcs[k]->getObjectName());
+    }
+  }
+
+  // Retrieve pointers to temporary storage
+  TacsScalar *vars, *dvars, *ddvars, *elemXpts;
+  getDataPointers(elementData, &vars, &dvars, &ddvars, NULL, &elemXpts, NULL,
+                  NULL, NULL);
 
-          // Evaluate the element-wise sensitivity of the function
-          funcs[k]->getElementXptSens(elemNum, elements[elemNum], time, coef,
-                                      elemXpts, vars, dvars, ddvars,
-                                      elemXptSens);
-          dfdXpt[k]->setValues(len, nodes, elemXptSens, TACS_ADD_VALUES);
+  // Determine the functions defined on each element
+  TACSFunctionSensWork work(numFuncs, funcs, numElements, elements);
+  const int maxFuncs = work.getMaxNumFuncs();
+  const int xptSize = TACS_SPATIAL_DIM * maxElementNodes;
+  TacsScalar *elemXptSens = new TacsScalar[maxFuncs * xptSize];
+  TacsScalar **sens = new TacsScalar *[maxFuncs];
+
+  for (int elemNum = 0; elemNum < numElements; elemNum++) {
+    const int *funcNums;
+    int nf = work.getElementFuncs(elemNum, &funcNums);
+    if (nf == 0) {
+      continue;
+    }
+
+    // Determine the values of the state variables for elemNum
+    int ptr = elementNodeIndex[elemNum];
+    int len = elementNodeIndex[elemNum + 1] - ptr;
+    const int *nodes = &elementTacsNodes[ptr];
+    xptVec->getValues(len, nodes, elemXpts);
+    varsVec->getValues(len, nodes, vars);
+    dvarsVec->getValues(len, nodes, dvars);
+    ddvarsVec->getValues(len, nodes, ddvars);
+
+    // Evaluate the element-wise sensitivity of the functions that do
+    // not share a point quantity
+    for (int j = 0; j < nf; j++) {
+      TACSFunction *func = funcs[funcNums[j]];
+      if (func->getPointQuantityType() < 0) {
+        func->getElementXptSens(elemNum, elements[elemNum], time, coef,
+                                elemXpts, vars, dvars, ddvars,
+                                &elemXptSens[j * xptSize]);
+      } else {
+        memset(&elemXptSens[j * xptSize], 0,
+               TACS_SPATIAL_DIM * len * sizeof(TacsScalar));
+      }
+    }
+
+    // Add the sensitivities for each group of functions that share a
+    // point quantity
+    int quantityType, numGroup;
+    const int *group;
+    while ((numGroup = work.evalNextGroup(
+                elemNum, elements[elemNum], time, elemXpts, vars, dvars,
+                ddvars, &quantityType, &group)) > 0) {
+      for (int g = 0; g < numGroup; g++) {
+        sens[g] = &elemXptSens[group[g] * xptSize];
+      }
+
+      int numPts = elements[elemNum]->getNumQuadraturePoints();
+      for (int n = 0; n < numPts; n++) {
+        double *pt;
+        const TacsScalar *dfdq, *dfddetXd;
+        if (work.getPointSens(n, &pt, &dfdq, &dfddetXd)) {
+          elements[elemNum]->addPointQuantityXptSensBatch(
+              elemNum, quantityType, time, coef, n, pt, elemXpts, vars, dvars,
+              ddvars, numGroup, dfddetXd, TACSFunctionSensWork::LD, dfdq,
+              sens);
         }
       }
     }
+
+    for (int j = 0; j < nf; j++) {
+      dfdXpt[funcNums[j]]->setValues(len, nodes, &elemXptSens[j * xptSize],
+                                     TACS_ADD_VALUES);
+    }
   }
+
+  delete[] elemXptSens;
+  delete[] sens;
 }
 
 /**
@@ -4941,6 +5732,7 @@ void TACSAssembler::addXptSens(TacsScalar coef, int numFuncs,
 void TACSAssembler::addSVSens(TacsScalar alpha, TacsScalar beta,
                               TacsScalar gamma, int numFuncs,
                               TACSFunction **funcs, TACSBVec **dfdu) {
+  TACS_PROFILE_SCOPE("TACSAssembler::addSVSens");
   // First check if this is the right assembly object
   for (int k = 0; k < numFuncs; k++) {
     if (funcs[k] && this != funcs[k]->getAssembler()) {
@@ -4950,56 +5742,82 @@ void TACSAssembler::addSVSens(TacsScalar alpha, TacsScalar beta,
   }
 
   // Retrieve pointers to temporary storage
-  TacsScalar *vars, *dvars, *ddvars, *elemRes, *elemXpts;
-  getDataPointers(elementData, &vars, &dvars, &ddvars, &elemRes, &elemXpts,
-                  NULL, NULL, NULL);
+  TacsScalar *vars, *dvars, *ddvars, *elemXpts;
+  getDataPointers(elementData, &vars, &dvars, &ddvars, NULL, &elemXpts, NULL,
+                  NULL, NULL);
 
-  for (int k = 0; k < numFuncs; k++) {
-    if (funcs[k]) {
-      if (funcs[k]->getDomainType() == TACSFunction::ENTIRE_DOMAIN) {
-        for (int elemNum = 0; elemNum < numElements; elemNum++) {
-          // Determine the values of the state variables for subElem
-          int ptr = elementNodeIndex[elemNum];
-          int len = elementNodeIndex[elemNum + 1] - ptr;
-          const int *nodes = &elementTacsNodes[ptr];
-          xptVec->getValues(len, nodes, elemXpts);
-          varsVec->getValues(len, nodes, vars);
-          dvarsVec->getValues(len, nodes, dvars);
-          ddvarsVec->getValues(len, nodes, ddvars);
+  // Determine the functions defined on each element
+  TACSFunctionSensWork work(numFuncs, funcs, numElements, elements);
+  const int maxFuncs = work.getMaxNumFuncs();
+  TacsScalar *elemRes = new TacsScalar[maxFuncs * maxElementSize];
+  TacsScalar **sens = new TacsScalar *[maxFuncs];
 
-          // Evaluate the element-wise sensitivity of the function
-          funcs[k]->getElementSVSens(elemNum, elements[elemNum], time, alpha,
-                                     beta, gamma, elemXpts, vars, dvars, ddvars,
-                                     elemRes);
-          dfdu[k]->setValues(len, nodes, elemRes, TACS_ADD_VALUES);
-        }
-      } else if (funcs[k]->getDomainType() == TACSFunction::SUB_DOMAIN) {
-        const int *elementNums;
-        int subDomainSize = funcs[k]->getElementNums(&elementNums);
+  for (int elemNum = 0; elemNum < numElements; elemNum++) {
+    const int *funcNums;
+    int nf = work.getElementFuncs(elemNum, &funcNums);
+    if (nf == 0) {
+      continue;
+    }
 
-        for (int i = 0; i < subDomainSize; i++) {
-          int elemNum = elementNums[i];
-          if (elemNum >= 0 && elemNum < numElements) {
-            // Determine the values of the state variables for the
-            // current element
-            int ptr = elementNodeIndex[elemNum];
-            int len = elementNodeIndex[elemNum + 1] - ptr;
-            const int *nodes = &elementTacsNodes[ptr];
-            xptVec->getValues(len, nodes, elemXpts);
-            varsVec->getValues(len, nodes, vars);
-            dvarsVec->getValues(len, nodes, dvars);
-            ddvarsVec->getValues(len, nodes, ddvars);
+    // Determine the values of the state variables for elemNum
+    int ptr = elementNodeIndex[elemNum];
+    int len = elementNodeIndex[elemNum + 1] - ptr;
+    const int *nodes = &elementTacsNodes[ptr];
+    xptVec->getValues(len, nodes, elemXpts);
+    varsVec->getValues(len, nodes, vars);
+    dvarsVec->getValues(len, nodes, dvars);
+    ddvarsVec->getValues(len, nodes, ddvars);
 
-            // Evaluate the element-wise sensitivity of the function
-            funcs[k]->getElementSVSens(elemNum, elements[elemNum], time, alpha,
-                                       beta, gamma, elemXpts, vars, dvars,
-                                       ddvars, elemRes);
-            dfdu[k]->setValues(len, nodes, elemRes, TACS_ADD_VALUES);
-          }
+    // Evaluate the element-wise sensitivity of the functions that do
+    // not share a point quantity
+    for (int j = 0; j < nf; j++) {
+      TACSFunction *func = funcs[funcNums[j]];
+      if (func->getPointQuantityType() < 0) {
+        func->getElementSVSens(elemNum, elements[elemNum], time, alpha, beta,
+                               gamma, elemXpts, vars, dvars, ddvars,
+                               &elemRes[j * maxElementSize]);
+      } else {
+        int numVars = elements[elemNum]->getNumVariables();
+        memset(&elemRes[j * maxElementSize], 0, numVars * sizeof(TacsScalar));
+      }
+    }
+
+    // Add the sensitivities for each group of functions that share a
+    // point quantity
+    int quantityType, numGroup;
+    const int *group;
+    while ((numGroup = work.evalNextGroup(
+                elemNum, elements[elemNum], time, elemXpts, vars, dvars,
+                ddvars, &quantityType, &group)) > 0) {
+      for (int g = 0; g < numGroup; g++) {
+        sens[g] = &elemRes[group[g] * maxElementSize];
+      }
+
+      int numPts = elements[elemNum]->getNumQuadraturePoints();
+      for (int n = 0; n < numPts; n++) {
+        double *pt;
+        const TacsScalar *dfdq, *dfddetXd;
+        if (work.getPointSens(n, &pt, &dfdq, &dfddetXd)) {
+          elements[elemNum]->addPointQuantitySVSensBatch(
+              elemNum, quantityType, time, alpha, beta, gamma, n, pt,
+              elemXpts, vars, dvars, ddvars, numGroup,
+              TACSFunctionSensWork::LD, dfdq, sens);
         }
       }
+    }
 
-      // Add the values into the array
+    for (int j = 0; j < nf; j++) {
+      dfdu[funcNums[j]]->setValues(len, nodes, &elemRes[j * maxElementSize],
+                                   TACS_ADD_VALUES);
+    }
+  }
+
+  delete[] elemRes;
+  delete[] sens;
+
+  // Add the values into the array
+  for (int k = 0; k < numFuncs; k++) {
+    if (funcs[k]) {
       dfdu[k]->beginSetValues(TACS_ADD_VALUES);
     }
   }
@@ -5033,6 +5851,52 @@ void TACSAssembler::addSVSens(TacsScalar alpha, TacsScalar beta,
 void TACSAssembler::addAdjointResProducts(TacsScalar scale, int numAdjoints,
                                           TACSBVec **adjoint, TACSBVec **dfdx,
                                           const TacsScalar lambda) {
+  addAdjointResProducts(scale, numAdjoints, adjoint, dfdx, NULL, lambda);
+}
+
+/**
+  Evaluate the product of several adjoint vectors with the derivative
+  of the residual w.r.t. the design variables and add the result to a
+  interleaved design vector.
+
+  The interleaved vector must be created by createInterleavedDesignVec() with
+  numAdjoints vectors and the full pattern, since the products are
+  non-zero for the design variables of all the elements. As with
+  addDVSensInterleaved(), the contributions for
+  all the adjoint vectors are communicated at once by a single call to
+  beginSetValues() and endSetValues() on the interleaved vector.
+
+  @param scale Scalar factor applied to the derivative
+  @param numAdjoints The number of adjoint vectors
+  @param adjoint The array of adjoint vectors
+  @param dfdx The interleaved derivative vector
+  @param lambda Scaling factor for the aux element contributions, by default 1
+*/
+void TACSAssembler::addAdjointResProductsInterleaved(TacsScalar scale,
+                                                     int numAdjoints,
+                                                     TACSBVec **adjoint,
+                                                     TACSInterleavedBVec *dfdx,
+                                                     const TacsScalar lambda) {
+  if (dfdx->getNumVecs() != numAdjoints ||
+      dfdx->getBlockSize() != designVarsPerNode) {
+    fprintf(stderr,
+            "[%d] TACSAssembler::addAdjointResProductsInterleaved: "
+            "Interleaved vector does not match the number of adjoints\n",
+            mpiRank);
+    return;
+  }
+  addAdjointResProducts(scale, numAdjoints, adjoint, NULL, dfdx, lambda);
+}
+
+/*
+  Add the adjoint-residual products to either the individual design
+  vectors or the interleaved design vector
+*/
+void TACSAssembler::addAdjointResProducts(TacsScalar scale, int numAdjoints,
+                                          TACSBVec **adjoint, TACSBVec **dfdx,
+                                          TACSInterleavedBVec *interleaved,
+                                          const TacsScalar lambda) {
+  TACS_PROFILE_SCOPE("TACSAssembler::addAdjointResProducts");
   // Distribute the design variable values to all processors
   for (int k = 0; k < numAdjoints; k++) {
     adjoint[k]->beginDistributeValues();
@@ -5058,6 +5922,8 @@ void TACSAssembler::addAdjointResProducts(TacsScalar scale, int numAdjoints,
   TacsScalar *fdvSens = elementSensData;
   int *dvNums = elementSensIData;
 
+  int nmissing = 0;
+
   // Set the data for the auxiliary elements - if there are any
   int naux = 0, aux_count = 0;
   TACSAuxElem *aux = NULL;
@@ -5089,7 +5955,11 @@ void TACSAssembler::addAdjointResProducts(TacsScalar scale, int numAdjoints,
       elements[i]->addAdjResProduct(i, time, scale, elemAdjoint, elemXpts, vars,
                                     dvars, ddvars, numDVs, fdvSens);
 
-      dfdx[k]->setValues(numDVs, dvNums, fdvSens, TACS_ADD_VALUES);
+      if (interleaved) {
+        nmissing += interleaved->addValues(k, numDVs, dvNums, fdvSens);
+      } else {
+        dfdx[k]->setValues(numDVs, dvNums, fdvSens, TACS_ADD_VALUES);
+      }
     }
 
     // Add the contribution from the auxiliary elements, scaled by lambda
@@ -5109,12 +5979,23 @@ void TACSAssembler::addAdjointResProducts(TacsScalar scale, int numAdjoints,
                                                 elemAdjoint, elemXpts, vars,
                                                 dvars, ddvars, numDVs, fdvSens);
 
-          dfdx[k]->setValues(numDVs, dvNums, fdvSens, TACS_ADD_VALUES);
+          if (interleaved) {
+            nmissing += interleaved->addValues(k, numDVs, dvNums, fdvSens);
+          } else {
+            dfdx[k]->setValues(numDVs, dvNums, fdvSens, TACS_ADD_VALUES);
+          }
         }
         aux_count++;
       }
     }
   }
+
+  if (nmissing > 0) {
+    fprintf(stderr,
+            "[%d] TACSAssembler::addAdjointResProductsInterleaved: %d design "
+            "variables are not in the pattern of the interleaved vector\n",
+            mpiRank, nmissing);
+  }
 }
 
 /**
@@ -5138,6 +6019,7 @@ void TACSAssembler::addAdjointResXptSensProducts(TacsScalar scale,
                                                  TACSBVec **adjoint,
                                                  TACSBVec **dfdXpt,
                                                  const TacsScalar lambda) {
+  TACS_PROFILE_SCOPE("TACSAssembler::addAdjointResXptSensProducts");
   for (int k = 0; k < numAdjoints; k++) {
     adjoint[k]->beginDistributeValues();
   }
@@ -5206,6 +6088,186 @@ void TACSAssembler::addAdjointResXptSensProducts(TacsScalar scale,
   }
 }
 
+/**
+  Evaluate the product of the derivative of the residual w.r.t. the
+  design variables with a design direction.
+
+  This function is collective on all TACSAssembler processes. This
+  computes the forward-mode (directional) derivative
+
+  res += scale*d(R)/dx*pdx
+
+  which is the transpose of the operation performed by
+  addAdjointResProducts. The entries of res associated with the
+  Dirichlet boundary conditions are zeroed.
+
+  @param scale Scalar factor applied to the derivative
+  @param pdx The design variable direction
+  @param res The output residual vector
+  @param lambda Scaling factor for the aux element contributions, by default 1
+*/
+void TACSAssembler::addResidualDVSensVecProduct(TacsScalar scale,
+                                                TACSBVec *pdx, TACSBVec *res,
+                                                const TacsScalar lambda) {
+  TACS_PROFILE_SCOPE("TACSAssembler::addResidualDVSensVecProduct");
+  // Distribute the non-local design direction values
+  pdx->beginDistributeValues();
+  pdx->endDistributeValues();
+
+  // Sort the list of auxiliary elements - this only performs the
+  // sort if it is required (if new elements are added)
+  if (auxElements) {
+    auxElements->sort();
+  }
+
+  // Retrieve pointers to temporary storage
+  TacsScalar *vars, *dvars, *ddvars, *elemRes, *elemXpts;
+  getDataPointers(elementData, &vars, &dvars, &ddvars, &elemRes, &elemXpts,
+                  NULL, NULL, NULL);
+
+  // Get the design variables from the elements on this process
+  const int maxDVs = maxElementDesignVars;
+  TacsScalar *elemPdx = elementSensData;
+  int *dvNums = elementSensIData;
+
+  // Allocate the scratch space for the element products
+  int dvSize = designVarsPerNode * maxElementDesignVars;
+  int sx = TACS_SPATIAL_DIM * maxElementNodes;
+  initThreadArenas();
+  TacsScalar *work = threadArenas[0]->allocateScalars(
+      maxElementSize + (dvSize > sx ? dvSize : sx));
+
+  // Set the data for the auxiliary elements - if there are any
+  int naux = 0, aux_count = 0;
+  TACSAuxElem *aux = NULL;
+  if (auxElements) {
+    naux = auxElements->getAuxElements(&aux);
+  }
+
+  for (int i = 0; i < numElements; i++) {
+    // Find the variables and nodes
+    int ptr = elementNodeIndex[i];
+    int len = elementNodeIndex[i + 1] - ptr;
+    const int *nodes = &elementTacsNodes[ptr];
+    xptVec->getValues(len, nodes, elemXpts);
+    varsVec->getValues(len, nodes, vars);
+    dvarsVec->getValues(len, nodes, dvars);
+    ddvarsVec->getValues(len, nodes, ddvars);
+
+    // Get the design direction for this element
+    int nvars = elements[i]->getNumVariables();
+    memset(elemRes, 0, nvars * sizeof(TacsScalar));
+    int numDVs = elements[i]->getDesignVarNums(i, maxDVs, dvNums);
+    pdx->getValues(numDVs, dvNums, elemPdx);
+    elements[i]->addResidualDVSensVecProduct(i, time, scale, elemXpts, vars,
+                                             dvars, ddvars, numDVs, elemPdx,
+                                             work, elemRes);
+
+    // Add the contribution from the auxiliary elements, scaled by lambda
+    while (aux_count < naux && aux[aux_count].num == i) {
+      numDVs = aux[aux_count].elem->getDesignVarNums(i, maxDVs, dvNums);
+      pdx->getValues(numDVs, dvNums, elemPdx);
+      aux[aux_count].elem->addResidualDVSensVecProduct(
+          i, time, lambda * scale, elemXpts, vars, dvars, ddvars, numDVs,
+          elemPdx, work, elemRes);
+      aux_count++;
+    }
+
+    res->setValues(len, nodes, elemRes, TACS_ADD_VALUES);
+  }
+
+  // Finish transmitting the product and zero the boundary conditions
+  res->beginSetValues(TACS_ADD_VALUES);
+  res->endSetValues(TACS_ADD_VALUES);
+  res->applyBCs(bcMap);
+}
+
+/**
+  Evaluate the product of the derivative of the residual w.r.t. the
+  nodal points with a direction in the node locations.
+
+  This function is collective on all TACSAssembler processes. This
+  computes the forward-mode (directional) derivative
+
+  res += scale*d(R)/d(Xpts)*pXpts
+
+  which is the transpose of the operation performed by
+  addAdjointResXptSensProducts. The entries of res associated with
+  the Dirichlet boundary conditions are zeroed.
+
+  @param scale Scalar factor applied to the derivative
+  @param pXpts The node location direction
+  @param res The output residual vector
+  @param lambda Scaling factor for the aux element contributions, by default 1
+*/
+void TACSAssembler::addResidualXptSensVecProduct(TacsScalar scale,
+                                                 TACSBVec *pXpts,
+                                                 TACSBVec *res,
+                                                 const TacsScalar lambda) {
+  TACS_PROFILE_SCOPE("TACSAssembler::addResidualXptSensVecProduct");
+  // Distribute the non-local node direction values
+  pXpts->beginDistributeValues();
+  pXpts->endDistributeValues();
+
+  // Sort the list of auxiliary elements - this only performs the
+  // sort if it is required (if new elements are added)
+  if (auxElements) {
+    auxElements->sort();
+  }
+
+  // Retrieve pointers to temporary storage
+  TacsScalar *vars, *dvars, *ddvars, *elemRes, *elemXpts, *elemPXpts;
+  getDataPointers(elementData, &vars, &dvars, &ddvars, &elemRes, &elemXpts,
+                  &elemPXpts, NULL, NULL);
+
+  // Allocate the scratch space for the element products
+  int dvSize = designVarsPerNode * maxElementDesignVars;
+  int sx = TACS_SPATIAL_DIM * maxElementNodes;
+  initThreadArenas();
+  TacsScalar *work = threadArenas[0]->allocateScalars(
+      maxElementSize + (dvSize > sx ? dvSize : sx));
+
+  // Set the data for the auxiliary elements - if there are any
+  int naux = 0, aux_count = 0;
+  TACSAuxElem *aux = NULL;
+  if (auxElements) {
+    naux = auxElements->getAuxElements(&aux);
+  }
+
+  for (int i = 0; i < numElements; i++) {
+    // Find the variables and nodes
+    int ptr = elementNodeIndex[i];
+    int len = elementNodeIndex[i + 1] - ptr;
+    const int *nodes = &elementTacsNodes[ptr];
+    xptVec->getValues(len, nodes, elemXpts);
+    varsVec->getValues(len, nodes, vars);
+    dvarsVec->getValues(len, nodes, dvars);
+    ddvarsVec->getValues(len, nodes, ddvars);
+    pXpts->getValues(len, nodes, elemPXpts);
+
+    int nvars = elements[i]->getNumVariables();
+    memset(elemRes, 0, nvars * sizeof(TacsScalar));
+    elements[i]->addResidualXptSensVecProduct(i, time, scale, elemXpts, vars,
+                                              dvars, ddvars, elemPXpts, work,
+                                              elemRes);
+
+    // Add the contribution from the auxiliary elements, scaled by lambda
+    while (aux_count < naux && aux[aux_count].num == i) {
+      aux[aux_count].elem->addResidualXptSensVecProduct(
+          i, time, lambda * scale, elemXpts, vars, dvars, ddvars, elemPXpts,
+          work, elemRes);
+      aux_count++;
+    }
+
+    res->setValues(len, nodes, elemRes, TACS_ADD_VALUES);
+  }
+
+  // Finish transmitting the product and zero the boundary conditions
+  res->beginSetValues(TACS_ADD_VALUES);
+  res->endSetValues(TACS_ADD_VALUES);
+  res->applyBCs(bcMap);
+}
+
 /**
   Evaluate the derivative of an inner product of two vectors with a
   matrix of a given type. This code does not explicitly evaluate the
@@ -5419,6 +6481,7 @@ void TACSAssembler::addJacobianVecProduct(TacsScalar scale, TacsScalar alpha,
                                           MatrixOrientation matOr,
                                           const TacsScalar lambda,
                                           const bool applyBCs) {
+  TACS_PROFILE_SCOPE("TACSAssembler::addJacobianVecProduct");
   x->beginDistributeValues();
   x->endDistributeValues();
 
@@ -5623,6 +6686,7 @@ void TACSAssembler::addMatrixFreeVecProduct(
     ElementMatrixType matType, const TacsScalar data[], TacsScalar temp[],
     TACSBVec *x, TACSBVec *y, MatrixOrientation matOr, const TacsScalar lambda,
     const bool applyBCs) {
+  TACS_PROFILE_SCOPE("TACSAssembler::addMatrixFreeVecProduct");
   x->beginDistributeValues();
   x->endDistributeValues();
 
@@ -6008,6 +7072,94 @@ void TACSAssembler::testFunction(TACSFunction *func, double dh) {
   Xvars->decref();
 }
 
+/**
+  Compute the relative cost of each element on this processor.
+
+  The costs can be gathered by the TACSCreator object and used as
+  vertex weights when the mesh is partitioned so that the work, rather
+  than the number of elements, is balanced across the processors.
+
+  The estimated cost is based on the number of quadrature points and
+  the size of the element Jacobian. The measured cost is the wall time
+  required to evaluate the element Jacobian (including any auxiliary
+  elements), which also captures the cost of the constitutive class.
+  The minimum over several passes is used to reduce timing noise.
+
+  @param cost_type The type of cost to compute
+  @param costs The cost of each local element (length numElements)
+*/
+void TACSAssembler::computeElementCosts(ElementCostType cost_type,
+                                        double *costs) {
+  if (!meshInitializedFlag) {
+    fprintf(stderr,
+            "[%d] Cannot call computeElementCosts() before initialize()\n",
+            mpiRank);
+    return;
+  }
+
+  if (cost_type == ESTIMATED_ELEMENT_COST) {
+    for (int i = 0; i < numElements; i++) {
+      double nvars = elements[i]->getNumVariables();
+      int nquad = elements[i]->getNumQuadraturePoints();
+      if (nquad < 1) {
+        nquad = 1;
+      }
+      costs[i] = nquad * nvars * nvars;
+    }
+    return;
+  }
+
+  // Sort the list of auxiliary elements - this call only performs the
+  // sort if it is required (if new elements are added)
+  if (auxElements) {
+    auxElements->sort();
+  }
+
+  // Retrieve pointers to temporary storage
+  TacsScalar *vars, *dvars, *ddvars, *elemRes, *elemXpts, *elemMat;
+  getDataPointers(elementData, &vars, &dvars, &ddvars, &elemRes, &elemXpts,
+                  NULL, NULL, &elemMat);
+
+  // Set the data for the auxiliary elements - if there are any
+  int naux = 0;
+  TACSAuxElem *aux = NULL;
+  if (auxElements) {
+    naux = auxElements->getAuxElements(&aux);
+  }
+
+  const int num_passes = 3;
+  for (int pass = 0; pass < num_passes; pass++) {
+    int aux_count = 0;
+    for (int i = 0; i < numElements; i++) {
+      int ptr = elementNodeIndex[i];
+      int len = elementNodeIndex[i + 1] - ptr;
+      const int *nodes = &elementTacsNodes[ptr];
+      xptVec->getValues(len, nodes, elemXpts);
+      varsVec->getValues(len, nodes, vars);
+      dvarsVec->getValues(len, nodes, dvars);
+      ddvarsVec->getValues(len, nodes, ddvars);
+
+      double t0 = MPI_Wtime();
+      int nvars = elements[i]->getNumVariables();
+      memset(elemRes, 0, nvars * sizeof(TacsScalar));
+      memset(elemMat, 0, nvars * nvars * sizeof(TacsScalar));
+      elements[i]->addJacobian(i, time, 1.0, 0.0, 0.0, elemXpts, vars, dvars,
+                               ddvars, elemRes, elemMat);
+      while (aux_count < naux && aux[aux_count].num == i) {
+        aux[aux_count].elem->addJacobian(i, time, 1.0, 0.0, 0.0, elemXpts,
+                                         vars, dvars, ddvars, elemRes,
+                                         elemMat);
+        aux_count++;
+      }
+      double t = MPI_Wtime() - t0;
+
+      if (pass == 0 || t < costs[i]) {
+        costs[i] = t;
+      }
+    }
+  }
+}
+
 /**
   Determine the number of components defined by elements in the
   TACSAssembler object.
@@ -31,9 +31,11 @@ class TACSAssembler;
 #include "TACSElement.h"
 #include "TACSFunction.h"
 #include "TACSObject.h"
+#include "TacsUtilities.h"
 
 // Linear algebra classes
 #include "TACSBVecDistribute.h"
+#include "TACSInterleavedBVec.h"
 #include "TACSParallelMat.h"
 #include "TACSSchurMat.h"
 #include "TACSSerialPivotMat.h"
@@ -77,6 +79,10 @@ class TACSAssembler : public TACSObject {
     DIRECT_SCHUR,
     GAUSS_SEIDEL
   };
+  enum ElementCostType {
+    ESTIMATED_ELEMENT_COST,  // Estimate from the element size
+    MEASURED_ELEMENT_COST    // Time the element Jacobian
+  };
 
   // Create the TACSAssembler object in parallel
   // -------------------------------------------
@@ -130,10 +136,16 @@ class TACSAssembler : public TACSObject {
   // -------------------
   int initialize();
 
+  // Group the elements by type for assembly after initialize()
+  // -----------------------------------------------------------
+  void computeElementOrdering();
+  int getElementOrdering(const int **groupPtr, const int **order);
+
   // Return important information about the TACSAssembler object
   // -----------------------------------------------------------
   MPI_Comm getMPIComm();
   TACSThreadInfo *getThreadInfo();
+  const char *getObjectName();
   int getVarsPerNode();
   int getDesignVarsPerNode();
   int getNumNodes();
@@ -259,6 +271,10 @@ class TACSAssembler : public TACSObject {
   // Design variable handling
   // ------------------------
   TACSBVec *createDesignVec();
+  TACSInterleavedBVec *createInterleavedDesignVec(int numVecs,
+                                                 TACSFunction **funcs = NULL);
+  void splitInterleavedDesignVec(TACSInterleavedBVec *interleaved,
+                                 int numVecs, TACSBVec **vecs);
   void getDesignVars(TACSBVec *dvs);
   void setDesignVars(TACSBVec *dvs);
   void getDesignVarRange(TACSBVec *lb, TACSBVec *ub);
@@ -282,6 +298,24 @@ class TACSAssembler : public TACSObject {
                                     TACSBVec **adjoint, TACSBVec **dfdXpts,
                                     const TacsScalar lambda = 1.0);
 
+  // Forward-mode products with the derivative of the residual
+  // ----------------------------------------------------------
+  void addResidualDVSensVecProduct(TacsScalar scale, TACSBVec *pdx,
+                                   TACSBVec *res,
+                                   const TacsScalar lambda = 1.0);
+  void addResidualXptSensVecProduct(TacsScalar scale, TACSBVec *pXpts,
+                                    TACSBVec *res,
+                                    const TacsScalar lambda = 1.0);
+
+  // Derivative evaluation into an interleaved design vector
+  // --------------------------------------------------------
+  void addDVSensInterleaved(TacsScalar coef, int numFuncs,
+                            TACSFunction **funcs, TACSInterleavedBVec *dfdx);
+  void addAdjointResProductsInterleaved(TacsScalar scale, int numAdjoints,
+                                        TACSBVec **adjoint,
+                                        TACSInterleavedBVec *dfdx,
+                                        const TacsScalar lambda = 1.0);
+
   // Advanced function interface - for time integration
   // --------------------------------------------------
   void integrateFunctions(TacsScalar tcoef, TACSFunction::EvaluationType ftype,
@@ -312,6 +346,10 @@ class TACSAssembler : public TACSObject {
                    double rtol = 1e-8, double atol = 1e-1);
   void testFunction(TACSFunction *func, double dh);
 
+  // Compute the relative cost of each local element
+  // ------------------------------------------------
+  void computeElementCosts(ElementCostType cost_type, double *costs);
+
   // Set the number of threads to work with
   // --------------------------------------
   void setNumThreads(int t);
@@ -365,6 +403,14 @@ class TACSAssembler : public TACSObject {
   // Scatter the boundary conditions on external nodes
   void scatterExternalBCs(TACSBcMap *bcs);
 
+  // Add the derivatives to the individual or interleaved design vectors
+  void addDVSens(TacsScalar coef, int numFuncs, TACSFunction **funcs,
+                 TACSBVec **dfdx, TACSInterleavedBVec *interleaved);
+  void addAdjointResProducts(TacsScalar scale, int numAdjoints,
+                             TACSBVec **adjoint, TACSBVec **dfdx,
+                             TACSInterleavedBVec *interleaved,
+                             const TacsScalar lambda);
+
   // Add values into the matrix
   inline void addMatValues(TACSMat *A, const int elemNum, const TacsScalar *mat,
                            int *item, TacsScalar *temp,
@@ -438,6 +484,34 @@ class TACSAssembler : public TACSObject {
   TacsScalar *elementData;  // Space for element residuals/matrices
   int *elementIData;        // Space for element index data
 
+  // The assembly order of the elements grouped by type, and the
+  // connectivity packed in that order
+  int numElementGroups;
+  int *elementGroupPtr;
+  int *elementOrder;
+  int *elementOrderNodeIndex, *elementOrderTacsNodes;
+
+  // Get the element index and nodes at a position in the assembly order
+  inline int getAssemblyElement(int k, int *len, const int **nodes) {
+    if (elementOrder) {
+      int ptr = elementOrderNodeIndex[k];
+      *len = elementOrderNodeIndex[k + 1] - ptr;
+      *nodes = &elementOrderTacsNodes[ptr];
+      return elementOrder[k];
+    }
+    int ptr = elementNodeIndex[k];
+    *len = elementNodeIndex[k + 1] - ptr;
+    *nodes = &elementTacsNodes[ptr];
+    return k;
+  }
+
+  // Find the first auxiliary element that is not before an element
+  int findAuxElement(int elemIndex, int start, int naux,
+                     const TACSAuxElem *aux);
+
+  // Add the element kernel flops to the current profiler scope
+  void addElementFlops(int jacobian);
+
   // Memory for the design variables and inddex data
   TacsScalar *elementSensData;
   int *elementSensIData;
@@ -453,6 +527,7 @@ class TACSAssembler : public TACSObject {
   // The static member functions that are used to p-thread TACSAssembler
   // operations... These are the most time-consuming operations.
   static void schedPthreadJob(TACSAssembler *tacs, int *index, int total_size);
+  static TACSArena *schedPthreadArena(TACSAssembler *tacs);
   static void *assembleRes_thread(void *t);
   static void *assembleJacobian_thread(void *t);
   static void *assembleMatType_thread(void *t);
@@ -518,6 +593,13 @@ class TACSAssembler : public TACSObject {
   pthread_t threads[TACSThreadInfo::TACS_MAX_NUM_THREADS];
   pthread_mutex_t tacs_mutex;  // The mutex for coordinating assembly ops.
 
+  // Allocate and reset the arenas for the per-thread temporary arrays
+  void initThreadArenas();
+
+  // The arenas for the temporary arrays, one for each thread
+  int numArenasInUse;
+  TACSArena *threadArenas[TACSThreadInfo::TACS_MAX_NUM_THREADS];
+
   // The name of the TACSAssembler object
   static const char *tacsName;
 };
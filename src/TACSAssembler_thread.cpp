@@ -38,6 +38,59 @@ void TACSAssembler::schedPthreadJob(TACSAssembler *assembler, int *index,
   pthread_mutex_unlock(&sched_mutex);
 }
 
+/*!
+  Hand out one of the arenas to each thread
+*/
+TACSArena *TACSAssembler::schedPthreadArena(TACSAssembler *assembler) {
+  pthread_mutex_lock(&sched_mutex);
+  TACSArena *arena = assembler->threadArenas[assembler->numArenasInUse];
+  assembler->numArenasInUse += 1;
+  pthread_mutex_unlock(&sched_mutex);
+
+  arena->reset();
+  return arena;
+}
+
+/*!
+  Allocate the arenas for the temporary arrays used by the assembly
+  operations, one for each thread.
+
+  Each arena is sized once from the largest element so that it can
+  hold all the arrays required by any of the assembly operations:
+  four element variable-size arrays, the node locations, the weights,
+  two element matrices, the index data and the scratch space for the
+  element residual direction products.
+*/
+void TACSAssembler::initThreadArenas() {
+  int s = maxElementSize;
+  int sx = TACS_SPATIAL_DIM * maxElementNodes;
+  int sw = maxElementIndepNodes;
+  int sd = designVarsPerNode * maxElementDesignVars;
+
+  size_t size = 4 * TACSArena::getAlignedSize(s * sizeof(TacsScalar)) +
+                TACSArena::getAlignedSize(sx * sizeof(TacsScalar)) +
+                TACSArena::getAlignedSize(sw * sizeof(TacsScalar)) +
+                2 * TACSArena::getAlignedSize(s * s * sizeof(TacsScalar)) +
+                TACSArena::getAlignedSize((s + (sd > sx ? sd : sx)) *
+                                          sizeof(TacsScalar)) +
+                TACSArena::getAlignedSize((sw + maxElementNodes + 1) *
+                                          sizeof(int));
+
+  for (int k = 0; k < thread_info->getNumThreads(); k++) {
+    if (threadArenas[k] && threadArenas[k]->getSize() < size) {
+      threadArenas[k]->decref();
+      threadArenas[k] = NULL;
+    }
+    if (!threadArenas[k]) {
+      threadArenas[k] = new TACSArena(size);
+      threadArenas[k]->incref();
+      threadArenas[k]->setMemoryOwner(tacsName);
+    }
+    threadArenas[k]->reset();
+  }
+  numArenasInUse = 0;
+}
+
 /*!
   The threaded-implementation of the residual assembly
 
@@ -54,18 +107,15 @@ void *TACSAssembler::assembleRes_thread(void *t) {
   TACSBVec *res = pinfo->res;
   TacsScalar lambda = pinfo->lambda;
 
-  // Allocate a temporary array large enough to store everything required
+  // Allocate the temporary arrays from the arena for this thread
+  TACSArena *arena = TACSAssembler::schedPthreadArena(assembler);
   int s = assembler->maxElementSize;
-  int sx = 3 * assembler->maxElementNodes;
-  int dataSize = 4 * s + sx;
-  TacsScalar *data = new TacsScalar[dataSize];
-
-  // Set pointers to the allocate memory
-  TacsScalar *vars = &data[0];
-  TacsScalar *dvars = &data[s];
-  TacsScalar *ddvars = &data[2 * s];
-  TacsScalar *elemRes = &data[3 * s];
-  TacsScalar *elemXpts = &data[4 * s];
+  int sx = TACS_SPATIAL_DIM * assembler->maxElementNodes;
+  TacsScalar *vars = arena->allocateScalars(s);
+  TacsScalar *dvars = arena->allocateScalars(s);
+  TacsScalar *ddvars = arena->allocateScalars(s);
+  TacsScalar *elemRes = arena->allocateScalars(s);
+  TacsScalar *elemXpts = arena->allocateScalars(sx);
 
   // Set the data for the auxiliary elements - if there are any
   int naux = 0, aux_count = 0;
@@ -75,39 +125,34 @@ void *TACSAssembler::assembleRes_thread(void *t) {
   }
   // To avoid allocating memory inside the element loop, make the aux element
   // contribution array big enough for the largest element
-  TacsScalar *auxElemRes;
+  TacsScalar *auxElemRes = NULL;
   bool scaleAux = lambda != TacsScalar(1.0) && naux > 0;
   if (scaleAux) {
-    auxElemRes = new TacsScalar[s];
+    auxElemRes = arena->allocateScalars(s);
   }
 
   while (assembler->numCompletedElements < assembler->numElements) {
-    int elemIndex = -1;
-    TACSAssembler::schedPthreadJob(assembler, &elemIndex,
-                                   assembler->numElements);
-
-    if (elemIndex >= 0) {
-      // Get the element object
+    int k = -1;
+    TACSAssembler::schedPthreadJob(assembler, &k, assembler->numElements);
+
+    if (k >= 0) {
+      // Retrieve the element and the variable values
+      int len;
+      const int *nodes;
+      int elemIndex = assembler->getAssemblyElement(k, &len, &nodes);
       TACSElement *element = assembler->elements[elemIndex];
-
-      // Retrieve the variable values
-      int ptr = assembler->elementNodeIndex[elemIndex];
-      int len = assembler->elementNodeIndex[elemIndex + 1] - ptr;
-      const int *nodes = &assembler->elementTacsNodes[ptr];
       assembler->xptVec->getValues(len, nodes, elemXpts);
       assembler->varsVec->getValues(len, nodes, vars);
       assembler->dvarsVec->getValues(len, nodes, dvars);
       assembler->ddvarsVec->getValues(len, nodes, ddvars);
 
-      // Generate the Jacobian of the element
+      // Generate the residual of the element
+      memset(elemRes, 0, element->getNumVariables() * sizeof(TacsScalar));
       element->addResidual(elemIndex, assembler->time, elemXpts, vars, dvars,
                            ddvars, elemRes);
 
-      // Increment the aux counter until we possibly have
-      // aux[aux_count].num == elemIndex
-      while (aux_count < naux && aux[aux_count].num < elemIndex) {
-        aux_count++;
-      }
+      // Find the first aux element with aux[aux_count].num >= elemIndex
+      aux_count = assembler->findAuxElement(elemIndex, aux_count, naux, aux);
 
       // Add the residual from any auxiliary elements, if the load factor is 1
       // they can be added straight to the elemRes, otherwise they need to be
@@ -136,10 +181,6 @@ void *TACSAssembler::assembleRes_thread(void *t) {
       pthread_mutex_unlock(&assembler->tacs_mutex);
     }
   }
-  if (scaleAux) {
-    delete[] auxElemRes;
-  }
-  delete[] data;
 
   pthread_exit(NULL);
 }
@@ -166,23 +207,19 @@ void *TACSAssembler::assembleJacobian_thread(void *t) {
   TacsScalar lambda = pinfo->lambda;
   MatrixOrientation matOr = pinfo->matOr;
 
-  // Allocate a temporary array large enough to store everything
-  // required
+  // Allocate the temporary arrays from the arena for this thread
+  TACSArena *arena = TACSAssembler::schedPthreadArena(assembler);
   int s = assembler->maxElementSize;
-  int sx = 3 * assembler->maxElementNodes;
+  int sx = TACS_SPATIAL_DIM * assembler->maxElementNodes;
   int sw = assembler->maxElementIndepNodes;
-  int dataSize = 4 * s + sx + s * s + sw;
-  TacsScalar *data = new TacsScalar[dataSize];
-  int *idata = new int[sw + assembler->maxElementNodes + 1];
-
-  // Set pointers to the allocate memory
-  TacsScalar *vars = &data[0];
-  TacsScalar *dvars = &data[s];
-  TacsScalar *ddvars = &data[2 * s];
-  TacsScalar *elemRes = &data[3 * s];
-  TacsScalar *elemXpts = &data[4 * s];
-  TacsScalar *elemWeights = &data[4 * s + sx];
-  TacsScalar *elemMat = &data[4 * s + sx + sw];
+  TacsScalar *vars = arena->allocateScalars(s);
+  TacsScalar *dvars = arena->allocateScalars(s);
+  TacsScalar *ddvars = arena->allocateScalars(s);
+  TacsScalar *elemRes = arena->allocateScalars(s);
+  TacsScalar *elemXpts = arena->allocateScalars(sx);
+  TacsScalar *elemWeights = arena->allocateScalars(sw);
+  TacsScalar *elemMat = arena->allocateScalars(s * s);
+  int *idata = arena->allocateInts(sw + assembler->maxElementNodes + 1);
 
   // Set the data for the auxiliary elements - if there are any
   int naux = 0, aux_count = 0;
@@ -192,18 +229,15 @@ void *TACSAssembler::assembleJacobian_thread(void *t) {
   }
 
   while (assembler->numCompletedElements < assembler->numElements) {
-    int elemIndex = -1;
-    TACSAssembler::schedPthreadJob(assembler, &elemIndex,
-                                   assembler->numElements);
-
-    if (elemIndex >= 0) {
-      // Get the element object
+    int k = -1;
+    TACSAssembler::schedPthreadJob(assembler, &k, assembler->numElements);
+
+    if (k >= 0) {
+      // Retrieve the element and the variable values
+      int len;
+      const int *nodes;
+      int elemIndex = assembler->getAssemblyElement(k, &len, &nodes);
       TACSElement *element = assembler->elements[elemIndex];
-
-      // Retrieve the variable values
-      int ptr = assembler->elementNodeIndex[elemIndex];
-      int len = assembler->elementNodeIndex[elemIndex + 1] - ptr;
-      const int *nodes = &assembler->elementTacsNodes[ptr];
       assembler->xptVec->getValues(len, nodes, elemXpts);
       assembler->varsVec->getValues(len, nodes, vars);
       assembler->dvarsVec->getValues(len, nodes, dvars);
@@ -218,11 +252,8 @@ void *TACSAssembler::assembleJacobian_thread(void *t) {
       element->addJacobian(elemIndex, assembler->time, alpha, beta, gamma,
                            elemXpts, vars, dvars, ddvars, elemRes, elemMat);
 
-      // Increment the aux counter until we possibly have
-      // aux[aux_count].num == elemIndex
-      while (aux_count < naux && aux[aux_count].num < elemIndex) {
-        aux_count++;
-      }
+      // Find the first aux element with aux[aux_count].num >= elemIndex
+      aux_count = assembler->findAuxElement(elemIndex, aux_count, naux, aux);
 
       // Add the residual from the auxiliary elements
       while (aux_count < naux && aux[aux_count].num == elemIndex) {
@@ -244,9 +275,6 @@ void *TACSAssembler::assembleJacobian_thread(void *t) {
     }
   }
 
-  delete[] data;
-  delete[] idata;
-
   pthread_exit(NULL);
 }
 
@@ -271,18 +299,16 @@ void *TACSAssembler::assembleMatType_thread(void *t) {
   MatrixOrientation matOr = pinfo->matOr;
   TacsScalar lambda = pinfo->lambda;
 
-  // Allocate a temporary array large enough to store everything required
+  // Allocate the temporary arrays from the arena for this thread
+  TACSArena *arena = TACSAssembler::schedPthreadArena(assembler);
   int s = assembler->maxElementSize;
-  int sx = 3 * assembler->maxElementNodes;
+  int sx = TACS_SPATIAL_DIM * assembler->maxElementNodes;
   int sw = assembler->maxElementIndepNodes;
-  int dataSize = s + sx + s * s + sw;
-  TacsScalar *data = new TacsScalar[dataSize];
-  int *idata = new int[sw + assembler->maxElementNodes + 1];
-
-  TacsScalar *vars = &data[0];
-  TacsScalar *elemXpts = &data[s];
-  TacsScalar *elemWeights = &data[s + sx];
-  TacsScalar *elemMat = &data[s + sx + sw];
+  TacsScalar *vars = arena->allocateScalars(s);
+  TacsScalar *elemXpts = arena->allocateScalars(sx);
+  TacsScalar *elemWeights = arena->allocateScalars(sw);
+  TacsScalar *elemMat = arena->allocateScalars(s * s);
+  int *idata = arena->allocateInts(sw + assembler->maxElementNodes + 1);
 
   // Set the data for the auxiliary elements - if there are any
   int naux = 0, aux_count = 0;
@@ -290,26 +316,22 @@ void *TACSAssembler::assembleMatType_thread(void *t) {
   if (assembler->auxElements) {
     naux = assembler->auxElements->getAuxElements(&aux);
   }
-  TacsScalar *auxElemMat;
+  TacsScalar *auxElemMat = NULL;
   bool scaleAux = lambda != TacsScalar(1.0) && naux > 0;
   if (scaleAux) {
-    auxElemMat = new TacsScalar[s * s];
+    auxElemMat = arena->allocateScalars(s * s);
   }
 
   while (assembler->numCompletedElements < assembler->numElements) {
-    int elemIndex = -1;
-    TACSAssembler::schedPthreadJob(assembler, &elemIndex,
-                                   assembler->numElements);
-
-    if (elemIndex >= 0) {
-      // Get the element
+    int k = -1;
+    TACSAssembler::schedPthreadJob(assembler, &k, assembler->numElements);
+
+    if (k >= 0) {
+      // Retrieve the element and the variable values
+      int len;
+      const int *nodes;
+      int elemIndex = assembler->getAssemblyElement(k, &len, &nodes);
       TACSElement *element = assembler->elements[elemIndex];
-
-      // Retrieve the variable values
-      // Retrieve the variable values
-      int ptr = assembler->elementNodeIndex[elemIndex];
-      int len = assembler->elementNodeIndex[elemIndex + 1] - ptr;
-      const int *nodes = &assembler->elementTacsNodes[ptr];
       assembler->xptVec->getValues(len, nodes, elemXpts);
       assembler->varsVec->getValues(len, nodes, vars);
 
@@ -317,11 +339,8 @@ void *TACSAssembler::assembleMatType_thread(void *t) {
       element->getMatType(matType, elemIndex, assembler->time, elemXpts, vars,
                           elemMat);
 
-      // Increment the aux counter until we possibly have
-      // aux[aux_count].num == elemIndex
-      while (aux_count < naux && aux[aux_count].num < elemIndex) {
-        aux_count++;
-      }
+      // Find the first aux element with aux[aux_count].num >= elemIndex
+      aux_count = assembler->findAuxElement(elemIndex, aux_count, naux, aux);
 
       // Add the contribution from any auxiliary elements, if the load factor is
       // 1 they can be added straight to the elemRes, otherwise they need to be
@@ -350,10 +369,6 @@ void *TACSAssembler::assembleMatType_thread(void *t) {
       pthread_mutex_unlock(&assembler->tacs_mutex);
     }
   }
-  if (scaleAux) {
-    delete[] auxElemMat;
-  }
-  delete[] data;
 
   pthread_exit(NULL);
 }
@@ -14,6 +14,7 @@
 
 #include "TACSCreator.h"
 
+#include "TACSProfiler.h"
 #include "TacsUtilities.h"
 #include "tacsmetis.h"
 
@@ -328,6 +329,57 @@ int TACSCreator::getElementPartition(const int **_partition) {
   return num_elements;
 }
 
+/*
+  Gather the costs of the elements from the TACSAssembler object
+  created by this object onto the root processor.
+
+  This function is collective on all processors. The local costs must
+  be in the element order of the TACSAssembler object created by the
+  last call to createTACS(). On the root processor, the costs are
+  returned in the original global element order so that they can be
+  passed to partitionMesh(). The elem_costs array is only referenced
+  on the root processor and must be of length num_elements.
+
+  input:
+  local_costs:     the cost of each element on this processor
+
+  output:
+  elem_costs:      the cost of each element in the global ordering
+*/
+void TACSCreator::gatherElementCosts(const double *local_costs,
+                                     double *elem_costs) {
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  int *ptr = NULL;
+  double *all_costs = NULL;
+  if (rank == root_rank) {
+    ptr = new int[size + 1];
+    ptr[0] = 0;
+    for (int k = 0; k < size; k++) {
+      ptr[k + 1] = ptr[k] + owned_elements[k];
+    }
+    all_costs = new double[num_elements];
+  }
+
+  MPI_Gatherv((void *)local_costs, num_owned_elements, MPI_DOUBLE, all_costs,
+              owned_elements, ptr, MPI_DOUBLE, root_rank, comm);
+
+  if (rank == root_rank) {
+    // The elements on each processor are ordered in ascending
+    // global order, so the costs can be placed in a single pass
+    for (int i = 0; i < num_elements; i++) {
+      int owner = partition[i];
+      elem_costs[i] = all_costs[ptr[owner]];
+      ptr[owner]++;
+    }
+
+    delete[] ptr;
+    delete[] all_costs;
+  }
+}
+
 /*
   Get the number of nodes owned by each processor
 */
@@ -434,6 +486,7 @@ void TACSCreator::getAssemblerNodeNums(TACSAssembler *assembler,
   allocated and returns a valid instance of the TACSAssembler object.
 */
 TACSAssembler *TACSCreator::createTACS() {
+  TACS_PROFILE_SCOPE("TACSCreator::createTACS");
   int size, rank;
   MPI_Comm_size(comm, &size);
   MPI_Comm_rank(comm, &rank);
@@ -463,6 +516,9 @@ TACSAssembler *TACSCreator::createTACS() {
 
   // This will be used later to determine which elements belong to
   // which domain within the finite-element mesh
+  if (local_elem_id_nums) {
+    delete[] local_elem_id_nums;
+  }
   local_elem_id_nums = new int[num_owned_elements];
 
   // Loacal nodal information
@@ -475,12 +531,6 @@ TACSAssembler *TACSCreator::createTACS() {
 
   // For each processor, send the information to the owner
   if (rank == root_rank) {
-    // Reset the nodes for the boundary conditions so that they
-    // correspond to the new ordering
-    for (int j = 0; j < num_bcs; j++) {
-      bc_nodes[j] = new_nodes[bc_nodes[j]];
-    }
-
     // Find the inverse mapping between the new and old node
     // numbers so that it's faster to access
     int *inv_new_nodes = new int[num_nodes];
@@ -746,43 +796,34 @@ TACSAssembler *TACSCreator::createTACS() {
              &status);
   }
 
-  // Broadcast the boundary condition information
+  // Broadcast the boundary condition information in the new node
+  // ordering. The original data is kept on the root processor so that
+  // the mesh can be repartitioned and a new TACSAssembler created.
   MPI_Bcast(&num_bcs, 1, MPI_INT, root_rank, comm);
 
+  int *local_bc_nodes = NULL, *local_bc_ptr = NULL, *local_bc_vars = NULL;
+  TacsScalar *local_bc_vals = NULL;
   if (num_bcs > 0) {
-    // Broadcast all the boundary conditions to all processors
-    if (rank != root_rank) {
-      if (bc_nodes) {
-        delete[] bc_nodes;
+    local_bc_nodes = new int[num_bcs];
+    local_bc_ptr = new int[num_bcs + 1];
+    if (rank == root_rank) {
+      for (int j = 0; j < num_bcs; j++) {
+        local_bc_nodes[j] = new_nodes[bc_nodes[j]];
       }
-      bc_nodes = new int[num_bcs];
+      memcpy(local_bc_ptr, bc_ptr, (num_bcs + 1) * sizeof(int));
     }
-    MPI_Bcast(bc_nodes, num_bcs, MPI_INT, root_rank, comm);
-
-    // Broacast the boundary condition pointer array
-    if (rank != root_rank) {
-      if (bc_ptr) {
-        delete[] bc_ptr;
-      }
-      bc_ptr = new int[num_bcs + 1];
+    MPI_Bcast(local_bc_nodes, num_bcs, MPI_INT, root_rank, comm);
+    MPI_Bcast(local_bc_ptr, num_bcs + 1, MPI_INT, root_rank, comm);
+
+    int bc_len = local_bc_ptr[num_bcs];
+    local_bc_vars = new int[bc_len];
+    local_bc_vals = new TacsScalar[bc_len];
+    if (rank == root_rank) {
+      memcpy(local_bc_vars, bc_vars, bc_len * sizeof(int));
+      memcpy(local_bc_vals, bc_vals, bc_len * sizeof(TacsScalar));
     }
-    MPI_Bcast(bc_ptr, num_bcs + 1, MPI_INT, root_rank, comm);
-
-    if (rank != root_rank) {
-      if (bc_vars) {
-        delete[] bc_vars;
-      }
-      bc_vars = new int[bc_ptr[num_bcs]];
-    }
-    MPI_Bcast(bc_vars, bc_ptr[num_bcs], MPI_INT, root_rank, comm);
-
-    if (rank != root_rank) {
-      if (bc_vals) {
-        delete[] bc_vals;
-      }
-      bc_vals = new TacsScalar[bc_ptr[num_bcs]];
-    }
-    MPI_Bcast(bc_vals, bc_ptr[num_bcs], TACS_MPI_TYPE, root_rank, comm);
+    MPI_Bcast(local_bc_vars, bc_len, MPI_INT, root_rank, comm);
+    MPI_Bcast(local_bc_vals, bc_len, TACS_MPI_TYPE, root_rank, comm);
   }
 
   TACSAssembler *tacs =
@@ -843,18 +884,18 @@ TACSAssembler *TACSCreator::createTACS() {
 
   // Set the boundary conditions
   for (int k = 0; k < num_bcs; k++) {
-    if (bc_nodes[k] >= 0) {
-      int nbcs = bc_ptr[k + 1] - bc_ptr[k];
+    if (local_bc_nodes[k] >= 0) {
+      int nbcs = local_bc_ptr[k + 1] - local_bc_ptr[k];
       int n = 0;
       for (int j = 0; j < nbcs; j++) {
-        if (bc_vars[bc_ptr[k] + j] < vars_per_node) {
-          bvars[n] = bc_vars[bc_ptr[k] + j];
-          bvals[n] = bc_vals[bc_ptr[k] + j];
+        if (local_bc_vars[local_bc_ptr[k] + j] < vars_per_node) {
+          bvars[n] = local_bc_vars[local_bc_ptr[k] + j];
+          bvals[n] = local_bc_vals[local_bc_ptr[k] + j];
           n++;
         }
       }
       if (n > 0) {
-        tacs->addBCs(1, &bc_nodes[k], n, bvars, bvals);
+        tacs->addBCs(1, &local_bc_nodes[k], n, bvars, bvals);
       }
     }
   }
@@ -863,15 +904,13 @@ TACSAssembler *TACSCreator::createTACS() {
   delete[] bvars;
   delete[] bvals;
 
-  // We no longer need the boundary condition information
-  delete[] bc_nodes;
-  bc_nodes = NULL;
-  delete[] bc_ptr;
-  bc_ptr = NULL;
-  delete[] bc_vars;
-  bc_vars = NULL;
-  delete[] bc_vals;
-  bc_vals = NULL;
+  // Free the local copy of the boundary condition information
+  if (num_bcs > 0) {
+    delete[] local_bc_nodes;
+    delete[] local_bc_ptr;
+    delete[] local_bc_vars;
+    delete[] local_bc_vals;
+  }
 
   // Use the reordering if the flag has been set in the
   // TACSCreator object
@@ -916,11 +955,21 @@ TACSAssembler *TACSCreator::createTACS() {
   first forms the dual mesh with an element->element data structure.
   The function then calls METIS to partition the mesh.
 
+  When the element costs are provided, they are used as the vertex
+  weights in METIS so that the partition balances the total cost on
+  each processor instead of the number of elements. The costs can be
+  computed with TACSAssembler::computeElementCosts() and collected
+  with gatherElementCosts(). The mesh is always re-partitioned when
+  the costs are provided, even if a partition already exists.
+
   input:
   split_size:      the number of segments in the partition
   part:            (optional) the specified partition
+  elem_costs:      (optional) the cost of each element
 */
-void TACSCreator::partitionMesh(int split_size, const int *part) {
+void TACSCreator::partitionMesh(int split_size, const int *part,
+                                const double *elem_costs) {
+  TACS_PROFILE_SCOPE("TACSCreator::partitionMesh");
   int rank;
   MPI_Comm_rank(comm, &rank);
   if (rank != root_rank) {
@@ -972,6 +1021,10 @@ void TACSCreator::partitionMesh(int split_size, const int *part) {
       partition = new int[num_elements];
       memcpy(partition, part, num_elements * sizeof(int));
     }
+  } else if (elem_costs && partition) {
+    // Discard the old partition so that a new one is computed
+    delete[] partition;
+    partition = NULL;
   }
 
   if (!partition) {
@@ -1104,6 +1157,30 @@ void TACSCreator::partitionMesh(int split_size, const int *part) {
     if (split_size > 1) {
       int ncon = 1;  // "It should be at least 1"??
 
+      // Convert the element costs to integer vertex weights, scaled
+      // so that the average element has a weight of 100
+      int *vwgt = NULL;
+      if (elem_costs) {
+        double avg = 0.0;
+        for (int i = 0; i < num_elements; i++) {
+          if (elem_costs[i] > 0.0) {
+            avg += elem_costs[i];
+          }
+        }
+        avg /= num_elements;
+
+        vwgt = new int[num_elements];
+        for (int i = 0; i < num_elements; i++) {
+          vwgt[i] = 1;
+          if (avg > 0.0 && elem_costs[i] > 0.0) {
+            int w = (int)(100.0 * elem_costs[i] / avg + 0.5);
+            if (w > 1) {
+              vwgt[i] = w;
+            }
+          }
+        }
+      }
+
       // Set the default options
       int options[METIS_NOPTIONS];
       METIS_SetDefaultOptions(options);
@@ -1116,13 +1193,17 @@ void TACSCreator::partitionMesh(int split_size, const int *part) {
 
       if (split_size < 8) {
         METIS_PartGraphRecursive(&num_elements, &ncon, elem_ptr, elem_conn,
-                                 NULL, NULL, NULL, &split_size, NULL, NULL,
+                                 vwgt, NULL, NULL, &split_size, NULL, NULL,
                                  options, &objval, partition);
       } else {
-        METIS_PartGraphKway(&num_elements, &ncon, elem_ptr, elem_conn, NULL,
+        METIS_PartGraphKway(&num_elements, &ncon, elem_ptr, elem_conn, vwgt,
                             NULL, NULL, &split_size, NULL, NULL, options,
                             &objval, partition);
       }
+
+      if (vwgt) {
+        delete[] vwgt;
+      }
     } else {
       // If there is no split, just assign all elements to the
       // root processor
@@ -35,6 +35,12 @@
   The user may wish to modify the ordering of TACS. This can be done
   by specifying the reordering type prior to calling createTACS().
 
+  The mesh can be partitioned using the cost of each element as a
+  weight, for instance with costs measured by TACSAssembler. The global
+  mesh is retained on the root processor, so the mesh can be
+  re-partitioned and a new TACSAssembler created with createTACS()
+  without setting the mesh data again.
+
   The new node numbers and new element partition can be retrieved from
   the creator object using the getNodeNums()/getElementPartion().
   Note that it is guaranteed that on each partiton, the elements will
@@ -77,7 +83,8 @@ class TACSCreator : public TACSObject {
 
   // Partition the mesh
   // ------------------
-  void partitionMesh(int split_size = 0, const int *part = NULL);
+  void partitionMesh(int split_size = 0, const int *part = NULL,
+                     const double *elem_costs = NULL);
 
   // Set the elements into TACS creator
   // ----------------------------------
@@ -105,6 +112,10 @@ class TACSCreator : public TACSObject {
   void getNumOwnedNodes(int **_owned_nodes);
   void getNumOwnedElements(int **_owned_elements);
 
+  // Gather the local element costs in the global element order
+  // -----------------------------------------------------------
+  void gatherElementCosts(const double *local_costs, double *elem_costs);
+
  private:
   // The magic element-generator function pointer
   TACSElement *(*element_creator)(int local, int elem_id);
@@ -17,8 +17,20 @@
 #include <math.h>
 
 #include "TACSMg.h"
+#include "TACSProfiler.h"
 #include "tacslapack.h"
 
+/*
+  Create a state vector for the time history, attributing its memory
+  to the integrator
+*/
+static TACSBVec *TacsCreateStateVec(TACSAssembler *assembler) {
+  TACSBVec *vec = assembler->createVec();
+  vec->incref();
+  vec->setMemoryOwner("TACSIntegrator");
+  return vec;
+}
+
 /*
   Base class constructor for integration schemes.
 
@@ -28,17 +40,20 @@
   tfinal:             the final time
   num_steps_per_sec:  the number of steps to take for each second
 */
-TACSIntegrator::TACSIntegrator(TACSAssembler *_assembler, double tinit,
-                               double tfinal, double num_steps) {
+TACSIntegrator::TACSIntegrator(TACSAssembler *_assembler, double _tinit,
+                               double _tfinal, double num_steps) {
   // Copy over the input parameters
   assembler = _assembler;
   assembler->incref();
+  tinit = _tinit;
+  tfinal = _tfinal;
 
   // Set the default prefix = results
   snprintf(prefix, sizeof(prefix), "./");
 
   // Allocate the total number of time steps
   num_time_steps = int(num_steps);
+  step_capacity = num_time_steps;
 
   // Store physical time of simulation
   time = new double[num_time_steps + 1];
@@ -65,12 +80,9 @@ TACSIntegrator::TACSIntegrator(TACSAssembler *_assembler, double tinit,
 
   // create state vectors for TACS during each timestep
   for (int k = 0; k < num_time_steps + 1; k++) {
-    q[k] = assembler->createVec();
-    q[k]->incref();
-    qdot[k] = assembler->createVec();
-    qdot[k]->incref();
-    qddot[k] = assembler->createVec();
-    qddot[k]->incref();
+    q[k] = TacsCreateStateVec(assembler);
+    qdot[k] = TacsCreateStateVec(assembler);
+    qddot[k] = TacsCreateStateVec(assembler);
   }
 
   // Objects to store information about the functions of interest
@@ -101,6 +113,19 @@ TACSIntegrator::TACSIntegrator(TACSAssembler *_assembler, double tinit,
   init_newton_delta = 0.0;
   jac_comp_freq = 1;
 
+  // Assemble and factor the Jacobian within each Newton iteration
+  use_matrix_free = 0;
+  adaptive_jac = 0;
+  max_contraction = 0.5;
+  jac_current = 0;
+  jac_alpha = jac_beta = jac_gamma = 0.0;
+  mf_mat = NULL;
+  mf_ksm = NULL;
+  mf_rtol = 1e-3;
+  mf_atol = 1e-30;
+  num_jac_updates = 0;
+  num_lin_iters = 0;
+
   // Set the default LINEAR solver
   use_lapack = 0;
   use_schur_mat = 1;
@@ -119,6 +144,39 @@ TACSIntegrator::TACSIntegrator(TACSAssembler *_assembler, double tinit,
   // Tecplot solution export
   f5_write_freq = 0;
 
+  // Use the uniform time steps by default
+  adaptive_step = 0;
+  step_rtol = 1e-3;
+  step_atol = 1e-6;
+  min_step = 0.0;
+  max_step = 0.0;
+  trial_step = 0;
+  num_rejected_steps = 0;
+
+  // No checkpoints are written and the integration starts from scratch
+  checkpoint_freq = 0;
+  checkpoint_file = NULL;
+  checkpoint_step = -1;
+  restart_step = -1;
+  restart_adjoint_step = -1;
+
+  // Store the full state history by default
+  num_snapshots = 0;
+  step_window = 0;
+  step_pins = NULL;
+  snapshot_steps = NULL;
+  num_pinned = 0;
+  next_snapshot = -1;
+  num_free_vecs = 0;
+  free_vecs = NULL;
+  step_forces = NULL;
+  step_aux = NULL;
+  replaying = 0;
+  num_stored_steps = num_time_steps + 1;
+  max_stored_steps = num_time_steps + 1;
+  num_recompute_steps = 0;
+  time_recompute = 0.0;
+
   // Set the rigid and shell visualization objects to NULL
   f5 = NULL;
 
@@ -130,16 +188,42 @@ TACSIntegrator::TACSIntegrator(TACSAssembler *_assembler, double tinit,
   Destructor for base class resources
 */
 TACSIntegrator::~TACSIntegrator() {
+  if (checkpoint_file) {
+    delete[] checkpoint_file;
+  }
+
   // Close any open file pointers
   if (logfp != stdout && logfp) {
     fclose(logfp);
   }
 
   // Dereference position, velocity and acceleration states
-  for (int k = 0; k < num_time_steps + 1; k++) {
-    q[k]->decref();
-    qdot[k]->decref();
-    qddot[k]->decref();
+  for (int k = 0; k < step_capacity + 1; k++) {
+    if (q[k]) {
+      q[k]->decref();
+      qdot[k]->decref();
+      qddot[k]->decref();
+    }
+  }
+
+  // Free the data for the snapshot mode
+  if (step_pins) {
+    for (int i = 0; i < num_free_vecs; i++) {
+      free_vecs[i]->decref();
+    }
+    for (int k = 0; k < num_time_steps + 1; k++) {
+      if (step_forces[k] && (k == 0 || step_forces[k] != step_forces[k - 1])) {
+        step_forces[k]->decref();
+      }
+      if (step_aux[k]) {
+        step_aux[k]->decref();
+      }
+    }
+    delete[] step_pins;
+    delete[] snapshot_steps;
+    delete[] free_vecs;
+    delete[] step_forces;
+    delete[] step_aux;
   }
 
   // Dereference Newton's method objects
@@ -154,6 +238,12 @@ TACSIntegrator::~TACSIntegrator() {
   if (ksm) {
     ksm->decref();
   }
+  if (mf_mat) {
+    mf_mat->decref();
+  }
+  if (mf_ksm) {
+    mf_ksm->decref();
+  }
 
   if (time) {
     delete[] time;
@@ -269,12 +359,72 @@ void TACSIntegrator::setKrylovSubspaceMethod(TACSKsm *_ksm) {
     ksm->decref();
   }
   ksm = _ksm;
+
+  // The matrix-free solver is re-created with the new preconditioner
+  if (mf_ksm) {
+    mf_ksm->decref();
+    mf_ksm = NULL;
+  }
+  jac_current = 0;
+}
+
+/*
+  Set whether to use the Jacobian-free Newton-Krylov (JFNK) mode
+
+  In this mode, GMRES uses Jacobian-vector products computed from the
+  element Jacobians at the current state, while the assembled and
+  factored Jacobian is only used as a lagged preconditioner. The
+  preconditioner is updated with the adaptive strategy described in
+  setAdaptiveJacobian(). The option is ignored when LAPACK is used.
+*/
+void TACSIntegrator::setUseMatrixFree(int _use_matrix_free) {
+  use_matrix_free = _use_matrix_free;
+}
+
+/*
+  Set the tolerances of the GMRES solves in the JFNK mode
+
+  The Newton update only needs to reduce the linearized residual by
+  the relative tolerance, so a loose tolerance saves Krylov iterations
+  at the cost of more Newton iterations.
+
+  input:
+  mf_rtol:  the relative tolerance of the linear solves
+  mf_atol:  the absolute tolerance of the linear solves
+*/
+void TACSIntegrator::setMatrixFreeTolerances(double _mf_rtol,
+                                             double _mf_atol) {
+  mf_rtol = _mf_rtol;
+  mf_atol = _mf_atol;
+  if (mf_ksm) {
+    mf_ksm->setTolerances(mf_rtol, mf_atol);
+  }
+}
+
+/*
+  Set whether to reuse the factored Jacobian across Newton iterations
+  and time steps
+
+  The Jacobian is re-assembled and factored only when the Newton
+  contraction ratio |R_{k+1}|/|R_{k}| exceeds max_contraction, when the
+  linearization coefficients change, when the previous linear solve
+  did not converge or when the previous Newton solve failed. When set,
+  the Jacobian assembly frequency is not used.
+*/
+void TACSIntegrator::setAdaptiveJacobian(int _adaptive_jac,
+                                         double _max_contraction) {
+  adaptive_jac = _adaptive_jac;
+  if (_max_contraction > 0.0) {
+    max_contraction = _max_contraction;
+  }
 }
 
 /*
   Set the time interval for the simulation
 */
-void TACSIntegrator::setTimeInterval(double tinit, double tfinal) {
+void TACSIntegrator::setTimeInterval(double _tinit, double _tfinal) {
+  tinit = _tinit;
+  tfinal = _tfinal;
   for (int k = 0; k < num_time_steps + 1; k++) {
     time[k] = tinit + double(k) * (tfinal - tinit) / double(num_time_steps);
   }
@@ -305,77 +455,1380 @@ void TACSIntegrator::setFunctions(int _num_funcs, TACSFunction **_funcs,
     }
   }
 
-  // Free functions that have already been set
-  if (funcs) {
-    for (int i = 0; i < num_funcs; i++) {
-      if (funcs[i]) {
-        funcs[i]->decref();
-      }
+  // Free functions that have already been set
+  if (funcs) {
+    for (int i = 0; i < num_funcs; i++) {
+      if (funcs[i]) {
+        funcs[i]->decref();
+      }
+    }
+    delete[] funcs;
+  }
+
+  if (dfdx) {
+    for (int i = 0; i < num_funcs; i++) {
+      if (dfdx[i]) {
+        dfdx[i]->decref();
+      }
+    }
+    delete[] dfdx;
+  }
+
+  if (dfdXpt) {
+    for (int i = 0; i < num_funcs; i++) {
+      if (dfdXpt[i]) {
+        dfdXpt[i]->decref();
+      }
+    }
+    delete[] dfdXpt;
+  }
+
+  // Set the number of functions
+  num_funcs = _num_funcs;
+  funcs = new TACSFunction *[num_funcs];
+  dfdx = new TACSBVec *[num_funcs];
+  dfdXpt = new TACSBVec *[num_funcs];
+
+  for (int i = 0; i < num_funcs; i++) {
+    funcs[i] = _funcs[i];
+    dfdx[i] = assembler->createDesignVec();
+    dfdx[i]->incref();
+    dfdXpt[i] = assembler->createNodeVec();
+    dfdXpt[i]->incref();
+  }
+}
+
+/*
+  Set the output directory prefix
+*/
+void TACSIntegrator::setOutputPrefix(const char *_prefix) {
+  strncpy(prefix, _prefix, sizeof(prefix));
+}
+
+/*
+  Get the name of the checkpoint file within the output prefix
+  directory. The name is allocated to fit the prefix.
+*/
+static char *TacsGetCheckpointFileName(const char *prefix) {
+  const char *name = "/checkpoint.bin";
+  size_t len = strlen(prefix) + strlen(name) + 1;
+  char *fname = new char[len];
+  snprintf(fname, len, "%s%s", prefix, name);
+  return fname;
+}
+
+/*
+  Integration the equations of motion forward in time.
+
+  If a checkpoint has been read, the integration resumes from the step
+  after the last step stored in the checkpoint.
+*/
+int TACSIntegrator::integrate() {
+  TACS_PROFILE_SCOPE("TACSIntegrator::integrate");
+
+  // A new integration replaces the steps stored in the checkpoint file
+  if (restart_step < 0) {
+    checkpoint_step = -1;
+  }
+
+  if (adaptive_step) {
+    return integrateAdaptive();
+  }
+
+  int start = 0;
+  if (restart_step >= 0) {
+    start = restart_step + 1;
+    restart_step = -1;
+
+    // Reset the timing information normally set at the first step
+    time_forward = MPI_Wtime();
+    time_fwd_assembly = 0.0;
+    time_fwd_factor = 0.0;
+    time_fwd_apply_factor = 0.0;
+    time_newton = 0.0;
+
+    // Recompute the initial energy used for logging
+    TacsScalar energies[2];
+    assembler->setSimulationTime(time[0]);
+    assembler->setVariables(q[0], qdot[0], qddot[0]);
+    assembler->evalEnergies(&energies[0], &energies[1]);
+    init_energy = energies[0] + energies[1];
+  }
+
+  for (int i = start; i < num_time_steps + 1; i++) {
+    int flag = iterate(i, NULL);
+    if (flag != 0) {
+      return flag;
+    }
+
+    // Write the checkpoint file if requested
+    if (checkpoint_freq > 0 && i > 0 && i < num_time_steps &&
+        i % checkpoint_freq == 0) {
+      char *fname = TacsGetCheckpointFileName(prefix);
+      writeCheckpoint(fname, i, 0);
+      delete[] fname;
+    }
+  }
+  return 0;
+}
+
+/*
+  Integrate the adjoint equations backwards in time
+
+  If an adjoint checkpoint has been read, the integration resumes from
+  the step before the last adjoint step stored in the checkpoint.
+*/
+void TACSIntegrator::integrateAdjoint() {
+  TACS_PROFILE_SCOPE("TACSIntegrator::integrateAdjoint");
+  int start = num_time_steps;
+  if (restart_adjoint_step >= 0) {
+    start = restart_adjoint_step - 1;
+    restart_adjoint_step = -1;
+
+    // Reset the timing information normally set at the last step
+    time_rev_assembly = 0.0;
+    time_rev_factor = 0.0;
+    time_rev_apply_factor = 0.0;
+    time_rev_jac_pdt = 0.0;
+    time_reverse = MPI_Wtime();
+
+    initializeLinearSolver();
+  }
+
+  for (int i = start; i >= 0; i--) {
+    initAdjoint(i);
+    iterateAdjoint(i, NULL);
+    postAdjoint(i);
+
+    // Write the checkpoint file if requested
+    if (checkpoint_freq > 0 && i > 0 && i < num_time_steps &&
+        i % checkpoint_freq == 0) {
+      char *fname = TacsGetCheckpointFileName(prefix);
+      writeCheckpoint(fname, i, 1);
+      delete[] fname;
+    }
+  }
+}
+
+/*
+  Adapt the time step during integrate() based on the estimate of the
+  local error provided by the integration scheme. The step is accepted
+  when the weighted RMS norm of the error in the states and velocities
+  is less than one, where the weight of each entry is
+
+  1/(step_atol + step_rtol*max(|q[k-1]|, |q[k]|))
+
+  The time steps are chosen with a PI controller. The time step set by
+  the number of steps in the constructor is used as the initial step,
+  and the storage for the time history grows as required. Once the
+  integration is complete, getNumTimeSteps() returns the number of
+  accepted steps and the adjoint integrates over the same sequence,
+  treating the accepted time steps as fixed. Checkpoints are not
+  written for the forward adaptive integration.
+
+  Only the DIRK and ESDIRK integrators support adaptive time steps.
+  The BDF coefficients, and the BDF adjoint that is built from them,
+  assume a uniform time step. Adaptive BDF steps would require
+  variable-step coefficients with a predictor-corrector error
+  estimate in both the forward and adjoint integrations, so the flag
+  is rejected for the BDF integrator.
+
+  input:
+  adaptive_step: flag to indicate whether to adapt the time step
+  step_rtol:     the relative tolerance on the local error
+  step_atol:     the absolute tolerance on the local error
+*/
+void TACSIntegrator::setAdaptiveTimeStep(int _adaptive_step, double _step_rtol,
+                                         double _step_atol) {
+  if (_adaptive_step && getErrorOrder() <= 0) {
+    fprintf(stderr,
+            "TACSIntegrator: Adaptive time steps are not supported by "
+            "this integrator\n");
+    _adaptive_step = 0;
+  }
+  adaptive_step = _adaptive_step;
+  step_rtol = _step_rtol;
+  step_atol = _step_atol;
+}
+
+/*
+  Set the limits on the adaptive time step. A value of zero selects
+  the default minimum of 1e-12*(tfinal - tinit) or the default
+  maximum of tfinal - tinit.
+*/
+void TACSIntegrator::setTimeStepLimits(double _min_step, double _max_step) {
+  min_step = _min_step;
+  max_step = _max_step;
+}
+
+/*
+  Integrate the equations of motion forward in time with adaptive
+  time steps. Steps are rejected when the local error estimate is too
+  large or when the Newton solve fails. The time steps that are taken
+  overwrite the uniform time steps. If the time step falls below the
+  minimum, the time steps that were set before the integration are
+  restored and 1 is returned.
+*/
+int TACSIntegrator::integrateAdaptive() {
+  if (restart_step >= 0) {
+    fprintf(stderr,
+            "TACSIntegrator: Cannot restart an adaptive integration from a "
+            "checkpoint\n");
+    restart_step = -1;
+    return 1;
+  }
+
+  // Order of the local error estimate used by the step control
+  int order = getErrorOrder();
+
+  // Save the time steps so that they can be restored on failure
+  int nominal_steps = num_time_steps;
+  double *nominal_time = new double[nominal_steps + 1];
+  memcpy(nominal_time, time, (nominal_steps + 1) * sizeof(double));
+
+  double hmin = (min_step > 0.0 ? min_step : 1e-12 * (tfinal - tinit));
+  double hmax = (max_step > 0.0 ? max_step : tfinal - tinit);
+
+  // The initial time step is the uniform time step
+  double h = (tfinal - tinit) / num_time_steps;
+  if (h > hmax) {
+    h = hmax;
+  }
+
+  int flag = iterate(0, NULL);
+  if (flag != 0) {
+    delete[] nominal_time;
+    return flag;
+  }
+
+  num_rejected_steps = 0;
+  double prev_err = 1.0;
+  int rejected = 0;
+
+  int k = 1;
+  while (1) {
+    reserveTimeSteps(k);
+
+    // Stretch the step to reach the final time instead of taking a
+    // very small final step
+    int last = 0;
+    if (time[k - 1] + 1.01 * h >= tfinal) {
+      h = tfinal - time[k - 1];
+      last = 1;
+    }
+    time[k] = (last ? tfinal : time[k - 1] + h);
+
+    // Set the projected number of time steps for logging
+    if (last) {
+      num_time_steps = k;
+    } else {
+      num_time_steps = k + 1 + int((tfinal - time[k]) / h);
+    }
+
+    // Take the trial step and estimate the local error
+    trial_step = 1;
+    flag = iterate(k, NULL);
+    trial_step = 0;
+    double err = 0.0;
+    if (flag == 0) {
+      err = estimateStepError(k);
+    }
+
+    double fac = 1.0;
+    if (flag == 0 && err <= 1.0) {
+      logTimeStep(k);
+      if (last) {
+        break;
+      }
+
+      // Compute the new time step with the PI controller
+      if (err < 1e-10) {
+        err = 1e-10;
+      }
+      fac = 0.9 * pow(err, -0.7 / (order + 1)) *
+            pow(prev_err, 0.4 / (order + 1));
+      fac = (fac < 0.2 ? 0.2 : (fac > 5.0 ? 5.0 : fac));
+      if (rejected && fac > 1.0) {
+        fac = 1.0;
+      }
+      prev_err = (err > 1e-4 ? err : 1e-4);
+      rejected = 0;
+      k++;
+    } else {
+      // Reduce the step after an error or a failed Newton solve
+      num_rejected_steps++;
+      if (flag == 0) {
+        fac = 0.9 * pow(err, -1.0 / (order + 1));
+        fac = (fac < 0.2 ? 0.2 : fac);
+      } else {
+        fac = 0.25;
+      }
+      rejected = 1;
+    }
+
+    h = (fac * h < hmax ? fac * h : hmax);
+    if (h < hmin) {
+      fprintf(stderr,
+              "TACSIntegrator: Time step %g is less than the minimum %g at "
+              "time %g\n",
+              h, hmin, time[k - 1]);
+
+      // Restore the time steps that were set before the integration
+      num_time_steps = nominal_steps;
+      memcpy(time, nominal_time, (nominal_steps + 1) * sizeof(double));
+      delete[] nominal_time;
+      return 1;
+    }
+  }
+  delete[] nominal_time;
+
+  // Extend the time window for the functions to the final step
+  if (end_plane >= nominal_steps || end_plane > num_time_steps) {
+    end_plane = num_time_steps;
+  }
+  if (start_plane >= end_plane) {
+    start_plane = 0;
+  }
+
+  return 0;
+}
+
+/*
+  Allocate a vector array with new_size entries and copy over the
+  first old_size entries
+*/
+static void TacsGrowVecArray(TACSAssembler *assembler, TACSBVec ***vecs,
+                             int old_size, int new_size) {
+  TACSBVec **v = new TACSBVec *[new_size];
+  memcpy(v, *vecs, old_size * sizeof(TACSBVec *));
+  for (int i = old_size; i < new_size; i++) {
+    v[i] = TacsCreateStateVec(assembler);
+  }
+  delete[] *vecs;
+  *vecs = v;
+}
+
+/*
+  Make sure that the states for the time steps 0 through num_steps are
+  allocated. The storage is doubled when it is extended.
+*/
+void TACSIntegrator::reserveTimeSteps(int num_steps) {
+  if (num_steps <= step_capacity) {
+    return;
+  }
+
+  int new_capacity = 2 * step_capacity;
+  if (new_capacity < num_steps) {
+    new_capacity = num_steps;
+  }
+
+  double *t = new double[new_capacity + 1];
+  memset(t, 0, (new_capacity + 1) * sizeof(double));
+  memcpy(t, time, (step_capacity + 1) * sizeof(double));
+  delete[] time;
+  time = t;
+
+  TacsGrowVecArray(assembler, &q, step_capacity + 1, new_capacity + 1);
+  TacsGrowVecArray(assembler, &qdot, step_capacity + 1, new_capacity + 1);
+  TacsGrowVecArray(assembler, &qddot, step_capacity + 1, new_capacity + 1);
+
+  reserveStageVecs(step_capacity, new_capacity);
+  step_capacity = new_capacity;
+}
+
+/*
+  Compute the weighted RMS norm of the error in the states and the
+  velocities at the given step
+*/
+double TACSIntegrator::getStepErrorNorm(int step_num, TACSBVec *err,
+                                        TACSBVec *derr) {
+  TacsScalar *e, *de, *q0, *q1, *qd0, *qd1;
+  int size = err->getArray(&e);
+  derr->getArray(&de);
+  q[step_num - 1]->getArray(&q0);
+  q[step_num]->getArray(&q1);
+  qdot[step_num - 1]->getArray(&qd0);
+  qdot[step_num]->getArray(&qd1);
+
+  double sum[2] = {0.0, 2.0 * size};
+  for (int i = 0; i < size; i++) {
+    double qmax = fabs(TacsRealPart(q0[i]));
+    if (fabs(TacsRealPart(q1[i])) > qmax) {
+      qmax = fabs(TacsRealPart(q1[i]));
+    }
+    double r = TacsRealPart(e[i]) / (step_atol + step_rtol * qmax);
+
+    double qdmax = fabs(TacsRealPart(qd0[i]));
+    if (fabs(TacsRealPart(qd1[i])) > qdmax) {
+      qdmax = fabs(TacsRealPart(qd1[i]));
+    }
+    double dr = TacsRealPart(de[i]) / (step_atol + step_rtol * qdmax);
+
+    sum[0] += r * r + dr * dr;
+  }
+
+  double total[2];
+  MPI_Allreduce(sum, total, 2, MPI_DOUBLE, MPI_SUM, assembler->getMPIComm());
+
+  if (total[1] > 0.0) {
+    return sqrt(total[0] / total[1]);
+  }
+  return 0.0;
+}
+
+/*
+  Set the frequency with which checkpoint files are written during
+  integrate() and integrateAdjoint(). The checkpoint is written to the
+  file checkpoint.bin within the output prefix directory and each
+  checkpoint appends the steps completed since the previous one.
+
+  input:
+  checkpoint_freq: the number of steps between checkpoints (0 = off)
+*/
+void TACSIntegrator::setCheckpointFrequency(int _checkpoint_freq) {
+  checkpoint_freq = _checkpoint_freq;
+}
+
+/*
+  Get the vectors that must be stored for each step to restart the
+  integration. Integrators that store additional information for each
+  step append their vectors to this list.
+
+  input:
+  step_num:  the step number
+  vecs:      the array of vectors (may be NULL)
+
+  returns:   the number of vectors
+*/
+int TACSIntegrator::getCheckpointStepVecs(int step_num, TACSBVec **vecs) {
+  if (vecs) {
+    vecs[0] = q[step_num];
+    vecs[1] = qdot[step_num];
+    vecs[2] = qddot[step_num];
+  }
+  return 3;
+}
+
+/*
+  Get the vectors that must be stored in addition to the full state
+  history to restart the adjoint integration. These are the partial
+  derivatives accumulated so far. Integrators that store additional
+  adjoint information append their vectors to this list.
+
+  input:
+  vecs:      the array of vectors (may be NULL)
+
+  returns:   the number of vectors
+*/
+int TACSIntegrator::getCheckpointAdjointVecs(TACSBVec **vecs) {
+  int count = 0;
+  for (int i = 0; i < num_funcs; i++, count += 2) {
+    if (vecs) {
+      vecs[count] = dfdx[i];
+      vecs[count + 1] = dfdXpt[i];
+    }
+  }
+  return count;
+}
+
+/*
+  Get the number of local entries stored for a vector in a checkpoint
+*/
+static int TacsGetCheckpointSize(TACSBVec *vec) {
+  return vec->getArray(NULL) + vec->getExtArray(NULL) + vec->getDepArray(NULL);
+}
+
+/*
+  Pack the owned, external and dependent values of a vector
+*/
+static void TacsPackCheckpointVec(TACSBVec *vec, TacsScalar *buffer) {
+  TacsScalar *array;
+  int size = vec->getArray(&array);
+  memcpy(buffer, array, size * sizeof(TacsScalar));
+  int ext_size = vec->getExtArray(&array);
+  memcpy(&buffer[size], array, ext_size * sizeof(TacsScalar));
+  int dep_size = vec->getDepArray(&array);
+  memcpy(&buffer[size + ext_size], array, dep_size * sizeof(TacsScalar));
+}
+
+/*
+  Unpack the owned, external and dependent values of a vector
+*/
+static void TacsUnpackCheckpointVec(const TacsScalar *buffer, TACSBVec *vec) {
+  TacsScalar *array;
+  int size = vec->getArray(&array);
+  memcpy(array, buffer, size * sizeof(TacsScalar));
+  int ext_size = vec->getExtArray(&array);
+  memcpy(array, &buffer[size], ext_size * sizeof(TacsScalar));
+  int dep_size = vec->getDepArray(&array);
+  memcpy(array, &buffer[size + ext_size], dep_size * sizeof(TacsScalar));
+}
+
+// Magic number, format version and header length of checkpoint files
+static const int TACS_CHECKPOINT_MAGIC = 0x54434b50;
+static const int TACS_CHECKPOINT_VERSION = 2;
+static const int TACS_CHECKPOINT_HEADER_SIZE = 9;
+
+/*
+  Write a binary checkpoint file in parallel using MPI-IO
+
+  The file can be used to restart the integration with the same
+  number of processors. All values are written in their native binary
+  representation, including the external and dependent entries of
+  each vector, so that the restarted integration starts from exactly
+  the stored state.
+
+  Each step has a fixed slot in the file. When the checkpoint is
+  written to the file that holds the earlier steps of the current
+  integration, only the steps that are not already stored are
+  written, so the total I/O over the integration is linear in the
+  number of steps. The header is written last and records the last
+  step that is complete, so a file that is interrupted while writing
+  still restarts from the previous checkpoint.
+
+  The file format is as follows:
+  int[9]                        The header information
+  double[num_time_steps+1]      The time values
+  int[mpiSize]                  The local length of the state vectors
+  TacsScalar[]                  The state vectors for each step
+  int[mpiSize*num_adj_vecs]     The local length of the adjoint vectors
+  TacsScalar[]                  The adjoint vector entries
+
+  input:
+  filename:  the name of the checkpoint file
+  step_num:  the last step that was completed
+  adjoint:   flag indicating whether this is an adjoint checkpoint
+
+  returns:   0 on success, 1 on failure
+*/
+int TACSIntegrator::writeCheckpoint(const char *filename, int step_num,
+                                    int adjoint) {
+  if (step_pins) {
+    if (mpiRank == 0) {
+      fprintf(stderr,
+              "TACSIntegrator: Checkpoint files require the full state "
+              "history\n");
+    }
+    return 1;
+  }
+  if (step_num < 0 || step_num > num_time_steps) {
+    if (mpiRank == 0) {
+      fprintf(stderr, "TACSIntegrator: Invalid checkpoint step %d\n",
+              step_num);
+    }
+    return 1;
+  }
+
+  MPI_Comm comm = assembler->getMPIComm();
+
+  // The adjoint integration requires the full state history
+  int last_step = (adjoint ? num_time_steps : step_num);
+  int num_step_vecs = getCheckpointStepVecs(num_time_steps > 0 ? 1 : 0, NULL);
+  int num_adj_vecs = (adjoint ? getCheckpointAdjointVecs(NULL) : 0);
+
+  // Find the size of the state vectors on each processor
+  int state_size = TacsGetCheckpointSize(q[0]);
+  int *state_sizes = new int[mpiSize];
+  MPI_Allgather(&state_size, 1, MPI_INT, state_sizes, 1, MPI_INT, comm);
+  MPI_Offset slot_size = 0, rank_offset = 0;
+  for (int j = 0; j < mpiSize; j++) {
+    if (j < mpiRank) {
+      rank_offset += state_sizes[j] * sizeof(TacsScalar);
+    }
+    slot_size += state_sizes[j] * sizeof(TacsScalar);
+  }
+
+  MPI_Offset time_offset = TACS_CHECKPOINT_HEADER_SIZE * sizeof(int);
+  MPI_Offset sizes_offset =
+      time_offset + (num_time_steps + 1) * sizeof(double);
+  MPI_Offset state_offset = sizes_offset + mpiSize * sizeof(int);
+  MPI_Offset adj_offset =
+      state_offset + (num_time_steps + 1) * num_step_vecs * slot_size;
+
+  char *fname = new char[strlen(filename) + 1];
+  strcpy(fname, filename);
+
+  MPI_File fp = NULL;
+  MPI_File_open(comm, fname, MPI_MODE_RDWR | MPI_MODE_CREATE, MPI_INFO_NULL,
+                &fp);
+  delete[] fname;
+
+  if (!fp) {
+    if (mpiRank == 0) {
+      fprintf(stderr, "TACSIntegrator: Failed to write checkpoint file %s\n",
+              filename);
+    }
+    delete[] state_sizes;
+    return 1;
+  }
+
+  char datarep[] = "native";
+  MPI_File_set_view(fp, 0, MPI_BYTE, MPI_BYTE, datarep, MPI_INFO_NULL);
+
+  int header[TACS_CHECKPOINT_HEADER_SIZE];
+  header[0] = TACS_CHECKPOINT_MAGIC;
+  header[1] = TACS_CHECKPOINT_VERSION;
+  header[2] = sizeof(TacsScalar);
+  header[3] = mpiSize;
+  header[4] = num_time_steps;
+  header[5] = num_step_vecs;
+
+  // Append to the file if it stores the earlier steps of this
+  // integration, otherwise write the full state history
+  int first_step = 0;
+  if (checkpoint_file && checkpoint_step >= 0 &&
+      strcmp(checkpoint_file, filename) == 0) {
+    int file_header[TACS_CHECKPOINT_HEADER_SIZE];
+    MPI_File_read_at_all(fp, 0, file_header,
+                         TACS_CHECKPOINT_HEADER_SIZE * sizeof(int), MPI_BYTE,
+                         MPI_STATUS_IGNORE);
+    if (memcmp(header, file_header, 6 * sizeof(int)) == 0 &&
+        file_header[7] >= checkpoint_step) {
+      first_step = checkpoint_step + 1;
+    }
+  }
+  if (first_step == 0) {
+    MPI_File_set_size(fp, 0);
+  } else if (adjoint) {
+    // Mark the adjoint data as invalid while it is overwritten
+    header[6] = 0;
+    header[7] = checkpoint_step;
+    header[8] = -1;
+    if (mpiRank == 0) {
+      MPI_File_write_at(fp, 0, header,
+                        TACS_CHECKPOINT_HEADER_SIZE * sizeof(int), MPI_BYTE,
+                        MPI_STATUS_IGNORE);
+    }
+    MPI_File_sync(fp);
+  }
+  if (last_step < first_step - 1) {
+    last_step = first_step - 1;
+  }
+
+  // Write the state vectors for the steps that are not yet stored
+  TACSBVec **vecs = new TACSBVec *[num_step_vecs + num_adj_vecs];
+  TacsScalar *buffer = new TacsScalar[state_size + 1];
+  for (int k = first_step; k <= last_step; k++) {
+    int nvecs = getCheckpointStepVecs(k, vecs);
+    for (int j = 0; j < nvecs; j++) {
+      TacsPackCheckpointVec(vecs[j], buffer);
+      MPI_Offset offset =
+          state_offset + (k * num_step_vecs + j) * slot_size + rank_offset;
+      MPI_File_write_at_all(fp, offset, buffer,
+                            state_size * sizeof(TacsScalar), MPI_BYTE,
+                            MPI_STATUS_IGNORE);
+    }
+  }
+  delete[] buffer;
+
+  // Write the adjoint vectors after the state history
+  if (adjoint) {
+    getCheckpointAdjointVecs(vecs);
+
+    int *sizes = new int[num_adj_vecs + 1];
+    int max_size = 0;
+    for (int k = 0; k < num_adj_vecs; k++) {
+      sizes[k] = TacsGetCheckpointSize(vecs[k]);
+      if (sizes[k] > max_size) {
+        max_size = sizes[k];
+      }
+    }
+    int *all_sizes = new int[mpiSize * num_adj_vecs + 1];
+    MPI_Allgather(sizes, num_adj_vecs, MPI_INT, all_sizes, num_adj_vecs,
+                  MPI_INT, comm);
+
+    if (mpiRank == 0) {
+      MPI_File_write_at(fp, adj_offset, all_sizes,
+                        mpiSize * num_adj_vecs * sizeof(int), MPI_BYTE,
+                        MPI_STATUS_IGNORE);
+    }
+
+    MPI_Offset offset = adj_offset + mpiSize * num_adj_vecs * sizeof(int);
+    buffer = new TacsScalar[max_size + 1];
+    for (int k = 0; k < num_adj_vecs; k++) {
+      TacsPackCheckpointVec(vecs[k], buffer);
+
+      MPI_Offset local_offset = offset;
+      for (int j = 0; j < mpiRank; j++) {
+        local_offset += all_sizes[j * num_adj_vecs + k] * sizeof(TacsScalar);
+      }
+      MPI_File_write_at_all(fp, local_offset, buffer,
+                            sizes[k] * sizeof(TacsScalar), MPI_BYTE,
+                            MPI_STATUS_IGNORE);
+
+      for (int j = 0; j < mpiSize; j++) {
+        offset += all_sizes[j * num_adj_vecs + k] * sizeof(TacsScalar);
+      }
+    }
+
+    delete[] buffer;
+    delete[] sizes;
+    delete[] all_sizes;
+  }
+  delete[] vecs;
+
+  // Write the header once the data is complete
+  MPI_File_sync(fp);
+  header[6] = num_adj_vecs;
+  header[7] = last_step;
+  header[8] = (adjoint ? step_num : -1);
+  if (mpiRank == 0) {
+    MPI_File_write_at(fp, time_offset, time,
+                      (num_time_steps + 1) * sizeof(double), MPI_BYTE,
+                      MPI_STATUS_IGNORE);
+    MPI_File_write_at(fp, sizes_offset, state_sizes, mpiSize * sizeof(int),
+                      MPI_BYTE, MPI_STATUS_IGNORE);
+    MPI_File_write_at(fp, 0, header, TACS_CHECKPOINT_HEADER_SIZE * sizeof(int),
+                      MPI_BYTE, MPI_STATUS_IGNORE);
+  }
+  MPI_File_close(&fp);
+  delete[] state_sizes;
+
+  // Record the steps that are stored in the file
+  if (!checkpoint_file || strcmp(checkpoint_file, filename) != 0) {
+    if (checkpoint_file) {
+      delete[] checkpoint_file;
+    }
+    checkpoint_file = new char[strlen(filename) + 1];
+    strcpy(checkpoint_file, filename);
+  }
+  checkpoint_step = last_step;
+
+  return 0;
+}
+
+/*
+  Read a checkpoint file written by writeCheckpoint
+
+  The integrator must be created with the same number of time steps,
+  functions and processors as the integrator that wrote the file.
+  After a forward checkpoint is read, integrate() resumes at the step
+  after step_num. After an adjoint checkpoint is read,
+  integrateAdjoint() resumes at the step before step_num. Later
+  checkpoints written to the same file append to it.
+
+  input:
+  filename:  the name of the checkpoint file
+
+  output:
+  step_num:  the last step that was completed
+  adjoint:   flag indicating whether this is an adjoint checkpoint
+
+  returns:   0 on success, 1 on failure
+*/
+int TACSIntegrator::readCheckpoint(const char *filename, int *_step_num,
+                                   int *_adjoint) {
+  if (step_pins) {
+    if (mpiRank == 0) {
+      fprintf(stderr,
+              "TACSIntegrator: Checkpoint files require the full state "
+              "history\n");
+    }
+    return 1;
+  }
+
+  MPI_Comm comm = assembler->getMPIComm();
+
+  char *fname = new char[strlen(filename) + 1];
+  strcpy(fname, filename);
+
+  MPI_File fp = NULL;
+  MPI_File_open(comm, fname, MPI_MODE_RDONLY, MPI_INFO_NULL, &fp);
+  delete[] fname;
+
+  if (!fp) {
+    if (mpiRank == 0) {
+      fprintf(stderr, "TACSIntegrator: Failed to open checkpoint file %s\n",
+              filename);
+    }
+    return 1;
+  }
+
+  char datarep[] = "native";
+  MPI_File_set_view(fp, 0, MPI_BYTE, MPI_BYTE, datarep, MPI_INFO_NULL);
+
+  // Read the header and check that the file is consistent
+  int header[TACS_CHECKPOINT_HEADER_SIZE];
+  MPI_File_read_at_all(fp, 0, header,
+                       TACS_CHECKPOINT_HEADER_SIZE * sizeof(int), MPI_BYTE,
+                       MPI_STATUS_IGNORE);
+  int num_step_vecs = getCheckpointStepVecs(num_time_steps > 0 ? 1 : 0, NULL);
+  int num_adj_vecs = header[6];
+  int state_step = header[7];
+  int adjoint_step = header[8];
+
+  int fail = 0;
+  if (header[0] != TACS_CHECKPOINT_MAGIC ||
+      header[1] != TACS_CHECKPOINT_VERSION ||
+      header[2] != sizeof(TacsScalar) || header[3] != mpiSize ||
+      header[4] != num_time_steps || header[5] != num_step_vecs ||
+      state_step < 0 || state_step > num_time_steps || adjoint_step < -1 ||
+      adjoint_step > num_time_steps ||
+      (adjoint_step >= 0 && (state_step != num_time_steps ||
+                             num_adj_vecs != getCheckpointAdjointVecs(NULL)))) {
+    fail = 1;
+  }
+
+  // Check the state vector sizes against the local sizes
+  MPI_Offset time_offset = TACS_CHECKPOINT_HEADER_SIZE * sizeof(int);
+  MPI_Offset sizes_offset =
+      time_offset + (num_time_steps + 1) * sizeof(double);
+  MPI_Offset state_offset = sizes_offset + mpiSize * sizeof(int);
+  int *state_sizes = new int[mpiSize];
+  MPI_Offset slot_size = 0, rank_offset = 0;
+  if (!fail) {
+    MPI_File_read_at_all(fp, sizes_offset, state_sizes, mpiSize * sizeof(int),
+                         MPI_BYTE, MPI_STATUS_IGNORE);
+    for (int j = 0; j < mpiSize; j++) {
+      if (j < mpiRank) {
+        rank_offset += state_sizes[j] * sizeof(TacsScalar);
+      }
+      slot_size += state_sizes[j] * sizeof(TacsScalar);
+    }
+
+    int local_fail = (state_sizes[mpiRank] != TacsGetCheckpointSize(q[0]));
+    MPI_Allreduce(&local_fail, &fail, 1, MPI_INT, MPI_MAX, comm);
+  }
+
+  if (!fail) {
+    // Read in the time values
+    MPI_File_read_at_all(fp, time_offset, time,
+                         (num_time_steps + 1) * sizeof(double), MPI_BYTE,
+                         MPI_STATUS_IGNORE);
+
+    // Read in the state history
+    int state_size = state_sizes[mpiRank];
+    TACSBVec **vecs = new TACSBVec *[num_step_vecs + num_adj_vecs];
+    TacsScalar *buffer = new TacsScalar[state_size + 1];
+    for (int k = 0; k <= state_step; k++) {
+      int nvecs = getCheckpointStepVecs(k, vecs);
+      for (int j = 0; j < nvecs; j++) {
+        MPI_Offset offset =
+            state_offset + (k * num_step_vecs + j) * slot_size + rank_offset;
+        MPI_File_read_at_all(fp, offset, buffer,
+                             state_size * sizeof(TacsScalar), MPI_BYTE,
+                             MPI_STATUS_IGNORE);
+        TacsUnpackCheckpointVec(buffer, vecs[j]);
+      }
+    }
+    delete[] buffer;
+
+    // Read in the adjoint vectors
+    if (adjoint_step >= 0) {
+      getCheckpointAdjointVecs(vecs);
+
+      MPI_Offset adj_offset =
+          state_offset + (num_time_steps + 1) * num_step_vecs * slot_size;
+      int *all_sizes = new int[mpiSize * num_adj_vecs + 1];
+      MPI_File_read_at_all(fp, adj_offset, all_sizes,
+                           mpiSize * num_adj_vecs * sizeof(int), MPI_BYTE,
+                           MPI_STATUS_IGNORE);
+
+      int local_fail = 0, max_size = 0;
+      for (int k = 0; k < num_adj_vecs; k++) {
+        int size = all_sizes[mpiRank * num_adj_vecs + k];
+        if (size != TacsGetCheckpointSize(vecs[k])) {
+          local_fail = 1;
+        }
+        if (size > max_size) {
+          max_size = size;
+        }
+      }
+      MPI_Allreduce(&local_fail, &fail, 1, MPI_INT, MPI_MAX, comm);
+
+      MPI_Offset offset = adj_offset + mpiSize * num_adj_vecs * sizeof(int);
+      buffer = new TacsScalar[max_size + 1];
+      for (int k = 0; !fail && k < num_adj_vecs; k++) {
+        MPI_Offset local_offset = offset;
+        for (int j = 0; j < mpiRank; j++) {
+          local_offset += all_sizes[j * num_adj_vecs + k] * sizeof(TacsScalar);
+        }
+        int size = all_sizes[mpiRank * num_adj_vecs + k];
+        MPI_File_read_at_all(fp, local_offset, buffer,
+                             size * sizeof(TacsScalar), MPI_BYTE,
+                             MPI_STATUS_IGNORE);
+        TacsUnpackCheckpointVec(buffer, vecs[k]);
+
+        for (int j = 0; j < mpiSize; j++) {
+          offset += all_sizes[j * num_adj_vecs + k] * sizeof(TacsScalar);
+        }
+      }
+
+      delete[] buffer;
+      delete[] all_sizes;
+    }
+    delete[] vecs;
+  }
+
+  if (!fail) {
+    // Set the step at which to resume the integration
+    if (adjoint_step >= 0) {
+      restart_step = -1;
+      restart_adjoint_step = adjoint_step;
+    } else {
+      restart_step = state_step;
+      restart_adjoint_step = -1;
+    }
+
+    // Later checkpoints are appended to this file
+    if (checkpoint_file) {
+      delete[] checkpoint_file;
+    }
+    checkpoint_file = new char[strlen(filename) + 1];
+    strcpy(checkpoint_file, filename);
+    checkpoint_step = state_step;
+  } else if (mpiRank == 0) {
+    fprintf(stderr,
+            "TACSIntegrator: Checkpoint file %s is inconsistent with "
+            "this integrator\n",
+            filename);
+  }
+
+  MPI_File_close(&fp);
+  delete[] state_sizes;
+
+  if (_step_num) {
+    *_step_num = (adjoint_step >= 0 ? adjoint_step : state_step);
+  }
+  if (_adjoint) {
+    *_adjoint = (adjoint_step >= 0);
+  }
+
+  return fail;
+}
+
+/*
+  Find the position of the first snapshot when reversing l steps with
+  c free snapshots. This is the binomial (revolve) schedule: the
+  smallest number of repetitions t is selected such that
+  beta(c, t) = (c + t)!/(c! t!) >= l and the snapshot is placed so that
+  the two remaining segments can each be reversed within t repetitions.
+*/
+static int TacsGetSnapshotSplit(int l, int c) {
+  double beta = 1.0;
+  int t = 0;
+  while (beta < l) {
+    t++;
+    beta = beta * (c + t) / t;
+  }
+
+  // beta(c, t-1) is the longest segment that can be reversed with
+  // c snapshots and t-1 repetitions
+  int m = int(beta * t / (c + t) + 0.5);
+  if (m > l - 1) {
+    m = l - 1;
+  }
+  if (m < 1) {
+    m = 1;
+  }
+  return m;
+}
+
+/*
+  Set the number of snapshots of the state history stored in memory
+
+  By default, the states at every time step are stored so that the
+  adjoint can be integrated backwards in time. When the number of
+  snapshots is positive, only the steps required to restart the
+  integration from num_snapshots positions (plus the initial
+  conditions) are stored. The remaining states are recomputed during
+  evalFunctions() and integrateAdjoint() using a binomial checkpointing
+  schedule. Each snapshot stores the states of getStepWindow() steps.
+
+  The forces passed to each step are copied so that the recomputed
+  steps use the same loads as the original ones. Steps with the same
+  forces share a copy and steps with zero forces store none, so the
+  storage for the forces is proportional to the number of distinct
+  loads. The auxiliary elements set at each step are retained by
+  reference and must not be modified during the integration. The
+  recomputed states agree with the original ones to within the
+  tolerance of the Newton solver.
+
+  input:
+  num_snapshots:  the number of snapshots (0 = store the full history)
+*/
+void TACSIntegrator::setNumSnapshots(int _num_snapshots) {
+  int window = getStepWindow();
+  if (_num_snapshots > 0 && window < 0) {
+    if (mpiRank == 0) {
+      fprintf(stderr,
+              "TACSIntegrator: Snapshots are not supported by this "
+              "integrator\n");
+    }
+    return;
+  }
+
+  if (_num_snapshots > 0 && !step_pins) {
+    step_window = window;
+    step_pins = new int[num_time_steps + 1];
+    snapshot_steps = new int[num_time_steps + 1];
+    free_vecs = new TACSBVec *[4 * (num_time_steps + 1)];
+    step_forces = new TACSBVec *[num_time_steps + 1];
+    step_aux = new TACSAuxElements *[num_time_steps + 1];
+    memset(step_pins, 0, (num_time_steps + 1) * sizeof(int));
+    memset(step_forces, 0, (num_time_steps + 1) * sizeof(TACSBVec *));
+    memset(step_aux, 0, (num_time_steps + 1) * sizeof(TACSAuxElements *));
+
+    // Release the states except for the initial conditions
+    for (int k = 1; k < num_time_steps + 1; k++) {
+      q[k]->decref();
+      qdot[k]->decref();
+      qddot[k]->decref();
+      q[k] = qdot[k] = qddot[k] = NULL;
+    }
+    step_pins[0] = 1;
+    num_pinned = 0;
+    num_free_vecs = 0;
+    num_stored_steps = max_stored_steps = 1;
+  } else if (_num_snapshots <= 0 && step_pins) {
+    // Allocate the full state history again
+    for (int k = 0; k < num_time_steps + 1; k++) {
+      if (!q[k]) {
+        allocStepVecs(k);
+      }
+      releaseStepForces(k);
+      if (step_aux[k]) {
+        step_aux[k]->decref();
+      }
+    }
+    for (int i = 0; i < num_free_vecs; i++) {
+      free_vecs[i]->decref();
+    }
+    delete[] step_pins;
+    delete[] snapshot_steps;
+    delete[] free_vecs;
+    delete[] step_forces;
+    delete[] step_aux;
+    step_pins = NULL;
+    snapshot_steps = NULL;
+    free_vecs = NULL;
+    step_forces = NULL;
+    step_aux = NULL;
+    num_free_vecs = 0;
+    num_stored_steps = max_stored_steps = num_time_steps + 1;
+  }
+
+  num_snapshots = (_num_snapshots > 0 ? _num_snapshots : 0);
+}
+
+/*
+  Prepare to compute the given step during the forward integration
+
+  This records the forces and auxiliary elements for the step so that
+  it can be recomputed, stores a snapshot at the previous step if it
+  is part of the binomial schedule and releases the states that are no
+  longer needed to advance the integration.
+*/
+void TACSIntegrator::initStep(int k, TACSBVec *forces) {
+  if (!step_pins || replaying) {
+    return;
+  }
+
+  if (k == 0) {
+    // Discard the history from any previous integration
+    for (int j = 0; j < num_time_steps + 1; j++) {
+      releaseStepForces(j);
+    }
+    for (int j = 1; j < num_time_steps + 1; j++) {
+      step_pins[j] = 0;
+      if (q[j]) {
+        freeStepVecs(j);
+      }
+    }
+    num_pinned = 0;
+    num_recompute_steps = 0;
+    time_recompute = 0.0;
+    max_stored_steps = num_stored_steps;
+
+    next_snapshot = -1;
+    if (num_time_steps > 1) {
+      next_snapshot = TacsGetSnapshotSplit(num_time_steps, num_snapshots);
+    }
+  } else {
+    // Store the snapshot at the last completed step
+    int last = k - 1;
+    if (last == next_snapshot) {
+      pinSnapshot(last);
+      next_snapshot = -1;
+      int c = num_snapshots - num_pinned;
+      int l = num_time_steps - last;
+      if (c > 0 && l > 1) {
+        next_snapshot = last + TacsGetSnapshotSplit(l, c);
+      }
+    }
+
+    // Release the step that is no longer required
+    int j = k - step_window - 1;
+    if (j > 0 && step_pins[j] == 0 && q[j]) {
+      freeStepVecs(j);
+    }
+  }
+
+  // Record the loads applied at this step
+  setStepForces(k, forces);
+  TACSAuxElements *aux = assembler->getAuxElements();
+  if (aux) {
+    aux->incref();
+  }
+  if (step_aux[k]) {
+    step_aux[k]->decref();
+  }
+  step_aux[k] = aux;
+
+  if (!q[k]) {
+    allocStepVecs(k);
+  }
+}
+
+/*
+  Make the states at the given step available
+
+  If the states are not stored, the integration is restarted from the
+  most recent stored step and new snapshots are placed according to
+  the binomial schedule using the snapshots that are still free.
+*/
+void TACSIntegrator::restoreStep(int k) {
+  if (!step_pins || q[k]) {
+    return;
+  }
+
+  double t0 = MPI_Wtime();
+
+  // Save the data modified when the steps are recomputed
+  int _print_level = print_level;
+  double _time_fwd_assembly = time_fwd_assembly;
+  double _time_fwd_factor = time_fwd_factor;
+  double _time_fwd_apply_factor = time_fwd_apply_factor;
+  double _time_newton = time_newton;
+  TACSAuxElements *aux = assembler->getAuxElements();
+  if (aux) {
+    aux->incref();
+  }
+
+  print_level = 0;
+  replaying = 1;
+
+  while (!q[k]) {
+    // Find the most recent step from which to restart
+    int start = k - 1;
+    while (!isRestartStep(start)) {
+      start--;
+    }
+
+    // Place a snapshot between the restart and the requested step
+    int end = k;
+    int c = num_snapshots - num_pinned;
+    if (c > 0 && k - start > 1) {
+      end = start + TacsGetSnapshotSplit(k - start, c);
+    }
+
+    advanceSteps(start, end);
+    if (end < k) {
+      pinSnapshot(end);
+    }
+  }
+
+  replaying = 0;
+  print_level = _print_level;
+  time_fwd_assembly = _time_fwd_assembly;
+  time_fwd_factor = _time_fwd_factor;
+  time_fwd_apply_factor = _time_fwd_apply_factor;
+  time_newton = _time_newton;
+  assembler->setAuxElements(aux);
+  if (aux) {
+    aux->decref();
+  }
+
+  time_recompute += MPI_Wtime() - t0;
+}
+
+/*
+  Release the states at the given step after the adjoint step is
+  complete. The states are no longer required for the remainder of the
+  adjoint integration.
+*/
+void TACSIntegrator::releaseStep(int k) {
+  if (!step_pins || k == 0) {
+    return;
+  }
+
+  unpinSnapshot(k);
+  if (step_pins[k] == 0 && q[k]) {
+    freeStepVecs(k);
+  }
+}
+
+/*
+  Allocate the state vectors for the given step from the free pool
+*/
+void TACSIntegrator::allocStepVecs(int k) {
+  TACSBVec **vecs[3] = {&q[k], &qdot[k], &qddot[k]};
+  for (int i = 0; i < 3; i++) {
+    if (num_free_vecs > 0) {
+      num_free_vecs--;
+      *vecs[i] = free_vecs[num_free_vecs];
+    } else {
+      *vecs[i] = TacsCreateStateVec(assembler);
+    }
+  }
+
+  num_stored_steps++;
+  if (num_stored_steps > max_stored_steps) {
+    max_stored_steps = num_stored_steps;
+  }
+}
+
+/*
+  Return the state vectors for the given step to the free pool
+*/
+void TACSIntegrator::freeStepVecs(int k) {
+  free_vecs[num_free_vecs] = q[k];
+  free_vecs[num_free_vecs + 1] = qdot[k];
+  free_vecs[num_free_vecs + 2] = qddot[k];
+  num_free_vecs += 3;
+  q[k] = qdot[k] = qddot[k] = NULL;
+  num_stored_steps--;
+}
+
+/*
+  Store a copy of the forces applied at the given step
+
+  The copy is shared with the previous step when the forces are the
+  same, and no copy is stored when the forces are zero.
+*/
+void TACSIntegrator::setStepForces(int k, TACSBVec *forces) {
+  releaseStepForces(k);
+  if (!forces) {
+    return;
+  }
+
+  // Check whether the forces are zero or match the previous step
+  TACSBVec *prev = (k > 0 ? step_forces[k - 1] : NULL);
+  TacsScalar *f, *p = NULL;
+  int size = forces->getArray(&f);
+  if (prev) {
+    prev->getArray(&p);
+  }
+  int flags[2] = {1, (prev != NULL)};
+  for (int i = 0; i < size; i++) {
+    if (f[i] != 0.0) {
+      flags[0] = 0;
+    }
+    if (p && f[i] != p[i]) {
+      flags[1] = 0;
     }
-    delete[] funcs;
   }
+  MPI_Allreduce(MPI_IN_PLACE, flags, 2, MPI_INT, MPI_MIN,
+                assembler->getMPIComm());
 
-  if (dfdx) {
-    for (int i = 0; i < num_funcs; i++) {
-      if (dfdx[i]) {
-        dfdx[i]->decref();
-      }
+  if (flags[0]) {
+    return;
+  } else if (flags[1]) {
+    step_forces[k] = prev;
+  } else {
+    TACSBVec *vec = NULL;
+    if (num_free_vecs > 0) {
+      num_free_vecs--;
+      vec = free_vecs[num_free_vecs];
+    } else {
+      vec = TacsCreateStateVec(assembler);
     }
-    delete[] dfdx;
+    vec->copyValues(forces);
+    step_forces[k] = vec;
   }
+}
 
-  if (dfdXpt) {
-    for (int i = 0; i < num_funcs; i++) {
-      if (dfdXpt[i]) {
-        dfdXpt[i]->decref();
-      }
+/*
+  Release the copy of the forces at the given step. The vector is
+  returned to the free pool once no other step shares it.
+*/
+void TACSIntegrator::releaseStepForces(int k) {
+  TACSBVec *vec = step_forces[k];
+  if (vec) {
+    step_forces[k] = NULL;
+    if ((k == 0 || step_forces[k - 1] != vec) &&
+        (k == num_time_steps || step_forces[k + 1] != vec)) {
+      free_vecs[num_free_vecs] = vec;
+      num_free_vecs++;
     }
-    delete[] dfdXpt;
   }
+}
 
-  // Set the number of functions
-  num_funcs = _num_funcs;
-  funcs = new TACSFunction *[num_funcs];
-  dfdx = new TACSBVec *[num_funcs];
-  dfdXpt = new TACSBVec *[num_funcs];
-
-  for (int i = 0; i < num_funcs; i++) {
-    funcs[i] = _funcs[i];
-    dfdx[i] = assembler->createDesignVec();
-    dfdx[i]->incref();
-    dfdXpt[i] = assembler->createNodeVec();
-    dfdXpt[i]->incref();
+/*
+  Check whether the integration can be restarted after the given step
+*/
+int TACSIntegrator::isRestartStep(int k) {
+  int start = k - step_window + 1;
+  if (start < 0) {
+    start = 0;
+  }
+  for (int j = start; j <= k; j++) {
+    if (!q[j]) {
+      return 0;
+    }
   }
+  return 1;
 }
 
 /*
-  Set the output directory prefix
+  Recompute the steps start+1 through end. The states required to
+  restart the integration after the step start must be stored.
 */
-void TACSIntegrator::setOutputPrefix(const char *_prefix) {
-  strncpy(prefix, _prefix, sizeof(prefix));
+void TACSIntegrator::advanceSteps(int start, int end) {
+  for (int k = start + 1; k <= end; k++) {
+    if (!q[k]) {
+      allocStepVecs(k);
+      assembler->setAuxElements(step_aux[k]);
+      iterate(k, step_forces[k]);
+      num_recompute_steps++;
+    }
+
+    // Release the step that is no longer required
+    int j = k - step_window;
+    if (j > 0 && step_pins[j] == 0 && q[j]) {
+      freeStepVecs(j);
+    }
+  }
 }
 
 /*
-  Integration the equations of motion forward in time.
+  Store a snapshot at the given step
 */
-int TACSIntegrator::integrate() {
-  for (int i = 0; i < num_time_steps + 1; i++) {
-    int flag = iterate(i, NULL);
-    if (flag != 0) {
-      return flag;
-    }
+void TACSIntegrator::pinSnapshot(int k) {
+  snapshot_steps[num_pinned] = k;
+  num_pinned++;
+
+  int start = k - step_window + 1;
+  if (start < 0) {
+    start = 0;
+  }
+  for (int j = start; j <= k; j++) {
+    step_pins[j]++;
   }
-  return 0;
 }
 
 /*
-  Integrate the adjoint equations backwards in time
+  Remove the snapshot stored at the given step, if any
 */
-void TACSIntegrator::integrateAdjoint() {
-  for (int i = num_time_steps; i >= 0; i--) {
-    initAdjoint(i);
-    iterateAdjoint(i, NULL);
-    postAdjoint(i);
+void TACSIntegrator::unpinSnapshot(int k) {
+  int index = 0;
+  while (index < num_pinned && snapshot_steps[index] != k) {
+    index++;
+  }
+  if (index == num_pinned) {
+    return;
+  }
+  num_pinned--;
+  for (; index < num_pinned; index++) {
+    snapshot_steps[index] = snapshot_steps[index + 1];
+  }
+
+  int start = k - step_window + 1;
+  if (start < 0) {
+    start = 0;
+  }
+  for (int j = start; j <= k; j++) {
+    step_pins[j]--;
   }
 }
 
@@ -389,6 +1842,7 @@ void TACSIntegrator::writeRawSolution(const char *filename, int format) {
   if (format == 1) {
     for (int k = 0; k < num_time_steps + 1; k++) {
       // Copy over the state values from TACSBVec
+      restoreStep(k);
       int num_state_vars = q[k]->getArray(&qvals);
       qdot[k]->getArray(&qdotvals);
       qddot[k]->getArray(&qddotvals);
@@ -415,6 +1869,7 @@ void TACSIntegrator::writeRawSolution(const char *filename, int format) {
       */
       for (int k = 0; k < num_time_steps + 1; k++) {
         // Copy over the state values from TACSBVec
+        restoreStep(k);
         int num_state_vars = q[k]->getArray(&qvals);
         qdot[k]->getArray(&qdotvals);
         qddot[k]->getArray(&qddotvals);
@@ -438,6 +1893,7 @@ void TACSIntegrator::writeRawSolution(const char *filename, int format) {
       // Write the DOFS on user specified element number in final ordering
       for (int k = 0; k < num_time_steps + 1; k++) {
         // Copy over the state values from TACSBVec
+        restoreStep(k);
         int num_state_vars = q[k]->getArray(&qvals);
         qdot[k]->getArray(&qdotvals);
         qddot[k]->getArray(&qddotvals);
@@ -478,6 +1934,7 @@ void TACSIntegrator::writeSolutionToF5() {
 */
 void TACSIntegrator::writeStepToF5(int step_num) {
   // Set the current states into TACS
+  restoreStep(step_num);
   assembler->setVariables(q[step_num], qdot[step_num], qddot[step_num]);
   assembler->setSimulationTime(time[step_num]);
 
@@ -538,11 +1995,35 @@ void TACSIntegrator::printWallTime(double t0, int level) {
             time_fwd_apply_factor, time_fwd_apply_factor / t0);
   }
 
+  if (level >= 2 && adaptive_step) {
+    fprintf(logfp, "..[%d] Rejected steps :   %8d %6.2f\n", mpiRank,
+            num_rejected_steps, 1.0 * num_rejected_steps / num_time_steps);
+  }
+
+  if (level >= 2 && (adaptive_jac || use_matrix_free)) {
+    fprintf(logfp, "..[%d] Jacobians      :   %8d %6.2f\n", mpiRank,
+            num_jac_updates, 1.0 * num_jac_updates / num_time_steps);
+    fprintf(logfp, "..[%d] Krylov iters   :   %8d %6.2f\n", mpiRank,
+            num_lin_iters, 1.0 * num_lin_iters / num_time_steps);
+  }
+
   if (level >= 1) {
     fprintf(logfp, ".[%d] Reverse         :  %8.2f %6.2f\n", mpiRank,
             time_reverse, time_reverse / t0);
   }
 
+  if (level >= 1 && step_pins) {
+    fprintf(logfp, ".[%d] Recompute       :  %8.2f %6.2f\n", mpiRank,
+            time_recompute, time_recompute / t0);
+  }
+
+  if (level >= 2 && step_pins) {
+    fprintf(logfp, "..[%d] Steps          :   %8d %6.2f\n", mpiRank,
+            num_recompute_steps, 1.0 * num_recompute_steps / num_time_steps);
+    fprintf(logfp, "..[%d] Stored steps   :   %8d %6.2f\n", mpiRank,
+            max_stored_steps, 1.0 * max_stored_steps / (num_time_steps + 1));
+  }
+
   if (level >= 2) {
     fprintf(logfp, "..[%d] Assembly       :   %8.2f %6.2f\n", mpiRank,
             time_rev_assembly, time_rev_assembly / t0);
@@ -563,12 +2044,17 @@ void TACSIntegrator::printOptionSummary() {
     fprintf(logfp, "===============================================\n");
     fprintf(logfp, "TACSIntegrator: Parameter values\n");
     fprintf(logfp, "===============================================\n");
-    fprintf(logfp, "%-30s %15g\n", "tinit", time[0]);
-    fprintf(logfp, "%-30s %15g\n", "tfinal", time[num_time_steps]);
+    fprintf(logfp, "%-30s %15g\n", "tinit", tinit);
+    fprintf(logfp, "%-30s %15g\n", "tfinal", tfinal);
     fprintf(logfp, "%-30s %15g\n", "step_size", time[1] - time[0]);
     fprintf(logfp, "%-30s %15d\n", "num_time_steps", num_time_steps);
     fprintf(logfp, "%-30s %15d\n", "mpiSize", mpiSize);
     fprintf(logfp, "%-30s %15d\n", "print_level", print_level);
+    fprintf(logfp, "%-30s %15d\n", "adaptive_step", adaptive_step);
+    if (adaptive_step) {
+      fprintf(logfp, "%-30s %15g\n", "step_rtol", step_rtol);
+      fprintf(logfp, "%-30s %15g\n", "step_atol", step_atol);
+    }
 
     fprintf(logfp, "===============================================\n");
     fprintf(logfp, "Nonlinear Solver: Parameter values\n");
@@ -577,6 +2063,13 @@ void TACSIntegrator::printOptionSummary() {
     fprintf(logfp, "%-30s %15g\n", "absolute_tolerance", atol);
     fprintf(logfp, "%-30s %15g\n", "relative_tolerance", rtol);
     fprintf(logfp, "%-30s %15d\n", "jac_comp_freq", jac_comp_freq);
+    fprintf(logfp, "%-30s %15d\n", "use_matrix_free", use_matrix_free);
+    if (use_matrix_free) {
+      fprintf(logfp, "%-30s %15g\n", "mf_rtol", mf_rtol);
+      fprintf(logfp, "%-30s %15g\n", "mf_atol", mf_atol);
+    }
+    fprintf(logfp, "%-30s %15d\n", "adaptive_jac", adaptive_jac);
+    fprintf(logfp, "%-30s %15g\n", "max_contraction", max_contraction);
 
     fprintf(logfp, "===============================================\n");
     fprintf(logfp, "Linear Solver: Parameter values\n");
@@ -637,6 +2130,7 @@ int TACSIntegrator::getNumTimeSteps() { return num_time_steps; }
 int TACSIntegrator::newtonSolve(double alpha, double beta, double gamma,
                                 double t, TACSBVec *u, TACSBVec *udot,
                                 TACSBVec *uddot, TACSBVec *forces) {
+  TACS_PROFILE_SCOPE("TACSIntegrator::newtonSolve");
   // Compute the norm of the forces if supplied
   double force_norm = 0.0;
   if (forces) {
@@ -646,6 +2140,20 @@ int TACSIntegrator::newtonSolve(double alpha, double beta, double gamma,
   // Create KSM
   initializeLinearSolver();
 
+  // Reuse the factored Jacobian based on the observed contraction
+  int lagged = ((adaptive_jac || use_matrix_free) && !use_lapack);
+
+  // Create the Jacobian-free Newton-Krylov solver if required
+  if (use_matrix_free && !use_lapack && !mf_ksm) {
+    if (!mf_mat) {
+      mf_mat = new TACSJacobianVecMat(assembler);
+      mf_mat->incref();
+    }
+    mf_ksm = new GMRES(mf_mat, pc, gmres_iters, num_restarts, is_flexible);
+    mf_ksm->incref();
+    mf_ksm->setTolerances(mf_rtol, mf_atol);
+  }
+
   // Initialize the update norms
   update_norm = 1.0e99;
 
@@ -654,10 +2162,18 @@ int TACSIntegrator::newtonSolve(double alpha, double beta, double gamma,
   res_norm = 0.0;
   int newton_exit_flag = 0;
 
+  // Keep track of linear solver failures and the contraction rate
+  int lin_fail = 0;
+  TacsScalar prev_res_norm = 0.0;
+
   if (logfp && print_level >= 2) {
-    fprintf(logfp, "%12s %12s %12s %12s %12s %12s %12s %12s %12s\n", "#iters",
+    fprintf(logfp, "%12s %12s %12s %12s %12s %12s %12s %12s %12s", "#iters",
             "|R|", "|R|/|R0|", "|dq|", "alpha", "beta", "gamma", "delta",
             "|F|");
+    if (lagged) {
+      fprintf(logfp, " %6s", "jac");
+    }
+    fprintf(logfp, "\n");
   }
 
   // Track the time taken for newton solve at each time step
@@ -672,7 +2188,9 @@ int TACSIntegrator::newtonSolve(double alpha, double beta, double gamma,
 
     // Assemble the Jacobian matrix once in Newton iterations
     double t0 = MPI_Wtime();
-    if ((niter % jac_comp_freq) == 0) {
+    if (lagged) {
+      assembler->assembleRes(res);
+    } else if ((niter % jac_comp_freq) == 0) {
       delta = init_newton_delta * gamma;
       if (niter > 0 && (TacsRealPart(res_norm) < TacsRealPart(init_res_norm))) {
         delta *= TacsRealPart(res_norm / init_res_norm);
@@ -699,6 +2217,7 @@ int TACSIntegrator::newtonSolve(double alpha, double beta, double gamma,
     time_fwd_assembly += MPI_Wtime() - t0;
 
     // Compute the L2-norm of the residual
+    prev_res_norm = res_norm;
     res_norm = res->norm();
 
     // Record the residual norm at the first Newton iteration
@@ -706,22 +2225,44 @@ int TACSIntegrator::newtonSolve(double alpha, double beta, double gamma,
       init_res_norm = res_norm;
     }
 
+    // Decide whether the lagged Jacobian must be updated
+    const char *jac_update = NULL;
+    if (lagged) {
+      if (!jac_current) {
+        jac_update = "init";
+      } else if (fabs(alpha - jac_alpha) > 1e-12 * fabs(alpha) ||
+                 fabs(beta - jac_beta) > 1e-12 * fabs(beta) ||
+                 fabs(gamma - jac_gamma) > 1e-12 * fabs(gamma)) {
+        jac_update = "coef";
+      } else if (lin_fail) {
+        jac_update = "lin";
+      } else if (niter > 0 &&
+                 TacsRealPart(res_norm) >
+                     max_contraction * TacsRealPart(prev_res_norm)) {
+        jac_update = "slow";
+      }
+    }
+
     // Write a summary
     if (logfp && print_level >= 2) {
       if (niter == 0) {
         fprintf(logfp,
-                "%12d %12.5e %12.5e %12s %12.5e %12.5e %12.5e %12.5e %12.5e\n",
+                "%12d %12.5e %12.5e %12s %12.5e %12.5e %12.5e %12.5e %12.5e",
                 niter, TacsRealPart(res_norm),
                 (niter == 0) ? 1.0 : TacsRealPart(res_norm / init_res_norm),
                 " ", alpha, beta, gamma, delta, force_norm);
       } else {
-        fprintf(
-            logfp,
-            "%12d %12.5e %12.5e %12.5e %12.5e %12.5e %12.5e %12.5e %12.5e\n",
-            niter, TacsRealPart(res_norm),
-            (niter == 0) ? 1.0 : TacsRealPart(res_norm / init_res_norm),
-            TacsRealPart(update_norm), alpha, beta, gamma, delta, force_norm);
+        fprintf(logfp,
+                "%12d %12.5e %12.5e %12.5e %12.5e %12.5e %12.5e %12.5e %12.5e",
+                niter, TacsRealPart(res_norm),
+                (niter == 0) ? 1.0 : TacsRealPart(res_norm / init_res_norm),
+                TacsRealPart(update_norm), alpha, beta, gamma, delta,
+                force_norm);
       }
+      if (lagged) {
+        fprintf(logfp, " %6s", jac_update ? jac_update : "-");
+      }
+      fprintf(logfp, "\n");
     }
 
     // Check if the norm of the residuals is a NaN
@@ -759,17 +2300,61 @@ int TACSIntegrator::newtonSolve(double alpha, double beta, double gamma,
       }
       // Perform the linear solve using LAPACK (serial only)
       lapackLinearSolve(res, mat, update);
+    } else if (lagged) {
+      // Assemble and factor the Jacobian only when it is updated
+      if (jac_update) {
+        double t1 = MPI_Wtime();
+        delta = init_newton_delta * gamma;
+        if (niter > 0 &&
+            (TacsRealPart(res_norm) < TacsRealPart(init_res_norm))) {
+          delta *= TacsRealPart(res_norm / init_res_norm);
+        }
+
+        TACSMg *mg = dynamic_cast<TACSMg *>(pc);
+        if (mg) {
+          mg->assembleJacobian(alpha, beta, gamma + delta, NULL,
+                               TACS_MAT_NORMAL);
+        } else {
+          assembler->assembleJacobian(alpha, beta, gamma + delta, NULL, mat,
+                                      TACS_MAT_NORMAL);
+        }
+        time_fwd_assembly += MPI_Wtime() - t1;
+
+        double t2 = MPI_Wtime();
+        pc->factor();
+        time_fwd_factor += MPI_Wtime() - t2;
+
+        jac_current = 1;
+        jac_alpha = alpha;
+        jac_beta = beta;
+        jac_gamma = gamma;
+        num_jac_updates++;
+      }
+
+      // Solve for the update using either the Jacobian-vector
+      // products or the lagged Jacobian
+      double t2 = MPI_Wtime();
+      TACSKsm *solver = ksm;
+      if (use_matrix_free) {
+        mf_mat->setCoefficients(alpha, beta, gamma);
+        solver = mf_ksm;
+      }
+      lin_fail = !solver->solve(res, update);
+      num_lin_iters += solver->getIterCount();
+      time_fwd_apply_factor += MPI_Wtime() - t2;
     } else {
       // LU Factor the matrix when needed
       double t1 = MPI_Wtime();
       if ((niter % jac_comp_freq) == 0) {
         pc->factor();
+        num_jac_updates++;
       }
       time_fwd_factor += MPI_Wtime() - t1;
 
       // Solve for update using KSM
       double t2 = MPI_Wtime();
       ksm->solve(res, update);
+      num_lin_iters += ksm->getIterCount();
       time_fwd_apply_factor += MPI_Wtime() - t2;
     }
 
@@ -787,6 +2372,11 @@ int TACSIntegrator::newtonSolve(double alpha, double beta, double gamma,
     newton_exit_flag = -1;
   }
 
+  // Update the Jacobian at the next solve if this solve failed
+  if (newton_exit_flag < 0) {
+    jac_current = 0;
+  }
+
   // Record the time taken for nonlinear solution
   time_newton = MPI_Wtime() - tnewton;
 
@@ -1095,6 +2685,12 @@ void TACSIntegrator::lapackLinearSolve(TACSBVec *res, TACSMat *mat,
   Implement all the tasks to perform during each time step
 */
 void TACSIntegrator::logTimeStep(int step_num) {
+  // Recomputed steps are not logged and trial steps are logged once
+  // they have been accepted
+  if (replaying || trial_step) {
+    return;
+  }
+
   if (step_num == 0) {
     // Keep track of the time taken for foward mode
     time_forward = MPI_Wtime();
@@ -1116,12 +2712,23 @@ void TACSIntegrator::logTimeStep(int step_num) {
   TacsScalar energies[2];
   assembler->evalEnergies(&energies[0], &energies[1]);
 
+  // Log the Jacobian updates when the Jacobian is lagged
+  int lagged = ((adaptive_jac || use_matrix_free) && !use_lapack);
+
   if (step_num == 0) {
+    // Reset the cumulative Jacobian and Krylov counts
+    num_jac_updates = 0;
+    num_lin_iters = 0;
+
     // Log information
     if (logfp && print_level >= 1) {
-      fprintf(logfp, "%12s %12s %12s %12s %12s %12s %12s %12s %12s %12s\n",
+      fprintf(logfp, "%12s %12s %12s %12s %12s %12s %12s %12s %12s %12s",
               "status", "time", "tnewton", "#iters", "|R|", "|R|/|R0|", "|dq|",
               "KE", "PE", "E0-E");
+      if (lagged) {
+        fprintf(logfp, " %6s %6s", "#jac", "#lin");
+      }
+      fprintf(logfp, "\n");
 
       // Compute the initial energy
       init_energy = energies[0] + energies[1];
@@ -1129,9 +2736,13 @@ void TACSIntegrator::logTimeStep(int step_num) {
       // Log the details
       fprintf(logfp,
               "%6d/%-6d %12.5e %12.5e %12d %12.5e "
-              "%12.5e %12.5e %12.5e %12.5e %12.5e\n",
+              "%12.5e %12.5e %12.5e %12.5e %12.5e",
               0, num_time_steps, time[0], time_newton, 0, 0.0, 0.0, 0.0,
               TacsRealPart(energies[0]), TacsRealPart(energies[1]), 0.0);
+      if (lagged) {
+        fprintf(logfp, " %6d %6d", 0, 0);
+      }
+      fprintf(logfp, "\n");
     }
   } else {
     // Print out the time step summary
@@ -1139,20 +2750,28 @@ void TACSIntegrator::logTimeStep(int step_num) {
       // Need a title for total summary as details of Newton iteration
       // will overshadow this one line summary
       if (print_level == 2) {
-        fprintf(logfp, "%12s %12s %12s %12s %12s %12s %12s %12s %12s %12s\n",
+        fprintf(logfp, "%12s %12s %12s %12s %12s %12s %12s %12s %12s %12s",
                 "status", "time", "tnewton", "#iters", "|R|", "|R|/|R0|",
                 "|dq|", "KE", "PE", "E0-E");
+        if (lagged) {
+          fprintf(logfp, " %6s %6s", "#jac", "#lin");
+        }
+        fprintf(logfp, "\n");
       }
 
       fprintf(logfp,
               "%6d/%-6d %12.5e %12.5e %12d %12.5e "
-              "%12.5e %12.5e %12.5e %12.5e %12.5e\n",
+              "%12.5e %12.5e %12.5e %12.5e %12.5e",
               step_num, num_time_steps, time[step_num], time_newton, niter,
               TacsRealPart(res_norm),
               TacsRealPart(res_norm / (rtol + init_res_norm)),
               TacsRealPart(update_norm), TacsRealPart(energies[0]),
               TacsRealPart(energies[1]),
               TacsRealPart((init_energy - (energies[0] + energies[1]))));
+      if (lagged) {
+        fprintf(logfp, " %6d %6d", num_jac_updates, num_lin_iters);
+      }
+      fprintf(logfp, "\n");
     }
   }
 }
@@ -1162,6 +2781,7 @@ void TACSIntegrator::logTimeStep(int step_num) {
 */
 double TACSIntegrator::getStates(int step_num, TACSBVec **_q, TACSBVec **_qdot,
                                  TACSBVec **_qddot) {
+  restoreStep(step_num);
   if (_q) {
     *_q = q[step_num];
   }
@@ -1221,6 +2841,7 @@ void TACSIntegrator::initializeLinearSolver() {
 
   // Set the global variable to initialize linear solver
   linear_solver_initialized = 1;
+  jac_current = 0;
 }
 
 /*
@@ -1526,6 +3147,9 @@ int TACSBDFIntegrator::getBDFCoeff(const int k, double bdf[], int order) {
   with FUNtoFEM.
 */
 int TACSBDFIntegrator::iterate(int k, TACSBVec *forces) {
+  // Allocate the states for this step when only snapshots are stored
+  initStep(k, forces);
+
   if (k == 0) {
     // Output the results at the initial condition if configured
     printOptionSummary();
@@ -1621,6 +3245,7 @@ void TACSBDFIntegrator::evalFunctions(TacsScalar *fvals) {
 
     for (int k = start_plane; k <= end_plane; k++) {
       // Set the stages
+      restoreStep(k);
       assembler->setSimulationTime(time[k]);
       assembler->setVariables(q[k], qdot[k], qddot[k]);
 
@@ -1650,6 +3275,7 @@ void TACSBDFIntegrator::evalFunctions(TacsScalar *fvals) {
   }
 
   for (int k = start_plane; k <= end_plane; k++) {
+    restoreStep(k);
     assembler->setSimulationTime(time[k]);
     assembler->setVariables(q[k], qdot[k], qddot[k]);
 
@@ -1680,11 +3306,16 @@ void TACSBDFIntegrator::evalFunctions(TacsScalar *fvals) {
 }
 
 /*
-  Initialize the right-hand-side contributions to the adjoint, compute
-  the Jacobian and factorize it.
+  The BDF formula for the second derivative uses the states from up to
+  2*max_bdf_order previous steps
 */
-void TACSBDFIntegrator::initAdjoint(int k) {
-  // Adjoint variables for each function of interest
+int TACSBDFIntegrator::getStepWindow() { return 2 * max_bdf_order; }
+
+/*
+  Allocate the adjoint variables and right-hand-sides if they have not
+  already been allocated
+*/
+void TACSBDFIntegrator::initAdjointVecs() {
   if (!psi) {
     psi = new TACSBVec *[num_funcs];
     for (int i = 0; i < num_funcs; i++) {
@@ -1701,6 +3332,38 @@ void TACSBDFIntegrator::initAdjoint(int k) {
       rhs[i]->incref();
     }
   }
+}
+
+/*
+  Get the adjoint vectors that must be stored to restart the adjoint
+  integration. This includes the adjoint variables and the
+  right-hand-sides accumulated from the previous steps.
+*/
+int TACSBDFIntegrator::getCheckpointAdjointVecs(TACSBVec **vecs) {
+  int count = TACSIntegrator::getCheckpointAdjointVecs(vecs);
+
+  initAdjointVecs();
+  for (int i = 0; i < num_funcs; i++, count++) {
+    if (vecs) {
+      vecs[count] = psi[i];
+    }
+  }
+  for (int i = 0; i < num_funcs * num_adjoint_rhs; i++, count++) {
+    if (vecs) {
+      vecs[count] = rhs[i];
+    }
+  }
+
+  return count;
+}
+
+/*
+  Initialize the right-hand-side contributions to the adjoint, compute
+  the Jacobian and factorize it.
+*/
+void TACSBDFIntegrator::initAdjoint(int k) {
+  // Adjoint variables for each function of interest
+  initAdjointVecs();
 
   // Zero the right-hand-sides at the last time-step
   if (k == num_time_steps) {
@@ -1735,6 +3398,9 @@ void TACSBDFIntegrator::initAdjoint(int k) {
     initializeLinearSolver();
   }
 
+  // Recompute the states at this step if they are not stored
+  restoreStep(k);
+
   // Set the simulation time
   assembler->setSimulationTime(time[k]);
   assembler->setVariables(q[k], qdot[k], qddot[k]);
@@ -1798,6 +3464,9 @@ void TACSBDFIntegrator::initAdjoint(int k) {
     double tfactor = MPI_Wtime();
     pc->factor();
     time_rev_factor += MPI_Wtime() - tfactor;
+
+    // The factorization can no longer be used for the forward problem
+    jac_current = 0;
   }
 }
 
@@ -1900,6 +3569,9 @@ void TACSBDFIntegrator::postAdjoint(int k) {
     // Keep track of the time taken for foward mode
     time_reverse = MPI_Wtime() - time_reverse;
   }
+
+  // Release the states at this step if only snapshots are stored
+  releaseStep(k);
 }
 
 /*
@@ -1939,14 +3611,9 @@ TACSDIRKIntegrator::TACSDIRKIntegrator(TACSAssembler *_tacs, double _tinit,
 
   // create state vectors for TACS during each timestep
   for (int k = 0; k < num_stages * num_time_steps; k++) {
-    qS[k] = assembler->createVec();
-    qS[k]->incref();
-
-    qdotS[k] = assembler->createVec();
-    qdotS[k]->incref();
-
-    qddotS[k] = assembler->createVec();
-    qddotS[k]->incref();
+    qS[k] = TacsCreateStateVec(assembler);
+    qdotS[k] = TacsCreateStateVec(assembler);
+    qddotS[k] = TacsCreateStateVec(assembler);
   }
 
   // Allocate space for Butcher tableau
@@ -1990,7 +3657,7 @@ TACSDIRKIntegrator::~TACSDIRKIntegrator() {
   delete[] B;
 
   // Cleanup stage states
-  for (int i = 0; i < num_stages * num_time_steps; i++) {
+  for (int i = 0; i < num_stages * step_capacity; i++) {
     qS[i]->decref();
     qdotS[i]->decref();
     qddotS[i]->decref();
@@ -2460,11 +4127,118 @@ void TACSDIRKIntegrator::evalFunctions(TacsScalar *fvals) {
   }
 }
 
+/*
+  Get the vectors that must be stored for each step. This includes the
+  stage states that were computed during the step.
+*/
+int TACSDIRKIntegrator::getCheckpointStepVecs(int step_num, TACSBVec **vecs) {
+  int count = TACSIntegrator::getCheckpointStepVecs(step_num, vecs);
+
+  if (step_num > 0) {
+    int offset = (step_num - 1) * num_stages;
+    for (int k = offset; k < offset + num_stages; k++, count += 3) {
+      if (vecs) {
+        vecs[count] = qS[k];
+        vecs[count + 1] = qdotS[k];
+        vecs[count + 2] = qddotS[k];
+      }
+    }
+  }
+
+  return count;
+}
+
+/*
+  Get the adjoint vectors that must be stored to restart the adjoint
+  integration. This includes the inter-stage adjoint vectors.
+*/
+int TACSDIRKIntegrator::getCheckpointAdjointVecs(TACSBVec **vecs) {
+  int count = TACSIntegrator::getCheckpointAdjointVecs(vecs);
+
+  initAdjointVecs();
+  for (int i = 0; i < num_funcs; i++, count += 2) {
+    if (vecs) {
+      vecs[count] = psi[i];
+      vecs[count + 1] = phi[i];
+    }
+  }
+
+  return count;
+}
+
+/*
+  The DIRK schemes do not have an embedded method. Instead, the local
+  error is estimated from the difference between the solution and the
+  second-order Taylor series predictor
+
+  q[k] = q[k-1] + h*qdot[k-1] + 0.5*h^2*qddot[k-1]
+  qdot[k] = qdot[k-1] + h*qddot[k-1]
+*/
+int TACSDIRKIntegrator::getErrorOrder() { return 2; }
+
+/*
+  Estimate the local error of the step from the predictor-corrector
+  difference. The residual and update vectors are used as temporary
+  storage since the step is complete.
+*/
+double TACSDIRKIntegrator::estimateStepError(int k) {
+  double h = time[k] - time[k - 1];
+
+  res->copyValues(q[k]);
+  res->axpy(-1.0, q[k - 1]);
+  res->axpy(-h, qdot[k - 1]);
+  res->axpy(-0.5 * h * h, qddot[k - 1]);
+
+  update->copyValues(qdot[k]);
+  update->axpy(-1.0, qdot[k - 1]);
+  update->axpy(-h, qddot[k - 1]);
+
+  return getStepErrorNorm(k, res, update);
+}
+
+/*
+  Grow the storage for the stage states
+*/
+void TACSDIRKIntegrator::reserveStageVecs(int old_steps, int new_steps) {
+  int old_size = num_stages * old_steps;
+  int new_size = num_stages * new_steps;
+  TacsGrowVecArray(assembler, &qS, old_size, new_size);
+  TacsGrowVecArray(assembler, &qdotS, old_size, new_size);
+  TacsGrowVecArray(assembler, &qddotS, old_size, new_size);
+}
+
 /*
   Set-up right-hand-sides for the adjoint equations
 */
 void TACSDIRKIntegrator::initAdjoint(int step_num) {
   // Adjoint variables for each function of interest
+  initAdjointVecs();
+
+  // Zero the entries at the final step
+  if (step_num == num_time_steps) {
+    for (int i = 0; i < num_funcs; i++) {
+      psi[i]->zeroEntries();
+      phi[i]->zeroEntries();
+
+      // Zero the derivative!
+      dfdx[i]->zeroEntries();
+      dfdXpt[i]->zeroEntries();
+    }
+
+    // Initialize linear solver
+    initializeLinearSolver();
+  }
+
+  for (int i = 0; i < num_funcs * num_stages; i++) {
+    omega[i]->zeroEntries();
+    domega[i]->zeroEntries();
+  }
+}
+
+/*
+  Allocate the adjoint vectors if they have not already been allocated
+*/
+void TACSDIRKIntegrator::initAdjointVecs() {
   if (!lambda) {
     rhs = assembler->createVec();
     rhs->incref();
@@ -2496,26 +4270,6 @@ void TACSDIRKIntegrator::initAdjoint(int step_num) {
       psi[i]->incref();
     }
   }
-
-  // Zero the entries at the final step
-  if (step_num == num_time_steps) {
-    for (int i = 0; i < num_funcs; i++) {
-      psi[i]->zeroEntries();
-      phi[i]->zeroEntries();
-
-      // Zero the derivative!
-      dfdx[i]->zeroEntries();
-      dfdXpt[i]->zeroEntries();
-    }
-
-    // Initialize linear solver
-    initializeLinearSolver();
-  }
-
-  for (int i = 0; i < num_funcs * num_stages; i++) {
-    omega[i]->zeroEntries();
-    domega[i]->zeroEntries();
-  }
 }
 
 /*
@@ -2562,6 +4316,7 @@ void TACSDIRKIntegrator::iterateAdjoint(int k, TACSBVec **adj_rhs) {
 
     // Factor the preconditioner
     pc->factor();
+    jac_current = 0;
 
     // Compute the derivatives and store them
     if (k > start_plane && k <= end_plane) {
@@ -2762,14 +4517,9 @@ TACSESDIRKIntegrator::TACSESDIRKIntegrator(TACSAssembler *_tacs, double _tinit,
 
   // create the state vectors for TACS for each stage of each time step
   for (int k = 0; k < num_stages * num_time_steps; k++) {
-    qS[k] = assembler->createVec();
-    qS[k]->incref();
-
-    qdotS[k] = assembler->createVec();
-    qdotS[k]->incref();
-
-    qddotS[k] = assembler->createVec();
-    qddotS[k]->incref();
+    qS[k] = TacsCreateStateVec(assembler);
+    qdotS[k] = TacsCreateStateVec(assembler);
+    qddotS[k] = TacsCreateStateVec(assembler);
   }
 
   // allocate sapce for the Butcher Tableau integration coefficents
@@ -2778,6 +4528,8 @@ TACSESDIRKIntegrator::TACSESDIRKIntegrator(TACSAssembler *_tacs, double _tinit,
   c = new double[num_stages];
   A = new double[num_stages * (num_stages + 1) / 2];
   B = new double[num_stages];
+  bhat = new double[num_stages];
+  Bhat = new double[num_stages];
 
   // set the Butcher Tableau integration coefficients to zero
   memset(a, 0., num_stages * (num_stages + 1) / 2 * sizeof(double));
@@ -2785,6 +4537,8 @@ TACSESDIRKIntegrator::TACSESDIRKIntegrator(TACSAssembler *_tacs, double _tinit,
   memset(c, 0., num_stages * sizeof(double));
   memset(A, 0., num_stages * (num_stages + 1) / 2 * sizeof(double));
   memset(B, 0., num_stages * sizeof(double));
+  memset(bhat, 0., num_stages * sizeof(double));
+  memset(Bhat, 0., num_stages * sizeof(double));
 
   // assign the coefficients in the Butcher Tableau (first-order)
   setupDefaultCoeffs();
@@ -2793,6 +4547,64 @@ TACSESDIRKIntegrator::TACSESDIRKIntegrator(TACSAssembler *_tacs, double _tinit,
   setupSecondCoeffs();
 }
 
+/*
+  Get the vectors that must be stored for each step. This includes the
+  stage states that were computed during the step.
+*/
+int TACSESDIRKIntegrator::getCheckpointStepVecs(int step_num,
+                                                TACSBVec **vecs) {
+  int count = TACSIntegrator::getCheckpointStepVecs(step_num, vecs);
+
+  if (step_num > 0) {
+    int offset = (step_num - 1) * num_stages;
+    for (int k = offset; k < offset + num_stages; k++, count += 3) {
+      if (vecs) {
+        vecs[count] = qS[k];
+        vecs[count + 1] = qdotS[k];
+        vecs[count + 2] = qddotS[k];
+      }
+    }
+  }
+
+  return count;
+}
+
+/*
+  The order of the embedded method is one less than the order of the
+  ESDIRK scheme
+*/
+int TACSESDIRKIntegrator::getErrorOrder() { return num_stages / 2; }
+
+/*
+  Estimate the local error of the step from the difference between the
+  ESDIRK solution and the solution of the embedded method. The residual
+  and update vectors are used as temporary storage.
+*/
+double TACSESDIRKIntegrator::estimateStepError(int k) {
+  double h = time[k] - time[k - 1];
+
+  res->zeroEntries();
+  update->zeroEntries();
+  for (int stage = 0; stage < num_stages; stage++) {
+    int offset = (k - 1) * num_stages + stage;
+    res->axpy(h * h * (B[stage] - Bhat[stage]), qddotS[offset]);
+    update->axpy(h * (b[stage] - bhat[stage]), qddotS[offset]);
+  }
+
+  return getStepErrorNorm(k, res, update);
+}
+
+/*
+  Grow the storage for the stage states
+*/
+void TACSESDIRKIntegrator::reserveStageVecs(int old_steps, int new_steps) {
+  int old_size = num_stages * old_steps;
+  int new_size = num_stages * new_steps;
+  TacsGrowVecArray(assembler, &qS, old_size, new_size);
+  TacsGrowVecArray(assembler, &qdotS, old_size, new_size);
+  TacsGrowVecArray(assembler, &qddotS, old_size, new_size);
+}
+
 /*
   destructor for TACSESDIRKIntegrator
 */
@@ -2803,9 +4615,11 @@ TACSESDIRKIntegrator::~TACSESDIRKIntegrator() {
   delete[] c;
   delete[] A;
   delete[] B;
+  delete[] bhat;
+  delete[] Bhat;
 
   // clean up the stage states
-  for (int k = 0; k < num_stages * num_time_steps; k++) {
+  for (int k = 0; k < num_stages * step_capacity; k++) {
     qS[k]->decref();
     qdotS[k]->decref();
     qddotS[k]->decref();
@@ -2852,6 +4666,12 @@ void TACSESDIRKIntegrator::setupDefaultCoeffs() {
     c[1] = 1767732205903.0 / 2027836641118.0;
     c[2] = 3.0 / 5.0;
     c[3] = 1.0;
+
+    // embedded 2nd-order weights
+    bhat[0] = 2756255671327.0 / 12835298489170.0;
+    bhat[1] = -10771552573575.0 / 22201958757719.0;
+    bhat[2] = 9247589265047.0 / 10645013368117.0;
+    bhat[3] = 2193209047091.0 / 5459859503100.0;
   }
 
   else if (num_stages == 6) {
@@ -2891,6 +4711,14 @@ void TACSESDIRKIntegrator::setupDefaultCoeffs() {
     c[3] = 31.0 / 50.0;
     c[4] = 17.0 / 20.0;
     c[5] = 1.0;
+
+    // embedded 3rd-order weights
+    bhat[0] = 4586570599.0 / 29645900160.0;
+    bhat[1] = 0.0;
+    bhat[2] = 178811875.0 / 945068544.0;
+    bhat[3] = 814220225.0 / 1159782912.0;
+    bhat[4] = -3700637.0 / 11593932.0;
+    bhat[5] = 61727.0 / 225920.0;
   }
 
   else if (num_stages == 8) {
@@ -2949,6 +4777,16 @@ void TACSESDIRKIntegrator::setupDefaultCoeffs() {
     c[5] = 24.0 / 100.0;
     c[6] = 3.0 / 5.0;
     c[7] = 1.0;
+
+    // embedded 4th-order weights
+    bhat[0] = -975461918565.0 / 9796059967033.0;
+    bhat[1] = 0.0;
+    bhat[2] = 0.0;
+    bhat[3] = 78070527104295.0 / 32432590147079.0;
+    bhat[4] = -548382580838.0 / 3424219808633.0;
+    bhat[5] = -33438840321285.0 / 15594753105479.0;
+    bhat[6] = 3629800801594.0 / 4656183773603.0;
+    bhat[7] = 4035322873751.0 / 18575991585200.0;
   }
 
   else {
@@ -2971,9 +4809,11 @@ void TACSESDIRKIntegrator::setupSecondCoeffs() {
   // set the values of the B coefficients
   for (int i = 0; i < num_stages; i++) {
     B[i] = 0.0;
+    Bhat[i] = 0.0;
     // loop over the rows in the tableau
     for (int j = 0; j < num_stages; j++) {
       B[i] += b[j] * getACoeff(j, i);
+      Bhat[i] += bhat[j] * getACoeff(j, i);
     }
   }
 
@@ -17,6 +17,7 @@
 
 #include "KSM.h"
 #include "TACSAssembler.h"
+#include "TACSMatrixFreeMat.h"
 #include "TACSObject.h"
 #include "TACSToFH5.h"
 
@@ -48,6 +49,9 @@ class TACSIntegrator : public TACSObject {
   void setUseSchurMat(int _use_schur_mat, TACSAssembler::OrderingType _type);
   void setInitNewtonDeltaFraction(double frac);
   void setKrylovSubspaceMethod(TACSKsm *_ksm);
+  void setUseMatrixFree(int _use_matrix_free);
+  void setMatrixFreeTolerances(double _mf_rtol, double _mf_atol = 1e-30);
+  void setAdaptiveJacobian(int _adaptive_jac, double _max_contraction = 0.5);
 
   // Set (or reset) the time interval
   // --------------------------------
@@ -122,6 +126,23 @@ class TACSIntegrator : public TACSObject {
   void printOptionSummary();
   void printAdjointOptionSummary();
 
+  // Checkpoint and restart the forward and adjoint integration
+  //-----------------------------------------------------------
+  void setCheckpointFrequency(int _checkpoint_freq);
+  int writeCheckpoint(const char *filename, int step_num, int adjoint = 0);
+  int readCheckpoint(const char *filename, int *step_num = NULL,
+                     int *adjoint = NULL);
+
+  // Limit the stored state history using binomial checkpointing
+  //------------------------------------------------------------
+  void setNumSnapshots(int _num_snapshots);
+
+  // Adapt the time step based on an estimate of the local error
+  //------------------------------------------------------------
+  void setAdaptiveTimeStep(int _adaptive_step, double _step_rtol = 1e-3,
+                           double _step_atol = 1e-6);
+  void setTimeStepLimits(double _min_step, double _max_step);
+
   // Returns the number of time steps configured during instantiation
   //-----------------------------------------------------------------
   int getNumTimeSteps();
@@ -153,11 +174,46 @@ class TACSIntegrator : public TACSObject {
   // Log the time step information
   void logTimeStep(int time_step);
 
+  // Get the vectors that define the integrator state at a checkpoint
+  virtual int getCheckpointStepVecs(int step_num, TACSBVec **vecs);
+  virtual int getCheckpointAdjointVecs(TACSBVec **vecs);
+
+  // The checkpoint file and the last step that it stores
+  char *checkpoint_file;
+  int checkpoint_step;
+
+  // Steps at which to resume the integration after a restart
+  int restart_step;          // Last forward step that was completed
+  int restart_adjoint_step;  // Last adjoint step that was completed
+
+  // Number of previous steps required to advance the integration by
+  // one step, or -1 if the full state history must be stored
+  virtual int getStepWindow() { return -1; }
+
+  // Manage the state history when only snapshots are stored
+  void initStep(int step_num, TACSBVec *forces);
+  void restoreStep(int step_num);
+  void releaseStep(int step_num);
+
+  // Order of the local error estimate, or 0 if there is no estimate
+  virtual int getErrorOrder() { return 0; }
+
+  // Estimate the weighted norm of the local error of the given step
+  virtual double estimateStepError(int step_num) { return 0.0; }
+
+  // Compute the weighted RMS norm of the state and velocity errors
+  double getStepErrorNorm(int step_num, TACSBVec *err, TACSBVec *derr);
+
+  // Grow the storage for the time history on demand
+  void reserveTimeSteps(int num_steps);
+  virtual void reserveStageVecs(int old_steps, int new_steps) {}
+
   // TACSAssembler information
   TACSAssembler *assembler;  // Instance of TACSAssembler
 
   // The step information
   int num_time_steps;  // Total number of time steps
+  int step_capacity;   // Number of steps with allocated storage
   double *time;        // Stores the time values
   TACSBVec **q;        // state variables across all time steps
   TACSBVec **qdot;     // first time derivative of ''
@@ -192,6 +248,19 @@ class TACSIntegrator : public TACSObject {
   TACSAssembler::OrderingType order_type;
   int use_lapack;  // Flag to switch to LAPACK for linear solve
 
+  // Jacobian-free Newton-Krylov and lagged Jacobian parameters
+  int use_matrix_free;         // Use Jacobian-vector products in GMRES
+  int adaptive_jac;            // Reuse the Jacobian based on the contraction
+  double max_contraction;      // Contraction rate that triggers an update
+  int jac_current;             // Flag indicating the Jacobian can be reused
+  double jac_alpha;            // dR/dq coefficient of the current Jacobian
+  double jac_beta;             // dR/dqdot coefficient of the current Jacobian
+  double jac_gamma;            // dR/dqddot coeff. of the current Jacobian
+  TACSJacobianVecMat *mf_mat;  // Matrix-free Jacobian
+  TACSKsm *mf_ksm;             // KSM solver for the JFNK mode
+  double mf_rtol;              // Relative tolerance of the JFNK solves
+  double mf_atol;              // Absolute tolerance of the JFNK solves
+
   int lev;
   double fill;
   int reorder_schur;
@@ -209,10 +278,56 @@ class TACSIntegrator : public TACSObject {
   TACSToFH5 *f5;      // F5 output visualization
   int f5_write_freq;  // Frequency for output during time marching
 
+  int checkpoint_freq;  // Frequency for writing checkpoint files
+
+  // Integrate forward in time with adaptive time steps
+  int integrateAdaptive();
+
+  // The time interval requested for the integration
+  double tinit, tfinal;
+
+  // Parameters for the adaptive time step control
+  int adaptive_step;       // Flag to adapt the time step
+  double step_rtol;        // Relative tolerance on the local error
+  double step_atol;        // Absolute tolerance on the local error
+  double min_step;         // Minimum time step (0 = default)
+  double max_step;         // Maximum time step (0 = default)
+  int trial_step;          // Flag indicating a step may be rejected
+  int num_rejected_steps;  // Number of rejected steps
+
+  // Allocate, free and recompute the states for the snapshot mode
+  void allocStepVecs(int step_num);
+  void freeStepVecs(int step_num);
+  int isRestartStep(int step_num);
+  void advanceSteps(int start, int end);
+  void pinSnapshot(int step_num);
+  void unpinSnapshot(int step_num);
+  void setStepForces(int step_num, TACSBVec *forces);
+  void releaseStepForces(int step_num);
+
+  // Data for the binomial checkpointing of the state history
+  int num_snapshots;           // Max. number of snapshots (0 = all steps)
+  int step_window;             // Steps stored with each snapshot
+  int *step_pins;              // Number of snapshots that use each step
+  int *snapshot_steps;         // The steps where snapshots are stored
+  int num_pinned;              // Number of snapshots that are stored
+  int next_snapshot;           // Next snapshot during the forward sweep
+  int num_free_vecs;           // Number of vectors in the free pool
+  TACSBVec **free_vecs;        // Pool of unused vectors
+  TACSBVec **step_forces;      // Copies of the forces used at each step
+  TACSAuxElements **step_aux;  // The auxiliary elements used at each step
+  int replaying;               // Flag indicating steps are recomputed
+  int num_stored_steps;        // Number of steps currently stored
+  int max_stored_steps;        // Peak number of stored steps
+  int num_recompute_steps;     // Number of steps that were recomputed
+  double time_recompute;       // Time spent recomputing steps
+
   int niter;                 // Newton iteration number
   TacsScalar res_norm;       // residual norm
   TacsScalar init_res_norm;  // Initial norm of the residual
   TacsScalar update_norm;    // Norm of the update
+  int num_jac_updates;       // Forward Jacobian factorizations
+  int num_lin_iters;         // Forward Krylov iterations
 
   TacsScalar init_energy;  // The energy during time = 0
 };
@@ -244,7 +359,17 @@ class TACSBDFIntegrator : public TACSIntegrator {
   // Evaluate the functions of interest
   void evalFunctions(TacsScalar *fvals);
 
+ protected:
+  // Get the vectors that define the integrator state at a checkpoint
+  int getCheckpointAdjointVecs(TACSBVec **vecs);
+
+  // Number of previous steps used by the BDF formula
+  int getStepWindow();
+
  private:
+  // Allocate the adjoint vectors
+  void initAdjointVecs();
+
   void get2ndBDFCoeff(const int k, double bdf[], int *nbdf, double bddf[],
                       int *nbddf, const int max_order);
   int getBDFCoeff(const int k, double bdf[], int order);
@@ -291,7 +416,22 @@ class TACSDIRKIntegrator : public TACSIntegrator {
   // Evaluate the functions of interest
   void evalFunctions(TacsScalar *fvals);
 
+ protected:
+  // Get the vectors that define the integrator state at a checkpoint
+  int getCheckpointStepVecs(int step_num, TACSBVec **vecs);
+  int getCheckpointAdjointVecs(TACSBVec **vecs);
+
+  // Estimate the local error from the predictor-corrector difference
+  int getErrorOrder();
+  double estimateStepError(int step_num);
+
+  // Grow the storage for the stage states
+  void reserveStageVecs(int old_steps, int new_steps);
+
  private:
+  // Allocate the adjoint vectors
+  void initAdjointVecs();
+
   // Set the default coefficients
   void setupDefaultCoeffs();
 
@@ -364,6 +504,17 @@ class TACSESDIRKIntegrator : public TACSIntegrator {
   // Get the adjoint value for the given function - adjoint not implemented yet
   void getAdjoint(int step_num, int func_num, TACSBVec **adjoint);
 
+ protected:
+  // Get the vectors that define the integrator state at a checkpoint
+  int getCheckpointStepVecs(int step_num, TACSBVec **vecs);
+
+  // Estimate the local error using the embedded method
+  int getErrorOrder();
+  double estimateStepError(int step_num);
+
+  // Grow the storage for the stage states
+  void reserveStageVecs(int old_steps, int new_steps);
+
  private:
   // set the first-order descirption integration coefficients
   void setupDefaultCoeffs();
@@ -395,6 +546,9 @@ class TACSESDIRKIntegrator : public TACSIntegrator {
 
   // the second order coefficients for the integration scheme
   double *A, *B;
+
+  // the weights of the embedded method used to estimate the error
+  double *bhat, *Bhat;
 };
 
 /*
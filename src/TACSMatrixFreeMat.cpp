@@ -72,4 +72,68 @@ void TACSMatrixFreeMat::multTranspose(TACSVec *tx, TACSVec *ty) {
   }
 }
 
-const char *TACSMatrixFreeMat::getObjectName() { return "TACSMatrixFreeMat"; }
\ No newline at end of file
+const char *TACSMatrixFreeMat::getObjectName() { return "TACSMatrixFreeMat"; }
+TACSJacobianVecMat::TACSJacobianVecMat(TACSAssembler *_assembler) {
+  assembler = _assembler;
+  assembler->incref();
+  alpha = 1.0;
+  beta = 0.0;
+  gamma = 0.0;
+  xbcs = NULL;
+}
+
+TACSJacobianVecMat::~TACSJacobianVecMat() {
+  assembler->decref();
+  if (xbcs) {
+    xbcs->decref();
+  }
+}
+
+void TACSJacobianVecMat::setCoefficients(double _alpha, double _beta,
+                                         double _gamma) {
+  alpha = _alpha;
+  beta = _beta;
+  gamma = _gamma;
+}
+
+TACSVec *TACSJacobianVecMat::createVec() { return assembler->createVec(); }
+
+void TACSJacobianVecMat::mult(TACSVec *tx, TACSVec *ty) {
+  TACSBVec *x = dynamic_cast<TACSBVec *>(tx);
+  TACSBVec *y = dynamic_cast<TACSBVec *>(ty);
+  if (x && y) {
+    y->zeroEntries();
+    assembler->addJacobianVecProduct(1.0, alpha, beta, gamma, x, y,
+                                     TACS_MAT_NORMAL, 1.0, false);
+
+    // Set y = x in the boundary condition rows
+    y->applyBCs(assembler->getBcMap(), x, 0.0);
+  }
+}
+
+void TACSJacobianVecMat::multTranspose(TACSVec *tx, TACSVec *ty) {
+  TACSBVec *x = dynamic_cast<TACSBVec *>(tx);
+  TACSBVec *y = dynamic_cast<TACSBVec *>(ty);
+  if (x && y) {
+    if (!xbcs) {
+      xbcs = assembler->createVec();
+      xbcs->incref();
+    }
+
+    // The boundary condition rows of the Jacobian only contribute the
+    // identity, so drop their entries from x before the product
+    xbcs->copyValues(x);
+    assembler->applyBCs(xbcs);
+    y->zeroEntries();
+    assembler->addJacobianVecProduct(1.0, alpha, beta, gamma, xbcs, y,
+                                     TACS_MAT_TRANSPOSE, 1.0, false);
+
+    // Add the identity contribution from the boundary condition rows
+    y->axpy(1.0, x);
+    y->axpy(-1.0, xbcs);
+  }
+}
+
+const char *TACSJacobianVecMat::getObjectName() {
+  return "TACSJacobianVecMat";
+}
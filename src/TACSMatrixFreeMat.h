@@ -40,4 +40,31 @@ class TACSMatrixFreeMat : public TACSMat {
   int data_size, temp_size;
 };
 
+/*
+  Matrix-free Jacobian that computes the Jacobian-vector products with
+  the element Jacobians evaluated at the current state. No element
+  data is stored between products.
+
+  The product is y = (alpha*dR/dq + beta*dR/dqdot + gamma*dR/dqddot)*x
+  evaluated at the variables currently set in TACSAssembler. As in the
+  assembled Jacobian, the rows of the Dirichlet boundary conditions are
+  replaced with rows of the identity matrix.
+*/
+class TACSJacobianVecMat : public TACSMat {
+ public:
+  TACSJacobianVecMat(TACSAssembler *_assembler);
+  ~TACSJacobianVecMat();
+
+  void setCoefficients(double _alpha, double _beta, double _gamma);
+  TACSVec *createVec();
+  void mult(TACSVec *x, TACSVec *y);
+  void multTranspose(TACSVec *x, TACSVec *y);
+  const char *getObjectName();
+
+ private:
+  TACSAssembler *assembler;
+  double alpha, beta, gamma;
+  TACSBVec *xbcs;  // Temporary vector for the transpose product
+};
+
 #endif  // TACS_MATRIX_FREE_MAT_H
@@ -0,0 +1,525 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSMemoryTracker.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+/*
+  The memory recorded for one owner
+*/
+struct TacsMemoryRecord {
+  const char *name;
+  double current;
+  double peak;
+  double predicted;
+  double predicted_peak;
+  int num_objects;
+};
+
+// The number of values stored for each owner when aggregating
+static const int TACS_MEMORY_NUM_VALUES = 5;
+
+// The records for each owner
+static int tacs_memory_num_records = 0;
+static int tacs_memory_max_records = 0;
+static TacsMemoryRecord *tacs_memory_records = NULL;
+
+// The total memory
+static double tacs_memory_current = 0.0;
+static double tacs_memory_peak = 0.0;
+static double tacs_memory_predicted = 0.0;
+static double tacs_memory_predicted_peak = 0.0;
+
+// Objects may be created and destroyed from different threads
+static pthread_mutex_t tacs_memory_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+int TACSMemoryTracker::dry_run = 0;
+
+/*
+  Find the record for the owner, or return NULL if it does not exist
+*/
+static TacsMemoryRecord *TacsMemoryFindRecord(const char *name) {
+  for (int i = 0; i < tacs_memory_num_records; i++) {
+    const char *rec_name = tacs_memory_records[i].name;
+    if (rec_name == name || strcmp(rec_name, name) == 0) {
+      return &tacs_memory_records[i];
+    }
+  }
+  return NULL;
+}
+
+/*
+  Add a new record for the owner
+*/
+static TacsMemoryRecord *TacsMemoryAddRecord(const char *name) {
+  if (tacs_memory_num_records >= tacs_memory_max_records) {
+    int max_records = 2 * tacs_memory_max_records;
+    if (max_records < 32) {
+      max_records = 32;
+    }
+    TacsMemoryRecord *records = new TacsMemoryRecord[max_records];
+    if (tacs_memory_records) {
+      memcpy(records, tacs_memory_records,
+             tacs_memory_num_records * sizeof(TacsMemoryRecord));
+      delete[] tacs_memory_records;
+    }
+    tacs_memory_records = records;
+    tacs_memory_max_records = max_records;
+  }
+
+  TacsMemoryRecord *rec = &tacs_memory_records[tacs_memory_num_records];
+  tacs_memory_num_records++;
+  rec->name = name;
+  rec->current = rec->peak = 0.0;
+  rec->predicted = rec->predicted_peak = 0.0;
+  rec->num_objects = 0;
+
+  return rec;
+}
+
+/**
+  Record the bytes allocated (or freed when negative) by an owner
+
+  This is called by the TACSObject memory hooks and need not be
+  called directly.
+
+  @param name The name of the owner
+  @param bytes The number of bytes allocated
+  @param num_objects The change in the number of objects
+  @param predicted Flag indicating whether the bytes are predicted
+*/
+void TACSMemoryTracker::add(const char *name, double bytes, int num_objects,
+                            int predicted) {
+  pthread_mutex_lock(&tacs_memory_mutex);
+  TacsMemoryRecord *rec = TacsMemoryFindRecord(name);
+  if (!rec) {
+    rec = TacsMemoryAddRecord(name);
+  }
+  rec->num_objects += num_objects;
+
+  if (predicted) {
+    rec->predicted += bytes;
+    if (rec->predicted > rec->predicted_peak) {
+      rec->predicted_peak = rec->predicted;
+    }
+    tacs_memory_predicted += bytes;
+    if (tacs_memory_predicted > tacs_memory_predicted_peak) {
+      tacs_memory_predicted_peak = tacs_memory_predicted;
+    }
+  } else {
+    rec->current += bytes;
+    if (rec->current > rec->peak) {
+      rec->peak = rec->current;
+    }
+    tacs_memory_current += bytes;
+    if (tacs_memory_current > tacs_memory_peak) {
+      tacs_memory_peak = tacs_memory_current;
+    }
+  }
+  pthread_mutex_unlock(&tacs_memory_mutex);
+}
+
+/**
+  Set the dry-run mode
+
+  In dry-run mode, the objects that compute the fill-in of a matrix
+  factorization record the bytes they would require without
+  allocating the numerical values.
+
+  @param flag Flag indicating whether to use dry-run mode
+*/
+void TACSMemoryTracker::setDryRun(int flag) { dry_run = flag; }
+
+/**
+  Get the current number of bytes on this processor
+
+  @param name The name of the owner, or NULL for the total
+  @param predicted Get the predicted bytes from dry-run mode instead
+  @return The number of bytes
+*/
+double TACSMemoryTracker::getCurrentBytes(const char *name, int predicted) {
+  if (!name) {
+    return (predicted ? tacs_memory_predicted : tacs_memory_current);
+  }
+  TacsMemoryRecord *rec = TacsMemoryFindRecord(name);
+  if (rec) {
+    return (predicted ? rec->predicted : rec->current);
+  }
+  return 0.0;
+}
+
+/**
+  Get the high-water mark of the bytes on this processor
+
+  @param name The name of the owner, or NULL for the total
+  @param predicted Get the predicted bytes from dry-run mode instead
+  @return The number of bytes
+*/
+double TACSMemoryTracker::getPeakBytes(const char *name, int predicted) {
+  if (!name) {
+    return (predicted ? tacs_memory_predicted_peak : tacs_memory_peak);
+  }
+  TacsMemoryRecord *rec = TacsMemoryFindRecord(name);
+  if (rec) {
+    return (predicted ? rec->predicted_peak : rec->peak);
+  }
+  return 0.0;
+}
+
+/**
+  Reset the high-water marks to the current number of bytes
+*/
+void TACSMemoryTracker::resetPeak() {
+  pthread_mutex_lock(&tacs_memory_mutex);
+  for (int i = 0; i < tacs_memory_num_records; i++) {
+    TacsMemoryRecord *rec = &tacs_memory_records[i];
+    rec->peak = rec->current;
+    rec->predicted_peak = rec->predicted;
+  }
+  tacs_memory_peak = tacs_memory_current;
+  tacs_memory_predicted_peak = tacs_memory_predicted;
+  pthread_mutex_unlock(&tacs_memory_mutex);
+}
+
+/**
+  Get the number of owners that have recorded memory on this processor
+*/
+int TACSMemoryTracker::getNumOwners() { return tacs_memory_num_records; }
+
+/**
+  Get the memory recorded by an owner on this processor
+
+  @param index The index of the owner
+  @param current The current number of bytes
+  @param peak The high-water mark of the bytes
+  @param predicted The current number of predicted bytes
+  @param predicted_peak The high-water mark of the predicted bytes
+  @param num_objects The number of objects with memory
+  @return The name of the owner
+*/
+const char *TACSMemoryTracker::getOwner(int index, double *current,
+                                        double *peak, double *predicted,
+                                        double *predicted_peak,
+                                        int *num_objects) {
+  if (index < 0 || index >= tacs_memory_num_records) {
+    return NULL;
+  }
+  TacsMemoryRecord *rec = &tacs_memory_records[index];
+  if (current) {
+    *current = rec->current;
+  }
+  if (peak) {
+    *peak = rec->peak;
+  }
+  if (predicted) {
+    *predicted = rec->predicted;
+  }
+  if (predicted_peak) {
+    *predicted_peak = rec->predicted_peak;
+  }
+  if (num_objects) {
+    *num_objects = rec->num_objects;
+  }
+  return rec->name;
+}
+
+/**
+  Get the high-water mark of the resident set size of this process
+
+  This includes all memory used by the process, not only the memory
+  recorded by TACS objects.
+
+  @return The number of bytes
+*/
+double TACSMemoryTracker::getProcessPeakBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+    return (double)usage.ru_maxrss;
+#else
+    return 1024.0 * usage.ru_maxrss;
+#endif
+  }
+  return 0.0;
+}
+
+/*
+  Compare two owner names for sorting
+*/
+static int TacsMemoryCompareNames(const void *a, const void *b) {
+  return strcmp(*(const char **)a, *(const char **)b);
+}
+
+/*
+  The records from all processors, gathered to the root processor.
+
+  The owner names from all processors are combined into a single
+  sorted list on every processor, and the values for each owner (and
+  the totals, stored last) are gathered to the root.
+*/
+class TacsMemoryData {
+ public:
+  TacsMemoryData(MPI_Comm comm) {
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // Concatenate the local names
+    int name_len = 0;
+    for (int i = 0; i < tacs_memory_num_records; i++) {
+      name_len += strlen(tacs_memory_records[i].name) + 1;
+    }
+    char *local_names = new char[name_len + 1];
+    for (int i = 0, offset = 0; i < tacs_memory_num_records; i++) {
+      strcpy(&local_names[offset], tacs_memory_records[i].name);
+      offset += strlen(tacs_memory_records[i].name) + 1;
+    }
+
+    // Gather all the names on all processors
+    int *counts = new int[size];
+    int *displs = new int[size];
+    MPI_Allgather(&name_len, 1, MPI_INT, counts, 1, MPI_INT, comm);
+    int total_len = 0;
+    for (int k = 0; k < size; k++) {
+      displs[k] = total_len;
+      total_len += counts[k];
+    }
+    names = new char[total_len + 1];
+    MPI_Allgatherv(local_names, name_len, MPI_CHAR, names, counts, displs,
+                   MPI_CHAR, comm);
+    delete[] local_names;
+
+    // Sort and uniquify the names
+    int num_names = 0;
+    for (int i = 0; i < total_len; i++) {
+      if (names[i] == '\0') {
+        num_names++;
+      }
+    }
+    owners = new const char *[num_names + 1];
+    for (int i = 0, offset = 0; i < num_names; i++) {
+      owners[i] = &names[offset];
+      offset += strlen(&names[offset]) + 1;
+    }
+    qsort(owners, num_names, sizeof(const char *), TacsMemoryCompareNames);
+    num_owners = 0;
+    for (int i = 0; i < num_names; i++) {
+      if (i == 0 || strcmp(owners[i], owners[num_owners - 1]) != 0) {
+        owners[num_owners] = owners[i];
+        num_owners++;
+      }
+    }
+
+    // Set the local values in the sorted order
+    int nvals = TACS_MEMORY_NUM_VALUES * (num_owners + 1);
+    double *local_values = new double[nvals];
+    memset(local_values, 0, nvals * sizeof(double));
+    for (int i = 0; i < num_owners; i++) {
+      TacsMemoryRecord *rec = TacsMemoryFindRecord(owners[i]);
+      if (rec) {
+        double *v = &local_values[TACS_MEMORY_NUM_VALUES * i];
+        v[0] = rec->current;
+        v[1] = rec->peak;
+        v[2] = rec->predicted;
+        v[3] = rec->predicted_peak;
+        v[4] = rec->num_objects;
+      }
+    }
+    double *v = &local_values[TACS_MEMORY_NUM_VALUES * num_owners];
+    v[0] = tacs_memory_current;
+    v[1] = tacs_memory_peak;
+    v[2] = tacs_memory_predicted;
+    v[3] = tacs_memory_predicted_peak;
+    v[4] = TACSMemoryTracker::getProcessPeakBytes();
+
+    values = NULL;
+    if (rank == root) {
+      values = new double[size * nvals];
+    }
+    MPI_Gather(local_values, nvals, MPI_DOUBLE, values, nvals, MPI_DOUBLE,
+               root, comm);
+
+    delete[] local_values;
+    delete[] counts;
+    delete[] displs;
+  }
+
+  ~TacsMemoryData() {
+    delete[] names;
+    delete[] owners;
+    if (values) {
+      delete[] values;
+    }
+  }
+
+  /*
+    Get the value for the owner on the given processor. The totals
+    are stored with owner == num_owners.
+  */
+  double getValue(int proc, int owner, int value) {
+    int nvals = TACS_MEMORY_NUM_VALUES * (num_owners + 1);
+    return values[nvals * proc + TACS_MEMORY_NUM_VALUES * owner + value];
+  }
+
+  /*
+    Compute the min/max/avg of one of the values over all processors
+  */
+  void getStats(int owner, int value, double stats[]) {
+    double vmin = 0.0, vmax = 0.0, sum = 0.0;
+    for (int k = 0; k < size; k++) {
+      double v = getValue(k, owner, value);
+      if (k == 0 || v < vmin) {
+        vmin = v;
+      }
+      if (k == 0 || v > vmax) {
+        vmax = v;
+      }
+      sum += v;
+    }
+    stats[0] = vmin;
+    stats[1] = vmax;
+    stats[2] = sum / size;
+  }
+
+  static const int root = 0;
+  int rank, size;
+
+  // The sorted list of unique owners on all processors
+  int num_owners;
+  char *names;
+  const char **owners;
+
+  // The values from all processors (on the root only)
+  double *values;
+};
+
+/**
+  Print a summary of the memory on all processors on the root
+
+  This call is collective on all processors in the communicator. For
+  each owner, the min/max/avg over the processors of the current
+  bytes and the max over the processors of the high-water mark are
+  printed in MB. The predicted bytes from dry-run mode are printed if
+  there are any.
+
+  @param comm The communicator
+  @param fp The file to print the summary to
+*/
+void TACSMemoryTracker::printSummary(MPI_Comm comm, FILE *fp) {
+  TacsMemoryData data(comm);
+  if (data.rank != data.root) {
+    return;
+  }
+
+  const double mb = 1.0 / (1024.0 * 1024.0);
+  double total[3];
+  data.getStats(data.num_owners, 2, total);
+  int has_predicted = (total[1] > 0.0);
+
+  fprintf(fp, "TACSMemoryTracker: %d processors (MB)\n", data.size);
+  fprintf(fp, "%-28s %10s %12s %12s %12s %12s", "Owner", "Max objs",
+          "Min current", "Avg current", "Max current", "Max peak");
+  if (has_predicted) {
+    fprintf(fp, " %12s", "Max predict");
+  }
+  fprintf(fp, "\n");
+
+  for (int i = 0; i <= data.num_owners; i++) {
+    double current[3], peak[3], predicted[3], objs[3];
+    data.getStats(i, 0, current);
+    data.getStats(i, 1, peak);
+    data.getStats(i, 3, predicted);
+    data.getStats(i, 4, objs);
+
+    if (i < data.num_owners) {
+      fprintf(fp, "%-28s %10.0f", data.owners[i], objs[1]);
+    } else {
+      fprintf(fp, "%-28s %10s", "Total", "");
+    }
+    fprintf(fp, " %12.3f %12.3f %12.3f %12.3f", mb * current[0],
+            mb * current[2], mb * current[1], mb * peak[1]);
+    if (has_predicted) {
+      fprintf(fp, " %12.3f", mb * predicted[1]);
+    }
+    fprintf(fp, "\n");
+  }
+
+  double rss[3];
+  data.getStats(data.num_owners, 4, rss);
+  fprintf(fp, "%-28s %10s %12.3f %12.3f %12.3f\n", "Process peak RSS", "",
+          mb * rss[0], mb * rss[2], mb * rss[1]);
+}
+
+/**
+  Write the memory on each processor to a JSON file on the root
+
+  This call is collective on all processors in the communicator. For
+  each owner, the current bytes, high-water mark, predicted bytes,
+  predicted high-water mark and number of objects are written for
+  every processor.
+
+  @param comm The communicator
+  @param file_name The name of the output file
+  @return Non-zero on failure
+*/
+int TACSMemoryTracker::writeJSON(MPI_Comm comm, const char *file_name) {
+  TacsMemoryData data(comm);
+
+  int fail = 0;
+  if (data.rank == data.root) {
+    FILE *fp = fopen(file_name, "w");
+    if (!fp) {
+      fprintf(stderr, "[%d] TACSMemoryTracker: Unable to open file %s\n",
+              data.rank, file_name);
+      fail = 1;
+    } else {
+      const char *value_names[] = {"current", "peak", "predicted",
+                                   "predicted_peak", "num_objects"};
+
+      fprintf(fp, "{\n  \"num_procs\": %d,\n  \"owners\": [", data.size);
+      for (int i = 0; i <= data.num_owners; i++) {
+        const char *name = "total";
+        if (i < data.num_owners) {
+          name = data.owners[i];
+        }
+        fprintf(fp, "%s\n    {\"name\": \"%s\"", (i > 0 ? "," : ""), name);
+        for (int j = 0; j < TACS_MEMORY_NUM_VALUES; j++) {
+          const char *value_name = value_names[j];
+          if (i == data.num_owners && j == 4) {
+            value_name = "process_peak";
+          }
+          fprintf(fp, ",\n     \"%s\": [", value_name);
+          for (int k = 0; k < data.size; k++) {
+            fprintf(fp, "%s%.0f", (k > 0 ? ", " : ""),
+                    data.getValue(k, i, j));
+          }
+          fprintf(fp, "]");
+        }
+        fprintf(fp, "}");
+      }
+      fprintf(fp, "\n  ]\n}\n");
+      fclose(fp);
+    }
+  }
+
+  MPI_Bcast(&fail, 1, MPI_INT, data.root, comm);
+  return fail;
+}
@@ -0,0 +1,88 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_MEMORY_TRACKER_H
+#define TACS_MEMORY_TRACKER_H
+
+#include <stdio.h>
+
+#include "mpi.h"
+
+/**
+  Registry of the memory allocated by TACS objects on this processor.
+
+  Objects record the bytes they allocate through the TACSObject
+  memory hooks. The bytes are attributed to an owner name, by default
+  the name of the object itself, and the registry keeps the current
+  number of bytes and the high-water mark for each owner as well as
+  for the total. An object can hand its bytes over to the object that
+  owns it (for instance the matrices within a preconditioner) with
+  TACSObject::setMemoryOwner().
+
+  Only the large arrays that objects explicitly record are tracked,
+  not every allocation. The high-water mark of the resident set size
+  of the process is reported as well for comparison.
+
+  In dry-run mode, the BCSRMat and TACSBlockCyclicMat objects compute
+  their non-zero pattern (including the fill-in of a factorization)
+  but skip allocating the numerical values, while still recording the
+  bytes they would require. All the bytes recorded by objects created
+  in dry-run mode are kept separately as predicted memory. This can be
+  used to size a job by creating the preconditioner in dry-run mode
+  before the numerical factorization. The preconditioners created in
+  dry-run mode cannot be factored or applied.
+*/
+class TACSMemoryTracker {
+ public:
+  // Record bytes allocated or freed (when negative) by an owner
+  // ------------------------------------------------------------
+  static void add(const char *name, double bytes, int num_objects,
+                  int predicted);
+
+  // Set/get the dry-run mode
+  // ------------------------
+  static void setDryRun(int flag);
+  static inline int isDryRun() { return dry_run; }
+
+  // Get the local memory for an owner, or the total when name is NULL
+  // -------------------------------------------------------------------
+  static double getCurrentBytes(const char *name = NULL, int predicted = 0);
+  static double getPeakBytes(const char *name = NULL, int predicted = 0);
+  static void resetPeak();
+
+  // Retrieve the local records for all the owners
+  // ---------------------------------------------
+  static int getNumOwners();
+  static const char *getOwner(int index, double *current, double *peak,
+                              double *predicted, double *predicted_peak,
+                              int *num_objects);
+
+  // Get the high-water mark of the resident set size of the process
+  // -----------------------------------------------------------------
+  static double getProcessPeakBytes();
+
+  // Aggregate and write out the results (collective on comm)
+  // ---------------------------------------------------------
+  static void printSummary(MPI_Comm comm, FILE *fp = stdout);
+  static int writeJSON(MPI_Comm comm, const char *file_name);
+
+ private:
+  static int dry_run;
+};
+
+#endif  // TACS_MEMORY_TRACKER_H
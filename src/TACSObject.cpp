@@ -18,6 +18,8 @@
 
 #include "TACSObject.h"
 
+#include "TACSMemoryTracker.h"
+
 /*
   Implementation of the reference counting TACSObject as well as
   initialization of MPI data for complex arithmetic
@@ -69,11 +71,32 @@ void TacsMPIComplexMin(void *_in, void *_out, int *count, MPI_Datatype *data) {
 }
 #endif
 
+/*
+  Merge partial KS aggregates. Each entry consists of the maximum
+  value, the sum of exp(weight*(f - max)) and the KS weight. The
+  result is stored relative to the larger of the two maximum values.
+*/
+void TacsMPIKSSum(void *_in, void *_out, int *count, MPI_Datatype *data) {
+  TacsScalar *in = (TacsScalar *)_in;
+  TacsScalar *out = (TacsScalar *)_out;
+
+  for (int i = 0; i < *count; i++, in += 3, out += 3) {
+    if (TacsRealPart(in[0]) > TacsRealPart(out[0])) {
+      out[1] = in[1] + out[1] * exp(in[2] * (out[0] - in[0]));
+      out[0] = in[0];
+    } else {
+      out[1] += in[1] * exp(in[2] * (in[0] - out[0]));
+    }
+  }
+}
+
 // Static flag to test if TacsInitialize has been called
 static int TacsInitialized = 0;
 
 MPI_Op TACS_MPI_MIN = MPI_MAX;
 MPI_Op TACS_MPI_MAX = MPI_MIN;
+MPI_Op TACS_MPI_KS_SUM = MPI_OP_NULL;
+MPI_Datatype TACS_MPI_KS_TYPE = MPI_DATATYPE_NULL;
 
 void TacsInitialize() {
   if (!TacsInitialized) {
@@ -86,6 +109,9 @@ void TacsInitialize() {
     TACS_MPI_MAX = MPI_MAX;
     TACS_MPI_MIN = MPI_MIN;
 #endif
+    MPI_Op_create(TacsMPIKSSum, 1, &TACS_MPI_KS_SUM);
+    MPI_Type_contiguous(3, TACS_MPI_TYPE, &TACS_MPI_KS_TYPE);
+    MPI_Type_commit(&TACS_MPI_KS_TYPE);
   }
   TacsInitialized++;
 }
@@ -100,12 +126,23 @@ void TacsFinalize() {
     MPI_Op_free(&TACS_MPI_MAX);
     MPI_Op_free(&TACS_MPI_MIN);
 #endif
+    MPI_Op_free(&TACS_MPI_KS_SUM);
+    MPI_Type_free(&TACS_MPI_KS_TYPE);
   }
 }
 
-TACSObject::TACSObject() { ref_count = 0; }
+TACSObject::TACSObject() {
+  ref_count = 0;
+  mem_predicted = 0;
+  mem_bytes = 0.0;
+  mem_owner = NULL;
+}
 
-TACSObject::~TACSObject() {}
+TACSObject::~TACSObject() {
+  if (mem_bytes != 0.0) {
+    TACSMemoryTracker::add(mem_owner, -mem_bytes, -1, mem_predicted);
+  }
+}
 
 /*
   Increase the reference count functions
@@ -137,6 +174,45 @@ const char *TACSObject::getObjectName() { return tacsDefault; }
 
 const char *TACSObject::tacsDefault = "TACSObject";
 
+//! Return the number of bytes recorded by this object
+double TACSObject::getMemoryUsage() { return mem_bytes; }
+
+/*
+  Set the owner of the memory recorded by this object, moving any
+  bytes that have already been recorded to the new owner
+*/
+void TACSObject::setMemoryOwner(const char *name) {
+  if (mem_bytes != 0.0) {
+    TACSMemoryTracker::add(mem_owner, -mem_bytes, -1, mem_predicted);
+    TACSMemoryTracker::add(name, mem_bytes, 1, mem_predicted);
+  }
+  mem_owner = name;
+}
+
+/*
+  Record the bytes allocated by this object. The bytes recorded by an
+  object created in dry-run mode are predicted bytes.
+*/
+void TACSObject::addMemoryUsage(double bytes) {
+  if (bytes == 0.0) {
+    return;
+  }
+  if (!mem_owner) {
+    mem_owner = this->getObjectName();
+  }
+
+  int num_objects = 0;
+  if (mem_bytes == 0.0) {
+    mem_predicted = TACSMemoryTracker::isDryRun();
+    num_objects = 1;
+  }
+  mem_bytes += bytes;
+  if (mem_bytes == 0.0) {
+    num_objects = -1;
+  }
+  TACSMemoryTracker::add(mem_owner, bytes, num_objects, mem_predicted);
+}
+
 /*
   Implementation of the TACSThreadInfo object
 */
@@ -41,6 +41,11 @@
 extern MPI_Op TACS_MPI_MIN;
 extern MPI_Op TACS_MPI_MAX;
 
+// Reduction for partial KS aggregates (max, sum, weight) - these are
+// only defined after TacsInitialize() has been called
+extern MPI_Op TACS_MPI_KS_SUM;
+extern MPI_Datatype TACS_MPI_KS_TYPE;
+
 /*
   Use the cplx type for TacsComplex
 */
@@ -134,9 +139,37 @@ class TACSObject {
   */
   virtual const char *getObjectName();
 
+  /**
+    Return the number of bytes recorded by this object
+  */
+  double getMemoryUsage();
+
+  /**
+    Attribute the memory recorded by this object to a different owner
+
+    The name must be a string literal or otherwise remain valid for
+    the lifetime of the object.
+  */
+  void setMemoryOwner(const char *name);
+
+ protected:
+  /**
+    Record the bytes allocated (or freed when negative) by this object
+
+    The bytes are attributed to the owner of the memory, by default
+    the name of the object, and are released when the object is
+    destroyed.
+  */
+  void addMemoryUsage(double bytes);
+
  private:
   int ref_count;
   static const char *tacsDefault;
+
+  // Memory recorded by this object
+  int mem_predicted;
+  double mem_bytes;
+  const char *mem_owner;
 };
 
 /**
@@ -0,0 +1,717 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSProfiler.h"
+
+/*
+  A node in the tree of scopes. Node 0 is the root of the tree and is
+  never written out.
+*/
+struct TacsProfileNode {
+  const char *name;
+  int parent;
+  int first_child;
+  int next_sibling;
+  double count;
+  double time;
+  double bytes;
+  double flops;
+};
+
+// The number of values stored for each scope when aggregating
+static const int TACS_PROFILE_NUM_VALUES = 4;
+
+// The maximum depth of nested scopes
+static const int TACS_PROFILE_MAX_DEPTH = 64;
+
+// The tree of scopes
+static int tacs_profile_num_nodes = 0;
+static int tacs_profile_max_nodes = 0;
+static TacsProfileNode *tacs_profile_nodes = NULL;
+
+// The stack of active scopes
+static int tacs_profile_depth = 0;
+static int tacs_profile_overflow = 0;
+static int tacs_profile_stack[TACS_PROFILE_MAX_DEPTH];
+static double tacs_profile_start[TACS_PROFILE_MAX_DEPTH];
+
+// The reference time and the trace events
+static double tacs_profile_t0 = 0.0;
+static int tacs_profile_max_events = 0;
+static int tacs_profile_num_events = 0;
+static int tacs_profile_dropped_events = 0;
+static int *tacs_profile_event_node = NULL;
+static double *tacs_profile_event_times = NULL;
+
+int TACSProfiler::enabled = 0;
+
+/*
+  Add a new node to the tree of scopes
+*/
+static int TacsProfileAddNode(const char *name, int parent) {
+  if (tacs_profile_num_nodes >= tacs_profile_max_nodes) {
+    int max_nodes = 2 * tacs_profile_max_nodes;
+    if (max_nodes < 64) {
+      max_nodes = 64;
+    }
+    TacsProfileNode *nodes = new TacsProfileNode[max_nodes];
+    if (tacs_profile_nodes) {
+      memcpy(nodes, tacs_profile_nodes,
+             tacs_profile_num_nodes * sizeof(TacsProfileNode));
+      delete[] tacs_profile_nodes;
+    }
+    tacs_profile_nodes = nodes;
+    tacs_profile_max_nodes = max_nodes;
+  }
+
+  int index = tacs_profile_num_nodes;
+  tacs_profile_num_nodes++;
+
+  TacsProfileNode *node = &tacs_profile_nodes[index];
+  node->name = name;
+  node->parent = parent;
+  node->first_child = -1;
+  node->next_sibling = -1;
+  node->count = 0.0;
+  node->time = 0.0;
+  node->bytes = 0.0;
+  node->flops = 0.0;
+
+  // Add the node to the end of the list of children
+  if (parent >= 0) {
+    int *ptr = &tacs_profile_nodes[parent].first_child;
+    while (*ptr >= 0) {
+      ptr = &tacs_profile_nodes[*ptr].next_sibling;
+    }
+    *ptr = index;
+  }
+
+  return index;
+}
+
+/**
+  Enable or disable the profiler
+
+  Enabling the profiler clears any data that has been recorded.
+
+  @param flag Flag indicating whether to enable the profiler
+  @param max_trace_events The maximum number of trace events to store
+*/
+void TACSProfiler::setEnabled(int flag, int max_trace_events) {
+  if (flag) {
+    if (tacs_profile_event_node) {
+      delete[] tacs_profile_event_node;
+      delete[] tacs_profile_event_times;
+      tacs_profile_event_node = NULL;
+      tacs_profile_event_times = NULL;
+    }
+    tacs_profile_max_events = 0;
+    if (max_trace_events > 0) {
+      tacs_profile_max_events = max_trace_events;
+      tacs_profile_event_node = new int[max_trace_events];
+      tacs_profile_event_times = new double[2 * max_trace_events];
+    }
+    reset();
+  }
+  enabled = flag;
+}
+
+/**
+  Clear all of the recorded data
+*/
+void TACSProfiler::reset() {
+  tacs_profile_num_nodes = 0;
+  tacs_profile_depth = 0;
+  tacs_profile_overflow = 0;
+  tacs_profile_num_events = 0;
+  tacs_profile_dropped_events = 0;
+  TacsProfileAddNode("", -1);
+  tacs_profile_t0 = MPI_Wtime();
+}
+
+/**
+  Enter a named scope
+
+  @param name The name of the scope
+*/
+void TACSProfiler::begin(const char *name) {
+  if (!enabled) {
+    return;
+  }
+  if (tacs_profile_num_nodes == 0) {
+    reset();
+  }
+  if (tacs_profile_depth >= TACS_PROFILE_MAX_DEPTH) {
+    tacs_profile_overflow++;
+    return;
+  }
+
+  // Find the scope within the children of the current scope
+  int parent = 0;
+  if (tacs_profile_depth > 0) {
+    parent = tacs_profile_stack[tacs_profile_depth - 1];
+  }
+  int index = tacs_profile_nodes[parent].first_child;
+  while (index >= 0) {
+    const char *node_name = tacs_profile_nodes[index].name;
+    if (node_name == name || strcmp(node_name, name) == 0) {
+      break;
+    }
+    index = tacs_profile_nodes[index].next_sibling;
+  }
+  if (index < 0) {
+    index = TacsProfileAddNode(name, parent);
+  }
+
+  tacs_profile_stack[tacs_profile_depth] = index;
+  tacs_profile_start[tacs_profile_depth] = MPI_Wtime();
+  tacs_profile_depth++;
+}
+
+/**
+  Leave the current scope
+*/
+void TACSProfiler::end() {
+  if (tacs_profile_overflow > 0) {
+    tacs_profile_overflow--;
+    return;
+  }
+  if (tacs_profile_depth == 0) {
+    return;
+  }
+
+  tacs_profile_depth--;
+  int index = tacs_profile_stack[tacs_profile_depth];
+  double t = tacs_profile_start[tacs_profile_depth];
+  double dt = MPI_Wtime() - t;
+
+  tacs_profile_nodes[index].count += 1.0;
+  tacs_profile_nodes[index].time += dt;
+
+  // Record the trace event
+  if (tacs_profile_num_events < tacs_profile_max_events) {
+    int k = tacs_profile_num_events;
+    tacs_profile_event_node[k] = index;
+    tacs_profile_event_times[2 * k] = t - tacs_profile_t0;
+    tacs_profile_event_times[2 * k + 1] = dt;
+    tacs_profile_num_events++;
+  } else if (tacs_profile_max_events > 0) {
+    tacs_profile_dropped_events++;
+  }
+}
+
+/*
+  Add the bytes moved and flops to the current scope
+*/
+void TACSProfiler::addCurrentCounts(double bytes, double flops) {
+  if (tacs_profile_depth > 0) {
+    int index = tacs_profile_stack[tacs_profile_depth - 1];
+    tacs_profile_nodes[index].bytes += bytes;
+    tacs_profile_nodes[index].flops += flops;
+  }
+}
+
+/*
+  Get the total time spent on this processor in all the scopes with
+  the given name, regardless of where they were called from
+*/
+double TACSProfiler::getTime(const char *name, int *count) {
+  double time = 0.0, calls = 0.0;
+  for (int i = 1; i < tacs_profile_num_nodes; i++) {
+    if (strcmp(tacs_profile_nodes[i].name, name) == 0) {
+      time += tacs_profile_nodes[i].time;
+      calls += tacs_profile_nodes[i].count;
+    }
+  }
+  if (count) {
+    *count = (int)calls;
+  }
+  return time;
+}
+
+/*
+  Write the path of the node into the string (if it is not NULL) and
+  return the length of the path
+*/
+static int TacsProfileGetPath(int index, char *path) {
+  int len = 0;
+  if (index > 0) {
+    len = TacsProfileGetPath(tacs_profile_nodes[index].parent, path);
+    if (len > 0) {
+      if (path) {
+        path[len] = '/';
+      }
+      len++;
+    }
+    int n = strlen(tacs_profile_nodes[index].name);
+    if (path) {
+      memcpy(&path[len], tacs_profile_nodes[index].name, n);
+    }
+    len += n;
+  }
+  if (path) {
+    path[len] = '\0';
+  }
+  return len;
+}
+
+/*
+  Compare two paths, ordering parents before their children
+*/
+static int TacsProfileComparePaths(const char *a, const char *b) {
+  while (*a && *a == *b) {
+    a++;
+    b++;
+  }
+  int ca = (*a == '/' ? 1 : (unsigned char)*a);
+  int cb = (*b == '/' ? 1 : (unsigned char)*b);
+  return ca - cb;
+}
+
+/*
+  The data from all processors, gathered to the root processor
+*/
+class TacsProfileData {
+ public:
+  TacsProfileData(MPI_Comm comm, int gather_events) {
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // Compute the length of the local paths
+    int nnodes = (tacs_profile_num_nodes > 0 ? tacs_profile_num_nodes - 1 : 0);
+    int path_len = 0;
+    for (int i = 1; i < tacs_profile_num_nodes; i++) {
+      path_len += TacsProfileGetPath(i, NULL) + 1;
+    }
+
+    // Create the local buffers
+    char *local_paths = new char[path_len + 1];
+    double *local_values = new double[TACS_PROFILE_NUM_VALUES * nnodes + 1];
+    for (int i = 1, offset = 0; i < tacs_profile_num_nodes; i++) {
+      offset += TacsProfileGetPath(i, &local_paths[offset]) + 1;
+      double *v = &local_values[TACS_PROFILE_NUM_VALUES * (i - 1)];
+      v[0] = tacs_profile_nodes[i].count;
+      v[1] = tacs_profile_nodes[i].time;
+      v[2] = tacs_profile_nodes[i].bytes;
+      v[3] = tacs_profile_nodes[i].flops;
+    }
+
+    int local_sizes[3] = {nnodes, path_len, 0};
+    if (gather_events) {
+      local_sizes[2] = tacs_profile_num_events;
+    }
+
+    // Gather the sizes on the root
+    int *sizes = NULL;
+    if (rank == root) {
+      sizes = new int[3 * size];
+    }
+    MPI_Gather(local_sizes, 3, MPI_INT, sizes, 3, MPI_INT, root, comm);
+
+    num_nodes = NULL;
+    node_ptr = NULL;
+    path_ptr = NULL;
+    event_ptr = NULL;
+    paths = NULL;
+    values = NULL;
+    event_node = NULL;
+    event_times = NULL;
+    int *counts = NULL, *displs = NULL;
+    if (rank == root) {
+      num_nodes = new int[size];
+      node_ptr = new int[size + 1];
+      path_ptr = new int[size + 1];
+      event_ptr = new int[size + 1];
+      counts = new int[size];
+      displs = new int[size];
+      node_ptr[0] = path_ptr[0] = event_ptr[0] = 0;
+      for (int k = 0; k < size; k++) {
+        num_nodes[k] = sizes[3 * k];
+        node_ptr[k + 1] = node_ptr[k] + sizes[3 * k];
+        path_ptr[k + 1] = path_ptr[k] + sizes[3 * k + 1];
+        event_ptr[k + 1] = event_ptr[k] + sizes[3 * k + 2];
+      }
+      paths = new char[path_ptr[size] + 1];
+      values = new double[TACS_PROFILE_NUM_VALUES * node_ptr[size] + 1];
+      event_node = new int[event_ptr[size] + 1];
+      event_times = new double[2 * event_ptr[size] + 1];
+    }
+
+    // Gather the paths
+    if (rank == root) {
+      for (int k = 0; k < size; k++) {
+        counts[k] = path_ptr[k + 1] - path_ptr[k];
+        displs[k] = path_ptr[k];
+      }
+    }
+    MPI_Gatherv(local_paths, path_len, MPI_CHAR, paths, counts, displs,
+                MPI_CHAR, root, comm);
+
+    // Gather the values
+    if (rank == root) {
+      for (int k = 0; k < size; k++) {
+        counts[k] = TACS_PROFILE_NUM_VALUES * num_nodes[k];
+        displs[k] = TACS_PROFILE_NUM_VALUES * node_ptr[k];
+      }
+    }
+    MPI_Gatherv(local_values, TACS_PROFILE_NUM_VALUES * nnodes, MPI_DOUBLE,
+                values, counts, displs, MPI_DOUBLE, root, comm);
+
+    // Gather the trace events
+    if (gather_events) {
+      if (rank == root) {
+        for (int k = 0; k < size; k++) {
+          counts[k] = event_ptr[k + 1] - event_ptr[k];
+          displs[k] = event_ptr[k];
+        }
+      }
+      MPI_Gatherv(tacs_profile_event_node, local_sizes[2], MPI_INT,
+                  event_node, counts, displs, MPI_INT, root, comm);
+      if (rank == root) {
+        for (int k = 0; k < size; k++) {
+          counts[k] *= 2;
+          displs[k] *= 2;
+        }
+      }
+      MPI_Gatherv(tacs_profile_event_times, 2 * local_sizes[2], MPI_DOUBLE,
+                  event_times, counts, displs, MPI_DOUBLE, root, comm);
+    }
+
+    delete[] local_paths;
+    delete[] local_values;
+    if (rank == root) {
+      delete[] sizes;
+      delete[] counts;
+      delete[] displs;
+      setupPaths();
+    }
+  }
+
+  ~TacsProfileData() {
+    if (rank == root) {
+      delete[] num_nodes;
+      delete[] node_ptr;
+      delete[] path_ptr;
+      delete[] event_ptr;
+      delete[] paths;
+      delete[] values;
+      delete[] event_node;
+      delete[] event_times;
+      delete[] node_paths;
+      delete[] sorted;
+      delete[] unique_ptr;
+    }
+  }
+
+  /*
+    Set pointers to the path of every node and group the nodes with
+    the same path from all processors
+  */
+  void setupPaths() {
+    int total = node_ptr[size];
+    node_paths = new const char *[total + 1];
+    for (int k = 0; k < size; k++) {
+      const char *p = &paths[path_ptr[k]];
+      for (int i = node_ptr[k]; i < node_ptr[k + 1]; i++) {
+        node_paths[i] = p;
+        p += strlen(p) + 1;
+      }
+    }
+
+    // Sort the nodes by their path
+    sorted = new int[total + 1];
+    for (int i = 0; i < total; i++) {
+      sorted[i] = i;
+    }
+    sort_paths = node_paths;
+    qsort(sorted, total, sizeof(int), compareNodes);
+    sort_paths = NULL;
+
+    // Find the groups of nodes with the same path
+    unique_ptr = new int[total + 1];
+    num_unique = 0;
+    for (int i = 0; i < total; i++) {
+      if (i == 0 || strcmp(node_paths[sorted[i]],
+                           node_paths[sorted[i - 1]]) != 0) {
+        unique_ptr[num_unique] = i;
+        num_unique++;
+      }
+    }
+    unique_ptr[num_unique] = total;
+  }
+
+  /*
+    Compute the min/max/avg of one of the values over all the
+    processors. Processors that never entered the scope contribute
+    zero.
+  */
+  void getStats(int group, int value, double stats[]) {
+    int nprocs = unique_ptr[group + 1] - unique_ptr[group];
+    double vmin = 0.0, vmax = 0.0, sum = 0.0;
+    for (int j = unique_ptr[group]; j < unique_ptr[group + 1]; j++) {
+      double v = values[TACS_PROFILE_NUM_VALUES * sorted[j] + value];
+      if (j == unique_ptr[group] || v < vmin) {
+        vmin = v;
+      }
+      if (j == unique_ptr[group] || v > vmax) {
+        vmax = v;
+      }
+      sum += v;
+    }
+    if (nprocs < size) {
+      if (vmin > 0.0) {
+        vmin = 0.0;
+      }
+      if (vmax < 0.0) {
+        vmax = 0.0;
+      }
+    }
+    stats[0] = vmin;
+    stats[1] = vmax;
+    stats[2] = sum / size;
+  }
+
+  const char *getPath(int group) {
+    return node_paths[sorted[unique_ptr[group]]];
+  }
+
+  // Get the path for the local node index on the given processor
+  const char *getNodePath(int proc, int index) {
+    return node_paths[node_ptr[proc] + index - 1];
+  }
+
+  static const int root = 0;
+  int rank, size;
+
+  // Data about the nodes from each processor
+  int *num_nodes, *node_ptr, *path_ptr;
+  char *paths;
+  double *values;
+  const char **node_paths;
+
+  // The trace events from each processor
+  int *event_ptr, *event_node;
+  double *event_times;
+
+  // The groups of nodes with the same path
+  int num_unique;
+  int *sorted, *unique_ptr;
+
+ private:
+  static int compareNodes(const void *a, const void *b) {
+    const char *pa = sort_paths[*(const int *)a];
+    const char *pb = sort_paths[*(const int *)b];
+    int c = TacsProfileComparePaths(pa, pb);
+    if (c == 0) {
+      return *(const int *)a - *(const int *)b;
+    }
+    return c;
+  }
+
+  static const char **sort_paths;
+};
+
+const char **TacsProfileData::sort_paths = NULL;
+
+/*
+  Get the depth of the path and a pointer to the name of the scope
+*/
+static int TacsProfileGetDepth(const char *path, const char **name) {
+  int depth = 0;
+  *name = path;
+  for (const char *p = path; *p; p++) {
+    if (*p == '/') {
+      depth++;
+      *name = p + 1;
+    }
+  }
+  return depth;
+}
+
+/*
+  Write a string to the file, escaping the characters required by JSON
+*/
+static void TacsProfileWriteString(FILE *fp, const char *str) {
+  fprintf(fp, "\"");
+  for (const char *p = str; *p; p++) {
+    if (*p == '"' || *p == '\\') {
+      fprintf(fp, "\\%c", *p);
+    } else if ((unsigned char)*p < 0x20) {
+      fprintf(fp, "\\u%04x", (unsigned char)*p);
+    } else {
+      fputc(*p, fp);
+    }
+  }
+  fprintf(fp, "\"");
+}
+
+/**
+  Print a summary of the aggregated results on the root processor
+
+  This call is collective on all processors in the communicator.
+
+  @param comm The communicator
+  @param fp The file to print the summary to
+*/
+void TACSProfiler::printSummary(MPI_Comm comm, FILE *fp) {
+  TacsProfileData data(comm, 0);
+  if (data.rank != data.root) {
+    return;
+  }
+
+  fprintf(fp, "TACSProfiler: %d processors\n", data.size);
+  fprintf(fp, "%-48s %10s %12s %12s %12s %8s\n", "Scope", "Max calls",
+          "Min time", "Avg time", "Max time", "Max/Avg");
+  for (int i = 0; i < data.num_unique; i++) {
+    const char *name;
+    int depth = TacsProfileGetDepth(data.getPath(i), &name);
+
+    double count[3], time[3];
+    data.getStats(i, 0, count);
+    data.getStats(i, 1, time);
+    double imbalance = (time[2] > 0.0 ? time[1] / time[2] : 1.0);
+
+    char label[49];
+    int indent = 2 * depth;
+    if (indent > 24) {
+      indent = 24;
+    }
+    snprintf(label, sizeof(label), "%*s%s", indent, "", name);
+    fprintf(fp, "%-48s %10.0f %12.5e %12.5e %12.5e %8.3f\n", label, count[1],
+            time[0], time[2], time[1], imbalance);
+  }
+}
+
+/**
+  Write the aggregated results to a JSON file on the root processor
+
+  This call is collective on all processors in the communicator. For
+  each scope, the min/max/avg of the call count, time, bytes and flops
+  over all processors are written.
+
+  @param comm The communicator
+  @param file_name The name of the output file
+  @return Non-zero on failure
+*/
+int TACSProfiler::writeJSON(MPI_Comm comm, const char *file_name) {
+  TacsProfileData data(comm, 0);
+
+  int fail = 0;
+  if (data.rank == data.root) {
+    FILE *fp = fopen(file_name, "w");
+    if (!fp) {
+      fprintf(stderr, "[%d] TACSProfiler: Unable to open file %s\n",
+              data.rank, file_name);
+      fail = 1;
+    } else {
+      const char *value_names[] = {"count", "time", "bytes", "flops"};
+
+      fprintf(fp, "{\n  \"num_procs\": %d,\n  \"scopes\": [", data.size);
+      for (int i = 0; i < data.num_unique; i++) {
+        const char *path = data.getPath(i);
+        const char *name;
+        int depth = TacsProfileGetDepth(path, &name);
+
+        fprintf(fp, "%s\n    {\"path\": ", (i > 0 ? "," : ""));
+        TacsProfileWriteString(fp, path);
+        fprintf(fp, ", \"name\": ");
+        TacsProfileWriteString(fp, name);
+        fprintf(fp, ", \"depth\": %d", depth);
+        for (int j = 0; j < TACS_PROFILE_NUM_VALUES; j++) {
+          double stats[3];
+          data.getStats(i, j, stats);
+          fprintf(fp,
+                  ",\n     \"%s\": {\"min\": %.9e, \"max\": %.9e, "
+                  "\"avg\": %.9e}",
+                  value_names[j], stats[0], stats[1], stats[2]);
+        }
+        fprintf(fp, "}");
+      }
+      fprintf(fp, "\n  ]\n}\n");
+      fclose(fp);
+    }
+  }
+
+  MPI_Bcast(&fail, 1, MPI_INT, data.root, comm);
+  return fail;
+}
+
+/**
+  Write the recorded scope events to a file in the Chrome trace event
+  format on the root processor
+
+  This call is collective on all processors in the communicator. The
+  events are only recorded when the profiler is enabled with a
+  non-zero number of trace events. Each processor is written as a
+  separate process in the trace.
+
+  @param comm The communicator
+  @param file_name The name of the output file
+  @return Non-zero on failure
+*/
+int TACSProfiler::writeChromeTrace(MPI_Comm comm, const char *file_name) {
+  TacsProfileData data(comm, 1);
+
+  int dropped = tacs_profile_dropped_events;
+  int total_dropped = 0;
+  MPI_Reduce(&dropped, &total_dropped, 1, MPI_INT, MPI_SUM, data.root, comm);
+
+  int fail = 0;
+  if (data.rank == data.root) {
+    FILE *fp = fopen(file_name, "w");
+    if (!fp) {
+      fprintf(stderr, "[%d] TACSProfiler: Unable to open file %s\n",
+              data.rank, file_name);
+      fail = 1;
+    } else {
+      if (total_dropped > 0) {
+        fprintf(stderr,
+                "TACSProfiler: %d trace events were dropped, increase "
+                "max_trace_events\n",
+                total_dropped);
+      }
+
+      fprintf(fp, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+      int first = 1;
+      for (int k = 0; k < data.size; k++) {
+        for (int j = data.event_ptr[k]; j < data.event_ptr[k + 1]; j++) {
+          const char *path = data.getNodePath(k, data.event_node[j]);
+          const char *name;
+          TacsProfileGetDepth(path, &name);
+
+          fprintf(fp, "%s\n{\"name\": ", (first ? "" : ","));
+          TacsProfileWriteString(fp, name);
+          fprintf(fp,
+                  ", \"cat\": \"tacs\", \"ph\": \"X\", \"pid\": %d, "
+                  "\"tid\": 0, \"ts\": %.3f, \"dur\": %.3f, "
+                  "\"args\": {\"path\": ",
+                  k, 1e6 * data.event_times[2 * j],
+                  1e6 * data.event_times[2 * j + 1]);
+          TacsProfileWriteString(fp, path);
+          fprintf(fp, "}}");
+          first = 0;
+        }
+      }
+      fprintf(fp, "\n]}\n");
+      fclose(fp);
+    }
+  }
+
+  MPI_Bcast(&fail, 1, MPI_INT, data.root, comm);
+  return fail;
+}
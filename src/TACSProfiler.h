@@ -0,0 +1,108 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_PROFILER_H
+#define TACS_PROFILER_H
+
+#include "TACSObject.h"
+
+/**
+  Lightweight profiling registry with named, nested scopes.
+
+  Each scope records the number of calls, the wall time and optional
+  estimates of the bytes moved and floating point operations. Scopes
+  are identified by their name and their parent scope, so the same
+  name called from different places is recorded separately.
+
+  The registry is disabled by default. When it is disabled, entering
+  and leaving a scope costs a single branch. The registry is not
+  thread-safe and scopes should only be entered from the main thread.
+
+  Scope names must be string literals or otherwise remain valid until
+  the registry is reset.
+
+  The results on each processor can be aggregated (min/max/avg over
+  the processors) and written as JSON, or the individual scope events
+  can be written in the Chrome trace event format for viewing in a
+  trace viewer.
+*/
+class TACSProfiler {
+ public:
+  // Enable/disable the profiler
+  // ---------------------------
+  static void setEnabled(int flag, int max_trace_events = 0);
+  static inline int isEnabled() { return enabled; }
+  static void reset();
+
+  // Enter and leave scopes
+  // ----------------------
+  static void begin(const char *name);
+  static void end();
+
+  // Get the local time and number of calls for scopes with this name
+  // -----------------------------------------------------------------
+  static double getTime(const char *name, int *count = NULL);
+
+  // Add counts to the current scope
+  // -------------------------------
+  static inline void addCounts(double bytes, double flops) {
+    if (enabled) {
+      addCurrentCounts(bytes, flops);
+    }
+  }
+
+  // Aggregate and write out the results (collective on comm)
+  // ---------------------------------------------------------
+  static void printSummary(MPI_Comm comm, FILE *fp = stdout);
+  static int writeJSON(MPI_Comm comm, const char *file_name);
+  static int writeChromeTrace(MPI_Comm comm, const char *file_name);
+
+ private:
+  static void addCurrentCounts(double bytes, double flops);
+
+  static int enabled;
+};
+
+/**
+  Scope guard that records the time between its construction and
+  destruction under the given name.
+*/
+class TACSProfileScope {
+ public:
+  TACSProfileScope(const char *name) {
+    active = TACSProfiler::isEnabled();
+    if (active) {
+      TACSProfiler::begin(name);
+    }
+  }
+  ~TACSProfileScope() {
+    if (active) {
+      TACSProfiler::end();
+    }
+  }
+
+ private:
+  int active;
+};
+
+#define TACS_PROFILE_CONCAT_(a, b) a##b
+#define TACS_PROFILE_CONCAT(a, b) TACS_PROFILE_CONCAT_(a, b)
+#define TACS_PROFILE_SCOPE(name) \
+  TACSProfileScope TACS_PROFILE_CONCAT(_tacs_profile_scope_, __LINE__)(name)
+
+#endif  // TACS_PROFILER_H
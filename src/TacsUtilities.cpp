@@ -968,6 +968,48 @@ void TACSMatrixHash::reset(int new_table_size) {
   table_size = new_table_size;
 }
 
+const char *TACSArena::arenaName = "TACSArena";
+
+/*
+  Allocate the block of memory for the arena
+*/
+TACSArena::TACSArena(size_t _size) {
+  size = getAlignedSize(_size);
+  offset = 0;
+  peak = 0;
+
+  // Over-allocate so that the start of the arena is aligned
+  base = new char[size + TACS_ARENA_ALIGNMENT];
+  uintptr_t addr = (uintptr_t)base;
+  data = base + (TACS_ARENA_ALIGNMENT - addr % TACS_ARENA_ALIGNMENT) %
+                    TACS_ARENA_ALIGNMENT;
+
+  addMemoryUsage(size + TACS_ARENA_ALIGNMENT);
+}
+
+TACSArena::~TACSArena() { delete[] base; }
+
+/*
+  Allocate an aligned array from the arena
+*/
+void *TACSArena::allocate(size_t bytes) {
+  size_t len = getAlignedSize(bytes);
+  if (offset + len > size) {
+    fprintf(stderr,
+            "TACSArena error: Cannot allocate %zu bytes, %zu of %zu bytes "
+            "in use\n",
+            bytes, offset, size);
+    return NULL;
+  }
+
+  void *ptr = &data[offset];
+  offset += len;
+  if (offset > peak) {
+    peak = offset;
+  }
+  return ptr;
+}
+
 TacsScalar ksAggregation(const TacsScalar f[], const int numVals,
                          const double ksWeight) {
   TacsScalar maxVal = f[0];
@@ -220,6 +220,64 @@ class TACSMatrixHash : public TACSObject {
   MemNode *mem_root, *mem;
 };
 
+/*
+  Bump allocator for temporary arrays used within computational
+  kernels.
+
+  The arena allocates a single block of memory once. Arrays are
+  handed out by advancing an offset into the block, with each array
+  aligned to a cache line, and are released all at once with reset()
+  or back to a mark obtained with getMark(). This avoids calls to
+  new/delete within the kernels. An arena is not thread-safe: each
+  thread must use its own arena.
+*/
+class TACSArena : public TACSObject {
+ public:
+  static const int TACS_ARENA_ALIGNMENT = 64;
+
+  TACSArena(size_t _size);
+  ~TACSArena();
+
+  /*
+    Allocate an array from the arena, NULL if there is not enough space
+  */
+  void *allocate(size_t bytes);
+  TacsScalar *allocateScalars(int n) {
+    return (TacsScalar *)allocate(n * sizeof(TacsScalar));
+  }
+  int *allocateInts(int n) { return (int *)allocate(n * sizeof(int)); }
+
+  /*
+    Release all the arrays, or the arrays allocated after a mark
+  */
+  void reset() { offset = 0; }
+  size_t getMark() { return offset; }
+  void release(size_t mark) { offset = mark; }
+
+  /*
+    Get the size of the arena and the largest offset used
+  */
+  size_t getSize() { return size; }
+  size_t getPeak() { return peak; }
+
+  /*
+    The space an array uses within an arena including the alignment
+  */
+  static size_t getAlignedSize(size_t bytes) {
+    return TACS_ARENA_ALIGNMENT *
+           ((bytes + TACS_ARENA_ALIGNMENT - 1) / TACS_ARENA_ALIGNMENT);
+  }
+
+  const char *getObjectName() { return arenaName; }
+
+ private:
+  char *base;  // The allocated block
+  char *data;  // The aligned start of the arena
+  size_t size, offset, peak;
+
+  static const char *arenaName;
+};
+
 /**
  * @brief Compute the KS aggregate of a set of values
  *
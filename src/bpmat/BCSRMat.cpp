@@ -21,6 +21,8 @@
 #include <stdio.h>
 
 #include "BCSRMatImpl.h"
+#include "TACSMemoryTracker.h"
+#include "TACSProfiler.h"
 #include "TacsUtilities.h"
 #include "tacslapack.h"
 
@@ -155,13 +157,7 @@ BCSRMat::BCSRMat(MPI_Comm _comm, BCSRMat *mat, int levFill, double fill,
 
   int *levs;
   computeILUk(mat, levFill, fill, &levs);
-
-  int length = data->rowp[data->nrows];
-  int bsize = data->bsize;
-  length *= bsize * bsize;
-
-  data->A = new TacsScalar[length];
-  memset(data->A, 0, length * sizeof(TacsScalar));
+  allocateValues();
 
   // Go through and print out the nz-pattern of the matrix
   if (fname) {
@@ -229,11 +225,9 @@ BCSRMat::BCSRMat(MPI_Comm _comm, TACSThreadInfo *_thread_info, int bsize,
   if (_A) {
     data->A = *_A;
     *_A = NULL;
+    updateMemoryUsage();
   } else {
-    // Find the size of the array
-    int length = bsize * bsize * data->rowp[nrows];
-    data->A = new TacsScalar[length];
-    memset(data->A, 0, length * sizeof(TacsScalar));
+    allocateValues();
   }
 }
 
@@ -296,11 +290,7 @@ BCSRMat::BCSRMat(MPI_Comm _comm, BCSRMat *Bmat, BCSRMat *Emat, BCSRMat *Fmat,
 
   delete[] levs;
 
-  int bsize = data->bsize;
-  int length = data->rowp[data->nrows];
-  length *= bsize * bsize;
-  data->A = new TacsScalar[length];
-  memset(data->A, 0, length * sizeof(TacsScalar));
+  allocateValues();
 }
 
 /*!
@@ -446,12 +436,7 @@ BCSRMat::BCSRMat(MPI_Comm _comm, BCSRMat *smat, int *alevs, BCSRMat *amat,
   data->rowp = rowp;
   data->cols = cols;
 
-  int bsize = data->bsize;
-  int length = rowp[nrows];
-  length *= bsize * bsize;
-
-  data->A = new TacsScalar[length];
-  memset(data->A, 0, length * sizeof(TacsScalar));
+  allocateValues();
 }
 
 /*
@@ -576,12 +561,56 @@ BCSRMat::BCSRMat(MPI_Comm _comm, BCSRMat *B, double fill) {
   data->rowp = rowp;
   data->cols = cols;
 
+  allocateValues();
+}
+
+/*
+  Allocate and zero the values for the non-zero pattern of the matrix
+  and record the memory used by the matrix. In dry-run mode, only the
+  memory that would be required is recorded.
+*/
+void BCSRMat::allocateValues() {
   int bsize = data->bsize;
-  int length = rowp[nrows];
-  length *= bsize * bsize;
+  int length = bsize * bsize * data->rowp[data->nrows];
+  if (!TACSMemoryTracker::isDryRun()) {
+    data->A = new TacsScalar[length];
+    memset(data->A, 0, length * sizeof(TacsScalar));
+  }
+  updateMemoryUsage();
+}
 
-  data->A = new TacsScalar[length];
-  memset(data->A, 0, length * sizeof(TacsScalar));
+/*
+  Record any change in the memory used by the matrix
+*/
+void BCSRMat::updateMemoryUsage() {
+  int nrows = data->nrows;
+  int nnz = data->rowp[nrows];
+  int b2 = data->bsize * data->bsize;
+  double bytes = (nrows + 1 + nnz) * sizeof(int);
+  bytes += 1.0 * b2 * nnz * sizeof(TacsScalar);
+  if (data->diag) {
+    bytes += nrows * sizeof(int);
+  }
+  if (Adiag) {
+    bytes += 1.0 * b2 * nrows * sizeof(TacsScalar);
+  }
+  addMemoryUsage(bytes - getMemoryUsage());
+}
+
+/*
+  Check that the values of the matrix have been allocated. The values
+  are not allocated when the matrix is created in dry-run mode, so the
+  numerical operations print an error and return.
+*/
+int BCSRMat::checkValues(const char *name) {
+  if (!data->A) {
+    fprintf(stderr,
+            "BCSRMat %s error: Cannot use a matrix created in dry-run "
+            "mode\n",
+            name);
+    return 0;
+  }
+  return 1;
 }
 
 BCSRMat::~BCSRMat() {
@@ -616,6 +645,10 @@ MPI_Comm BCSRMat::getMPIComm() { return comm; }
 
 TACSThreadInfo *BCSRMat::getThreadInfo() { return thread_info; }
 
+const char *BCSRMat::getObjectName() { return matName; }
+
+const char *BCSRMat::matName = "BCSRMat";
+
 /*!
   Compute the ILU(levFill) preconditioner
 
@@ -974,6 +1007,7 @@ BCSRMat *BCSRMat::computeILUkFpc(BCSRMat *Fmat, const int *levs, int levFill,
 void BCSRMat::setUpDiag() {
   if (!data->diag) {
     data->diag = new int[data->nrows];
+    updateMemoryUsage();
   }
 
   for (int i = 0; i < data->nrows; i++) {
@@ -1187,9 +1221,15 @@ void BCSRMat::initBlockImpl() {
   performed in place.
 */
 void BCSRMat::factor() {
+  if (!checkValues("factor")) {
+    return;
+  }
   if (!data->diag) {
     setUpDiag();
   }
+  if (TACSProfiler::isEnabled()) {
+    TACSProfiler::addCounts(0.0, getFactorFlops());
+  }
 
   if (bfactor_thread && thread_info->getNumThreads() > 1) {
     // If not allocated, allocate the threaded data
@@ -1220,10 +1260,58 @@ void BCSRMat::factor() {
   }
 }
 
+/*!
+  Count the floating point operations in the numerical factorization
+  with the current non-zero pattern.
+
+  Each block of L is multiplied by the inverse of a diagonal block, and
+  each block of U in the rows used for elimination updates the matching
+  block in the row, at a cost of 2*b^3 each. The diagonal blocks are
+  inverted at a cost of about 4/3*b^3. The products, and the
+  application of the factorization, cost 2*b^2 for each block.
+*/
+double BCSRMat::getFactorFlops() {
+  if (!data->diag) {
+    setUpDiag();
+  }
+
+  const int nrows = data->nrows;
+  const int *rowp = data->rowp;
+  const int *cols = data->cols;
+  const int *diag = data->diag;
+
+  double nupdates = 0.0;
+  for (int i = 0; i < nrows; i++) {
+    int end = rowp[i + 1];
+    for (int jp = rowp[i]; jp < diag[i]; jp++) {
+      int j = cols[jp];
+      nupdates += 1.0;
+
+      // Match the upper part of row j with the remainder of row i
+      int kp = jp + 1;
+      for (int p = diag[j] + 1; p < rowp[j + 1]; p++) {
+        while (kp < end && cols[kp] < cols[p]) {
+          kp++;
+        }
+        if (kp < end && cols[kp] == cols[p]) {
+          nupdates += 1.0;
+        }
+      }
+    }
+  }
+
+  double b3 = 1.0 * data->bsize * data->bsize * data->bsize;
+  return 2.0 * b3 * nupdates + 1.333333 * b3 * nrows;
+}
+
 /*!
   Compute y = A*x
 */
 void BCSRMat::mult(TacsScalar *xvec, TacsScalar *yvec) {
+  if (!checkValues("mult")) {
+    return;
+  }
+  TACSProfiler::addCounts(0.0, getMultFlops());
   if (bmultadd_thread && thread_info->getNumThreads() > 1) {
     // If not allocated, allocate the threaded data
     if (!tdata) {
@@ -1262,6 +1350,10 @@ void BCSRMat::mult(TacsScalar *xvec, TacsScalar *yvec) {
   Compute y = A*x + z
 */
 void BCSRMat::multAdd(TacsScalar *xvec, TacsScalar *zvec, TacsScalar *yvec) {
+  if (!checkValues("multAdd")) {
+    return;
+  }
+  TACSProfiler::addCounts(0.0, getMultFlops());
   if (bmultadd_thread && thread_info->getNumThreads() > 1) {
     // If not allocated, allocate the threaded data
     if (!tdata) {
@@ -1304,6 +1396,10 @@ void BCSRMat::multAdd(TacsScalar *xvec, TacsScalar *zvec, TacsScalar *yvec) {
   Compute y = A^{T}*x
 */
 void BCSRMat::multTranspose(TacsScalar *xvec, TacsScalar *yvec) {
+  if (!checkValues("multTranspose")) {
+    return;
+  }
+  TACSProfiler::addCounts(0.0, getMultFlops());
   memset(yvec, 0, data->bsize * data->ncols * sizeof(TacsScalar));
   bmulttrans(data, xvec, yvec);
 }
@@ -1313,6 +1409,10 @@ void BCSRMat::multTranspose(TacsScalar *xvec, TacsScalar *yvec) {
 */
 void BCSRMat::multTransposeAdd(TacsScalar *inVec, TacsScalar *addVec,
                                TacsScalar *outVec) {
+  if (!checkValues("multTransposeAdd")) {
+    return;
+  }
+  TACSProfiler::addCounts(0.0, getMultFlops());
   bmulttransadd(data, inVec, addVec, outVec);
 }
 
@@ -1324,6 +1424,10 @@ void BCSRMat::multTransposeAdd(TacsScalar *inVec, TacsScalar *addVec,
   y = U^{-1} L^{-1} x
 */
 void BCSRMat::applyFactor(TacsScalar *xvec, TacsScalar *yvec) {
+  if (!checkValues("applyFactor")) {
+    return;
+  }
+  TACSProfiler::addCounts(0.0, getMultFlops());
   if (!data->diag) {
     fprintf(stderr, "BCSRMat applyFactor error: matrix not factored\n");
   } else {
@@ -1388,6 +1492,10 @@ void BCSRMat::applyFactor(TacsScalar *xvec, TacsScalar *yvec) {
   x = U^{-1} L^{-1} x
 */
 void BCSRMat::applyFactor(TacsScalar *xvec) {
+  if (!checkValues("applyFactor")) {
+    return;
+  }
+  TACSProfiler::addCounts(0.0, getMultFlops());
   if (!data->diag) {
     fprintf(stderr, "BCSRMat applyFactor error: matrix not factored\n");
   } else {
@@ -1525,6 +1633,9 @@ void BCSRMat::applyFactorSchur(TacsScalar *x, int var_offset) {
   these matrices and store the result.
 */
 void BCSRMat::factorDiag(const TacsScalar *diag) {
+  if (!checkValues("factorDiag")) {
+    return;
+  }
   if (!data->diag) {
     setUpDiag();
   }
@@ -1538,6 +1649,7 @@ void BCSRMat::factorDiag(const TacsScalar *diag) {
 
   if (!Adiag) {
     Adiag = new TacsScalar[nrows * b2];
+    updateMemoryUsage();
   }
 
   for (int i = 0; i < nrows; i++) {
@@ -1560,6 +1672,9 @@ void BCSRMat::factorDiag(const TacsScalar *diag) {
 */
 void BCSRMat::applySOR(TacsScalar *b, TacsScalar *x, TacsScalar omega,
                        int iters) {
+  if (!checkValues("applySOR")) {
+    return;
+  }
   if (Adiag) {
     for (int i = 0; i < iters; i++) {
       applysor(data, NULL, 0, data->nrows, 0, Adiag, omega, b, NULL, x);
@@ -1575,6 +1690,9 @@ void BCSRMat::applySOR(TacsScalar *b, TacsScalar *x, TacsScalar omega,
 void BCSRMat::applySOR(BCSRMat *B, int start, int end, int var_offset,
                        TacsScalar omega, const TacsScalar *b,
                        const TacsScalar *xext, TacsScalar *x) {
+  if (!checkValues("applySOR")) {
+    return;
+  }
   if (Adiag) {
     if (B) {
       applysor(data, B->data, start, end, var_offset, Adiag, omega, b, xext, x);
@@ -1593,6 +1711,9 @@ void BCSRMat::applySOR(BCSRMat *B, int start, int end, int var_offset,
   matrix to have the correct non-zero pattern.
 */
 void BCSRMat::matMultAdd(double alpha, BCSRMat *amat, BCSRMat *bmat) {
+  if (!checkValues("matMultAdd")) {
+    return;
+  }
   // Check that the sizes work
   if (data->bsize != amat->data->bsize || data->bsize != bmat->data->bsize) {
     fprintf(stderr,
@@ -1765,6 +1886,9 @@ void BCSRMat::matMultNormal(TacsScalar *s, BCSRMat *bmat) {
   Zero all entries of the matrix
 */
 void BCSRMat::zeroEntries() {
+  if (!checkValues("zeroEntries")) {
+    return;
+  }
   int bsize = data->bsize;
   int length = data->rowp[data->nrows];
   length *= bsize * bsize;
@@ -1776,6 +1900,9 @@ void BCSRMat::zeroEntries() {
   Scale all the entries in the matrix by a factor
 */
 void BCSRMat::scale(TacsScalar alpha) {
+  if (!checkValues("scale")) {
+    return;
+  }
   const int bsize = data->bsize;
   int length = data->rowp[data->nrows];
   length *= bsize * bsize;
@@ -1799,6 +1926,9 @@ void BCSRMat::scale(TacsScalar alpha) {
 */
 void BCSRMat::addRowValues(int row, int ncol, const int *col, int nca,
                            const TacsScalar *avals) {
+  if (!checkValues("addRowValues")) {
+    return;
+  }
   if (ncol <= 0) {
     return;
   }
@@ -1881,6 +2011,9 @@ void BCSRMat::addRowWeightValues(TacsScalar alpha, int row, int nwrows,
                                  const TacsScalar *weights, int nca,
                                  const TacsScalar *avals,
                                  MatrixOrientation matOr) {
+  if (!checkValues("addRowWeightValues")) {
+    return;
+  }
   if (nwrows <= 0 || alpha == 0.0) {
     return;
   }
@@ -1971,6 +2104,9 @@ void BCSRMat::addRowWeightValues(TacsScalar alpha, int row, int nwrows,
 */
 void BCSRMat::addBlockRowValues(int row, int ncol, const int *col,
                                 const TacsScalar *avals) {
+  if (!checkValues("addBlockRowValues")) {
+    return;
+  }
   if (ncol <= 0) {
     return;
   }
@@ -2025,6 +2161,9 @@ void BCSRMat::addBlockRowValues(int row, int ncol, const int *col,
   ident:    flag to indicate whether to set the diagonal to 1
 */
 void BCSRMat::zeroRow(int row, int vars, int ident) {
+  if (!checkValues("zeroRow")) {
+    return;
+  }
   if (row >= 0 && row < data->nrows) {
     const int *rowp = data->rowp;
     const int *cols = data->cols;
@@ -2057,6 +2196,9 @@ void BCSRMat::zeroRow(int row, int vars, int ident) {
 */
 void BCSRMat::zeroColumns(int num_zero_cols, const int *zero_cols,
                           const int *zero_vars, int ident) {
+  if (!checkValues("zeroColumns")) {
+    return;
+  }
   const int ncols = data->ncols;
   const int nrows = data->nrows;
   const int *rowp = data->rowp;
@@ -2358,6 +2500,9 @@ void BCSRMat::getArrays(int *_bsize, int *_nrows, int *_ncols,
   Get the matrix in a dense column-major format appropriate for LAPACK
 */
 void BCSRMat::getDenseColumnMajor(TacsScalar *D) {
+  if (!checkValues("getDenseColumnMajor")) {
+    return;
+  }
   const int bsize = data->bsize;
   const int nrows = data->nrows;
   const int *rowp = data->rowp;
@@ -2395,6 +2540,9 @@ void BCSRMat::getDenseColumnMajor(TacsScalar *D) {
   Scan through each row of the matrix, copying entries.
 */
 void BCSRMat::copyValues(BCSRMat *mat) {
+  if (!checkValues("copyValues")) {
+    return;
+  }
   if (mat->data->nrows != data->nrows || mat->data->ncols != data->ncols ||
       data->bsize != mat->data->bsize) {
     fprintf(stderr,
@@ -2450,6 +2598,9 @@ void BCSRMat::copyValues(BCSRMat *mat) {
 */
 
 void BCSRMat::axpy(TacsScalar alpha, BCSRMat *mat) {
+  if (!checkValues("axpy")) {
+    return;
+  }
   if (mat->data->nrows != data->nrows || mat->data->ncols != data->ncols ||
       mat->data->bsize != data->bsize) {
     fprintf(stderr,
@@ -2507,6 +2658,9 @@ void BCSRMat::axpy(TacsScalar alpha, BCSRMat *mat) {
   patterns are static.
 */
 void BCSRMat::axpby(TacsScalar alpha, TacsScalar beta, BCSRMat *mat) {
+  if (!checkValues("axpby")) {
+    return;
+  }
   if (mat->data->nrows != data->nrows || mat->data->ncols != data->ncols) {
     fprintf(stderr,
             "BCSRMat: Matrices are not the same "
@@ -2557,6 +2711,9 @@ void BCSRMat::axpby(TacsScalar alpha, TacsScalar beta, BCSRMat *mat) {
   Add a value to the diagonal entries of the matrix
 */
 void BCSRMat::addDiag(TacsScalar alpha) {
+  if (!checkValues("addDiag")) {
+    return;
+  }
   if (data->diag) {
     const int bsize = data->bsize;
     const int b2 = bsize * bsize;
@@ -2587,6 +2744,9 @@ void BCSRMat::addDiag(TacsScalar alpha) {
   Add an array of values to the diagonal entries of the matrix
 */
 void BCSRMat::addDiag(TacsScalar *alpha) {
+  if (!checkValues("addDiag")) {
+    return;
+  }
   if (data->diag) {
     const int bsize = data->bsize;
     const int b2 = bsize * bsize;
@@ -2666,6 +2826,9 @@ void BCSRMat::getNumUpperLowerDiagonals(int *_bl, int *_bu) {
   returns: the matrix band size
 */
 void BCSRMat::getBandedMatrix(TacsScalar *A, int size, int symm_flag) {
+  if (!checkValues("getBandedMatrix")) {
+    return;
+  }
   // Compute the matrix bandwidth
   int bl, bu;
   getNumUpperLowerDiagonals(&bl, &bu);
@@ -119,6 +119,13 @@ class BCSRMat : public TACSObject {
   // ------------------------------------------------------------
   void matMultNormal(TacsScalar *s, BCSRMat *bmat);
 
+  // Count the floating point operations in the numerical kernels
+  // -------------------------------------------------------------
+  double getFactorFlops();
+  double getMultFlops() {
+    return 2.0 * data->bsize * data->bsize * data->rowp[data->nrows];
+  }
+
   // Get the matrix dimensions
   // -------------------------
   int getBlockSize() { return data->bsize; }
@@ -146,8 +153,13 @@ class BCSRMat : public TACSObject {
   void initGenericImpl();
   void initBlockImpl();
 
+  const char *getObjectName();
+
  private:
   void setUpDiag();  // Set up the diagonal entry pointer 'diag'
+  void allocateValues();  // Allocate the values for the non-zero pattern
+  void updateMemoryUsage();  // Record the memory used by the matrix
+  int checkValues(const char *name);  // Check the values are allocated
   void computeILUk(BCSRMat *mat, int levFill, double fill, int **_levs);
   BCSRMat *computeILUkEpc(BCSRMat *EMat, const int *levs, int levFill,
                           double fill, int **_elevs);
@@ -203,6 +215,8 @@ class BCSRMat : public TACSObject {
   TacsScalar *Adiag;
   int npairs;
   int *pairs;
+
+  static const char *matName;
 };
 
 #endif  // TACS_BCSR_MATRIX_H
@@ -21,6 +21,8 @@
 #include <math.h>
 #include <stdio.h>
 
+#include "TACSProfiler.h"
+
 /*
   Implementation of various Krylov-subspace methods
 */
@@ -437,6 +439,7 @@ void PCG::setMonitor(KSMPrint *_monitor) {
   solve_flag: flag for the whether the solve terminated successfully
 */
 int PCG::solve(TACSVec *b, TACSVec *x, int zero_guess) {
+  TACS_PROFILE_SCOPE("PCG::solve");
   int solve_flag = 0;
   iterCount = 0;
   TacsScalar rhs_norm = 0.0;
@@ -783,6 +786,7 @@ const char *GMRES::gmresName = "GMRES";
   solve_flag: flag for the whether the solve terminated successfully
 */
 int GMRES::solve(TACSVec *b, TACSVec *x, int zero_guess) {
+  TACS_PROFILE_SCOPE("GMRES::solve");
   TacsScalar rhs_norm = 0.0;
   int solve_flag = 0;
   iterCount = 0;
@@ -829,6 +833,7 @@ int GMRES::solve(TACSVec *b, TACSVec *x, int zero_guess) {
     }
 
     for (int i = 0; i < msub; i++) {
+      TACS_PROFILE_SCOPE("GMRES::iteration");
       if (monitor_time) {
         t_pc -= MPI_Wtime();
       }
@@ -1194,6 +1199,7 @@ const char *GCROT::gcrotName = "GCROT";
   solve_flag: flag for the whether the solve terminated successfully
 */
 int GCROT::solve(TACSVec *b, TACSVec *x, int zero_guess) {
+  TACS_PROFILE_SCOPE("GCROT::solve");
   TacsScalar rhs_norm = 0.0;
   int solve_flag = 0;
   int mat_iters = 0;
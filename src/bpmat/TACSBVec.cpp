@@ -126,6 +126,8 @@ TACSBVec::TACSBVec(TACSNodeMap *map, int _bsize, TACSBVecDistribute *_ext_dist,
     dep_size = 0;
     x_dep = NULL;
   }
+
+  addMemoryUsage(1.0 * (size + ext_size + dep_size) * sizeof(TacsScalar));
 }
 
 /*
@@ -156,6 +158,8 @@ TACSBVec::TACSBVec(MPI_Comm _comm, int _size, int _bsize) {
   dep_size = 0;
   x_dep = NULL;
   dep_nodes = NULL;
+
+  addMemoryUsage(1.0 * size * sizeof(TacsScalar));
 }
 
 TACSBVec::~TACSBVec() {
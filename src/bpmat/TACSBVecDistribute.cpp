@@ -18,6 +18,7 @@
 
 #include "TACSBVecDistribute.h"
 
+#include "TACSProfiler.h"
 #include "TacsUtilities.h"
 
 /*
@@ -464,6 +465,13 @@ TACSBVecDistribute::TACSBVecDistribute(TACSNodeMap *_rmap,
   // Free the full data
   delete[] full_req_ptr;
   delete[] full_ext_ptr;
+
+  // Record the memory for the communication pattern
+  int len = 3 * (n_ext_proc + n_req_proc) + 2 + req_ptr[n_req_proc];
+  if (!sorted_flag) {
+    len += 2 * nvars_unsorted;
+  }
+  addMemoryUsage(1.0 * len * sizeof(int));
 }
 
 /*
@@ -497,6 +505,14 @@ TACSBVecDistCtx *TACSBVecDistribute::createCtx(int bsize) {
   }
   ctx->reqvals = new TacsScalar[bsize * req_ptr[n_req_proc]];
 
+  // Record the memory for the buffers as part of this object
+  int len = bsize * req_ptr[n_req_proc];
+  if (!sorted_flag) {
+    len += bsize * next_vars;
+  }
+  ctx->setMemoryOwner(name);
+  ctx->addMemoryUsage(1.0 * len * sizeof(TacsScalar));
+
   // Allocate space for the send/recevies
   if (n_req_proc > 0) {
     ctx->sends = new MPI_Request[n_req_proc];
@@ -543,6 +559,7 @@ TACSBVecIndices *TACSBVecDistribute::getIndices() { return bindex; }
 void TACSBVecDistribute::beginForward(TACSBVecDistCtx *ctx, TacsScalar *global,
                                       TacsScalar *local,
                                       const int node_offset) {
+  TACS_PROFILE_SCOPE("TACSBVecDistribute::beginForward");
   if (this != ctx->me) {
     fprintf(stderr, "TACSBVecDistribute: Inconsistent context\n");
     return;
@@ -580,6 +597,7 @@ void TACSBVecDistribute::beginForward(TACSBVecDistCtx *ctx, TacsScalar *global,
     int size = bsize * req_count[i];
     MPI_Isend(&reqvals[start], size, TACS_MPI_TYPE, dest, ctx->ctx_tag, comm,
               &sends[i]);
+    TACSProfiler::addCounts(size * sizeof(TacsScalar), 0.0);
   }
 
   if (sorted_flag) {
@@ -620,6 +638,7 @@ void TACSBVecDistribute::beginForward(TACSBVecDistCtx *ctx, TacsScalar *global,
 */
 void TACSBVecDistribute::endForward(TACSBVecDistCtx *ctx, TacsScalar *global,
                                     TacsScalar *local, const int node_offset) {
+  TACS_PROFILE_SCOPE("TACSBVecDistribute::endForward");
   if (this != ctx->me) {
     fprintf(stderr, "TACSBVecDistribute: Inconsistent context\n");
     return;
@@ -651,6 +670,7 @@ void TACSBVecDistribute::endForward(TACSBVecDistCtx *ctx, TacsScalar *global,
 void TACSBVecDistribute::beginReverse(TACSBVecDistCtx *ctx, TacsScalar *local,
                                       TacsScalar *global,
                                       TACSBVecOperation op) {
+  TACS_PROFILE_SCOPE("TACSBVecDistribute::beginReverse");
   if (this != ctx->me) {
     fprintf(stderr, "TACSBVecDistribute: Inconsistent context\n");
     return;
@@ -699,6 +719,7 @@ void TACSBVecDistribute::beginReverse(TACSBVecDistCtx *ctx, TacsScalar *local,
     int size = bsize * ext_count[i];
     MPI_Isend(&local[start], size, TACS_MPI_TYPE, dest, ctx->ctx_tag, comm,
               &recvs[i]);
+    TACSProfiler::addCounts(size * sizeof(TacsScalar), 0.0);
   }
 
   for (int i = 0; i < n_req_proc; i++) {
@@ -716,6 +737,7 @@ void TACSBVecDistribute::beginReverse(TACSBVecDistCtx *ctx, TacsScalar *local,
 */
 void TACSBVecDistribute::endReverse(TACSBVecDistCtx *ctx, TacsScalar *local,
                                     TacsScalar *global, TACSBVecOperation op) {
+  TACS_PROFILE_SCOPE("TACSBVecDistribute::endReverse");
   if (this != ctx->me) {
     fprintf(stderr, "TACSBVecDistribute: Inconsistent context\n");
     return;
@@ -20,6 +20,8 @@
 
 #include <stdlib.h>
 
+#include "TACSMemoryTracker.h"
+#include "TACSProfiler.h"
 #include "TacsUtilities.h"
 #include "tacslapack.h"
 
@@ -795,6 +797,10 @@ void TACSBlockCyclicMat::getSize(int *nr, int *nc) {
   }
 }
 
+const char *TACSBlockCyclicMat::getObjectName() { return matName; }
+
+const char *TACSBlockCyclicMat::matName = "TACSBlockCyclicMat";
+
 /*
   Retrieve the size of the process grid.
 */
@@ -880,8 +886,11 @@ void TACSBlockCyclicMat::init_nz_arrays() {
 
   // Allocate the diagonal values
   dval_size = dval_offset[nrows];
-  Dvals = new TacsScalar[dval_size];
-  memset(Dvals, 0, dval_size * sizeof(TacsScalar));
+  Dvals = NULL;
+  if (!TACSMemoryTracker::isDryRun()) {
+    Dvals = new TacsScalar[dval_size];
+    memset(Dvals, 0, dval_size * sizeof(TacsScalar));
+  }
 
   // Calculate the off-diagonal offsets
   max_ubuff_size = 0;
@@ -906,8 +915,11 @@ void TACSBlockCyclicMat::init_nz_arrays() {
 
   // Allocate the upper triangular components
   uval_size = uval_offset[Urowp[nrows]];
-  Uvals = new TacsScalar[uval_size];
-  memset(Uvals, 0, uval_size * sizeof(TacsScalar));
+  Uvals = NULL;
+  if (!TACSMemoryTracker::isDryRun()) {
+    Uvals = new TacsScalar[uval_size];
+    memset(Uvals, 0, uval_size * sizeof(TacsScalar));
+  }
 
   // Calculate the lower triangular size
   lval_offset[0] = 0;
@@ -932,8 +944,11 @@ void TACSBlockCyclicMat::init_nz_arrays() {
 
   // Allocate space for the lower triangular components
   lval_size = lval_offset[Lcolp[ncols]];
-  Lvals = new TacsScalar[lval_size];
-  memset(Lvals, 0, lval_size * sizeof(TacsScalar));
+  Lvals = NULL;
+  if (!TACSMemoryTracker::isDryRun()) {
+    Lvals = new TacsScalar[lval_size];
+    memset(Lvals, 0, lval_size * sizeof(TacsScalar));
+  }
 
   int max_buff[2], max_buff_all[2];
   max_buff[0] = max_lbuff_size;
@@ -943,12 +958,38 @@ void TACSBlockCyclicMat::init_nz_arrays() {
 
   max_lbuff_size = max_buff_all[0];
   max_ubuff_size = max_buff_all[1];
+
+  // Record the memory for the non-zero pattern and the values. In
+  // dry-run mode, the values are not allocated.
+  int nnz = Urowp[nrows] + Lcolp[ncols];
+  double bytes = (3 * (nrows + 1) + 2 * (ncols + 1) + 2 * nnz) * sizeof(int);
+  bytes += (1.0 * dval_size + uval_size + lval_size) * sizeof(TacsScalar);
+  addMemoryUsage(bytes);
+}
+
+/*
+  Check that the values of the matrix have been allocated. The values
+  are not allocated when the matrix is created in dry-run mode, so the
+  numerical operations print an error and return.
+*/
+int TACSBlockCyclicMat::check_values(const char *name) {
+  if (!Dvals) {
+    fprintf(stderr,
+            "TACSBlockCyclicMat %s error: Cannot use a matrix created in "
+            "dry-run mode\n",
+            name);
+    return 0;
+  }
+  return 1;
 }
 
 /*
   Zero all the matrix entries.
 */
 void TACSBlockCyclicMat::zeroEntries() {
+  if (!check_values("zeroEntries")) {
+    return;
+  }
   memset(Dvals, 0, dval_size * sizeof(TacsScalar));
   memset(Lvals, 0, lval_size * sizeof(TacsScalar));
   memset(Uvals, 0, uval_size * sizeof(TacsScalar));
@@ -967,6 +1008,9 @@ void TACSBlockCyclicMat::zeroEntries() {
 void TACSBlockCyclicMat::addAllValues(int csr_bsize, int nvars,
                                       const int *csr_vars, const int *csr_rowp,
                                       const int *csr_cols, TacsScalar *vals) {
+  if (!check_values("addAllValues")) {
+    return;
+  }
   int rank, size;
   MPI_Comm_rank(comm, &rank);
   MPI_Comm_size(comm, &size);
@@ -1164,6 +1208,9 @@ void TACSBlockCyclicMat::addAlltoallValues(int csr_bsize, int nvars,
                                            const int *csr_rowp,
                                            const int *csr_cols,
                                            TacsScalar *vals) {
+  if (!check_values("addAlltoallValues")) {
+    return;
+  }
   int rank, size;
   MPI_Comm_rank(comm, &rank);
   MPI_Comm_size(comm, &size);
@@ -1426,6 +1473,9 @@ int TACSBlockCyclicMat::add_values(int rank, int i, int j, int csr_bsize,
   entries lie within the unit interval.
 */
 void TACSBlockCyclicMat::setRand() {
+  if (!check_values("setRand")) {
+    return;
+  }
   int rank;
   MPI_Comm_rank(comm, &rank);
 
@@ -1497,6 +1547,9 @@ void TACSBlockCyclicMat::setRand() {
   factorization over-writes the original matrix entries.
 */
 void TACSBlockCyclicMat::mult(TacsScalar *x, TacsScalar *y) {
+  if (!check_values("mult")) {
+    return;
+  }
   int rank;
   MPI_Comm_rank(comm, &rank);
 
@@ -1836,6 +1889,9 @@ void TACSBlockCyclicMat::init_row_counts() {
   .     send x[i] to the j-th columns
 */
 void TACSBlockCyclicMat::applyFactor(TacsScalar *x) {
+  if (!check_values("applyFactor")) {
+    return;
+  }
   int rank;
   MPI_Comm_rank(comm, &rank);
 
@@ -2434,6 +2490,9 @@ TacsScalar *TACSBlockCyclicMat::get_block(int rank, int i, int j) {
   A[i+1:n,i+1:n] <-- A[i+1:n,i+1:n] - L[i+1:n,i]*U[i,i+1:n]
 */
 void TACSBlockCyclicMat::factor() {
+  if (!check_values("factor")) {
+    return;
+  }
   int rank;
   MPI_Comm_rank(comm, &rank);
 
@@ -2465,6 +2524,7 @@ void TACSBlockCyclicMat::factor() {
   double t_recv_wait = 0.0;
   double t_send_wait = 0.0;
   int n_gemm = 0;
+  double flops = 0.0;
 
   for (int i = 0; i < nrows; i++) {
     int bi = bptr[i + 1] - bptr[i];
@@ -2485,6 +2545,7 @@ void TACSBlockCyclicMat::factor() {
       LAPACKgetri(&bi, d_diag, &bi, temp_piv, work, &lwork, &info);
       // Add flops from the inversion
       TacsAddFlops(1.333333 * bi * bi * bi);
+      flops += 1.333333 * bi * bi * bi;
 
       // Send the factor to the column processes
       for (int p = 0; p < nprows; p++) {
@@ -2570,6 +2631,7 @@ void TACSBlockCyclicMat::factor() {
                    &bi, &beta, temp_block, &bj);
           n_gemm++;
           TacsAddFlops(2 * bi * bi * bj);
+          flops += 2.0 * bi * bi * bj;
 
           memcpy(&Lvals[np], temp_block, bi * bj * sizeof(TacsScalar));
         }
@@ -2686,6 +2748,7 @@ void TACSBlockCyclicMat::factor() {
                    &bii);
           n_gemm++;
           TacsAddFlops(2 * bii * bjj * bi);
+          flops += 2.0 * bii * bjj * bi;
         }
 
         U += bi * bjj;
@@ -2699,6 +2762,8 @@ void TACSBlockCyclicMat::factor() {
     }
   }
 
+  TACSProfiler::addCounts(0.0, flops);
+
   if (monitor_factor) {
     printf("[%d] Number of GEMM updates: %d\n", rank, n_gemm);
     printf("[%d] Update time:      %15.8f\n", rank, t_update);
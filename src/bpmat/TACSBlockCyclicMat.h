@@ -90,6 +90,7 @@ class TACSBlockCyclicMat : public TACSObject {
   void getProcessGridSize(int *_nprows, int *_npcols);
   void setMonitorFactorFlag(int flag);
   int getLocalVecSize() { return xbptr[nrows]; }
+  const char *getObjectName();
 
   // Get block pointers to the columns
   // ---------------------------------
@@ -145,6 +146,7 @@ class TACSBlockCyclicMat : public TACSObject {
  private:
   void init_proc_grid(int size);
   void init_nz_arrays();
+  int check_values(const char *name);
   void init_row_counts();
   void merge_nz_pattern(int root, int *rowp, int *cols, int reorder_blocks);
   void compute_symbolic_factor(int **_rowp, int **_cols, int max_size);
@@ -254,6 +256,8 @@ class TACSBlockCyclicMat : public TACSObject {
   int lower_block_count, upper_block_count;
   int *lower_row_sum_count, *lower_row_sum_recv;
   int *upper_row_sum_count, *upper_row_sum_recv;
+
+  static const char *matName;
 };
 
 #endif  // TACS_BLOCK_CYCLIC_MAT_H
@@ -0,0 +1,651 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSInterleavedBVec.h"
+
+#include "TACSProfiler.h"
+#include "TacsUtilities.h"
+
+/*
+  Find the vectors that are non-zero at a local node from the blocks
+  that contain the node. The marker array is used to skip vectors that
+  have already been found and must contain values other than the stamp
+  on input. The vectors are written to cols when it is not NULL.
+*/
+static int TacsFindNodeVecs(int node, const int *node_ptr,
+                            const int *node_blocks, int nvecs,
+                            const int *vec_ptr, const int *block_vecs,
+                            int stamp, int *marker, int *cols) {
+  int count = 0;
+  for (int jp = node_ptr[node]; jp < node_ptr[node + 1]; jp++) {
+    int block = node_blocks[jp];
+    if (!vec_ptr) {
+      // Each block includes all the vectors
+      if (cols) {
+        for (int k = 0; k < nvecs; k++) {
+          cols[k] = k;
+        }
+      }
+      return nvecs;
+    }
+    for (int kp = vec_ptr[block]; kp < vec_ptr[block + 1]; kp++) {
+      int vec = block_vecs[kp];
+      if (vec >= 0 && vec < nvecs && marker[vec] != stamp) {
+        marker[vec] = stamp;
+        if (cols) {
+          cols[count] = vec;
+        }
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+/**
+  Create the vectors and their sparse pattern
+
+  The nodes of block i are block_nodes[block_ptr[i]:block_ptr[i+1]],
+  which are global node numbers or negative dependent node numbers, as
+  in TACSBVec::setValues(). The vectors that are non-zero on these
+  nodes are block_vecs[vec_ptr[i]:vec_ptr[i+1]]. When vec_ptr is NULL,
+  all the vectors are non-zero on the nodes of every block.
+
+  This call is collective on all processors in the node map.
+
+  @param map The node map for the owned nodes
+  @param bsize The block size of each vector
+  @param nvecs The number of vectors
+  @param ext_dist The external nodes
+  @param dep_nodes The dependent nodes
+  @param nblocks The number of blocks
+  @param block_ptr Pointer into the nodes for each block
+  @param block_nodes The nodes for each block
+  @param vec_ptr Pointer into the vectors for each block (may be NULL)
+  @param block_vecs The vectors for each block
+*/
+TACSInterleavedBVec::TACSInterleavedBVec(
+    TACSNodeMap *map, int _bsize, int _nvecs, TACSBVecDistribute *ext_dist,
+    TACSBVecDepNodes *_dep_nodes, int nblocks, const int *block_ptr,
+    const int *block_nodes, const int *vec_ptr, const int *block_vecs) {
+  node_map = map;
+  node_map->incref();
+  comm = node_map->getMPIComm();
+
+  int mpi_size, mpi_rank;
+  MPI_Comm_size(comm, &mpi_size);
+  MPI_Comm_rank(comm, &mpi_rank);
+
+  bsize = _bsize;
+  nvecs = _nvecs;
+
+  // Set the number of owned, external and dependent nodes
+  const int *owner_range;
+  node_map->getOwnerRange(&owner_range);
+  lower = owner_range[mpi_rank];
+  upper = owner_range[mpi_rank + 1];
+  nowned = upper - lower;
+
+  next = 0;
+  ext_indices = NULL;
+  const int *ext_nodes = NULL;
+  if (ext_dist) {
+    ext_indices = ext_dist->getIndices();
+    ext_indices->incref();
+    next = ext_indices->getIndices(&ext_nodes);
+  }
+
+  ndep = 0;
+  dep_nodes = _dep_nodes;
+  const int *dep_ptr = NULL, *dep_conn = NULL;
+  const double *dep_conn_weights = NULL;
+  if (dep_nodes) {
+    dep_nodes->incref();
+    ndep = dep_nodes->getDepNodes(&dep_ptr, &dep_conn, &dep_conn_weights);
+  }
+  const int nlocal = nowned + next + ndep;
+
+  // Find the blocks that contain each local node. The values at a
+  // dependent node are added to the nodes it depends on, so the
+  // blocks that contain a dependent node also contain these nodes.
+  int *node_ptr = new int[nlocal + 1];
+  memset(node_ptr, 0, (nlocal + 1) * sizeof(int));
+  for (int i = 0; i < nblocks; i++) {
+    for (int jp = block_ptr[i]; jp < block_ptr[i + 1]; jp++) {
+      int node = getLocalIndex(block_nodes[jp]);
+      if (node >= 0) {
+        node_ptr[node + 1]++;
+        if (node >= nowned + next) {
+          int d = node - nowned - next;
+          for (int kp = dep_ptr[d]; kp < dep_ptr[d + 1]; kp++) {
+            int conn = getLocalIndex(dep_conn[kp]);
+            if (conn >= 0) {
+              node_ptr[conn + 1]++;
+            }
+          }
+        }
+      }
+    }
+  }
+  for (int i = 0; i < nlocal; i++) {
+    node_ptr[i + 1] += node_ptr[i];
+  }
+
+  int *node_blocks = new int[node_ptr[nlocal]];
+  for (int i = 0; i < nblocks; i++) {
+    for (int jp = block_ptr[i]; jp < block_ptr[i + 1]; jp++) {
+      int node = getLocalIndex(block_nodes[jp]);
+      if (node >= 0) {
+        node_blocks[node_ptr[node]] = i;
+        node_ptr[node]++;
+        if (node >= nowned + next) {
+          int d = node - nowned - next;
+          for (int kp = dep_ptr[d]; kp < dep_ptr[d + 1]; kp++) {
+            int conn = getLocalIndex(dep_conn[kp]);
+            if (conn >= 0) {
+              node_blocks[node_ptr[conn]] = i;
+              node_ptr[conn]++;
+            }
+          }
+        }
+      }
+    }
+  }
+  for (int i = nlocal; i > 0; i--) {
+    node_ptr[i] = node_ptr[i - 1];
+  }
+  node_ptr[0] = 0;
+
+  // Find the vectors at each external node from the local blocks
+  int *marker = new int[nvecs];
+  for (int k = 0; k < nvecs; k++) {
+    marker[k] = -1;
+  }
+
+  int *ext_ptr = new int[next + 1];
+  ext_ptr[0] = 0;
+  for (int i = 0; i < next; i++) {
+    ext_ptr[i + 1] =
+        ext_ptr[i] + TacsFindNodeVecs(nowned + i, node_ptr, node_blocks, nvecs,
+                                      vec_ptr, block_vecs, i, marker, NULL);
+  }
+
+  int *ext_vecs = new int[ext_ptr[next]];
+  for (int k = 0; k < nvecs; k++) {
+    marker[k] = -1;
+  }
+  for (int i = 0; i < next; i++) {
+    int *cols_i = &ext_vecs[ext_ptr[i]];
+    int len = TacsFindNodeVecs(nowned + i, node_ptr, node_blocks, nvecs,
+                               vec_ptr, block_vecs, i, marker, cols_i);
+    TacsUniqueSort(len, cols_i);
+  }
+
+  // Send the node number, the number of vectors and the vectors for
+  // each external node with a non-empty pattern to the owner
+  int *full_send_count = new int[mpi_size];
+  int *full_send_ptr = new int[mpi_size + 1];
+  int *full_recv_count = new int[mpi_size];
+  int *full_recv_ptr = new int[mpi_size + 1];
+  int *ext_owners = new int[next];
+  memset(full_send_count, 0, mpi_size * sizeof(int));
+  for (int i = 0; i < next; i++) {
+    ext_owners[i] = -1;
+    int len = ext_ptr[i + 1] - ext_ptr[i];
+    if (len > 0 && ext_nodes[i] >= 0) {
+      int owner = node_map->getNodeOwner(ext_nodes[i]);
+      if (owner >= 0 && owner != mpi_rank) {
+        ext_owners[i] = owner;
+        full_send_count[owner] += 2 + len;
+      }
+    }
+  }
+
+  MPI_Alltoall(full_send_count, 1, MPI_INT, full_recv_count, 1, MPI_INT, comm);
+
+  full_send_ptr[0] = full_recv_ptr[0] = 0;
+  for (int i = 0; i < mpi_size; i++) {
+    full_send_ptr[i + 1] = full_send_ptr[i] + full_send_count[i];
+    full_recv_ptr[i + 1] = full_recv_ptr[i] + full_recv_count[i];
+  }
+
+  int *send_pattern = new int[full_send_ptr[mpi_size]];
+  int *recv_pattern = new int[full_recv_ptr[mpi_size]];
+  for (int i = 0; i < next; i++) {
+    int owner = ext_owners[i];
+    if (owner >= 0) {
+      int *buff = &send_pattern[full_send_ptr[owner]];
+      int len = ext_ptr[i + 1] - ext_ptr[i];
+      buff[0] = ext_nodes[i];
+      buff[1] = len;
+      memcpy(&buff[2], &ext_vecs[ext_ptr[i]], len * sizeof(int));
+      full_send_ptr[owner] += 2 + len;
+    }
+  }
+  for (int i = mpi_size; i > 0; i--) {
+    full_send_ptr[i] = full_send_ptr[i - 1];
+  }
+  full_send_ptr[0] = 0;
+
+  MPI_Alltoallv(send_pattern, full_send_count, full_send_ptr, MPI_INT,
+                recv_pattern, full_recv_count, full_recv_ptr, MPI_INT, comm);
+
+  // Find the received patterns for each owned node
+  int *recv_node_ptr = new int[nowned + 1];
+  memset(recv_node_ptr, 0, (nowned + 1) * sizeof(int));
+  int nrecv_nodes = 0;
+  for (int jp = 0; jp < full_recv_ptr[mpi_size];
+       jp += 2 + recv_pattern[jp + 1]) {
+    recv_node_ptr[recv_pattern[jp] - lower + 1]++;
+    nrecv_nodes++;
+  }
+  for (int i = 0; i < nowned; i++) {
+    recv_node_ptr[i + 1] += recv_node_ptr[i];
+  }
+  int *recv_node_offset = new int[nrecv_nodes];
+  for (int jp = 0; jp < full_recv_ptr[mpi_size];
+       jp += 2 + recv_pattern[jp + 1]) {
+    int node = recv_pattern[jp] - lower;
+    recv_node_offset[recv_node_ptr[node]] = jp + 1;
+    recv_node_ptr[node]++;
+  }
+  for (int i = nowned; i > 0; i--) {
+    recv_node_ptr[i] = recv_node_ptr[i - 1];
+  }
+  recv_node_ptr[0] = 0;
+
+  // Form the pattern for all the local nodes. The pattern for the
+  // owned nodes includes the patterns received from other processors.
+  rowp = new int[nlocal + 1];
+  rowp[0] = 0;
+  for (int pass = 0; pass < 2; pass++) {
+    for (int k = 0; k < nvecs; k++) {
+      marker[k] = -1;
+    }
+    for (int i = 0; i < nlocal; i++) {
+      int *cols_i = (pass == 0 ? NULL : &cols[rowp[i]]);
+      int len = 0;
+      if (i >= nowned && i < nowned + next) {
+        len = ext_ptr[i - nowned + 1] - ext_ptr[i - nowned];
+        if (cols_i) {
+          memcpy(cols_i, &ext_vecs[ext_ptr[i - nowned]], len * sizeof(int));
+        }
+      } else {
+        len = TacsFindNodeVecs(i, node_ptr, node_blocks, nvecs, vec_ptr,
+                               block_vecs, i, marker, cols_i);
+        if (i < nowned) {
+          for (int jp = recv_node_ptr[i]; jp < recv_node_ptr[i + 1]; jp++) {
+            const int *recv = &recv_pattern[recv_node_offset[jp]];
+            for (int kp = 0; kp < recv[0]; kp++) {
+              int vec = recv[kp + 1];
+              if (vec >= 0 && vec < nvecs && marker[vec] != i) {
+                marker[vec] = i;
+                if (cols_i) {
+                  cols_i[len] = vec;
+                }
+                len++;
+              }
+            }
+          }
+        }
+        if (cols_i) {
+          TacsUniqueSort(len, cols_i);
+        }
+      }
+      if (pass == 0) {
+        rowp[i + 1] = rowp[i] + len;
+      }
+    }
+    if (pass == 0) {
+      cols = new int[rowp[nlocal]];
+    }
+  }
+
+  // Set the entries sent to each processor in the order of the
+  // patterns sent above
+  nsend_procs = 0;
+  for (int i = 0; i < mpi_size; i++) {
+    if (full_send_count[i] > 0) {
+      nsend_procs++;
+    }
+  }
+  send_procs = new int[nsend_procs];
+  send_ptr = new int[nsend_procs + 1];
+  send_ptr[0] = 0;
+  for (int i = 0, n = 0; i < mpi_size; i++) {
+    if (full_send_count[i] > 0) {
+      send_procs[n] = i;
+      // Subtract the node number and length for each node
+      int size = 0;
+      for (int jp = full_send_ptr[i]; jp < full_send_ptr[i + 1];
+           jp += 2 + send_pattern[jp + 1]) {
+        size += send_pattern[jp + 1];
+      }
+      send_ptr[n + 1] = send_ptr[n] + size;
+      n++;
+    }
+  }
+
+  send_entries = new int[send_ptr[nsend_procs]];
+  int *send_offset = new int[mpi_size];
+  for (int n = 0; n < nsend_procs; n++) {
+    send_offset[send_procs[n]] = send_ptr[n];
+  }
+  for (int i = 0; i < next; i++) {
+    int owner = ext_owners[i];
+    if (owner >= 0) {
+      int node = nowned + i;
+      for (int jp = rowp[node]; jp < rowp[node + 1]; jp++) {
+        send_entries[send_offset[owner]] = jp;
+        send_offset[owner]++;
+      }
+    }
+  }
+  delete[] send_offset;
+
+  // Set the owned entries for the values received from each processor
+  nrecv_procs = 0;
+  for (int i = 0; i < mpi_size; i++) {
+    if (full_recv_count[i] > 0) {
+      nrecv_procs++;
+    }
+  }
+  recv_procs = new int[nrecv_procs];
+  recv_ptr = new int[nrecv_procs + 1];
+  recv_ptr[0] = 0;
+  for (int i = 0, n = 0; i < mpi_size; i++) {
+    if (full_recv_count[i] > 0) {
+      recv_procs[n] = i;
+      int size = 0;
+      for (int jp = full_recv_ptr[i]; jp < full_recv_ptr[i + 1];
+           jp += 2 + recv_pattern[jp + 1]) {
+        size += recv_pattern[jp + 1];
+      }
+      recv_ptr[n + 1] = recv_ptr[n] + size;
+      n++;
+    }
+  }
+
+  recv_entries = new int[recv_ptr[nrecv_procs]];
+  for (int jp = 0, n = 0; jp < full_recv_ptr[mpi_size];
+       jp += 2 + recv_pattern[jp + 1]) {
+    int node = recv_pattern[jp] - lower;
+    for (int kp = 0; kp < recv_pattern[jp + 1]; kp++, n++) {
+      recv_entries[n] = findEntry(node, recv_pattern[jp + 2 + kp]);
+    }
+  }
+
+  // Set the entries that the dependent node values are added to
+  ndep_entries = 0;
+  for (int d = 0; d < ndep; d++) {
+    int node = nowned + next + d;
+    ndep_entries +=
+        (rowp[node + 1] - rowp[node]) * (dep_ptr[d + 1] - dep_ptr[d]);
+  }
+  dep_src = new int[ndep_entries];
+  dep_dest = new int[ndep_entries];
+  dep_weights = new double[ndep_entries];
+  ndep_entries = 0;
+  for (int d = 0; d < ndep; d++) {
+    int node = nowned + next + d;
+    for (int kp = dep_ptr[d]; kp < dep_ptr[d + 1]; kp++) {
+      int conn = getLocalIndex(dep_conn[kp]);
+      if (conn >= 0) {
+        for (int jp = rowp[node]; jp < rowp[node + 1]; jp++) {
+          dep_src[ndep_entries] = jp;
+          dep_dest[ndep_entries] = findEntry(conn, cols[jp]);
+          dep_weights[ndep_entries] = dep_conn_weights[kp];
+          ndep_entries++;
+        }
+      }
+    }
+  }
+
+  delete[] node_ptr;
+  delete[] node_blocks;
+  delete[] marker;
+  delete[] ext_ptr;
+  delete[] ext_vecs;
+  delete[] ext_owners;
+  delete[] full_send_count;
+  delete[] full_send_ptr;
+  delete[] full_recv_count;
+  delete[] full_recv_ptr;
+  delete[] send_pattern;
+  delete[] recv_pattern;
+  delete[] recv_node_ptr;
+  delete[] recv_node_offset;
+
+  // Allocate the values and the communication buffers
+  int size = bsize * rowp[nlocal];
+  x = new TacsScalar[size];
+  memset(x, 0, size * sizeof(TacsScalar));
+  send_buff = new TacsScalar[bsize * send_ptr[nsend_procs]];
+  recv_buff = new TacsScalar[bsize * recv_ptr[nrecv_procs]];
+  send_requests = new MPI_Request[nsend_procs];
+  recv_requests = new MPI_Request[nrecv_procs];
+
+  tag = tag_value;
+  tag_value++;
+
+  addMemoryUsage(
+      1.0 * (size + bsize * (send_ptr[nsend_procs] + recv_ptr[nrecv_procs])) *
+          sizeof(TacsScalar) +
+      1.0 * (nlocal + 1 + rowp[nlocal] + send_ptr[nsend_procs] +
+             recv_ptr[nrecv_procs] + 2 * ndep_entries) *
+          sizeof(int));
+}
+
+int TACSInterleavedBVec::tag_value = 0;
+
+TACSInterleavedBVec::~TACSInterleavedBVec() {
+  node_map->decref();
+  if (ext_indices) {
+    ext_indices->decref();
+  }
+  if (dep_nodes) {
+    dep_nodes->decref();
+  }
+  delete[] rowp;
+  delete[] cols;
+  delete[] x;
+  delete[] dep_src;
+  delete[] dep_dest;
+  delete[] dep_weights;
+  delete[] send_procs;
+  delete[] send_ptr;
+  delete[] send_entries;
+  delete[] send_buff;
+  delete[] send_requests;
+  delete[] recv_procs;
+  delete[] recv_ptr;
+  delete[] recv_entries;
+  delete[] recv_buff;
+  delete[] recv_requests;
+}
+
+const char *TACSInterleavedBVec::getObjectName() {
+  return "TACSInterleavedBVec";
+}
+
+/*
+  Get the local index of a node: the owned nodes are first, followed
+  by the external and then the dependent nodes. Returns -1 if the node
+  is not stored on this processor.
+*/
+int TACSInterleavedBVec::getLocalIndex(int index) {
+  if (index >= lower && index < upper) {
+    return index - lower;
+  } else if (index < 0) {
+    int d = -index - 1;
+    if (d < ndep) {
+      return nowned + next + d;
+    }
+  } else if (ext_indices) {
+    int k = ext_indices->findIndex(index);
+    if (k >= 0) {
+      return nowned + k;
+    }
+  }
+  return -1;
+}
+
+/*
+  Find the entry for the vector at the local node, or -1 if the vector
+  is not in the pattern for the node
+*/
+int TACSInterleavedBVec::findEntry(int node, int vec) {
+  const int *cols_node = &cols[rowp[node]];
+  int *item = TacsSearchArray(vec, rowp[node + 1] - rowp[node], cols_node);
+  if (item) {
+    return rowp[node] + (item - cols_node);
+  }
+  return -1;
+}
+
+/**
+  Get the number of entries stored on this processor
+
+  Each entry stores bsize values for one vector at one node.
+
+  @param nowned_entries The number of entries for the owned nodes
+  @return The number of entries for all local nodes
+*/
+int TACSInterleavedBVec::getNumEntries(int *nowned_entries) {
+  if (nowned_entries) {
+    *nowned_entries = rowp[nowned];
+  }
+  return rowp[nowned + next + ndep];
+}
+
+/**
+  Zero all the values
+*/
+void TACSInterleavedBVec::zeroEntries() {
+  memset(x, 0, bsize * rowp[nowned + next + ndep] * sizeof(TacsScalar));
+}
+
+/**
+  Add values to one of the vectors
+
+  The values are added at the nodes in the index array, which are
+  global node numbers or negative dependent node numbers. Values at
+  nodes that are not in the pattern of the vector are not added.
+
+  @param vec The vector index
+  @param n The number of nodes
+  @param index The node numbers
+  @param vals The block of bsize values for each node
+  @return The number of nodes that are not in the pattern
+*/
+int TACSInterleavedBVec::addValues(int vec, int n, const int *index,
+                                   const TacsScalar *vals) {
+  int nmissing = 0;
+  for (int i = 0; i < n; i++, vals += bsize) {
+    int node = getLocalIndex(index[i]);
+    int entry = (node >= 0 ? findEntry(node, vec) : -1);
+    if (entry >= 0) {
+      TacsScalar *y = &x[bsize * entry];
+      for (int k = 0; k < bsize; k++) {
+        y[k] += vals[k];
+      }
+    } else {
+      nmissing++;
+    }
+  }
+  return nmissing;
+}
+
+/**
+  Copy the owned values of one of the vectors to an array
+
+  The array stores bsize values for each owned node, in the same
+  layout as TACSBVec. Values not in the pattern are set to zero.
+
+  @param vec The vector index
+  @param array The array of owned values
+*/
+void TACSInterleavedBVec::getValues(int vec, TacsScalar *array) {
+  for (int i = 0; i < nowned; i++, array += bsize) {
+    int entry = findEntry(i, vec);
+    if (entry >= 0) {
+      memcpy(array, &x[bsize * entry], bsize * sizeof(TacsScalar));
+    } else {
+      memset(array, 0, bsize * sizeof(TacsScalar));
+    }
+  }
+}
+
+/**
+  Begin adding the values of the dependent and external nodes to
+  their owners
+
+  The values for all the vectors are sent to each processor in a
+  single message.
+*/
+void TACSInterleavedBVec::beginSetValues() {
+  TACS_PROFILE_SCOPE("TACSInterleavedBVec::beginSetValues");
+  // Add the dependent node values to the independent nodes
+  for (int i = 0; i < ndep_entries; i++) {
+    const TacsScalar *z = &x[bsize * dep_src[i]];
+    TacsScalar *y = &x[bsize * dep_dest[i]];
+    for (int k = 0; k < bsize; k++) {
+      y[k] += dep_weights[i] * z[k];
+    }
+  }
+
+  for (int n = 0; n < nrecv_procs; n++) {
+    int start = bsize * recv_ptr[n];
+    int size = bsize * (recv_ptr[n + 1] - recv_ptr[n]);
+    MPI_Irecv(&recv_buff[start], size, TACS_MPI_TYPE, recv_procs[n], tag,
+              comm, &recv_requests[n]);
+  }
+
+  for (int n = 0; n < nsend_procs; n++) {
+    for (int jp = send_ptr[n]; jp < send_ptr[n + 1]; jp++) {
+      memcpy(&send_buff[bsize * jp], &x[bsize * send_entries[jp]],
+             bsize * sizeof(TacsScalar));
+    }
+    int start = bsize * send_ptr[n];
+    int size = bsize * (send_ptr[n + 1] - send_ptr[n]);
+    MPI_Isend(&send_buff[start], size, TACS_MPI_TYPE, send_procs[n], tag,
+              comm, &send_requests[n]);
+    TACSProfiler::addCounts(size * sizeof(TacsScalar), 0.0);
+  }
+}
+
+/**
+  Finish adding the values to their owners and zero the values of the
+  external and dependent nodes
+*/
+void TACSInterleavedBVec::endSetValues() {
+  TACS_PROFILE_SCOPE("TACSInterleavedBVec::endSetValues");
+  MPI_Waitall(nrecv_procs, recv_requests, MPI_STATUSES_IGNORE);
+  for (int jp = 0; jp < recv_ptr[nrecv_procs]; jp++) {
+    const TacsScalar *z = &recv_buff[bsize * jp];
+    TacsScalar *y = &x[bsize * recv_entries[jp]];
+    for (int k = 0; k < bsize; k++) {
+      y[k] += z[k];
+    }
+  }
+  MPI_Waitall(nsend_procs, send_requests, MPI_STATUSES_IGNORE);
+
+  int start = rowp[nowned];
+  int end = rowp[nowned + next + ndep];
+  memset(&x[bsize * start], 0, bsize * (end - start) * sizeof(TacsScalar));
+}
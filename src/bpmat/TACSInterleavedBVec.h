@@ -0,0 +1,122 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_INTERLEAVED_BVEC_H
+#define TACS_INTERLEAVED_BVEC_H
+
+#include "TACSBVec.h"
+
+/**
+  A set of block vectors that share the parallel layout of a TACSBVec
+  and are stored together with a sparse pattern.
+
+  Each local node (owned, external or dependent) stores a block of
+  bsize values only for the vectors that are non-zero at the node.
+  The vectors for each node are stored contiguously in a compressed
+  sparse row format, with the vectors in ascending order. This is
+  used to accumulate the derivatives of many functions w.r.t. the
+  design variables, where the derivative of each function is only
+  non-zero for the design variables of the elements in its domain.
+
+  The pattern is defined by a set of blocks, typically the elements.
+  Each block lists its nodes and the vectors that are non-zero on
+  these nodes. The pattern of the external nodes is sent to their
+  owners when the object is created, so that the values added to
+  external nodes for all the vectors are collected on their owners
+  with a single exchange of messages in beginSetValues() and
+  endSetValues().
+
+  Values can only be added at a node for the vectors in the pattern.
+*/
+class TACSInterleavedBVec : public TACSObject {
+ public:
+  TACSInterleavedBVec(TACSNodeMap *map, int bsize, int nvecs,
+                      TACSBVecDistribute *ext_dist, TACSBVecDepNodes *dep_nodes,
+                      int nblocks, const int *block_ptr,
+                      const int *block_nodes, const int *vec_ptr,
+                      const int *block_vecs);
+  ~TACSInterleavedBVec();
+
+  // Get the size and layout of the vectors
+  // --------------------------------------
+  MPI_Comm getMPIComm() { return comm; }
+  int getBlockSize() { return bsize; }
+  int getNumVecs() { return nvecs; }
+  int getNumEntries(int *nowned_entries = NULL);
+
+  // Set and get the values
+  // ----------------------
+  void zeroEntries();
+  int addValues(int vec, int n, const int *index, const TacsScalar *vals);
+  void getValues(int vec, TacsScalar *array);
+
+  // Collect the values to their owners
+  // ----------------------------------
+  void beginSetValues();
+  void endSetValues();
+
+  const char *getObjectName();
+
+ private:
+  // Get the local node index for a global node index
+  int getLocalIndex(int index);
+
+  // Find the entry for a vector at a local node
+  int findEntry(int node, int vec);
+
+  // The communicator and the node map
+  MPI_Comm comm;
+  TACSNodeMap *node_map;
+  TACSBVecIndices *ext_indices;
+  TACSBVecDepNodes *dep_nodes;
+
+  // The block size and number of vectors
+  int bsize, nvecs;
+
+  // The range of owned nodes and the number of owned, external and
+  // dependent nodes
+  int lower, upper;
+  int nowned, next, ndep;
+
+  // The sparse pattern and the values
+  int *rowp, *cols;
+  TacsScalar *x;
+
+  // Data for adding the dependent node values to the independent nodes
+  int ndep_entries;
+  int *dep_src, *dep_dest;
+  double *dep_weights;
+
+  // The entries sent to other processors
+  int nsend_procs;
+  int *send_procs, *send_ptr, *send_entries;
+  TacsScalar *send_buff;
+  MPI_Request *send_requests;
+
+  // The entries received from other processors
+  int nrecv_procs;
+  int *recv_procs, *recv_ptr, *recv_entries;
+  TacsScalar *recv_buff;
+  MPI_Request *recv_requests;
+
+  // The MPI tag for the messages
+  int tag;
+  static int tag_value;
+};
+
+#endif  // TACS_INTERLEAVED_BVEC_H
@@ -18,6 +18,7 @@
 
 #include "TACSMatDistribute.h"
 
+#include "TACSProfiler.h"
 #include "TacsUtilities.h"
 
 /*
@@ -1152,6 +1153,7 @@ void TACSMatDistribute::setValues(TACSParallelMat *mat, int nvars,
    Initiate the communication of the off-process matrix entries
 */
 void TACSMatDistribute::beginAssembly(TACSParallelMat *mat) {
+  TACS_PROFILE_SCOPE("TACSMatDistribute::beginAssembly");
   int mpiRank;
   MPI_Comm_rank(comm, &mpiRank);
 
@@ -1180,6 +1182,7 @@ void TACSMatDistribute::beginAssembly(TACSParallelMat *mat) {
     int tag = 5;
     MPI_Isend(&ext_A[buff_offset], count, TACS_MPI_TYPE, dest, tag, comm,
               &ext_requests[k]);
+    TACSProfiler::addCounts(count * sizeof(TacsScalar), 0.0);
     offset += ext_count[k];
     buff_offset += count;
   }
@@ -1191,6 +1194,7 @@ void TACSMatDistribute::beginAssembly(TACSParallelMat *mat) {
   entries to the matrix.
 */
 void TACSMatDistribute::endAssembly(TACSParallelMat *mat) {
+  TACS_PROFILE_SCOPE("TACSMatDistribute::endAssembly");
   int mpiRank;
   MPI_Comm_rank(comm, &mpiRank);
 
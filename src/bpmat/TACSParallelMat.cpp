@@ -20,6 +20,8 @@
 
 #include <stdio.h>
 
+#include "TACSMemoryTracker.h"
+#include "TACSProfiler.h"
 #include "tacslapack.h"
 
 /*!
@@ -134,6 +136,11 @@ void TACSParallelMat::init(TACSNodeMap *_rmap, BCSRMat *_Aloc, BCSRMat *_Bext,
   x_ext = new TacsScalar[len];
   memset(x_ext, 0, len * sizeof(TacsScalar));
   ext_offset = bsize * Np;
+
+  // Record the memory for the matrices as part of this matrix
+  addMemoryUsage(1.0 * len * sizeof(TacsScalar));
+  Aloc->setMemoryOwner(matName);
+  Bext->setMemoryOwner(matName);
 }
 
 TACSParallelMat::~TACSParallelMat() {
@@ -246,6 +253,7 @@ void TACSParallelMat::addDiag(TacsScalar alpha) { Aloc->addDiag(alpha); }
   Matrix multiplication
 */
 void TACSParallelMat::mult(TACSVec *txvec, TACSVec *tyvec) {
+  TACS_PROFILE_SCOPE("TACSParallelMat::mult");
   TACSBVec *xvec, *yvec;
   xvec = dynamic_cast<TACSBVec *>(txvec);
   yvec = dynamic_cast<TACSBVec *>(tyvec);
@@ -1201,6 +1209,8 @@ TACSAdditiveSchwarz::TACSAdditiveSchwarz(TACSParallelMat *_mat, int levFill,
   // components of the matrix. Incref the pointer to the matrix
   Apc = new BCSRMat(mat->getMPIComm(), Aloc, levFill, fill);
   Apc->incref();
+  Apc->setMemoryOwner("TACSAdditiveSchwarz");
+  dry_run = TACSMemoryTracker::isDryRun();
 
   alpha = 0.0;  // Diagonal scalar to be added to the preconditioner
 }
@@ -1225,6 +1235,13 @@ void TACSAdditiveSchwarz::setDiagShift(TacsScalar _alpha) { alpha = _alpha; }
   block-diagonal matrix and then factoring the copy.
 */
 void TACSAdditiveSchwarz::factor() {
+  TACS_PROFILE_SCOPE("TACSAdditiveSchwarz::factor");
+  if (dry_run) {
+    fprintf(stderr,
+            "TACSAdditiveSchwarz error: Cannot factor a preconditioner "
+            "created in dry-run mode\n");
+    return;
+  }
   Apc->copyValues(Aloc);
   if (alpha != 0.0) {
     Apc->addDiag(alpha);
@@ -1241,6 +1258,13 @@ void TACSAdditiveSchwarz::factor() {
   y = U^{-1} L^{-1} x
 */
 void TACSAdditiveSchwarz::applyFactor(TACSVec *txvec, TACSVec *tyvec) {
+  TACS_PROFILE_SCOPE("TACSAdditiveSchwarz::applyFactor");
+  if (dry_run) {
+    fprintf(stderr,
+            "TACSAdditiveSchwarz error: Cannot apply a preconditioner "
+            "created in dry-run mode\n");
+    return;
+  }
   TACSBVec *xvec, *yvec;
   xvec = dynamic_cast<TACSBVec *>(txvec);
   yvec = dynamic_cast<TACSBVec *>(tyvec);
@@ -1267,6 +1291,12 @@ void TACSAdditiveSchwarz::applyFactor(TACSVec *txvec, TACSVec *tyvec) {
   y = U^{-1} L^{-1} y
 */
 void TACSAdditiveSchwarz::applyFactor(TACSVec *txvec) {
+  if (dry_run) {
+    fprintf(stderr,
+            "TACSAdditiveSchwarz error: Cannot apply a preconditioner "
+            "created in dry-run mode\n");
+    return;
+  }
   TACSBVec *xvec;
   xvec = dynamic_cast<TACSBVec *>(txvec);
 
@@ -1309,6 +1339,8 @@ TACSApproximateSchur::TACSApproximateSchur(TACSParallelMat *_mat, int levFill,
 
   Apc = new BCSRMat(mat->getMPIComm(), Aloc, levFill, fill);
   Apc->incref();
+  Apc->setMemoryOwner("TACSApproximateSchur");
+  dry_run = TACSMemoryTracker::isDryRun();
   alpha = 0.0;
 
   // Check if we're dealing with a serial case here...
@@ -1387,6 +1419,13 @@ void TACSApproximateSchur::setMonitor(KSMPrint *ksm_print) {
   Factor preconditioner based on the values in the matrix.
 */
 void TACSApproximateSchur::factor() {
+  TACS_PROFILE_SCOPE("TACSApproximateSchur::factor");
+  if (dry_run) {
+    fprintf(stderr,
+            "TACSApproximateSchur error: Cannot factor a preconditioner "
+            "created in dry-run mode\n");
+    return;
+  }
   Apc->copyValues(Aloc);
   if (alpha != 0.0) {
     Apc->addDiag(alpha);
@@ -1505,6 +1544,13 @@ void TACSApproximateSchur::printNzPattern(const char *fileName) {
   x_i = U_b^{-1} L_b^{-1} ( f_i - E * y_i)
 */
 void TACSApproximateSchur::applyFactor(TACSVec *txvec, TACSVec *tyvec) {
+  TACS_PROFILE_SCOPE("TACSApproximateSchur::applyFactor");
+  if (dry_run) {
+    fprintf(stderr,
+            "TACSApproximateSchur error: Cannot apply a preconditioner "
+            "created in dry-run mode\n");
+    return;
+  }
   TACSBVec *xvec, *yvec;
   xvec = dynamic_cast<TACSBVec *>(txvec);
   yvec = dynamic_cast<TACSBVec *>(tyvec);
@@ -1730,6 +1776,7 @@ TACSBlockCyclicPc::TACSBlockCyclicPc(TACSParallelMat *_mat,
   bcyclic = new TACSBlockCyclicMat(comm, N, N, bsize, csr_vars, n, rowp, cols,
                                    blocks_per_block, reorder_blocks);
   bcyclic->incref();
+  dry_run = TACSMemoryTracker::isDryRun();
 
   delete[] csr_vars;
   delete[] rowp;
@@ -1778,6 +1825,12 @@ TACSBlockCyclicPc::~TACSBlockCyclicPc() {
 
 // Apply the preconditioner to x, to produce y
 void TACSBlockCyclicPc::applyFactor(TACSVec *tx, TACSVec *ty) {
+  if (dry_run) {
+    fprintf(stderr,
+            "TACSBlockCyclicPc error: Cannot apply a preconditioner "
+            "created in dry-run mode\n");
+    return;
+  }
   TACSBVec *x, *y;
   x = dynamic_cast<TACSBVec *>(tx);
   y = dynamic_cast<TACSBVec *>(ty);
@@ -1806,6 +1859,13 @@ void TACSBlockCyclicPc::applyFactor(TACSVec *tx, TACSVec *ty) {
 
 // Factor (or set up) the preconditioner
 void TACSBlockCyclicPc::factor() {
+  if (dry_run) {
+    fprintf(stderr,
+            "TACSBlockCyclicPc error: Cannot factor a preconditioner "
+            "created in dry-run mode\n");
+    return;
+  }
+
   bcyclic->zeroEntries();
 
   int mpi_size, mpi_rank;
@@ -238,6 +238,7 @@ class TACSAdditiveSchwarz : public TACSPc {
   BCSRMat *Aloc;
   TacsScalar alpha;
   BCSRMat *Apc;
+  int dry_run;  // Created in dry-run mode, cannot be factored
 };
 
 /*
@@ -302,6 +303,7 @@ class TACSApproximateSchur : public TACSPc {
   TACSParallelMat *mat;
   BCSRMat *Aloc, *Apc;
   TacsScalar alpha;
+  int dry_run;  // Created in dry-run mode, cannot be factored
 
   // Offsets into the array
   int start, end, var_offset;
@@ -336,6 +338,7 @@ class TACSBlockCyclicPc : public TACSPc {
   TacsScalar *rhs_array;
   TACSBVecDistribute *vec_dist;
   TACSBVecDistCtx *vec_ctx;
+  int dry_run;  // Created in dry-run mode, cannot be factored
 };
 
 #endif  // TACS_PARALLEL_MATRIX_H
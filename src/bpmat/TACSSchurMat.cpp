@@ -18,6 +18,8 @@
 
 #include "TACSSchurMat.h"
 
+#include "TACSMemoryTracker.h"
+#include "TACSProfiler.h"
 #include "TacsUtilities.h"
 #include "tacslapack.h"
 
@@ -397,6 +399,13 @@ void TACSSchurMat::init(TACSNodeMap *_rmap, BCSRMat *_B, BCSRMat *_E,
   ylocal = new TacsScalar[local_size];
   memset(xlocal, 0, local_size * sizeof(TacsScalar));
   memset(ylocal, 0, local_size * sizeof(TacsScalar));
+
+  // Record the memory for the matrices as part of this matrix
+  addMemoryUsage(2.0 * local_size * sizeof(TacsScalar));
+  B->setMemoryOwner(matName);
+  E->setMemoryOwner(matName);
+  F->setMemoryOwner(matName);
+  C->setMemoryOwner(matName);
 }
 
 /*
@@ -881,6 +890,7 @@ void TACSSchurMat::addDiag(TacsScalar alpha) {
   10) Wait for communication with global y vector to finish
 */
 void TACSSchurMat::mult(TACSVec *txvec, TACSVec *tyvec) {
+  TACS_PROFILE_SCOPE("TACSSchurMat::mult");
   tyvec->zeroEntries();
 
   // Safely down-cast the TACSVec vectors to TACSBVecs
@@ -1004,6 +1014,10 @@ void TACSSchurMat::getBCSRMat(BCSRMat **_B, BCSRMat **_E, BCSRMat **_F,
   }
 }
 
+const char *TACSSchurMat::getObjectName() { return matName; }
+
+const char *TACSSchurMat::matName = "TACSSchurMat";
+
 /*!
   The Global Schur preconditioner. Some assembly required.
 
@@ -1035,6 +1049,10 @@ TACSSchurPc::TACSSchurPc(TACSSchurMat *_mat, int levFill, double fill,
   monitor_factor = 0;
   monitor_back_solve = 0;
 
+  // In dry-run mode, the fill-in is computed but the values of the
+  // factor are not allocated
+  dry_run = TACSMemoryTracker::isDryRun();
+
   // By default use the less-memory intensive option
   use_cyclic_alltoall = 0;
 
@@ -1064,6 +1082,10 @@ TACSSchurPc::TACSSchurPc(TACSSchurMat *_mat, int levFill, double fill,
   Epc->incref();
   Fpc->incref();
   Sc->incref();
+  Bpc->setMemoryOwner(pcName);
+  Epc->setMemoryOwner(pcName);
+  Fpc->setMemoryOwner(pcName);
+  Sc->setMemoryOwner(pcName);
 
   // Determine the ordering for the global Schur variables
   // -----------------------------------------------------
@@ -1314,6 +1336,10 @@ TACSSchurPc::TACSSchurPc(TACSSchurMat *_mat, int levFill, double fill,
   gschur = new TACSBVec(schur_map, bsize);
   yschur->incref();
   gschur->incref();
+  yschur->setMemoryOwner(pcName);
+  gschur->setMemoryOwner(pcName);
+
+  addMemoryUsage(1.0 * (xsize + ysize) * sizeof(TacsScalar));
 }
 
 /*
@@ -1450,6 +1476,10 @@ void TACSSchurPc::getBCSRMat(BCSRMat **_Bpc, BCSRMat **_Epc, BCSRMat **_Fpc,
   }
 }
 
+const char *TACSSchurPc::getObjectName() { return pcName; }
+
+const char *TACSSchurPc::pcName = "TACSSchurPc";
+
 /*
   Set the flag that prints out the factorization time
 
@@ -1508,6 +1538,14 @@ void TACSSchurPc::setAlltoallAssemblyFlag(int flag) {
   Factor the preconditioner for this matrix (pc).
 */
 void TACSSchurPc::factor() {
+  TACS_PROFILE_SCOPE("TACSSchurPc::factor");
+  if (dry_run) {
+    fprintf(stderr,
+            "TACSSchurPc error: Cannot factor a preconditioner created in "
+            "dry-run mode\n");
+    return;
+  }
+
   // Set the time variables
   double diag_factor_time = 0.0;
   double schur_complement_time = 0.0;
@@ -1627,6 +1665,14 @@ void TACSSchurPc::factor() {
   4. Compute x <- U^{-1} (x - L^{-1} E * y) = U^{-1} (x - Epc * y)
 */
 void TACSSchurPc::applyFactor(TACSVec *tin, TACSVec *tout) {
+  TACS_PROFILE_SCOPE("TACSSchurPc::applyFactor");
+  if (dry_run) {
+    fprintf(stderr,
+            "TACSSchurPc error: Cannot apply a preconditioner created in "
+            "dry-run mode\n");
+    return;
+  }
+
   // First, perform a safe down-cast from TACSVec to BVec
   TACSBVec *invec, *outvec;
   invec = dynamic_cast<TACSBVec *>(tin);
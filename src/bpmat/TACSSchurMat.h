@@ -101,6 +101,7 @@ class TACSSchurMat : public TACSMat {
   TACSBVecDistribute *getLocalMap() { return b_map; }
   TACSBVecDistribute *getSchurMap() { return c_map; }
   TACSNodeMap *getNodeMap() { return rmap; }
+  const char *getObjectName();
 
  protected:
   TACSSchurMat();
@@ -170,6 +171,7 @@ class TACSSchurPc : public TACSPc {
   // ----------------------------------------------
   void getBCSRMat(BCSRMat **_Bpc, BCSRMat **_Epc, BCSRMat **_Fpc,
                   BCSRMat **_Sc);
+  const char *getObjectName();
 
  private:
   TACSSchurMat *mat;
@@ -184,6 +186,7 @@ class TACSSchurPc : public TACSPc {
 
   int monitor_factor;      // Monitor the factorization time
   int monitor_back_solve;  // Monitor the back-solves
+  int dry_run;             // Created in dry-run mode, cannot be factored
 
   // The sparse block cyclic matrix
   TACSBlockCyclicMat *bcyclic;  // This stores the Schur complement
@@ -210,6 +213,7 @@ class TACSSchurPc : public TACSPc {
   TacsScalar *xlocal;         // The local variables
   TacsScalar *yinterface;     // The interface variables
   TACSBVec *gschur, *yschur;  // The Schur complement vectors
+  static const char *pcName;
 };
 
 #endif  // TACS_SCHUR_MATRIX_H
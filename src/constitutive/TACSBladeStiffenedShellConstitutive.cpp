@@ -215,6 +215,16 @@ TACSBladeStiffenedShellConstitutive::TACSBladeStiffenedShellConstitutive(
   // Arrays for storing ply failure sensitivities
   this->panelPlyFailSens = new TacsScalar[2 * this->numPanelPlies];
   this->stiffenerPlyFailSens = new TacsScalar[2 * this->numStiffenerPlies];
+
+  // The critical panel buckling loads and their gradients are computed on
+  // demand and cached until the design changes
+  for (int ii = 0; ii < 2; ii++) {
+    this->critLoadVersion[ii] = -1;
+    this->critLoadSensVersion[ii] = -1;
+  }
+  memset(this->critLoads, 0, 4 * sizeof(TacsScalar));
+  this->critLoadDVSens = nullptr;
+  this->critLoadDVSensSize = 0;
 }
 
 // ==============================================================================
@@ -286,6 +296,9 @@ TACSBladeStiffenedShellConstitutive::~TACSBladeStiffenedShellConstitutive() {
   delete[] this->stiffenerPlyFailSens;
   this->stiffenerPlyFailSens = nullptr;
 
+  delete[] this->critLoadDVSens;
+  this->critLoadDVSens = nullptr;
+
   delete[] this->panelQMats;
   this->panelQMats = nullptr;
   delete[] this->panelAbarMats;
@@ -346,6 +359,7 @@ void TACSBladeStiffenedShellConstitutive::setStiffenerPlyFractions(
   for (int ii = 0; ii < this->numStiffenerPlies; ii++) {
     this->stiffenerPlyFracs[ii] = plyFractions[ii];
   }
+  this->updateDesignVersion();
 }
 
 void TACSBladeStiffenedShellConstitutive::setPanelPlyFractions(
@@ -353,6 +367,7 @@ void TACSBladeStiffenedShellConstitutive::setPanelPlyFractions(
   for (int ii = 0; ii < this->numPanelPlies; ii++) {
     this->panelPlyFracs[ii] = plyFractions[ii];
   }
+  this->updateDesignVersion();
 }
 
 // ==============================================================================
@@ -421,6 +436,7 @@ int TACSBladeStiffenedShellConstitutive::setDesignVars(int elemIndex, int dvLen,
         this->stiffenerPlyFracs[ii] = dvs[this->stiffenerPlyFracLocalNums[ii]];
       }
     }
+    this->updateDesignVersion();
   }
   return this->numDesignVars;
 }
@@ -732,7 +748,7 @@ void TACSBladeStiffenedShellConstitutive::evalStress(int elemIndex,
 
   // Just compute the stiffness matrix and multiply by the strain
   TacsScalar C[NUM_TANGENT_STIFFNESS_ENTRIES];
-  this->computeStiffness(C);
+  this->evalTangentStiffness(elemIndex, pt, X, C);
   TacsScalar *A = &C[0];
   TacsScalar *B = &C[6];
   TacsScalar *D = &C[12];
@@ -829,6 +845,9 @@ void TACSBladeStiffenedShellConstitutive::addStressDVSens(
 // Evaluate the tangent stiffness
 void TACSBladeStiffenedShellConstitutive::evalTangentStiffness(
     int elemIndex, const double pt[], const TacsScalar X[], TacsScalar C[]) {
+  if (this->getCachedTangentStiffness(C)) {
+    return;
+  }
   this->computeStiffness(C);
 }
 
@@ -2031,15 +2050,69 @@ void TACSBladeStiffenedShellConstitutive::computeStiffenerMOISens(
 // Buckling functions
 // ==============================================================================
 
-TacsScalar TACSBladeStiffenedShellConstitutive::evalGlobalPanelBuckling(
-    const TacsScalar e[]) {
-  TacsScalar stress[TACSShellConstitutive::NUM_STRESSES];
+void TACSBladeStiffenedShellConstitutive::getCriticalPanelLoads(
+    int mode, TacsScalar *N1Crit, TacsScalar *N12Crit) {
+  if (this->critLoadVersion[mode] != this->designVersion) {
+    if (mode == LOCAL_PANEL_BUCKLING) {
+      this->computeCriticalLocalPanelLoads(&this->critLoads[0],
+                                           &this->critLoads[1]);
+    } else {
+      this->computeCriticalGlobalPanelLoads(&this->critLoads[2],
+                                            &this->critLoads[3]);
+    }
+    this->critLoadVersion[mode] = this->designVersion;
+  }
+  *N1Crit = this->critLoads[2 * mode];
+  *N12Crit = this->critLoads[2 * mode + 1];
+}
+
+void TACSBladeStiffenedShellConstitutive::addCriticalPanelLoadsDVSens(
+    int mode, TacsScalar scale, TacsScalar dfdN1Crit, TacsScalar dfdN12Crit,
+    TacsScalar dfdx[]) {
+  const int n = this->numDesignVars;
+  if (this->critLoadDVSensSize != n) {
+    delete[] this->critLoadDVSens;
+    this->critLoadDVSens = new TacsScalar[4 * n];
+    this->critLoadDVSensSize = n;
+    this->critLoadSensVersion[0] = this->critLoadSensVersion[1] = -1;
+  }
+
+  // Compute the gradients of the two critical loads by seeding each one in
+  // turn, the derivatives are linear in the seeds
+  TacsScalar *dN1dx = &this->critLoadDVSens[2 * mode * n];
+  TacsScalar *dN12dx = &this->critLoadDVSens[(2 * mode + 1) * n];
+  if (this->critLoadSensVersion[mode] != this->designVersion) {
+    memset(dN1dx, 0, 2 * n * sizeof(TacsScalar));
+    if (mode == LOCAL_PANEL_BUCKLING) {
+      this->addCriticalLocalPanelLoadsDVSens(1.0, 1.0, 0.0, dN1dx);
+      this->addCriticalLocalPanelLoadsDVSens(1.0, 0.0, 1.0, dN12dx);
+    } else {
+      this->addCriticalGlobalPanelLoadsDVSens(1.0, 1.0, 0.0, dN1dx);
+      this->addCriticalGlobalPanelLoadsDVSens(1.0, 0.0, 1.0, dN12dx);
+    }
+    this->critLoadSensVersion[mode] = this->designVersion;
+  }
+
+  for (int ii = 0; ii < n; ii++) {
+    dfdx[ii] += scale * (dfdN1Crit * dN1dx[ii] + dfdN12Crit * dN12dx[ii]);
+  }
+}
+
+void TACSBladeStiffenedShellConstitutive::computeCriticalGlobalPanelLoads(
+    TacsScalar *N1Crit, TacsScalar *N12Crit) {
   TacsScalar D1, D2, D3;
   this->computeCriticalGlobalBucklingStiffness(&D1, &D2, &D3);
   const TacsScalar L = this->panelLength;
 
-  const TacsScalar N1Crit = computeCriticalGlobalAxialLoad(D1, L);
-  const TacsScalar N12Crit = this->computeCriticalShearLoad(D1, D2, D3, L);
+  *N1Crit = computeCriticalGlobalAxialLoad(D1, L);
+  *N12Crit = this->computeCriticalShearLoad(D1, D2, D3, L);
+}
+
+TacsScalar TACSBladeStiffenedShellConstitutive::evalGlobalPanelBuckling(
+    const TacsScalar e[]) {
+  TacsScalar stress[TACSShellConstitutive::NUM_STRESSES];
+  TacsScalar N1Crit, N12Crit;
+  this->getCriticalPanelLoads(GLOBAL_PANEL_BUCKLING, &N1Crit, &N12Crit);
 
   this->evalStress(0, NULL, NULL, e, stress);
   return this->bucklingEnvelope(-stress[0], N1Crit, stress[2], N12Crit);
@@ -2111,11 +2184,9 @@ TACSBladeStiffenedShellConstitutive::evalGlobalPanelBucklingStrainSens(
   this->extractTangentStiffness(stiffness, &A, &B, &D, &As, &drill);
   this->computeStress(A, B, D, As, drill, e, stress);
   TacsScalar N1GlobalSens, N1CritGlobalSens, N12GlobalSens, N12CritGlobalSens;
-  TacsScalar D1, D2, D3;
-  this->computeCriticalGlobalBucklingStiffness(&D1, &D2, &D3);
-  const TacsScalar L = this->panelLength;
-  TacsScalar N1CritGlobal = computeCriticalGlobalAxialLoad(D1, L);
-  TacsScalar N12CritGlobal = this->computeCriticalShearLoad(D1, D2, D3, L);
+  TacsScalar N1CritGlobal, N12CritGlobal;
+  this->getCriticalPanelLoads(GLOBAL_PANEL_BUCKLING, &N1CritGlobal,
+                              &N12CritGlobal);
 
   const TacsScalar strengthRatio = this->bucklingEnvelopeSens(
       -stress[0], N1CritGlobal, stress[2], N12CritGlobal, &N1GlobalSens,
@@ -2137,12 +2208,8 @@ void TACSBladeStiffenedShellConstitutive::addGlobalPanelBucklingDVSens(
   TacsScalar stress[NUM_STRESSES];
   this->evalStress(0, NULL, NULL, strain, stress);
   TacsScalar dfdN1Global, dfdN12Global, dfdN1CritGlobal, dfdN12CritGlobal;
-  TacsScalar D1, D2, D3;
   TacsScalar N1Crit, N12Crit;
-  this->computeCriticalGlobalBucklingStiffness(&D1, &D2, &D3);
-  const TacsScalar L = this->panelLength;
-  N1Crit = computeCriticalGlobalAxialLoad(D1, L);
-  N12Crit = this->computeCriticalShearLoad(D1, D2, D3, L);
+  this->getCriticalPanelLoads(GLOBAL_PANEL_BUCKLING, &N1Crit, &N12Crit);
 
   this->bucklingEnvelopeSens(-stress[0], N1Crit, stress[2], N12Crit,
                              &dfdN1Global, &dfdN1CritGlobal, &dfdN12Global,
@@ -2159,6 +2226,17 @@ void TACSBladeStiffenedShellConstitutive::addGlobalPanelBucklingDVSens(
 
   // Propogate the sensitivity of the buckling failure criteria w.r.t the
   // critical loads back to the DVs
+  this->addCriticalPanelLoadsDVSens(GLOBAL_PANEL_BUCKLING, scale,
+                                    dfdN1CritGlobal, dfdN12CritGlobal, dfdx);
+}
+
+void TACSBladeStiffenedShellConstitutive::addCriticalGlobalPanelLoadsDVSens(
+    TacsScalar scale, TacsScalar dfdN1CritGlobal, TacsScalar dfdN12CritGlobal,
+    TacsScalar dfdx[]) {
+  TacsScalar D1, D2, D3;
+  this->computeCriticalGlobalBucklingStiffness(&D1, &D2, &D3);
+  const TacsScalar L = this->panelLength;
+
   TacsScalar dfdD1, dfdD2, dfdD3, dfdPanelLength;
   this->computeCriticalShearLoadSens(D1, D2, D3, L, &dfdD1, &dfdD2, &dfdD3,
                                      &dfdPanelLength);
@@ -2677,24 +2755,31 @@ void TACSBladeStiffenedShellConstitutive::testGlobalBucklingStiffnessSens() {
 
 TacsScalar TACSBladeStiffenedShellConstitutive::evalLocalPanelBuckling(
     const TacsScalar e[]) {
-  // Compute panel stiffness matrix and loads
-  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES],
-      stress[NUM_STRESSES];
+  // Compute panel loads
+  TacsScalar stress[NUM_STRESSES];
+  this->computePanelStress(e, stress);
+
+  // Get the critical local loads
+  TacsScalar N1Crit, N12Crit;
+  this->getCriticalPanelLoads(LOCAL_PANEL_BUCKLING, &N1Crit, &N12Crit);
+
+  // Compute the buckling criteria
+  return this->bucklingEnvelope(-stress[0], N1Crit, stress[2], N12Crit);
+}
+
+void TACSBladeStiffenedShellConstitutive::computeCriticalLocalPanelLoads(
+    TacsScalar *N1Crit, TacsScalar *N12Crit) {
+  // Compute panel stiffness matrix
+  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES];
   this->computePanelStiffness(panelStiffness);
   const TacsScalar *A, *D;
   this->extractTangentStiffness(panelStiffness, &A, NULL, &D, NULL, NULL);
-  this->computePanelStress(e, stress);
 
   // Compute the critical local loads
   const TacsScalar D11 = D[0], D12 = D[1], D22 = D[3], D66 = D[5],
                    L = this->stiffenerPitch;
-  const TacsScalar N1Crit =
-      this->computeCriticalLocalAxialLoad(D11, D22, D12, D66, L);
-  const TacsScalar N12Crit =
-      this->computeCriticalShearLoad(D11, D22, D12 + 2.0 * D66, L);
-
-  // Compute the buckling criteria
-  return this->bucklingEnvelope(-stress[0], N1Crit, stress[2], N12Crit);
+  *N1Crit = this->computeCriticalLocalAxialLoad(D11, D22, D12, D66, L);
+  *N12Crit = this->computeCriticalShearLoad(D11, D22, D12 + 2.0 * D66, L);
 }
 
 TacsScalar TACSBladeStiffenedShellConstitutive::computeCriticalShearLoad(
@@ -2733,13 +2818,11 @@ TACSBladeStiffenedShellConstitutive::evalLocalPanelBucklingStrainSens(
                                 NULL);
   this->computePanelStress(e, panelStress);
 
-  // Compute the critical local loads (no need to compute their
+  // Get the critical local loads (no need to compute their
   // sensitivities because they're not dependent on the strain))
   TacsScalar N1CritLocal, N12CritLocal;
-  TacsScalar D11 = DPanel[0], D12 = DPanel[1], D22 = DPanel[3], D66 = DPanel[5],
-             L = this->stiffenerPitch;
-  N1CritLocal = this->computeCriticalLocalAxialLoad(D11, D22, D12, D66, L);
-  N12CritLocal = this->computeCriticalShearLoad(D11, D22, D12 + 2.0 * D66, L);
+  this->getCriticalPanelLoads(LOCAL_PANEL_BUCKLING, &N1CritLocal,
+                              &N12CritLocal);
 
   // Compute the buckling criteria and it's sensitivities
   TacsScalar N1LocalSens, N12LocalSens, N1CritLocalSens, N12CritLocalSens;
@@ -2760,32 +2843,13 @@ TACSBladeStiffenedShellConstitutive::evalLocalPanelBucklingStrainSens(
 void TACSBladeStiffenedShellConstitutive::addLocalPanelBucklingDVSens(
     int elemIndex, TacsScalar scale, const double pt[], const TacsScalar X[],
     const TacsScalar strain[], int dvLen, TacsScalar dfdx[]) {
-  // Compute panel stiffness matrix and loads
-  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES],
-      panelStress[NUM_STRESSES];
-  const TacsScalar t = this->panelThick;
-  this->computePanelStiffness(panelStiffness);
-  const TacsScalar *A, *D;
-  this->extractTangentStiffness(panelStiffness, &A, NULL, &D, NULL, NULL);
+  // Compute panel loads
+  TacsScalar panelStress[NUM_STRESSES];
   this->computePanelStress(strain, panelStress);
 
-  // Compute the critical local loads and their sensitivities
+  // Get the critical local loads
   TacsScalar N1Crit, N12Crit;
-  const TacsScalar D11 = D[0], D12 = D[1], D22 = D[3], D66 = D[5],
-                   L = this->stiffenerPitch;
-
-  // Create arrays for the sensitivities of the critical loads:
-  // [dN/dD11, dNdD22, dNdD12, dNdD66, dNdL]
-  TacsScalar N1CritSens[5], N12CritSens[5];
-  N1Crit = this->computeCriticalLocalAxialLoadSens(
-      D11, D22, D12, D66, L, &N1CritSens[0], &N1CritSens[1], &N1CritSens[2],
-      &N1CritSens[3], &N1CritSens[4]);
-  N12Crit = this->computeCriticalShearLoadSens(
-      D11, D22, D12 + 2.0 * D66, L, &N12CritSens[0], &N12CritSens[1],
-      &N12CritSens[2], &N12CritSens[4]);
-
-  // N12CritSens[2] is currently dN12Crit/d(D12 + 2D66)
-  N12CritSens[3] = 2.0 * N12CritSens[2];
+  this->getCriticalPanelLoads(LOCAL_PANEL_BUCKLING, &N1Crit, &N12Crit);
 
   // Compute the buckling criteria and it's sensitivities to the applied and
   // critical loads
@@ -2801,6 +2865,39 @@ void TACSBladeStiffenedShellConstitutive::addLocalPanelBucklingDVSens(
   this->addPanelStressDVSens(scale, strain, dfdPanelStress,
                              &dfdx[this->panelDVStartNum]);
 
+  // Propogate the sensitivity of the buckling failure criteria w.r.t the
+  // critical loads back to the DVs
+  this->addCriticalPanelLoadsDVSens(LOCAL_PANEL_BUCKLING, scale,
+                                    dfdN1CritLocal, dfdN12CritLocal, dfdx);
+}
+
+void TACSBladeStiffenedShellConstitutive::addCriticalLocalPanelLoadsDVSens(
+    TacsScalar scale, TacsScalar dfdN1CritLocal, TacsScalar dfdN12CritLocal,
+    TacsScalar dfdx[]) {
+  // Compute panel stiffness matrix
+  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES];
+  const TacsScalar t = this->panelThick;
+  this->computePanelStiffness(panelStiffness);
+  const TacsScalar *A, *D;
+  this->extractTangentStiffness(panelStiffness, &A, NULL, &D, NULL, NULL);
+
+  // Compute the sensitivities of the critical local loads
+  const TacsScalar D11 = D[0], D12 = D[1], D22 = D[3], D66 = D[5],
+                   L = this->stiffenerPitch;
+
+  // Create arrays for the sensitivities of the critical loads:
+  // [dN/dD11, dNdD22, dNdD12, dNdD66, dNdL]
+  TacsScalar N1CritSens[5], N12CritSens[5];
+  this->computeCriticalLocalAxialLoadSens(D11, D22, D12, D66, L, &N1CritSens[0],
+                                          &N1CritSens[1], &N1CritSens[2],
+                                          &N1CritSens[3], &N1CritSens[4]);
+  this->computeCriticalShearLoadSens(D11, D22, D12 + 2.0 * D66, L,
+                                     &N12CritSens[0], &N12CritSens[1],
+                                     &N12CritSens[2], &N12CritSens[4]);
+
+  // N12CritSens[2] is currently dN12Crit/d(D12 + 2D66)
+  N12CritSens[3] = 2.0 * N12CritSens[2];
+
   // Convert the sensitivities of  the critical loads w.r.t the D matrix
   // entries to sensitivities of the buckling failure criteria w.r.t the D
   // matrix entries
@@ -3077,6 +3174,88 @@ bool TACSBladeStiffenedShellConstitutive::testBucklingEnvelopeSens(
           fabs(dfdN12RelError) < tol && fabs(dfdN12CritRelError) < tol);
 }
 
+TacsScalar TACSBladeStiffenedShellConstitutive::testCriticalPanelLoadCache(
+    int printLevel) {
+  const int n = this->numDesignVars;
+  const TacsScalar scale = 0.7, dfdN1Crit = 1.3, dfdN12Crit = -0.4;
+  TacsScalar *dfdx = new TacsScalar[n];
+  TacsScalar *dfdxRef = new TacsScalar[n];
+
+  if (printLevel != 0) {
+    printf("\nTACSBladeStiffened..testCriticalPanelLoadCache start::\n");
+    printf("--------------------------------------------------------\n\n");
+  }
+
+  TacsScalar maxRelError = 0.0;
+  for (int mode = 0; mode < 2; mode++) {
+    // compute the critical loads and their gradient directly
+    TacsScalar N1CritRef, N12CritRef;
+    memset(dfdxRef, 0, n * sizeof(TacsScalar));
+    if (mode == LOCAL_PANEL_BUCKLING) {
+      this->computeCriticalLocalPanelLoads(&N1CritRef, &N12CritRef);
+      this->addCriticalLocalPanelLoadsDVSens(scale, dfdN1Crit, dfdN12Crit,
+                                             dfdxRef);
+    } else {
+      this->computeCriticalGlobalPanelLoads(&N1CritRef, &N12CritRef);
+      this->addCriticalGlobalPanelLoadsDVSens(scale, dfdN1Crit, dfdN12Crit,
+                                              dfdxRef);
+    }
+
+    // the gradient error is relative to the largest gradient entry
+    TacsScalar dfdxMax = 0.0;
+    for (int ii = 0; ii < n; ii++) {
+      if (fabs(TacsRealPart(dfdxRef[ii])) > TacsRealPart(dfdxMax)) {
+        dfdxMax = fabs(TacsRealPart(dfdxRef[ii]));
+      }
+    }
+
+    for (int rep = 0; rep < 2; rep++) {
+      TacsScalar N1Crit, N12Crit;
+      this->getCriticalPanelLoads(mode, &N1Crit, &N12Crit);
+      memset(dfdx, 0, n * sizeof(TacsScalar));
+      this->addCriticalPanelLoadsDVSens(mode, scale, dfdN1Crit, dfdN12Crit,
+                                        dfdx);
+
+      TacsScalar relError =
+          fabs(TacsRealPart((N1Crit - N1CritRef) / N1CritRef));
+      TacsScalar err = fabs(TacsRealPart((N12Crit - N12CritRef) / N12CritRef));
+      if (TacsRealPart(err) > TacsRealPart(relError)) {
+        relError = err;
+      }
+      for (int ii = 0; ii < n; ii++) {
+        err = fabs(TacsRealPart(dfdx[ii] - dfdxRef[ii]));
+        if (TacsRealPart(dfdxMax) != 0.0) {
+          err /= TacsRealPart(dfdxMax);
+        }
+        if (TacsRealPart(err) > TacsRealPart(relError)) {
+          relError = err;
+        }
+      }
+      if (TacsRealPart(relError) > TacsRealPart(maxRelError)) {
+        maxRelError = relError;
+      }
+
+      if (printLevel != 0) {
+        printf("\t%s panel loads, call %d: N1Crit = %.8e, N12Crit = %.8e\n",
+               mode == LOCAL_PANEL_BUCKLING ? "local" : "global", rep,
+               TacsRealPart(N1Crit), TacsRealPart(N12Crit));
+        printf("\t%s panel loads, call %d rel error = %.4e\n",
+               mode == LOCAL_PANEL_BUCKLING ? "local" : "global", rep,
+               TacsRealPart(relError));
+      }
+    }
+  }
+
+  delete[] dfdx;
+  delete[] dfdxRef;
+
+  if (printLevel != 0) {
+    printf("\tOverall max rel error = %.4e\n\n", TacsRealPart(maxRelError));
+  }
+
+  return maxRelError;
+}
+
 TacsScalar TACSBladeStiffenedShellConstitutive::evalStiffenerColumnBuckling(
     const TacsScalar stiffenerStrain[]) {
   TacsScalar stiffenerStress[TACSBeamConstitutive::NUM_STRESSES];
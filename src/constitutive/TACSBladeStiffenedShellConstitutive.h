@@ -303,7 +303,10 @@ class TACSBladeStiffenedShellConstitutive : public TACSShellConstitutive {
    *
    * @param _ksWeight
    */
-  inline void setKSWeight(double _ksWeight) { this->ksWeight = _ksWeight; }
+  inline void setKSWeight(double _ksWeight) {
+    this->ksWeight = _ksWeight;
+    this->updateDesignVersion();
+  }
 
   // ==============================================================================
   // Setting/getting design variable information
@@ -460,6 +463,19 @@ class TACSBladeStiffenedShellConstitutive : public TACSShellConstitutive {
                                        const TacsScalar N12,
                                        const TacsScalar N12Crit);
 
+  /**
+   * @brief Test that the cached critical panel loads and their DV
+   * sensitivities match the values computed directly for the current design
+   *
+   * Each cached quantity is read twice, so that both the call that refreshes
+   * the cache and the call that reuses it are checked.
+   *
+   * @param printLevel an integer flag, with 0 to not print the test result to
+   * terminal and 1 to print to terminal
+   * @return the maximum relative error between the cached and direct values
+   */
+  TacsScalar testCriticalPanelLoadCache(int printLevel);
+
  protected:
   /**
    * @brief Compute the stiffness matrix of the stiffened shell
@@ -883,6 +899,87 @@ class TACSBladeStiffenedShellConstitutive : public TACSShellConstitutive {
   // Buckling functions
   // ==============================================================================
 
+  /**
+   * @brief Get the critical axial and shear loads for local or global panel
+   * buckling
+   *
+   * The critical loads only depend on the design variables of the panel, so
+   * they are computed once per design and reused at every point of every
+   * element that shares this constitutive object.
+   *
+   * @param mode LOCAL_PANEL_BUCKLING or GLOBAL_PANEL_BUCKLING
+   * @output N1Crit Critical axial load
+   * @output N12Crit Critical shear load
+   */
+  void getCriticalPanelLoads(int mode, TacsScalar *N1Crit,
+                             TacsScalar *N12Crit);
+
+  /**
+   * @brief Add the derivative of a function of the local or global critical
+   * panel loads w.r.t the design variables
+   *
+   * The gradients of the critical loads are computed once per design and
+   * reused at every point of every element that shares this constitutive
+   * object.
+   *
+   * @param mode LOCAL_PANEL_BUCKLING or GLOBAL_PANEL_BUCKLING
+   * @param scale Value by which to scale the derivatives
+   * @param dfdN1Crit Sensitivity of the output w.r.t the critical axial load
+   * @param dfdN12Crit Sensitivity of the output w.r.t the critical shear load
+   * @param dfdx The DV sensitivity array to add to
+   */
+  void addCriticalPanelLoadsDVSens(int mode, TacsScalar scale,
+                                   TacsScalar dfdN1Crit, TacsScalar dfdN12Crit,
+                                   TacsScalar dfdx[]);
+
+  /**
+   * @brief Compute the critical axial and shear loads for local buckling of
+   * the panel skin between the stiffeners (not cached)
+   *
+   * @output N1Crit Critical axial load
+   * @output N12Crit Critical shear load
+   */
+  virtual void computeCriticalLocalPanelLoads(TacsScalar *N1Crit,
+                                              TacsScalar *N12Crit);
+
+  /**
+   * @brief Add the derivative of a function of the critical local panel loads
+   * w.r.t the design variables (not cached)
+   *
+   * @param scale Value by which to scale the derivatives
+   * @param dfdN1Crit Sensitivity of the output w.r.t the critical axial load
+   * @param dfdN12Crit Sensitivity of the output w.r.t the critical shear load
+   * @param dfdx The DV sensitivity array to add to
+   */
+  virtual void addCriticalLocalPanelLoadsDVSens(TacsScalar scale,
+                                                TacsScalar dfdN1Crit,
+                                                TacsScalar dfdN12Crit,
+                                                TacsScalar dfdx[]);
+
+  /**
+   * @brief Compute the critical axial and shear loads for global buckling of
+   * the stiffened panel (not cached)
+   *
+   * @output N1Crit Critical axial load
+   * @output N12Crit Critical shear load
+   */
+  virtual void computeCriticalGlobalPanelLoads(TacsScalar *N1Crit,
+                                               TacsScalar *N12Crit);
+
+  /**
+   * @brief Add the derivative of a function of the critical global panel loads
+   * w.r.t the design variables (not cached)
+   *
+   * @param scale Value by which to scale the derivatives
+   * @param dfdN1Crit Sensitivity of the output w.r.t the critical axial load
+   * @param dfdN12Crit Sensitivity of the output w.r.t the critical shear load
+   * @param dfdx The DV sensitivity array to add to
+   */
+  virtual void addCriticalGlobalPanelLoadsDVSens(TacsScalar scale,
+                                                 TacsScalar dfdN1Crit,
+                                                 TacsScalar dfdN12Crit,
+                                                 TacsScalar dfdx[]);
+
   /**
    * @brief Compute the strength ratio for the global buckling of the panel
    *
@@ -1395,6 +1492,13 @@ class TACSBladeStiffenedShellConstitutive : public TACSShellConstitutive {
   TacsScalar *panelPlyFailSens;
   TacsScalar *stiffenerPlyFailSens;
 
+  // --- Cached critical panel buckling loads ---
+  int critLoadVersion[2];  ///< Design version of the cached critical loads
+  int critLoadSensVersion[2];  ///< Design version of the cached gradients
+  TacsScalar critLoads[4];  ///< Local and global [N1Crit, N12Crit]
+  TacsScalar *critLoadDVSens;  ///< Local and global [dN1Crit/dx, dN12Crit/dx]
+  int critLoadDVSensSize;      ///< Number of DVs in critLoadDVSens
+
   static const char *const constName;  ///< Constitutive model name
   static const int NUM_Q_ENTRIES = 6;  ///< Number of entries in the Q matrix
   static const int NUM_ABAR_ENTRIES =
@@ -1407,6 +1511,9 @@ class TACSBladeStiffenedShellConstitutive : public TACSShellConstitutive {
           ///< 4. Global panel buckling
           ///< 5. Stiffener column buckling
           ///< 6. Stiffener crippling
+  static const int LOCAL_PANEL_BUCKLING = 0;  ///< Local panel buckling loads
+  static const int GLOBAL_PANEL_BUCKLING =
+      1;  ///< Global panel buckling loads
   static constexpr TacsScalar DUMMY_FAIL_VALUE =
       -1e200;  ///< Dummy failure value used for failure modes that are disabled
 };
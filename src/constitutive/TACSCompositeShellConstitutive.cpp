@@ -21,6 +21,11 @@
 const char *TACSCompositeShellConstitutive::constName =
     "TACSCompositeShellConstitutive";
 
+/*
+  The maximum number of plies evaluated in a single failure batch
+*/
+static const int PLY_BATCH_SIZE = 32;
+
 /*
   Create the shell constitutive
 */
@@ -114,6 +119,10 @@ void TACSCompositeShellConstitutive::evalStress(int elemIndex,
                                                 const TacsScalar X[],
                                                 const TacsScalar e[],
                                                 TacsScalar s[]) {
+  if (evalCachedStress(e, s)) {
+    return;
+  }
+
   TacsScalar A[6], B[6], D[6], As[3], drill;
 
   // Zero the stiffness matrices
@@ -166,6 +175,9 @@ void TACSCompositeShellConstitutive::evalStress(int elemIndex,
 
 /*
   Compute the most critical failure criteria for the laminate
+
+  The mid-ply strains are collected into batches of consecutive plies
+  that share the same ply properties and are evaluated in a single call.
 */
 TacsScalar TACSCompositeShellConstitutive::evalFailure(
     int elemIndex, const double pt[], const TacsScalar X[],
@@ -180,16 +192,30 @@ TacsScalar TACSCompositeShellConstitutive::evalFailure(
   // Keep track of the maximum failure criterion
   TacsScalar max = 0.0;
 
-  for (int i = 0; i < num_plies; i++) {
-    TacsScalar lamStrain[3];
-    TacsScalar tp = t0 + 0.5 * ply_thickness[i];
-    getLaminaStrain(lamStrain, strain, tp);
-    TacsScalar fval = ply_props[i]->failure(ply_angles[i], lamStrain);
+  TacsScalar ex[PLY_BATCH_SIZE], ey[PLY_BATCH_SIZE], exy[PLY_BATCH_SIZE];
+  TacsScalar fail[PLY_BATCH_SIZE];
+
+  for (int i = 0; i < num_plies;) {
+    int n = 0;
+    for (; n < PLY_BATCH_SIZE && i + n < num_plies; n++) {
+      if (ply_props[i + n] != ply_props[i]) {
+        break;
+      }
+      TacsScalar tp = t0 + 0.5 * ply_thickness[i + n];
+      ex[n] = strain[0] + tp * strain[3];
+      ey[n] = strain[1] + tp * strain[4];
+      exy[n] = strain[2] + tp * strain[5];
+      t0 += ply_thickness[i + n];
+    }
+
+    ply_props[i]->failureBatch(n, &ply_angles[i], ex, ey, exy, fail);
 
-    if (TacsRealPart(fval) > TacsRealPart(max)) {
-      max = fval;
+    for (int k = 0; k < n; k++) {
+      if (TacsRealPart(fail[k]) > TacsRealPart(max)) {
+        max = fail[k];
+      }
     }
-    t0 += ply_thickness[i];
+    i += n;
   }
 
   return max;
@@ -213,23 +239,39 @@ TacsScalar TACSCompositeShellConstitutive::evalFailureStrainSens(
   // Keep track of the maximum failure criterion
   TacsScalar max = 0.0;
 
-  for (int i = 0; i < num_plies; i++) {
-    TacsScalar lamStrain[3], phi[3];
-    TacsScalar tp = t0 + 0.5 * ply_thickness[i];
-    getLaminaStrain(lamStrain, strain, tp);
-    TacsScalar fval = ply_props[i]->failure(ply_angles[i], lamStrain);
-    ply_props[i]->failureStrainSens(ply_angles[i], lamStrain, phi);
-
-    if (TacsRealPart(fval) > TacsRealPart(max)) {
-      max = fval;
-      sens[0] = phi[0];
-      sens[1] = phi[1];
-      sens[2] = phi[2];
-      sens[3] = tp * phi[0];
-      sens[4] = tp * phi[1];
-      sens[5] = tp * phi[2];
+  TacsScalar ex[PLY_BATCH_SIZE], ey[PLY_BATCH_SIZE], exy[PLY_BATCH_SIZE];
+  TacsScalar tp[PLY_BATCH_SIZE], fail[PLY_BATCH_SIZE];
+  TacsScalar dfdex[PLY_BATCH_SIZE], dfdey[PLY_BATCH_SIZE];
+  TacsScalar dfdexy[PLY_BATCH_SIZE];
+
+  for (int i = 0; i < num_plies;) {
+    int n = 0;
+    for (; n < PLY_BATCH_SIZE && i + n < num_plies; n++) {
+      if (ply_props[i + n] != ply_props[i]) {
+        break;
+      }
+      tp[n] = t0 + 0.5 * ply_thickness[i + n];
+      ex[n] = strain[0] + tp[n] * strain[3];
+      ey[n] = strain[1] + tp[n] * strain[4];
+      exy[n] = strain[2] + tp[n] * strain[5];
+      t0 += ply_thickness[i + n];
     }
-    t0 += ply_thickness[i];
+
+    ply_props[i]->failureStrainSensBatch(n, &ply_angles[i], ex, ey, exy, fail,
+                                         dfdex, dfdey, dfdexy);
+
+    for (int k = 0; k < n; k++) {
+      if (TacsRealPart(fail[k]) > TacsRealPart(max)) {
+        max = fail[k];
+        sens[0] = dfdex[k];
+        sens[1] = dfdey[k];
+        sens[2] = dfdexy[k];
+        sens[3] = tp[k] * dfdex[k];
+        sens[4] = tp[k] * dfdey[k];
+        sens[5] = tp[k] * dfdexy[k];
+      }
+    }
+    i += n;
   }
 
   return max;
@@ -250,6 +292,10 @@ void TACSCompositeShellConstitutive::evalTangentStiffness(int elemIndex,
                                                           const double pt[],
                                                           const TacsScalar X[],
                                                           TacsScalar C[]) {
+  if (getCachedTangentStiffness(C)) {
+    return;
+  }
+
   TacsScalar *A = &C[0];
   TacsScalar *B = &C[6];
   TacsScalar *D = &C[12];
@@ -30,6 +30,52 @@ const char *TACSConstitutive::constName = "TACSConstitutive";
 */
 const char *TACSConstitutive::getObjectName() { return constName; }
 
+/*
+  Evaluate the derivative of the density along the design direction
+  from the design variable sensitivity of the density
+*/
+TacsScalar TACSConstitutive::evalDensityDVSensVecProduct(
+    int elemIndex, const double pt[], const TacsScalar X[], int dvLen,
+    const TacsScalar pdx[], TacsScalar work[]) {
+  int dvSize = dvLen * getDesignVarsPerNode();
+  TacsScalar *dfdx = &work[getNumStresses()];
+  memset(dfdx, 0, dvSize * sizeof(TacsScalar));
+  addDensityDVSens(elemIndex, 1.0, pt, X, dvLen, dfdx);
+
+  TacsScalar product = 0.0;
+  for (int k = 0; k < dvSize; k++) {
+    product += dfdx[k] * pdx[k];
+  }
+  return product;
+}
+
+/*
+  Evaluate the derivative of the stress along the design direction one
+  component at a time using unit adjoint vectors
+*/
+void TACSConstitutive::evalStressDVSensVecProduct(
+    int elemIndex, const double pt[], const TacsScalar X[],
+    const TacsScalar strain[], int dvLen, const TacsScalar pdx[],
+    TacsScalar work[], TacsScalar pstress[]) {
+  int nstress = getNumStresses();
+  int dvSize = dvLen * getDesignVarsPerNode();
+  TacsScalar *psi = work;
+  TacsScalar *dfdx = &work[nstress];
+  memset(psi, 0, nstress * sizeof(TacsScalar));
+
+  for (int i = 0; i < nstress; i++) {
+    psi[i] = 1.0;
+    memset(dfdx, 0, dvSize * sizeof(TacsScalar));
+    addStressDVSens(elemIndex, 1.0, pt, X, strain, psi, dvLen, dfdx);
+    psi[i] = 0.0;
+
+    pstress[i] = 0.0;
+    for (int k = 0; k < dvSize; k++) {
+      pstress[i] += dfdx[k] * pdx[k];
+    }
+  }
+}
+
 /*
   Compute a two-dimensional representation of the failure envelope.
   Store the values in the output x_vals and y_vals.
@@ -167,6 +167,28 @@ class TACSConstitutive : public TACSObject {
     return addDensityDVSens(elemIndex, scale, pt, X, dvLen, dfdx);
   }
 
+  /**
+    Evaluate the derivative of the density along a direction in the
+    design variables
+
+    By default, this is found from addDensityDVSens. Constitutive
+    classes may override it with a direct computation.
+
+    @param elemIndex The local element index
+    @param pt The parametric location
+    @param X The point location
+    @param dvLen The length of the design vector array
+    @param pdx The design variable direction
+    @param work Scratch array of length getSensVecProductWorkSize(dvLen)
+    @return The derivative of the density along pdx
+  */
+  virtual TacsScalar evalDensityDVSensVecProduct(int elemIndex,
+                                                 const double pt[],
+                                                 const TacsScalar X[],
+                                                 int dvLen,
+                                                 const TacsScalar pdx[],
+                                                 TacsScalar work[]);
+
   /**
     Add the derivative of the pointwise mass with respect to state variables
 
@@ -357,6 +379,44 @@ class TACSConstitutive : public TACSObject {
                                const TacsScalar psi[], int dvLen,
                                TacsScalar dfdx[]) {}
 
+  /**
+    Evaluate the derivative of the stress along a direction in the
+    design variables at a fixed strain
+
+    pstress = d(stress)/dx*pdx
+
+    By default, each component is found from addStressDVSens with a
+    unit adjoint vector, which costs one call for each stress
+    component. Constitutive classes should override it with a direct
+    computation.
+
+    @param elemIndex The local element index
+    @param pt The parametric point within the element
+    @param X The physical point location
+    @param strain The strain evaluated at the point
+    @param dvLen The length of the design vector array
+    @param pdx The design variable direction
+    @param work Scratch array of length getSensVecProductWorkSize(dvLen)
+    @param pstress The derivative of the stress along pdx
+  */
+  virtual void evalStressDVSensVecProduct(int elemIndex, const double pt[],
+                                          const TacsScalar X[],
+                                          const TacsScalar strain[],
+                                          int dvLen, const TacsScalar pdx[],
+                                          TacsScalar work[],
+                                          TacsScalar pstress[]);
+
+  /**
+    Get the length of the scratch array for the design variable
+    direction products
+
+    @param dvLen The length of the design vector array
+    @return The length of the scratch array
+  */
+  int getSensVecProductWorkSize(int dvLen) {
+    return getNumStresses() + dvLen * getDesignVarsPerNode();
+  }
+
   /**
     Evaluate the tangent stiffness used for the geometric stiffness
     matrix computations.
@@ -74,6 +74,8 @@ TACSGPBladeStiffenedShellConstitutive::TACSGPBladeStiffenedShellConstitutive(
   if (this->panelGPs) {
     this->panelGPs->incref();
   }
+  this->gpPredictVersion = -1;
+  this->gpPredictSensVersion = -1;
 
   // allocate Xtest temporary vectors for each GP
   if (this->getAxialGP()) {
@@ -135,122 +137,70 @@ TACSGPBladeStiffenedShellConstitutive::
 // Override Failure constraint and sensitivities
 // ==============================================================================
 
-TacsScalar TACSGPBladeStiffenedShellConstitutive::evalLocalPanelBuckling(
-    const TacsScalar e[]) {
-  // this routine computes N11,cr for the local panel section with size a x s_p
-  // (in between stiffeners)
-
-  // compute panel stiffness matrix
-  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES],
-      panelStress[NUM_STRESSES];
-  this->computePanelStiffness(panelStiffness);
-  const TacsScalar *Ap, *Dp;
-  this->extractTangentStiffness(panelStiffness, &Ap, NULL, &Dp, NULL, NULL);
-  this->computePanelStress(e, panelStress);
-
-  // extract panel stiffnesses and dimensions
-  TacsScalar D11Local = Dp[0];
-  TacsScalar D12p = Dp[1], D66p = Dp[5], D22p = Dp[3];
-  TacsScalar A11p = Ap[0], A66p = Ap[5];
-  TacsScalar a = this->panelLength;
-  TacsScalar b = this->panelWidth;
-  TacsScalar s_p = this->stiffenerPitch;
+void TACSGPBladeStiffenedShellConstitutive::computeCriticalLocalPanelLoads(
+    TacsScalar *N1Crit, TacsScalar *N12Crit) {
+  // this routine computes N11,cr and N12,cr for the local panel section with
+  // size a x s_p (in between stiffeners)
+  this->predictPanelGPs(false);
 
   // compute non-dimensional parameters for the local panel
-  TacsScalar rho0Local = computeAffineAspectRatio(
-      D11Local, D22p, a, s_p);  // local panel is a x s_p
-  TacsScalar xiLocal = computeLaminateIsotropy(D11Local, D22p, D12p, D66p);
-  TacsScalar zetaPanel =
-      computeTransverseShearParameter(A66p, A11p, b, this->panelThick);
+  TacsScalar D11Local, D22p, rho0Local, xiLocal, zetaPanel;
+  this->computeLocalPanelBucklingParams(&D11Local, &D22p, &rho0Local, &xiLocal,
+                                        &zetaPanel);
 
   // compute the pure axial and pure shear buckling loads
-  TacsScalar N1CritLocal = computeCriticalLocalAxialLoad(
-      D11Local, D22p, rho0Local, xiLocal, zetaPanel);
-  TacsScalar N12CritLocal = computeCriticalLocalShearLoad(
-      D11Local, D22p, rho0Local, xiLocal, zetaPanel);
-
-  // compute the combined loading buckling failure index
-  return this->bucklingEnvelope(-panelStress[0], N1CritLocal, panelStress[2],
-                                N12CritLocal);
+  *N1Crit = computeCriticalLocalAxialLoad(D11Local, D22p, rho0Local, xiLocal,
+                                          zetaPanel);
+  *N12Crit = computeCriticalLocalShearLoad(D11Local, D22p, rho0Local, xiLocal,
+                                           zetaPanel);
 }
 
 TacsScalar TACSGPBladeStiffenedShellConstitutive::evalGlobalPanelBuckling(
     const TacsScalar e[]) {
-  // this routine computes N11,cr for the global panel with the stiffeners
-  // applied
-
-  // compute panel stiffness matrix
-  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES],
-      panelStress[NUM_STRESSES];
-  this->computePanelStiffness(panelStiffness);
-  const TacsScalar *Ap, *Dp;
-  this->extractTangentStiffness(panelStiffness, &Ap, NULL, &Dp, NULL, NULL);
+  // compute the in-plane panel loads
+  TacsScalar panelStress[NUM_STRESSES];
   this->computePanelStress(e, panelStress);
 
-  // compute effective moduli, overall centroid
-  TacsScalar E1s, E1p, _;
-  this->computeEffectiveModulii(this->numPanelPlies, this->panelQMats,
-                                this->panelPlyFracs, &E1p, &_);
-  this->computeEffectiveModulii(this->numStiffenerPlies, this->stiffenerQMats,
-                                this->stiffenerPlyFracs, &E1s, &_);
-  TacsScalar zn = this->computeOverallCentroid(E1p, E1s);
+  // get the pure axial and pure shear buckling loads
+  TacsScalar N1CritGlobal, N12CritGlobal;
+  this->getCriticalPanelLoads(GLOBAL_PANEL_BUCKLING, &N1CritGlobal,
+                              &N12CritGlobal);
 
-  // get the global buckling D11 with overall stiffener + panel centroid
-  TacsScalar D11Global;
-  computePanelGlobalBucklingStiffness(E1p, zn, &D11Global);
+  // compute the combined loading buckling failure index
+  return this->bucklingEnvelope(-panelStress[0], N1CritGlobal, panelStress[2],
+                                N12CritGlobal);
+}
 
-  // extract panel stiffnesses and dimensions
-  TacsScalar D12p = Dp[1], D66p = Dp[5], D22p = Dp[3];
-  TacsScalar A11p = Ap[0], A66p = Ap[5];
-  TacsScalar a = this->panelLength;
-  TacsScalar b = this->panelWidth;
-  TacsScalar s_p = this->stiffenerPitch;
+void TACSGPBladeStiffenedShellConstitutive::computeCriticalGlobalPanelLoads(
+    TacsScalar *N1Crit, TacsScalar *N12Crit) {
+  // this routine computes N11,cr and N12,cr for the global panel with the
+  // stiffeners applied
+  this->predictPanelGPs(false);
 
   // compute non-dimensional parameters for the global panel
-  TacsScalar delta = computeStiffenerAreaRatio(E1p, E1s);
-  TacsScalar rho0Global =
-      computeAffineAspectRatio(D11Global, D22p, a, b);  // global panel is a x b
-  TacsScalar xiGlobal = computeLaminateIsotropy(D11Global, D22p, D12p, D66p);
-  TacsScalar gamma = computeStiffenerStiffnessRatio(D11Global, E1s, zn);
-  TacsScalar zetaPanel =
-      computeTransverseShearParameter(A66p, A11p, b, this->panelThick);
+  TacsScalar D11Global, D22p, delta, rho0Global, xiGlobal, gamma, zetaPanel;
+  this->computeGlobalPanelBucklingParams(&D11Global, &D22p, &delta, &rho0Global,
+                                         &xiGlobal, &gamma, &zetaPanel);
+  TacsScalar b = this->panelWidth;
 
   // compute the pure axial and pure shear buckling loads
-  TacsScalar N1CritGlobal = computeCriticalGlobalAxialLoad(
-      D11Global, D22p, b, delta, rho0Global, xiGlobal, gamma, zetaPanel);
-  TacsScalar N12CritGlobal = computeCriticalGlobalShearLoad(
-      D11Global, D22p, b, rho0Global, xiGlobal, gamma, zetaPanel);
-
-  // compute the combined loading buckling failure index
-  return this->bucklingEnvelope(-panelStress[0], N1CritGlobal, panelStress[2],
-                                N12CritGlobal);
+  *N1Crit = computeCriticalGlobalAxialLoad(D11Global, D22p, b, delta,
+                                           rho0Global, xiGlobal, gamma,
+                                           zetaPanel);
+  *N12Crit = computeCriticalGlobalShearLoad(D11Global, D22p, b, rho0Global,
+                                            xiGlobal, gamma, zetaPanel);
 }
 
 TacsScalar TACSGPBladeStiffenedShellConstitutive::evalStiffenerCrippling(
     const TacsScalar stiffenerStrain[]) {
   if (CPTstiffenerCrippling) {  // use predictions for Sean's paper
-    // compute D matrix of the stiffener (treating it like a panel for
-    // crippling)
-    TacsScalar stiffenerCripplingStiffness[NUM_TANGENT_STIFFNESS_ENTRIES];
-    const TacsScalar *As_crippling, *Ds_crippling;
-    this->computeStiffenerCripplingStiffness(stiffenerCripplingStiffness);
-    this->extractTangentStiffness(stiffenerCripplingStiffness, &As_crippling,
-                                  NULL, &Ds_crippling, NULL, NULL);
+    this->predictPanelGPs(false);
 
-    // get stiffener material props and dimensions
-    TacsScalar A11s = As_crippling[0], A66s = As_crippling[5];
-    TacsScalar D11s = Ds_crippling[0], D12s = Ds_crippling[1];
-    TacsScalar D22s = Ds_crippling[3], D66s = Ds_crippling[5];
-    TacsScalar bStiff = this->stiffenerHeight;
-    TacsScalar hStiff = this->stiffenerThick;
-    TacsScalar a = this->panelLength;
-
-    // compute stiffener non-dimensional parameters
-    TacsScalar rho0Stiff = computeAffineAspectRatio(D11s, D22s, a, bStiff);
-    TacsScalar xiStiff = computeLaminateIsotropy(D11s, D22s, D12s, D66s);
-    TacsScalar genPoiss = computeGeneralizedPoissonsRatio(D12s, D66s);
-    TacsScalar zetaStiff =
-        computeTransverseShearParameter(A66s, A11s, bStiff, hStiff);
+    // compute stiffener non-dimensional parameters (treating it like a panel
+    // for crippling)
+    TacsScalar D11s, D22s, rho0Stiff, xiStiff, genPoiss, zetaStiff;
+    this->computeStiffenerCripplingParams(&D11s, &D22s, &rho0Stiff, &xiStiff,
+                                          &genPoiss, &zetaStiff);
 
     // Compute stiffener in plane load and crippling failure index
     TacsScalar A11s_beam;
@@ -269,62 +219,11 @@ TacsScalar TACSGPBladeStiffenedShellConstitutive::evalStiffenerCrippling(
   }
 }
 
-TacsScalar
-TACSGPBladeStiffenedShellConstitutive::evalLocalPanelBucklingStrainSens(
-    const TacsScalar e[], TacsScalar sens[]) {
-  // this routine computes N11,cr for the local panel section with size a x s_p
-  // (in between stiffeners)
-
-  // compute panel stiffness matrix
-  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES],
-      panelStress[NUM_STRESSES];
-  this->computePanelStiffness(panelStiffness);
-  const TacsScalar *Ap, *Dp;
-  this->extractTangentStiffness(panelStiffness, &Ap, NULL, &Dp, NULL, NULL);
-  this->computePanelStress(e, panelStress);
-
-  // extract panel stiffnesses and dimensions
-  TacsScalar D11Local = Dp[0];
-  TacsScalar D12p = Dp[1], D66p = Dp[5], D22p = Dp[3];
-  TacsScalar A11p = Ap[0], A66p = Ap[5];
-  TacsScalar a = this->panelLength;
-  TacsScalar b = this->panelWidth;
-  TacsScalar s_p = this->stiffenerPitch;
-
-  // compute non-dimensional parameters for the local panel
-  TacsScalar rho0Local = computeAffineAspectRatio(
-      D11Local, D22p, a, s_p);  // local panel is a x s_p
-  TacsScalar xiLocal = computeLaminateIsotropy(D11Local, D22p, D12p, D66p);
-  TacsScalar zetaPanel =
-      computeTransverseShearParameter(A66p, A11p, b, this->panelThick);
-
-  // compute the pure axial and pure shear buckling loads
-  TacsScalar N1CritLocal = computeCriticalLocalAxialLoad(
-      D11Local, D22p, rho0Local, xiLocal, zetaPanel);
-  TacsScalar N12CritLocal = computeCriticalLocalShearLoad(
-      D11Local, D22p, rho0Local, xiLocal, zetaPanel);
-
-  // Compute the buckling criteria and it's sensitivities
-  TacsScalar N1LocalSens, N12LocalSens, N1CritLocalSens, N12CritLocalSens;
-  const TacsScalar strengthRatio = this->bucklingEnvelopeSens(
-      -panelStress[0], N1CritLocal, panelStress[2], N12CritLocal, &N1LocalSens,
-      &N1CritLocalSens, &N12LocalSens, &N12CritLocalSens);
-
-  sens[0] = N1LocalSens * -Ap[0] + N12LocalSens * Ap[2];
-  sens[1] = N1LocalSens * -Ap[1] + N12LocalSens * Ap[4];
-  sens[2] = N1LocalSens * -Ap[2] + N12LocalSens * Ap[5];
-  for (int ii = 3; ii < NUM_STRESSES; ii++) {
-    sens[ii] = 0.0;
-  }
-
-  return strengthRatio;
-}
-
 TacsScalar
 TACSGPBladeStiffenedShellConstitutive::evalGlobalPanelBucklingStrainSens(
     const TacsScalar e[], TacsScalar sens[]) {
-  // this routine computes N11,cr for the global panel with the stiffeners
-  // applied
+  // this routine computes the strain sensitivity of the global panel buckling
+  // failure index with the stiffeners applied
 
   // compute panel stiffness matrix
   TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES],
@@ -334,39 +233,10 @@ TACSGPBladeStiffenedShellConstitutive::evalGlobalPanelBucklingStrainSens(
   this->extractTangentStiffness(panelStiffness, &Ap, NULL, &Dp, NULL, NULL);
   this->computePanelStress(e, panelStress);
 
-  // compute effective moduli, overall centroid
-  TacsScalar E1s, E1p, _;
-  this->computeEffectiveModulii(this->numPanelPlies, this->panelQMats,
-                                this->panelPlyFracs, &E1p, &_);
-  this->computeEffectiveModulii(this->numStiffenerPlies, this->stiffenerQMats,
-                                this->stiffenerPlyFracs, &E1s, &_);
-  TacsScalar zn = this->computeOverallCentroid(E1p, E1s);
-
-  // get the global buckling D11 with overall stiffener + panel centroid
-  TacsScalar D11Global;
-  computePanelGlobalBucklingStiffness(E1p, zn, &D11Global);
-
-  // extract panel stiffnesses and dimensions
-  TacsScalar D12p = Dp[1], D66p = Dp[5], D22p = Dp[3];
-  TacsScalar A11p = Ap[0], A66p = Ap[5];
-  TacsScalar a = this->panelLength;
-  TacsScalar b = this->panelWidth;
-  TacsScalar s_p = this->stiffenerPitch;
-
-  // compute non-dimensional parameters for the global panel
-  TacsScalar delta = computeStiffenerAreaRatio(E1p, E1s);
-  TacsScalar rho0Global =
-      computeAffineAspectRatio(D11Global, D22p, a, b);  // global panel is a x b
-  TacsScalar xiGlobal = computeLaminateIsotropy(D11Global, D22p, D12p, D66p);
-  TacsScalar gamma = computeStiffenerStiffnessRatio(D11Global, E1s, zn);
-  TacsScalar zetaPanel =
-      computeTransverseShearParameter(A66p, A11p, b, this->panelThick);
-
-  // compute the pure axial and pure shear buckling loads
-  TacsScalar N1CritGlobal = computeCriticalGlobalAxialLoad(
-      D11Global, D22p, b, delta, rho0Global, xiGlobal, gamma, zetaPanel);
-  TacsScalar N12CritGlobal = computeCriticalGlobalShearLoad(
-      D11Global, D22p, b, rho0Global, xiGlobal, gamma, zetaPanel);
+  // get the pure axial and pure shear buckling loads
+  TacsScalar N1CritGlobal, N12CritGlobal;
+  this->getCriticalPanelLoads(GLOBAL_PANEL_BUCKLING, &N1CritGlobal,
+                              &N12CritGlobal);
 
   // backprop sensitivities from combined loading to the in-plane loads for
   // strain sens
@@ -390,28 +260,13 @@ TacsScalar
 TACSGPBladeStiffenedShellConstitutive::evalStiffenerCripplingStrainSens(
     const TacsScalar stiffenerStrain[], TacsScalar sens[]) {
   if (CPTstiffenerCrippling) {  // use predictions for Sean's paper
-    // compute D matrix of the stiffener (treating it like a panel for
-    // crippling)
-    TacsScalar stiffenerCripplingStiffness[NUM_TANGENT_STIFFNESS_ENTRIES];
-    const TacsScalar *As_crippling, *Ds_crippling;
-    this->computeStiffenerCripplingStiffness(stiffenerCripplingStiffness);
-    this->extractTangentStiffness(stiffenerCripplingStiffness, &As_crippling,
-                                  NULL, &Ds_crippling, NULL, NULL);
-
-    // get stiffener material props and dimensions
-    TacsScalar A11s = As_crippling[0], A66s = As_crippling[5];
-    TacsScalar D11s = Ds_crippling[0], D12s = Ds_crippling[1];
-    TacsScalar D22s = Ds_crippling[3], D66s = Ds_crippling[5];
-    TacsScalar bStiff = this->stiffenerHeight;
-    TacsScalar hStiff = this->stiffenerThick;
-    TacsScalar a = this->panelLength;
+    this->predictPanelGPs(false);
 
-    // compute stiffener non-dimensional parameters
-    TacsScalar rho0Stiff = computeAffineAspectRatio(D11s, D22s, a, bStiff);
-    TacsScalar xiStiff = computeLaminateIsotropy(D11s, D22s, D12s, D66s);
-    TacsScalar genPoiss = computeGeneralizedPoissonsRatio(D12s, D66s);
-    TacsScalar zetaStiff =
-        computeTransverseShearParameter(A66s, A11s, bStiff, hStiff);
+    // compute stiffener non-dimensional parameters (treating it like a panel
+    // for crippling)
+    TacsScalar D11s, D22s, rho0Stiff, xiStiff, genPoiss, zetaStiff;
+    this->computeStiffenerCripplingParams(&D11s, &D22s, &rho0Stiff, &xiStiff,
+                                          &genPoiss, &zetaStiff);
 
     // Compute stiffener in plane load and crippling failure index
     TacsScalar A11s_beam;
@@ -439,20 +294,17 @@ TACSGPBladeStiffenedShellConstitutive::evalStiffenerCripplingStrainSens(
   }
 }
 
-void TACSGPBladeStiffenedShellConstitutive::addLocalPanelBucklingDVSens(
-    int elemIndex, TacsScalar scale, const double pt[], const TacsScalar X[],
-    const TacsScalar strain[], int dvLen, TacsScalar dfdx[]) {
-  // scale is scale * dKSdf[2] here so already backpropped to the combined
-  // axial-shear buckling load now we need to backprop through the failure
-  // computation back to the DVs
+void TACSGPBladeStiffenedShellConstitutive::addCriticalLocalPanelLoadsDVSens(
+    TacsScalar scale, TacsScalar N1CritLocalSens, TacsScalar N12CritLocalSens,
+    TacsScalar dfdx[]) {
+  // backprop from the critical local buckling loads back to the DVs
+  this->predictPanelGPs(true);
 
   // compute panel stiffness matrix
-  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES],
-      panelStress[NUM_STRESSES];
+  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES];
   this->computePanelStiffness(panelStiffness);
   const TacsScalar *Ap, *Dp;
   this->extractTangentStiffness(panelStiffness, &Ap, NULL, &Dp, NULL, NULL);
-  this->computePanelStress(strain, panelStress);
 
   // extract panel stiffnesses and dimensions
   TacsScalar D11Local = Dp[0];
@@ -469,28 +321,6 @@ void TACSGPBladeStiffenedShellConstitutive::addLocalPanelBucklingDVSens(
   TacsScalar zetaPanel =
       computeTransverseShearParameter(A66p, A11p, b, this->panelThick);
 
-  // compute the pure axial and pure shear buckling loads
-  TacsScalar N1CritLocal = computeCriticalLocalAxialLoad(
-      D11Local, D22p, rho0Local, xiLocal, zetaPanel);
-  TacsScalar N12CritLocal = computeCriticalLocalShearLoad(
-      D11Local, D22p, rho0Local, xiLocal, zetaPanel);
-
-  // backprop from combined failure index to the in-plane load sens, critical
-  // buckling load sens
-  TacsScalar N1LocalSens, N12LocalSens, N1CritLocalSens, N12CritLocalSens;
-  const TacsScalar strengthRatio = this->bucklingEnvelopeSens(
-      -panelStress[0], N1CritLocal, panelStress[2], N12CritLocal, &N1LocalSens,
-      &N1CritLocalSens, &N12LocalSens, &N12CritLocalSens);
-
-  // backprop in-plane load sens (stress sens) to the DVs
-  TacsScalar dfdPanelStress[NUM_STRESSES];
-  memset(dfdPanelStress, 0, NUM_STRESSES * sizeof(TacsScalar));
-  dfdPanelStress[0] = -N1LocalSens;
-  dfdPanelStress[2] = N12LocalSens;
-  // figure out whether this should be based on
-  this->addPanelStressDVSens(scale, strain, dfdPanelStress,
-                             &dfdx[this->panelDVStartNum]);
-
   // backprop critical buckling load sens to the material properties and the
   // non-dimensional parameters
   // --------------------------
@@ -602,13 +432,46 @@ void TACSGPBladeStiffenedShellConstitutive::addGlobalPanelBucklingDVSens(
   // axial-shear buckling load now we need to backprop through the failure
   // computation back to the DVs
 
+  // compute the in-plane panel loads
+  TacsScalar panelStress[NUM_STRESSES];
+  this->computePanelStress(strain, panelStress);
+
+  // get the pure axial and pure shear buckling loads
+  TacsScalar N1CritGlobal, N12CritGlobal;
+  this->getCriticalPanelLoads(GLOBAL_PANEL_BUCKLING, &N1CritGlobal,
+                              &N12CritGlobal);
+
+  // backprop sensitivities from combined loading to the in-plane loads for
+  // strain sens
+  TacsScalar N1GlobalSens, N1CritGlobalSens, N12GlobalSens, N12CritGlobalSens;
+  const TacsScalar strengthRatio = this->bucklingEnvelopeSens(
+      -panelStress[0], N1CritGlobal, panelStress[2], N12CritGlobal,
+      &N1GlobalSens, &N1CritGlobalSens, &N12GlobalSens, &N12CritGlobalSens);
+
+  // backprop in-plane load sens (stress sens) to the DVs
+  TacsScalar dfdPanelStress[NUM_STRESSES];
+  memset(dfdPanelStress, 0, NUM_STRESSES * sizeof(TacsScalar));
+  dfdPanelStress[0] = -N1GlobalSens;
+  dfdPanelStress[2] = N12GlobalSens;
+  // figure out whether this should be based on
+  this->addPanelStressDVSens(scale, strain, dfdPanelStress,
+                             &dfdx[this->panelDVStartNum]);
+
+  // backprop critical buckling load sens to the DVs
+  this->addCriticalPanelLoadsDVSens(GLOBAL_PANEL_BUCKLING, scale,
+                                    N1CritGlobalSens, N12CritGlobalSens, dfdx);
+}
+
+void TACSGPBladeStiffenedShellConstitutive::addCriticalGlobalPanelLoadsDVSens(
+    TacsScalar scale, TacsScalar N1CritGlobalSens, TacsScalar N12CritGlobalSens,
+    TacsScalar dfdx[]) {
+  this->predictPanelGPs(true);
+
   // compute panel stiffness matrix
-  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES],
-      panelStress[NUM_STRESSES];
+  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES];
   this->computePanelStiffness(panelStiffness);
   const TacsScalar *Ap, *Dp;
   this->extractTangentStiffness(panelStiffness, &Ap, NULL, &Dp, NULL, NULL);
-  this->computePanelStress(strain, panelStress);
 
   // compute effective moduli, overall centroid
   TacsScalar E1s, E1p, _;
@@ -639,28 +502,6 @@ void TACSGPBladeStiffenedShellConstitutive::addGlobalPanelBucklingDVSens(
   TacsScalar zetaPanel =
       computeTransverseShearParameter(A66p, A11p, b, this->panelThick);
 
-  // compute the pure axial and pure shear buckling loads
-  TacsScalar N1CritGlobal = computeCriticalGlobalAxialLoad(
-      D11Global, D22p, b, delta, rho0Global, xiGlobal, gamma, zetaPanel);
-  TacsScalar N12CritGlobal = computeCriticalGlobalShearLoad(
-      D11Global, D22p, b, rho0Global, xiGlobal, gamma, zetaPanel);
-
-  // backprop sensitivities from combined loading to the in-plane loads for
-  // strain sens
-  TacsScalar N1GlobalSens, N1CritGlobalSens, N12GlobalSens, N12CritGlobalSens;
-  const TacsScalar strengthRatio = this->bucklingEnvelopeSens(
-      -panelStress[0], N1CritGlobal, panelStress[2], N12CritGlobal,
-      &N1GlobalSens, &N1CritGlobalSens, &N12GlobalSens, &N12CritGlobalSens);
-
-  // backprop in-plane load sens (stress sens) to the DVs
-  TacsScalar dfdPanelStress[NUM_STRESSES];
-  memset(dfdPanelStress, 0, NUM_STRESSES * sizeof(TacsScalar));
-  dfdPanelStress[0] = -N1GlobalSens;
-  dfdPanelStress[2] = N12GlobalSens;
-  // figure out whether this should be based on
-  this->addPanelStressDVSens(scale, strain, dfdPanelStress,
-                             &dfdx[this->panelDVStartNum]);
-
   // backprop critical buckling load sens to the material properties and the
   // non-dimensional parameters
   // --------------------------
@@ -807,6 +648,7 @@ void TACSGPBladeStiffenedShellConstitutive::addStiffenerCripplingDVSens(
     const TacsScalar scale, const TacsScalar stiffenerStrain[],
     TacsScalar dfdx[]) {
   if (CPTstiffenerCrippling) {  // use predictions for Sean's paper
+    this->predictPanelGPs(true);
 
     // previous section writes directly into dfdx, this section writes into
     // DVsens DVsens format [0 - panel length, 1 - stiff pitch, 2 - panel thick,
@@ -1122,6 +964,169 @@ void TACSGPBladeStiffenedShellConstitutive::computeStiffenerCripplingStiffness(
   C[21] = DRILLING_REGULARIZATION * 0.5 * (As[0] + As[2]);
 }
 
+void TACSGPBladeStiffenedShellConstitutive::computeLocalPanelBucklingParams(
+    TacsScalar *D11, TacsScalar *D22, TacsScalar *rho0, TacsScalar *xi,
+    TacsScalar *zeta) {
+  // compute panel stiffness matrix
+  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES];
+  this->computePanelStiffness(panelStiffness);
+  const TacsScalar *Ap, *Dp;
+  this->extractTangentStiffness(panelStiffness, &Ap, NULL, &Dp, NULL, NULL);
+
+  // extract panel stiffnesses and dimensions
+  TacsScalar D11Local = Dp[0];
+  TacsScalar D12p = Dp[1], D66p = Dp[5], D22p = Dp[3];
+  TacsScalar A11p = Ap[0], A66p = Ap[5];
+  TacsScalar a = this->panelLength;
+  TacsScalar b = this->panelWidth;
+  TacsScalar s_p = this->stiffenerPitch;
+
+  // compute non-dimensional parameters for the local panel
+  *D11 = D11Local;
+  *D22 = D22p;
+  *rho0 = computeAffineAspectRatio(D11Local, D22p, a,
+                                   s_p);  // local panel is a x s_p
+  *xi = computeLaminateIsotropy(D11Local, D22p, D12p, D66p);
+  *zeta = computeTransverseShearParameter(A66p, A11p, b, this->panelThick);
+}
+
+void TACSGPBladeStiffenedShellConstitutive::computeGlobalPanelBucklingParams(
+    TacsScalar *D11, TacsScalar *D22, TacsScalar *delta, TacsScalar *rho0,
+    TacsScalar *xi, TacsScalar *gamma, TacsScalar *zeta) {
+  // compute panel stiffness matrix
+  TacsScalar panelStiffness[NUM_TANGENT_STIFFNESS_ENTRIES];
+  this->computePanelStiffness(panelStiffness);
+  const TacsScalar *Ap, *Dp;
+  this->extractTangentStiffness(panelStiffness, &Ap, NULL, &Dp, NULL, NULL);
+
+  // compute effective moduli, overall centroid
+  TacsScalar E1s, E1p, _;
+  this->computeEffectiveModulii(this->numPanelPlies, this->panelQMats,
+                                this->panelPlyFracs, &E1p, &_);
+  this->computeEffectiveModulii(this->numStiffenerPlies, this->stiffenerQMats,
+                                this->stiffenerPlyFracs, &E1s, &_);
+  TacsScalar zn = this->computeOverallCentroid(E1p, E1s);
+
+  // get the global buckling D11 with overall stiffener + panel centroid
+  TacsScalar D11Global;
+  computePanelGlobalBucklingStiffness(E1p, zn, &D11Global);
+
+  // extract panel stiffnesses and dimensions
+  TacsScalar D12p = Dp[1], D66p = Dp[5], D22p = Dp[3];
+  TacsScalar A11p = Ap[0], A66p = Ap[5];
+  TacsScalar a = this->panelLength;
+  TacsScalar b = this->panelWidth;
+
+  // compute non-dimensional parameters for the global panel
+  *D11 = D11Global;
+  *D22 = D22p;
+  *delta = computeStiffenerAreaRatio(E1p, E1s);
+  *rho0 =
+      computeAffineAspectRatio(D11Global, D22p, a, b);  // global panel is a x b
+  *xi = computeLaminateIsotropy(D11Global, D22p, D12p, D66p);
+  *gamma = computeStiffenerStiffnessRatio(D11Global, E1s, zn);
+  *zeta = computeTransverseShearParameter(A66p, A11p, b, this->panelThick);
+}
+
+void TACSGPBladeStiffenedShellConstitutive::computeStiffenerCripplingParams(
+    TacsScalar *D11, TacsScalar *D22, TacsScalar *rho0, TacsScalar *xi,
+    TacsScalar *genPoiss, TacsScalar *zeta) {
+  // compute D matrix of the stiffener (treating it like a panel for
+  // crippling)
+  TacsScalar stiffenerCripplingStiffness[NUM_TANGENT_STIFFNESS_ENTRIES];
+  const TacsScalar *As_crippling, *Ds_crippling;
+  this->computeStiffenerCripplingStiffness(stiffenerCripplingStiffness);
+  this->extractTangentStiffness(stiffenerCripplingStiffness, &As_crippling,
+                                NULL, &Ds_crippling, NULL, NULL);
+
+  // get stiffener material props and dimensions
+  TacsScalar A11s = As_crippling[0], A66s = As_crippling[5];
+  TacsScalar D11s = Ds_crippling[0], D12s = Ds_crippling[1];
+  TacsScalar D22s = Ds_crippling[3], D66s = Ds_crippling[5];
+  TacsScalar bStiff = this->stiffenerHeight;
+  TacsScalar hStiff = this->stiffenerThick;
+  TacsScalar a = this->panelLength;
+
+  // compute stiffener non-dimensional parameters
+  *D11 = D11s;
+  *D22 = D22s;
+  *rho0 = computeAffineAspectRatio(D11s, D22s, a, bStiff);
+  *xi = computeLaminateIsotropy(D11s, D22s, D12s, D66s);
+  *genPoiss = computeGeneralizedPoissonsRatio(D12s, D66s);
+  *zeta = computeTransverseShearParameter(A66s, A11s, bStiff, hStiff);
+}
+
+int TACSGPBladeStiffenedShellConstitutive::computePanelGPInputs(
+    int predInds[], TacsScalar Xtest[]) {
+  // the test points use the same inputs as the critical load routines:
+  // 0 - axial global, 1 - axial local, 2 - shear global, 3 - shear local,
+  // 4 - crippling
+  TacsScalar one = 1.0;
+  int n = 0;
+  if (this->getAxialGP() || this->getShearGP()) {
+    TacsScalar D11, D22, delta, rho0, xi, gamma, zeta;
+    this->computeGlobalPanelBucklingParams(&D11, &D22, &delta, &rho0, &xi,
+                                           &gamma, &zeta);
+    TacsScalar XGlobal[4];
+    XGlobal[0] = log(one + xi);
+    XGlobal[1] = log(rho0);
+    XGlobal[2] = log(one + gamma);
+    XGlobal[3] = log(one + 1000.0 * zeta);
+
+    this->computeLocalPanelBucklingParams(&D11, &D22, &rho0, &xi, &zeta);
+    TacsScalar XLocal[4];
+    XLocal[0] = log(one + xi);
+    XLocal[1] = log(rho0);
+    XLocal[2] = 0.0;  // log(1+gamma) = 0 since gamma=0 for unstiffened panel
+    XLocal[3] = log(one + 1000.0 * zeta);
+
+    for (int k = 0; k < 2; k++) {
+      TACSBucklingGaussianProcessModel *gp =
+          (k == 0 ? this->getAxialGP() : this->getShearGP());
+      if (gp) {
+        predInds[n] = 2 * k;
+        memcpy(&Xtest[4 * n], XGlobal, 4 * sizeof(TacsScalar));
+        predInds[n + 1] = 2 * k + 1;
+        memcpy(&Xtest[4 * (n + 1)], XLocal, 4 * sizeof(TacsScalar));
+        n += 2;
+      }
+    }
+  }
+
+  if (this->CPTstiffenerCrippling && this->getCripplingGP()) {
+    TacsScalar D11, D22, rho0, xi, genPoiss, zeta;
+    this->computeStiffenerCripplingParams(&D11, &D22, &rho0, &xi, &genPoiss,
+                                          &zeta);
+    predInds[n] = 4;
+    Xtest[4 * n] = log(one + xi);
+    Xtest[4 * n + 1] = log(rho0);
+    Xtest[4 * n + 2] = log(genPoiss);
+    Xtest[4 * n + 3] = log(one + 1000.0 * zeta);
+    n++;
+  }
+
+  return n;
+}
+
+void TACSGPBladeStiffenedShellConstitutive::predictPanelGPs(bool sens) {
+  // the predictions only need to be made once for each design
+  int version = (sens ? this->gpPredictSensVersion : this->gpPredictVersion);
+  if (!this->panelGPs || version == this->designVersion) {
+    return;
+  }
+
+  int predInds[5];
+  TacsScalar Xtest[20];
+  int n = this->computePanelGPInputs(predInds, Xtest);
+  if (sens) {
+    this->panelGPs->predictMeanTestDataSensBatch(n, predInds, Xtest);
+    this->gpPredictSensVersion = this->designVersion;
+  } else {
+    this->panelGPs->predictMeanTestDataBatch(n, predInds, Xtest);
+  }
+  this->gpPredictVersion = this->designVersion;
+}
+
 TacsScalar TACSGPBladeStiffenedShellConstitutive::computeStiffenerInPlaneLoad(
     const TacsScalar stiffenerStrain[], TacsScalar *A11s) {
   int n = TACSBeamConstitutive::NUM_TANGENT_STIFFNESS_ENTRIES;
@@ -3729,10 +3734,115 @@ TacsScalar TACSGPBladeStiffenedShellConstitutive::testStiffenerCripplingLoad(
   return relError;
 }
 
+TacsScalar TACSGPBladeStiffenedShellConstitutive::testPanelGPBatch(
+    int printLevel) {
+  if (!this->panelGPs) {
+    return 0.0;
+  }
+
+  if (printLevel != 0) {
+    printf("\nTACSGPBladeStiffened..testPanelGPBatch start::\n");
+    printf("--------------------------------------------------------\n\n");
+  }
+
+  // make the batched predictions and jacobians of this panel
+  int predInds[5];
+  TacsScalar Xtest[20], Ybatch[5], YsensBatch[5], jacBatch[20];
+  int n = this->computePanelGPInputs(predInds, Xtest);
+  this->panelGPs->resetSavedData();
+  this->panelGPs->predictMeanTestDataBatch(n, predInds, Xtest, Ybatch);
+  this->panelGPs->resetSavedData();
+  this->panelGPs->predictMeanTestDataSensBatch(n, predInds, Xtest, YsensBatch,
+                                               jacBatch);
+
+  // compute the non-dimensional parameters of the critical load routines
+  TacsScalar D11L, D22L, rho0L, xiL, zetaL;
+  this->computeLocalPanelBucklingParams(&D11L, &D22L, &rho0L, &xiL, &zetaL);
+  TacsScalar D11G, D22G, delta, rho0G, xiG, gamma, zetaG;
+  this->computeGlobalPanelBucklingParams(&D11G, &D22G, &delta, &rho0G, &xiG,
+                                         &gamma, &zetaG);
+  TacsScalar D11s, D22s, rho0s, xis, genPoiss, zetas;
+  this->computeStiffenerCripplingParams(&D11s, &D22s, &rho0s, &xis, &genPoiss,
+                                        &zetas);
+  TacsScalar b = this->panelWidth;
+
+  TacsScalar maxRelError = 0.0;
+  for (int i = 0; i < n; i++) {
+    // make each prediction separately through its critical load routine,
+    // which stores its test point in XtestAxial, XtestShear or XtestCrippling
+    this->panelGPs->resetSavedData();
+    TacsScalar *X = XtestCrippling;
+    if (predInds[i] == 0) {
+      computeCriticalGlobalAxialLoad(D11G, D22G, b, delta, rho0G, xiG, gamma,
+                                     zetaG);
+      X = XtestAxial;
+    } else if (predInds[i] == 1) {
+      computeCriticalLocalAxialLoad(D11L, D22L, rho0L, xiL, zetaL);
+      X = XtestAxial;
+    } else if (predInds[i] == 2) {
+      computeCriticalGlobalShearLoad(D11G, D22G, b, rho0G, xiG, gamma, zetaG);
+      X = XtestShear;
+    } else if (predInds[i] == 3) {
+      computeCriticalLocalShearLoad(D11L, D22L, rho0L, xiL, zetaL);
+      X = XtestShear;
+    } else {
+      computeStiffenerCripplingLoad(D11s, D22s, xis, rho0s, genPoiss, zetas);
+    }
+    TacsScalar Y = this->panelGPs->predictMeanTestData(predInds[i], X);
+    TacsScalar jac[4];
+    this->panelGPs->predictMeanTestDataSens(predInds[i], 1.0, X, jac);
+
+    // compare the test points, predictions and jacobians
+    const int nvals = 10;
+    TacsScalar batchVals[nvals], sepVals[nvals];
+    for (int j = 0; j < 4; j++) {
+      batchVals[j] = Xtest[4 * i + j];
+      sepVals[j] = X[j];
+      batchVals[4 + j] = jacBatch[4 * i + j];
+      sepVals[4 + j] = jac[j];
+    }
+    batchVals[8] = Ybatch[i];
+    batchVals[9] = YsensBatch[i];
+    sepVals[8] = sepVals[9] = Y;
+
+    TacsScalar relError = 0.0;
+    for (int j = 0; j < nvals; j++) {
+      TacsScalar err = fabs(TacsRealPart(batchVals[j] - sepVals[j]));
+      if (TacsRealPart(sepVals[j]) != 0.0) {
+        err /= fabs(TacsRealPart(sepVals[j]));
+      }
+      if (TacsRealPart(err) > TacsRealPart(relError)) {
+        relError = err;
+      }
+    }
+    if (TacsRealPart(relError) > TacsRealPart(maxRelError)) {
+      maxRelError = relError;
+    }
+
+    if (printLevel != 0) {
+      printf("\tprediction %d: batch Ytest = %.8e, separate Ytest = %.8e\n",
+             predInds[i], TacsRealPart(Ybatch[i]), TacsRealPart(Y));
+      printf("\tprediction %d rel error = %.4e\n", predInds[i],
+             TacsRealPart(relError));
+    }
+  }
+
+  // clear the predictions made by the test
+  this->panelGPs->resetSavedData();
+  this->gpPredictVersion = -1;
+  this->gpPredictSensVersion = -1;
+
+  if (printLevel != 0) {
+    printf("\tOverall max rel error = %.4e\n\n", TacsRealPart(maxRelError));
+  }
+
+  return maxRelError;
+}
+
 TacsScalar TACSGPBladeStiffenedShellConstitutive::testAllTests(
     TacsScalar epsilon, int printLevel) {
   // run each of the nondim parameter tests and aggregate the max among them
-  const int n_tests = 8;
+  const int n_tests = 9;
   TacsScalar relErrors[n_tests];
   memset(relErrors, 0, n_tests * sizeof(TacsScalar));
 
@@ -3747,6 +3857,7 @@ TacsScalar TACSGPBladeStiffenedShellConstitutive::testAllTests(
   relErrors[2] = testShearCriticalLoads(epsilon, printLevel);
   relErrors[3] = testStiffenerCripplingLoad(epsilon, printLevel);
   relErrors[7] = testOtherTests(epsilon, printLevel);
+  relErrors[8] = testPanelGPBatch(printLevel);
 
   if (this->getAxialGP()) {
     if (printLevel != 0) {
@@ -3798,6 +3909,7 @@ TacsScalar TACSGPBladeStiffenedShellConstitutive::testAllTests(
              TacsRealPart(relErrors[6]));
     }
     printf("\ttestOtherTests = %.4e\n", TacsRealPart(relErrors[7]));
+    printf("\ttestPanelGPBatch = %.4e\n", TacsRealPart(relErrors[8]));
     printf("\tOverall max rel error = %.4e\n\n", TacsRealPart(maxRelError));
   }
 
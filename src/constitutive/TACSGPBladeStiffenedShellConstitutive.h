@@ -159,6 +159,17 @@ class TACSGPBladeStiffenedShellConstitutive
    */
   TacsScalar testStiffenerCripplingLoad(TacsScalar epsilon, int printLevel);
 
+  /**
+   *
+   * @brief Test that the batched GP predictions of this panel match the
+   * predictions made separately by each critical load computation
+   * @param printLevel an integer flag, with 0 to not print the test result to
+   * terminal and 1 to print to terminal
+   * @return the maximum relative error between the batched and separate
+   * test points, predictions and jacobians
+   */
+  TacsScalar testPanelGPBatch(int printLevel);
+
   /**
    *
    * @brief Test all GP tests
@@ -314,13 +325,50 @@ class TACSGPBladeStiffenedShellConstitutive
   // ==============================================================================
 
   /**
-   * @brief Compute the strength ratio for the local buckling of the panel skin
-   * between stiffeners
+   * @brief Compute the critical axial and shear loads for local buckling of
+   * the panel skin between the stiffeners from the GP or closed-form models
    *
-   * @param e Shell strains
-   * @return TacsScalar Strength ratio
+   * @output N1Crit Critical axial load
+   * @output N12Crit Critical shear load
+   */
+  void computeCriticalLocalPanelLoads(TacsScalar *N1Crit,
+                                      TacsScalar *N12Crit) override;
+
+  /**
+   * @brief Add the derivative of a function of the critical local panel loads
+   * w.r.t the design variables
+   *
+   * @param scale Value by which to scale the derivatives
+   * @param dfdN1Crit Sensitivity of the output w.r.t the critical axial load
+   * @param dfdN12Crit Sensitivity of the output w.r.t the critical shear load
+   * @param dfdx The DV sensitivity array to add to
+   */
+  void addCriticalLocalPanelLoadsDVSens(TacsScalar scale, TacsScalar dfdN1Crit,
+                                        TacsScalar dfdN12Crit,
+                                        TacsScalar dfdx[]) override;
+
+  /**
+   * @brief Compute the critical axial and shear loads for global buckling of
+   * the stiffened panel from the GP or closed-form models
+   *
+   * @output N1Crit Critical axial load
+   * @output N12Crit Critical shear load
+   */
+  void computeCriticalGlobalPanelLoads(TacsScalar *N1Crit,
+                                       TacsScalar *N12Crit) override;
+
+  /**
+   * @brief Add the derivative of a function of the critical global panel loads
+   * w.r.t the design variables
+   *
+   * @param scale Value by which to scale the derivatives
+   * @param dfdN1Crit Sensitivity of the output w.r.t the critical axial load
+   * @param dfdN12Crit Sensitivity of the output w.r.t the critical shear load
+   * @param dfdx The DV sensitivity array to add to
    */
-  TacsScalar evalLocalPanelBuckling(const TacsScalar e[]) override;
+  void addCriticalGlobalPanelLoadsDVSens(TacsScalar scale, TacsScalar dfdN1Crit,
+                                         TacsScalar dfdN12Crit,
+                                         TacsScalar dfdx[]) override;
 
   /**
    * @brief Compute the strength ratio for the global buckling of the panel
@@ -345,16 +393,6 @@ class TACSGPBladeStiffenedShellConstitutive
   TacsScalar evalStiffenerCrippling(
       const TacsScalar stiffenerStrain[]) override;
 
-  /**
-   * @brief Compute the sensitivity of the local panel buckling strength ratio
-   *
-   * @param e Shell strains
-   * @param sens Sensitivity of the output w.r.t the shell strains
-   * @return TacsScalar Strength Ratio
-   */
-  TacsScalar evalLocalPanelBucklingStrainSens(const TacsScalar e[],
-                                              TacsScalar sens[]) override;
-
   /**
    * @brief Compute the sensitivity of the global buckling strength ratio w.r.t
    * the shell strains
@@ -377,23 +415,6 @@ class TACSGPBladeStiffenedShellConstitutive
   TacsScalar evalStiffenerCripplingStrainSens(
       const TacsScalar stiffenerStrain[], TacsScalar sens[]) override;
 
-  /**
-   * @brief Add the derivative of the local panel buckling strength ratio w.r.t
-   * the design variables
-
-    @param elemIndex The local element index (not used)
-    @param scale Value by which to scale the derivatives
-    @param pt The parametric point (not used)
-    @param X The physical node location (not used)
-    @param strain The shell strains
-    @param dvLen The length of the design vector (not used)
-    @param dfdx The DV sensitivity array to add to
-   */
-  void addLocalPanelBucklingDVSens(int elemIndex, TacsScalar scale,
-                                   const double pt[], const TacsScalar X[],
-                                   const TacsScalar strain[], int dvLen,
-                                   TacsScalar dfdx[]) override;
-
   /**
    * @brief Add the derivative of the global panel buckling strength ratio w.r.t
    * the design variables
@@ -454,6 +475,50 @@ class TACSGPBladeStiffenedShellConstitutive
 
   void computeStiffenerCripplingStiffness(TacsScalar C[]);
 
+  /**
+   * @brief compute the non-dimensional parameters of the local panel skin
+   * between the stiffeners used by the local buckling predictions
+   */
+  void computeLocalPanelBucklingParams(TacsScalar *D11, TacsScalar *D22,
+                                       TacsScalar *rho0, TacsScalar *xi,
+                                       TacsScalar *zeta);
+
+  /**
+   * @brief compute the non-dimensional parameters of the stiffened panel used
+   * by the global buckling predictions
+   */
+  void computeGlobalPanelBucklingParams(TacsScalar *D11, TacsScalar *D22,
+                                        TacsScalar *delta, TacsScalar *rho0,
+                                        TacsScalar *xi, TacsScalar *gamma,
+                                        TacsScalar *zeta);
+
+  /**
+   * @brief compute the non-dimensional parameters of the stiffener used by
+   * the stiffener crippling prediction
+   */
+  void computeStiffenerCripplingParams(TacsScalar *D11, TacsScalar *D22,
+                                       TacsScalar *rho0, TacsScalar *xi,
+                                       TacsScalar *genPoiss, TacsScalar *zeta);
+
+  /**
+   * @brief compute the GP test points of all the buckling predictions of
+   * this panel, in the format of TACSPanelGPs::predictMeanTestDataBatch
+   *
+   * @param predInds the prediction indices, length 5
+   * @param Xtest the test points, length 20
+   * @return the number of predictions
+   */
+  int computePanelGPInputs(int predInds[], TacsScalar Xtest[]);
+
+  /**
+   * @brief make all of the GP buckling predictions of this panel with one
+   * batched call to each GP model, once per design. The critical load
+   * routines then reuse the predictions saved in the TACSPanelGPs object.
+   *
+   * @param sens whether to also compute the jacobians of the predictions
+   */
+  void predictPanelGPs(bool sens);
+
   // ==============================================================================
   // Buckling functions
   // ==============================================================================
@@ -1234,6 +1299,9 @@ class TACSGPBladeStiffenedShellConstitutive
   TacsScalar *XtestAxial, *XtestShear, *XtestCrippling;
   TacsScalar *XtestAxialSens, *XtestShearSens, *XtestCripplingSens;
 
+  // design versions of the batched GP predictions
+  int gpPredictVersion, gpPredictSensVersion;
+
  private:
   // private so that subclass constName for GP buckling constraints doesn't
   // conflict with superclass
@@ -16,6 +16,14 @@ TACSGaussianProcessModel::TACSGaussianProcessModel(int n_train, int n_param,
     this->Xtrain[ii] = Xtrain[ii];
   }
 
+  // store a transposed copy for the batch predictions
+  this->XtrainSoA = new TacsScalar[n_train * n_param];
+  for (int itrain = 0; itrain < n_train; itrain++) {
+    for (int j = 0; j < n_param; j++) {
+      this->XtrainSoA[j * n_train + itrain] = Xtrain[n_param * itrain + j];
+    }
+  }
+
   this->alpha = new TacsScalar[n_train];
   for (int jj = 0; jj < n_train; jj++) {
     this->alpha[jj] = alpha[jj];
@@ -34,6 +42,9 @@ TACSGaussianProcessModel::~TACSGaussianProcessModel() {
   delete[] this->Xtrain;
   this->Xtrain = nullptr;
 
+  delete[] this->XtrainSoA;
+  this->XtrainSoA = nullptr;
+
   delete[] this->alpha;
   this->alpha = nullptr;
 
@@ -41,28 +52,27 @@ TACSGaussianProcessModel::~TACSGaussianProcessModel() {
   this->theta = nullptr;
 }
 
+void TACSGaussianProcessModel::setAlpha(const TacsScalar *alpha) {
+  for (int jj = 0; jj < n_train; jj++) {
+    this->alpha[jj] = alpha[jj];
+  }
+  updateTrainingTerms();
+}
+
+void TACSGaussianProcessModel::setTheta(const TacsScalar *theta) {
+  for (int kk = 0; kk < n_theta; kk++) {
+    this->theta[kk] = theta[kk];
+  }
+  updateTrainingTerms();
+}
+
 TacsScalar TACSGaussianProcessModel::predictMeanTestData(
     const TacsScalar *Xtest) {
   // Xtest is an array of size n_param (for one test data point)
   // use the equation mean(Ytest) = cov(Xtest,X_train) @ alpha [this is a dot
   // product] where Ytest is a scalar
   TacsScalar Ytest = 0.0;
-
-  // printf("Xtest[0] = %.6e\n", Xtest[0]);
-  // printf("Xtest[1] = %.6e\n", Xtest[1]);
-  // printf("Xtest[2] = %.6e\n", Xtest[2]);
-  // printf("Xtest[3] = %.6e\n", Xtest[3]);
-
-  // iterate over each training data point, get the cross-term covariance and
-  // add the coefficient alpha for it
-  for (int itrain = 0; itrain < n_train; itrain++) {
-    TacsScalar *loc_Xtrain = &Xtrain[n_param * itrain];
-    // TacsScalar mkernel = kernel(Xtest, loc_Xtrain);
-    Ytest += kernel(Xtest, loc_Xtrain) * alpha[itrain];
-
-    // printf("kernel[%d] %.6e\n", itrain, kernel(Xtest, loc_Xtrain));
-    // printf("alpha[%d] = %.6e\n", itrain, alpha[itrain]);
-  }
+  predictMeanTestDataBatch(1, Xtest, &Ytest);
   return Ytest;
 }
 
@@ -70,23 +80,145 @@ TacsScalar TACSGaussianProcessModel::predictMeanTestDataSens(
     const TacsScalar Ysens, const TacsScalar *Xtest, TacsScalar *Xtestsens) {
   // Xtest is an array of size n_param (for one test data point)
   // the sensitivity here is on log[nondim-params]
-  // use the equation mean(Ytest) = cov(Xtest,X_train) @ alpha [this is a dot
-  // product] where Ytest is a scalar
   TacsScalar Ytest = 0.0;
+  predictMeanTestDataSensBatch(1, Xtest, &Ytest, Xtestsens);
+  for (int i = 0; i < n_param; i++) {
+    Xtestsens[i] *= Ysens;
+  }
+
+  return Ytest;
+}
 
+void TACSGaussianProcessModel::predictMeanTestDataBatch(int n_test,
+                                                        const TacsScalar *Xtest,
+                                                        TacsScalar *Ytest) {
   // iterate over each training data point, get the cross-term covariance and
   // add the coefficient alpha for it
-  memset(Xtestsens, 0, n_param * sizeof(TacsScalar));
+  for (int itest = 0; itest < n_test; itest++) {
+    const TacsScalar *loc_Xtest = &Xtest[n_param * itest];
+    Ytest[itest] = 0.0;
+    for (int itrain = 0; itrain < n_train; itrain++) {
+      TacsScalar *loc_Xtrain = &Xtrain[n_param * itrain];
+      Ytest[itest] += kernel(loc_Xtest, loc_Xtrain) * alpha[itrain];
+    }
+  }
+}
 
+void TACSGaussianProcessModel::predictMeanTestDataSensBatch(
+    int n_test, const TacsScalar *Xtest, TacsScalar *Ytest,
+    TacsScalar *Xtestjac) {
+  memset(Xtestjac, 0, n_param * n_test * sizeof(TacsScalar));
+
+  for (int itest = 0; itest < n_test; itest++) {
+    const TacsScalar *loc_Xtest = &Xtest[n_param * itest];
+    TacsScalar *loc_Xtestjac = &Xtestjac[n_param * itest];
+    Ytest[itest] = 0.0;
+    for (int itrain = 0; itrain < n_train; itrain++) {
+      TacsScalar *loc_Xtrain = &Xtrain[n_param * itrain];
+      Ytest[itest] += kernel(loc_Xtest, loc_Xtrain) * alpha[itrain];
+
+      // backwards propagate to the Xtestjac through the kernel computation
+      kernelSens(alpha[itrain], loc_Xtest, loc_Xtrain, loc_Xtestjac);
+    }
+  }
+}
+
+void TACSBucklingGaussianProcessModel::updateTrainingTerms() {
+  // The relu, gamma and constant terms of the kernel are products of a test
+  // point factor and a training point factor, so their contribution to the
+  // prediction only requires the alpha-weighted sum of the training factors
+  alphaRelu = alphaGamma = alphaSum = 0.0;
   for (int itrain = 0; itrain < n_train; itrain++) {
-    TacsScalar *loc_Xtrain = &Xtrain[n_param * itrain];
-    Ytest += kernel(Xtest, loc_Xtrain) * alpha[itrain];
+    const TacsScalar *loc_Xtrain = &Xtrain[N_PARAM * itrain];
+    TacsScalar arg = -loc_Xtrain[1];
+    if (affine) {
+      arg += 0.25 * loc_Xtrain[2];
+    }
+    alphaRelu += alpha[itrain] * soft_relu(arg, theta[0]);
+    alphaGamma += alpha[itrain] * loc_Xtrain[2];
+    alphaSum += alpha[itrain];
+  }
+}
 
-    // backwards propagate to the Xtestsens through the kernel computation
-    kernelSens(Ysens * alpha[itrain], Xtest, loc_Xtrain, Xtestsens);
+void TACSBucklingGaussianProcessModel::predictMeanTestDataBatch(
+    int n_test, const TacsScalar *Xtest, TacsScalar *Ytest) {
+  const TacsScalar *t0 = &XtrainSoA[0];
+  const TacsScalar *t1 = &XtrainSoA[n_train];
+  const TacsScalar *t2 = &XtrainSoA[2 * n_train];
+  const TacsScalar *t3 = &XtrainSoA[3 * n_train];
+  const TacsScalar a1 = (affine ? 0.25 : 0.0);
+  const TacsScalar scale = 0.5 / (theta[3] * theta[3] * theta[4]);
+
+  for (int itest = 0; itest < n_test; itest++) {
+    const TacsScalar *x = &Xtest[N_PARAM * itest];
+
+    // separable terms of the kernel
+    TacsScalar relu_test = soft_relu(-x[1] + a1 * x[2], theta[0]);
+    TacsScalar Y = relu_test * alphaRelu + theta[1] * x[2] * alphaGamma +
+                   theta[5] * alphaSum;
+
+    // rational quadratic term, swept over the contiguous training data
+    TacsScalar RQ_sum = 0.0;
+    for (int itrain = 0; itrain < n_train; itrain++) {
+      TacsScalar d0 = x[0] - t0[itrain];
+      TacsScalar d2 = x[2] - t2[itrain];
+      TacsScalar d1 = x[1] - t1[itrain] - a1 * d2;
+      TacsScalar d3 = x[3] - t3[itrain];
+      TacsScalar base = 1.0 + scale * (d0 * d0 + d1 * d1 + d2 * d2 + d3 * d3);
+      RQ_sum += alpha[itrain] * pow(base, -theta[4]);
+    }
+    Ytest[itest] = Y + theta[2] * RQ_sum;
   }
+}
 
-  return Ytest;
+void TACSBucklingGaussianProcessModel::predictMeanTestDataSensBatch(
+    int n_test, const TacsScalar *Xtest, TacsScalar *Ytest,
+    TacsScalar *Xtestjac) {
+  const TacsScalar *t0 = &XtrainSoA[0];
+  const TacsScalar *t1 = &XtrainSoA[n_train];
+  const TacsScalar *t2 = &XtrainSoA[2 * n_train];
+  const TacsScalar *t3 = &XtrainSoA[3 * n_train];
+  const TacsScalar a1 = (affine ? 0.25 : 0.0);
+  const TacsScalar scale = 0.5 / (theta[3] * theta[3] * theta[4]);
+
+  for (int itest = 0; itest < n_test; itest++) {
+    const TacsScalar *x = &Xtest[N_PARAM * itest];
+    TacsScalar *jac = &Xtestjac[N_PARAM * itest];
+
+    // separable terms of the kernel and their derivatives
+    TacsScalar arg = -x[1] + a1 * x[2];
+    TacsScalar relu_test = soft_relu(arg, theta[0]);
+    TacsScalar relu_sens = soft_relu_sens(arg, theta[0]) * alphaRelu;
+    TacsScalar Y = relu_test * alphaRelu + theta[1] * x[2] * alphaGamma +
+                   theta[5] * alphaSum;
+
+    // rational quadratic term and its derivative computed together in a
+    // single sweep over the contiguous training data
+    TacsScalar RQ_sum = 0.0;
+    TacsScalar w0 = 0.0, w1 = 0.0, w2 = 0.0, w3 = 0.0;
+    for (int itrain = 0; itrain < n_train; itrain++) {
+      TacsScalar d0 = x[0] - t0[itrain];
+      TacsScalar d2 = x[2] - t2[itrain];
+      TacsScalar d1 = x[1] - t1[itrain] - a1 * d2;
+      TacsScalar d3 = x[3] - t3[itrain];
+      TacsScalar base = 1.0 + scale * (d0 * d0 + d1 * d1 + d2 * d2 + d3 * d3);
+      TacsScalar RQ = alpha[itrain] * pow(base, -theta[4]);
+      TacsScalar w = RQ / base;
+      RQ_sum += RQ;
+      w0 += w * d0;
+      w1 += w * d1;
+      w2 += w * d2;
+      w3 += w * d3;
+    }
+    Ytest[itest] = Y + theta[2] * RQ_sum;
+
+    // d(RQ)/d(d_i) = -theta[2] * RQ / base * d_i / theta[3]^2
+    TacsScalar c = -theta[2] / (theta[3] * theta[3]);
+    jac[0] = c * w0;
+    jac[1] = c * w1 - relu_sens;
+    jac[2] = c * (w2 - a1 * w1) + a1 * relu_sens + theta[1] * alphaGamma;
+    jac[3] = c * w3;
+  }
 }
 
 TacsScalar TACSBucklingGaussianProcessModel::kernel(const TacsScalar *Xtest,
@@ -105,7 +237,7 @@ TacsScalar TACSBucklingGaussianProcessModel::kernel(const TacsScalar *Xtest,
   }
 
   TacsScalar gam_term = Xtest[2] * Xtrain[2];
-  TacsScalar sum_sq;
+  TacsScalar sum_sq = 0.0;
   for (int i = 0; i < 4; i++) {
     TacsScalar Xdiff = Xtest[i] - Xtrain[i];
     if (i == 1 && affine) {
@@ -150,7 +282,7 @@ void TACSBucklingGaussianProcessModel::kernelSens(const TacsScalar ksens,
   jacobian[2] += theta[1] * Xtrain[2];
 
   // RQ term
-  TacsScalar sum_sq;
+  TacsScalar sum_sq = 0.0;
   for (int i = 0; i < 4; i++) {
     TacsScalar Xdiff = Xtest[i] - Xtrain[i];
     if (i == 1 && affine) {
@@ -58,6 +58,33 @@ class TACSGaussianProcessModel : public TACSObject {
                                      const TacsScalar *Xtest,
                                      TacsScalar *Xtestsens);
 
+  /**
+   * @brief predict the mean test data Ytest for a batch of test data points
+   *
+   * @param n_test the number of test data points
+   * @param Xtest the test data inputs, rank 1-tensor of length
+   * [n_param*n_test] ordered as [param1_1, ..., param4_1, param1_2, ...]
+   * @param Ytest the predicted test data, rank 1-tensor of length n_test
+   */
+  virtual void predictMeanTestDataBatch(int n_test, const TacsScalar *Xtest,
+                                        TacsScalar *Ytest);
+
+  /**
+   * @brief predict the mean test data Ytest and its jacobian dYtest/dXtest
+   * for a batch of test data points in a single pass over the training data
+   *
+   * @param n_test the number of test data points
+   * @param Xtest the test data inputs, rank 1-tensor of length
+   * [n_param*n_test] ordered as [param1_1, ..., param4_1, param1_2, ...]
+   * @param Ytest the predicted test data, rank 1-tensor of length n_test
+   * @param Xtestjac the jacobian dYtest/dXtest, rank 1-tensor of length
+   * [n_param*n_test] with the same ordering as Xtest
+   */
+  virtual void predictMeanTestDataSensBatch(int n_test,
+                                            const TacsScalar *Xtest,
+                                            TacsScalar *Ytest,
+                                            TacsScalar *Xtestjac);
+
   // TESTING SCRIPTS
   // ---------------
   /**
@@ -193,8 +220,8 @@ class TACSGaussianProcessModel : public TACSObject {
   int getNparam() { return n_param; };
   TacsScalar getKS() { return ks; };
   void setKS(TacsScalar ks) { this->ks = ks; };
-  void setAlpha(TacsScalar *alpha) { this->alpha = alpha; };
-  void setTheta(TacsScalar *theta) { this->theta = theta; };
+  void setAlpha(const TacsScalar *alpha);
+  void setTheta(const TacsScalar *theta);
   void getTrainingData(TacsScalar *Xtrain) { Xtrain = this->Xtrain; };
   void getTheta(TacsScalar *theta) { theta = this->theta; };
 
@@ -225,6 +252,12 @@ class TACSGaussianProcessModel : public TACSObject {
   virtual void kernelSens(const TacsScalar ksens, const TacsScalar *Xtest,
                           const TacsScalar *Xtrain, TacsScalar *Xtestsens) = 0;
 
+  /**
+   * @brief update any data that depends only on the training set, alpha and
+   * theta. This is called whenever alpha or theta are changed.
+   */
+  virtual void updateTrainingTerms() {}
+
   int n_train;
   int n_param;
   int n_theta = 6;
@@ -234,6 +267,9 @@ class TACSGaussianProcessModel : public TACSObject {
   // n_Train=5 then the entries are basically [rho01, xi1, gamma1, delta1,
   // zeta1, rho02, xi2, gamma2, delta2, zeta2, ..., zetaN]
   TacsScalar *Xtrain;
+  // the same training data stored parameter-major [n_param x n_train] so that
+  // the batch predictions sweep contiguous arrays over the training points
+  TacsScalar *XtrainSoA;
   TacsScalar *alpha;
   TacsScalar *theta;  // hyperparameters
 
@@ -249,7 +285,9 @@ class TACSBucklingGaussianProcessModel : public TACSGaussianProcessModel {
                                    const TacsScalar alpha[],
                                    const TacsScalar theta[])
       : TACSGaussianProcessModel(n_train, N_PARAM, affine, Xtrain, alpha,
-                                 theta) {};
+                                 theta) {
+    updateTrainingTerms();
+  };
   ~TACSBucklingGaussianProcessModel() {};
 
   /**
@@ -274,6 +312,30 @@ class TACSBucklingGaussianProcessModel : public TACSGaussianProcessModel {
    */
   TacsScalar kernel(const TacsScalar *Xtest, const TacsScalar *Xtrain) override;
 
+  /**
+   * @brief batch prediction of the mean test data using the SoA training data
+   *
+   * @param n_test the number of test data points
+   * @param Xtest the test data inputs, rank 1-tensor of length [4*n_test]
+   * @param Ytest the predicted test data, rank 1-tensor of length n_test
+   */
+  void predictMeanTestDataBatch(int n_test, const TacsScalar *Xtest,
+                                TacsScalar *Ytest) override;
+
+  /**
+   * @brief batch prediction of the mean test data and the jacobian
+   * dYtest/dXtest, computing the kernel and its derivatives together
+   *
+   * @param n_test the number of test data points
+   * @param Xtest the test data inputs, rank 1-tensor of length [4*n_test]
+   * @param Ytest the predicted test data, rank 1-tensor of length n_test
+   * @param Xtestjac the jacobian dYtest/dXtest, rank 1-tensor of length
+   * [4*n_test]
+   */
+  void predictMeanTestDataSensBatch(int n_test, const TacsScalar *Xtest,
+                                    TacsScalar *Ytest,
+                                    TacsScalar *Xtestjac) override;
+
  protected:
   /**
    * @brief backpropagate derivatives of the kernel function to the Xtest input
@@ -287,6 +349,18 @@ class TACSBucklingGaussianProcessModel : public TACSGaussianProcessModel {
   void kernelSens(const TacsScalar ksens, const TacsScalar *Xtest,
                   const TacsScalar *Xtrain, TacsScalar *Xtestsens) override;
 
+  /**
+   * @brief precompute the alpha-weighted sums of the kernel terms that are
+   * separable in the test and training points
+   */
+  void updateTrainingTerms() override;
+
+  // alpha-weighted sums over the training set of the relu term, the gamma
+  // term and the constant term of the kernel
+  TacsScalar alphaRelu = 0.0;
+  TacsScalar alphaGamma = 0.0;
+  TacsScalar alphaSum = 0.0;
+
   // there are 4 parameters [log(xi), log(rho_0), log(1+gamma), log(zeta)] for
   // the axial model
   static const int N_PARAM = 4;
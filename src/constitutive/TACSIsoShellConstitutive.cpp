@@ -65,6 +65,7 @@ int TACSIsoShellConstitutive::setDesignVars(int elemIndex, int dvLen,
                                             const TacsScalar dvs[]) {
   if (tNum >= 0 && dvLen >= 1) {
     t = dvs[0];
+    updateDesignVersion();
     return 1;
   }
   return 0;
@@ -116,6 +117,16 @@ void TACSIsoShellConstitutive::addDensityDVSens(int elemIndex, TacsScalar scale,
   }
 }
 
+// Evaluate the derivative of the density along a design direction
+TacsScalar TACSIsoShellConstitutive::evalDensityDVSensVecProduct(
+    int elemIndex, const double pt[], const TacsScalar X[], int dvLen,
+    const TacsScalar pdx[], TacsScalar work[]) {
+  if (properties && tNum >= 0) {
+    return pdx[0] * properties->getDensity();
+  }
+  return 0.0;
+}
+
 // Evaluate the mass moments
 void TACSIsoShellConstitutive::evalMassMoments(int elemIndex, const double pt[],
                                                const TacsScalar X[],
@@ -139,6 +150,20 @@ void TACSIsoShellConstitutive::addMassMomentsDVSens(
   }
 }
 
+// Evaluate the derivative of the mass moments along a design direction
+void TACSIsoShellConstitutive::evalMassMomentsDVSensVecProduct(
+    int elemIndex, const double pt[], const TacsScalar X[], int dvLen,
+    const TacsScalar pdx[], TacsScalar work[], TacsScalar pmoments[]) {
+  if (properties && tNum >= 0) {
+    TacsScalar rho = properties->getDensity();
+    pmoments[0] = pdx[0] * rho;
+    pmoments[1] = -2.0 * pdx[0] * rho * t * tOffset;
+    pmoments[2] = pdx[0] * rho * (3.0 * tOffset * tOffset + 0.25) * t * t;
+  } else {
+    pmoments[0] = pmoments[1] = pmoments[2] = 0.0;
+  }
+}
+
 // Evaluate the specific heat
 TacsScalar TACSIsoShellConstitutive::evalSpecificHeat(int elemIndex,
                                                       const double pt[],
@@ -154,6 +179,10 @@ void TACSIsoShellConstitutive::evalStress(int elemIndex, const double pt[],
                                           const TacsScalar X[],
                                           const TacsScalar e[],
                                           TacsScalar s[]) {
+  if (evalCachedStress(e, s)) {
+    return;
+  }
+
   if (properties) {
     TacsScalar A[6], B[6], D[6], As[3], drill;
 
@@ -193,6 +222,10 @@ void TACSIsoShellConstitutive::evalTangentStiffness(int elemIndex,
                                                     const double pt[],
                                                     const TacsScalar X[],
                                                     TacsScalar C[]) {
+  if (getCachedTangentStiffness(C)) {
+    return;
+  }
+
   if (properties) {
     TacsScalar *A = &C[0];
     TacsScalar *B = &C[6];
@@ -250,6 +283,37 @@ void TACSIsoShellConstitutive::addStressDVSens(int elemIndex, TacsScalar scale,
   }
 }
 
+// Evaluate the derivative of the stress along a design direction
+void TACSIsoShellConstitutive::evalStressDVSensVecProduct(
+    int elemIndex, const double pt[], const TacsScalar X[],
+    const TacsScalar e[], int dvLen, const TacsScalar pdx[],
+    TacsScalar work[], TacsScalar ps[]) {
+  if (properties && tNum >= 0) {
+    TacsScalar A[6], B[6], D[6], As[3], drill;
+
+    // Compute the derivatives of the stiffness matrices w.r.t. the
+    // thickness, scaled by the thickness direction
+    properties->evalTangentStiffness2D(A);
+    TacsScalar dI = (3.0 * tOffset * tOffset + 0.25) * t * t;
+    for (int i = 0; i < 6; i++) {
+      A[i] *= pdx[0];
+      B[i] = -2.0 * tOffset * t * A[i];
+      D[i] = dI * A[i];
+    }
+
+    As[0] = As[2] = (5.0 / 6.0) * A[5];
+    As[1] = 0.0;
+
+    drill = 0.5 * DRILLING_REGULARIZATION * (As[0] + As[2]);
+
+    computeStress(A, B, D, As, drill, e, ps);
+  } else {
+    ps[0] = ps[1] = ps[2] = 0.0;
+    ps[3] = ps[4] = ps[5] = 0.0;
+    ps[6] = ps[7] = ps[8] = 0.0;
+  }
+}
+
 // Calculate the point-wise failure criteria
 TacsScalar TACSIsoShellConstitutive::evalFailure(int elemIndex,
                                                  const double pt[],
@@ -56,6 +56,12 @@ class TACSIsoShellConstitutive : public TACSShellConstitutive {
   void addDensityDVSens(int elemIndex, TacsScalar scale, const double pt[],
                         const TacsScalar X[], int dvLen, TacsScalar dfdx[]);
 
+  // Evaluate the derivative of the density along a design direction
+  TacsScalar evalDensityDVSensVecProduct(int elemIndex, const double pt[],
+                                         const TacsScalar X[], int dvLen,
+                                         const TacsScalar pdx[],
+                                         TacsScalar work[]);
+
   // Evaluate the mass moments
   void evalMassMoments(int elemIndex, const double pt[], const TacsScalar X[],
                        TacsScalar moments[]);
@@ -65,6 +71,13 @@ class TACSIsoShellConstitutive : public TACSShellConstitutive {
                             const TacsScalar X[], const TacsScalar scale[],
                             int dvLen, TacsScalar dfdx[]);
 
+  // Evaluate the derivative of the mass moments along a design direction
+  void evalMassMomentsDVSensVecProduct(int elemIndex, const double pt[],
+                                       const TacsScalar X[], int dvLen,
+                                       const TacsScalar pdx[],
+                                       TacsScalar work[],
+                                       TacsScalar pmoments[]);
+
   // Evaluate the specific heat
   TacsScalar evalSpecificHeat(int elemIndex, const double pt[],
                               const TacsScalar X[]);
@@ -82,6 +95,13 @@ class TACSIsoShellConstitutive : public TACSShellConstitutive {
                        const TacsScalar X[], const TacsScalar strain[],
                        const TacsScalar psi[], int dvLen, TacsScalar dfdx[]);
 
+  // Evaluate the derivative of the stress along a design direction
+  void evalStressDVSensVecProduct(int elemIndex, const double pt[],
+                                  const TacsScalar X[],
+                                  const TacsScalar strain[], int dvLen,
+                                  const TacsScalar pdx[], TacsScalar work[],
+                                  TacsScalar pstress[]);
+
   // Calculate the point-wise failure criteria
   TacsScalar evalFailure(int elemIndex, const double pt[], const TacsScalar X[],
                          const TacsScalar e[]);
@@ -82,6 +82,7 @@ void TACSLamParamFullShellConstitutive::setLaminationParameters(
   for (int k = 0; k < NUM_LAM_PARAMS; k++) {
     lp[k] = _lp[k];
   }
+  updateDesignVersion();
 }
 
 // Set the number of failure angles to set
@@ -125,6 +126,7 @@ int TACSLamParamFullShellConstitutive::setDesignVars(int elemIndex, int dvLen,
       index++;
     }
   }
+  updateDesignVersion();
   return numDesignVars;
 }
 
@@ -316,6 +318,10 @@ void TACSLamParamFullShellConstitutive::evalStress(int elemIndex,
                                                    const TacsScalar X[],
                                                    const TacsScalar e[],
                                                    TacsScalar s[]) {
+  if (evalCachedStress(e, s)) {
+    return;
+  }
+
   TacsScalar A[6], B[6], D[6], As[3], drill;
   getStiffness(A, B, D, As, &drill);
   TACSShellConstitutive::computeStress(A, B, D, As, drill, e, s);
@@ -426,6 +432,10 @@ void TACSLamParamFullShellConstitutive::addStressDVSens(
 // Evaluate the tangent stiffness
 void TACSLamParamFullShellConstitutive::evalTangentStiffness(
     int elemIndex, const double pt[], const TacsScalar X[], TacsScalar C[]) {
+  if (getCachedTangentStiffness(C)) {
+    return;
+  }
+
   TacsScalar *A = &C[0];
   TacsScalar *B = &C[6];
   TacsScalar *D = &C[12];
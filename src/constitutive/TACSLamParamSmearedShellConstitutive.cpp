@@ -185,6 +185,7 @@ int TACSLamParamSmearedShellConstitutive::setDesignVars(
     W3 = dvs[i];
     i++;
   }
+  updateDesignVersion();
   return numDesignVars;
 }
 
@@ -401,6 +402,10 @@ void TACSLamParamSmearedShellConstitutive::evalStress(int elemIndex,
                                                       const TacsScalar X[],
                                                       const TacsScalar e[],
                                                       TacsScalar s[]) {
+  if (evalCachedStress(e, s)) {
+    return;
+  }
+
   TacsScalar A[6], B[6], D[6], As[3], drill;
   getStiffness(A, B, D, As, &drill);
   TACSShellConstitutive::computeStress(A, B, D, As, drill, e, s);
@@ -409,6 +414,10 @@ void TACSLamParamSmearedShellConstitutive::evalStress(int elemIndex,
 // Evaluate the tangent stiffness
 void TACSLamParamSmearedShellConstitutive::evalTangentStiffness(
     int elemIndex, const double pt[], const TacsScalar X[], TacsScalar C[]) {
+  if (getCachedTangentStiffness(C)) {
+    return;
+  }
+
   TacsScalar *A = &C[0];
   TacsScalar *B = &C[6];
   TacsScalar *D = &C[12];
@@ -1205,6 +1205,249 @@ TacsScalar TACSOrthotropicPly::failureStrainSens(TacsScalar angle,
   return fail;
 }
 
+/*
+  Evaluate the failure criterion at a batch of points
+
+  The laminate strains are stored in structure-of-arrays form, so that
+  the strain at point i is (ex[i], ey[i], exy[i]) and the ply angle is
+  angles[i]. The trigonometric terms are only re-evaluated when the
+  angle changes between consecutive points, so points within the same
+  ply should be stored next to one another. The Tsai-Wu and maximum
+  strain criteria are evaluated inline, while the Cuntze criteria fall
+  back to the single point code.
+*/
+void TACSOrthotropicPly::failureBatch(int n, const TacsScalar angles[],
+                                      const TacsScalar ex[],
+                                      const TacsScalar ey[],
+                                      const TacsScalar exy[],
+                                      TacsScalar fail[]) {
+  if (failureCriterion == CUNTZE_UD || failureCriterion == CUNTZE_WOVEN) {
+    for (int i = 0; i < n; i++) {
+      TacsScalar strain[3] = {ex[i], ey[i], exy[i]};
+      fail[i] = failure(angles[i], strain);
+    }
+    return;
+  }
+
+  TacsScalar cos2 = 1.0, sin2 = 0.0, sincos = 0.0;
+  for (int i = 0; i < n; i++) {
+    if (i == 0 || angles[i] != angles[i - 1]) {
+      TacsScalar cos1 = cos(angles[i]);
+      TacsScalar sin1 = sin(angles[i]);
+      cos2 = cos1 * cos1;
+      sin2 = sin1 * sin1;
+      sincos = sin1 * cos1;
+    }
+
+    // Compute the strain in the ply axis
+    TacsScalar e0 = cos2 * ex[i] + sin2 * ey[i] + sincos * exy[i];
+    TacsScalar e1 = sin2 * ex[i] + cos2 * ey[i] - sincos * exy[i];
+    TacsScalar e2 = 2.0 * sincos * (ey[i] - ex[i]) + (cos2 - sin2) * exy[i];
+
+    if (failureCriterion == MAX_STRAIN) {
+      TacsScalar f[6];
+      f[0] = e0 / eXt;
+      f[1] = -e0 / eXc;
+      f[2] = e1 / eYt;
+      f[3] = -e1 / eYc;
+      f[4] = e2 / eS12;
+      f[5] = -e2 / eS12;
+
+      TacsScalar max = f[0];
+      for (int k = 1; k < 6; k++) {
+        if (TacsRealPart(f[k]) > TacsRealPart(max)) {
+          max = f[k];
+        }
+      }
+
+      TacsScalar ksSum = 0.0;
+      for (int k = 0; k < 6; k++) {
+        ksSum += exp(ksWeight * (f[k] - max));
+      }
+      fail[i] = max + log(ksSum) / ksWeight;
+    } else {
+      TacsScalar s0 = Q11 * e0 + Q12 * e1;
+      TacsScalar s1 = Q12 * e0 + Q22 * e1;
+      TacsScalar s2 = Q66 * e2;
+
+      TacsScalar linTerm = F1 * s0 + F2 * s1;
+      TacsScalar quadTerm = F11 * s0 * s0 + F22 * s1 * s1 +
+                            2.0 * F12 * s0 * s1 + F66 * s2 * s2;
+      if (failureCriterion == TSAI_WU_MODIFIED) {
+        fail[i] = 0.5 * (linTerm + sqrt(linTerm * linTerm + 4.0 * quadTerm));
+      } else {
+        fail[i] = linTerm + quadTerm;
+      }
+    }
+  }
+}
+
+/*
+  Evaluate the failure criterion and its derivative w.r.t. the
+  laminate strain at a batch of points
+
+  The derivatives are returned in the same structure-of-arrays form as
+  the strain, dfdex[i] = d(fail[i])/d(ex[i]) and so on.
+*/
+void TACSOrthotropicPly::failureStrainSensBatch(
+    int n, const TacsScalar angles[], const TacsScalar ex[],
+    const TacsScalar ey[], const TacsScalar exy[], TacsScalar fail[],
+    TacsScalar dfdex[], TacsScalar dfdey[], TacsScalar dfdexy[]) {
+  if (failureCriterion == CUNTZE_UD || failureCriterion == CUNTZE_WOVEN) {
+    for (int i = 0; i < n; i++) {
+      TacsScalar strain[3] = {ex[i], ey[i], exy[i]}, sens[3];
+      fail[i] = failure(angles[i], strain);
+      failureStrainSens(angles[i], strain, sens);
+      dfdex[i] = sens[0];
+      dfdey[i] = sens[1];
+      dfdexy[i] = sens[2];
+    }
+    return;
+  }
+
+  TacsScalar cos2 = 1.0, sin2 = 0.0, sincos = 0.0;
+  for (int i = 0; i < n; i++) {
+    if (i == 0 || angles[i] != angles[i - 1]) {
+      TacsScalar cos1 = cos(angles[i]);
+      TacsScalar sin1 = sin(angles[i]);
+      cos2 = cos1 * cos1;
+      sin2 = sin1 * sin1;
+      sincos = sin1 * cos1;
+    }
+
+    // Compute the strain in the ply axis
+    TacsScalar e0 = cos2 * ex[i] + sin2 * ey[i] + sincos * exy[i];
+    TacsScalar e1 = sin2 * ex[i] + cos2 * ey[i] - sincos * exy[i];
+    TacsScalar e2 = 2.0 * sincos * (ey[i] - ex[i]) + (cos2 - sin2) * exy[i];
+
+    // The derivative of the failure criterion w.r.t. the ply strain
+    TacsScalar d0, d1, d2;
+    if (failureCriterion == MAX_STRAIN) {
+      TacsScalar f[6], fexp[6];
+      f[0] = e0 / eXt;
+      f[1] = -e0 / eXc;
+      f[2] = e1 / eYt;
+      f[3] = -e1 / eYc;
+      f[4] = e2 / eS12;
+      f[5] = -e2 / eS12;
+
+      TacsScalar max = f[0];
+      for (int k = 1; k < 6; k++) {
+        if (TacsRealPart(f[k]) > TacsRealPart(max)) {
+          max = f[k];
+        }
+      }
+
+      TacsScalar ksSum = 0.0;
+      for (int k = 0; k < 6; k++) {
+        fexp[k] = exp(ksWeight * (f[k] - max));
+        ksSum += fexp[k];
+      }
+      fail[i] = max + log(ksSum) / ksWeight;
+
+      d0 = (fexp[0] * eXc - fexp[1] * eXt) / (ksSum * eXt * eXc);
+      d1 = (fexp[2] * eYc - fexp[3] * eYt) / (ksSum * eYt * eYc);
+      d2 = (fexp[4] - fexp[5]) / (ksSum * eS12);
+    } else {
+      TacsScalar s0 = Q11 * e0 + Q12 * e1;
+      TacsScalar s1 = Q12 * e0 + Q22 * e1;
+      TacsScalar s2 = Q66 * e2;
+
+      TacsScalar linTerm = F1 * s0 + F2 * s1;
+      TacsScalar quadTerm = F11 * s0 * s0 + F22 * s1 * s1 +
+                            2.0 * F12 * s0 * s1 + F66 * s2 * s2;
+
+      // The derivative of the quadratic term w.r.t. the ply stress
+      TacsScalar dq0 = 2.0 * (F11 * s0 + F12 * s1);
+      TacsScalar dq1 = 2.0 * (F22 * s1 + F12 * s0);
+      TacsScalar dq2 = 2.0 * F66 * s2;
+
+      TacsScalar ds0, ds1, ds2;
+      if (failureCriterion == TSAI_WU_MODIFIED) {
+        if (TacsRealPart(s0) == 0.0 && TacsRealPart(s1) == 0.0 &&
+            TacsRealPart(s2) == 0.0) {
+          // Use the limit value at zero stress from the single point code
+          TacsScalar strain[3] = {ex[i], ey[i], exy[i]}, sens[3];
+          fail[i] = failureStrainSens(angles[i], strain, sens);
+          dfdex[i] = sens[0];
+          dfdey[i] = sens[1];
+          dfdexy[i] = sens[2];
+          continue;
+        }
+
+        TacsScalar root = sqrt(linTerm * linTerm + 4.0 * quadTerm);
+        fail[i] = 0.5 * (linTerm + root);
+        ds0 = 0.5 * F1 + (0.5 * linTerm * F1 + dq0) / root;
+        ds1 = 0.5 * F2 + (0.5 * linTerm * F2 + dq1) / root;
+        ds2 = dq2 / root;
+      } else {
+        fail[i] = linTerm + quadTerm;
+        ds0 = F1 + dq0;
+        ds1 = F2 + dq1;
+        ds2 = dq2;
+      }
+
+      // Convert the stress derivative to a ply strain derivative
+      d0 = Q11 * ds0 + Q12 * ds1;
+      d1 = Q12 * ds0 + Q22 * ds1;
+      d2 = Q66 * ds2;
+    }
+
+    // Transform the derivative to the laminate axis
+    dfdex[i] = cos2 * d0 + sin2 * d1 - 2.0 * sincos * d2;
+    dfdey[i] = sin2 * d0 + cos2 * d1 + 2.0 * sincos * d2;
+    dfdexy[i] = sincos * (d0 - d1) + (cos2 - sin2) * d2;
+  }
+}
+
+/*
+  Evaluate the KS aggregate of the failure criterion over a batch of
+  points
+
+  The failure values at each point are returned in fail. If the
+  derivative arrays are provided, they are set to the derivative of the
+  KS aggregate w.r.t. the laminate strain at each point.
+*/
+TacsScalar TACSOrthotropicPly::failureBatchKS(
+    int n, const TacsScalar angles[], const TacsScalar ex[],
+    const TacsScalar ey[], const TacsScalar exy[], double weight,
+    TacsScalar fail[], TacsScalar dfdex[], TacsScalar dfdey[],
+    TacsScalar dfdexy[]) {
+  if (n <= 0) {
+    return 0.0;
+  }
+
+  int compute_sens = (dfdex && dfdey && dfdexy);
+  if (compute_sens) {
+    failureStrainSensBatch(n, angles, ex, ey, exy, fail, dfdex, dfdey, dfdexy);
+  } else {
+    failureBatch(n, angles, ex, ey, exy, fail);
+  }
+
+  TacsScalar max = fail[0];
+  for (int i = 1; i < n; i++) {
+    if (TacsRealPart(fail[i]) > TacsRealPart(max)) {
+      max = fail[i];
+    }
+  }
+
+  TacsScalar ksSum = 0.0;
+  for (int i = 0; i < n; i++) {
+    ksSum += exp(weight * (fail[i] - max));
+  }
+
+  if (compute_sens) {
+    for (int i = 0; i < n; i++) {
+      TacsScalar w = exp(weight * (fail[i] - max)) / ksSum;
+      dfdex[i] *= w;
+      dfdey[i] *= w;
+      dfdexy[i] *= w;
+    }
+  }
+
+  return max + log(ksSum) / weight;
+}
+
 TacsScalar TACSOrthotropicPly::failureAngleSens(TacsScalar angle,
                                                 const TacsScalar strain[],
                                                 TacsScalar *failSens) {
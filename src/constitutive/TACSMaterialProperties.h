@@ -228,6 +228,24 @@ class TACSOrthotropicPly : public TACSObject {
   TacsScalar failureAngleSens(TacsScalar angle, const TacsScalar strain[],
                               TacsScalar *failSens);
 
+  // Evaluate the failure criterion at a batch of n points in one call.
+  // The laminate strains are passed in structure-of-arrays form.
+  // ------------------------------------------------------------------
+  void failureBatch(int n, const TacsScalar angles[], const TacsScalar ex[],
+                    const TacsScalar ey[], const TacsScalar exy[],
+                    TacsScalar fail[]);
+  void failureStrainSensBatch(int n, const TacsScalar angles[],
+                              const TacsScalar ex[], const TacsScalar ey[],
+                              const TacsScalar exy[], TacsScalar fail[],
+                              TacsScalar dfdex[], TacsScalar dfdey[],
+                              TacsScalar dfdexy[]);
+  TacsScalar failureBatchKS(int n, const TacsScalar angles[],
+                            const TacsScalar ex[], const TacsScalar ey[],
+                            const TacsScalar exy[], double weight,
+                            TacsScalar fail[], TacsScalar dfdex[] = NULL,
+                            TacsScalar dfdey[] = NULL,
+                            TacsScalar dfdexy[] = NULL);
+
   // Given the strain and stress in the local coordinates,
   // determine the failure modes of the Cuntze failure criterion
   // as well as the global failure value.
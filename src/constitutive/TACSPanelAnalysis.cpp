@@ -22,7 +22,11 @@
 
 #include "TACSPanelAnalysis.h"
 
+#include <pthread.h>
+
 #include "FElibrary.h"
+#include "TACSGaussQuadrature.h"
+#include "TACSLagrangeInterpolation.h"
 #include "tacslapack.h"
 
 /*
@@ -66,10 +70,10 @@
   BCs are applied exist along x = - beta*y, and x = - beta*y + Lx
 
   We use classical lamination theory, rather than first-order shear
-  deformation theory. All the constitutive objects used here are FSDT
-  stiffness objects, but the shear components are not used. (This is
-  for practical reasons, rather than requiring a full new set of
-  stiffness objects just for this class.)
+  deformation theory. All the constitutive objects used here are shell
+  constitutive objects, but the shear and drilling components are not
+  used. (This is for practical reasons, rather than requiring a full
+  new set of stiffness objects just for this class.)
 */
 
 /*
@@ -124,6 +128,10 @@ TACSPanelAnalysis::TACSPanelAnalysis(int _nnodes, int _nsegments, int _nbeams,
   // Set the eigenvalue tolerance
   lanczos_eigen_tol = 1e-12;
 
+  // The stiffness matrix factorization is computed on demand
+  Kfactor = NULL;
+  Kfactor_valid = 0;
+
   // The slope of the line x = - beta*y, that defines the rib locations
   beta = 0.0;
   if (theta != 0.0) {
@@ -131,10 +139,10 @@ TACSPanelAnalysis::TACSPanelAnalysis(int _nnodes, int _nsegments, int _nbeams,
   }
 
   Xpts = new TacsScalar[2 * nnodes];
-  panels = new FSDTStiffness *[nsegments];
+  panels = new TACSShellConstitutive *[nsegments];
   nodes = new int[2 * nsegments];
 
-  beams = new EBStiffness *[nbeams];
+  beams = new TACSBeamConstitutive *[nbeams];
   bnodes = new int[nbeams];
 
   segmentType = new int[nsegments];
@@ -177,8 +185,8 @@ TACSPanelAnalysis::TACSPanelAnalysis(int _nnodes, int _nsegments, int _nbeams,
   first_node_bc = (4 | 8);
   last_node_bc = (4 | 8);
 
-  memset(panels, 0, nsegments * sizeof(FSDTStiffness *));
-  memset(beams, 0, nbeams * sizeof(EBStiffness *));
+  memset(panels, 0, nsegments * sizeof(TACSShellConstitutive *));
+  memset(beams, 0, nbeams * sizeof(TACSBeamConstitutive *));
   memset(Xpts, 0, 2 * nnodes * sizeof(TacsScalar));
 
   // 4*nmodes variables for each node
@@ -193,8 +201,8 @@ TACSPanelAnalysis::TACSPanelAnalysis(int _nnodes, int _nsegments, int _nbeams,
 
   // The Gauss points and weights
   numGauss = 2;
-  gaussWts = FElibrary::gaussWts2;
-  gaussPts = FElibrary::gaussPts2;
+  gaussWts = TacsGaussQuadWts2;
+  gaussPts = TacsGaussQuadPts2;
 
   // The number of bands stored in the matrix
   nband = -1;
@@ -225,6 +233,10 @@ TACSPanelAnalysis::~TACSPanelAnalysis() {
   delete[] Xpts;
   delete[] vars;
 
+  if (Kfactor) {
+    delete[] Kfactor;
+  }
+
   // Delete design variable information if it was allocated
   if (XptConst) {
     delete[] XptConst;
@@ -264,6 +276,7 @@ void TACSPanelAnalysis::setLanczosSubspaceSize(int subspace_size) {
 */
 void TACSPanelAnalysis::setPoints(TacsScalar *_Xpts, int npoints) {
   memcpy(Xpts, _Xpts, 2 * nnodes * sizeof(TacsScalar));
+  clearStiffnessFactor();
 }
 
 /*
@@ -275,8 +288,9 @@ void TACSPanelAnalysis::setPoints(TacsScalar *_Xpts, int npoints) {
   stiff:    the constitutive object for this segment
   n1, n2:   the start and end nodes for this segment
 */
-void TACSPanelAnalysis::setSegment(int seg, int seg_type, FSDTStiffness *stiff,
-                                   int n1, int n2) {
+void TACSPanelAnalysis::setSegment(int seg, int seg_type,
+                                   TACSShellConstitutive *stiff, int n1,
+                                   int n2) {
   if (seg >= 0 && seg < nsegments) {
     if (stiff) {
       stiff->incref();
@@ -288,6 +302,7 @@ void TACSPanelAnalysis::setSegment(int seg, int seg_type, FSDTStiffness *stiff,
     panels[seg] = stiff;
     nodes[2 * seg] = n1;
     nodes[2 * seg + 1] = n2;
+    clearStiffnessFactor();
   }
 }
 
@@ -299,7 +314,8 @@ void TACSPanelAnalysis::setSegment(int seg, int seg_type, FSDTStiffness *stiff,
   stiff: the stiffness object associated with the beam
   n:     the node number at which to place the beam
 */
-void TACSPanelAnalysis::setBeam(int beam, EBStiffness *stiff, int n) {
+void TACSPanelAnalysis::setBeam(int beam, TACSBeamConstitutive *stiff,
+                                int n) {
   if (beam >= 0 && beam < nbeams) {
     if (stiff) {
       stiff->incref();
@@ -309,6 +325,7 @@ void TACSPanelAnalysis::setBeam(int beam, EBStiffness *stiff, int n) {
     }
     beams[beam] = stiff;
     bnodes[beam] = n;
+    clearStiffnessFactor();
   }
 }
 
@@ -552,9 +569,104 @@ void TACSPanelAnalysis::initialize() {
   // Adjust the bandwidth for the number of nodes
   nband = 4 * nmodes * nband - 1;
 
+  // The size of the stiffness matrix may have changed
+  if (Kfactor) {
+    delete[] Kfactor;
+    Kfactor = NULL;
+  }
+  clearStiffnessFactor();
+
   delete[] work;
 }
 
+/*
+  Set the design variables of a constitutive object from the values in
+  the global design variable array
+
+  The constitutive objects store their own design variables, whose
+  global numbers are obtained from getDesignVarNums(). Variables with
+  numbers outside the array are left unchanged.
+*/
+static void TacsSetConstitutiveDesignVars(TACSConstitutive *con,
+                                          const TacsScalar dvs[], int numDVs) {
+  int ndvs = con->getDesignVarNums(0, 0, NULL);
+  if (ndvs > 0) {
+    int *dvNums = new int[ndvs];
+    TacsScalar *x = new TacsScalar[ndvs];
+    con->getDesignVarNums(0, ndvs, dvNums);
+    con->getDesignVars(0, ndvs, x);
+    for (int i = 0; i < ndvs; i++) {
+      if (dvNums[i] >= 0 && dvNums[i] < numDVs) {
+        x[i] = dvs[dvNums[i]];
+      }
+    }
+    con->setDesignVars(0, ndvs, x);
+    delete[] dvNums;
+    delete[] x;
+  }
+}
+
+/*
+  Copy the design variables, or their bounds, of a constitutive object
+  into the global design variable arrays. The bounds are only copied
+  when lb and ub are not NULL.
+*/
+static void TacsGetConstitutiveDesignVars(TACSConstitutive *con,
+                                          TacsScalar dvs[], TacsScalar lb[],
+                                          TacsScalar ub[], int numDVs) {
+  int ndvs = con->getDesignVarNums(0, 0, NULL);
+  if (ndvs > 0) {
+    int *dvNums = new int[ndvs];
+    TacsScalar *x = new TacsScalar[3 * ndvs];
+    con->getDesignVarNums(0, ndvs, dvNums);
+    if (dvs) {
+      con->getDesignVars(0, ndvs, x);
+    }
+    if (lb && ub) {
+      con->getDesignVarRange(0, ndvs, &x[ndvs], &x[2 * ndvs]);
+    }
+    for (int i = 0; i < ndvs; i++) {
+      if (dvNums[i] >= 0 && dvNums[i] < numDVs) {
+        if (dvs) {
+          dvs[dvNums[i]] = x[i];
+        }
+        if (lb && ub) {
+          lb[dvNums[i]] = x[ndvs + i];
+          ub[dvNums[i]] = x[2 * ndvs + i];
+        }
+      }
+    }
+    delete[] dvNums;
+    delete[] x;
+  }
+}
+
+/*
+  Add the derivative with respect to the design variables of a
+  constitutive object to the global derivative array
+
+  input:
+  ndvs:     the number of design variables of the constitutive object
+  dfdx:     the derivative w.r.t. the design variables of the object
+
+  in/out:
+  fdvSens:  the global derivative array of length numDVs
+*/
+static void TacsAddConstitutiveDVSens(TACSConstitutive *con, int ndvs,
+                                      const TacsScalar dfdx[],
+                                      TacsScalar fdvSens[], int numDVs) {
+  if (ndvs > 0) {
+    int *dvNums = new int[ndvs];
+    con->getDesignVarNums(0, ndvs, dvNums);
+    for (int i = 0; i < ndvs; i++) {
+      if (dvNums[i] >= 0 && dvNums[i] < numDVs) {
+        fdvSens[dvNums[i]] += dfdx[i];
+      }
+    }
+    delete[] dvNums;
+  }
+}
+
 /*
   Set the design variable values in both the constitutive objects as
   well as the geometric design variables
@@ -565,11 +677,11 @@ void TACSPanelAnalysis::initialize() {
 */
 void TACSPanelAnalysis::setDesignVars(const TacsScalar dvs[], int numDVs) {
   for (int k = 0; k < nsegments; k++) {
-    panels[k]->setDesignVars(dvs, numDVs);
+    TacsSetConstitutiveDesignVars(panels[k], dvs, numDVs);
   }
 
   for (int k = 0; k < nbeams; k++) {
-    beams[k]->setDesignVars(dvs, numDVs);
+    TacsSetConstitutiveDesignVars(beams[k], dvs, numDVs);
   }
 
   // Set the geometric design variables
@@ -584,6 +696,9 @@ void TACSPanelAnalysis::setDesignVars(const TacsScalar dvs[], int numDVs) {
   }
 
   updateGeometry();
+
+  // The stiffness matrix must be re-factored for the new design
+  clearStiffnessFactor();
 }
 
 /*
@@ -599,11 +714,11 @@ void TACSPanelAnalysis::setDesignVars(const TacsScalar dvs[], int numDVs) {
 */
 void TACSPanelAnalysis::getDesignVars(TacsScalar dvs[], int numDVs) const {
   for (int k = 0; k < nsegments; k++) {
-    panels[k]->getDesignVars(dvs, numDVs);
+    TacsGetConstitutiveDesignVars(panels[k], dvs, NULL, NULL, numDVs);
   }
 
   for (int k = 0; k < nbeams; k++) {
-    beams[k]->getDesignVars(dvs, numDVs);
+    TacsGetConstitutiveDesignVars(beams[k], dvs, NULL, NULL, numDVs);
   }
 
   // Set the geometric design variables
@@ -633,11 +748,11 @@ void TACSPanelAnalysis::getDesignVars(TacsScalar dvs[], int numDVs) const {
 void TACSPanelAnalysis::getDesignVarRange(TacsScalar lb[], TacsScalar ub[],
                                           int numDVs) const {
   for (int k = 0; k < nsegments; k++) {
-    panels[k]->getDesignVarRange(lb, ub, numDVs);
+    TacsGetConstitutiveDesignVars(panels[k], NULL, lb, ub, numDVs);
   }
 
   for (int k = 0; k < nbeams; k++) {
-    beams[k]->getDesignVarRange(lb, ub, numDVs);
+    TacsGetConstitutiveDesignVars(beams[k], NULL, lb, ub, numDVs);
   }
 
   for (int k = 0; k < nDvGeo; k++) {
@@ -668,6 +783,99 @@ void TACSPanelAnalysis::updateGeometry() {
   }
 }
 
+/*
+  Get the stiffness of a panel segment
+
+  The stiffness is evaluated from the tangent stiffness of the shell
+  constitutive object.
+
+  output:
+  At, Bt, Dt:  the in-plane, bending-stretching and bending stiffness
+  Ast:         the transverse shear stiffness
+*/
+void TACSPanelAnalysis::getSegmentStiffness(int seg, TacsScalar At[],
+                                            TacsScalar Bt[], TacsScalar Dt[],
+                                            TacsScalar Ast[]) {
+  const double pt[3] = {0.0, 0.0, 0.0};
+  const TacsScalar X[3] = {0.0, 0.0, 0.0};
+  TacsScalar C[TACSShellConstitutive::NUM_TANGENT_STIFFNESS_ENTRIES];
+  panels[seg]->evalTangentStiffness(0, pt, X, C);
+
+  const TacsScalar *A, *B, *D, *As;
+  TacsScalar drill;
+  TACSShellConstitutive::extractTangentStiffness(C, &A, &B, &D, &As, &drill);
+  memcpy(At, A, 6 * sizeof(TacsScalar));
+  memcpy(Bt, B, 6 * sizeof(TacsScalar));
+  memcpy(Dt, D, 6 * sizeof(TacsScalar));
+  memcpy(Ast, As, 3 * sizeof(TacsScalar));
+}
+
+/*
+  Get the mass per unit area and the rotary inertia of a segment
+
+  output:
+  mass:  the integrals of rho and rho*z^2 through the thickness
+*/
+void TACSPanelAnalysis::getSegmentMass(int seg, TacsScalar mass[]) {
+  const double pt[3] = {0.0, 0.0, 0.0};
+  const TacsScalar X[3] = {0.0, 0.0, 0.0};
+  TacsScalar moments[3];
+  panels[seg]->evalMassMoments(0, pt, X, moments);
+  mass[0] = moments[0];
+  mass[1] = moments[2];
+}
+
+/*
+  Get the stiffness of a longitudinal beam
+
+  The beams in the finite-strip model use Euler--Bernoulli theory with
+  the strain components [axial, w'', v'', twist]. These correspond to
+  the axial, first and second bending and torsion components of the
+  beam constitutive object, so the 4x4 stiffness is extracted from the
+  symmetric 6x6 tangent stiffness in the packed upper-triangular
+  format.
+
+  output:
+  Ct:  the packed upper-triangular 4x4 stiffness matrix
+*/
+void TACSPanelAnalysis::getBeamStiffness(int beam, TacsScalar Ct[]) {
+  const double pt[3] = {0.0, 0.0, 0.0};
+  const TacsScalar X[3] = {0.0, 0.0, 0.0};
+  TacsScalar C[TACSBeamConstitutive::NUM_TANGENT_STIFFNESS_ENTRIES];
+  beams[beam]->evalTangentStiffness(0, pt, X, C);
+
+  Ct[0] = C[0];
+  Ct[1] = C[2];
+  Ct[2] = C[3];
+  Ct[3] = C[1];
+  Ct[4] = C[11];
+  Ct[5] = C[12];
+  Ct[6] = C[7];
+  Ct[7] = C[15];
+  Ct[8] = C[8];
+  Ct[9] = C[6];
+}
+
+/*
+  Get the mass moments of a longitudinal beam
+
+  output:
+  mass:  the moments [rho, rho*z, rho*y, rho*z^2, rho*y*z, rho*y^2]
+         where z is the first and y is the second bending direction
+*/
+void TACSPanelAnalysis::getBeamMass(int beam, TacsScalar mass[]) {
+  const double pt[3] = {0.0, 0.0, 0.0};
+  const TacsScalar X[3] = {0.0, 0.0, 0.0};
+  TacsScalar moments[6];
+  beams[beam]->evalMassMoments(0, pt, X, moments);
+  mass[0] = moments[0];
+  mass[1] = moments[1];
+  mass[2] = moments[2];
+  mass[3] = moments[3];
+  mass[4] = moments[5];
+  mass[5] = moments[4];
+}
+
 /*
   Compute the mass per unit area of the panel
 
@@ -693,9 +901,8 @@ TacsScalar TACSPanelAnalysis::computePtMass() {
     TacsScalar s = (Xpts[2 * n2 + 1] - Xpts[2 * n1 + 1]);
     TacsScalar Le = sqrt(c * c + s * s);
 
-    double pt[2] = {0.0, 0.0};
     TacsScalar mass[2];
-    panels[k]->getPointwiseMass(pt, mass);
+    getSegmentMass(k, mass);
     ptmass += mass[0] * Le;
   }
 
@@ -738,13 +945,19 @@ void TACSPanelAnalysis::addPtMassDVSens(TacsScalar scale, TacsScalar fdvSens[],
     TacsScalar s = (Xpts[2 * n2 + 1] - Xpts[2 * n1 + 1]);
     TacsScalar Le = sqrt(c * c + s * s);
 
-    double pt[2] = {0.0, 0.0};
-    TacsScalar alpha[2] = {scale * Le * invLy, 0.0};
-    panels[k]->addPointwiseMassDVSens(pt, alpha, fdvSens, numDVs);
+    const double pt[3] = {0.0, 0.0, 0.0};
+    const TacsScalar X[3] = {0.0, 0.0, 0.0};
+    TacsScalar alpha[3] = {scale * Le * invLy, 0.0, 0.0};
+    int ndvs = panels[k]->getDesignVarNums(0, 0, NULL);
+    TacsScalar *dfdx = new TacsScalar[ndvs];
+    memset(dfdx, 0, ndvs * sizeof(TacsScalar));
+    panels[k]->addMassMomentsDVSens(0, pt, X, alpha, ndvs, dfdx);
+    TacsAddConstitutiveDVSens(panels[k], ndvs, dfdx, fdvSens, numDVs);
+    delete[] dfdx;
 
     // Add the contribution to the pointmass
     TacsScalar mass[2];
-    panels[k]->getPointwiseMass(pt, mass);
+    getSegmentMass(k, mass);
     ptmass += mass[0] * Le;
   }
 
@@ -776,9 +989,8 @@ void TACSPanelAnalysis::addPtMassDVSens(TacsScalar scale, TacsScalar fdvSens[],
       TacsScalar Le = sqrt(c * c + s * s);
       TacsScalar sLe = (c * sc + s * ss) / Le;
 
-      double pt[2] = {0.0, 0.0};
       TacsScalar mass[2];
-      panels[k]->getPointwiseMass(pt, mass);
+      getSegmentMass(k, mass);
       sptmass += mass[0] * sLe;
     }
     sptmass *= invLy;
@@ -858,18 +1070,23 @@ Node out of range\n");
   e[3] = strain[3]*cos(t)
   e[4] = strain[4]*cos(t)**3
   e[5] = strain[5]*cos(t)**2
+
+  The strain has the TACSShellConstitutive::NUM_STRESSES components of
+  the shell strain, where the shear and drilling strain are only used
+  for the skin segments.
 */
 void TACSPanelAnalysis::failure(const TacsScalar strain[], TacsScalar fail[],
                                 int nfail) {
   const double pt[3] = {0.0, 0.0, 0.0};
+  const TacsScalar X[3] = {0.0, 0.0, 0.0};
 
   for (int k = 0; k < numFailPoints && k < nfail; k++) {
     int seg = failSegments[k];
     if (failPointIsSkin[k]) {
-      panels[seg]->failure(pt, strain, &fail[k]);
+      fail[k] = panels[seg]->evalFailure(0, pt, X, strain);
     } else {
       // Compute the strain at the midpoint of the segment
-      TacsScalar e[8];
+      TacsScalar e[TACSShellConstitutive::NUM_STRESSES];
       TacsScalar z = Xpts[2 * failNodes[k] + 1];
 
       int n1 = nodes[2 * seg];
@@ -878,40 +1095,38 @@ void TACSPanelAnalysis::failure(const TacsScalar strain[], TacsScalar fail[],
       TacsScalar s = (Xpts[2 * n2 + 1] - Xpts[2 * n1 + 1]);
       TacsScalar Le = sqrt(c * c + s * s);
       c = c / Le;
-      s = s / Le;
 
+      memset(e, 0, TACSShellConstitutive::NUM_STRESSES * sizeof(TacsScalar));
       e[0] = (strain[0] + z * strain[3]);
-      e[1] = e[2] = 0.0;
-
       e[3] = strain[3] * c;
-      e[4] = e[5] = e[6] = e[7] = 0.0;
 
-      panels[seg]->failure(pt, e, &fail[k]);
+      fail[k] = panels[seg]->evalFailure(0, pt, X, e);
     }
   }
 }
 
 /*
   Compute the derivative of the failure function with respect to the
-  given design variable number. Add the result times the weight vector
-  to the array failDVSens.
+  design variables. Add the result times the weight vector to the
+  array fdvSens.
 
   This function can be used to compute the derivative of an aggregated
   failure function w.r.t. the design variables.
 
   input:
-  dvNum:   the design variable number
   strain:  the strain at the point in the constitutive object
   weights: the weight associated with each failure point
   nfail:   the number of failure points = len(weights)
+  dvLen:   the length of the derivative array
 
   output:
-  failDVSens:  the derivative of the failure function w.r.t. design vars
+  fdvSens: the derivative of the failure function w.r.t. design vars
 */
 void TACSPanelAnalysis::addFailureDVSens(const TacsScalar strain[],
                                          const TacsScalar weights[], int nfail,
                                          TacsScalar fdvSens[], int dvLen) {
-  const double pt[2] = {0.0, 0.0};
+  const double pt[3] = {0.0, 0.0, 0.0};
+  const TacsScalar X[3] = {0.0, 0.0, 0.0};
 
   for (int dv = 0; dv < nDvGeo; dv++) {
     TacsScalar failDVSens = 0.0;
@@ -919,7 +1134,7 @@ void TACSPanelAnalysis::addFailureDVSens(const TacsScalar strain[],
       int seg = failSegments[k];
       if (!failPointIsSkin[k]) {
         // Compute the strain at the midpoint of the segment
-        TacsScalar e[8];
+        TacsScalar e[TACSShellConstitutive::NUM_STRESSES];
         TacsScalar z = Xpts[2 * failNodes[k] + 1];
         TacsScalar sz = XptLin[2 * nnodes * dv + 2 * failNodes[k] + 1];
 
@@ -937,14 +1152,12 @@ void TACSPanelAnalysis::addFailureDVSens(const TacsScalar strain[],
         sc = (sc * Le - sLe * c) / (Le * Le);
         c = c / Le;
 
+        memset(e, 0, TACSShellConstitutive::NUM_STRESSES * sizeof(TacsScalar));
         e[0] = (strain[0] + z * strain[3]);
-        e[1] = e[2] = 0.0;
-
         e[3] = strain[3] * c;
-        e[4] = e[5] = e[6] = e[7] = 0.0;
 
-        TacsScalar eSens[8];
-        panels[seg]->failureStrainSens(pt, e, eSens);
+        TacsScalar eSens[TACSShellConstitutive::NUM_STRESSES];
+        panels[seg]->evalFailureStrainSens(0, pt, X, e, eSens);
         failDVSens += weights[k] *
                       (eSens[0] * sz * strain[3] + eSens[3] * sc * strain[3]);
       }
@@ -959,11 +1172,15 @@ void TACSPanelAnalysis::addFailureDVSens(const TacsScalar strain[],
   // of the material design variables
   for (int k = 0; k < numFailPoints && k < nfail; k++) {
     int seg = failSegments[k];
+    int ndvs = panels[seg]->getDesignVarNums(0, 0, NULL);
+    TacsScalar *dfdx = new TacsScalar[ndvs];
+    memset(dfdx, 0, ndvs * sizeof(TacsScalar));
+
     if (failPointIsSkin[k]) {
-      panels[seg]->addFailureDVSens(pt, strain, weights[k], fdvSens, dvLen);
+      panels[seg]->addFailureDVSens(0, weights[k], pt, X, strain, ndvs, dfdx);
     } else {
       // Compute the strain at the midpoint of the segment
-      TacsScalar e[8];
+      TacsScalar e[TACSShellConstitutive::NUM_STRESSES];
       TacsScalar z = Xpts[2 * failNodes[k] + 1];
 
       int n1 = nodes[2 * seg];
@@ -972,16 +1189,16 @@ void TACSPanelAnalysis::addFailureDVSens(const TacsScalar strain[],
       TacsScalar s = (Xpts[2 * n2 + 1] - Xpts[2 * n1 + 1]);
       TacsScalar Le = sqrt(c * c + s * s);
       c = c / Le;
-      s = s / Le;
 
+      memset(e, 0, TACSShellConstitutive::NUM_STRESSES * sizeof(TacsScalar));
       e[0] = (strain[0] + z * strain[3]);
-      e[1] = e[2] = 0.0;
-
       e[3] = strain[3] * c;
-      e[4] = e[5] = e[6] = e[7] = 0.0;
 
-      panels[seg]->addFailureDVSens(pt, e, weights[k], fdvSens, dvLen);
+      panels[seg]->addFailureDVSens(0, weights[k], pt, X, e, ndvs, dfdx);
     }
+
+    TacsAddConstitutiveDVSens(panels[seg], ndvs, dfdx, fdvSens, dvLen);
+    delete[] dfdx;
   }
 }
 
@@ -1001,31 +1218,24 @@ void TACSPanelAnalysis::addFailureDVSens(const TacsScalar strain[],
 void TACSPanelAnalysis::failureStrainSens(const TacsScalar strain[],
                                           const TacsScalar weights[], int nfail,
                                           TacsScalar failSens[]) {
+  const int nstress = TACSShellConstitutive::NUM_STRESSES;
   const double pt[3] = {0.0, 0.0, 0.0};
+  const TacsScalar X[3] = {0.0, 0.0, 0.0};
 
-  failSens[0] = failSens[1] = failSens[2] = failSens[3] = 0.0;
-  failSens[4] = failSens[5] = failSens[6] = failSens[7] = 0.0;
+  memset(failSens, 0, nstress * sizeof(TacsScalar));
 
   for (int k = 0; k < numFailPoints && k < nfail; k++) {
     int seg = failSegments[k];
     if (failPointIsSkin[k]) {
-      TacsScalar eSens[8];
-      panels[seg]->failureStrainSens(pt, strain, eSens);
-
-      failSens[0] += weights[k] * eSens[0];
-      failSens[1] += weights[k] * eSens[1];
-      failSens[2] += weights[k] * eSens[2];
-
-      failSens[3] += weights[k] * eSens[3];
-      failSens[4] += weights[k] * eSens[4];
-      failSens[5] += weights[k] * eSens[5];
+      TacsScalar eSens[nstress];
+      panels[seg]->evalFailureStrainSens(0, pt, X, strain, eSens);
 
-      failSens[6] += weights[k] * eSens[6];
-      failSens[7] += weights[k] * eSens[7];
+      for (int i = 0; i < nstress; i++) {
+        failSens[i] += weights[k] * eSens[i];
+      }
     } else {
       // Compute the strain at the midpoint of the segment
-      TacsScalar e[8];
-      int seg = failSegments[k];
+      TacsScalar e[nstress];
       TacsScalar z = Xpts[2 * failNodes[k] + 1];
 
       int n1 = nodes[2 * seg];
@@ -1034,16 +1244,13 @@ void TACSPanelAnalysis::failureStrainSens(const TacsScalar strain[],
       TacsScalar s = (Xpts[2 * n2 + 1] - Xpts[2 * n1 + 1]);
       TacsScalar Le = sqrt(c * c + s * s);
       c = c / Le;
-      s = s / Le;
 
+      memset(e, 0, nstress * sizeof(TacsScalar));
       e[0] = (strain[0] + z * strain[3]);
-      e[1] = e[2] = 0.0;
-
       e[3] = strain[3] * c;
-      e[4] = e[5] = e[6] = e[7] = 0.0;
 
-      TacsScalar eSens[8];
-      panels[seg]->failureStrainSens(pt, e, eSens);
+      TacsScalar eSens[nstress];
+      panels[seg]->evalFailureStrainSens(0, pt, X, e, eSens);
 
       failSens[0] += weights[k] * eSens[0];
       failSens[3] += weights[k] * (z * eSens[0] + c * eSens[3]);
@@ -1071,8 +1278,6 @@ void TACSPanelAnalysis::failureStrainSens(const TacsScalar strain[],
 */
 void TACSPanelAnalysis::computeStiffness(TacsScalar A[], TacsScalar B[],
                                          TacsScalar D[], TacsScalar As[]) {
-  double pt[3] = {0.0, 0.0, 0.0};
-
   for (int k = 0; k < 6; k++) {
     A[k] = B[k] = D[k] = 0.0;
   }
@@ -1090,7 +1295,7 @@ void TACSPanelAnalysis::computeStiffness(TacsScalar A[], TacsScalar B[],
     double kcorr = 5.0 / 6.0;
     TacsScalar At[6], Bt[6], Dt[6], Ast[3];
     ;
-    panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
+    getSegmentStiffness(k, At, Bt, Dt, Ast);
 
     if (segmentType[k] == STIFFENER_SEGMENT) {
       TacsScalar A11 = (At[0] * At[3] - At[1] * At[1]) / At[3];
@@ -1189,7 +1394,7 @@ void TACSPanelAnalysis::computeStiffnessDVSens( int dvNum,
 
         double kcorr = 5.0/6.0;
         TacsScalar At[6], Bt[6], Dt[6], Ast[3];
-        panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
+        getSegmentStiffness(k, At, Bt, Dt, Ast);
 
         if (segmentType[k] == STIFFENER_SEGMENT){
           TacsScalar A11 = (At[0]*At[3] - At[1]*At[1])/At[3];
@@ -1262,7 +1467,7 @@ void TACSPanelAnalysis::computeStiffnessDVSens( int dvNum,
         double kcorr = 5.0/6.0;
         TacsScalar At[6], Bt[6], Dt[6], Ast[3];
         TacsScalar sAt[6], sBt[6], sDt[6], sAst[3];
-        panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
+        getSegmentStiffness(k, At, Bt, Dt, Ast);
         panels[k]->getStiffnessDVSens(dvNum, pt, sAt, sBt, sDt, sAst);
 
         if (segmentType[k] == STIFFENER_SEGMENT){
@@ -1342,6 +1547,13 @@ void TACSPanelAnalysis::computeStiffnessDVSens( int dvNum,
 
   Note that the size of the work space required is: n*(m+2) + 4*m + m*m
 
+  The Cholesky factorization of B must be computed before calling this
+  function (e.g. with LAPACKpbtrf). This allows the same factorization
+  to be re-used for multiple eigenvalue problems. When B is the
+  stiffness matrix, this is a shift-invert transformation about zero
+  such that the eigenvalues of interest are at the ends of the
+  spectrum where the Lanczos method converges quickly.
+
   Note that if lm is set to true, we find the largest magnitude
   eigenvalues: those corresponding to both the largest and smallest
   values.
@@ -1355,7 +1567,7 @@ void TACSPanelAnalysis::computeStiffnessDVSens( int dvNum,
   A:      the matrix A stored in a banded diagonal format
   lda:    the leading dimension of A (>= ka + 1)
   kb:     the number of sub or super-diagonas in B
-  B:      the matirx B stored in a banded diagonal format
+  B:      the Cholesky factor of B stored in a banded diagonal format
   ldb:    the leading dimension of B (>= kb + 1)
   k:      the number of requested converged eigenvalues
   m:      the size of the Lanczos factorization
@@ -1376,17 +1588,6 @@ requires a larger subspace\n");
     return -1;
   }
 
-  // Factor the B matrix using a Cholesky factorization
-  int info;
-  LAPACKpbtrf(buplo, &n, &kb, B, &ldb, &info);
-  if (info != 0) {
-    fprintf(stderr,
-            "TACSPanelAnalysis: Error, Cholesky \
-factorizaiton failed: %d\n",
-            info);
-    return info;
-  }
-
   // Set up the data that we will be accessing
   TacsScalar *V = work;                          // (m+1)*n locations
   TacsScalar *tmp = &work[n * (m + 1)];          // n locations
@@ -1396,11 +1597,15 @@ factorizaiton failed: %d\n",
   // Keep track of how many eigenvalues have converged
   int nconv = 0, npconv = 0;
 
-  // Randomly generate an initial vector that will be used
-  // as the starting point to generate the Lanczos basis
+  // Randomly generate an initial vector that will be used as the
+  // starting point to generate the Lanczos basis. A local generator is
+  // used instead of rand() so that the results are reproducible and
+  // panels can be analyzed concurrently.
   TacsScalar *v0 = &V[0];
+  unsigned int seed = 1;
   for (int i = 0; i < n; i++) {
-    v0[i] = -1.0 + 2.0 * rand() / RAND_MAX;
+    seed = 1103515245U * seed + 12345U;
+    v0[i] = -1.0 + 2.0 * ((seed >> 16) & 0x7fff) / 32767.0;
   }
 
   // Normalize the initial estimate
@@ -1610,62 +1815,91 @@ did not converge to zero\n",
 }
 
 /*
-  Compute the solution with a uniform pressure load on the skin
-  panels.
-
-  Solve the system of equations:
+  Assemble the stiffness matrix in the upper banded storage format
 
-  K*x = f
+  output:
+  K:   the stiffness matrix of size (nband + 1)*nvars
 */
-int TACSPanelAnalysis::computePressureLoad(TacsScalar p,
-                                           const char *file_name) {
-  double pt[3] = {0.0, 0.0, 0.0};
-
-  int nentries = (nband + 1) * nvars;
-  TacsScalar *K = new TacsScalar[nentries];
-  TacsScalar *f = new TacsScalar[nvars];
-
-  memset(K, 0, nentries * sizeof(TacsScalar));
-  memset(f, 0, nvars * sizeof(TacsScalar));
+void TACSPanelAnalysis::assembleStiffness(TacsScalar K[]) {
+  memset(K, 0, (nband + 1) * nvars * sizeof(TacsScalar));
 
   for (int k = 0; k < nsegments; k++) {
-    // Compute the stiffness matrix and geometric stiffness matrix
-    // corresponding to this segment node
-    int n1 = nodes[2 * k];
-    int n2 = nodes[2 * k + 1];
-
     // Add the contribution to the stiffness matrix
     TacsScalar At[6], Bt[6], Dt[6], Ast[3];
-    panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
-    addStiffMat(K, n1, n2, At, Bt, Dt);
-
-    if (segmentType[k] == SKIN_SEGMENT) {
-      addPressureLoad(f, n1, n2, p);
-    }
+    getSegmentStiffness(k, At, Bt, Dt, Ast);
+    addStiffMat(K, nodes[2 * k], nodes[2 * k + 1], At, Bt, Dt);
   }
 
   for (int k = 0; k < nbeams; k++) {
     TacsScalar Ct[10];
-    beams[k]->getStiffness(pt, Ct);
+    getBeamStiffness(k, Ct);
     addStiffMatBeam(K, bnodes[k], Ct);
   }
+}
 
-  int info, one = 1;
-  int ldk = nband + 1;
-  LAPACKdpbsv("U", &nvars, &nband, &one, K, &ldk, f, &nvars, &info);
+/*
+  Assemble the stiffness matrix and compute its Cholesky factorization
 
+  The stiffness matrix does not depend on the applied loads, so the
+  factorization is stored and re-used for all subsequent buckling,
+  frequency and pressure load computations until the design variables
+  or the panel model are modified.
+*/
+int TACSPanelAnalysis::factorStiffness() {
+  if (Kfactor_valid) {
+    return 0;
+  }
+
+  if (!Kfactor) {
+    Kfactor = new TacsScalar[(nband + 1) * nvars];
+  }
+  assembleStiffness(Kfactor);
+
+  int info, ldk = nband + 1;
+  LAPACKpbtrf("U", &nvars, &nband, Kfactor, &ldk, &info);
   if (info != 0) {
     fprintf(stderr,
-            "TACSPanelAnalysis: Error in LAPACK Cholesky factorization\
- info = %d\n",
+            "TACSPanelAnalysis: Error, Cholesky \
+factorization failed: %d\n",
             info);
+    return info;
   }
 
-  if (file_name) {
-    printPanelMode(file_name, f, 125);
+  Kfactor_valid = 1;
+  return 0;
+}
+
+/*
+  Compute the solution with a uniform pressure load on the skin
+  panels.
+
+  Solve the system of equations:
+
+  K*x = f
+*/
+int TACSPanelAnalysis::computePressureLoad(TacsScalar p,
+                                           const char *file_name) {
+  TacsScalar *f = new TacsScalar[nvars];
+  memset(f, 0, nvars * sizeof(TacsScalar));
+
+  for (int k = 0; k < nsegments; k++) {
+    if (segmentType[k] == SKIN_SEGMENT) {
+      addPressureLoad(f, nodes[2 * k], nodes[2 * k + 1], p);
+    }
+  }
+
+  // Solve U^{T}*U*x = f using the factored stiffness matrix
+  int info = factorStiffness();
+  if (info == 0) {
+    int incx = 1, ldk = nband + 1;
+    BLAStbsv("U", "T", "N", &nvars, &nband, Kfactor, &ldk, f, &incx);
+    BLAStbsv("U", "N", "N", &nvars, &nband, Kfactor, &ldk, f, &incx);
+
+    if (file_name) {
+      printPanelMode(file_name, f, 125);
+    }
   }
 
-  delete[] K;
   delete[] f;
 
   return info;
@@ -1788,6 +2022,124 @@ int TACSPanelAnalysis::computeBucklingLoads(TacsScalar Nxy,
   return info;
 }
 
+/*
+  Data shared between the threads that compute the buckling loads for
+  a list of panels
+*/
+class TACSPanelBucklingThreadInfo {
+ public:
+  int npanels;
+  TACSPanelAnalysis **panels;
+  const TacsScalar *Nx, *Nxy;
+  TacsScalar *loads;
+  int nloads;
+
+  // The next panel to analyze and the failure flag
+  int next_panel;
+  int fail;
+  pthread_mutex_t mutex;
+};
+
+/*
+  Analyze panels from the list until there are none remaining
+*/
+static void *TacsPanelBucklingThread(void *t) {
+  TACSPanelBucklingThreadInfo *pinfo =
+      static_cast<TACSPanelBucklingThreadInfo *>(t);
+
+  while (1) {
+    pthread_mutex_lock(&pinfo->mutex);
+    int index = pinfo->next_panel;
+    pinfo->next_panel++;
+    pthread_mutex_unlock(&pinfo->mutex);
+
+    if (index >= pinfo->npanels) {
+      break;
+    }
+
+    int fail = pinfo->panels[index]->computeBucklingLoads(
+        pinfo->Nx[index], pinfo->Nxy[index],
+        &pinfo->loads[pinfo->nloads * index], pinfo->nloads);
+
+    if (fail) {
+      pthread_mutex_lock(&pinfo->mutex);
+      pinfo->fail = fail;
+      pthread_mutex_unlock(&pinfo->mutex);
+    }
+  }
+
+  return NULL;
+}
+
+/*
+  Compute the first 'nloads' critical buckling loads for each panel
+  in a list, distributing the panels between a number of threads.
+
+  The panel analysis objects are independent, so each panel is
+  analyzed by a single thread. Note that each entry in the list must
+  be a distinct TACSPanelAnalysis object.
+
+  input:
+  npanels:     the number of panels
+  panels:      the panel analysis objects
+  Nx:          the axial force per unit length for each panel
+  Nxy:         the shear force per unit length for each panel
+  nloads:      the number of loads to compute for each panel
+  num_threads: the number of threads to use
+
+  output:
+  loads:       the critical loads, stored as loads[nloads*panel + k]
+*/
+int TACSPanelAnalysis::computeBucklingLoads(int npanels,
+                                            TACSPanelAnalysis *panels[],
+                                            const TacsScalar Nx[],
+                                            const TacsScalar Nxy[],
+                                            TacsScalar loads[], int nloads,
+                                            int num_threads) {
+  TACSPanelBucklingThreadInfo pinfo;
+  pinfo.npanels = npanels;
+  pinfo.panels = panels;
+  pinfo.Nx = Nx;
+  pinfo.Nxy = Nxy;
+  pinfo.loads = loads;
+  pinfo.nloads = nloads;
+  pinfo.next_panel = 0;
+  pinfo.fail = 0;
+  pthread_mutex_init(&pinfo.mutex, NULL);
+
+  if (num_threads > npanels) {
+    num_threads = npanels;
+  }
+
+  if (num_threads > 1) {
+    pthread_t *threads = new pthread_t[num_threads];
+
+    // Create the joinable attribute
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+
+    for (int k = 0; k < num_threads; k++) {
+      pthread_create(&threads[k], &attr, TacsPanelBucklingThread,
+                     (void *)&pinfo);
+    }
+
+    // Join all the threads
+    for (int k = 0; k < num_threads; k++) {
+      pthread_join(threads[k], NULL);
+    }
+
+    pthread_attr_destroy(&attr);
+    delete[] threads;
+  } else {
+    TacsPanelBucklingThread((void *)&pinfo);
+  }
+
+  pthread_mutex_destroy(&pinfo.mutex);
+
+  return pinfo.fail;
+}
+
 /*
   This code computes the eigenvalues associated with a
   buckling problem.
@@ -1820,38 +2172,14 @@ int TACSPanelAnalysis::computeBucklingLoads(const TacsScalar segmentLoads[],
                                             int neigs, TacsScalar eigvals[],
                                             TacsScalar eigvecs[],
                                             int two_sided) {
-  // The parametric point where we evaluate the stiffness
-  double pt[3] = {0.0, 0.0, 0.0};
-
-  // K: the stiffness matrix
   // G: the geometric stiffness matrix
   int nentries = (nband + 1) * nvars;
-
-  TacsScalar *K = new TacsScalar[nentries];
   TacsScalar *G = new TacsScalar[nentries];
-
-  memset(K, 0, nentries * sizeof(TacsScalar));
   memset(G, 0, nentries * sizeof(TacsScalar));
 
   for (int k = 0; k < nsegments; k++) {
-    // Compute the stiffness matrix and geometric stiffness matrix
-    // corresponding to this segment node
-    int n1 = nodes[2 * k];
-    int n2 = nodes[2 * k + 1];
-
-    // Add the contribution to the stiffness matrix
-    TacsScalar At[6], Bt[6], Dt[6], Ast[3];
-    panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
-    addStiffMat(K, n1, n2, At, Bt, Dt);
-
     // Add the contribution to the geometric stiffness matrix
-    addGeoStiffMat(G, &segmentLoads[3 * k], n1, n2);
-  }
-
-  for (int k = 0; k < nbeams; k++) {
-    TacsScalar Ct[10];
-    beams[k]->getStiffness(pt, Ct);
-    addStiffMatBeam(K, bnodes[k], Ct);
+    addGeoStiffMat(G, &segmentLoads[3 * k], nodes[2 * k], nodes[2 * k + 1]);
   }
 
   int info = 0;
@@ -1859,10 +2187,13 @@ int TACSPanelAnalysis::computeBucklingLoads(const TacsScalar segmentLoads[],
     int ldz = nvars;
     int ldk = nband + 1, ldg = nband + 1;
 
-    // Allocate space for the matrices required
+    // Allocate space for the matrices required. Note that the LAPACK
+    // routine over-writes the stiffness matrix with its factorization
+    TacsScalar *K = new TacsScalar[nentries];
     TacsScalar *eigs = new TacsScalar[nvars];
     TacsScalar *Z = new TacsScalar[nvars * nvars];
     TacsScalar *work = new TacsScalar[3 * nvars];
+    assembleStiffness(K);
 
     LAPACKdsbgv("V", "U", &nvars, &nband, &nband, G, &ldg, K, &ldk, eigs, Z,
                 &ldz, work, &info);
@@ -1890,23 +2221,30 @@ positive definite\n");
       }
     }
 
+    delete[] K;
     delete[] eigs;
     delete[] Z;
     delete[] work;
   } else {
-    // Solve the eigenvalue problem K*u + load*G*u = 0
-    int m = lanczos_subspace_size;
-    double tol = lanczos_eigen_tol;
-    int lwork = nvars * (m + 2) + m * m + 4 * m;
-    TacsScalar *work = new TacsScalar[lwork];
-
-    info = computeEigenvalues(two_sided, "U", "U", nvars, nband, G, nband + 1,
-                              nband, K, nband + 1, neigs, m, work, tol, eigvals,
-                              eigvecs);
-    delete[] work;
+    // Retrieve the factored stiffness matrix. This is shared between
+    // all load cases until the design variables are modified.
+    info = factorStiffness();
+
+    if (info == 0) {
+      // Solve the eigenvalue problem K*u + load*G*u = 0 for the lowest
+      // loads only, using K^{-1} as the shift-invert operator
+      int m = lanczos_subspace_size;
+      double tol = lanczos_eigen_tol;
+      int lwork = nvars * (m + 2) + m * m + 4 * m;
+      TacsScalar *work = new TacsScalar[lwork];
+
+      info = computeEigenvalues(two_sided, "U", "U", nvars, nband, G,
+                                nband + 1, nband, Kfactor, nband + 1, neigs, m,
+                                work, tol, eigvals, eigvecs);
+      delete[] work;
+    }
   }
 
-  delete[] K;
   delete[] G;
 
   return info;
@@ -2057,7 +2395,7 @@ int TACSPanelAnalysis::computeBucklingLoadsDVSens( TacsScalar Nx,
       for ( int k = 0; k < nsegments; k++ ){
         // Geometric design variable
         TacsScalar At[6], Bt[6], Dt[6], Ast[3];
-        panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
+        getSegmentStiffness(k, At, Bt, Dt, Ast);
 
         // Add the positive load contribution
         addStiffMatGeoSens(posKSens, dv, eigvecs, nvars, nloads,
@@ -2080,7 +2418,7 @@ int TACSPanelAnalysis::computeBucklingLoadsDVSens( TacsScalar Nx,
     else if (designVarTypes[n] == 2){
       for ( int k = 0; k < nsegments; k++ ){
         TacsScalar At[6], Bt[6], Dt[6], Ast[3];
-        panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
+        getSegmentStiffness(k, At, Bt, Dt, Ast);
 
         // Add the positive load contribution
         addStiffMatLxSens(posKSens, eigvecs, nvars, nloads,
@@ -2176,7 +2514,7 @@ int TACSPanelAnalysis::computeFrequencies(TacsScalar freq[], int nfreq,
     char *file_name = new char[file_len];
 
     for (int i = 0; i < nfreq; i++) {
-      snprintf(file_name, sizeof(file_name), "%spanel_mode%02d.dat", prefix, i);
+      snprintf(file_name, file_len, "%spanel_mode%02d.dat", prefix, i);
       printPanelMode(file_name, &eigvecs[nvars * i], 125);
     }
 
@@ -2200,45 +2538,22 @@ int TACSPanelAnalysis::computeFrequencies(TacsScalar freq[], int nfreq,
 */
 int TACSPanelAnalysis::computeFrequencies(int neigs, TacsScalar eigvals[],
                                           TacsScalar eigvecs[]) {
-  double pt[3] = {0.0, 0.0, 0.0};
-
-  // K: the stiffness matrix
   // M: the mass matrix
   int nentries = (nband + 1) * nvars;
-
-  TacsScalar *K = new TacsScalar[nentries];
   TacsScalar *M = new TacsScalar[nentries];
-
-  memset(K, 0, nentries * sizeof(TacsScalar));
   memset(M, 0, nentries * sizeof(TacsScalar));
 
   for (int k = 0; k < nsegments; k++) {
-    // Compute the stiffness matrix and geometric stiffness matrix
-    // corresponding to this segment node
-    int n1 = nodes[2 * k];
-    int n2 = nodes[2 * k + 1];
-
-    // Add the contribution to the stiffness matrix
-    TacsScalar At[6], Bt[6], Dt[6], Ast[3];
-    panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
-    addStiffMat(K, n1, n2, At, Bt, Dt);
-
     // Add the contribution to the mass matrix
-    double pt[2] = {0.0, 0.0};
     TacsScalar mass[2];
-    panels[k]->getPointwiseMass(pt, mass);
-    addMassMat(M, n1, n2, mass);
+    getSegmentMass(k, mass);
+    addMassMat(M, nodes[2 * k], nodes[2 * k + 1], mass);
   }
 
   for (int k = 0; k < nbeams; k++) {
-    TacsScalar Ct[10];
-    beams[k]->getStiffness(pt, Ct);
-    addStiffMatBeam(K, bnodes[k], Ct);
-
     // Add the contribution to the mass matrix
-    double pt[2] = {0.0, 0.0};
     TacsScalar mass[6];
-    beams[k]->getPointwiseMass(pt, mass);
+    getBeamMass(k, mass);
     addMassMatBeam(M, bnodes[k], mass);
   }
 
@@ -2248,9 +2563,11 @@ int TACSPanelAnalysis::computeFrequencies(int neigs, TacsScalar eigvals[],
     int ldk = nband + 1, ldm = nband + 1;
 
     // Allocate space for the solution
+    TacsScalar *K = new TacsScalar[nentries];
     TacsScalar *eigs = new TacsScalar[nvars];
     TacsScalar *Z = new TacsScalar[nvars * nvars];
     TacsScalar *work = new TacsScalar[3 * nvars];
+    assembleStiffness(K);
 
     LAPACKdsbgv("V", "U", &nvars, &nband, &nband, K, &ldk, M, &ldm, eigs, Z,
                 &nvars, work, &info);
@@ -2270,24 +2587,44 @@ int TACSPanelAnalysis::computeFrequencies(int neigs, TacsScalar eigvals[],
       }
     }
 
+    delete[] K;
     delete[] eigs;
     delete[] work;
     delete[] Z;
   } else {
-    // Solve the eigenvalue problem K*u + eig*M*u = 0
-    int m = lanczos_subspace_size;
-    double tol = lanczos_eigen_tol;
-    int lwork = nvars * (m + 2) + m * m + 4 * m;
-    TacsScalar *work = new TacsScalar[lwork];
-    int two_sided = 0;
-
-    info = computeEigenvalues(two_sided, "U", "U", nvars, nband, K, nband + 1,
-                              nband, M, nband + 1, neigs, m, work, tol, eigvals,
-                              eigvecs);
-    delete[] work;
+    // Retrieve the factored stiffness matrix
+    info = factorStiffness();
+
+    if (info == 0) {
+      // Solve the shift-invert problem -M*u = mu*K*u. The lowest
+      // frequencies correspond to the most negative values of
+      // mu = -1/lambda which converge first in the Lanczos method.
+      for (int i = 0; i < nentries; i++) {
+        M[i] *= -1.0;
+      }
+
+      int m = lanczos_subspace_size;
+      double tol = lanczos_eigen_tol;
+      int lwork = nvars * (m + 2) + m * m + 4 * m;
+      TacsScalar *work = new TacsScalar[lwork];
+      int two_sided = 0;
+
+      info = computeEigenvalues(two_sided, "U", "U", nvars, nband, M,
+                                nband + 1, nband, Kfactor, nband + 1, neigs, m,
+                                work, tol, eigvals, eigvecs);
+      delete[] work;
+
+      // Convert back to the eigenvalues of K*u = lambda*M*u and scale
+      // the eigenvectors so that they are normalized with respect to M
+      int incx = 1;
+      for (int k = 0; k < neigs; k++) {
+        eigvals[k] = -1.0 / eigvals[k];
+        TacsScalar scale = sqrt(eigvals[k]);
+        BLASscal(&nvars, &scale, &eigvecs[nvars * k], &incx);
+      }
+    }
   }
 
-  delete[] K;
   delete[] M;
 
   return info;
@@ -2348,7 +2685,7 @@ int TACSPanelAnalysis::computeFrequenciesDVSens( TacsScalar freq[],
       for ( int k = 0; k < nsegments; k++ ){
         // Geometric design variable
         TacsScalar At[6], Bt[6], Dt[6], Ast[3];
-        panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
+        getSegmentStiffness(k, At, Bt, Dt, Ast);
 
         double pt[2] = {0.0, 0.0};
         TacsScalar mass[2];
@@ -2363,7 +2700,7 @@ int TACSPanelAnalysis::computeFrequenciesDVSens( TacsScalar freq[],
     else if (designVarTypes[n] == 2){
       for ( int k = 0; k < nsegments; k++ ){
         TacsScalar At[6], Bt[6], Dt[6], Ast[3];
-        panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
+        getSegmentStiffness(k, At, Bt, Dt, Ast);
 
         double pt[2] = {0.0, 0.0};
         TacsScalar mass[2];
@@ -2456,7 +2793,8 @@ void TACSPanelAnalysis::addStiffMat(TacsScalar mat[], int n1, int n2,
     // Calculate the stiffness matrix contributions
     for (int k = 0; k < numGauss; k++) {
       // Evaluate the shape functions
-      FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+      TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                      TacsGaussLobattoPoints2, N, Na);
       FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
       TacsScalar h = 2.0 / Le;
@@ -2501,7 +2839,8 @@ void TACSPanelAnalysis::addStiffMat(TacsScalar mat[], int n1, int n2,
         // Compute sin(n) * cos(m) term
         for (int k = 0; k < numGauss; k++) {
           // Evaluate the shape functions
-          FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+          TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                          TacsGaussLobattoPoints2, N, Na);
           FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
           TacsScalar h = 2.0 / Le;
@@ -2665,9 +3004,8 @@ void TACSPanelAnalysis::addStiffMatBeam(TacsScalar mat[], int n1,
         }
 
         // Add values to the matrix
-        addValues(mat, nband, 4 * NUM_NODES, n_vars, 4 * NUM_NODES, m_vars, Ks);
-        addValuesTranspose(mat, nband, 4 * NUM_NODES, m_vars, 4 * NUM_NODES,
-                           n_vars, Ks);
+        addValues(mat, nband, 4, n_vars, 4, m_vars, Ks);
+        addValuesTranspose(mat, nband, 4, m_vars, 4, n_vars, Ks);
       }
     }
   }
@@ -2719,7 +3057,8 @@ void TACSPanelAnalysis::addMassMat(TacsScalar mat[], int n1, int n2,
     // Calculate the stiffness matrix contributions
     for (int k = 0; k < numGauss; k++) {
       // Evaluate the shape functions
-      FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+      TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                      TacsGaussLobattoPoints2, N, Na);
       FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
       TacsScalar h = 2.0 / Le;
@@ -2762,7 +3101,8 @@ void TACSPanelAnalysis::addMassMat(TacsScalar mat[], int n1, int n2,
         // Compute sin(n) * cos(m) term
         for (int k = 0; k < numGauss; k++) {
           // Evaluate the shape functions
-          FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+          TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                          TacsGaussLobattoPoints2, N, Na);
           FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
           TacsScalar h = 2.0 / Le;
@@ -2859,9 +3199,8 @@ void TACSPanelAnalysis::addMassMatBeam(TacsScalar mat[], int n1,
         }
 
         // Add values to the matrix
-        addValues(mat, nband, 4 * NUM_NODES, n_vars, 4 * NUM_NODES, m_vars, Ms);
-        addValuesTranspose(mat, nband, 4 * NUM_NODES, m_vars, 4 * NUM_NODES,
-                           n_vars, Ms);
+        addValues(mat, nband, 4, n_vars, 4, m_vars, Ms);
+        addValuesTranspose(mat, nband, 4, m_vars, 4, n_vars, Ms);
       }
     }
   }
@@ -2910,7 +3249,8 @@ void TACSPanelAnalysis::addGeoStiffMat(TacsScalar mat[],
     // Calculate the stiffness matrix contributions
     for (int k = 0; k < numGauss; k++) {
       // Evaluate the shape functions
-      FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+      TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                      TacsGaussLobattoPoints2, N, Na);
       FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
       TacsScalar h = 2.0 / Le;
@@ -2937,7 +3277,8 @@ void TACSPanelAnalysis::addGeoStiffMat(TacsScalar mat[],
 
         for (int k = 0; k < numGauss; k++) {
           // Evaluate the shape functions
-          FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+          TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                          TacsGaussLobattoPoints2, N, Na);
           FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
           TacsScalar h = 2.0 / Le;
@@ -3013,7 +3354,8 @@ void TACSPanelAnalysis::addStiffMatDVSens(
     // Calculate the stiffness matrix contributions
     for (int k = 0; k < numGauss; k++) {
       // Evaluate the shape functions
-      FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+      TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                      TacsGaussLobattoPoints2, N, Na);
       FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
       TacsScalar h = 2.0 / Le;
@@ -3059,7 +3401,8 @@ void TACSPanelAnalysis::addStiffMatDVSens(
         // Compute sin(n) * cos(m) term
         for (int k = 0; k < numGauss; k++) {
           // Evaluate the shape functions
-          FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+          TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                          TacsGaussLobattoPoints2, N, Na);
           FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
           TacsScalar h = 2.0 / Le;
@@ -3139,7 +3482,8 @@ void TACSPanelAnalysis::addMassMatDVSens(TacsScalar smat[],
     // Calculate the stiffness matrix contributions
     for (int k = 0; k < numGauss; k++) {
       // Evaluate the shape functions
-      FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+      TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                      TacsGaussLobattoPoints2, N, Na);
       FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
       TacsScalar h = 2.0 / Le;
@@ -3183,7 +3527,8 @@ void TACSPanelAnalysis::addMassMatDVSens(TacsScalar smat[],
         // Compute sin(n) * cos(m) term
         for (int k = 0; k < numGauss; k++) {
           // Evaluate the shape functions
-          FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+          TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                          TacsGaussLobattoPoints2, N, Na);
           FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
           TacsScalar h = 2.0 / Le;
@@ -3259,7 +3604,8 @@ void TACSPanelAnalysis::addGeoStiffMatDVSens(TacsScalar smat[],
     // Calculate the stiffness matrix contributions
     for (int k = 0; k < numGauss; k++) {
       // Evaluate the shape functions
-      FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+      TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                      TacsGaussLobattoPoints2, N, Na);
       FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
       TacsScalar h = 2.0 / Le;
@@ -3287,7 +3633,8 @@ void TACSPanelAnalysis::addGeoStiffMatDVSens(TacsScalar smat[],
 
         for (int k = 0; k < numGauss; k++) {
           // Evaluate the shape functions
-          FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+          TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                          TacsGaussLobattoPoints2, N, Na);
           FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
           TacsScalar h = 2.0 / Le;
@@ -3379,7 +3726,8 @@ void TACSPanelAnalysis::addStiffMatGeoSens(TacsScalar smat[], int dv,
     // Calculate the stiffness matrix contributions
     for (int k = 0; k < numGauss; k++) {
       // Evaluate the shape functions
-      FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+      TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                      TacsGaussLobattoPoints2, N, Na);
       FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
       TacsScalar h = 2.0 / Le;
@@ -3441,7 +3789,8 @@ void TACSPanelAnalysis::addStiffMatGeoSens(TacsScalar smat[], int dv,
         // Compute sin(n) * cos(m) term
         for (int k = 0; k < numGauss; k++) {
           // Evaluate the shape functions
-          FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+          TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                          TacsGaussLobattoPoints2, N, Na);
           FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
           TacsScalar h = 2.0 / Le;
@@ -3550,7 +3899,8 @@ void TACSPanelAnalysis::addMassMatGeoSens(TacsScalar smat[], int dv,
     // Calculate the stiffness matrix contributions
     for (int k = 0; k < numGauss; k++) {
       // Evaluate the shape functions
-      FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+      TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                      TacsGaussLobattoPoints2, N, Na);
       FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
       TacsScalar h = 2.0 / Le;
@@ -3605,7 +3955,8 @@ void TACSPanelAnalysis::addMassMatGeoSens(TacsScalar smat[], int dv,
         // Compute sin(n) * cos(m) term
         for (int k = 0; k < numGauss; k++) {
           // Evaluate the shape functions
-          FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+          TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                          TacsGaussLobattoPoints2, N, Na);
           FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
           TacsScalar h = 2.0 / Le;
@@ -3703,7 +4054,8 @@ void TACSPanelAnalysis::addGeoStiffMatGeoSens(TacsScalar smat[], int dv,
     // Calculate the stiffness matrix contributions
     for (int k = 0; k < numGauss; k++) {
       // Evaluate the shape functions
-      FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+      TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                      TacsGaussLobattoPoints2, N, Na);
       FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
       TacsScalar h = 2.0 / Le;
@@ -3738,7 +4090,8 @@ void TACSPanelAnalysis::addGeoStiffMatGeoSens(TacsScalar smat[], int dv,
         // Compute int_{0}^{1} sin(n*pi*x) * cos(m*pi*x) dx term
         for (int k = 0; k < numGauss; k++) {
           // Evaluate the shape functions
-          FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+          TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                          TacsGaussLobattoPoints2, N, Na);
           FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
           TacsScalar h = 2.0 / Le;
@@ -3824,7 +4177,8 @@ void TACSPanelAnalysis::addStiffMatLxSens(TacsScalar smat[],
     // Calculate the stiffness matrix contributions
     for (int k = 0; k < numGauss; k++) {
       // Evaluate the shape functions
-      FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+      TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                      TacsGaussLobattoPoints2, N, Na);
       FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
       TacsScalar h = 2.0 / Le;
@@ -3885,7 +4239,8 @@ void TACSPanelAnalysis::addStiffMatLxSens(TacsScalar smat[],
         // Compute sin(n) * cos(m) term
         for (int k = 0; k < numGauss; k++) {
           // Evaluate the shape functions
-          FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+          TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                          TacsGaussLobattoPoints2, N, Na);
           FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
           TacsScalar h = 2.0 / Le;
@@ -3982,7 +4337,8 @@ void TACSPanelAnalysis::addMassMatLxSens(TacsScalar smat[],
     // Calculate the stiffness matrix contributions
     for (int k = 0; k < numGauss; k++) {
       // Evaluate the shape functions
-      FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+      TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                      TacsGaussLobattoPoints2, N, Na);
       FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
       TacsScalar h = 2.0 / Le;
@@ -4034,7 +4390,8 @@ void TACSPanelAnalysis::addMassMatLxSens(TacsScalar smat[],
         // Compute sin(n) * cos(m) term
         for (int k = 0; k < numGauss; k++) {
           // Evaluate the shape functions
-          FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+          TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                          TacsGaussLobattoPoints2, N, Na);
           FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
           TacsScalar h = 2.0 / Le;
@@ -4117,7 +4474,8 @@ void TACSPanelAnalysis::addGeoStiffMatLxSens(TacsScalar smat[],
     // Calculate the stiffness matrix contributions
     for (int k = 0; k < numGauss; k++) {
       // Evaluate the shape functions
-      FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+      TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                      TacsGaussLobattoPoints2, N, Na);
       FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
       TacsScalar h = 2.0 / Le;
@@ -4149,7 +4507,8 @@ void TACSPanelAnalysis::addGeoStiffMatLxSens(TacsScalar smat[],
         // Compute int_{0}^{1} sin(n*pi*x) * cos(m*pi*x) dx term
         for (int k = 0; k < numGauss; k++) {
           // Evaluate the shape functions
-          FElibrary::lagrangeSF(N, Na, gaussPts[k], NUM_NODES);
+          TacsLagrangeShapeFuncDerivative(NUM_NODES, gaussPts[k],
+                                          TacsGaussLobattoPoints2, N, Na);
           FElibrary::cubicHP(Nhp, Nahp, Naahp, gaussPts[k]);
 
           TacsScalar h = 2.0 / Le;
@@ -5096,8 +5455,6 @@ void TACSPanelAnalysis::computeBeamMcos(TacsScalar M[], TacsScalar lambda) {
 void TACSPanelAnalysis::computeSegmentLoads(TacsScalar Nx, TacsScalar Nxy,
                                             TacsScalar segmentLoads[],
                                             TacsScalar beamLoads[]) {
-  double pt[3] = {0.0, 0.0, 0.0};
-
   memset(segmentLoads, 0, 3 * nsegments * sizeof(TacsScalar));
   memset(beamLoads, 0, nbeams * sizeof(TacsScalar));
 
@@ -5117,7 +5474,7 @@ void TACSPanelAnalysis::computeSegmentLoads(TacsScalar Nx, TacsScalar Nxy,
     c = c / Le;
 
     TacsScalar At[6], Bt[6], Dt[6], Ast[3];
-    panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
+    getSegmentStiffness(k, At, Bt, Dt, Ast);
     TacsScalar A11 = (At[0] * At[3] - At[1] * At[1]) / At[3];
 
     EA += A11 * Le;
@@ -5127,7 +5484,7 @@ void TACSPanelAnalysis::computeSegmentLoads(TacsScalar Nx, TacsScalar Nxy,
   // Add the contributions from the beam elements
   for (int k = 0; k < nbeams; k++) {
     TacsScalar Ct[10];
-    beams[k]->getStiffness(pt, Ct);
+    getBeamStiffness(k, Ct);
     EA += Ct[0];
   }
 
@@ -5146,7 +5503,7 @@ void TACSPanelAnalysis::computeSegmentLoads(TacsScalar Nx, TacsScalar Nxy,
     c = c / Le;
 
     TacsScalar At[6], Bt[6], Dt[6], Ast[3];
-    panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
+    getSegmentStiffness(k, At, Bt, Dt, Ast);
     TacsScalar A11 = (At[0] * At[3] - At[1] * At[1]) / At[3];
 
     segmentLoads[3 * k] = A11 * epx;
@@ -5155,7 +5512,7 @@ void TACSPanelAnalysis::computeSegmentLoads(TacsScalar Nx, TacsScalar Nxy,
 
   for (int k = 0; k < nbeams; k++) {
     TacsScalar Ct[10];
-    beams[k]->getStiffness(pt, Ct);
+    getBeamStiffness(k, Ct);
     beamLoads[k] = Ct[0] * epx;
   }
 }
@@ -5192,7 +5549,7 @@ void TACSPanelAnalysis::computeSegmentLoadsDVSens( int dvNum,
 
     TacsScalar At[6], Bt[6], Dt[6], Ast[3];
     TacsScalar sAt[6], sBt[6], sDt[6], sAst[3];
-    panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
+    getSegmentStiffness(k, At, Bt, Dt, Ast);
     panels[k]->getStiffnessDVSens(dvNum, pt, sAt, sBt, sDt, sAst);
     TacsScalar A11 = (At[0]*At[3] - At[1]*At[1])/At[3];
     TacsScalar sA11 = (At[0]*sAt[3] + sAt[0]*At[3] - 2.0*At[1]*sAt[1])/At[3];
@@ -5207,7 +5564,7 @@ void TACSPanelAnalysis::computeSegmentLoadsDVSens( int dvNum,
 
   for ( int k = 0; k < nbeams; k++ ){
     TacsScalar Ct[10], sCt[10];
-    beams[k]->getStiffness(pt, Ct);
+    getBeamStiffness(k, Ct);
     beams[k]->getStiffnessDVSens(dvNum, pt, sCt);
     EA += Ct[0];
     sEA += sCt[0];
@@ -5231,7 +5588,7 @@ void TACSPanelAnalysis::computeSegmentLoadsDVSens( int dvNum,
 
     TacsScalar At[6], Bt[6], Dt[6], Ast[3];
     TacsScalar sAt[6], sBt[6], sDt[6], sAst[3];
-    panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
+    getSegmentStiffness(k, At, Bt, Dt, Ast);
     panels[k]->getStiffnessDVSens(dvNum, pt, sAt, sBt, sDt, sAst);
     TacsScalar A11 = (At[0]*At[3] - At[1]*At[1])/At[3];
     TacsScalar sA11 = (At[0]*sAt[3] + sAt[0]*At[3] - 2.0*At[1]*sAt[1])/At[3];
@@ -5243,7 +5600,7 @@ void TACSPanelAnalysis::computeSegmentLoadsDVSens( int dvNum,
 
   for ( int k = 0; k < nbeams; k++ ){
     TacsScalar Ct[10], sCt[10];
-    beams[k]->getStiffness(pt, Ct);
+    getBeamStiffness(k, Ct);
     beams[k]->getStiffnessDVSens(dvNum, pt, sCt);
     beamLoads[k] = sCt[0]*epx + Ct[0]*sepx;
   }
@@ -5257,8 +5614,6 @@ void TACSPanelAnalysis::computeSegmentLoadsGeoSens(TacsScalar Nx,
                                                    TacsScalar Nxy, int dv,
                                                    TacsScalar segmentLoads[],
                                                    TacsScalar beamLoads[]) {
-  double pt[3] = {0.0, 0.0, 0.0};
-
   memset(segmentLoads, 0, 3 * nsegments * sizeof(TacsScalar));
   memset(beamLoads, 0, nbeams * sizeof(TacsScalar));
 
@@ -5292,7 +5647,7 @@ void TACSPanelAnalysis::computeSegmentLoadsGeoSens(TacsScalar Nx,
     c = c / Le;
 
     TacsScalar At[6], Bt[6], Dt[6], Ast[3];
-    panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
+    getSegmentStiffness(k, At, Bt, Dt, Ast);
     TacsScalar A11 = (At[0] * At[3] - At[1] * At[1]) / At[3];
 
     EA += A11 * Le;
@@ -5304,7 +5659,7 @@ void TACSPanelAnalysis::computeSegmentLoadsGeoSens(TacsScalar Nx,
 
   for (int k = 0; k < nbeams; k++) {
     TacsScalar Ct[10];
-    beams[k]->getStiffness(pt, Ct);
+    getBeamStiffness(k, Ct);
     EA += Ct[0];
   }
 
@@ -5331,7 +5686,7 @@ void TACSPanelAnalysis::computeSegmentLoadsGeoSens(TacsScalar Nx,
     c = c / Le;
 
     TacsScalar At[6], Bt[6], Dt[6], Ast[3];
-    panels[k]->getStiffness(pt, At, Bt, Dt, Ast);
+    getSegmentStiffness(k, At, Bt, Dt, Ast);
     TacsScalar A11 = (At[0] * At[3] - At[1] * At[1]) / At[3];
     segmentLoads[3 * k] = A11 * sepx;
     segmentLoads[3 * k + 1] = 0.0;
@@ -5428,7 +5783,8 @@ void TACSPanelAnalysis::printPanelMode(const char *file_name,
                         Xpts[2 * n2 + 1] * (1.0 + xi));
           x[0] = (Lx * i) / nx - beta * x[1];
 
-          FElibrary::lagrangeSF(N, Na, xi, NUM_NODES);
+          TacsLagrangeShapeFuncDerivative(NUM_NODES, xi,
+                                          TacsGaussLobattoPoints2, N, Na);
           FElibrary::cubicHP(Nhp, Nahp, Naahp, xi);
 
           TacsScalar u[3] = {0.0, 0.0, 0.0};
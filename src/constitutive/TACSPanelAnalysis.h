@@ -28,12 +28,17 @@
 #warning "TACSPanelAnalysis cannot be used with complex TACS"
 #else
 
-#include "EBStiffness.h"
-#include "FSDTStiffness.h"
+#include "TACSBeamConstitutive.h"
+#include "TACSShellConstitutive.h"
 
 /*
   This class implements a panel-level buckling analysis for
   determining the buckling loads of the panel and stiffeners.
+
+  The skin and stiffener segments use the stiffness and mass moments of
+  a TACSShellConstitutive object, while the longitudinal beams use a
+  TACSBeamConstitutive object. All properties are evaluated at the
+  origin with an element index of zero.
 */
 class TACSPanelAnalysis : public TACSObject {
  public:
@@ -47,8 +52,9 @@ class TACSPanelAnalysis : public TACSObject {
   // Functions for initialization
   // ----------------------------
   void setPoints(TacsScalar *Xpts, int npoints);
-  void setSegment(int seg, int seg_type, FSDTStiffness *stiff, int n1, int n2);
-  void setBeam(int beam, EBStiffness *stiff, int n);
+  void setSegment(int seg, int seg_type, TACSShellConstitutive *stiff, int n1,
+                  int n2);
+  void setBeam(int beam, TACSBeamConstitutive *stiff, int n);
   void setFirstNodeBC(int _first_node, int _first_node_bc);
   void setLastNodeBC(int _last_node, int _last_node_bc);
   void initialize();
@@ -86,6 +92,12 @@ class TACSPanelAnalysis : public TACSObject {
   int computeBucklingLoads(TacsScalar Nxy, TacsScalar posLoads[],
                            TacsScalar negLoads[], int nloads);
 
+  // Compute the buckling loads for a list of panels using multiple threads
+  static int computeBucklingLoads(int npanels, TACSPanelAnalysis *panels[],
+                                  const TacsScalar Nx[], const TacsScalar Nxy[],
+                                  TacsScalar loads[], int nloads,
+                                  int num_threads);
+
   // Compute the solution with a uniform surface pressure
   // ----------------------------------------------------
   int computePressureLoad(TacsScalar p, const char *file_name);
@@ -93,9 +105,9 @@ class TACSPanelAnalysis : public TACSObject {
   // Compute the design variable sensitivity of the
   // buckling loads or frequencies
   // ----------------------------------------------
-  int computeFrequenciesDVSens(TacsScalar freq[], TacsScalar freqDVSens[],
-                               int nfreq);
   /*
+  int computeFrequenciesDVSens( TacsScalar freq[], TacsScalar freqDVSens[],
+                                int nfreq );
   int computeBucklingLoadsDVSens( TacsScalar Nx, TacsScalar Nxy,
                                   TacsScalar loads[],
                                   TacsScalar loadDVSens[], int nloads );
@@ -146,26 +158,22 @@ class TACSPanelAnalysis : public TACSObject {
                          int ka, TacsScalar *A, int lda, int kb, TacsScalar *B,
                          int ldb, int k, int m, TacsScalar *work, double tol,
                          TacsScalar *eigs, TacsScalar *Z);
+
+  // Assemble and factor the stiffness matrix
+  // ----------------------------------------
+  void assembleStiffness(TacsScalar K[]);
+  int factorStiffness();
+  void clearStiffnessFactor() { Kfactor_valid = 0; }
   int computeFrequencies(int neigs, TacsScalar eigvals[], TacsScalar eigvecs[]);
   int computeBucklingLoads(const TacsScalar segmentLoads[],
                            const TacsScalar beamLoads[], int neigs,
                            TacsScalar eigvals[], TacsScalar eigvecs[],
                            int two_sided);
 
-  // Function to compute the derivative of the buckling loads
-  // --------------------------------------------------------
-  int computeBucklingLoadsDVSens(TacsScalar Nx, TacsScalar Nxy,
-                                 TacsScalar posLoads[], TacsScalar negLoads[],
-                                 TacsScalar posLoadDVSens[],
-                                 TacsScalar negLoadDVSens[], int nloads);
-
   // Compute the segment loads and their sensitivities
   // -------------------------------------------------
   void computeSegmentLoads(TacsScalar Nx, TacsScalar Nxy,
                            TacsScalar segmentLoads[], TacsScalar beamLoads[]);
-  void computeSegmentLoadsDVSens(int dvNum, TacsScalar Nx, TacsScalar Nxy,
-                                 TacsScalar segmentLoads[],
-                                 TacsScalar beamLoads[]);
   void computeSegmentLoadsGeoSens(TacsScalar Nx, TacsScalar Nxy, int dv,
                                   TacsScalar segmentLoads[],
                                   TacsScalar beamLoads[]);
@@ -177,6 +185,14 @@ class TACSPanelAnalysis : public TACSObject {
   // Update the Xpt array based on the current values of the geoDvs
   void updateGeometry();
 
+  // Evaluate the properties of the segments and beams
+  // -------------------------------------------------
+  void getSegmentStiffness(int seg, TacsScalar At[], TacsScalar Bt[],
+                           TacsScalar Dt[], TacsScalar Ast[]);
+  void getSegmentMass(int seg, TacsScalar mass[]);
+  void getBeamStiffness(int beam, TacsScalar Ct[]);
+  void getBeamMass(int beam, TacsScalar mass[]);
+
   // The maximum number of nodes in an element
   static const int NUM_NODES = 2;
 
@@ -391,6 +407,12 @@ class TACSPanelAnalysis : public TACSObject {
   int lanczos_subspace_size;
   double lanczos_eigen_tol;
 
+  // The Cholesky factor of the stiffness matrix. This is used as the
+  // shift-invert operator for both the buckling and frequency problems
+  // and is re-used until the design variables or the model change.
+  TacsScalar *Kfactor;
+  int Kfactor_valid;
+
   // Assign the start and end nodes - these are used
   // to compute the mass per unit area of the panel
   int first_node, last_node;
@@ -413,12 +435,12 @@ class TACSPanelAnalysis : public TACSObject {
   int *nodes;        // The nodes for each segment
   int *bnodes;       // The nodes associated with longitudinal beams
 
-  FSDTStiffness **panels;  // The sub-stiffness properties of each panel
-  EBStiffness **beams;     // The beam stiffness objects
-  int nsegments;           // The number of panel segments
-  int nbeams;              // The number of longitudinal beams
-  int nmodes;              // The number of terms in the
-  int *segmentType;        // Segment types - skin or stiffener
+  TACSShellConstitutive **panels;  // The stiffness of each panel segment
+  TACSBeamConstitutive **beams;    // The beam stiffness objects
+  int nsegments;                   // The number of panel segments
+  int nbeams;                      // The number of longitudinal beams
+  int nmodes;                      // The number of terms in the
+  int *segmentType;                // Segment types - skin or stiffener
 
   // The unknowns associated with each panel segment
   // Note that negative unknowns do not appear in the final matrix
@@ -22,6 +22,8 @@ TACSPanelGPs::TACSPanelGPs(TACSBucklingGaussianProcessModel *axialGP,
   savedYtest = new TacsScalar[n_save];
   savedAdjoint = new bool[n_save];
   savedJacobians = new TacsScalar[n_save_adj];
+  savedXtest = new TacsScalar[n_save_adj];
+  resetSavedData();
 
   this->saveData = saveData;
 }
@@ -55,69 +57,161 @@ TACSPanelGPs::~TACSPanelGPs() {
   delete[] savedYtest;
   delete[] savedAdjoint;
   delete[] savedJacobians;
+  delete[] savedXtest;
 }
 
 void TACSPanelGPs::resetSavedData() {
   // goal here is to reset the saved data
   memset(savedYtest, 0.0, n_save * sizeof(TacsScalar));
   memset(savedJacobians, 0.0, n_save_adj * sizeof(TacsScalar));
+  memset(savedXtest, 0.0, n_save_adj * sizeof(TacsScalar));
   for (int i = 0; i < n_save; i++) {
     savedForward[i] = false;
     savedAdjoint[i] = false;
   }
 }
 
-TacsScalar TACSPanelGPs::predictMeanTestData(int predInd,
-                                             const TacsScalar *Xtest) {
-  // assume checking for input calling is in the other class for now
-  // otherwise I would return garbage values..
-  if (!savedForward[predInd] || !saveData) {
-    // axial global or local options
-    if (predInd == 0 || predInd == 1) {
-      savedYtest[predInd] = this->axialGP->predictMeanTestData(Xtest);
-    }
-    // shear global or local options
-    if (predInd == 2 || predInd == 3) {
-      savedYtest[predInd] = this->shearGP->predictMeanTestData(Xtest);
-    }
-    // crippling GP
-    if (predInd == 4) {
-      savedYtest[predInd] = this->cripplingGP->predictMeanTestData(Xtest);
+TACSBucklingGaussianProcessModel *TACSPanelGPs::getGP(int predInd,
+                                                     int *group) {
+  // axial global or local options
+  if (predInd == 0 || predInd == 1) {
+    *group = 0;
+    return this->axialGP;
+  }
+  // shear global or local options
+  if (predInd == 2 || predInd == 3) {
+    *group = 1;
+    return this->shearGP;
+  }
+  // crippling GP
+  *group = 2;
+  return this->cripplingGP;
+}
+
+bool TACSPanelGPs::isSaved(const bool saved[], int predInd,
+                           const TacsScalar *Xtest) {
+  if (!saved[predInd]) {
+    return false;
+  }
+  // when the data is shared across a component, the saved value is used
+  // regardless of the test point until resetSavedData() is called
+  if (saveData) {
+    return true;
+  }
+  // otherwise the saved value is only reused for the same test point
+  const TacsScalar *X = &savedXtest[4 * predInd];
+  for (int i = 0; i < 4; i++) {
+    if (X[i] != Xtest[i]) {
+      return false;
     }
-    savedForward[predInd] = true;
   }
-  return savedYtest[predInd];
+  return true;
 }
 
-void TACSPanelGPs::predictMeanTestDataSens(int predInd, const TacsScalar Ysens,
-                                           const TacsScalar *Xtest,
-                                           TacsScalar *Xtestsens) {
-  // assume checking for input calling is in the other class for now
-  // otherwise I would return garbage values..
+void TACSPanelGPs::computeBatch(int n, const int predInds[],
+                                const TacsScalar Xtest[], bool sens) {
+  const bool *saved = (sens ? savedAdjoint : savedForward);
 
-  // just save the jacobians in each cell as the failure input derivatives
-  // for backpropagation may not be the same
+  // loop over the axial, shear and crippling GPs
+  for (int group = 0; group < 3; group++) {
+    // collect the test points of this GP that are not saved yet
+    TACSBucklingGaussianProcessModel *gp = NULL;
+    int slots[5], count = 0;
+    TacsScalar X[20];
+    for (int i = 0; i < n; i++) {
+      int predGroup;
+      TACSBucklingGaussianProcessModel *predGP =
+          getGP(predInds[i], &predGroup);
+      if (predGroup != group || !predGP ||
+          isSaved(saved, predInds[i], &Xtest[4 * i])) {
+        continue;
+      }
+      gp = predGP;
 
-  // change this part with 4* to not be hardcoded later..
-  TacsScalar *localJacobian = &savedJacobians[4 * predInd];
+      int k = 0;
+      while (k < count && slots[k] != predInds[i]) {
+        k++;
+      }
+      if (k == count) {
+        slots[count] = predInds[i];
+        count++;
+      }
+      memcpy(&X[4 * k], &Xtest[4 * i], 4 * sizeof(TacsScalar));
+    }
 
-  if (!savedAdjoint[predInd] || !saveData) {
-    // axial global or local options
-    if (predInd == 0 || predInd == 1) {
-      this->axialGP->predictMeanTestDataSens(1.0, Xtest, localJacobian);
+    if (count == 0) {
+      continue;
     }
-    // shear global or local options
-    if (predInd == 2 || predInd == 3) {
-      this->shearGP->predictMeanTestDataSens(1.0, Xtest, localJacobian);
+
+    // make one prediction for all of the test points of this GP
+    TacsScalar Y[5], jac[20];
+    if (sens) {
+      gp->predictMeanTestDataSensBatch(count, X, Y, jac);
+    } else {
+      gp->predictMeanTestDataBatch(count, X, Y);
     }
-    // crippling GP
-    if (predInd == 4) {
-      this->cripplingGP->predictMeanTestDataSens(1.0, Xtest, localJacobian);
+
+    // save the predictions. A new forward prediction invalidates the
+    // jacobian saved at a different test point.
+    for (int k = 0; k < count; k++) {
+      int predInd = slots[k];
+      savedYtest[predInd] = Y[k];
+      memcpy(&savedXtest[4 * predInd], &X[4 * k], 4 * sizeof(TacsScalar));
+      savedForward[predInd] = true;
+      if (sens) {
+        memcpy(&savedJacobians[4 * predInd], &jac[4 * k],
+               4 * sizeof(TacsScalar));
+      }
+      savedAdjoint[predInd] = sens;
     }
-    savedAdjoint[predInd] = true;
   }
+}
+
+void TACSPanelGPs::predictMeanTestDataBatch(int n, const int predInds[],
+                                            const TacsScalar Xtest[],
+                                            TacsScalar Ytest[]) {
+  computeBatch(n, predInds, Xtest, false);
+  if (Ytest) {
+    for (int i = 0; i < n; i++) {
+      Ytest[i] = savedYtest[predInds[i]];
+    }
+  }
+}
+
+void TACSPanelGPs::predictMeanTestDataSensBatch(int n, const int predInds[],
+                                                const TacsScalar Xtest[],
+                                                TacsScalar Ytest[],
+                                                TacsScalar Xtestjac[]) {
+  computeBatch(n, predInds, Xtest, true);
+  for (int i = 0; i < n; i++) {
+    if (Ytest) {
+      Ytest[i] = savedYtest[predInds[i]];
+    }
+    if (Xtestjac) {
+      memcpy(&Xtestjac[4 * i], &savedJacobians[4 * predInds[i]],
+             4 * sizeof(TacsScalar));
+    }
+  }
+}
+
+TacsScalar TACSPanelGPs::predictMeanTestData(int predInd,
+                                             const TacsScalar *Xtest) {
+  // assume checking for input calling is in the other class for now
+  // otherwise I would return garbage values..
+  computeBatch(1, &predInd, Xtest, false);
+  return savedYtest[predInd];
+}
+
+void TACSPanelGPs::predictMeanTestDataSens(int predInd, const TacsScalar Ysens,
+                                           const TacsScalar *Xtest,
+                                           TacsScalar *Xtestsens) {
+  // just save the jacobians in each cell as the failure input derivatives
+  // for backpropagation may not be the same. The prediction and its jacobian
+  // are computed together, so the forward data is saved here as well
+  computeBatch(1, &predInd, Xtest, true);
 
   // now multiply the Ysens backpropagated derivative by the saved jacobian
+  const TacsScalar *localJacobian = &savedJacobians[4 * predInd];
   for (int i = 0; i < 4; i++) {
     Xtestsens[i] = Ysens * localJacobian[i];
   }
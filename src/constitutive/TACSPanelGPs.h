@@ -83,6 +83,39 @@ class TACSPanelGPs : public TACSObject {
   void predictMeanTestDataSens(int predInd, const TacsScalar Ysens,
                                const TacsScalar *Xtest, TacsScalar *Xtestsens);
 
+  /**
+   * predict the mean test data for several buckling predictions at once.
+   * The test points are grouped by GP model so that each GP makes a single
+   * batched prediction. Predictions that are already saved are not
+   * recomputed. Each predInd should appear at most once; if it appears more
+   * than once, only the last test point is used.
+   *
+   * @param n the number of predictions
+   * @param predInds the prediction indices (see above), length n
+   * @param Xtest the test data points, rank 1-tensor of length 4*n
+   * @param Ytest the mean predictions of the GPs, length n (may be null)
+   */
+  void predictMeanTestDataBatch(int n, const int predInds[],
+                                const TacsScalar Xtest[],
+                                TacsScalar Ytest[] = NULL);
+
+  /**
+   * predict the mean test data and the jacobians for several buckling
+   * predictions at once. This saves both the forward and adjoint data so that
+   * the subsequent calls to predictMeanTestData and predictMeanTestDataSens
+   * at the same test points reuse them.
+   *
+   * @param n the number of predictions
+   * @param predInds the prediction indices (see above), length n
+   * @param Xtest the test data points, rank 1-tensor of length 4*n
+   * @param Ytest the mean predictions of the GPs, length n (may be null)
+   * @param Xtestjac the jacobians dYtest/dXtest, length 4*n (may be null)
+   */
+  void predictMeanTestDataSensBatch(int n, const int predInds[],
+                                    const TacsScalar Xtest[],
+                                    TacsScalar Ytest[] = NULL,
+                                    TacsScalar Xtestjac[] = NULL);
+
   /**
    * clear and reset all the saved data.
    * this also turns off the flags saying we have saved the data
@@ -105,10 +138,24 @@ class TACSPanelGPs : public TACSObject {
   }
 
  protected:
+  // compute the predictions which are not saved yet with one batched call to
+  // each GP model
+  void computeBatch(int n, const int predInds[], const TacsScalar Xtest[],
+                    bool sens);
+
+  // check whether the saved data for predInd can be used for this test point
+  bool isSaved(const bool saved[], int predInd, const TacsScalar *Xtest);
+
+  // get the GP model and its group index for a prediction index
+  TACSBucklingGaussianProcessModel *getGP(int predInd, int *group);
+
   const int n_save = 5;
   int n_save_adj = 20;  // 5 * n_params rn
   bool saveData;
 
+  // test points of the saved forward and adjoint data
+  TacsScalar *savedXtest;
+
   // saved forward data in this class
   TacsScalar *savedYtest;
   bool *savedForward;
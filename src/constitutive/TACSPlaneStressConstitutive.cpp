@@ -113,6 +113,16 @@ void TACSPlaneStressConstitutive::addDensityDVSens(
   }
 }
 
+// Evaluate the derivative of the density along a design direction
+TacsScalar TACSPlaneStressConstitutive::evalDensityDVSensVecProduct(
+    int elemIndex, const double pt[], const TacsScalar X[], int dvLen,
+    const TacsScalar pdx[], TacsScalar work[]) {
+  if (properties && tNum >= 0) {
+    return pdx[0] * properties->getDensity();
+  }
+  return 0.0;
+}
+
 // Evaluate the specific heat
 TacsScalar TACSPlaneStressConstitutive::evalSpecificHeat(int elemIndex,
                                                          const double pt[],
@@ -177,6 +187,23 @@ void TACSPlaneStressConstitutive::addStressDVSens(
   }
 }
 
+// Evaluate the derivative of the stress along a design direction
+void TACSPlaneStressConstitutive::evalStressDVSensVecProduct(
+    int elemIndex, const double pt[], const TacsScalar X[],
+    const TacsScalar e[], int dvLen, const TacsScalar pdx[],
+    TacsScalar work[], TacsScalar ps[]) {
+  if (properties && tNum >= 0) {
+    TacsScalar C[6];
+    properties->evalTangentStiffness2D(C);
+
+    ps[0] = pdx[0] * (C[0] * e[0] + C[1] * e[1] + C[2] * e[2]);
+    ps[1] = pdx[0] * (C[1] * e[0] + C[3] * e[1] + C[4] * e[2]);
+    ps[2] = pdx[0] * (C[2] * e[0] + C[4] * e[1] + C[5] * e[2]);
+  } else {
+    ps[0] = ps[1] = ps[2] = 0.0;
+  }
+}
+
 // Evaluate the thermal strain
 void TACSPlaneStressConstitutive::evalThermalStrain(int elemIndex,
                                                     const double pt[],
@@ -59,6 +59,12 @@ class TACSPlaneStressConstitutive : public TACSConstitutive {
   void addDensityDVSens(int elemIndex, TacsScalar scale, const double pt[],
                         const TacsScalar X[], int dvLen, TacsScalar dfdx[]);
 
+  // Evaluate the derivative of the density along a design direction
+  TacsScalar evalDensityDVSensVecProduct(int elemIndex, const double pt[],
+                                         const TacsScalar X[], int dvLen,
+                                         const TacsScalar pdx[],
+                                         TacsScalar work[]);
+
   // Evaluate the specific heat
   TacsScalar evalSpecificHeat(int elemIndex, const double pt[],
                               const TacsScalar X[]);
@@ -76,6 +82,13 @@ class TACSPlaneStressConstitutive : public TACSConstitutive {
                        const TacsScalar X[], const TacsScalar strain[],
                        const TacsScalar psi[], int dvLen, TacsScalar dfdx[]);
 
+  // Evaluate the derivative of the stress along a design direction
+  void evalStressDVSensVecProduct(int elemIndex, const double pt[],
+                                  const TacsScalar X[],
+                                  const TacsScalar strain[], int dvLen,
+                                  const TacsScalar pdx[], TacsScalar work[],
+                                  TacsScalar pstress[]);
+
   // Evaluate the thermal strain
   void evalThermalStrain(int elemIndex, const double pt[], const TacsScalar X[],
                          TacsScalar theta, TacsScalar strain[]);
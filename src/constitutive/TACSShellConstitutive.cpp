@@ -18,6 +18,8 @@
 
 #include "TACSShellConstitutive.h"
 
+#include <string.h>
+
 #include "tacslapack.h"
 
 const char *TACSShellConstitutive::constName = "TACSShellConstitutive";
@@ -32,6 +34,30 @@ const char *TACSShellConstitutive::getObjectName() { return constName; }
 */
 int TACSShellConstitutive::getNumStresses() { return NUM_STRESSES; }
 
+/*
+  Evaluate the derivative of the mass moments along the design
+  direction one moment at a time
+*/
+void TACSShellConstitutive::evalMassMomentsDVSensVecProduct(
+    int elemIndex, const double pt[], const TacsScalar X[], int dvLen,
+    const TacsScalar pdx[], TacsScalar work[], TacsScalar pmoments[]) {
+  int dvSize = dvLen * getDesignVarsPerNode();
+  TacsScalar *dfdx = &work[NUM_STRESSES];
+
+  TacsScalar scale[3] = {0.0, 0.0, 0.0};
+  for (int i = 0; i < 3; i++) {
+    scale[i] = 1.0;
+    memset(dfdx, 0, dvSize * sizeof(TacsScalar));
+    addMassMomentsDVSens(elemIndex, pt, X, scale, dvLen, dfdx);
+    scale[i] = 0.0;
+
+    pmoments[i] = 0.0;
+    for (int k = 0; k < dvSize; k++) {
+      pmoments[i] += dfdx[k] * pdx[k];
+    }
+  }
+}
+
 // Extract the tangent stiffness components from the matrix
 void TACSShellConstitutive::extractTangentStiffness(
     const TacsScalar *C, const TacsScalar **A, const TacsScalar **B,
@@ -53,6 +79,78 @@ void TACSShellConstitutive::extractTangentStiffness(
   }
 }
 
+/*
+  Copy the cached tangent stiffness into C if the cache is enabled and
+  was computed for the current design and drilling regularization.
+  Returns 1 if the cached values were used and 0 otherwise.
+*/
+int TACSShellConstitutive::getCachedTangentStiffness(TacsScalar C[]) {
+  if (useStiffnessCache && stiffnessVersion == designVersion &&
+      stiffnessDrill == DRILLING_REGULARIZATION) {
+    memcpy(C, stiffnessCache,
+           NUM_TANGENT_STIFFNESS_ENTRIES * sizeof(TacsScalar));
+    return 1;
+  }
+  return 0;
+}
+
+/*
+  Enable or disable the cached tangent stiffness
+*/
+void TACSShellConstitutive::setUseStiffnessCache(int flag) {
+  useStiffnessCache = flag;
+  stiffnessVersion = -1;
+  if (useStiffnessCache) {
+    computeStiffnessCache();
+  }
+}
+
+/*
+  Increment the design version after the design variables, or any
+  other data that the stiffness depends on, are modified. The cached
+  stiffness is recomputed here rather than during the evaluation so
+  that the cache is never written while the elements are assembled in
+  parallel threads.
+*/
+void TACSShellConstitutive::updateDesignVersion() {
+  designVersion++;
+  if (useStiffnessCache) {
+    computeStiffnessCache();
+  }
+}
+
+/*
+  Compute the tangent stiffness for the current design and store it in
+  the cache
+*/
+void TACSShellConstitutive::computeStiffnessCache() {
+  double pt[3] = {0.0, 0.0, 0.0};
+  TacsScalar X[3] = {0.0, 0.0, 0.0};
+  TacsScalar C[NUM_TANGENT_STIFFNESS_ENTRIES];
+
+  // Invalidate the cache so that the stiffness is computed
+  stiffnessVersion = -1;
+  evalTangentStiffness(0, pt, X, C);
+
+  memcpy(stiffnessCache, C, NUM_TANGENT_STIFFNESS_ENTRIES * sizeof(TacsScalar));
+  stiffnessDrill = DRILLING_REGULARIZATION;
+  stiffnessVersion = designVersion;
+}
+
+/*
+  Evaluate the stress using the cached stiffness. Returns 0 without
+  modifying the stress if the cache is disabled or out of date.
+*/
+int TACSShellConstitutive::evalCachedStress(const TacsScalar e[],
+                                            TacsScalar s[]) {
+  TacsScalar C[NUM_TANGENT_STIFFNESS_ENTRIES];
+  if (getCachedTangentStiffness(C)) {
+    computeStress(&C[0], &C[6], &C[12], &C[18], C[21], e, s);
+    return 1;
+  }
+  return 0;
+}
+
 /*
   Default drilling regularization value. Set to 0.1 to match the
   behavior seen in Nastran, which improves agreement between
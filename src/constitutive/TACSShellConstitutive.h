@@ -33,7 +33,12 @@ class TACSShellConstitutive : public TACSConstitutive {
   static const int NUM_STRESSES = 9;
   static const int NUM_TANGENT_STIFFNESS_ENTRIES = 22;
 
-  TACSShellConstitutive() {}
+  TACSShellConstitutive() {
+    useStiffnessCache = 0;
+    designVersion = 0;
+    stiffnessVersion = -1;
+    stiffnessDrill = 0.0;
+  }
   virtual ~TACSShellConstitutive() {}
 
   // Get the number of stresses
@@ -75,6 +80,28 @@ class TACSShellConstitutive : public TACSConstitutive {
                                     const TacsScalar scale[], int dvLen,
                                     TacsScalar dfdx[]) {}
 
+  /**
+    Evaluate the derivative of the mass moments along a direction in
+    the design variables
+
+    By default, each moment is found from addMassMomentsDVSens with a
+    unit scale factor. Constitutive classes may override it with a
+    direct computation.
+
+    @param elemIndex The local element index
+    @param pt The parametric location
+    @param X The point location
+    @param dvLen the length of the design vector array
+    @param pdx The design variable direction
+    @param work Scratch array of length getSensVecProductWorkSize(dvLen)
+    @param pmoments The derivative of the moments along pdx
+  */
+  virtual void evalMassMomentsDVSensVecProduct(int elemIndex, const double pt[],
+                                               const TacsScalar X[], int dvLen,
+                                               const TacsScalar pdx[],
+                                               TacsScalar work[],
+                                               TacsScalar pmoments[]);
+
   // Set/get the drilling regularization value
   static void setDrillingRegularization(double kval);
   static double getDrillingRegularization();
@@ -99,14 +126,51 @@ class TACSShellConstitutive : public TACSConstitutive {
                                    const TacsScalar drill, const TacsScalar e[],
                                    TacsScalar s[]);
 
+  /**
+    Enable or disable caching of the tangent stiffness matrix.
+
+    This is only valid for linear constitutive models whose stiffness
+    depends on the design variables alone, and not on the element
+    index, the parametric point or the node locations. When enabled,
+    the stiffness is computed immediately and again whenever the
+    design variables are modified. The evaluation routines only read
+    the cache, so it can be shared between the assembly threads. If
+    the drilling regularization is changed, the cache is bypassed
+    until the stiffness is recomputed.
+
+    @param flag Flag indicating whether to cache the stiffness
+  */
+  void setUseStiffnessCache(int flag);
+
   // The name of the constitutive object
   const char *getObjectName();
 
  protected:
+  // Retrieve the cached stiffness if it is valid
+  int getCachedTangentStiffness(TacsScalar C[]);
+
+  // Increment the design version and recompute the cached stiffness
+  void updateDesignVersion();
+
+  // Compute the stress from the cached stiffness, if it is valid
+  int evalCachedStress(const TacsScalar e[], TacsScalar s[]);
+
   // The drilling regularization constant
   static double DRILLING_REGULARIZATION;
 
+  // Incremented whenever the design variables are modified
+  int designVersion;
+
  private:
+  // Compute the stiffness and store it in the cache
+  void computeStiffnessCache();
+
+  // The cached tangent stiffness and the design version it corresponds to
+  int useStiffnessCache;
+  int stiffnessVersion;
+  double stiffnessDrill;
+  TacsScalar stiffnessCache[NUM_TANGENT_STIFFNESS_ENTRIES];
+
   // The object name
   static const char *constName;
 };
@@ -81,9 +81,14 @@ TACSSmearedCompositeShellConstitutive::TACSSmearedCompositeShellConstitutive(
   nfvals = 2 * num_plies;
   fvals = new TacsScalar[nfvals];
   dks_vals = new TacsScalar[nfvals];
-  dfvals = new TacsScalar *[nfvals];
-  for (int i = 0; i < nfvals; i++) {
-    dfvals[i] = new TacsScalar[NUM_STRESSES];
+
+  // Storage for the batched failure evaluation at the bottom and top
+  // of each ply
+  pt_angles = new TacsScalar[nfvals];
+  pt_strain = new TacsScalar[3 * nfvals];
+  pt_sens = new TacsScalar[3 * nfvals];
+  for (int i = 0; i < num_plies; i++) {
+    pt_angles[2 * i] = pt_angles[2 * i + 1] = ply_angles[i];
   }
 }
 
@@ -100,10 +105,9 @@ TACSSmearedCompositeShellConstitutive::
   delete[] ply_fraction_ub;
   delete[] fvals;
   delete[] dks_vals;
-  for (int i = 0; i < nfvals; i++) {
-    delete[] dfvals[i];
-  }
-  delete[] dfvals;
+  delete[] pt_angles;
+  delete[] pt_strain;
+  delete[] pt_sens;
 }
 
 int TACSSmearedCompositeShellConstitutive::getDesignVarNums(int elemIndex,
@@ -140,6 +144,7 @@ int TACSSmearedCompositeShellConstitutive::setDesignVars(
       index++;
     }
   }
+  updateDesignVersion();
   return index;
 }
 
@@ -333,6 +338,10 @@ void TACSSmearedCompositeShellConstitutive::evalStress(int elemIndex,
                                                        const TacsScalar X[],
                                                        const TacsScalar e[],
                                                        TacsScalar s[]) {
+  if (evalCachedStress(e, s)) {
+    return;
+  }
+
   TacsScalar A[6], B[6], D[6], As[3], drill;
   drill = evalFSDTStiffness(elemIndex, pt, X, A, B, D, As);
 
@@ -422,30 +431,85 @@ void TACSSmearedCompositeShellConstitutive::addStressDVSens(
 TacsScalar TACSSmearedCompositeShellConstitutive::evalFailure(
     int elemIndex, const double pt[], const TacsScalar X[],
     const TacsScalar strain[]) {
-  evalPlyTopBottomFailure(strain, fvals);
-  TacsScalar ks_val = ksAggregation(fvals, nfvals, ks_weight);
-
-  return ks_val;
+  return evalPlyTopBottomFailure(strain, NULL);
 }
 
 /*
-  Compute the most critical failure criteria for the laminate
+  Compute the KS aggregate of the failure criteria evaluated at the
+  bottom and top of each ply
+
+  The strains at the sampling points are stored in structure-of-arrays
+  form and passed to the ply in a single batch. When all the plies share
+  the same properties, the KS aggregation is performed within the batch.
+  Otherwise, consecutive plies with the same properties are evaluated
+  together and aggregated afterwards.
+
+  If dfde is not NULL, it is set to the derivative of the KS aggregate
+  w.r.t. the laminate strain at each point, dfde[k*nfvals + p].
 */
-void TACSSmearedCompositeShellConstitutive::evalPlyTopBottomFailure(
-    const TacsScalar strain[], TacsScalar fvals[]) {
+TacsScalar TACSSmearedCompositeShellConstitutive::evalPlyTopBottomFailure(
+    const TacsScalar strain[], TacsScalar dfde[]) {
   // Compute the total thickness of the laminate
   TacsScalar tb = (-0.5 - t_offset) * thickness;
   TacsScalar tt = (0.5 - t_offset) * thickness;
 
+  TacsScalar *ex = &pt_strain[0];
+  TacsScalar *ey = &pt_strain[nfvals];
+  TacsScalar *exy = &pt_strain[2 * nfvals];
   for (int i = 0; i < num_plies; i++) {
-    TacsScalar lamStrain[3] = {0.0};
+    ex[2 * i] = strain[0] + tb * strain[3];
+    ey[2 * i] = strain[1] + tb * strain[4];
+    exy[2 * i] = strain[2] + tb * strain[5];
+
+    ex[2 * i + 1] = strain[0] + tt * strain[3];
+    ey[2 * i + 1] = strain[1] + tt * strain[4];
+    exy[2 * i + 1] = strain[2] + tt * strain[5];
+  }
 
-    getLaminaStrain(strain, tb, lamStrain);
-    fvals[2 * i] = ply_props[i]->failure(ply_angles[i], lamStrain);
+  TacsScalar *dfdex = NULL, *dfdey = NULL, *dfdexy = NULL;
+  if (dfde) {
+    dfdex = &dfde[0];
+    dfdey = &dfde[nfvals];
+    dfdexy = &dfde[2 * nfvals];
+  }
 
-    getLaminaStrain(strain, tt, lamStrain);
-    fvals[2 * i + 1] = ply_props[i]->failure(ply_angles[i], lamStrain);
+  int n = 1;
+  while (n < num_plies && ply_props[n] == ply_props[0]) {
+    n++;
   }
+  if (n == num_plies) {
+    return ply_props[0]->failureBatchKS(nfvals, pt_angles, ex, ey, exy,
+                                        ks_weight, fvals, dfdex, dfdey,
+                                        dfdexy);
+  }
+
+  for (int i = 0; i < num_plies; i += n) {
+    n = 1;
+    while (i + n < num_plies && ply_props[i + n] == ply_props[i]) {
+      n++;
+    }
+    int p = 2 * i;
+    if (dfde) {
+      ply_props[i]->failureStrainSensBatch(
+          2 * n, &pt_angles[p], &ex[p], &ey[p], &exy[p], &fvals[p], &dfdex[p],
+          &dfdey[p], &dfdexy[p]);
+    } else {
+      ply_props[i]->failureBatch(2 * n, &pt_angles[p], &ex[p], &ey[p],
+                                 &exy[p], &fvals[p]);
+    }
+  }
+
+  if (dfde) {
+    TacsScalar ks_val = ksAggregationSens(fvals, nfvals, ks_weight, dks_vals);
+    for (int p = 0; p < nfvals; p++) {
+      dfdex[p] *= dks_vals[p];
+      dfdey[p] *= dks_vals[p];
+      dfdexy[p] *= dks_vals[p];
+    }
+    return ks_val;
+  }
+
+  return ksAggregation(fvals, nfvals, ks_weight);
 }
 
 // Evaluate the derivative of the failure criteria w.r.t. the strain
@@ -460,38 +524,20 @@ TacsScalar TACSSmearedCompositeShellConstitutive::evalFailureStrainSens(
   TacsScalar tb = (-0.5 - t_offset) * thickness;
   TacsScalar tt = (0.5 - t_offset) * thickness;
 
-  evalPlyTopBottomFailure(strain, fvals);
-
-  for (int i = 0; i < num_plies; i++) {
-    TacsScalar lamStrain[3], phi[3];
-
-    // plate bottom stress
-    getLaminaStrain(strain, tb, lamStrain);
-    TacsScalar fval_bot =
-        ply_props[i]->failureStrainSens(ply_angles[i], lamStrain, phi);
-    dfvals[2 * i + 0][0] = phi[0];
-    dfvals[2 * i + 0][1] = phi[1];
-    dfvals[2 * i + 0][2] = phi[2];
-    dfvals[2 * i + 0][3] = tb * phi[0];
-    dfvals[2 * i + 0][4] = tb * phi[1];
-    dfvals[2 * i + 0][5] = tb * phi[2];
-    dfvals[2 * i + 0][6] = dfvals[2 * i + 0][7] = dfvals[2 * i + 0][8] = 0.0;
-
-    // plate top stress
-    getLaminaStrain(strain, tt, lamStrain);
-    TacsScalar fval_top =
-        ply_props[i]->failureStrainSens(ply_angles[i], lamStrain, phi);
-    dfvals[2 * i + 1][0] = phi[0];
-    dfvals[2 * i + 1][1] = phi[1];
-    dfvals[2 * i + 1][2] = phi[2];
-    dfvals[2 * i + 1][3] = tt * phi[0];
-    dfvals[2 * i + 1][4] = tt * phi[1];
-    dfvals[2 * i + 1][5] = tt * phi[2];
-    dfvals[2 * i + 1][6] = dfvals[2 * i + 1][7] = dfvals[2 * i + 1][8] = 0.0;
-  }
-
-  TacsScalar ks_val = ksAggregationSensProduct(fvals, nfvals, NUM_STRESSES,
-                                               ks_weight, dfvals, sens);
+  TacsScalar ks_val = evalPlyTopBottomFailure(strain, pt_sens);
+
+  const TacsScalar *dfdex = &pt_sens[0];
+  const TacsScalar *dfdey = &pt_sens[nfvals];
+  const TacsScalar *dfdexy = &pt_sens[2 * nfvals];
+  for (int p = 0; p < nfvals; p++) {
+    TacsScalar tp = (p % 2 == 0 ? tb : tt);
+    sens[0] += dfdex[p];
+    sens[1] += dfdey[p];
+    sens[2] += dfdexy[p];
+    sens[3] += tp * dfdex[p];
+    sens[4] += tp * dfdey[p];
+    sens[5] += tp * dfdexy[p];
+  }
 
   return ks_val;
 }
@@ -502,29 +548,15 @@ void TACSSmearedCompositeShellConstitutive::addFailureDVSens(
     const TacsScalar e[], int dvLen, TacsScalar dfdx[]) {
   int index = 0;
   if (thickness_dv_num >= 0 && dvLen >= 1) {
-    // Compute the total thickness of the laminate
-    TacsScalar tb = (-0.5 - t_offset) * thickness;
-    TacsScalar tt = (0.5 - t_offset) * thickness;
-
-    evalPlyTopBottomFailure(e, fvals);
-    TacsScalar ks_val = ksAggregationSens(fvals, nfvals, ks_weight, dks_vals);
-
-    for (int i = 0; i < num_plies; i++) {
-      TacsScalar lamStrain[3], phi[3];
-
-      // plate bottom stress
-      getLaminaStrain(e, tb, lamStrain);
-      TacsScalar fval_bot =
-          ply_props[i]->failureStrainSens(ply_angles[i], lamStrain, phi);
-      dfdx[index] += (-0.5 - t_offset) * scale * dks_vals[2 * i + 0] *
-                     (phi[0] * e[3] + phi[1] * e[4] + phi[2] * e[5]);
-
-      // plate top stress
-      getLaminaStrain(e, tt, lamStrain);
-      TacsScalar fval_top =
-          ply_props[i]->failureStrainSens(ply_angles[i], lamStrain, phi);
-      dfdx[index] += (0.5 - t_offset) * scale * dks_vals[2 * i + 1] *
-                     (phi[0] * e[3] + phi[1] * e[4] + phi[2] * e[5]);
+    evalPlyTopBottomFailure(e, pt_sens);
+
+    const TacsScalar *dfdex = &pt_sens[0];
+    const TacsScalar *dfdey = &pt_sens[nfvals];
+    const TacsScalar *dfdexy = &pt_sens[2 * nfvals];
+    for (int p = 0; p < nfvals; p++) {
+      TacsScalar dtp = (p % 2 == 0 ? -0.5 - t_offset : 0.5 - t_offset);
+      dfdx[index] += dtp * scale *
+                     (dfdex[p] * e[3] + dfdey[p] * e[4] + dfdexy[p] * e[5]);
     }
 
     index++;
@@ -544,6 +576,10 @@ void TACSSmearedCompositeShellConstitutive::getLaminaStrain(
 // Evaluate the tangent stiffness
 void TACSSmearedCompositeShellConstitutive::evalTangentStiffness(
     int elemIndex, const double pt[], const TacsScalar X[], TacsScalar C[]) {
+  if (getCachedTangentStiffness(C)) {
+    return;
+  }
+
   TacsScalar *A = &C[0];
   TacsScalar *B = &C[6];
   TacsScalar *D = &C[12];
@@ -136,7 +136,7 @@ class TACSSmearedCompositeShellConstitutive : public TACSShellConstitutive {
   double ks_weight;
   int nfvals;
   TacsScalar *fvals, *dks_vals;
-  TacsScalar **dfvals;
+  TacsScalar *pt_angles, *pt_strain, *pt_sens;
   TacsScalar t_offset;
 
   // The object name
@@ -147,7 +147,8 @@ class TACSSmearedCompositeShellConstitutive : public TACSShellConstitutive {
                                TacsScalar B[], TacsScalar D[], TacsScalar As[]);
   void getLaminaStrain(const TacsScalar rmStrain[], TacsScalar tp,
                        TacsScalar strain[]);
-  void evalPlyTopBottomFailure(const TacsScalar strain[], TacsScalar fvals[]);
+  TacsScalar evalPlyTopBottomFailure(const TacsScalar strain[],
+                                     TacsScalar dfde[]);
 };
 
 #endif  // TACS_SMEARED_COMPOSITE_SHELL_CONSTITUTIVE_H
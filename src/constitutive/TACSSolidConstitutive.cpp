@@ -119,6 +119,16 @@ void TACSSolidConstitutive::addDensityDVSens(int elemIndex, TacsScalar scale,
   }
 }
 
+// Evaluate the derivative of the density along a design direction
+TacsScalar TACSSolidConstitutive::evalDensityDVSensVecProduct(
+    int elemIndex, const double pt[], const TacsScalar X[], int dvLen,
+    const TacsScalar pdx[], TacsScalar work[]) {
+  if (properties && tNum >= 0) {
+    return pdx[0] * properties->getDensity();
+  }
+  return 0.0;
+}
+
 // Evaluate the specific heat
 TacsScalar TACSSolidConstitutive::evalSpecificHeat(int elemIndex,
                                                    const double pt[],
@@ -208,6 +218,33 @@ void TACSSolidConstitutive::addStressDVSens(int elemIndex, TacsScalar scale,
   }
 }
 
+// Evaluate the derivative of the stress along a design direction
+void TACSSolidConstitutive::evalStressDVSensVecProduct(
+    int elemIndex, const double pt[], const TacsScalar X[],
+    const TacsScalar e[], int dvLen, const TacsScalar pdx[],
+    TacsScalar work[], TacsScalar ps[]) {
+  if (properties && tNum >= 0) {
+    TacsScalar C[21];
+    properties->evalTangentStiffness3D(C);
+
+    TacsScalar p = pdx[0];
+    ps[0] = p * (C[0] * e[0] + C[1] * e[1] + C[2] * e[2] + C[3] * e[3] +
+                 C[4] * e[4] + C[5] * e[5]);
+    ps[1] = p * (C[1] * e[0] + C[6] * e[1] + C[7] * e[2] + C[8] * e[3] +
+                 C[9] * e[4] + C[10] * e[5]);
+    ps[2] = p * (C[2] * e[0] + C[7] * e[1] + C[11] * e[2] + C[12] * e[3] +
+                 C[13] * e[4] + C[14] * e[5]);
+    ps[3] = p * (C[3] * e[0] + C[8] * e[1] + C[12] * e[2] + C[15] * e[3] +
+                 C[16] * e[4] + C[17] * e[5]);
+    ps[4] = p * (C[4] * e[0] + C[9] * e[1] + C[13] * e[2] + C[16] * e[3] +
+                 C[18] * e[4] + C[19] * e[5]);
+    ps[5] = p * (C[5] * e[0] + C[10] * e[1] + C[14] * e[2] + C[17] * e[3] +
+                 C[19] * e[4] + C[20] * e[5]);
+  } else {
+    ps[0] = ps[1] = ps[2] = ps[3] = ps[4] = ps[5] = 0.0;
+  }
+}
+
 // Evaluate the thermal strain
 void TACSSolidConstitutive::evalThermalStrain(int elemIndex, const double pt[],
                                               const TacsScalar X[],
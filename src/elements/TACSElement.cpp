@@ -331,6 +331,67 @@ void TACSElement::addAdjResXptProduct(
   delete[] tmp;
 }
 
+void TACSElement::addResidualDVSensVecProduct(
+    int elemIndex, double time, TacsScalar scale, const TacsScalar Xpts[],
+    const TacsScalar vars[], const TacsScalar dvars[],
+    const TacsScalar ddvars[], int dvLen, const TacsScalar pdx[],
+    TacsScalar work[], TacsScalar res[]) {
+  int nvars = getNumVariables();
+  int dvSize = dvLen * getDesignVarsPerNode();
+  if (nvars == 0 || dvSize == 0) {
+    return;
+  }
+
+  TacsScalar *psi = work;
+  TacsScalar *dfdx = &work[nvars];
+  memset(psi, 0, nvars * sizeof(TacsScalar));
+
+  // Each entry of the product is the adjoint-residual product for a
+  // unit adjoint vector, dotted with the design direction
+  for (int i = 0; i < nvars; i++) {
+    psi[i] = 1.0;
+    memset(dfdx, 0, dvSize * sizeof(TacsScalar));
+    addAdjResProduct(elemIndex, time, 1.0, psi, Xpts, vars, dvars, ddvars,
+                     dvLen, dfdx);
+
+    TacsScalar product = 0.0;
+    for (int k = 0; k < dvSize; k++) {
+      product += dfdx[k] * pdx[k];
+    }
+    res[i] += scale * product;
+    psi[i] = 0.0;
+  }
+}
+
+void TACSElement::addResidualXptSensVecProduct(
+    int elemIndex, double time, TacsScalar scale, const TacsScalar Xpts[],
+    const TacsScalar vars[], const TacsScalar dvars[],
+    const TacsScalar ddvars[], const TacsScalar pXpts[], TacsScalar work[],
+    TacsScalar res[]) {
+  int nvars = getNumVariables();
+  int nxpts = 3 * getNumNodes();
+
+  TacsScalar *psi = work;
+  TacsScalar *fXptSens = &work[nvars];
+  memset(psi, 0, nvars * sizeof(TacsScalar));
+
+  // Each entry of the product is the adjoint-residual product for a
+  // unit adjoint vector, dotted with the node direction
+  for (int i = 0; i < nvars; i++) {
+    psi[i] = 1.0;
+    memset(fXptSens, 0, nxpts * sizeof(TacsScalar));
+    addAdjResXptProduct(elemIndex, time, 1.0, psi, Xpts, vars, dvars, ddvars,
+                        fXptSens);
+
+    TacsScalar product = 0.0;
+    for (int k = 0; k < nxpts; k++) {
+      product += fXptSens[k] * pXpts[k];
+    }
+    res[i] += scale * product;
+    psi[i] = 0.0;
+  }
+}
+
 void TACSElement::getMatType(ElementMatrixType matType, int elemIndex,
                              double time, const TacsScalar Xpts[],
                              const TacsScalar vars[], TacsScalar mat[]) {
@@ -819,3 +880,64 @@ void TACSElement::addPointQuantityXptSens(
     delete[] fd;
   }
 }
+
+int TACSElement::evalPointQuantities(
+    int elemIndex, int quantityType, double time, int npts, const int n[],
+    const double pt[], const TacsScalar Xpts[], const TacsScalar vars[],
+    const TacsScalar dvars[], const TacsScalar ddvars[], TacsScalar detXd[],
+    TacsScalar quantity[]) {
+  int count = 0;
+  for (int i = 0; i < npts; i++) {
+    double p[3];
+    p[0] = pt[i];
+    p[1] = pt[npts + i];
+    p[2] = pt[2 * npts + i];
+
+    TacsScalar q[TACSElementModel::MAX_POINT_QUANTITY_SIZE];
+    count = evalPointQuantity(elemIndex, quantityType, time, n[i], p, Xpts,
+                              vars, dvars, ddvars, &detXd[i], q);
+    for (int j = 0; j < count; j++) {
+      quantity[j * npts + i] = q[j];
+    }
+  }
+
+  return count;
+}
+
+void TACSElement::addPointQuantityDVSensBatch(
+    int elemIndex, int quantityType, double time, TacsScalar scale, int n,
+    double pt[], const TacsScalar Xpts[], const TacsScalar vars[],
+    const TacsScalar dvars[], const TacsScalar ddvars[], int numFuncs,
+    int ldq, const TacsScalar dfdq[], int dvLen, TacsScalar *dfdx[]) {
+  for (int i = 0; i < numFuncs; i++) {
+    addPointQuantityDVSens(elemIndex, quantityType, time, scale, n, pt, Xpts,
+                           vars, dvars, ddvars, &dfdq[ldq * i], dvLen,
+                           dfdx[i]);
+  }
+}
+
+void TACSElement::addPointQuantitySVSensBatch(
+    int elemIndex, int quantityType, double time, TacsScalar alpha,
+    TacsScalar beta, TacsScalar gamma, int n, double pt[],
+    const TacsScalar Xpts[], const TacsScalar vars[], const TacsScalar dvars[],
+    const TacsScalar ddvars[], int numFuncs, int ldq, const TacsScalar dfdq[],
+    TacsScalar *dfdu[]) {
+  for (int i = 0; i < numFuncs; i++) {
+    addPointQuantitySVSens(elemIndex, quantityType, time, alpha, beta, gamma,
+                           n, pt, Xpts, vars, dvars, ddvars, &dfdq[ldq * i],
+                           dfdu[i]);
+  }
+}
+
+void TACSElement::addPointQuantityXptSensBatch(
+    int elemIndex, int quantityType, double time, TacsScalar scale, int n,
+    double pt[], const TacsScalar Xpts[], const TacsScalar vars[],
+    const TacsScalar dvars[], const TacsScalar ddvars[], int numFuncs,
+    const TacsScalar dfddetXd[], int ldq, const TacsScalar dfdq[],
+    TacsScalar *dfdXpts[]) {
+  for (int i = 0; i < numFuncs; i++) {
+    addPointQuantityXptSens(elemIndex, quantityType, time, scale, n, pt, Xpts,
+                            vars, dvars, ddvars, dfddetXd[i], &dfdq[ldq * i],
+                            dfdXpts[i]);
+  }
+}
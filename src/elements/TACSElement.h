@@ -90,6 +90,13 @@ class TACSElement : public TACSObject {
   */
   static void setFiniteDifferenceOrder(int order);
 
+  /*
+    Get the default finite difference order for real analysis
+
+    @return The finite difference order
+  */
+  static int getFiniteDifferenceOrder() { return fdOrder; }
+
   /**
     Get the number of degrees of freedom per node for this element
 
@@ -512,6 +519,83 @@ class TACSElement : public TACSObject {
                                    const TacsScalar ddvars[],
                                    TacsScalar fXptSens[]);
 
+  /**
+    Add the directional derivative of the residual w.r.t. the design
+    variables to the output residual vector
+
+    This adds the contribution scaled by an input factor as follows:
+
+    res += scale*d(res)/dx*pdx
+
+    By default, the product is computed one residual entry at a time
+    using addAdjResProduct with unit adjoint vectors. The result is
+    therefore exact whenever the adjoint-residual product is exact.
+    This costs one adjoint-residual product for each element variable,
+    so elements should override it with a forward computation. The
+    scratch array is supplied by the caller so that no memory is
+    allocated for each element.
+
+    @param elemIndex The local element index
+    @param time The simulation time
+    @param scale The coefficient for the derivative result
+    @param Xpts The element node locations
+    @param vars The values of the element degrees of freedom
+    @param dvars The first time derivative of the element DOF
+    @param ddvars The second time derivative of the element DOF
+    @param dvLen The length of the design variable vector
+    @param pdx The design variable direction
+    @param work Scratch array of length getSensVecProductWorkSize(dvLen)
+    @param res The element residual input/output
+  */
+  virtual void addResidualDVSensVecProduct(
+      int elemIndex, double time, TacsScalar scale, const TacsScalar Xpts[],
+      const TacsScalar vars[], const TacsScalar dvars[],
+      const TacsScalar ddvars[], int dvLen, const TacsScalar pdx[],
+      TacsScalar work[], TacsScalar res[]);
+
+  /**
+    Add the directional derivative of the residual w.r.t. the node
+    locations to the output residual vector
+
+    This adds the contribution scaled by an input factor as follows:
+
+    res += scale*d(res)/d(Xpts)*pXpts
+
+    By default, the product is computed one residual entry at a time
+    using addAdjResXptProduct with unit adjoint vectors. Elements
+    should override this with a direct computation.
+
+    @param elemIndex The local element index
+    @param time The simulation time
+    @param scale The coefficient for the derivative result
+    @param Xpts The element node locations
+    @param vars The values of the element degrees of freedom
+    @param dvars The first time derivative of the element DOF
+    @param ddvars The second time derivative of the element DOF
+    @param pXpts The node location direction
+    @param work Scratch array of length getSensVecProductWorkSize(0)
+    @param res The element residual input/output
+  */
+  virtual void addResidualXptSensVecProduct(
+      int elemIndex, double time, TacsScalar scale, const TacsScalar Xpts[],
+      const TacsScalar vars[], const TacsScalar dvars[],
+      const TacsScalar ddvars[], const TacsScalar pXpts[], TacsScalar work[],
+      TacsScalar res[]);
+
+  /**
+    Get the length of the scratch array required by the residual
+    direction products
+
+    @param dvLen The length of the design variable vector
+    @return The length of the scratch array
+  */
+  int getSensVecProductWorkSize(int dvLen) {
+    int nvars = getNumVariables();
+    int dvSize = dvLen * getDesignVarsPerNode();
+    int nxpts = 3 * getNumNodes();
+    return nvars + (dvSize > nxpts ? dvSize : nxpts);
+  }
+
   /**
     Compute a specific type of element matrix (mass, stiffness, geometric
     stiffness, etc.)
@@ -674,6 +758,38 @@ class TACSElement : public TACSObject {
     return 0;  // No quantities defined by default
   }
 
+  /**
+    Evaluate a point-wise quantity of interest at a set of points
+
+    The parametric points are stored in a structure-of-arrays format so
+    that pt[j*npts + i] is the j-th coordinate of the i-th point, and
+    the j-th component of the quantity at the i-th point is stored in
+    quantity[j*npts + i]. The default implementation calls
+    evalPointQuantity() at each point and supports quantities with up to
+    TACSElementModel::MAX_POINT_QUANTITY_SIZE components.
+
+    @param elemIndex The index of the element
+    @param quantityType The integer indicating the pointwise quantity
+    @param time The simulation time
+    @param npts The number of points
+    @param n The quadrature point index for each point
+    @param pt The parametric points (3 x npts)
+    @param Xpts The element node locations
+    @param vars The values of the element degrees of freedom
+    @param dvars The first time derivative of the element DOF
+    @param ddvars The second time derivative of the element DOF
+    @param detXd The determinant of the Jacobian at each point
+    @param quantity The output quantity of interest (count x npts)
+    @return Integer indicating the number of defined quantities
+  */
+  virtual int evalPointQuantities(int elemIndex, int quantityType,
+                                  double time, int npts, const int n[],
+                                  const double pt[], const TacsScalar Xpts[],
+                                  const TacsScalar vars[],
+                                  const TacsScalar dvars[],
+                                  const TacsScalar ddvars[],
+                                  TacsScalar detXd[], TacsScalar quantity[]);
+
   /**
     Add the derivative of the point quantity w.r.t. the design variables
 
@@ -744,6 +860,92 @@ class TACSElement : public TACSObject {
       const TacsScalar dvars[], const TacsScalar ddvars[],
       const TacsScalar dfddetXd, const TacsScalar dfdq[], TacsScalar dfdXpts[]);
 
+  /**
+    Add the derivatives of several functions of the point quantity
+    w.r.t. the design variables
+
+    The derivative of the i-th function w.r.t. the quantity is stored
+    in dfdq[ldq*i] and its result is added to dfdx[i]. The default
+    implementation calls addPointQuantityDVSens for each function.
+    Elements can override this to share the point evaluation.
+
+    @param elemIndex The index of the element
+    @param quantityType The integer indicating the pointwise quantity
+    @param time The simulation time
+    @param scale The scalar factor applied to the derivative
+    @param n The quadrature point index
+    @param pt The quadrature point
+    @param Xpts The element node locations
+    @param vars The values of the element degrees of freedom
+    @param dvars The first time derivative of the element DOF
+    @param ddvars The second time derivative of the element DOF
+    @param numFuncs The number of functions
+    @param ldq The leading dimension of the dfdq array
+    @param dfdq The derivatives of the functions w.r.t. the quantity
+    @param dvLen The length of the design arrays
+    @param dfdx The derivative arrays for each function
+  */
+  virtual void addPointQuantityDVSensBatch(
+      int elemIndex, int quantityType, double time, TacsScalar scale, int n,
+      double pt[], const TacsScalar Xpts[], const TacsScalar vars[],
+      const TacsScalar dvars[], const TacsScalar ddvars[], int numFuncs,
+      int ldq, const TacsScalar dfdq[], int dvLen, TacsScalar *dfdx[]);
+
+  /**
+    Add the derivatives of several functions of the point quantity
+    w.r.t. the state variables
+
+    @param elemIndex The index of the element
+    @param quantityType The integer indicating the pointwise quantity
+    @param time The simulation time
+    @param alpha The coefficient for the state variables
+    @param beta The coefficient for the first time derivatives
+    @param gamma The coefficient for the second time derivatives
+    @param n The quadrature point index
+    @param pt The quadrature point
+    @param Xpts The element node locations
+    @param vars The values of the element degrees of freedom
+    @param dvars The first time derivative of the element DOF
+    @param ddvars The second time derivative of the element DOF
+    @param numFuncs The number of functions
+    @param ldq The leading dimension of the dfdq array
+    @param dfdq The derivatives of the functions w.r.t. the quantity
+    @param dfdu The derivative arrays for each function
+  */
+  virtual void addPointQuantitySVSensBatch(
+      int elemIndex, int quantityType, double time, TacsScalar alpha,
+      TacsScalar beta, TacsScalar gamma, int n, double pt[],
+      const TacsScalar Xpts[], const TacsScalar vars[],
+      const TacsScalar dvars[], const TacsScalar ddvars[], int numFuncs,
+      int ldq, const TacsScalar dfdq[], TacsScalar *dfdu[]);
+
+  /**
+    Add the derivatives of several functions of the point quantity
+    w.r.t. the node locations
+
+    @param elemIndex The index of the element
+    @param quantityType The integer indicating the pointwise quantity
+    @param time The simulation time
+    @param scale The scalar factor applied to the derivative
+    @param n The quadrature point index
+    @param pt The quadrature point
+    @param Xpts The element node locations
+    @param vars The values of the element degrees of freedom
+    @param dvars The first time derivative of the element DOF
+    @param ddvars The second time derivative of the element DOF
+    @param numFuncs The number of functions
+    @param dfddetXd The derivatives w.r.t. determinant of the Jacobian
+    @param ldq The leading dimension of the dfdq array
+    @param dfdq The derivatives of the functions w.r.t. the quantity
+    @param dfdXpts The derivative arrays for each function
+  */
+  virtual void addPointQuantityXptSensBatch(
+      int elemIndex, int quantityType, double time, TacsScalar scale, int n,
+      double pt[], const TacsScalar Xpts[], const TacsScalar vars[],
+      const TacsScalar dvars[], const TacsScalar ddvars[], int numFuncs,
+      const TacsScalar dfddetXd[], int ldq, const TacsScalar dfdq[],
+      TacsScalar *dfdXpts[]);
+
   /**
     Compute the output data for visualization
 
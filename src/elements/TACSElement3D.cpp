@@ -133,6 +133,65 @@ int TACSElement3D::getDesignVarRange(int elemIndex, int dvLen, TacsScalar lb[],
   return model->getDesignVarRange(elemIndex, dvLen, lb, ub);
 }
 
+/*
+  Copy the field values at a single point into the structure-of-arrays
+  format used by the batched element model interface
+*/
+static inline void TACSElement3DScatterPoint(int npts, int i, int size,
+                                  const TacsScalar *in, TacsScalar *out) {
+  for (int j = 0; j < size; j++) {
+    out[j * npts + i] = in[j];
+  }
+}
+
+/*
+  Copy the values at a single point out of the structure-of-arrays format
+*/
+static inline void TACSElement3DGatherPoint(int npts, int i, int size,
+                                 const TacsScalar *in, TacsScalar *out) {
+  for (int j = 0; j < size; j++) {
+    out[j] = in[j * npts + i];
+  }
+}
+
+/*
+  Evaluate the field gradient at a block of quadrature points and store
+  the result in the structure-of-arrays format. The determinant of the
+  Jacobian transformation is multiplied by the quadrature weight.
+*/
+void TACSElement3D::getFieldGradientPoints(
+    int elemIndex, int start, int npts, const TacsScalar Xpts[],
+    const TacsScalar vars[], const TacsScalar dvars[],
+    const TacsScalar ddvars[], int elems[], int index[], double pts[],
+    TacsScalar detXd[], TacsScalar X[], TacsScalar Xd[], TacsScalar J[],
+    TacsScalar Ut[], TacsScalar Ux[]) {
+  const int vars_per_node = model->getVarsPerNode();
+
+  for (int i = 0; i < npts; i++) {
+    int n = start + i;
+    elems[i] = elemIndex;
+    index[i] = n;
+
+    double pt[3];
+    double weight = basis->getQuadraturePoint(n, pt);
+    pts[i] = pt[0];
+    pts[npts + i] = pt[1];
+    pts[2 * npts + i] = pt[2];
+
+    TacsScalar Xp[3], Xdp[9];
+    TacsScalar Utp[3 * MAX_VARS_PER_NODE];
+    TacsScalar Ud[3 * MAX_VARS_PER_NODE], Uxp[3 * MAX_VARS_PER_NODE];
+    detXd[i] = weight * basis->getFieldGradient(n, pt, Xpts, vars_per_node,
+                                                vars, dvars, ddvars, Xp, Xdp,
+                                                &J[9 * i], Utp, Ud, Uxp);
+
+    TACSElement3DScatterPoint(npts, i, 3, Xp, X);
+    TACSElement3DScatterPoint(npts, i, 9, Xdp, Xd);
+    TACSElement3DScatterPoint(npts, i, 3 * vars_per_node, Utp, Ut);
+    TACSElement3DScatterPoint(npts, i, 3 * vars_per_node, Uxp, Ux);
+  }
+}
+
 /*
   Add the residual to the provided vector
 */
@@ -144,29 +203,40 @@ void TACSElement3D::addResidual(int elemIndex, double time,
   const int nquad = basis->getNumQuadraturePoints();
   const int vars_per_node = model->getVarsPerNode();
 
-  // Loop over each quadrature point and add the residual contribution
-  for (int n = 0; n < nquad; n++) {
-    // Get the quadrature weight
-    double pt[3];
-    double weight = basis->getQuadraturePoint(n, pt);
+  // Evaluate the weak form in blocks of quadrature points
+  for (int start = 0; start < nquad; start += MAX_BATCH_POINTS) {
+    int npts = nquad - start;
+    if (npts > MAX_BATCH_POINTS) {
+      npts = MAX_BATCH_POINTS;
+    }
 
     // Get the solution field and the solution field gradient and the
-    // Jacobian transformation
-    TacsScalar X[3], Xd[9], J[9];
-    TacsScalar Ut[3 * MAX_VARS_PER_NODE];
-    TacsScalar Ud[3 * MAX_VARS_PER_NODE], Ux[3 * MAX_VARS_PER_NODE];
-    TacsScalar detXd = basis->getFieldGradient(
-        n, pt, Xpts, vars_per_node, vars, dvars, ddvars, X, Xd, J, Ut, Ud, Ux);
-
-    // Multiply the weight by the quadrature point
-    detXd *= weight;
-
-    // Evaluate the weak form of the model
-    TacsScalar DUt[3 * MAX_VARS_PER_NODE], DUx[3 * MAX_VARS_PER_NODE];
-    model->evalWeakIntegrand(elemIndex, n, time, pt, X, Xd, Ut, Ux, DUt, DUx);
-
-    // Add the weak form of the residual at this point
-    basis->addWeakResidual(n, pt, detXd, J, vars_per_node, DUt, DUx, res);
+    // Jacobian transformation at each point
+    int elems[MAX_BATCH_POINTS], index[MAX_BATCH_POINTS];
+    double pts[3 * MAX_BATCH_POINTS];
+    TacsScalar detXd[MAX_BATCH_POINTS];
+    TacsScalar X[3 * MAX_BATCH_POINTS], Xd[9 * MAX_BATCH_POINTS];
+    TacsScalar J[9 * MAX_BATCH_POINTS];
+    TacsScalar Ut[3 * MAX_VARS_PER_NODE * MAX_BATCH_POINTS];
+    TacsScalar Ux[3 * MAX_VARS_PER_NODE * MAX_BATCH_POINTS];
+    getFieldGradientPoints(elemIndex, start, npts, Xpts, vars, dvars, ddvars,
+                           elems, index, pts, detXd, X, Xd, J, Ut, Ux);
+
+    // Evaluate the weak form of the model at all points
+    TacsScalar DUt[3 * MAX_VARS_PER_NODE * MAX_BATCH_POINTS];
+    TacsScalar DUx[3 * MAX_VARS_PER_NODE * MAX_BATCH_POINTS];
+    model->evalWeakIntegrandPoints(npts, elems, time, index, pts, X, Xd, Ut,
+                                   Ux, DUt, DUx);
+
+    // Add the weak form of the residual at each point
+    for (int i = 0; i < npts; i++) {
+      double pt[3] = {pts[i], pts[npts + i], pts[2 * npts + i]};
+      TacsScalar DUtp[3 * MAX_VARS_PER_NODE], DUxp[3 * MAX_VARS_PER_NODE];
+      TACSElement3DGatherPoint(npts, i, 3 * vars_per_node, DUt, DUtp);
+      TACSElement3DGatherPoint(npts, i, 3 * vars_per_node, DUx, DUxp);
+      basis->addWeakResidual(index[i], pt, detXd[i], &J[9 * i], vars_per_node,
+                             DUtp, DUxp, res);
+    }
   }
 }
 
@@ -189,37 +259,59 @@ void TACSElement3D::addJacobian(int elemIndex, double time, TacsScalar alpha,
   model->getWeakMatrixNonzeros(TACS_JACOBIAN_MATRIX, elemIndex, &Jac_nnz,
                                &Jac_pairs);
 
-  // Loop over each quadrature point and add the residual contribution
-  for (int n = 0; n < nquad; n++) {
-    // Get the quadrature weight
-    double pt[3];
-    double weight = basis->getQuadraturePoint(n, pt);
-
-    // Get the solution field and the solution field gradient and the
-    // Jacobian transformation
-    TacsScalar X[3], Xd[9], J[9];
-    TacsScalar Ut[3 * MAX_VARS_PER_NODE];
-    TacsScalar Ud[3 * MAX_VARS_PER_NODE], Ux[3 * MAX_VARS_PER_NODE];
-    TacsScalar detXd = basis->getFieldGradient(
-        n, pt, Xpts, vars_per_node, vars, dvars, ddvars, X, Xd, J, Ut, Ud, Ux);
-
-    // Multiply the weight by the quadrature point
-    detXd *= weight;
-
-    // Evaluate the weak form of the model
-    TacsScalar DUt[3 * MAX_VARS_PER_NODE], DUx[3 * MAX_VARS_PER_NODE];
-    TacsScalar Jac[36 * MAX_VARS_PER_NODE * MAX_VARS_PER_NODE];
-    model->evalWeakMatrix(TACS_JACOBIAN_MATRIX, elemIndex, n, time, pt, X, Xd,
-                          Ut, Ux, DUt, DUx, Jac);
+  // Set the number of points in each block so that the Jacobian entries
+  // fit within the fixed-size buffer
+  int max_npts = MAX_BATCH_POINTS;
+  if (Jac_nnz * max_npts > MAX_BATCH_JAC_SIZE) {
+    max_npts = MAX_BATCH_JAC_SIZE / Jac_nnz;
+  }
 
-    // Add the contributions to the residual
-    if (res) {
-      basis->addWeakResidual(n, pt, detXd, J, vars_per_node, DUt, DUx, res);
+  // Evaluate the weak form in blocks of quadrature points
+  for (int start = 0; start < nquad; start += max_npts) {
+    int npts = nquad - start;
+    if (npts > max_npts) {
+      npts = max_npts;
     }
 
-    // Add the weak form of the Jacobian
-    basis->scaleWeakMatrix(detXd, alpha, beta, gamma, Jac_nnz, Jac_pairs, Jac);
-    basis->addWeakMatrix(n, pt, J, vars_per_node, Jac_nnz, Jac_pairs, Jac, mat);
+    // Get the solution field and the solution field gradient and the
+    // Jacobian transformation at each point
+    int elems[MAX_BATCH_POINTS], index[MAX_BATCH_POINTS];
+    double pts[3 * MAX_BATCH_POINTS];
+    TacsScalar detXd[MAX_BATCH_POINTS];
+    TacsScalar X[3 * MAX_BATCH_POINTS], Xd[9 * MAX_BATCH_POINTS];
+    TacsScalar J[9 * MAX_BATCH_POINTS];
+    TacsScalar Ut[3 * MAX_VARS_PER_NODE * MAX_BATCH_POINTS];
+    TacsScalar Ux[3 * MAX_VARS_PER_NODE * MAX_BATCH_POINTS];
+    getFieldGradientPoints(elemIndex, start, npts, Xpts, vars, dvars, ddvars,
+                           elems, index, pts, detXd, X, Xd, J, Ut, Ux);
+
+    // Evaluate the weak form of the model at all points
+    TacsScalar DUt[3 * MAX_VARS_PER_NODE * MAX_BATCH_POINTS];
+    TacsScalar DUx[3 * MAX_VARS_PER_NODE * MAX_BATCH_POINTS];
+    TacsScalar Jac[MAX_BATCH_JAC_SIZE];
+    model->evalWeakMatrixPoints(TACS_JACOBIAN_MATRIX, npts, elems, time, index,
+                                pts, X, Xd, Ut, Ux, DUt, DUx, Jac);
+
+    for (int i = 0; i < npts; i++) {
+      double pt[3] = {pts[i], pts[npts + i], pts[2 * npts + i]};
+
+      // Add the contributions to the residual
+      if (res) {
+        TacsScalar DUtp[3 * MAX_VARS_PER_NODE], DUxp[3 * MAX_VARS_PER_NODE];
+        TACSElement3DGatherPoint(npts, i, 3 * vars_per_node, DUt, DUtp);
+        TACSElement3DGatherPoint(npts, i, 3 * vars_per_node, DUx, DUxp);
+        basis->addWeakResidual(index[i], pt, detXd[i], &J[9 * i],
+                               vars_per_node, DUtp, DUxp, res);
+      }
+
+      // Add the weak form of the Jacobian at this point
+      TacsScalar Jacp[36 * MAX_VARS_PER_NODE * MAX_VARS_PER_NODE];
+      TACSElement3DGatherPoint(npts, i, Jac_nnz, Jac, Jacp);
+      basis->scaleWeakMatrix(detXd[i], alpha, beta, gamma, Jac_nnz, Jac_pairs,
+                             Jacp);
+      basis->addWeakMatrix(index[i], pt, &J[9 * i], vars_per_node, Jac_nnz,
+                           Jac_pairs, Jacp, mat);
+    }
   }
 }
 
@@ -309,6 +401,132 @@ void TACSElement3D::addAdjResXptProduct(
   }
 }
 
+/*
+  Add the directional derivative of the residual w.r.t. the design
+  variables
+
+  The model provides the derivative of the weak form coefficients along
+  the design direction at each quadrature point, which is integrated
+  like the residual itself. The scratch array is passed to the model.
+*/
+void TACSElement3D::addResidualDVSensVecProduct(
+    int elemIndex, double time, TacsScalar scale, const TacsScalar Xpts[],
+    const TacsScalar vars[], const TacsScalar dvars[],
+    const TacsScalar ddvars[], int dvLen, const TacsScalar pdx[],
+    TacsScalar work[], TacsScalar res[]) {
+  // Compute the number of quadrature points
+  const int nquad = basis->getNumQuadraturePoints();
+  const int vars_per_node = model->getVarsPerNode();
+  if (dvLen * model->getDesignVarsPerNode() == 0) {
+    return;
+  }
+
+  // Loop over each quadrature point and add the residual contribution
+  for (int n = 0; n < nquad; n++) {
+    // Get the quadrature weight
+    double pt[3];
+    double weight = basis->getQuadraturePoint(n, pt);
+
+    // Get the solution field and the solution field gradient and the
+    // Jacobian transformation
+    TacsScalar X[3], Xd[9], J[9];
+    TacsScalar Ut[3 * MAX_VARS_PER_NODE];
+    TacsScalar Ud[3 * MAX_VARS_PER_NODE], Ux[3 * MAX_VARS_PER_NODE];
+    TacsScalar detXd =
+        basis->getFieldGradient(n, pt, Xpts, vars_per_node, vars, dvars,
+                                ddvars, X, Xd, J, Ut, Ud, Ux);
+
+    // Compute the derivative of the coefficients along the design
+    // direction
+    TacsScalar pDUt[3 * MAX_VARS_PER_NODE], pDUx[3 * MAX_VARS_PER_NODE];
+    model->evalWeakDVSensVecProduct(elemIndex, time, n, pt, X, Xd, Ut, Ux,
+                                    dvLen, pdx, work, pDUt, pDUx);
+
+    basis->addWeakResidual(n, pt, scale * weight * detXd, J, vars_per_node,
+                           pDUt, pDUx, res);
+  }
+}
+
+/*
+  Add the directional derivative of the residual w.r.t. the node
+  locations
+
+  The node direction perturbs the position X, the derivative Xd, the
+  transformation J = Xd^{-1}, its determinant and the spatial
+  derivatives Ux = Ud*J. The model provides the derivative of the weak
+  form coefficients along the perturbation of X, Xd and Ux.
+*/
+void TACSElement3D::addResidualXptSensVecProduct(
+    int elemIndex, double time, TacsScalar scale, const TacsScalar Xpts[],
+    const TacsScalar vars[], const TacsScalar dvars[],
+    const TacsScalar ddvars[], const TacsScalar pXpts[], TacsScalar work[],
+    TacsScalar res[]) {
+  // Compute the number of quadrature points
+  const int nquad = basis->getNumQuadraturePoints();
+  const int vars_per_node = model->getVarsPerNode();
+
+  // Loop over each quadrature point and add the residual contribution
+  for (int n = 0; n < nquad; n++) {
+    // Get the quadrature weight
+    double pt[3];
+    double weight = basis->getQuadraturePoint(n, pt);
+
+    // Get the solution field and the solution field gradient and the
+    // Jacobian transformation
+    TacsScalar X[3], Xd[9], J[9];
+    TacsScalar Ut[3 * MAX_VARS_PER_NODE];
+    TacsScalar Ud[3 * MAX_VARS_PER_NODE], Ux[3 * MAX_VARS_PER_NODE];
+    TacsScalar detXd =
+        basis->getFieldGradient(n, pt, Xpts, vars_per_node, vars, dvars,
+                                ddvars, X, Xd, J, Ut, Ud, Ux);
+
+    // Evaluate the weak form coefficients
+    TacsScalar DUt[3 * MAX_VARS_PER_NODE], DUx[3 * MAX_VARS_PER_NODE];
+    model->evalWeakIntegrand(elemIndex, time, n, pt, X, Xd, Ut, Ux, DUt, DUx);
+
+    // Compute the perturbation of X and Xd along the node direction
+    TacsScalar pX[3], pXd[9];
+    basis->interpFields(n, pt, 3, pXpts, 1, pX);
+    basis->interpFieldsGrad(n, pt, 3, pXpts, pXd);
+
+    // Compute pJ = -J*pXd*J and pdetXd = detXd*tr(J*pXd)
+    TacsScalar JpXd[9], pJ[9];
+    mat3x3MatMult(J, pXd, JpXd);
+    mat3x3MatMult(JpXd, J, pJ);
+    for (int i = 0; i < 9; i++) {
+      pJ[i] = -pJ[i];
+    }
+    TacsScalar pdetXd = detXd * (JpXd[0] + JpXd[4] + JpXd[8]);
+
+    // Compute the perturbation of Ux = Ud*J
+    TacsScalar pUx[3 * MAX_VARS_PER_NODE];
+    for (int j = 0; j < vars_per_node; j++) {
+      mat3x3MultTrans(pJ, &Ud[3 * j], &pUx[3 * j]);
+    }
+
+    // Compute the perturbed coefficients
+    TacsScalar pDUt[3 * MAX_VARS_PER_NODE], pDUx[3 * MAX_VARS_PER_NODE];
+    model->evalWeakXptSensVecProduct(elemIndex, time, n, pt, X, Xd, Ut, Ux, pX,
+                                     pXd, pUx, pDUt, pDUx);
+
+    // Form the coefficients detXd*pDUt + pdetXd*DUt and similarly for
+    // DUx
+    for (int i = 0; i < 3 * vars_per_node; i++) {
+      pDUt[i] = detXd * pDUt[i] + pdetXd * DUt[i];
+    }
+    for (int i = 0; i < 3 * vars_per_node; i++) {
+      pDUx[i] = detXd * pDUx[i] + pdetXd * DUx[i];
+    }
+    basis->addWeakResidual(n, pt, scale * weight, J, vars_per_node, pDUt,
+                           pDUx, res);
+
+    // Add the contribution from the perturbation of J
+    memset(pDUt, 0, 3 * vars_per_node * sizeof(TacsScalar));
+    basis->addWeakResidual(n, pt, scale * weight * detXd, pJ, vars_per_node,
+                           pDUt, DUx, res);
+  }
+}
+
 /**
   Compute a specific type of element matrix (mass, stiffness, geometric
   stiffness, etc.)
@@ -557,6 +775,63 @@ int TACSElement3D::evalPointQuantity(
                                   Ut, Ux, quantity);
 }
 
+/**
+   Evaluate a point-wise quantity of interest at a set of points
+*/
+int TACSElement3D::evalPointQuantities(
+    int elemIndex, int quantityType, double time, int npts, const int n[],
+    const double pt[], const TacsScalar Xpts[], const TacsScalar vars[],
+    const TacsScalar dvars[], const TacsScalar ddvars[], TacsScalar detXd[],
+    TacsScalar quantity[]) {
+  const int vars_per_node = model->getVarsPerNode();
+
+  int count = 0;
+  for (int start = 0; start < npts; start += MAX_BATCH_POINTS) {
+    int size = npts - start;
+    if (size > MAX_BATCH_POINTS) {
+      size = MAX_BATCH_POINTS;
+    }
+
+    // Compute the field gradient at each point
+    int elems[MAX_BATCH_POINTS];
+    double pts[3 * MAX_BATCH_POINTS];
+    TacsScalar X[3 * MAX_BATCH_POINTS], Xd[9 * MAX_BATCH_POINTS];
+    TacsScalar Ut[3 * MAX_VARS_PER_NODE * MAX_BATCH_POINTS];
+    TacsScalar Ux[3 * MAX_VARS_PER_NODE * MAX_BATCH_POINTS];
+    for (int i = 0; i < size; i++) {
+      double p[3];
+      p[0] = pts[i] = pt[start + i];
+      p[1] = pts[size + i] = pt[npts + start + i];
+      p[2] = pts[2 * size + i] = pt[2 * npts + start + i];
+      elems[i] = elemIndex;
+
+      TacsScalar Xp[3], Xdp[9], J[9];
+      TacsScalar Utp[3 * MAX_VARS_PER_NODE];
+      TacsScalar Ud[3 * MAX_VARS_PER_NODE], Uxp[3 * MAX_VARS_PER_NODE];
+      basis->getFieldGradient(n[start + i], p, Xpts, vars_per_node, vars,
+                              dvars, ddvars, Xp, Xdp, J, Utp, Ud, Uxp);
+      detXd[start + i] = det3x3(Xdp);
+
+      TACSElement3DScatterPoint(size, i, 3, Xp, X);
+      TACSElement3DScatterPoint(size, i, 9, Xdp, Xd);
+      TACSElement3DScatterPoint(size, i, 3 * vars_per_node, Utp, Ut);
+      TACSElement3DScatterPoint(size, i, 3 * vars_per_node, Uxp, Ux);
+    }
+
+    // Evaluate the quantity at all points in the block
+    TacsScalar q[TACSElementModel::MAX_POINT_QUANTITY_SIZE * MAX_BATCH_POINTS];
+    count = model->evalPointQuantities(size, elems, quantityType, time,
+                                       &n[start], pts, X, Xd, Ut, Ux, q);
+    for (int j = 0; j < count; j++) {
+      for (int i = 0; i < size; i++) {
+        quantity[j * npts + start + i] = q[j * size + i];
+      }
+    }
+  }
+
+  return count;
+}
+
 /**
    Add the derivative of the point quantity w.r.t. the design variables
 */
@@ -652,6 +927,115 @@ void TACSElement3D::addPointQuantityXptSens(
                                  dfdXpts);
 }
 
+/**
+   Add the derivatives of several functions of the point quantity w.r.t.
+   the design variables. The field gradient is only computed once.
+*/
+void TACSElement3D::addPointQuantityDVSensBatch(
+    int elemIndex, int quantityType, double time, TacsScalar scale, int n,
+    double pt[], const TacsScalar Xpts[], const TacsScalar vars[],
+    const TacsScalar dvars[], const TacsScalar ddvars[], int numFuncs,
+    int ldq, const TacsScalar dfdq[], int dvLen, TacsScalar *dfdx[]) {
+  const int vars_per_node = model->getVarsPerNode();
+  TacsScalar X[3], Xd[9], J[9];
+  TacsScalar Ut[3 * MAX_VARS_PER_NODE];
+  TacsScalar Ud[3 * MAX_VARS_PER_NODE], Ux[3 * MAX_VARS_PER_NODE];
+  basis->getFieldGradient(n, pt, Xpts, vars_per_node, vars, dvars, ddvars, X,
+                          Xd, J, Ut, Ud, Ux);
+
+  for (int k = 0; k < numFuncs; k++) {
+    model->addPointQuantityDVSens(elemIndex, quantityType, time, scale, n, pt,
+                                  X, Xd, Ut, Ux, &dfdq[ldq * k], dvLen,
+                                  dfdx[k]);
+  }
+}
+
+/**
+   Add the derivatives of several functions of the point quantity w.r.t.
+   the state variables
+*/
+void TACSElement3D::addPointQuantitySVSensBatch(
+    int elemIndex, int quantityType, double time, TacsScalar alpha,
+    TacsScalar beta, TacsScalar gamma, int n, double pt[],
+    const TacsScalar Xpts[], const TacsScalar vars[], const TacsScalar dvars[],
+    const TacsScalar ddvars[], int numFuncs, int ldq, const TacsScalar dfdq[],
+    TacsScalar *dfdu[]) {
+  const int vars_per_node = model->getVarsPerNode();
+  TacsScalar X[3], Xd[9], J[9];
+  TacsScalar Ut[3 * MAX_VARS_PER_NODE];
+  TacsScalar Ud[3 * MAX_VARS_PER_NODE], Ux[3 * MAX_VARS_PER_NODE];
+  basis->getFieldGradient(n, pt, Xpts, vars_per_node, vars, dvars, ddvars, X,
+                          Xd, J, Ut, Ud, Ux);
+
+  for (int k = 0; k < numFuncs; k++) {
+    // Evaluate the derivative of the function with respect to X, Ut, Ux
+    TacsScalar dfdX[3], dfdXd[9];
+    TacsScalar dfdUt[3 * MAX_VARS_PER_NODE], dfdUx[3 * MAX_VARS_PER_NODE];
+    model->evalPointQuantitySens(elemIndex, quantityType, time, n, pt, X, Xd,
+                                 Ut, Ux, &dfdq[ldq * k], dfdX, dfdXd, dfdUt,
+                                 dfdUx);
+
+    // Multiply by the scalar coefficients
+    for (int i = 0; i < vars_per_node; i++) {
+      dfdUt[3 * i] *= alpha;
+      dfdUt[3 * i + 1] *= beta;
+      dfdUt[3 * i + 2] *= gamma;
+
+      dfdUx[3 * i] *= alpha;
+      dfdUx[3 * i + 1] *= alpha;
+      dfdUx[3 * i + 2] *= alpha;
+    }
+
+    basis->addFieldGradientSVSens(n, pt, Xpts, vars_per_node, Xd, J, Ud, dfdUt,
+                                  dfdUx, dfdu[k]);
+  }
+}
+
+/**
+   Add the derivatives of several functions of the point quantity w.r.t.
+   the node locations
+*/
+void TACSElement3D::addPointQuantityXptSensBatch(
+    int elemIndex, int quantityType, double time, TacsScalar scale, int n,
+    double pt[], const TacsScalar Xpts[], const TacsScalar vars[],
+    const TacsScalar dvars[], const TacsScalar ddvars[], int numFuncs,
+    const TacsScalar dfddetXd[], int ldq, const TacsScalar dfdq[],
+    TacsScalar *dfdXpts[]) {
+  const int vars_per_node = model->getVarsPerNode();
+  TacsScalar X[3], Xd[9], J[9];
+  TacsScalar Ut[3 * MAX_VARS_PER_NODE];
+  TacsScalar Ud[3 * MAX_VARS_PER_NODE], Ux[3 * MAX_VARS_PER_NODE];
+  basis->getFieldGradient(n, pt, Xpts, vars_per_node, vars, dvars, ddvars, X,
+                          Xd, J, Ut, Ud, Ux);
+
+  for (int k = 0; k < numFuncs; k++) {
+    // Evaluate the derivative of the function with respect to X, Ut, Ux
+    TacsScalar dfdX[3], dfdXd[9];
+    TacsScalar dfdUt[3 * MAX_VARS_PER_NODE], dfdUx[3 * MAX_VARS_PER_NODE];
+    model->evalPointQuantitySens(elemIndex, quantityType, time, n, pt, X, Xd,
+                                 Ut, Ux, &dfdq[ldq * k], dfdX, dfdXd, dfdUt,
+                                 dfdUx);
+
+    // Scale the derivatives appropriately
+    dfdX[0] *= scale;
+    dfdX[1] *= scale;
+    dfdX[2] *= scale;
+
+    for (int i = 0; i < 9; i++) {
+      dfdXd[i] *= scale;
+    }
+
+    for (int i = 0; i < 3 * vars_per_node; i++) {
+      dfdUt[i] *= scale;
+      dfdUx[i] *= scale;
+    }
+
+    basis->addFieldGradientXptSens(n, pt, Xpts, vars_per_node, Xd, J, Ud,
+                                   scale * dfddetXd[k], dfdX, dfdXd, NULL,
+                                   dfdUx, dfdXpts[k]);
+  }
+}
+
 /*
   Get the element data for the basis
 */
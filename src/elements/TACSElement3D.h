@@ -23,6 +23,12 @@ class TACSElement3D : public TACSElement {
  public:
   static const int MAX_VARS_PER_NODE = 8;
 
+  // The number of quadrature points evaluated together by the model
+  static const int MAX_BATCH_POINTS = 16;
+
+  // The size of the buffer for the weak form Jacobian entries
+  static const int MAX_BATCH_JAC_SIZE = 4096;
+
   TACSElement3D(TACSElementModel *_model, TACSElementBasis *_basis);
   ~TACSElement3D();
 
@@ -103,6 +109,30 @@ class TACSElement3D : public TACSElement {
                            const TacsScalar vars[], const TacsScalar dvars[],
                            const TacsScalar ddvars[], TacsScalar fXptSens[]);
 
+  /**
+    Add the directional derivative of the residual w.r.t. the design
+    variables
+  */
+  void addResidualDVSensVecProduct(int elemIndex, double time,
+                                   TacsScalar scale, const TacsScalar Xpts[],
+                                   const TacsScalar vars[],
+                                   const TacsScalar dvars[],
+                                   const TacsScalar ddvars[], int dvLen,
+                                   const TacsScalar pdx[], TacsScalar work[],
+                                   TacsScalar res[]);
+
+  /**
+    Add the directional derivative of the residual w.r.t. the node
+    locations
+  */
+  void addResidualXptSensVecProduct(int elemIndex, double time,
+                                    TacsScalar scale, const TacsScalar Xpts[],
+                                    const TacsScalar vars[],
+                                    const TacsScalar dvars[],
+                                    const TacsScalar ddvars[],
+                                    const TacsScalar pXpts[],
+                                    TacsScalar work[], TacsScalar res[]);
+
   /**
     Get the size of the data for the matrix-vector product
   */
@@ -154,6 +184,15 @@ class TACSElement3D : public TACSElement {
                                 const TacsScalar phi[], const TacsScalar Xpts[],
                                 const TacsScalar vars[], TacsScalar dfdu[]);
 
+  /**
+    Evaluate a point-wise quantity of interest at a set of points
+  */
+  int evalPointQuantities(int elemIndex, int quantityType, double time,
+                          int npts, const int n[], const double pt[],
+                          const TacsScalar Xpts[], const TacsScalar vars[],
+                          const TacsScalar dvars[], const TacsScalar ddvars[],
+                          TacsScalar detXd[], TacsScalar quantity[]);
+
   /**
     Evaluate a point-wise quantity of interest.
   */
@@ -196,6 +235,41 @@ class TACSElement3D : public TACSElement {
                                const TacsScalar dfddetXd,
                                const TacsScalar dfdq[], TacsScalar dfdXpts[]);
 
+  /**
+    Add the derivatives of several functions w.r.t. the design variables
+  */
+  void addPointQuantityDVSensBatch(int elemIndex, int quantityType,
+                                   double time, TacsScalar scale, int n,
+                                   double pt[], const TacsScalar Xpts[],
+                                   const TacsScalar vars[],
+                                   const TacsScalar dvars[],
+                                   const TacsScalar ddvars[], int numFuncs,
+                                   int ldq, const TacsScalar dfdq[],
+                                   int dvLen, TacsScalar *dfdx[]);
+
+  /**
+    Add the derivatives of several functions w.r.t. the state variables
+  */
+  void addPointQuantitySVSensBatch(int elemIndex, int quantityType,
+                                   double time, TacsScalar alpha,
+                                   TacsScalar beta, TacsScalar gamma, int n,
+                                   double pt[], const TacsScalar Xpts[],
+                                   const TacsScalar vars[],
+                                   const TacsScalar dvars[],
+                                   const TacsScalar ddvars[], int numFuncs,
+                                   int ldq, const TacsScalar dfdq[],
+                                   TacsScalar *dfdu[]);
+
+  /**
+    Add the derivatives of several functions w.r.t. the node locations
+  */
+  void addPointQuantityXptSensBatch(
+      int elemIndex, int quantityType, double time, TacsScalar scale, int n,
+      double pt[], const TacsScalar Xpts[], const TacsScalar vars[],
+      const TacsScalar dvars[], const TacsScalar ddvars[], int numFuncs,
+      const TacsScalar dfddetXd[], int ldq, const TacsScalar dfdq[],
+      TacsScalar *dfdXpts[]);
+
   /**
     Compute the output data for visualization
   */
@@ -205,6 +279,15 @@ class TACSElement3D : public TACSElement {
                      int ld_data, TacsScalar *data);
 
  private:
+  // Compute the field gradient at a block of quadrature points
+  void getFieldGradientPoints(int elemIndex, int start, int npts,
+                              const TacsScalar Xpts[], const TacsScalar vars[],
+                              const TacsScalar dvars[],
+                              const TacsScalar ddvars[], int elems[],
+                              int index[], double pts[], TacsScalar detXd[],
+                              TacsScalar X[], TacsScalar Xd[], TacsScalar J[],
+                              TacsScalar Ut[], TacsScalar Ux[]);
+
   TACSElementModel *model;
   TACSElementBasis *basis;
 };
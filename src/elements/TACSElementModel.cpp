@@ -0,0 +1,244 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2014 Georgia Tech Research Corporation
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSElementModel.h"
+
+/*
+  The size of the buffers for the derivatives and the weak form
+  Jacobian at a single point
+*/
+static const int MAX_POINT_UT_SIZE = 3 * TACSElementModel::MAX_VARS_PER_NODE;
+static const int MAX_POINT_UX_SIZE = 3 * TACSElementModel::MAX_VARS_PER_NODE;
+static const int MAX_POINT_JAC_SIZE =
+    (MAX_POINT_UT_SIZE + MAX_POINT_UX_SIZE) *
+    (MAX_POINT_UT_SIZE + MAX_POINT_UX_SIZE);
+
+/*
+  Copy the values at a single point from the structure-of-arrays
+  format into a contiguous array
+*/
+template <typename T>
+static inline void TacsGatherPoint(int npts, int i, int size, const T *in,
+                                   T *out) {
+  for (int j = 0; j < size; j++) {
+    out[j] = in[j * npts + i];
+  }
+}
+
+/*
+  Copy the values at a single point from a contiguous array into the
+  structure-of-arrays format
+*/
+template <typename T>
+static inline void TacsScatterPoint(int npts, int i, int size, const T *in,
+                                    T *out) {
+  for (int j = 0; j < size; j++) {
+    out[j * npts + i] = in[j];
+  }
+}
+
+/*
+  Evaluate the derivative of the weak form coefficients along the design
+  direction one coefficient at a time
+*/
+void TACSElementModel::evalWeakDVSensVecProduct(
+    int elemIndex, const double time, int n, const double pt[],
+    const TacsScalar X[], const TacsScalar Xd[], const TacsScalar Ut[],
+    const TacsScalar Ux[], int dvLen, const TacsScalar pdx[],
+    TacsScalar work[], TacsScalar pDUt[], TacsScalar pDUx[]) {
+  const int vars_per_node = getVarsPerNode();
+  const int ncoef = (1 + getNumParameters()) * vars_per_node;
+  const int dvSize = dvLen * getDesignVarsPerNode();
+
+  // The unit adjoint value for each variable, followed by the unit
+  // adjoint gradient components
+  TacsScalar Psi[MAX_POINT_UT_SIZE + MAX_POINT_UX_SIZE];
+  TacsScalar *Psix = &Psi[vars_per_node];
+  memset(Psi, 0, ncoef * sizeof(TacsScalar));
+
+  memset(pDUt, 0, 3 * vars_per_node * sizeof(TacsScalar));
+  for (int i = 0; i < ncoef; i++) {
+    Psi[i] = 1.0;
+    memset(work, 0, dvSize * sizeof(TacsScalar));
+    addWeakAdjProduct(elemIndex, time, 1.0, n, pt, X, Xd, Ut, Ux, Psi, Psix,
+                      dvLen, work);
+    Psi[i] = 0.0;
+
+    TacsScalar product = 0.0;
+    for (int k = 0; k < dvSize; k++) {
+      product += work[k] * pdx[k];
+    }
+    if (i < vars_per_node) {
+      pDUt[3 * i] = product;
+    } else {
+      pDUx[i - vars_per_node] = product;
+    }
+  }
+}
+
+/*
+  Evaluate the derivative of the weak form coefficients along the
+  perturbation of the geometry one coefficient at a time
+*/
+void TACSElementModel::evalWeakXptSensVecProduct(
+    int elemIndex, const double time, int n, const double pt[],
+    const TacsScalar X[], const TacsScalar Xd[], const TacsScalar Ut[],
+    const TacsScalar Ux[], const TacsScalar pX[], const TacsScalar pXd[],
+    const TacsScalar pUx[], TacsScalar pDUt[], TacsScalar pDUx[]) {
+  const int vars_per_node = getVarsPerNode();
+  const int num_params = getNumParameters();
+  const int ncoef = (1 + num_params) * vars_per_node;
+
+  // The unit adjoint value for each variable, followed by the unit
+  // adjoint gradient components
+  TacsScalar Psi[MAX_POINT_UT_SIZE + MAX_POINT_UX_SIZE];
+  TacsScalar *Psix = &Psi[vars_per_node];
+  memset(Psi, 0, ncoef * sizeof(TacsScalar));
+
+  memset(pDUt, 0, 3 * vars_per_node * sizeof(TacsScalar));
+  for (int i = 0; i < ncoef; i++) {
+    Psi[i] = 1.0;
+    TacsScalar product, dfdX[3], dfdXd[9];
+    TacsScalar dfdUx[MAX_POINT_UX_SIZE], dfdPsix[MAX_POINT_UX_SIZE];
+    evalWeakAdjXptSensProduct(elemIndex, time, n, pt, X, Xd, Ut, Ux, Psi, Psix,
+                              &product, dfdX, dfdXd, dfdUx, dfdPsix);
+    Psi[i] = 0.0;
+
+    TacsScalar pDU = dfdX[0] * pX[0] + dfdX[1] * pX[1] + dfdX[2] * pX[2];
+    for (int k = 0; k < 3 * num_params; k++) {
+      pDU += dfdXd[k] * pXd[k];
+    }
+    for (int k = 0; k < num_params * vars_per_node; k++) {
+      pDU += dfdUx[k] * pUx[k];
+    }
+    if (i < vars_per_node) {
+      pDUt[3 * i] = pDU;
+    } else {
+      pDUx[i - vars_per_node] = pDU;
+    }
+  }
+}
+
+/*
+  Evaluate the weak form integrand at each point in turn
+*/
+void TACSElementModel::evalWeakIntegrandPoints(
+    int npts, const int elemIndex[], const double time, const int n[],
+    const double pt[], const TacsScalar X[], const TacsScalar Xd[],
+    const TacsScalar Ut[], const TacsScalar Ux[], TacsScalar DUt[],
+    TacsScalar DUx[]) {
+  const int vars_per_node = getVarsPerNode();
+  const int num_params = getNumParameters();
+  const int ut_size = 3 * vars_per_node;
+  const int ux_size = num_params * vars_per_node;
+
+  // The values at a single point
+  TacsScalar Xp[3], Xdp[9];
+  TacsScalar Utp[MAX_POINT_UT_SIZE], Uxp[MAX_POINT_UX_SIZE];
+  TacsScalar DUtp[MAX_POINT_UT_SIZE], DUxp[MAX_POINT_UX_SIZE];
+
+  for (int i = 0; i < npts; i++) {
+    double ptp[3];
+    TacsGatherPoint(npts, i, 3, pt, ptp);
+    TacsGatherPoint(npts, i, 3, X, Xp);
+    TacsGatherPoint(npts, i, 3 * num_params, Xd, Xdp);
+    TacsGatherPoint(npts, i, ut_size, Ut, Utp);
+    TacsGatherPoint(npts, i, ux_size, Ux, Uxp);
+
+    evalWeakIntegrand(elemIndex[i], time, n[i], ptp, Xp, Xdp, Utp, Uxp, DUtp,
+                      DUxp);
+
+    TacsScatterPoint(npts, i, ut_size, DUtp, DUt);
+    TacsScatterPoint(npts, i, ux_size, DUxp, DUx);
+  }
+}
+
+/*
+  Evaluate the weak form matrix at each point in turn
+*/
+void TACSElementModel::evalWeakMatrixPoints(
+    ElementMatrixType matType, int npts, const int elemIndex[],
+    const double time, const int n[], const double pt[], const TacsScalar X[],
+    const TacsScalar Xd[], const TacsScalar Ut[], const TacsScalar Ux[],
+    TacsScalar DUt[], TacsScalar DUx[], TacsScalar Jac[]) {
+  if (npts <= 0) {
+    return;
+  }
+
+  const int vars_per_node = getVarsPerNode();
+  const int num_params = getNumParameters();
+  const int ut_size = 3 * vars_per_node;
+  const int ux_size = num_params * vars_per_node;
+
+  int Jac_nnz;
+  const int *Jac_pairs;
+  getWeakMatrixNonzeros(matType, elemIndex[0], &Jac_nnz, &Jac_pairs);
+
+  // The values at a single point
+  TacsScalar Xp[3], Xdp[9];
+  TacsScalar Utp[MAX_POINT_UT_SIZE], Uxp[MAX_POINT_UX_SIZE];
+  TacsScalar DUtp[MAX_POINT_UT_SIZE], DUxp[MAX_POINT_UX_SIZE];
+  TacsScalar Jacp[MAX_POINT_JAC_SIZE];
+
+  for (int i = 0; i < npts; i++) {
+    double ptp[3];
+    TacsGatherPoint(npts, i, 3, pt, ptp);
+    TacsGatherPoint(npts, i, 3, X, Xp);
+    TacsGatherPoint(npts, i, 3 * num_params, Xd, Xdp);
+    TacsGatherPoint(npts, i, ut_size, Ut, Utp);
+    TacsGatherPoint(npts, i, ux_size, Ux, Uxp);
+
+    evalWeakMatrix(matType, elemIndex[i], time, n[i], ptp, Xp, Xdp, Utp, Uxp,
+                   DUtp, DUxp, Jacp);
+
+    TacsScatterPoint(npts, i, ut_size, DUtp, DUt);
+    TacsScatterPoint(npts, i, ux_size, DUxp, DUx);
+    TacsScatterPoint(npts, i, Jac_nnz, Jacp, Jac);
+  }
+}
+
+/*
+  Evaluate the quantity of interest at each point in turn
+*/
+int TACSElementModel::evalPointQuantities(
+    int npts, const int elemIndex[], const int quantityType, const double time,
+    const int n[], const double pt[], const TacsScalar X[],
+    const TacsScalar Xd[], const TacsScalar Ut[], const TacsScalar Ux[],
+    TacsScalar quantity[]) {
+  const int vars_per_node = getVarsPerNode();
+  const int num_params = getNumParameters();
+  const int ut_size = 3 * vars_per_node;
+  const int ux_size = num_params * vars_per_node;
+
+  // The values at a single point
+  TacsScalar Xp[3], Xdp[9];
+  TacsScalar Utp[MAX_POINT_UT_SIZE], Uxp[MAX_POINT_UX_SIZE];
+
+  int count = 0;
+  for (int i = 0; i < npts; i++) {
+    double ptp[3];
+    TacsGatherPoint(npts, i, 3, pt, ptp);
+    TacsGatherPoint(npts, i, 3, X, Xp);
+    TacsGatherPoint(npts, i, 3 * num_params, Xd, Xdp);
+    TacsGatherPoint(npts, i, ut_size, Ut, Utp);
+    TacsGatherPoint(npts, i, ux_size, Ux, Uxp);
+
+    TacsScalar q[MAX_POINT_QUANTITY_SIZE];
+    count = evalPointQuantity(elemIndex[i], quantityType, time, n[i], ptp, Xp,
+                              Xdp, Utp, Uxp, q);
+    TacsScatterPoint(npts, i, count, q, quantity);
+  }
+
+  return count;
+}
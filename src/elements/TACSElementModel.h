@@ -25,6 +25,16 @@
 */
 class TACSElementModel : public TACSObject {
  public:
+  // The maximum length of a quantity in evalPointQuantities()
+  static const int MAX_POINT_QUANTITY_SIZE = 16;
+
+  // The number of points processed together within the models
+  static const int POINT_BLOCK_SIZE = 16;
+
+  // The maximum number of variables per node supported by the default
+  // implementations of the point evaluation routines
+  static const int MAX_VARS_PER_NODE = 8;
+
   /**
     Returns the spatial dimension of the element: 1, 2 or 3
 
@@ -225,6 +235,72 @@ class TACSElementModel : public TACSObject {
     }
   }
 
+  /**
+    Evaluate the derivative of the weak form coefficients along a
+    direction in the design variables
+
+    pDUt = d(DUt)/dx*pdx, pDUx = d(DUx)/dx*pdx
+
+    By default, each coefficient is found from addWeakAdjProduct with
+    a unit adjoint value or adjoint gradient. Since the three time
+    coefficients for each variable multiply the same basis functions,
+    only their sum is found and stored in the first entry. Models
+    should override this with a direct computation.
+
+    @param elemIndex The local element index
+    @param time The simulation time
+    @param n The quadrature point index
+    @param pt The parametric position of the quadrature point
+    @param X The physical position of the quadrature point
+    @param Xd The derivative physical position of the quadrature point
+    @param Ut Values of the state variables and their 1st/2nd time derivs
+    @param Ux The spatial derivatives of the state variables
+    @param dvLen The length of the design variable vector
+    @param pdx The design variable direction
+    @param work Scratch array with space for the number of stresses of
+    the constitutive object plus dvLen*getDesignVarsPerNode() entries
+    @param pDUt The derivative of the time-dependent coefficients
+    @param pDUx The derivative of the spatial-derivative coefficients
+  */
+  virtual void evalWeakDVSensVecProduct(
+      int elemIndex, const double time, int n, const double pt[],
+      const TacsScalar X[], const TacsScalar Xd[], const TacsScalar Ut[],
+      const TacsScalar Ux[], int dvLen, const TacsScalar pdx[],
+      TacsScalar work[], TacsScalar pDUt[], TacsScalar pDUx[]);
+
+  /**
+    Evaluate the derivative of the weak form coefficients along a
+    perturbation of the point location, its derivative and the spatial
+    derivatives of the state variables
+
+    pDUt = d(DUt)/dX*pX + d(DUt)/dXd*pXd + d(DUt)/dUx*pUx
+
+    and similarly for pDUx. By default, each coefficient is found from
+    evalWeakAdjXptSensProduct with a unit adjoint value or adjoint
+    gradient and the time coefficients are stored as in
+    evalWeakDVSensVecProduct. Models should override this with a
+    direct computation.
+
+    @param elemIndex The local element index
+    @param time The simulation time
+    @param n The quadrature point index
+    @param pt The parametric position of the quadrature point
+    @param X The physical position of the quadrature point
+    @param Xd The derivative physical position of the quadrature point
+    @param Ut Values of the state variables and their 1st/2nd time derivs
+    @param Ux The spatial derivatives of the state variables
+    @param pX The perturbation of X
+    @param pXd The perturbation of Xd
+    @param pUx The perturbation of Ux
+    @param pDUt The derivative of the time-dependent coefficients
+    @param pDUx The derivative of the spatial-derivative coefficients
+  */
+  virtual void evalWeakXptSensVecProduct(
+      int elemIndex, const double time, int n, const double pt[],
+      const TacsScalar X[], const TacsScalar Xd[], const TacsScalar Ut[],
+      const TacsScalar Ux[], const TacsScalar pX[], const TacsScalar pXd[],
+      const TacsScalar pUx[], TacsScalar pDUt[], TacsScalar pDUx[]);
+
   /**
     Get the non-zero pattern of the element type
 
@@ -432,6 +508,92 @@ class TACSElementModel : public TACSObject {
       TacsScalar dfdX[], TacsScalar dfdXd[], TacsScalar dfdUt[],
       TacsScalar dfdUx[]) {}
 
+  /**
+    Evaluate the weak form integrand at a set of points
+
+    The point-wise arrays are stored in a structure-of-arrays format
+    where the j-th component at the i-th point is stored in
+    A[j*npts + i]. The points may belong to different elements. The
+    default implementation calls evalWeakIntegrand() at each point.
+
+    @param npts The number of points
+    @param elemIndex The local element index for each point
+    @param time The simulation time
+    @param n The quadrature point index for each point
+    @param pt The parametric positions (3 x npts)
+    @param X The physical positions (3 x npts)
+    @param Xd The position derivatives (3*num_params x npts)
+    @param Ut The state variables and time derivs (3*vars_per_node x npts)
+    @param Ux The spatial derivatives (num_params*vars_per_node x npts)
+    @param DUt The time-dependent coefficients (3*vars_per_node x npts)
+    @param DUx The spatial coefficients (num_params*vars_per_node x npts)
+  */
+  virtual void evalWeakIntegrandPoints(
+      int npts, const int elemIndex[], const double time, const int n[],
+      const double pt[], const TacsScalar X[], const TacsScalar Xd[],
+      const TacsScalar Ut[], const TacsScalar Ux[], TacsScalar DUt[],
+      TacsScalar DUx[]);
+
+  /**
+    Evaluate the weak form coefficients and their Jacobian at a set of
+    points
+
+    The arrays are stored in the same structure-of-arrays format as
+    evalWeakIntegrandPoints(). The Jacobian entries are stored as
+    Jac[k*npts + i] for k < Jac_nnz. All points must share the non-zero
+    pattern returned by getWeakMatrixNonzeros(). The default
+    implementation calls evalWeakMatrix() at each point.
+
+    @param matType The element matrix type
+    @param npts The number of points
+    @param elemIndex The local element index for each point
+    @param time The simulation time
+    @param n The quadrature point index for each point
+    @param pt The parametric positions (3 x npts)
+    @param X The physical positions (3 x npts)
+    @param Xd The position derivatives (3*num_params x npts)
+    @param Ut The state variables and time derivs (3*vars_per_node x npts)
+    @param Ux The spatial derivatives (num_params*vars_per_node x npts)
+    @param DUt The time-dependent coefficients (3*vars_per_node x npts)
+    @param DUx The spatial coefficients (num_params*vars_per_node x npts)
+    @param Jac The Jacobian entries (Jac_nnz x npts)
+  */
+  virtual void evalWeakMatrixPoints(
+      ElementMatrixType matType, int npts, const int elemIndex[],
+      const double time, const int n[], const double pt[],
+      const TacsScalar X[], const TacsScalar Xd[], const TacsScalar Ut[],
+      const TacsScalar Ux[], TacsScalar DUt[], TacsScalar DUx[],
+      TacsScalar Jac[]);
+
+  /**
+    Evaluate a point-wise quantity of interest at a set of points
+
+    The arrays are stored in the same structure-of-arrays format as
+    evalWeakIntegrandPoints() and the j-th component of the quantity at
+    the i-th point is stored in quantity[j*npts + i]. The default
+    implementation calls evalPointQuantity() at each point and supports
+    quantities with up to MAX_POINT_QUANTITY_SIZE components.
+
+    @param npts The number of points
+    @param elemIndex The local element index for each point
+    @param quantityType Integer indicating the type of pointwise quantity
+    @param time The simulation time
+    @param n The quadrature point index for each point
+    @param pt The parametric positions (3 x npts)
+    @param X The physical positions (3 x npts)
+    @param Xd The position derivatives (3*num_params x npts)
+    @param Ut The state variables and time derivs (3*vars_per_node x npts)
+    @param Ux The spatial derivatives (num_params*vars_per_node x npts)
+    @param quantity The quantity of interest (count x npts)
+    @return Length of the quantity computed at each point
+  */
+  virtual int evalPointQuantities(int npts, const int elemIndex[],
+                                  const int quantityType, const double time,
+                                  const int n[], const double pt[],
+                                  const TacsScalar X[], const TacsScalar Xd[],
+                                  const TacsScalar Ut[], const TacsScalar Ux[],
+                                  TacsScalar quantity[]);
+
   /**
     Generate a line of output for a single visualization point
 
@@ -452,4 +614,26 @@ class TACSElementModel : public TACSObject {
                              int ld_data, TacsScalar *data) {}
 };
 
+/**
+  Extract the parametric and physical coordinates of the i-th point
+  from the structure-of-arrays format
+
+  @param npts The number of points
+  @param i The index of the point
+  @param pt The parametric positions (3 x npts)
+  @param X The physical positions (3 x npts)
+  @param p The parametric position of the i-th point
+  @param Xp The physical position of the i-th point
+*/
+inline void TacsGetPointCoordinates(int npts, int i, const double pt[],
+                                    const TacsScalar X[], double p[],
+                                    TacsScalar Xp[]) {
+  p[0] = pt[i];
+  p[1] = pt[npts + i];
+  p[2] = pt[2 * npts + i];
+  Xp[0] = X[i];
+  Xp[1] = X[npts + i];
+  Xp[2] = X[2 * npts + i];
+}
+
 #endif  // TACS_ELEMENT_MODEL_H
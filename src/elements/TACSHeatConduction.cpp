@@ -92,6 +92,40 @@ void TACSHeatConduction2D::evalWeakIntegrand(
   DUx[1] = flux[1];
 }
 
+/*
+  Evaluate the weak form coefficients at a set of points
+*/
+void TACSHeatConduction2D::evalWeakIntegrandPoints(
+    int npts, const int elemIndex[], const double time, const int n[],
+    const double pt[], const TacsScalar X[], const TacsScalar Xd[],
+    const TacsScalar Ut[], const TacsScalar Ux[], TacsScalar DUt[],
+    TacsScalar DUx[]) {
+  for (int i = 0; i < npts; i++) {
+    double p[3];
+    TacsScalar Xp[3];
+    TacsGetPointCoordinates(npts, i, pt, X, p, Xp);
+
+    // Evaluate the density and specific heat
+    TacsScalar rho = stiff->evalDensity(elemIndex[i], p, Xp);
+    TacsScalar c = stiff->evalSpecificHeat(elemIndex[i], p, Xp);
+
+    DUt[i] = 0.0;
+    DUt[npts + i] = c * rho * Ut[npts + i];
+    DUt[2 * npts + i] = 0.0;
+
+    // Compute the thermal flux from the thermal gradient
+    TacsScalar grad[2], flux[2];
+    for (int j = 0; j < 2; j++) {
+      grad[j] = Ux[j * npts + i];
+    }
+
+    stiff->evalHeatFlux(elemIndex[i], p, Xp, grad, flux);
+    for (int j = 0; j < 2; j++) {
+      DUx[j * npts + i] = flux[j];
+    }
+  }
+}
+
 void TACSHeatConduction2D::getWeakMatrixNonzeros(ElementMatrixType matType,
                                                  int elemIndex, int *Jac_nnz,
                                                  const int *Jac_pairs[]) {
@@ -141,6 +175,60 @@ void TACSHeatConduction2D::evalWeakMatrix(
   }
 }
 
+/*
+  The entries of the tangent heat flux that appear in the Jacobian
+*/
+static const int TACSHeatConduction2DJacIndex[] = {0, 1, 1, 2};
+
+/*
+  Evaluate the weak form coefficients and the Jacobian at a set of points
+*/
+void TACSHeatConduction2D::evalWeakMatrixPoints(
+    ElementMatrixType matType, int npts, const int elemIndex[],
+    const double time, const int n[], const double pt[], const TacsScalar X[],
+    const TacsScalar Xd[], const TacsScalar Ut[], const TacsScalar Ux[],
+    TacsScalar DUt[], TacsScalar DUx[], TacsScalar Jac[]) {
+  if (matType != TACS_JACOBIAN_MATRIX) {
+    TACSElementModel::evalWeakMatrixPoints(matType, npts, elemIndex, time, n,
+                                           pt, X, Xd, Ut, Ux, DUt, DUx, Jac);
+    return;
+  }
+
+  for (int i = 0; i < npts; i++) {
+    double p[3];
+    TacsScalar Xp[3];
+    TacsGetPointCoordinates(npts, i, pt, X, p, Xp);
+
+    // Evaluate the density and specific heat
+    TacsScalar rho = stiff->evalDensity(elemIndex[i], p, Xp);
+    TacsScalar c = stiff->evalSpecificHeat(elemIndex[i], p, Xp);
+
+    DUt[i] = 0.0;
+    DUt[npts + i] = c * rho * Ut[npts + i];
+    DUt[2 * npts + i] = 0.0;
+
+    // Compute the thermal flux from the thermal gradient
+    TacsScalar grad[2], flux[2];
+    for (int j = 0; j < 2; j++) {
+      grad[j] = Ux[j * npts + i];
+    }
+
+    stiff->evalHeatFlux(elemIndex[i], p, Xp, grad, flux);
+    for (int j = 0; j < 2; j++) {
+      DUx[j * npts + i] = flux[j];
+    }
+
+    // Set the time-dependent terms
+    Jac[i] = c * rho;
+
+    TacsScalar Kc[3];
+    stiff->evalTangentHeatFlux(elemIndex[i], p, Xp, Kc);
+    for (int j = 0; j < 4; j++) {
+      Jac[(j + 1) * npts + i] = Kc[TACSHeatConduction2DJacIndex[j]];
+    }
+  }
+}
+
 /*
   Add the product of the adjoint vector times the weak form of the adjoint
   equations to the design variable components
@@ -422,6 +510,40 @@ void TACSHeatConduction3D::evalWeakIntegrand(
   DUx[2] = flux[2];
 }
 
+/*
+  Evaluate the weak form coefficients at a set of points
+*/
+void TACSHeatConduction3D::evalWeakIntegrandPoints(
+    int npts, const int elemIndex[], const double time, const int n[],
+    const double pt[], const TacsScalar X[], const TacsScalar Xd[],
+    const TacsScalar Ut[], const TacsScalar Ux[], TacsScalar DUt[],
+    TacsScalar DUx[]) {
+  for (int i = 0; i < npts; i++) {
+    double p[3];
+    TacsScalar Xp[3];
+    TacsGetPointCoordinates(npts, i, pt, X, p, Xp);
+
+    // Evaluate the density and specific heat
+    TacsScalar rho = stiff->evalDensity(elemIndex[i], p, Xp);
+    TacsScalar c = stiff->evalSpecificHeat(elemIndex[i], p, Xp);
+
+    DUt[i] = 0.0;
+    DUt[npts + i] = c * rho * Ut[npts + i];
+    DUt[2 * npts + i] = 0.0;
+
+    // Compute the thermal flux from the thermal gradient
+    TacsScalar grad[3], flux[3];
+    for (int j = 0; j < 3; j++) {
+      grad[j] = Ux[j * npts + i];
+    }
+
+    stiff->evalHeatFlux(elemIndex[i], p, Xp, grad, flux);
+    for (int j = 0; j < 3; j++) {
+      DUx[j * npts + i] = flux[j];
+    }
+  }
+}
+
 void TACSHeatConduction3D::getWeakMatrixNonzeros(ElementMatrixType matType,
                                                  int elemIndex, int *Jac_nnz,
                                                  const int *Jac_pairs[]) {
@@ -482,6 +604,60 @@ void TACSHeatConduction3D::evalWeakMatrix(
   }
 }
 
+/*
+  The entries of the tangent heat flux that appear in the Jacobian
+*/
+static const int TACSHeatConduction3DJacIndex[] = {0, 1, 2, 1, 3, 4, 2, 4, 5};
+
+/*
+  Evaluate the weak form coefficients and the Jacobian at a set of points
+*/
+void TACSHeatConduction3D::evalWeakMatrixPoints(
+    ElementMatrixType matType, int npts, const int elemIndex[],
+    const double time, const int n[], const double pt[], const TacsScalar X[],
+    const TacsScalar Xd[], const TacsScalar Ut[], const TacsScalar Ux[],
+    TacsScalar DUt[], TacsScalar DUx[], TacsScalar Jac[]) {
+  if (matType != TACS_JACOBIAN_MATRIX) {
+    TACSElementModel::evalWeakMatrixPoints(matType, npts, elemIndex, time, n,
+                                           pt, X, Xd, Ut, Ux, DUt, DUx, Jac);
+    return;
+  }
+
+  for (int i = 0; i < npts; i++) {
+    double p[3];
+    TacsScalar Xp[3];
+    TacsGetPointCoordinates(npts, i, pt, X, p, Xp);
+
+    // Evaluate the density and specific heat
+    TacsScalar rho = stiff->evalDensity(elemIndex[i], p, Xp);
+    TacsScalar c = stiff->evalSpecificHeat(elemIndex[i], p, Xp);
+
+    DUt[i] = 0.0;
+    DUt[npts + i] = c * rho * Ut[npts + i];
+    DUt[2 * npts + i] = 0.0;
+
+    // Compute the thermal flux from the thermal gradient
+    TacsScalar grad[3], flux[3];
+    for (int j = 0; j < 3; j++) {
+      grad[j] = Ux[j * npts + i];
+    }
+
+    stiff->evalHeatFlux(elemIndex[i], p, Xp, grad, flux);
+    for (int j = 0; j < 3; j++) {
+      DUx[j * npts + i] = flux[j];
+    }
+
+    // Set the time-dependent terms
+    Jac[i] = c * rho;
+
+    TacsScalar Kc[6];
+    stiff->evalTangentHeatFlux(elemIndex[i], p, Xp, Kc);
+    for (int j = 0; j < 9; j++) {
+      Jac[(j + 1) * npts + i] = Kc[TACSHeatConduction3DJacIndex[j]];
+    }
+  }
+}
+
 /*
   Add the product of the adjoint vector times the weak form of the adjoint
   equations to the design variable components
@@ -63,6 +63,16 @@ class TACSHeatConduction2D : public TACSElementModel {
                          const TacsScalar Ux[], TacsScalar DUt[],
                          TacsScalar DUx[]);
 
+  /**
+    Evaluate the weak form coefficients at a set of points
+  */
+  void evalWeakIntegrandPoints(int npts, const int elemIndex[],
+                               const double time, const int n[],
+                               const double pt[], const TacsScalar X[],
+                               const TacsScalar Xd[], const TacsScalar Ut[],
+                               const TacsScalar Ux[], TacsScalar DUt[],
+                               TacsScalar DUx[]);
+
   /**
      Add the derivative of the product of the adjoint and residual to
      the design vector
@@ -100,6 +110,17 @@ class TACSHeatConduction2D : public TACSElementModel {
                       const TacsScalar Ut[], const TacsScalar Ux[],
                       TacsScalar DUt[], TacsScalar DUx[], TacsScalar Jac[]);
 
+  /**
+    Evaluate the weak form coefficients and Jacobian at a set of points
+  */
+  void evalWeakMatrixPoints(ElementMatrixType matType, int npts,
+                            const int elemIndex[], const double time,
+                            const int n[], const double pt[],
+                            const TacsScalar X[], const TacsScalar Xd[],
+                            const TacsScalar Ut[], const TacsScalar Ux[],
+                            TacsScalar DUt[], TacsScalar DUx[],
+                            TacsScalar Jac[]);
+
   /**
      Evaluate a point-wise quantity of interest at a quadrature point
   */
@@ -190,6 +211,16 @@ class TACSHeatConduction3D : public TACSElementModel {
                          const TacsScalar Ux[], TacsScalar DUt[],
                          TacsScalar DUx[]);
 
+  /**
+    Evaluate the weak form coefficients at a set of points
+  */
+  void evalWeakIntegrandPoints(int npts, const int elemIndex[],
+                               const double time, const int n[],
+                               const double pt[], const TacsScalar X[],
+                               const TacsScalar Xd[], const TacsScalar Ut[],
+                               const TacsScalar Ux[], TacsScalar DUt[],
+                               TacsScalar DUx[]);
+
   /**
     Add the derivative of the product of the adjoint and residual to
     the design vector
@@ -227,6 +258,17 @@ class TACSHeatConduction3D : public TACSElementModel {
                       const TacsScalar Ut[], const TacsScalar Ux[],
                       TacsScalar DUt[], TacsScalar DUx[], TacsScalar Jac[]);
 
+  /**
+    Evaluate the weak form coefficients and Jacobian at a set of points
+  */
+  void evalWeakMatrixPoints(ElementMatrixType matType, int npts,
+                            const int elemIndex[], const double time,
+                            const int n[], const double pt[],
+                            const TacsScalar X[], const TacsScalar Xd[],
+                            const TacsScalar Ut[], const TacsScalar Ux[],
+                            TacsScalar DUt[], TacsScalar DUx[],
+                            TacsScalar Jac[]);
+
   /**
     Evaluate a point-wise quantity of interest at a quadrature point
   */
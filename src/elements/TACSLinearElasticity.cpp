@@ -120,6 +120,78 @@ void TACSLinearElasticity2D::evalWeakIntegrand(
   }
 }
 
+/*
+  Evaluate the weak form coefficients at a block of points. The
+  kinematics and the coefficients are computed across the points,
+  while the constitutive object is still evaluated point by point.
+*/
+void TACSLinearElasticity2D::evalWeakIntegrandPoints(
+    int npts, const int elemIndex[], const double time, const int n[],
+    const double pt[], const TacsScalar X[], const TacsScalar Xd[],
+    const TacsScalar Ut[], const TacsScalar Ux[], TacsScalar DUt[],
+    TacsScalar DUx[]) {
+  const int bs = POINT_BLOCK_SIZE;
+
+  for (int start = 0; start < npts; start += bs) {
+    const int size = (npts - start < bs ? npts - start : bs);
+
+    TacsScalar e[3 * bs], s[3 * bs], rho[bs];
+    TacsEvalStrainPoints2D(strain_type, size, npts, &Ux[start], e);
+
+    for (int k = 0; k < size; k++) {
+      double p[3];
+      TacsScalar Xp[3];
+      TacsGetPointCoordinates(npts, start + k, pt, X, p, Xp);
+      rho[k] = stiff->evalDensity(elemIndex[start + k], p, Xp);
+
+      TacsScalar ep[3], sp[3];
+      ep[0] = e[k];
+      ep[1] = e[bs + k];
+      ep[2] = e[2 * bs + k];
+      stiff->evalStress(elemIndex[start + k], p, Xp, ep, sp);
+      s[k] = sp[0];
+      s[bs + k] = sp[1];
+      s[2 * bs + k] = sp[2];
+    }
+
+    for (int j = 0; j < 6; j++) {
+      TacsScalar *dut = &DUt[j * npts + start];
+      if (j % 3 == 2) {
+        const TacsScalar *ut = &Ut[j * npts + start];
+        for (int k = 0; k < size; k++) {
+          dut[k] = rho[k] * ut[k];
+        }
+      } else {
+        for (int k = 0; k < size; k++) {
+          dut[k] = 0.0;
+        }
+      }
+    }
+
+    const TacsScalar *ux = &Ux[start], *uy = &Ux[npts + start];
+    const TacsScalar *vx = &Ux[2 * npts + start], *vy = &Ux[3 * npts + start];
+    TacsScalar *dux = &DUx[start], *duy = &DUx[npts + start];
+    TacsScalar *dvx = &DUx[2 * npts + start], *dvy = &DUx[3 * npts + start];
+    const TacsScalar *s0 = &s[0], *s1 = &s[bs], *s2 = &s[2 * bs];
+
+    if (strain_type == TACS_LINEAR_STRAIN) {
+      for (int k = 0; k < size; k++) {
+        dux[k] = s0[k];
+        duy[k] = s2[k];
+        dvx[k] = s2[k];
+        dvy[k] = s1[k];
+      }
+    } else {
+      for (int k = 0; k < size; k++) {
+        dux[k] = uy[k] * s2[k] + s0[k] * (ux[k] + 1.0);
+        duy[k] = uy[k] * s1[k] + s2[k] * (ux[k] + 1.0);
+        dvx[k] = vx[k] * s0[k] + s2[k] * (vy[k] + 1.0);
+        dvy[k] = vx[k] * s2[k] + s1[k] * (vy[k] + 1.0);
+      }
+    }
+  }
+}
+
 /*
   Add the design variable derivative of the product of the adjoint
   vector with the weak form of the residual
@@ -229,6 +301,107 @@ void TACSLinearElasticity2D::evalWeakAdjXptSensProduct(
   }
 }
 
+/*
+  Evaluate the derivative of the weak form coefficients along the design
+  direction. The derivatives of the density and of the stress at the
+  current strain are found directly from the constitutive object.
+*/
+void TACSLinearElasticity2D::evalWeakDVSensVecProduct(
+    int elemIndex, const double time, int n, const double pt[],
+    const TacsScalar X[], const TacsScalar Xd[], const TacsScalar Ut[],
+    const TacsScalar Ux[], int dvLen, const TacsScalar pdx[],
+    TacsScalar work[], TacsScalar pDUt[], TacsScalar pDUx[]) {
+  // Evaluate the derivative of the density
+  TacsScalar prho =
+      stiff->evalDensityDVSensVecProduct(elemIndex, pt, X, dvLen, pdx, work);
+
+  pDUt[0] = 0.0;
+  pDUt[1] = 0.0;
+  pDUt[2] = prho * Ut[2];
+
+  pDUt[3] = 0.0;
+  pDUt[4] = 0.0;
+  pDUt[5] = prho * Ut[5];
+
+  TacsScalar e[3], ps[3];
+  if (strain_type == TACS_LINEAR_STRAIN) {
+    e[0] = Ux[0];
+    e[1] = Ux[3];
+    e[2] = Ux[1] + Ux[2];
+
+    stiff->evalStressDVSensVecProduct(elemIndex, pt, X, e, dvLen, pdx, work,
+                                      ps);
+
+    pDUx[0] = ps[0];
+    pDUx[1] = ps[2];
+
+    pDUx[2] = ps[2];
+    pDUx[3] = ps[1];
+  } else {
+    e[0] = Ux[0] + 0.5 * (Ux[0] * Ux[0] + Ux[2] * Ux[2]);
+    e[1] = Ux[3] + 0.5 * (Ux[1] * Ux[1] + Ux[3] * Ux[3]);
+    e[2] = Ux[1] + Ux[2] + (Ux[0] * Ux[1] + Ux[2] * Ux[3]);
+
+    stiff->evalStressDVSensVecProduct(elemIndex, pt, X, e, dvLen, pdx, work,
+                                      ps);
+
+    pDUx[0] = Ux[1] * ps[2] + ps[0] * (Ux[0] + 1.0);
+    pDUx[1] = Ux[1] * ps[1] + ps[2] * (Ux[0] + 1.0);
+    pDUx[2] = Ux[2] * ps[0] + ps[2] * (Ux[3] + 1.0);
+    pDUx[3] = Ux[2] * ps[2] + ps[1] * (Ux[3] + 1.0);
+  }
+}
+
+/*
+  Evaluate the derivative of the weak form coefficients along a
+  perturbation of the geometry. The coefficients depend on the
+  geometry only through the spatial derivatives Ux, and the stress is
+  linear in the strain.
+*/
+void TACSLinearElasticity2D::evalWeakXptSensVecProduct(
+    int elemIndex, const double time, int n, const double pt[],
+    const TacsScalar X[], const TacsScalar Xd[], const TacsScalar Ut[],
+    const TacsScalar Ux[], const TacsScalar pX[], const TacsScalar pXd[],
+    const TacsScalar pUx[], TacsScalar pDUt[], TacsScalar pDUx[]) {
+  memset(pDUt, 0, 6 * sizeof(TacsScalar));
+
+  TacsScalar pe[3], ps[3];
+  if (strain_type == TACS_LINEAR_STRAIN) {
+    pe[0] = pUx[0];
+    pe[1] = pUx[3];
+    pe[2] = pUx[1] + pUx[2];
+    stiff->evalStress(elemIndex, pt, X, pe, ps);
+
+    pDUx[0] = ps[0];
+    pDUx[1] = ps[2];
+
+    pDUx[2] = ps[2];
+    pDUx[3] = ps[1];
+  } else {
+    TacsScalar e[3], s[3];
+    e[0] = Ux[0] + 0.5 * (Ux[0] * Ux[0] + Ux[2] * Ux[2]);
+    e[1] = Ux[3] + 0.5 * (Ux[1] * Ux[1] + Ux[3] * Ux[3]);
+    e[2] = Ux[1] + Ux[2] + (Ux[0] * Ux[1] + Ux[2] * Ux[3]);
+    stiff->evalStress(elemIndex, pt, X, e, s);
+
+    pe[0] = pUx[0] * (Ux[0] + 1.0) + pUx[2] * Ux[2];
+    pe[1] = pUx[1] * Ux[1] + pUx[3] * (Ux[3] + 1.0);
+    pe[2] = pUx[0] * Ux[1] + pUx[1] * (Ux[0] + 1.0) + pUx[2] * (Ux[3] + 1.0) +
+            pUx[3] * Ux[2];
+    stiff->evalStress(elemIndex, pt, X, pe, ps);
+
+    // Perturb the coefficients (I + Ux)*S
+    pDUx[0] = pUx[1] * s[2] + pUx[0] * s[0] + Ux[1] * ps[2] +
+              ps[0] * (Ux[0] + 1.0);
+    pDUx[1] = pUx[1] * s[1] + pUx[0] * s[2] + Ux[1] * ps[1] +
+              ps[2] * (Ux[0] + 1.0);
+    pDUx[2] = pUx[2] * s[0] + pUx[3] * s[2] + Ux[2] * ps[0] +
+              ps[2] * (Ux[3] + 1.0);
+    pDUx[3] = pUx[2] * s[2] + pUx[3] * s[1] + Ux[2] * ps[2] +
+              ps[1] * (Ux[3] + 1.0);
+  }
+}
+
 void TACSLinearElasticity2D::getWeakMatrixNonzeros(ElementMatrixType matType,
                                                    int elemIndex, int *Jac_nnz,
                                                    const int *Jac_pairs[]) {
@@ -445,6 +618,51 @@ void TACSLinearElasticity2D::evalWeakMatrix(
   }
 }
 
+/*
+  The entries of the tangent stiffness that appear in the Jacobian for
+  the linear strain expressions, following the order in evalWeakMatrix
+*/
+static const int TACSLinearElasticity2DLinearJacIndex[] = {
+    0, 2, 2, 1, 2, 5, 5, 4, 2, 5, 5, 4, 1, 4, 4, 3};
+
+/*
+  Evaluate the weak form coefficients and the Jacobian at a block of
+  points. Only the Jacobian with the linear strain expressions has a
+  specialized implementation.
+*/
+void TACSLinearElasticity2D::evalWeakMatrixPoints(
+    ElementMatrixType matType, int npts, const int elemIndex[],
+    const double time, const int n[], const double pt[], const TacsScalar X[],
+    const TacsScalar Xd[], const TacsScalar Ut[], const TacsScalar Ux[],
+    TacsScalar DUt[], TacsScalar DUx[], TacsScalar Jac[]) {
+  if (matType != TACS_JACOBIAN_MATRIX || strain_type != TACS_LINEAR_STRAIN) {
+    TACSElementModel::evalWeakMatrixPoints(matType, npts, elemIndex, time, n,
+                                           pt, X, Xd, Ut, Ux, DUt, DUx, Jac);
+    return;
+  }
+
+  // Evaluate the weak form coefficients
+  evalWeakIntegrandPoints(npts, elemIndex, time, n, pt, X, Xd, Ut, Ux, DUt,
+                          DUx);
+
+  for (int i = 0; i < npts; i++) {
+    double p[3];
+    TacsScalar Xp[3];
+    TacsGetPointCoordinates(npts, i, pt, X, p, Xp);
+
+    // Set the acceleration terms
+    TacsScalar rho = stiff->evalDensity(elemIndex[i], p, Xp);
+    Jac[i] = rho;
+    Jac[npts + i] = rho;
+
+    TacsScalar C[6];
+    stiff->evalTangentStiffness(elemIndex[i], p, Xp, C);
+    for (int j = 0; j < 16; j++) {
+      Jac[(j + 2) * npts + i] = C[TACSLinearElasticity2DLinearJacIndex[j]];
+    }
+  }
+}
+
 void TACSLinearElasticity2D::addWeakMatDVSens(
     ElementMatrixType matType, int elemIndex, const double time,
     TacsScalar scale, int n, const double pt[], const TacsScalar X[],
@@ -602,6 +820,43 @@ int TACSLinearElasticity2D::evalPointQuantity(
   return 0;
 }
 
+/*
+  Evaluate the quantity of interest at a block of points. The failure
+  index is evaluated with the strain computed across the points.
+*/
+int TACSLinearElasticity2D::evalPointQuantities(
+    int npts, const int elemIndex[], const int quantityType, const double time,
+    const int n[], const double pt[], const TacsScalar X[],
+    const TacsScalar Xd[], const TacsScalar Ut[], const TacsScalar Ux[],
+    TacsScalar quantity[]) {
+  if (quantityType != TACS_FAILURE_INDEX) {
+    return TACSElementModel::evalPointQuantities(
+        npts, elemIndex, quantityType, time, n, pt, X, Xd, Ut, Ux, quantity);
+  }
+
+  const int bs = POINT_BLOCK_SIZE;
+  for (int start = 0; start < npts; start += bs) {
+    const int size = (npts - start < bs ? npts - start : bs);
+
+    TacsScalar e[3 * bs];
+    TacsEvalStrainPoints2D(strain_type, size, npts, &Ux[start], e);
+
+    for (int k = 0; k < size; k++) {
+      double p[3];
+      TacsScalar Xp[3];
+      TacsGetPointCoordinates(npts, start + k, pt, X, p, Xp);
+
+      TacsScalar ep[3];
+      ep[0] = e[k];
+      ep[1] = e[bs + k];
+      ep[2] = e[2 * bs + k];
+      quantity[start + k] = stiff->evalFailure(elemIndex[start + k], p, Xp, ep);
+    }
+  }
+
+  return 1;
+}
+
 /*
   Add the derivative of the point-wise quantity of interest w.r.t.
   design variables to the design vector
@@ -946,6 +1201,99 @@ void TACSLinearElasticity3D::evalWeakIntegrand(
   }
 }
 
+/*
+  Evaluate the weak form coefficients at a block of points. The
+  kinematics and the coefficients are computed across the points,
+  while the constitutive object is still evaluated point by point.
+*/
+void TACSLinearElasticity3D::evalWeakIntegrandPoints(
+    int npts, const int elemIndex[], const double time, const int n[],
+    const double pt[], const TacsScalar X[], const TacsScalar Xd[],
+    const TacsScalar Ut[], const TacsScalar Ux[], TacsScalar DUt[],
+    TacsScalar DUx[]) {
+  const int bs = POINT_BLOCK_SIZE;
+
+  for (int start = 0; start < npts; start += bs) {
+    const int size = (npts - start < bs ? npts - start : bs);
+
+    TacsScalar e[6 * bs], s[6 * bs], rho[bs];
+    TacsEvalStrainPoints3D(strain_type, size, npts, &Ux[start], e);
+
+    for (int k = 0; k < size; k++) {
+      double p[3];
+      TacsScalar Xp[3];
+      TacsGetPointCoordinates(npts, start + k, pt, X, p, Xp);
+      rho[k] = stiff->evalDensity(elemIndex[start + k], p, Xp);
+
+      TacsScalar ep[6], sp[6];
+      for (int j = 0; j < 6; j++) {
+        ep[j] = e[j * bs + k];
+      }
+      stiff->evalStress(elemIndex[start + k], p, Xp, ep, sp);
+      for (int j = 0; j < 6; j++) {
+        s[j * bs + k] = sp[j];
+      }
+    }
+
+    for (int j = 0; j < 9; j++) {
+      TacsScalar *dut = &DUt[j * npts + start];
+      if (j % 3 == 2) {
+        const TacsScalar *ut = &Ut[j * npts + start];
+        for (int k = 0; k < size; k++) {
+          dut[k] = rho[k] * ut[k];
+        }
+      } else {
+        for (int k = 0; k < size; k++) {
+          dut[k] = 0.0;
+        }
+      }
+    }
+
+    const TacsScalar *s0 = &s[0], *s1 = &s[bs], *s2 = &s[2 * bs];
+    const TacsScalar *s3 = &s[3 * bs], *s4 = &s[4 * bs], *s5 = &s[5 * bs];
+    TacsScalar *d[9];
+    for (int j = 0; j < 9; j++) {
+      d[j] = &DUx[j * npts + start];
+    }
+
+    if (strain_type == TACS_LINEAR_STRAIN) {
+      for (int k = 0; k < size; k++) {
+        d[0][k] = s0[k];
+        d[1][k] = s5[k];
+        d[2][k] = s4[k];
+
+        d[3][k] = s5[k];
+        d[4][k] = s1[k];
+        d[5][k] = s3[k];
+
+        d[6][k] = s4[k];
+        d[7][k] = s3[k];
+        d[8][k] = s2[k];
+      }
+    } else {
+      const TacsScalar *u[9];
+      for (int j = 0; j < 9; j++) {
+        u[j] = &Ux[j * npts + start];
+      }
+
+      // Coef = (I + Ux)*S
+      for (int k = 0; k < size; k++) {
+        d[0][k] = u[1][k] * s5[k] + u[2][k] * s4[k] + s0[k] * (u[0][k] + 1.0);
+        d[1][k] = u[1][k] * s1[k] + u[2][k] * s3[k] + s5[k] * (u[0][k] + 1.0);
+        d[2][k] = u[1][k] * s3[k] + u[2][k] * s2[k] + s4[k] * (u[0][k] + 1.0);
+
+        d[3][k] = u[3][k] * s0[k] + u[5][k] * s4[k] + s5[k] * (u[4][k] + 1.0);
+        d[4][k] = u[3][k] * s5[k] + u[5][k] * s3[k] + s1[k] * (u[4][k] + 1.0);
+        d[5][k] = u[3][k] * s4[k] + u[5][k] * s2[k] + s3[k] * (u[4][k] + 1.0);
+
+        d[6][k] = u[6][k] * s0[k] + u[7][k] * s5[k] + s4[k] * (u[8][k] + 1.0);
+        d[7][k] = u[6][k] * s5[k] + u[7][k] * s1[k] + s3[k] * (u[8][k] + 1.0);
+        d[8][k] = u[6][k] * s4[k] + u[7][k] * s3[k] + s2[k] * (u[8][k] + 1.0);
+      }
+    }
+  }
+}
+
 /*
   Add the product of the adjoint vector times the weak form of the adjoint
   equations to the design variable components
@@ -1134,6 +1482,163 @@ void TACSLinearElasticity3D::evalWeakAdjXptSensProduct(
   }
 }
 
+/*
+  Evaluate the derivative of the weak form coefficients along the design
+  direction. The derivatives of the density and of the stress at the
+  current strain are found directly from the constitutive object.
+*/
+void TACSLinearElasticity3D::evalWeakDVSensVecProduct(
+    int elemIndex, const double time, int n, const double pt[],
+    const TacsScalar X[], const TacsScalar Xd[], const TacsScalar Ut[],
+    const TacsScalar Ux[], int dvLen, const TacsScalar pdx[],
+    TacsScalar work[], TacsScalar pDUt[], TacsScalar pDUx[]) {
+  // Evaluate the derivative of the density
+  TacsScalar prho =
+      stiff->evalDensityDVSensVecProduct(elemIndex, pt, X, dvLen, pdx, work);
+
+  pDUt[0] = 0.0;
+  pDUt[1] = 0.0;
+  pDUt[2] = prho * Ut[2];
+
+  pDUt[3] = 0.0;
+  pDUt[4] = 0.0;
+  pDUt[5] = prho * Ut[5];
+
+  pDUt[6] = 0.0;
+  pDUt[7] = 0.0;
+  pDUt[8] = prho * Ut[8];
+
+  TacsScalar e[6], ps[6];
+  if (strain_type == TACS_LINEAR_STRAIN) {
+    e[0] = Ux[0];
+    e[1] = Ux[4];
+    e[2] = Ux[8];
+
+    e[3] = Ux[5] + Ux[7];
+    e[4] = Ux[2] + Ux[6];
+    e[5] = Ux[1] + Ux[3];
+
+    stiff->evalStressDVSensVecProduct(elemIndex, pt, X, e, dvLen, pdx, work,
+                                      ps);
+
+    pDUx[0] = ps[0];
+    pDUx[1] = ps[5];
+    pDUx[2] = ps[4];
+
+    pDUx[3] = ps[5];
+    pDUx[4] = ps[1];
+    pDUx[5] = ps[3];
+
+    pDUx[6] = ps[4];
+    pDUx[7] = ps[3];
+    pDUx[8] = ps[2];
+  } else {
+    e[0] = Ux[0] + 0.5 * (Ux[0] * Ux[0] + Ux[3] * Ux[3] + Ux[6] * Ux[6]);
+    e[1] = Ux[4] + 0.5 * (Ux[1] * Ux[1] + Ux[4] * Ux[4] + Ux[7] * Ux[7]);
+    e[2] = Ux[8] + 0.5 * (Ux[2] * Ux[2] + Ux[5] * Ux[5] + Ux[8] * Ux[8]);
+
+    e[3] = Ux[5] + Ux[7] + (Ux[1] * Ux[2] + Ux[4] * Ux[5] + Ux[7] * Ux[8]);
+    e[4] = Ux[2] + Ux[6] + (Ux[0] * Ux[2] + Ux[3] * Ux[5] + Ux[6] * Ux[8]);
+    e[5] = Ux[1] + Ux[3] + (Ux[0] * Ux[1] + Ux[3] * Ux[4] + Ux[6] * Ux[7]);
+
+    stiff->evalStressDVSensVecProduct(elemIndex, pt, X, e, dvLen, pdx, work,
+                                      ps);
+
+    pDUx[0] = Ux[1] * ps[5] + Ux[2] * ps[4] + ps[0] * (Ux[0] + 1.0);
+    pDUx[1] = Ux[1] * ps[1] + Ux[2] * ps[3] + ps[5] * (Ux[0] + 1.0);
+    pDUx[2] = Ux[1] * ps[3] + Ux[2] * ps[2] + ps[4] * (Ux[0] + 1.0);
+
+    pDUx[3] = Ux[3] * ps[0] + Ux[5] * ps[4] + ps[5] * (Ux[4] + 1.0);
+    pDUx[4] = Ux[3] * ps[5] + Ux[5] * ps[3] + ps[1] * (Ux[4] + 1.0);
+    pDUx[5] = Ux[3] * ps[4] + Ux[5] * ps[2] + ps[3] * (Ux[4] + 1.0);
+
+    pDUx[6] = Ux[6] * ps[0] + Ux[7] * ps[5] + ps[4] * (Ux[8] + 1.0);
+    pDUx[7] = Ux[6] * ps[5] + Ux[7] * ps[1] + ps[3] * (Ux[8] + 1.0);
+    pDUx[8] = Ux[6] * ps[4] + Ux[7] * ps[3] + ps[2] * (Ux[8] + 1.0);
+  }
+}
+
+/*
+  Evaluate the derivative of the weak form coefficients along a
+  perturbation of the geometry. The coefficients depend on the
+  geometry only through the spatial derivatives Ux, and the stress is
+  linear in the strain.
+*/
+void TACSLinearElasticity3D::evalWeakXptSensVecProduct(
+    int elemIndex, const double time, int n, const double pt[],
+    const TacsScalar X[], const TacsScalar Xd[], const TacsScalar Ut[],
+    const TacsScalar Ux[], const TacsScalar pX[], const TacsScalar pXd[],
+    const TacsScalar pUx[], TacsScalar pDUt[], TacsScalar pDUx[]) {
+  memset(pDUt, 0, 9 * sizeof(TacsScalar));
+
+  TacsScalar pe[6], ps[6];
+  if (strain_type == TACS_LINEAR_STRAIN) {
+    pe[0] = pUx[0];
+    pe[1] = pUx[4];
+    pe[2] = pUx[8];
+
+    pe[3] = pUx[5] + pUx[7];
+    pe[4] = pUx[2] + pUx[6];
+    pe[5] = pUx[1] + pUx[3];
+    stiff->evalStress(elemIndex, pt, X, pe, ps);
+
+    pDUx[0] = ps[0];
+    pDUx[1] = ps[5];
+    pDUx[2] = ps[4];
+
+    pDUx[3] = ps[5];
+    pDUx[4] = ps[1];
+    pDUx[5] = ps[3];
+
+    pDUx[6] = ps[4];
+    pDUx[7] = ps[3];
+    pDUx[8] = ps[2];
+  } else {
+    TacsScalar e[6], s[6];
+    e[0] = Ux[0] + 0.5 * (Ux[0] * Ux[0] + Ux[3] * Ux[3] + Ux[6] * Ux[6]);
+    e[1] = Ux[4] + 0.5 * (Ux[1] * Ux[1] + Ux[4] * Ux[4] + Ux[7] * Ux[7]);
+    e[2] = Ux[8] + 0.5 * (Ux[2] * Ux[2] + Ux[5] * Ux[5] + Ux[8] * Ux[8]);
+
+    e[3] = Ux[5] + Ux[7] + (Ux[1] * Ux[2] + Ux[4] * Ux[5] + Ux[7] * Ux[8]);
+    e[4] = Ux[2] + Ux[6] + (Ux[0] * Ux[2] + Ux[3] * Ux[5] + Ux[6] * Ux[8]);
+    e[5] = Ux[1] + Ux[3] + (Ux[0] * Ux[1] + Ux[3] * Ux[4] + Ux[6] * Ux[7]);
+    stiff->evalStress(elemIndex, pt, X, e, s);
+
+    pe[0] = pUx[0] * (Ux[0] + 1.0) + pUx[3] * Ux[3] + pUx[6] * Ux[6];
+    pe[1] = pUx[1] * Ux[1] + pUx[4] * (Ux[4] + 1.0) + pUx[7] * Ux[7];
+    pe[2] = pUx[2] * Ux[2] + pUx[5] * Ux[5] + pUx[8] * (Ux[8] + 1.0);
+
+    pe[3] = pUx[1] * Ux[2] + pUx[2] * Ux[1] + pUx[4] * Ux[5] +
+            pUx[5] * (Ux[4] + 1.0) + pUx[7] * (Ux[8] + 1.0) + pUx[8] * Ux[7];
+    pe[4] = pUx[0] * Ux[2] + pUx[2] * (Ux[0] + 1.0) + pUx[3] * Ux[5] +
+            pUx[5] * Ux[3] + pUx[6] * (Ux[8] + 1.0) + pUx[8] * Ux[6];
+    pe[5] = pUx[0] * Ux[1] + pUx[1] * (Ux[0] + 1.0) + pUx[3] * (Ux[4] + 1.0) +
+            pUx[4] * Ux[3] + pUx[6] * Ux[7] + pUx[7] * Ux[6];
+    stiff->evalStress(elemIndex, pt, X, pe, ps);
+
+    // Perturb the coefficients (I + Ux)*S, where S is the symmetric
+    // stress matrix
+    TacsScalar S[9], pS[9];
+    S[0] = s[0], S[1] = s[5], S[2] = s[4];
+    S[3] = s[5], S[4] = s[1], S[5] = s[3];
+    S[6] = s[4], S[7] = s[3], S[8] = s[2];
+    pS[0] = ps[0], pS[1] = ps[5], pS[2] = ps[4];
+    pS[3] = ps[5], pS[4] = ps[1], pS[5] = ps[3];
+    pS[6] = ps[4], pS[7] = ps[3], pS[8] = ps[2];
+
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        TacsScalar value = pS[3 * i + j];
+        for (int k = 0; k < 3; k++) {
+          value +=
+              pUx[3 * i + k] * S[3 * k + j] + Ux[3 * i + k] * pS[3 * k + j];
+        }
+        pDUx[3 * i + j] = value;
+      }
+    }
+  }
+}
+
 void TACSLinearElasticity3D::getWeakMatrixNonzeros(ElementMatrixType matType,
                                                    int elemIndex, int *Jac_nnz,
                                                    const int *Jac_pairs[]) {
@@ -1821,6 +2326,56 @@ void TACSLinearElasticity3D::evalWeakMatrix(
   }
 }
 
+/*
+  The entries of the tangent stiffness that appear in the Jacobian for
+  the linear strain expressions, following the order in evalWeakMatrix
+*/
+static const int TACSLinearElasticity3DLinearJacIndex[] = {
+    0,  5,  4,  5,  1,  3,  4,  3,  2,  5,  20, 19, 20, 10, 17, 19, 17,
+    14, 4,  19, 18, 19, 9,  16, 18, 16, 13, 5,  20, 19, 20, 10, 17, 19,
+    17, 14, 1,  10, 9,  10, 6,  8,  9,  8,  7,  3,  17, 16, 17, 8,  15,
+    16, 15, 12, 4,  19, 18, 19, 9,  16, 18, 16, 13, 3,  17, 16, 17, 8,
+    15, 16, 15, 12, 2,  14, 13, 14, 7,  12, 13, 12, 11};
+
+/*
+  Evaluate the weak form coefficients and the Jacobian at a block of
+  points. Only the Jacobian with the linear strain expressions has a
+  specialized implementation.
+*/
+void TACSLinearElasticity3D::evalWeakMatrixPoints(
+    ElementMatrixType matType, int npts, const int elemIndex[],
+    const double time, const int n[], const double pt[], const TacsScalar X[],
+    const TacsScalar Xd[], const TacsScalar Ut[], const TacsScalar Ux[],
+    TacsScalar DUt[], TacsScalar DUx[], TacsScalar Jac[]) {
+  if (matType != TACS_JACOBIAN_MATRIX || strain_type != TACS_LINEAR_STRAIN) {
+    TACSElementModel::evalWeakMatrixPoints(matType, npts, elemIndex, time, n,
+                                           pt, X, Xd, Ut, Ux, DUt, DUx, Jac);
+    return;
+  }
+
+  // Evaluate the weak form coefficients
+  evalWeakIntegrandPoints(npts, elemIndex, time, n, pt, X, Xd, Ut, Ux, DUt,
+                          DUx);
+
+  for (int i = 0; i < npts; i++) {
+    double p[3];
+    TacsScalar Xp[3];
+    TacsGetPointCoordinates(npts, i, pt, X, p, Xp);
+
+    // Set the acceleration terms
+    TacsScalar rho = stiff->evalDensity(elemIndex[i], p, Xp);
+    Jac[i] = rho;
+    Jac[npts + i] = rho;
+    Jac[2 * npts + i] = rho;
+
+    TacsScalar C[21];
+    stiff->evalTangentStiffness(elemIndex[i], p, Xp, C);
+    for (int j = 0; j < 81; j++) {
+      Jac[(j + 3) * npts + i] = C[TACSLinearElasticity3DLinearJacIndex[j]];
+    }
+  }
+}
+
 void TACSLinearElasticity3D::addWeakMatDVSens(
     ElementMatrixType matType, int elemIndex, const double time,
     TacsScalar scale, int n, const double pt[], const TacsScalar X[],
@@ -2042,6 +2597,43 @@ int TACSLinearElasticity3D::evalPointQuantity(
   return 0;
 }
 
+/*
+  Evaluate the quantity of interest at a block of points. The failure
+  index is evaluated with the strain computed across the points.
+*/
+int TACSLinearElasticity3D::evalPointQuantities(
+    int npts, const int elemIndex[], const int quantityType, const double time,
+    const int n[], const double pt[], const TacsScalar X[],
+    const TacsScalar Xd[], const TacsScalar Ut[], const TacsScalar Ux[],
+    TacsScalar quantity[]) {
+  if (quantityType != TACS_FAILURE_INDEX) {
+    return TACSElementModel::evalPointQuantities(
+        npts, elemIndex, quantityType, time, n, pt, X, Xd, Ut, Ux, quantity);
+  }
+
+  const int bs = POINT_BLOCK_SIZE;
+  for (int start = 0; start < npts; start += bs) {
+    const int size = (npts - start < bs ? npts - start : bs);
+
+    TacsScalar e[6 * bs];
+    TacsEvalStrainPoints3D(strain_type, size, npts, &Ux[start], e);
+
+    for (int k = 0; k < size; k++) {
+      double p[3];
+      TacsScalar Xp[3];
+      TacsGetPointCoordinates(npts, start + k, pt, X, p, Xp);
+
+      TacsScalar ep[6];
+      for (int j = 0; j < 6; j++) {
+        ep[j] = e[j * bs + k];
+      }
+      quantity[start + k] = stiff->evalFailure(elemIndex[start + k], p, Xp, ep);
+    }
+  }
+
+  return 1;
+}
+
 /*
   Add the derivative of the point-wise quantity of interest w.r.t.
   design variables to the design vector
@@ -21,6 +21,89 @@
 
 enum ElementStrainType { TACS_LINEAR_STRAIN, TACS_NONLINEAR_STRAIN };
 
+/**
+  Evaluate the 2D strain at a block of points
+
+  The displacement gradient components are stored with a stride of
+  npts, while the strain components are stored with a stride of
+  TACSElementModel::POINT_BLOCK_SIZE.
+
+  @param strain_type The type of strain expression
+  @param size The number of points in the block
+  @param npts The stride between the components of Ux
+  @param Ux The displacement gradient at the points
+  @param e The strain at the points
+*/
+inline void TacsEvalStrainPoints2D(ElementStrainType strain_type, int size,
+                                   int npts, const TacsScalar Ux[],
+                                   TacsScalar e[]) {
+  const int bs = TACSElementModel::POINT_BLOCK_SIZE;
+  const TacsScalar *ux = &Ux[0], *uy = &Ux[npts];
+  const TacsScalar *vx = &Ux[2 * npts], *vy = &Ux[3 * npts];
+
+  if (strain_type == TACS_LINEAR_STRAIN) {
+    for (int k = 0; k < size; k++) {
+      e[k] = ux[k];
+      e[bs + k] = vy[k];
+      e[2 * bs + k] = uy[k] + vx[k];
+    }
+  } else {
+    for (int k = 0; k < size; k++) {
+      e[k] = ux[k] + 0.5 * (ux[k] * ux[k] + vx[k] * vx[k]);
+      e[bs + k] = vy[k] + 0.5 * (uy[k] * uy[k] + vy[k] * vy[k]);
+      e[2 * bs + k] = uy[k] + vx[k] + (ux[k] * uy[k] + vx[k] * vy[k]);
+    }
+  }
+}
+
+/**
+  Evaluate the 3D strain at a block of points
+
+  The storage format is the same as TacsEvalStrainPoints2D().
+
+  @param strain_type The type of strain expression
+  @param size The number of points in the block
+  @param npts The stride between the components of Ux
+  @param Ux The displacement gradient at the points
+  @param e The strain at the points
+*/
+inline void TacsEvalStrainPoints3D(ElementStrainType strain_type, int size,
+                                   int npts, const TacsScalar Ux[],
+                                   TacsScalar e[]) {
+  const int bs = TACSElementModel::POINT_BLOCK_SIZE;
+  const TacsScalar *ux = &Ux[0], *uy = &Ux[npts], *uz = &Ux[2 * npts];
+  const TacsScalar *vx = &Ux[3 * npts], *vy = &Ux[4 * npts];
+  const TacsScalar *vz = &Ux[5 * npts], *wx = &Ux[6 * npts];
+  const TacsScalar *wy = &Ux[7 * npts], *wz = &Ux[8 * npts];
+
+  if (strain_type == TACS_LINEAR_STRAIN) {
+    for (int k = 0; k < size; k++) {
+      e[k] = ux[k];
+      e[bs + k] = vy[k];
+      e[2 * bs + k] = wz[k];
+
+      e[3 * bs + k] = vz[k] + wy[k];
+      e[4 * bs + k] = uz[k] + wx[k];
+      e[5 * bs + k] = uy[k] + vx[k];
+    }
+  } else {
+    for (int k = 0; k < size; k++) {
+      e[k] = ux[k] + 0.5 * (ux[k] * ux[k] + vx[k] * vx[k] + wx[k] * wx[k]);
+      e[bs + k] =
+          vy[k] + 0.5 * (uy[k] * uy[k] + vy[k] * vy[k] + wy[k] * wy[k]);
+      e[2 * bs + k] =
+          wz[k] + 0.5 * (uz[k] * uz[k] + vz[k] * vz[k] + wz[k] * wz[k]);
+
+      e[3 * bs + k] = vz[k] + wy[k] +
+                      (uy[k] * uz[k] + vy[k] * vz[k] + wy[k] * wz[k]);
+      e[4 * bs + k] = uz[k] + wx[k] +
+                      (ux[k] * uz[k] + vx[k] * vz[k] + wx[k] * wz[k]);
+      e[5 * bs + k] = uy[k] + vx[k] +
+                      (ux[k] * uy[k] + vx[k] * vy[k] + wx[k] * wy[k]);
+    }
+  }
+}
+
 class TACSLinearElasticity2D : public TACSElementModel {
  public:
   TACSLinearElasticity2D(TACSPlaneStressConstitutive *_con,
@@ -66,6 +149,16 @@ class TACSLinearElasticity2D : public TACSElementModel {
                          const TacsScalar Ux[], TacsScalar DUt[],
                          TacsScalar DUx[]);
 
+  /**
+    Evaluate the weak form coefficients at a set of points
+  */
+  void evalWeakIntegrandPoints(int npts, const int elemIndex[],
+                               const double time, const int n[],
+                               const double pt[], const TacsScalar X[],
+                               const TacsScalar Xd[], const TacsScalar Ut[],
+                               const TacsScalar Ux[], TacsScalar DUt[],
+                               TacsScalar DUx[]);
+
   /**
      Add the derivative of the product of the adjoint and residual to
      the design vector
@@ -88,6 +181,28 @@ class TACSLinearElasticity2D : public TACSElementModel {
                                  TacsScalar dfdX[], TacsScalar dfdXd[],
                                  TacsScalar dfdUx[], TacsScalar dfdPsix[]);
 
+  /**
+    Evaluate the derivative of the weak form coefficients along a
+    design direction
+  */
+  void evalWeakDVSensVecProduct(int elemIndex, const double time, int n,
+                                const double pt[], const TacsScalar X[],
+                                const TacsScalar Xd[], const TacsScalar Ut[],
+                                const TacsScalar Ux[], int dvLen,
+                                const TacsScalar pdx[], TacsScalar work[],
+                                TacsScalar pDUt[], TacsScalar pDUx[]);
+
+  /**
+    Evaluate the derivative of the weak form coefficients along a
+    perturbation of the geometry
+  */
+  void evalWeakXptSensVecProduct(int elemIndex, const double time, int n,
+                                 const double pt[], const TacsScalar X[],
+                                 const TacsScalar Xd[], const TacsScalar Ut[],
+                                 const TacsScalar Ux[], const TacsScalar pX[],
+                                 const TacsScalar pXd[], const TacsScalar pUx[],
+                                 TacsScalar pDUt[], TacsScalar pDUx[]);
+
   /**
     Get the non-zero pattern for the matrix
   */
@@ -103,6 +218,17 @@ class TACSLinearElasticity2D : public TACSElementModel {
                       const TacsScalar Ut[], const TacsScalar Ux[],
                       TacsScalar DUt[], TacsScalar DUx[], TacsScalar Jac[]);
 
+  /**
+    Evaluate the weak form coefficients and Jacobian at a set of points
+  */
+  void evalWeakMatrixPoints(ElementMatrixType matType, int npts,
+                            const int elemIndex[], const double time,
+                            const int n[], const double pt[],
+                            const TacsScalar X[], const TacsScalar Xd[],
+                            const TacsScalar Ut[], const TacsScalar Ux[],
+                            TacsScalar DUt[], TacsScalar DUx[],
+                            TacsScalar Jac[]);
+
   /**
     Add the derivative of the weak form to the element sensitivity vector
   */
@@ -135,6 +261,16 @@ class TACSLinearElasticity2D : public TACSElementModel {
                         const TacsScalar Ut[], const TacsScalar Ux[],
                         TacsScalar *quantity);
 
+  /**
+     Evaluate a point-wise quantity of interest at a set of points
+  */
+  int evalPointQuantities(int npts, const int elemIndex[],
+                          const int quantityType, const double time,
+                          const int n[], const double pt[],
+                          const TacsScalar X[], const TacsScalar Xd[],
+                          const TacsScalar Ut[], const TacsScalar Ux[],
+                          TacsScalar quantity[]);
+
   /**
      Add the derivative of the quantity w.r.t. the design variables
   */
@@ -218,6 +354,16 @@ class TACSLinearElasticity3D : public TACSElementModel {
                          const TacsScalar Ux[], TacsScalar DUt[],
                          TacsScalar DUx[]);
 
+  /**
+    Evaluate the weak form coefficients at a set of points
+  */
+  void evalWeakIntegrandPoints(int npts, const int elemIndex[],
+                               const double time, const int n[],
+                               const double pt[], const TacsScalar X[],
+                               const TacsScalar Xd[], const TacsScalar Ut[],
+                               const TacsScalar Ux[], TacsScalar DUt[],
+                               TacsScalar DUx[]);
+
   /**
     Evaluate the derivatives of the weak form coefficients
   */
@@ -250,6 +396,28 @@ class TACSLinearElasticity3D : public TACSElementModel {
                                  TacsScalar dfdX[], TacsScalar dfdXd[],
                                  TacsScalar dfdUx[], TacsScalar dfdPsix[]);
 
+  /**
+    Evaluate the derivative of the weak form coefficients along a
+    design direction
+  */
+  void evalWeakDVSensVecProduct(int elemIndex, const double time, int n,
+                                const double pt[], const TacsScalar X[],
+                                const TacsScalar Xd[], const TacsScalar Ut[],
+                                const TacsScalar Ux[], int dvLen,
+                                const TacsScalar pdx[], TacsScalar work[],
+                                TacsScalar pDUt[], TacsScalar pDUx[]);
+
+  /**
+    Evaluate the derivative of the weak form coefficients along a
+    perturbation of the geometry
+  */
+  void evalWeakXptSensVecProduct(int elemIndex, const double time, int n,
+                                 const double pt[], const TacsScalar X[],
+                                 const TacsScalar Xd[], const TacsScalar Ut[],
+                                 const TacsScalar Ux[], const TacsScalar pX[],
+                                 const TacsScalar pXd[], const TacsScalar pUx[],
+                                 TacsScalar pDUt[], TacsScalar pDUx[]);
+
   /**
     Get the non-zero pattern for the matrix
   */
@@ -265,6 +433,17 @@ class TACSLinearElasticity3D : public TACSElementModel {
                       const TacsScalar Ut[], const TacsScalar Ux[],
                       TacsScalar DUt[], TacsScalar DUx[], TacsScalar Jac[]);
 
+  /**
+    Evaluate the weak form coefficients and Jacobian at a set of points
+  */
+  void evalWeakMatrixPoints(ElementMatrixType matType, int npts,
+                            const int elemIndex[], const double time,
+                            const int n[], const double pt[],
+                            const TacsScalar X[], const TacsScalar Xd[],
+                            const TacsScalar Ut[], const TacsScalar Ux[],
+                            TacsScalar DUt[], TacsScalar DUx[],
+                            TacsScalar Jac[]);
+
   /**
     Add the derivative of the weak form to the element sensitivity vector
   */
@@ -297,6 +476,16 @@ class TACSLinearElasticity3D : public TACSElementModel {
                         const TacsScalar Ut[], const TacsScalar Ux[],
                         TacsScalar *quantity);
 
+  /**
+     Evaluate a point-wise quantity of interest at a set of points
+  */
+  int evalPointQuantities(int npts, const int elemIndex[],
+                          const int quantityType, const double time,
+                          const int n[], const double pt[],
+                          const TacsScalar X[], const TacsScalar Xd[],
+                          const TacsScalar Ut[], const TacsScalar Ux[],
+                          TacsScalar quantity[]);
+
   /**
      Add the derivative of the quantity w.r.t. the design variables
   */
@@ -145,6 +145,89 @@ void TACSLinearThermoelasticity2D::evalWeakIntegrand(
   DUx[5] = flux[1];
 }
 
+/*
+  Evaluate the weak form coefficients at a block of points. The
+  kinematics and the coefficients are computed across the points,
+  while the constitutive object is still evaluated point by point.
+*/
+void TACSLinearThermoelasticity2D::evalWeakIntegrandPoints(
+    int npts, const int elemIndex[], const double time, const int n[],
+    const double pt[], const TacsScalar X[], const TacsScalar Xd[],
+    const TacsScalar Ut[], const TacsScalar Ux[], TacsScalar DUt[],
+    TacsScalar DUx[]) {
+  const int bs = POINT_BLOCK_SIZE;
+
+  for (int start = 0; start < npts; start += bs) {
+    const int size = (npts - start < bs ? npts - start : bs);
+
+    TacsScalar e[3 * bs], s[3 * bs], rho[bs], c[bs];
+    TacsEvalStrainPoints2D(strain_type, size, npts, &Ux[start], e);
+
+    for (int k = 0; k < size; k++) {
+      const int i = start + k;
+      double p[3];
+      TacsScalar Xp[3];
+      TacsGetPointCoordinates(npts, i, pt, X, p, Xp);
+
+      // Evaluate the density and specific heat
+      rho[k] = stiff->evalDensity(elemIndex[i], p, Xp);
+      c[k] = stiff->evalSpecificHeat(elemIndex[i], p, Xp);
+
+      // Compute the mechanical strain by removing the thermal strain
+      TacsScalar theta = Ut[6 * npts + i];
+      TacsScalar et[3], ep[3], sp[3];
+      stiff->evalThermalStrain(elemIndex[i], p, Xp, theta, et);
+      for (int j = 0; j < 3; j++) {
+        ep[j] = e[j * bs + k] - et[j];
+      }
+
+      // Evaluate the stress
+      stiff->evalStress(elemIndex[i], p, Xp, ep, sp);
+      for (int j = 0; j < 3; j++) {
+        s[j * bs + k] = sp[j];
+      }
+
+      // Compute the thermal flux from the thermal gradient
+      TacsScalar grad[2], flux[2];
+      for (int j = 0; j < 2; j++) {
+        grad[j] = Ux[(4 + j) * npts + i];
+      }
+      stiff->evalHeatFlux(elemIndex[i], p, Xp, grad, flux);
+      for (int j = 0; j < 2; j++) {
+        DUx[(4 + j) * npts + i] = flux[j];
+      }
+    }
+
+    for (int j = 0; j < 9; j++) {
+      TacsScalar *dut = &DUt[j * npts + start];
+      const TacsScalar *ut = &Ut[j * npts + start];
+      if (j < 6 && j % 3 == 2 &&
+          !(steady_state_flag & TACS_STEADY_STATE_MECHANICAL)) {
+        for (int k = 0; k < size; k++) {
+          dut[k] = rho[k] * ut[k];
+        }
+      } else if (j == 7 &&
+                 !(steady_state_flag & TACS_STEADY_STATE_THERMAL)) {
+        for (int k = 0; k < size; k++) {
+          dut[k] = c[k] * rho[k] * ut[k];
+        }
+      } else {
+        for (int k = 0; k < size; k++) {
+          dut[k] = 0.0;
+        }
+      }
+    }
+
+    const TacsScalar *s0 = &s[0], *s1 = &s[bs], *s2 = &s[2 * bs];
+    for (int k = 0; k < size; k++) {
+        DUx[start + k] = s0[k];
+        DUx[npts + start + k] = s2[k];
+        DUx[2 * npts + start + k] = s2[k];
+        DUx[3 * npts + start + k] = s1[k];
+    }
+  }
+}
+
 void TACSLinearThermoelasticity2D::getWeakMatrixNonzeros(
     ElementMatrixType matType, int elemIndex, int *Jac_nnz,
     const int *Jac_pairs[]) {
@@ -572,6 +655,48 @@ int TACSLinearThermoelasticity2D::evalPointQuantity(
   return 0;
 }
 
+/*
+  Evaluate the quantity of interest at a block of points. The failure
+  index is evaluated with the strain computed across the points.
+*/
+int TACSLinearThermoelasticity2D::evalPointQuantities(
+    int npts, const int elemIndex[], const int quantityType, const double time,
+    const int n[], const double pt[], const TacsScalar X[],
+    const TacsScalar Xd[], const TacsScalar Ut[], const TacsScalar Ux[],
+    TacsScalar quantity[]) {
+  if (quantityType != TACS_FAILURE_INDEX) {
+    return TACSElementModel::evalPointQuantities(
+        npts, elemIndex, quantityType, time, n, pt, X, Xd, Ut, Ux, quantity);
+  }
+
+  const int bs = POINT_BLOCK_SIZE;
+  for (int start = 0; start < npts; start += bs) {
+    const int size = (npts - start < bs ? npts - start : bs);
+
+    TacsScalar e[3 * bs];
+    TacsEvalStrainPoints2D(strain_type, size, npts, &Ux[start], e);
+
+    for (int k = 0; k < size; k++) {
+      const int i = start + k;
+      double p[3];
+      TacsScalar Xp[3];
+      TacsGetPointCoordinates(npts, i, pt, X, p, Xp);
+
+      // Compute the mechanical strain by removing the thermal strain
+      TacsScalar theta = Ut[6 * npts + i];
+      TacsScalar et[3], ep[3];
+      stiff->evalThermalStrain(elemIndex[i], p, Xp, theta, et);
+      for (int j = 0; j < 3; j++) {
+        ep[j] = e[j * bs + k] - et[j];
+      }
+
+      quantity[i] = stiff->evalFailure(elemIndex[i], p, Xp, ep);
+    }
+  }
+
+  return 1;
+}
+
 /*
   Add the derivative of the point-wise quantity of interest w.r.t.
   design variables to the design vector
@@ -1028,6 +1153,95 @@ void TACSLinearThermoelasticity3D::evalWeakIntegrand(
   DUx[11] = flux[2];
 }
 
+/*
+  Evaluate the weak form coefficients at a block of points. The
+  kinematics and the coefficients are computed across the points,
+  while the constitutive object is still evaluated point by point.
+*/
+void TACSLinearThermoelasticity3D::evalWeakIntegrandPoints(
+    int npts, const int elemIndex[], const double time, const int n[],
+    const double pt[], const TacsScalar X[], const TacsScalar Xd[],
+    const TacsScalar Ut[], const TacsScalar Ux[], TacsScalar DUt[],
+    TacsScalar DUx[]) {
+  const int bs = POINT_BLOCK_SIZE;
+
+  for (int start = 0; start < npts; start += bs) {
+    const int size = (npts - start < bs ? npts - start : bs);
+
+    TacsScalar e[6 * bs], s[6 * bs], rho[bs], c[bs];
+    TacsEvalStrainPoints3D(strain_type, size, npts, &Ux[start], e);
+
+    for (int k = 0; k < size; k++) {
+      const int i = start + k;
+      double p[3];
+      TacsScalar Xp[3];
+      TacsGetPointCoordinates(npts, i, pt, X, p, Xp);
+
+      // Evaluate the density and specific heat
+      rho[k] = stiff->evalDensity(elemIndex[i], p, Xp);
+      c[k] = stiff->evalSpecificHeat(elemIndex[i], p, Xp);
+
+      // Compute the mechanical strain by removing the thermal strain
+      TacsScalar theta = Ut[9 * npts + i];
+      TacsScalar et[6], ep[6], sp[6];
+      stiff->evalThermalStrain(elemIndex[i], p, Xp, theta, et);
+      for (int j = 0; j < 6; j++) {
+        ep[j] = e[j * bs + k] - et[j];
+      }
+
+      // Evaluate the stress
+      stiff->evalStress(elemIndex[i], p, Xp, ep, sp);
+      for (int j = 0; j < 6; j++) {
+        s[j * bs + k] = sp[j];
+      }
+
+      // Compute the thermal flux from the thermal gradient
+      TacsScalar grad[3], flux[3];
+      for (int j = 0; j < 3; j++) {
+        grad[j] = Ux[(9 + j) * npts + i];
+      }
+      stiff->evalHeatFlux(elemIndex[i], p, Xp, grad, flux);
+      for (int j = 0; j < 3; j++) {
+        DUx[(9 + j) * npts + i] = flux[j];
+      }
+    }
+
+    for (int j = 0; j < 12; j++) {
+      TacsScalar *dut = &DUt[j * npts + start];
+      const TacsScalar *ut = &Ut[j * npts + start];
+      if (j < 9 && j % 3 == 2 &&
+          !(steady_state_flag & TACS_STEADY_STATE_MECHANICAL)) {
+        for (int k = 0; k < size; k++) {
+          dut[k] = rho[k] * ut[k];
+        }
+      } else if (j == 10 &&
+                 !(steady_state_flag & TACS_STEADY_STATE_THERMAL)) {
+        for (int k = 0; k < size; k++) {
+          dut[k] = c[k] * rho[k] * ut[k];
+        }
+      } else {
+        for (int k = 0; k < size; k++) {
+          dut[k] = 0.0;
+        }
+      }
+    }
+
+    const TacsScalar *s0 = &s[0], *s1 = &s[bs], *s2 = &s[2 * bs];
+    const TacsScalar *s3 = &s[3 * bs], *s4 = &s[4 * bs], *s5 = &s[5 * bs];
+    for (int k = 0; k < size; k++) {
+        DUx[start + k] = s0[k];
+        DUx[npts + start + k] = s5[k];
+        DUx[2 * npts + start + k] = s4[k];
+        DUx[3 * npts + start + k] = s5[k];
+        DUx[4 * npts + start + k] = s1[k];
+        DUx[5 * npts + start + k] = s3[k];
+        DUx[6 * npts + start + k] = s4[k];
+        DUx[7 * npts + start + k] = s3[k];
+        DUx[8 * npts + start + k] = s2[k];
+    }
+  }
+}
+
 void TACSLinearThermoelasticity3D::getWeakMatrixNonzeros(
     ElementMatrixType matType, int elemIndex, int *Jac_nnz,
     const int *Jac_pairs[]) {
@@ -1683,6 +1897,48 @@ int TACSLinearThermoelasticity3D::evalPointQuantity(
   return 0;
 }
 
+/*
+  Evaluate the quantity of interest at a block of points. The failure
+  index is evaluated with the strain computed across the points.
+*/
+int TACSLinearThermoelasticity3D::evalPointQuantities(
+    int npts, const int elemIndex[], const int quantityType, const double time,
+    const int n[], const double pt[], const TacsScalar X[],
+    const TacsScalar Xd[], const TacsScalar Ut[], const TacsScalar Ux[],
+    TacsScalar quantity[]) {
+  if (quantityType != TACS_FAILURE_INDEX) {
+    return TACSElementModel::evalPointQuantities(
+        npts, elemIndex, quantityType, time, n, pt, X, Xd, Ut, Ux, quantity);
+  }
+
+  const int bs = POINT_BLOCK_SIZE;
+  for (int start = 0; start < npts; start += bs) {
+    const int size = (npts - start < bs ? npts - start : bs);
+
+    TacsScalar e[6 * bs];
+    TacsEvalStrainPoints3D(strain_type, size, npts, &Ux[start], e);
+
+    for (int k = 0; k < size; k++) {
+      const int i = start + k;
+      double p[3];
+      TacsScalar Xp[3];
+      TacsGetPointCoordinates(npts, i, pt, X, p, Xp);
+
+      // Compute the mechanical strain by removing the thermal strain
+      TacsScalar theta = Ut[9 * npts + i];
+      TacsScalar et[6], ep[6];
+      stiff->evalThermalStrain(elemIndex[i], p, Xp, theta, et);
+      for (int j = 0; j < 6; j++) {
+        ep[j] = e[j * bs + k] - et[j];
+      }
+
+      quantity[i] = stiff->evalFailure(elemIndex[i], p, Xp, ep);
+    }
+  }
+
+  return 1;
+}
+
 /*
   Add the derivative of the point-wise quantity of interest w.r.t.
   design variables to the design vector
@@ -69,6 +69,16 @@ class TACSLinearThermoelasticity2D : public TACSElementModel {
                          const TacsScalar Ux[], TacsScalar DUt[],
                          TacsScalar DUx[]);
 
+  /**
+    Evaluate the weak form coefficients at a set of points
+  */
+  void evalWeakIntegrandPoints(int npts, const int elemIndex[],
+                               const double time, const int n[],
+                               const double pt[], const TacsScalar X[],
+                               const TacsScalar Xd[], const TacsScalar Ut[],
+                               const TacsScalar Ux[], TacsScalar DUt[],
+                               TacsScalar DUx[]);
+
   /**
      Add the derivative of the product of the adjoint and residual to
      the design vector
@@ -115,6 +125,16 @@ class TACSLinearThermoelasticity2D : public TACSElementModel {
                         const TacsScalar Ut[], const TacsScalar Ux[],
                         TacsScalar *quantity);
 
+  /**
+     Evaluate a point-wise quantity of interest at a set of points
+  */
+  int evalPointQuantities(int npts, const int elemIndex[],
+                          const int quantityType, const double time,
+                          const int n[], const double pt[],
+                          const TacsScalar X[], const TacsScalar Xd[],
+                          const TacsScalar Ut[], const TacsScalar Ux[],
+                          TacsScalar quantity[]);
+
   /**
      Add the derivative of the quantity w.r.t. the design variables
   */
@@ -200,6 +220,16 @@ class TACSLinearThermoelasticity3D : public TACSElementModel {
                          const TacsScalar Ux[], TacsScalar DUt[],
                          TacsScalar DUx[]);
 
+  /**
+    Evaluate the weak form coefficients at a set of points
+  */
+  void evalWeakIntegrandPoints(int npts, const int elemIndex[],
+                               const double time, const int n[],
+                               const double pt[], const TacsScalar X[],
+                               const TacsScalar Xd[], const TacsScalar Ut[],
+                               const TacsScalar Ux[], TacsScalar DUt[],
+                               TacsScalar DUx[]);
+
   /**
      Add the derivative of the product of the adjoint and residual to
      the design vector
@@ -246,6 +276,16 @@ class TACSLinearThermoelasticity3D : public TACSElementModel {
                         const TacsScalar Ut[], const TacsScalar Ux[],
                         TacsScalar *quantity);
 
+  /**
+     Evaluate a point-wise quantity of interest at a set of points
+  */
+  int evalPointQuantities(int npts, const int elemIndex[],
+                          const int quantityType, const double time,
+                          const int n[], const double pt[],
+                          const TacsScalar X[], const TacsScalar Xd[],
+                          const TacsScalar Ut[], const TacsScalar Ux[],
+                          TacsScalar quantity[]);
+
   /**
      Add the derivative of the quantity w.r.t. the design variables
   */
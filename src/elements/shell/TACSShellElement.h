@@ -146,6 +146,22 @@ class TACSShellElement : public TACSElement {
                         const TacsScalar ddvars[], int dvLen,
                         TacsScalar dfdx[]);
 
+  void addResidualDVSensVecProduct(int elemIndex, double time,
+                                   TacsScalar scale, const TacsScalar Xpts[],
+                                   const TacsScalar vars[],
+                                   const TacsScalar dvars[],
+                                   const TacsScalar ddvars[], int dvLen,
+                                   const TacsScalar pdx[], TacsScalar work[],
+                                   TacsScalar res[]);
+
+  void addResidualXptSensVecProduct(int elemIndex, double time,
+                                    TacsScalar scale, const TacsScalar Xpts[],
+                                    const TacsScalar vars[],
+                                    const TacsScalar dvars[],
+                                    const TacsScalar ddvars[],
+                                    const TacsScalar pXpts[],
+                                    TacsScalar work[], TacsScalar res[]);
+
   int evalPointQuantity(int elemIndex, int quantityType, double time, int n,
                         double pt[], const TacsScalar Xpts[],
                         const TacsScalar vars[], const TacsScalar dvars[],
@@ -1011,6 +1027,239 @@ void TACSShellElement<quadrature, basis, director, model>::addAdjResProduct(
   }
 }
 
+/*
+  Add the directional derivative of the residual w.r.t. the design
+  variables
+
+  The residual depends on the design variables only through the stress
+  and the mass moments. The derivatives of these along the design
+  direction are found from the constitutive object and are then added
+  to the residual in the same way as the stress and mass moments in
+  addResidual().
+*/
+template <class quadrature, class basis, class director, class model>
+void TACSShellElement<quadrature, basis, director, model>::
+    addResidualDVSensVecProduct(int elemIndex, double time, TacsScalar scale,
+                                const TacsScalar Xpts[],
+                                const TacsScalar vars[],
+                                const TacsScalar dvars[],
+                                const TacsScalar ddvars[], int dvLen,
+                                const TacsScalar pdx[], TacsScalar work[],
+                                TacsScalar res[]) {
+  // Compute the number of quadrature points
+  const int nquad = quadrature::getNumQuadraturePoints();
+  const int dvSize = dvLen * getDesignVarsPerNode();
+  if (dvSize == 0) {
+    return;
+  }
+
+  // Check whether there are any inertial contributions
+  int dynamic = 0;
+  for (int i = 0; i < vars_per_node * num_nodes; i++) {
+    if (ddvars[i] != 0.0) {
+      dynamic = 1;
+      break;
+    }
+  }
+
+  // Derivative of the director field and matrix at each point
+  TacsScalar dd[dsize];
+  memset(dd, 0, 3 * num_nodes * sizeof(TacsScalar));
+
+  // Compute the node normal directions
+  TacsScalar fn[3 * num_nodes], Xdn[9 * num_nodes];
+  TacsShellComputeNodeNormals<basis>(Xpts, fn, Xdn);
+
+  // Compute the drill strain penalty at each node
+  TacsScalar etn[num_nodes], detn[num_nodes];
+  memset(detn, 0, num_nodes * sizeof(TacsScalar));
+
+  // Store information about the transformation and derivatives at each node for
+  // the drilling degrees of freedom
+  TacsScalar XdinvTn[9 * num_nodes], Tn[9 * num_nodes];
+  TacsScalar u0xn[9 * num_nodes], Ctn[csize];
+  TacsShellComputeDrillStrain<vars_per_node, offset, basis, director, model>(
+      transform, Xdn, fn, vars, XdinvTn, Tn, u0xn, Ctn, etn);
+
+  TacsScalar d[dsize], ddot[dsize], dddot[dsize];
+  director::template computeDirectorRates<vars_per_node, offset, num_nodes>(
+      vars, dvars, ddvars, fn, d, ddot, dddot);
+
+  // Compute the tying strain values
+  TacsScalar ety[basis::NUM_TYING_POINTS], dety[basis::NUM_TYING_POINTS];
+  memset(dety, 0, basis::NUM_TYING_POINTS * sizeof(TacsScalar));
+  model::template computeTyingStrain<vars_per_node, basis>(Xpts, fn, vars, d,
+                                                           ety);
+
+  // Loop over each quadrature point and add the residual contribution
+  for (int quad_index = 0; quad_index < nquad; quad_index++) {
+    // Get the quadrature weight
+    double pt[3];
+    double weight = quadrature::getQuadraturePoint(quad_index, pt);
+
+    // Compute X, X,xi and the interpolated normal n0
+    TacsScalar X[3], Xxi[6], n0[3], T[9], et;
+    basis::template interpFields<3, 3>(pt, Xpts, X);
+    basis::template interpFieldsGrad<3, 3>(pt, Xpts, Xxi);
+    basis::template interpFields<3, 3>(pt, fn, n0);
+    basis::template interpFields<1, 1>(pt, etn, &et);
+
+    // Compute the transformation at the quadrature point
+    transform->computeTransform(Xxi, n0, T);
+
+    // Evaluate the displacement gradient at the point
+    TacsScalar XdinvT[9], XdinvzT[9];
+    TacsScalar u0x[9], u1x[9];
+    TacsScalar detXd = TacsShellComputeDispGrad<vars_per_node, basis>(
+        pt, Xpts, vars, fn, d, Xxi, n0, T, XdinvT, XdinvzT, u0x, u1x);
+    detXd *= scale * weight;
+
+    // Evaluate the tying components of the strain
+    TacsScalar gty[6];  // The symmetric components of the tying strain
+    basis::interpTyingStrain(pt, ety, gty);
+
+    // Compute the symmetric parts of the tying strain
+    TacsScalar e0ty[6];  // e0ty = XdinvT^{T}*gty*XdinvT
+    mat3x3SymmTransformTranspose(XdinvT, gty, e0ty);
+
+    // Compute the set of strain components
+    TacsScalar e[9];  // The components of the strain
+    model::evalStrain(u0x, u1x, e0ty, e);
+    e[8] = et;
+
+    // Compute the derivative of the stress along the design direction
+    TacsScalar s[9];
+    con->evalStressDVSensVecProduct(elemIndex, pt, X, e, dvLen, pdx, work, s);
+
+    // Compute the derivative of the product of the stress and strain
+    // with respect to u0x, u1x and e0ty
+    TacsScalar du0x[9], du1x[9], de0ty[6];
+    model::evalStrainSens(detXd, s, u0x, u1x, du0x, du1x, de0ty);
+
+    // Add the contribution to the drilling strain
+    TacsScalar det = detXd * s[8];
+    basis::template addInterpFieldsTranspose<1, 1>(pt, &det, detn);
+
+    // Add the contributions to the residual from du0x, du1x and dCt
+    TacsShellAddDispGradSens<vars_per_node, basis>(pt, T, XdinvT, XdinvzT, du0x,
+                                                   du1x, res, dd);
+
+    // Compute the of the tying strain w.r.t. derivative w.r.t. the coefficients
+    TacsScalar dgty[6];
+    mat3x3SymmTransformTransSens(XdinvT, de0ty, dgty);
+
+    // Evaluate the tying strain
+    basis::addInterpTyingStrainTranspose(pt, dgty, dety);
+
+    if (dynamic) {
+      // Compute the derivative of the mass moments along the design
+      // direction
+      TacsScalar moments[3];
+      con->evalMassMomentsDVSensVecProduct(elemIndex, pt, X, dvLen, pdx, work,
+                                           moments);
+
+      // Evaluate the second time derivatives
+      TacsScalar u0ddot[3], d0ddot[3];
+      basis::template interpFields<vars_per_node, 3>(pt, ddvars, u0ddot);
+      basis::template interpFields<3, 3>(pt, dddot, d0ddot);
+
+      // Add the contributions to the derivative
+      TacsScalar du0dot[3];
+      du0dot[0] = detXd * (moments[0] * u0ddot[0] + moments[1] * d0ddot[0]);
+      du0dot[1] = detXd * (moments[0] * u0ddot[1] + moments[1] * d0ddot[1]);
+      du0dot[2] = detXd * (moments[0] * u0ddot[2] + moments[1] * d0ddot[2]);
+      basis::template addInterpFieldsTranspose<vars_per_node, 3>(pt, du0dot,
+                                                                 res);
+
+      TacsScalar dd0dot[3];
+      dd0dot[0] = detXd * (moments[1] * u0ddot[0] + moments[2] * d0ddot[0]);
+      dd0dot[1] = detXd * (moments[1] * u0ddot[1] + moments[2] * d0ddot[1]);
+      dd0dot[2] = detXd * (moments[1] * u0ddot[2] + moments[2] * d0ddot[2]);
+      basis::template addInterpFieldsTranspose<3, 3>(pt, dd0dot, dd);
+    }
+  }
+
+  // Add the contribution to the residual from the drill strain
+  TacsShellAddDrillStrainSens<vars_per_node, offset, basis, director, model>(
+      Xdn, fn, vars, XdinvTn, Tn, u0xn, Ctn, detn, res);
+
+  // Add the contributions from the tying strain
+  model::template addComputeTyingStrainTranspose<vars_per_node, basis>(
+      Xpts, fn, vars, d, dety, res, dd);
+
+  // Add the contributions to the director field
+  director::template addDirectorResidual<vars_per_node, offset, num_nodes>(
+      vars, dvars, ddvars, fn, dd, res);
+}
+
+/*
+  Add the directional derivative of the residual w.r.t. the node
+  locations
+
+  The shell element does not have a derivative of the residual w.r.t.
+  the node locations, so the derivative is found along the node
+  direction directly. This uses the complex step method in the complex
+  build and finite differences otherwise, which costs one or two
+  residual evaluations instead of one for each node coordinate.
+*/
+template <class quadrature, class basis, class director, class model>
+void TACSShellElement<quadrature, basis, director, model>::
+    addResidualXptSensVecProduct(int elemIndex, double time, TacsScalar scale,
+                                 const TacsScalar Xpts[],
+                                 const TacsScalar vars[],
+                                 const TacsScalar dvars[],
+                                 const TacsScalar ddvars[],
+                                 const TacsScalar pXpts[], TacsScalar work[],
+                                 TacsScalar res[]) {
+  // The step length
+#ifdef TACS_USE_COMPLEX
+  const double dh = 1e-30;
+#else
+  const double dh = 1e-7;
+#endif  // TACS_USE_COMPLEX
+
+  const int nvars = vars_per_node * num_nodes;
+  TacsScalar *tmp = work;
+  TacsScalar *X = &work[nvars];
+
+  // Evaluate the residual at the perturbed node locations
+  for (int k = 0; k < 3 * num_nodes; k++) {
+#ifdef TACS_USE_COMPLEX
+    X[k] = Xpts[k] + TacsScalar(0.0, dh) * pXpts[k];
+#else
+    X[k] = Xpts[k] + dh * pXpts[k];
+#endif  // TACS_USE_COMPLEX
+  }
+  memset(tmp, 0, nvars * sizeof(TacsScalar));
+  addResidual(elemIndex, time, X, vars, dvars, ddvars, tmp);
+
+#ifdef TACS_USE_COMPLEX
+  for (int i = 0; i < nvars; i++) {
+    res[i] += scale * TacsImagPart(tmp[i]) / dh;
+  }
+#else
+  // Subtract the residual at the unperturbed node locations, or at the
+  // backward step for second-order central differencing
+  double h = dh;
+  if (getFiniteDifferenceOrder() < 2) {
+    memcpy(X, Xpts, 3 * num_nodes * sizeof(TacsScalar));
+  } else {
+    for (int k = 0; k < 3 * num_nodes; k++) {
+      X[k] = Xpts[k] - dh * pXpts[k];
+    }
+    h = 2.0 * dh;
+  }
+  for (int i = 0; i < nvars; i++) {
+    tmp[i] = -tmp[i];
+  }
+  addResidual(elemIndex, time, X, vars, dvars, ddvars, tmp);
+
+  for (int i = 0; i < nvars; i++) {
+    res[i] -= scale * tmp[i] / h;
+  }
+#endif  // TACS_USE_COMPLEX
+}
+
 template <class quadrature, class basis, class director, class model>
 int TACSShellElement<quadrature, basis, director, model>::evalPointQuantity(
     int elemIndex, int quantityType, double time, int n, double pt[],
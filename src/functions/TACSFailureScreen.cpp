@@ -0,0 +1,232 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSFailureScreen.h"
+
+#include <string.h>
+
+/*
+  Compute a 64-bit FNV-1a hash of the element node locations and
+  state variables. This is used to identify the state at which the
+  centroid failure value was computed.
+*/
+static uint64_t TacsFailureScreenHash(int numNodes, int numVars,
+                                      const TacsScalar Xpts[],
+                                      const TacsScalar vars[],
+                                      const TacsScalar dvars[],
+                                      const TacsScalar ddvars[]) {
+  uint64_t h = 14695981039346656037ULL;
+  const TacsScalar *arrays[4] = {Xpts, vars, dvars, ddvars};
+  const int sizes[4] = {3 * numNodes, numVars, numVars, numVars};
+  for (int k = 0; k < 4; k++) {
+    if (arrays[k]) {
+      const unsigned char *p = (const unsigned char *)arrays[k];
+      size_t len = sizes[k] * sizeof(TacsScalar);
+      for (size_t i = 0; i < len; i++) {
+        h = (h ^ p[i]) * 1099511628211ULL;
+      }
+    }
+  }
+  return h;
+}
+
+TACSFailureScreen::TACSFailureScreen(int _numElements, double _tol,
+                                     double _spreadFactor) {
+  numElements = _numElements;
+  tol = _tol;
+  spreadFactor = 1.0;
+  setSpreadFactor(_spreadFactor);
+
+  centroidFail = new TacsScalar[numElements];
+  centroidMeasure = new double[numElements];
+  centroidCurrent = new int[numElements];
+  centroidTime = new double[numElements];
+  centroidKey = new uint64_t[numElements];
+  spread = new double[numElements];
+  for (int i = 0; i < numElements; i++) {
+    centroidFail[i] = 0.0;
+    centroidMeasure[i] = 0.0;
+    centroidCurrent[i] = 0;
+    centroidTime[i] = 0.0;
+    centroidKey[i] = 0;
+    spread[i] = -1.0;
+  }
+
+  logSkipped = -1e20;
+  numChecked = numSkipped = 0;
+  skippedFraction = 0.0;
+}
+
+TACSFailureScreen::~TACSFailureScreen() {
+  delete[] centroidFail;
+  delete[] centroidMeasure;
+  delete[] centroidCurrent;
+  delete[] centroidTime;
+  delete[] centroidKey;
+  delete[] spread;
+}
+
+/*
+  Reset the data for the next pass
+*/
+void TACSFailureScreen::initPass(TACSFunction::EvaluationType ftype) {
+  if (ftype == TACSFunction::INITIALIZE) {
+    for (int i = 0; i < numElements; i++) {
+      centroidCurrent[i] = 0;
+    }
+  } else if (ftype == TACSFunction::INTEGRATE) {
+    logSkipped = -1e20;
+    numChecked = numSkipped = 0;
+  }
+}
+
+/*
+  Evaluate the bound on the failure index and check whether the
+  element contribution is negligible
+*/
+int TACSFailureScreen::skipElement(
+    TACSFunction::EvaluationType ftype, int elemIndex, TACSElement *element,
+    double time, TacsScalar scale, double safetyFactor, double weight,
+    int continuous, TacsScalar maxFail, TacsScalar sum,
+    const TacsScalar Xpts[], const TacsScalar vars[], const TacsScalar dvars[],
+    const TacsScalar ddvars[]) {
+  if (elemIndex < 0 || elemIndex >= numElements) {
+    return 0;
+  }
+  const int numQuadPoints = element->getNumQuadraturePoints();
+  if (ftype == TACSFunction::INTEGRATE) {
+    numChecked++;
+  }
+
+  // Re-use the centroid value from the INITIALIZE pass if it was
+  // computed at the same time and state, otherwise evaluate the failure
+  // index at the centroid. The time integrators complete the INITIALIZE
+  // pass over all time steps before the INTEGRATE pass, so the stored
+  // value may belong to a different step.
+  uint64_t key = TacsFailureScreenHash(element->getNumNodes(),
+                                       element->getNumVariables(), Xpts, vars,
+                                       dvars, ddvars);
+  int count = 1;
+  if (ftype == TACSFunction::INTEGRATE && centroidCurrent[elemIndex] &&
+      centroidTime[elemIndex] == time && centroidKey[elemIndex] == key) {
+    centroidCurrent[elemIndex] = 0;
+  } else {
+    // Find the centroid as the weighted average of the quadrature points
+    double pt[3] = {0.0, 0.0, 0.0};
+    double wsum = 0.0;
+    for (int i = 0; i < numQuadPoints; i++) {
+      double qpt[3] = {0.0, 0.0, 0.0};
+      double w = element->getQuadraturePoint(i, qpt);
+      pt[0] += w * qpt[0];
+      pt[1] += w * qpt[1];
+      pt[2] += w * qpt[2];
+      wsum += w;
+    }
+    if (wsum != 0.0) {
+      pt[0] /= wsum;
+      pt[1] /= wsum;
+      pt[2] /= wsum;
+    }
+
+    TacsScalar fail = 0.0, detXd = 0.0;
+    count = element->evalPointQuantity(elemIndex, TACS_FAILURE_INDEX, time,
+                                       -1, pt, Xpts, vars, dvars, ddvars,
+                                       &detXd, &fail);
+    if (count < 1) {
+      spread[elemIndex] = -1.0;
+    }
+    centroidFail[elemIndex] = fail;
+    centroidMeasure[elemIndex] = wsum * fabs(TacsRealPart(detXd));
+    centroidCurrent[elemIndex] = (ftype == TACSFunction::INITIALIZE);
+    centroidTime[elemIndex] = time;
+    centroidKey[elemIndex] = key;
+  }
+
+  if (count < 1 || spread[elemIndex] < 0.0) {
+    return 0;
+  }
+
+  double fc = TacsRealPart(centroidFail[elemIndex]);
+  double bound =
+      safetyFactor * (fc + spreadFactor * spread[elemIndex] * fabs(fc));
+
+  int skip = 0;
+  if (ftype == TACSFunction::INITIALIZE) {
+    skip = (bound < TacsRealPart(maxFail));
+  } else if (TacsRealPart(scale) > 0.0 && TacsRealPart(sum) > 0.0) {
+    // Add the bound on the contribution from this element to the
+    // skipped contributions. The sums are stored as logarithms to avoid
+    // overflow in the exponential.
+    double m = (continuous ? centroidMeasure[elemIndex] : 1.0 * numQuadPoints);
+    double logElem = log(TacsRealPart(scale) * m) + weight * bound;
+    double hi = (logElem > logSkipped ? logElem : logSkipped);
+    double lo = (logElem > logSkipped ? logSkipped : logElem);
+    double logTotal = hi + log1p(exp(lo - hi));
+
+    // Skip the element if the skipped contributions remain below tol
+    // times the sum on this processor
+    double logLimit = log(tol * TacsRealPart(sum)) +
+                      weight * TacsRealPart(maxFail);
+    if (logTotal <= logLimit) {
+      logSkipped = logTotal;
+      skip = 1;
+    }
+  }
+
+  if (skip && ftype == TACSFunction::INTEGRATE) {
+    numSkipped++;
+  }
+
+  return skip;
+}
+
+/*
+  Record the largest spread between the maximum quadrature point
+  value and the centroid value
+*/
+void TACSFailureScreen::updateElement(int elemIndex, TacsScalar maxElemFail) {
+  if (elemIndex < 0 || elemIndex >= numElements) {
+    return;
+  }
+
+  double fc = TacsRealPart(centroidFail[elemIndex]);
+  double fmax = TacsRealPart(maxElemFail);
+  if (fc != 0.0) {
+    double s = (fmax > fc ? (fmax - fc) / fabs(fc) : 0.0);
+    if (s > spread[elemIndex]) {
+      spread[elemIndex] = s;
+    }
+  } else {
+    spread[elemIndex] = -1.0;
+  }
+}
+
+/*
+  Compute the fraction of skipped elements over all processors
+*/
+void TACSFailureScreen::reduceCount(MPI_Comm comm) {
+  int in[2], out[2];
+  in[0] = numChecked;
+  in[1] = numSkipped;
+  MPI_Allreduce(in, out, 2, MPI_INT, MPI_SUM, comm);
+
+  skippedFraction = 0.0;
+  if (out[0] > 0) {
+    skippedFraction = (1.0 * out[1]) / out[0];
+  }
+}
@@ -0,0 +1,184 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_FAILURE_SCREEN_H
+#define TACS_FAILURE_SCREEN_H
+
+#include <stdint.h>
+
+#include "TACSElement.h"
+#include "TACSFunction.h"
+
+/*
+  Screen elements out of the evaluation of an exponentially-weighted
+  failure aggregate.
+
+  Before the failure index is evaluated at each quadrature point, an
+  estimate of the upper bound of the failure index within the element
+  is computed from the failure index at the element centroid and the
+  largest relative spread between the maximum quadrature point value
+  and the centroid value recorded at the full evaluations of the
+  element:
+
+  f_bound = f_c + spreadFactor*spread*|f_c|
+
+  Elements that have not yet been fully evaluated are never skipped.
+  During the INITIALIZE pass, elements whose bound is below the current
+  maximum are skipped. This only changes the offset used in the
+  exponential, not the value of the aggregate. During the INTEGRATE
+  pass, the bound on the contribution of the element to the sum
+
+  scale*m*exp(weight*(f_bound - maxFail))
+
+  is computed, where m is the number of quadrature points for discrete
+  aggregates or the element measure for continuous aggregates. The
+  element is skipped only if the accumulated bound of all the skipped
+  elements on this processor stays below tol times the current sum.
+  The sum can only grow, so the skipped contributions change the sum
+  on all processors by a relative amount of at most tol, and the KS
+  value by at most log(1 + tol)/weight.
+
+  This bound holds only while the failure index within each skipped
+  element stays below f_bound. The spread is measured at previous
+  states, so for nonlinear failure criteria or large changes in the
+  state the estimate can be exceeded. The spread factor inflates the
+  estimate to guard against this. Since the skipped elements depend on
+  the spreads recorded at earlier evaluations, two evaluations at the
+  same state agree to within the tolerance, but not exactly. This is
+  intended for use during optimization rather than for final sizing.
+*/
+class TACSFailureScreen : public TACSObject {
+ public:
+  TACSFailureScreen(int _numElements, double _tol,
+                    double _spreadFactor = 1.5);
+  ~TACSFailureScreen();
+
+  /**
+    Set the screening tolerance
+
+    @param _tol The relative tolerance on the skipped contributions
+  */
+  void setTolerance(double _tol) { tol = _tol; }
+
+  /**
+    Get the screening tolerance
+  */
+  double getTolerance() { return tol; }
+
+  /**
+    Set the factor that inflates the recorded spread in the bound
+
+    @param _spreadFactor The spread factor (must be at least 1)
+  */
+  void setSpreadFactor(double _spreadFactor) {
+    spreadFactor = (_spreadFactor > 1.0 ? _spreadFactor : 1.0);
+  }
+
+  /**
+    Get the factor that inflates the recorded spread in the bound
+  */
+  double getSpreadFactor() { return spreadFactor; }
+
+  /**
+    Reset the stored centroid values before an INITIALIZE pass or the
+    skipped contributions and counters before an INTEGRATE pass
+
+    @param ftype The type of evaluation
+  */
+  void initPass(TACSFunction::EvaluationType ftype);
+
+  /**
+    Check whether the element can be skipped in this pass
+
+    This evaluates the failure index at the element centroid, unless
+    it was already evaluated for this element at the same time and
+    state in the INITIALIZE pass of the same evaluation. The failure
+    index is multiplied by the
+    safety factor before the bound is compared against the maximum
+    failure value.
+
+    @param ftype The type of evaluation
+    @param elemIndex The local element index
+    @param element The element
+    @param time The simulation time
+    @param scale The scale factor applied to the element contribution
+    @param safetyFactor The factor multiplying the failure index
+    @param weight The weight in the exponential aggregation
+    @param continuous Flag indicating a continuous aggregate
+    @param maxFail The current maximum failure value
+    @param sum The current sum of the exponential terms on this processor
+    @return 1 if the element can be skipped, 0 otherwise
+  */
+  int skipElement(TACSFunction::EvaluationType ftype, int elemIndex,
+                  TACSElement *element, double time, TacsScalar scale,
+                  double safetyFactor, double weight, int continuous,
+                  TacsScalar maxFail, TacsScalar sum,
+                  const TacsScalar Xpts[], const TacsScalar vars[],
+                  const TacsScalar dvars[], const TacsScalar ddvars[]);
+
+  /**
+    Record the maximum quadrature point failure value after a full
+    evaluation of the element
+
+    @param elemIndex The local element index
+    @param maxElemFail The maximum failure value (without safety factor)
+  */
+  void updateElement(int elemIndex, TacsScalar maxElemFail);
+
+  /**
+    Reduce the counters across all processors and compute the fraction
+    of elements that were skipped in the last INTEGRATE pass
+
+    @param comm The MPI communicator
+  */
+  void reduceCount(MPI_Comm comm);
+
+  /**
+    Get the fraction of elements skipped in the last INTEGRATE pass
+  */
+  double getSkippedFraction() { return skippedFraction; }
+
+ private:
+  int numElements;
+  double tol;
+  double spreadFactor;
+
+  // The centroid failure value and measure for each element
+  TacsScalar *centroidFail;
+  double *centroidMeasure;
+
+  // Flag indicating that the centroid values are from the current
+  // evaluation, and the time and hash of the element state at which
+  // they were computed
+  int *centroidCurrent;
+  double *centroidTime;
+  uint64_t *centroidKey;
+
+  // The largest relative spread of the failure index (negative if
+  // unknown)
+  double *spread;
+
+  // The log of the sum of the bounds on the skipped contributions
+  double logSkipped;
+
+  // The local counters and the global skipped fraction
+  int numChecked, numSkipped;
+  double skippedFraction;
+};
+
+#endif  // TACS_FAILURE_SCREEN_H
@@ -74,6 +74,46 @@ enum TACSFunction::StageType TACSFunction::getStageType() {
   return funcStageType;
 }
 
+/*
+  Set the stage type for the function
+*/
+void TACSFunction::setStageType(StageType _funcStages) {
+  funcStageType = _funcStages;
+}
+
+/*
+  Merge the running KS aggregates across all processors. This uses the
+  TACS_MPI_KS_SUM reduction when TACS has been initialized and
+  otherwise gathers the partial aggregates and merges them locally.
+*/
+void TACSFunction::reduceKSValue(MPI_Comm comm, double ksWeight,
+                                 TacsScalar *maxVal, TacsScalar *ksSum) {
+  if (TacsIsInitialized()) {
+    TacsScalar in[3], out[3];
+    in[0] = *maxVal;
+    in[1] = *ksSum;
+    in[2] = ksWeight;
+    MPI_Allreduce(in, out, 1, TACS_MPI_KS_TYPE, TACS_MPI_KS_SUM, comm);
+    *maxVal = out[0];
+    *ksSum = out[1];
+  } else {
+    int size;
+    MPI_Comm_size(comm, &size);
+    TacsScalar in[2];
+    in[0] = *maxVal;
+    in[1] = *ksSum;
+    TacsScalar *all = new TacsScalar[2 * size];
+    MPI_Allgather(in, 2, TACS_MPI_TYPE, all, 2, TACS_MPI_TYPE, comm);
+
+    *maxVal = all[0];
+    *ksSum = all[1];
+    for (int i = 1; i < size; i++) {
+      addKSValue(ksWeight, all[2 * i], all[2 * i + 1], maxVal, ksSum);
+    }
+    delete[] all;
+  }
+}
+
 /*
   Overwrite the domain in the function with a new set of elements.
   This reallocates the existing array if it is not long enough.
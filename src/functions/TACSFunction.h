@@ -278,7 +278,97 @@ class TACSFunction : public TACSObject {
     memset(dfdXpts, 0, 3 * numNodes * sizeof(TacsScalar));
   }
 
+  /**
+     The maximum number of components of a point-wise quantity that
+     can be used in the fused sensitivity evaluation
+  */
+  static const int MAX_POINT_QUANTITY_SIZE = 9;
+
+  /**
+     Get the point-wise quantity that is aggregated by this function
+
+     Functions that are computed solely from a single point-wise
+     quantity at the element quadrature points can return the quantity
+     type here. In this case, TACSAssembler evaluates the quantity once
+     at each quadrature point for all functions that share it, and adds
+     the sensitivities of all of these functions with a single call to
+     the element. The derivatives are obtained from
+     getElementPointQuantitySens() instead of getElementSVSens(),
+     addElementDVSens() and getElementXptSens().
+
+     @return The quantity type or -1 if the function does not support this
+  */
+  virtual int getPointQuantityType() { return -1; }
+
+  /**
+     Evaluate the derivative of the function w.r.t. the point-wise
+     quantity at each quadrature point within the element
+
+     The quantity and its derivative are stored with a stride of
+     MAX_POINT_QUANTITY_SIZE for each quadrature point. The same
+     derivative is used for the state variable, design variable and
+     node sensitivities.
+
+     @param elemIndex The local element index
+     @param element The TACSElement object
+     @param numPts The number of quadrature points
+     @param weights The quadrature weights
+     @param counts The number of defined quantities at each point
+     @param detXd The determinant of the Jacobian at each point
+     @param quantity The values of the quantity at each point
+     @param dfdq The derivative of the function w.r.t. the quantity
+     @param dfddetXd The derivative of the function w.r.t. detXd
+  */
+  virtual void getElementPointQuantitySens(
+      int elemIndex, TACSElement *element, int numPts, const double weights[],
+      const int counts[], const TacsScalar detXd[],
+      const TacsScalar quantity[], TacsScalar dfdq[], TacsScalar dfddetXd[]) {
+  }
+
  protected:
+  /**
+     Set the stage type of the function
+
+     @param _funcStages The stage type of the function
+  */
+  void setStageType(StageType _funcStages);
+
+  /**
+     Add a value to a running KS aggregate in a single pass
+
+     The sum of exp(ksWeight*(f - maxVal)) is rescaled whenever the
+     maximum value increases so that the exponent is never positive.
+
+     @param ksWeight The KS weight
+     @param value The new value f
+     @param coef The coefficient multiplying the exponential term
+     @param maxVal The running maximum value
+     @param ksSum The running sum relative to the maximum value
+  */
+  static void addKSValue(double ksWeight, TacsScalar value, TacsScalar coef,
+                         TacsScalar *maxVal, TacsScalar *ksSum) {
+    if (TacsRealPart(value) > TacsRealPart(*maxVal)) {
+      *ksSum = coef + (*ksSum) * exp(ksWeight * (*maxVal - value));
+      *maxVal = value;
+    } else {
+      *ksSum += coef * exp(ksWeight * (value - *maxVal));
+    }
+  }
+
+  /**
+     Merge the running KS aggregates from all processors
+
+     On exit, maxVal contains the global maximum value and ksSum
+     contains the global sum relative to the global maximum.
+
+     @param comm The MPI communicator
+     @param ksWeight The KS weight
+     @param maxVal The running maximum value
+     @param ksSum The running sum relative to the maximum value
+  */
+  static void reduceKSValue(MPI_Comm comm, double ksWeight,
+                            TacsScalar *maxVal, TacsScalar *ksSum);
+
   TACSAssembler *assembler;
 
  private:
@@ -32,12 +32,18 @@ TACSInducedFailure::TACSInducedFailure(TACSAssembler *_assembler, double _P)
   maxFail = -1e20;
   failNumer = 0.0;
   failDenom = 0.0;
+
+  screen = NULL;
 }
 
 /*
   Delete all the allocated data
 */
-TACSInducedFailure::~TACSInducedFailure() {}
+TACSInducedFailure::~TACSInducedFailure() {
+  if (screen) {
+    screen->decref();
+  }
+}
 
 /*
   The name of the function class
@@ -61,6 +67,33 @@ void TACSInducedFailure::setInducedType(InducedNormType type) {
   normType = type;
 }
 
+/*
+  Set the tolerance used to screen elements from the evaluation
+*/
+void TACSInducedFailure::setFailureScreening(double tol, double spreadFactor) {
+  if (tol > 0.0) {
+    if (!screen) {
+      screen = new TACSFailureScreen(assembler->getNumElements(), tol);
+      screen->incref();
+    }
+    screen->setTolerance(tol);
+    screen->setSpreadFactor(spreadFactor);
+  } else if (screen) {
+    screen->decref();
+    screen = NULL;
+  }
+}
+
+/*
+  Get the fraction of elements skipped in the last evaluation
+*/
+double TACSInducedFailure::getSkippedFraction() {
+  if (screen) {
+    return screen->getSkippedFraction();
+  }
+  return 0.0;
+}
+
 /*
   Retrieve the function name
 */
@@ -78,6 +111,10 @@ TacsScalar TACSInducedFailure::getFunctionValue() {
   Initialize the internal values stored within the KS function
 */
 void TACSInducedFailure::initEvaluation(EvaluationType ftype) {
+  if (screen) {
+    screen->initPass(ftype);
+  }
+
   if (ftype == TACSFunction::INITIALIZE) {
     maxFail = -1e20;
   } else if (ftype == TACSFunction::INTEGRATE) {
@@ -90,6 +127,10 @@ void TACSInducedFailure::initEvaluation(EvaluationType ftype) {
   Reduce the function values across all MPI processes
 */
 void TACSInducedFailure::finalEvaluation(EvaluationType ftype) {
+  if (screen && ftype == TACSFunction::INTEGRATE) {
+    screen->reduceCount(assembler->getMPIComm());
+  }
+
   if (ftype == TACSFunction::INITIALIZE) {
     // Distribute the values of the KS function computed on this domain
     TacsScalar temp = maxFail;
@@ -116,6 +157,20 @@ void TACSInducedFailure::elementWiseEval(
     EvaluationType ftype, int elemIndex, TACSElement *element, double time,
     TacsScalar scale, const TacsScalar Xpts[], const TacsScalar vars[],
     const TacsScalar dvars[], const TacsScalar ddvars[]) {
+  // Check whether the element contribution is negligible
+  int useScreen =
+      (screen && (normType == EXPONENTIAL || normType == DISCRETE_EXPONENTIAL ||
+                  normType == EXPONENTIAL_SQUARED ||
+                  normType == DISCRETE_EXPONENTIAL_SQUARED));
+  int continuous = (normType == EXPONENTIAL || normType == EXPONENTIAL_SQUARED);
+  if (useScreen &&
+      screen->skipElement(ftype, elemIndex, element, time, 1.0, 1.0, P,
+                          continuous, maxFail, failDenom, Xpts, vars, dvars,
+                          ddvars)) {
+    return;
+  }
+
+  TacsScalar maxElemFail = -1e20;
   for (int i = 0; i < element->getNumQuadraturePoints(); i++) {
     double pt[3];
     double weight = element->getQuadraturePoint(i, pt);
@@ -129,6 +184,9 @@ void TACSInducedFailure::elementWiseEval(
 
     // Check whether the quantity requested is defined or not
     if (count >= 1) {
+      if (TacsRealPart(fail) > TacsRealPart(maxElemFail)) {
+        maxElemFail = fail;
+      }
       if (ftype == TACSFunction::INITIALIZE) {
         // Set the maximum failure load
         if (TacsRealPart(fail) > TacsRealPart(maxFail)) {
@@ -171,6 +229,10 @@ void TACSInducedFailure::elementWiseEval(
       }
     }
   }
+
+  if (useScreen) {
+    screen->updateElement(elemIndex, maxElemFail);
+  }
 }
 
 /*
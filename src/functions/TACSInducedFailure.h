@@ -19,6 +19,7 @@
   Compute an aggregated function using an induced norm approach
 */
 
+#include "TACSFailureScreen.h"
 #include "TACSFunction.h"
 
 /*
@@ -75,6 +76,26 @@ class TACSInducedFailure : public TACSFunction {
   double getParameter();
   void setInducedType(InducedNormType _norm_type);
 
+  /**
+    Skip elements whose contribution to the aggregate is negligible
+
+    This only applies to the exponential norm types. Elements are
+    skipped while the sum of the bounds on their contributions stays
+    below tol times the denominator of the induced aggregate. This
+    holds only while the failure index stays below the estimated
+    bound, see TACSFailureScreen. The sensitivities are computed over
+    all elements.
+
+    @param tol The screening tolerance (a value <= 0 disables screening)
+    @param spreadFactor The factor inflating the recorded spread
+  */
+  void setFailureScreening(double tol, double spreadFactor = 1.5);
+
+  /**
+    Get the fraction of elements skipped in the last evaluation
+  */
+  double getSkippedFraction();
+
   // Set the value of the failure offset for numerical stability
   // -----------------------------------------------------------
   void setMaxFailOffset(TacsScalar _maxFail) { maxFail = _maxFail; }
@@ -138,6 +159,9 @@ class TACSInducedFailure : public TACSFunction {
   // The P in the P-norm
   double P;
 
+  // The optional element screening data
+  TACSFailureScreen *screen;
+
   // The name of the function
   static const char *funcName;
 };
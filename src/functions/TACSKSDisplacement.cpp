@@ -33,6 +33,7 @@ TACSKSDisplacement::TACSKSDisplacement(TACSAssembler *_assembler,
   dir[1] = _dir[1];
   dir[2] = _dir[2];
   alpha = _alpha;
+  singlePass = 0;
   setKSAggregationType(KS_CONTINUOUS);
 
   // Initialize the maximum displacement value and KS sum to default values
@@ -60,6 +61,21 @@ void TACSKSDisplacement::setKSAggregationType(KSAggregationType type) {
     MPI_Abort(assembler->getMPIComm(), 1);
   }
   ksType = type;
+
+  // The single-pass evaluation only applies to the KS types
+  if (singlePass && (ksType == KS_DISCRETE || ksType == KS_CONTINUOUS)) {
+    setStageType(TACSFunction::SINGLE_STAGE);
+  } else {
+    setStageType(TACSFunction::TWO_STAGE);
+  }
+}
+
+/*
+  Set whether to evaluate the function in a single pass
+*/
+void TACSKSDisplacement::setSinglePassEvaluation(int flag) {
+  singlePass = flag;
+  setKSAggregationType(ksType);
 }
 
 /*
@@ -102,6 +118,9 @@ void TACSKSDisplacement::initEvaluation(EvaluationType ftype) {
     maxDisp = -1e20;
   } else if (ftype == TACSFunction::INTEGRATE) {
     ksDispSum = 0.0;
+    if (getStageType() == TACSFunction::SINGLE_STAGE) {
+      maxDisp = -1e20;
+    }
   }
 }
 
@@ -109,7 +128,12 @@ void TACSKSDisplacement::initEvaluation(EvaluationType ftype) {
   Reduce the function values across all MPI processes
 */
 void TACSKSDisplacement::finalEvaluation(EvaluationType ftype) {
-  if (ftype == TACSFunction::INITIALIZE) {
+  if (getStageType() == TACSFunction::SINGLE_STAGE) {
+    // Merge the running maximum and sums from all processes
+    if (ftype == TACSFunction::INTEGRATE) {
+      reduceKSValue(assembler->getMPIComm(), ksWeight, &maxDisp, &ksDispSum);
+    }
+  } else if (ftype == TACSFunction::INITIALIZE) {
     // Distribute the values of the KS function computed on this domain
     TacsScalar temp = maxDisp;
     MPI_Allreduce(&temp, &maxDisp, 1, TACS_MPI_TYPE, TACS_MPI_MAX,
@@ -160,6 +184,14 @@ void TACSKSDisplacement::elementWiseEval(
         if (TacsRealPart(dispProj) > TacsRealPart(maxDisp)) {
           maxDisp = dispProj;
         }
+      } else if (getStageType() == TACSFunction::SINGLE_STAGE) {
+        // Update the running maximum and sum in a single pass
+        if (ksType == KS_DISCRETE) {
+          addKSValue(ksWeight, dispProj, scale, &maxDisp, &ksDispSum);
+        } else if (ksType == KS_CONTINUOUS) {
+          addKSValue(ksWeight, dispProj, scale * weight * detXd, &maxDisp,
+                     &ksDispSum);
+        }
       } else {
         // Add the displacement to the sum
         if (ksType == KS_DISCRETE) {
@@ -356,3 +388,58 @@ void TACSKSDisplacement::addElementDVSens(
     }
   }
 }
+
+/*
+  Get the point-wise quantity used by the fused sensitivity evaluation
+*/
+int TACSKSDisplacement::getPointQuantityType() {
+  return TACS_ELEMENT_DISPLACEMENT;
+}
+
+/*
+  Determine the derivative of the function with respect to the
+  displacement at each quadrature point in the element
+*/
+void TACSKSDisplacement::getElementPointQuantitySens(
+    int elemIndex, TACSElement *element, int numPts, const double weights[],
+    const int counts[], const TacsScalar detXd[], const TacsScalar quantity[],
+    TacsScalar dfdq[], TacsScalar dfddetXd[]) {
+  const int ld = MAX_POINT_QUANTITY_SIZE;
+
+  for (int i = 0; i < numPts; i++) {
+    const TacsScalar *dispVec = &quantity[ld * i];
+    double weight = weights[i];
+
+    // project displacement along user-defined direction
+    TacsScalar dispProj = 0.0;
+    for (int j = 0; j < counts[i]; j++) {
+      dispProj += dispVec[j] * dir[j];
+    }
+
+    TacsScalar factor = 0.0;
+    dfddetXd[i] = 0.0;
+    if (counts[i] >= 1) {
+      // Compute the sensitivity contribution
+      if (ksType == KS_DISCRETE) {
+        factor = exp(ksWeight * (dispProj - maxDisp)) / ksDispSum;
+      } else if (ksType == KS_CONTINUOUS) {
+        TacsScalar expfact = exp(ksWeight * (dispProj - maxDisp)) / ksDispSum;
+        dfddetXd[i] = weight * expfact / ksWeight;
+        factor = weight * detXd[i] * expfact;
+      } else if (ksType == PNORM_DISCRETE) {
+        TacsScalar fpow =
+            pow(fabs(TacsRealPart(dispProj / maxDisp)), ksWeight - 2.0);
+        factor = dispProj * fpow * invPnorm;
+      } else if (ksType == PNORM_CONTINUOUS) {
+        TacsScalar fpow =
+            pow(fabs(TacsRealPart(dispProj / maxDisp)), ksWeight - 2.0);
+        factor = dispProj * fpow * invPnorm * weight * detXd[i];
+        dfddetXd[i] = dispProj * fpow * invPnorm * weight;
+      }
+    }
+
+    dfdq[ld * i] = factor * dir[0];
+    dfdq[ld * i + 1] = factor * dir[1];
+    dfdq[ld * i + 2] = factor * dir[2];
+  }
+}
@@ -68,6 +68,18 @@ class TACSKSDisplacement : public TACSFunction {
   double getParameter();
   void setParameter(double _ksWeight);
 
+  /**
+    Evaluate the function in a single pass over the mesh
+
+    The maximum value and the KS sum are accumulated together and the
+    sum is rescaled whenever the maximum increases. This only applies
+    to the KS aggregation types, the p-norm types always require two
+    passes.
+
+    @param flag Flag indicating whether to use a single pass
+  */
+  void setSinglePassEvaluation(int flag);
+
   // Set the value of the displacement offset for numerical stability
   // -----------------------------------------------------------
   void setMaxDispOffset(TacsScalar _maxDisp) { maxDisp = _maxDisp; }
@@ -126,10 +138,28 @@ class TACSKSDisplacement : public TACSFunction {
                          const TacsScalar vars[], const TacsScalar dvars[],
                          const TacsScalar ddvars[], TacsScalar fXptSens[]);
 
+  /**
+     Get the point-wise quantity used in the fused sensitivity evaluation
+  */
+  int getPointQuantityType();
+
+  /**
+     Evaluate the derivative w.r.t. the quantity at each quadrature point
+  */
+  void getElementPointQuantitySens(int elemIndex, TACSElement *element,
+                                   int numPts, const double weights[],
+                                   const int counts[],
+                                   const TacsScalar detXd[],
+                                   const TacsScalar quantity[],
+                                   TacsScalar dfdq[], TacsScalar dfddetXd[]);
+
  private:
   // The type of aggregation to use
   KSAggregationType ksType;
 
+  // Flag indicating whether to use the single-pass evaluation
+  int singlePass;
+
   // The weight on the ks function value
   double ksWeight;
 
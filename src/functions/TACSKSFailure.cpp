@@ -30,6 +30,7 @@ TACSKSFailure::TACSKSFailure(TACSAssembler *_assembler, double _ksWeight,
   ksWeight = _ksWeight;
   alpha = _alpha;
   safetyFactor = _safetyFactor;
+  singlePass = 0;
   setKSAggregationType(KS_CONTINUOUS);
 
   // Initialize the maximum failure value and KS sum to default values
@@ -37,9 +38,15 @@ TACSKSFailure::TACSKSFailure(TACSAssembler *_assembler, double _ksWeight,
   maxFail = -1e20;
   ksFailSum = 0.0;
   invPnorm = 0.0;
+
+  screen = NULL;
 }
 
-TACSKSFailure::~TACSKSFailure() {}
+TACSKSFailure::~TACSKSFailure() {
+  if (screen) {
+    screen->decref();
+  }
+}
 
 /*
   TACSKSFailure function name
@@ -51,6 +58,49 @@ const char *TACSKSFailure::funcName = "TACSKSFailure";
 */
 void TACSKSFailure::setKSAggregationType(KSAggregationType type) {
   ksType = type;
+
+  // The single-pass evaluation only applies to the KS types
+  if (singlePass && (ksType == KS_DISCRETE || ksType == KS_CONTINUOUS ||
+                     ksType == KS_DISCRETE_AVERAGE)) {
+    setStageType(TACSFunction::SINGLE_STAGE);
+  } else {
+    setStageType(TACSFunction::TWO_STAGE);
+  }
+}
+
+/*
+  Set whether to evaluate the function in a single pass
+*/
+void TACSKSFailure::setSinglePassEvaluation(int flag) {
+  singlePass = flag;
+  setKSAggregationType(ksType);
+}
+
+/*
+  Set the tolerance used to screen elements from the evaluation
+*/
+void TACSKSFailure::setFailureScreening(double tol, double spreadFactor) {
+  if (tol > 0.0) {
+    if (!screen) {
+      screen = new TACSFailureScreen(assembler->getNumElements(), tol);
+      screen->incref();
+    }
+    screen->setTolerance(tol);
+    screen->setSpreadFactor(spreadFactor);
+  } else if (screen) {
+    screen->decref();
+    screen = NULL;
+  }
+}
+
+/*
+  Get the fraction of elements skipped in the last evaluation
+*/
+double TACSKSFailure::getSkippedFraction() {
+  if (screen) {
+    return screen->getSkippedFraction();
+  }
+  return 0.0;
 }
 
 /*
@@ -87,10 +137,17 @@ TacsScalar TACSKSFailure::getMaximumFailure() { return maxFail; }
   Initialize the internal values stored within the KS function
 */
 void TACSKSFailure::initEvaluation(EvaluationType ftype) {
+  if (screen) {
+    screen->initPass(ftype);
+  }
+
   if (ftype == TACSFunction::INITIALIZE) {
     maxFail = -1e20;
   } else if (ftype == TACSFunction::INTEGRATE) {
     ksFailSum = 0.0;
+    if (getStageType() == TACSFunction::SINGLE_STAGE) {
+      maxFail = -1e20;
+    }
   }
 }
 
@@ -98,7 +155,16 @@ void TACSKSFailure::initEvaluation(EvaluationType ftype) {
   Reduce the function values across all MPI processes
 */
 void TACSKSFailure::finalEvaluation(EvaluationType ftype) {
-  if (ftype == TACSFunction::INITIALIZE) {
+  if (screen && ftype == TACSFunction::INTEGRATE) {
+    screen->reduceCount(assembler->getMPIComm());
+  }
+
+  if (getStageType() == TACSFunction::SINGLE_STAGE) {
+    // Merge the running maximum and sums from all processes
+    if (ftype == TACSFunction::INTEGRATE) {
+      reduceKSValue(assembler->getMPIComm(), ksWeight, &maxFail, &ksFailSum);
+    }
+  } else if (ftype == TACSFunction::INITIALIZE) {
     // Distribute the values of the KS function computed on this domain
     TacsScalar temp = maxFail;
     MPI_Allreduce(&temp, &maxFail, 1, TACS_MPI_TYPE, TACS_MPI_MAX,
@@ -128,8 +194,19 @@ void TACSKSFailure::elementWiseEval(EvaluationType ftype, int elemIndex,
                                     const TacsScalar vars[],
                                     const TacsScalar dvars[],
                                     const TacsScalar ddvars[]) {
+  // Check whether the element contribution is negligible
+  int useScreen =
+      (screen && (ksType == KS_DISCRETE || ksType == KS_CONTINUOUS));
+  if (useScreen &&
+      screen->skipElement(ftype, elemIndex, element, time, scale, safetyFactor,
+                          ksWeight, ksType == KS_CONTINUOUS, maxFail,
+                          ksFailSum, Xpts, vars, dvars, ddvars)) {
+    return;
+  }
+
   const int numQuadPoints = element->getNumQuadraturePoints();
   TacsScalar avgFail = 0.0;
+  TacsScalar maxElemFail = -1e20;
   for (int i = 0; i < numQuadPoints; i++) {
     double pt[3];
     double weight = element->getQuadraturePoint(i, pt);
@@ -141,6 +218,10 @@ void TACSKSFailure::elementWiseEval(EvaluationType ftype, int elemIndex,
         element->evalPointQuantity(elemIndex, TACS_FAILURE_INDEX, time, i, pt,
                                    Xpts, vars, dvars, ddvars, &detXd, &fail);
 
+    if (count >= 1 && TacsRealPart(fail) > TacsRealPart(maxElemFail)) {
+      maxElemFail = fail;
+    }
+
     // Scale failure value by safety factor
     fail *= safetyFactor;
 
@@ -154,6 +235,14 @@ void TACSKSFailure::elementWiseEval(EvaluationType ftype, int elemIndex,
         if (TacsRealPart(fail) > TacsRealPart(maxFail)) {
           maxFail = fail;
         }
+      } else if (getStageType() == TACSFunction::SINGLE_STAGE) {
+        // Update the running maximum and sum in a single pass
+        if (ksType == KS_DISCRETE) {
+          addKSValue(ksWeight, fail, scale, &maxFail, &ksFailSum);
+        } else if (ksType == KS_CONTINUOUS) {
+          addKSValue(ksWeight, fail, scale * weight * detXd, &maxFail,
+                     &ksFailSum);
+        }
       } else {
         // Add the failure load to the sum
         if (ksType == KS_DISCRETE) {
@@ -178,11 +267,17 @@ void TACSKSFailure::elementWiseEval(EvaluationType ftype, int elemIndex,
       if (TacsRealPart(avgFail) > TacsRealPart(maxFail)) {
         maxFail = avgFail;
       }
+    } else if (getStageType() == TACSFunction::SINGLE_STAGE) {
+      addKSValue(ksWeight, avgFail, scale, &maxFail, &ksFailSum);
     } else if (ftype == TACSFunction::INTEGRATE) {
       TacsScalar fexp = exp(ksWeight * (avgFail - maxFail));
       ksFailSum += scale * fexp;
     }
   }
+
+  if (useScreen) {
+    screen->updateElement(elemIndex, maxElemFail);
+  }
 }
 
 /*
@@ -412,3 +507,65 @@ void TACSKSFailure::addElementDVSens(
     }
   }
 }
+
+/*
+  Get the point-wise quantity used by the fused sensitivity evaluation
+*/
+int TACSKSFailure::getPointQuantityType() { return TACS_FAILURE_INDEX; }
+
+/*
+  Determine the derivative of the function with respect to the failure
+  index at each quadrature point in the element. This uses the failure
+  values computed by TACSAssembler and gives the same derivatives as
+  the element-wise sensitivity routines above.
+*/
+void TACSKSFailure::getElementPointQuantitySens(
+    int elemIndex, TACSElement *element, int numPts, const double weights[],
+    const int counts[], const TacsScalar detXd[], const TacsScalar quantity[],
+    TacsScalar dfdq[], TacsScalar dfddetXd[]) {
+  const int ld = MAX_POINT_QUANTITY_SIZE;
+  TacsScalar avgFail = 0.0;
+
+  if (ksType == KS_DISCRETE_AVERAGE) {
+    for (int i = 0; i < numPts; i++) {
+      avgFail += safetyFactor * quantity[ld * i] / (double)numPts;
+    }
+  }
+
+  for (int i = 0; i < numPts; i++) {
+    // Scale failure value by safety factor
+    TacsScalar fail = safetyFactor * quantity[ld * i];
+    double weight = weights[i];
+
+    dfdq[ld * i] = 0.0;
+    dfddetXd[i] = 0.0;
+
+    if (counts[i] >= 1) {
+      // Compute the sensitivity contribution
+      TacsScalar q = 0.0, qdetXd = 0.0;
+      if (ksType == KS_DISCRETE) {
+        q = exp(ksWeight * (fail - maxFail)) / ksFailSum;
+      } else if (ksType == KS_CONTINUOUS) {
+        TacsScalar expfact = exp(ksWeight * (fail - maxFail)) / ksFailSum;
+        qdetXd = weight * expfact / ksWeight;
+        q = weight * detXd[i] * expfact;
+      } else if (ksType == PNORM_DISCRETE) {
+        TacsScalar fpow =
+            pow(fabs(TacsRealPart(fail / maxFail)), ksWeight - 2.0);
+        q = fail * fpow * invPnorm;
+      } else if (ksType == PNORM_CONTINUOUS) {
+        TacsScalar fpow =
+            pow(fabs(TacsRealPart(fail / maxFail)), ksWeight - 2.0);
+        q = fail * fpow * invPnorm * weight * detXd[i];
+        qdetXd = fail * fpow * invPnorm * weight;
+      } else if (ksType == KS_DISCRETE_AVERAGE) {
+        q = exp(ksWeight * (avgFail - maxFail)) / ksFailSum;
+        q /= (double)numPts;
+      }
+
+      // Scale failure sens by safety factor
+      dfdq[ld * i] = safetyFactor * q;
+      dfddetXd[i] = qdetXd;
+    }
+  }
+}
@@ -23,6 +23,7 @@
   Compute the KS function in TACS
 */
 
+#include "TACSFailureScreen.h"
 #include "TACSFunction.h"
 
 /*
@@ -69,6 +70,42 @@ class TACSKSFailure : public TACSFunction {
   double getParameter();
   void setParameter(double _ksWeight);
 
+  /**
+    Evaluate the function in a single pass over the mesh
+
+    The maximum value and the KS sum are accumulated together and the
+    sum is rescaled whenever the maximum increases. This only applies
+    to the KS aggregation types, the p-norm types always require two
+    passes.
+
+    @param flag Flag indicating whether to use a single pass
+  */
+  void setSinglePassEvaluation(int flag);
+
+  /**
+    Skip elements whose contribution to the KS aggregate is negligible
+
+    The failure index is first evaluated at the element centroid and
+    an estimate of the upper bound within the element is formed using
+    the spread recorded at the full evaluations of the element.
+    Elements are skipped while the sum of the bounds on their
+    contributions stays below tol times the KS sum, so that the KS
+    value changes by at most log(1 + tol)/ksWeight. This holds only
+    while the failure index stays below the estimated bound, see
+    TACSFailureScreen. This only applies to the KS_DISCRETE and
+    KS_CONTINUOUS aggregation types. The sensitivities are computed
+    over all elements.
+
+    @param tol The screening tolerance (a value <= 0 disables screening)
+    @param spreadFactor The factor inflating the recorded spread
+  */
+  void setFailureScreening(double tol, double spreadFactor = 1.5);
+
+  /**
+    Get the fraction of elements skipped in the last evaluation
+  */
+  double getSkippedFraction();
+
   // Set the value of the failure offset for numerical stability
   // -----------------------------------------------------------
   void setMaxFailOffset(TacsScalar _maxFail) { maxFail = _maxFail; }
@@ -127,10 +164,28 @@ class TACSKSFailure : public TACSFunction {
                          const TacsScalar vars[], const TacsScalar dvars[],
                          const TacsScalar ddvars[], TacsScalar fXptSens[]);
 
+  /**
+     Get the point-wise quantity used in the fused sensitivity evaluation
+  */
+  int getPointQuantityType();
+
+  /**
+     Evaluate the derivative w.r.t. the quantity at each quadrature point
+  */
+  void getElementPointQuantitySens(int elemIndex, TACSElement *element,
+                                   int numPts, const double weights[],
+                                   const int counts[],
+                                   const TacsScalar detXd[],
+                                   const TacsScalar quantity[],
+                                   TacsScalar dfdq[], TacsScalar dfddetXd[]);
+
  private:
   // The type of aggregation to use
   KSAggregationType ksType;
 
+  // Flag indicating whether to use the single-pass evaluation
+  int singlePass;
+
   // The weight on the ks function value
   double ksWeight;
 
@@ -150,6 +205,9 @@ class TACSKSFailure : public TACSFunction {
   // Used for the case when this is used to evaluate the p-norm
   TacsScalar invPnorm;
 
+  // The optional element screening data
+  TACSFailureScreen *screen;
+
   /**
      Compute the average failure value over all quadrature points
   */
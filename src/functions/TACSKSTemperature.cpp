@@ -29,6 +29,7 @@ TACSKSTemperature::TACSKSTemperature(TACSAssembler *_assembler,
                    TACSFunction::TWO_STAGE, 0) {
   ksWeight = _ksWeight;
   alpha = _alpha;
+  singlePass = 0;
   setKSAggregationType(KS_CONTINUOUS);
 
   // Initialize the maximum temperature value and KS sum to default values
@@ -56,6 +57,21 @@ void TACSKSTemperature::setKSAggregationType(KSAggregationType type) {
     MPI_Abort(assembler->getMPIComm(), 1);
   }
   ksType = type;
+
+  // The single-pass evaluation only applies to the KS types
+  if (singlePass && (ksType == KS_DISCRETE || ksType == KS_CONTINUOUS)) {
+    setStageType(TACSFunction::SINGLE_STAGE);
+  } else {
+    setStageType(TACSFunction::TWO_STAGE);
+  }
+}
+
+/*
+  Set whether to evaluate the function in a single pass
+*/
+void TACSKSTemperature::setSinglePassEvaluation(int flag) {
+  singlePass = flag;
+  setKSAggregationType(ksType);
 }
 
 /*
@@ -96,6 +112,9 @@ void TACSKSTemperature::initEvaluation(EvaluationType ftype) {
     maxTemp = -1e20;
   } else if (ftype == TACSFunction::INTEGRATE) {
     ksTempSum = 0.0;
+    if (getStageType() == TACSFunction::SINGLE_STAGE) {
+      maxTemp = -1e20;
+    }
   }
 }
 
@@ -103,7 +122,12 @@ void TACSKSTemperature::initEvaluation(EvaluationType ftype) {
   Reduce the function values across all MPI processes
 */
 void TACSKSTemperature::finalEvaluation(EvaluationType ftype) {
-  if (ftype == TACSFunction::INITIALIZE) {
+  if (getStageType() == TACSFunction::SINGLE_STAGE) {
+    // Merge the running maximum and sums from all processes
+    if (ftype == TACSFunction::INTEGRATE) {
+      reduceKSValue(assembler->getMPIComm(), ksWeight, &maxTemp, &ksTempSum);
+    }
+  } else if (ftype == TACSFunction::INITIALIZE) {
     // Distribute the values of the KS function computed on this domain
     TacsScalar temp = maxTemp;
     MPI_Allreduce(&temp, &maxTemp, 1, TACS_MPI_TYPE, TACS_MPI_MAX,
@@ -149,6 +173,14 @@ void TACSKSTemperature::elementWiseEval(
         if (TacsRealPart(temperature) > TacsRealPart(maxTemp)) {
           maxTemp = temperature;
         }
+      } else if (getStageType() == TACSFunction::SINGLE_STAGE) {
+        // Update the running maximum and sum in a single pass
+        if (ksType == KS_DISCRETE) {
+          addKSValue(ksWeight, temperature, scale, &maxTemp, &ksTempSum);
+        } else if (ksType == KS_CONTINUOUS) {
+          addKSValue(ksWeight, temperature, scale * weight * detXd, &maxTemp,
+                     &ksTempSum);
+        }
       } else {
         // Add the temperature to the sum
         if (ksType == KS_DISCRETE) {
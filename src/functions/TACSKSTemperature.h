@@ -60,6 +60,18 @@ class TACSKSTemperature : public TACSFunction {
   double getParameter();
   void setParameter(double _ksWeight);
 
+  /**
+    Evaluate the function in a single pass over the mesh
+
+    The maximum value and the KS sum are accumulated together and the
+    sum is rescaled whenever the maximum increases. This only applies
+    to the KS aggregation types, the p-norm types always require two
+    passes.
+
+    @param flag Flag indicating whether to use a single pass
+  */
+  void setSinglePassEvaluation(int flag);
+
   // Set the value of the temperature offset for numerical stability
   // -----------------------------------------------------------
   void setMaxTempOffset(TacsScalar _maxTemp) { maxTemp = _maxTemp; }
@@ -122,6 +134,9 @@ class TACSKSTemperature : public TACSFunction {
   // The type of aggregation to use
   KSAggregationType ksType;
 
+  // Flag indicating whether to use the single-pass evaluation
+  int singlePass;
+
   // The weight on the ks function value
   double ksWeight;
 
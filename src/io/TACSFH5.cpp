@@ -18,6 +18,22 @@
 
 #include "TACSFH5.h"
 
+#include <math.h>
+#include <stdint.h>
+
+#include "TACSFH5Compress.h"
+
+/*
+  The largest codes of the quantized storage are reserved for the
+  non-finite values: the largest code stores NaN and the next two
+  store +inf and -inf.
+*/
+static const uint32_t FH5_QUANTIZED_NUM_RESERVED = 3;
+
+static inline uint32_t TacsFH5MaxCode(size_t code_size) {
+  return (code_size == sizeof(uint16_t) ? 65535u : 4294967295u);
+}
+
 /**
    Create the FH5 object with the given communicator
 
@@ -29,6 +45,8 @@ TACSFH5File::TACSFH5File(MPI_Comm _comm) {
   file_offset = 0;
   file_end = 0;
   file_for_writing = 0;
+  compression = FH5_NO_COMPRESSION;
+  tol = 0.0;
 
   rfp = NULL;
   current = root = tip = NULL;
@@ -179,6 +197,14 @@ int TACSFH5File::createFile(const char *file_name, int num_components,
    data (double) or (int)
 
    dim1*dim2*sizeof(double)/sizeof(int)
+
+   When compression is active, the compression type is stored in the
+   upper bits of the data type entry and the data is replaced by a
+   chunk table followed by the encoded chunk from each processor:
+
+   number of chunks (int64)
+   rows, bytes for each chunk (int64, int64)
+   encoded chunks (char)
 */
 int TACSFH5File::writeZoneData(char *zone_name, char *var_names,
                                FH5DataType data_name, int dim1, int dim2,
@@ -211,12 +237,20 @@ int TACSFH5File::writeZoneData(char *zone_name, char *var_names,
     MPI_File_set_view(fp, file_offset, MPI_CHAR, MPI_CHAR, datarep,
                       MPI_INFO_NULL);
 
+    // Lossy storage only applies to floating point data
+    int comp = compression;
+    if (data_name == FH5_INT && comp != FH5_NO_COMPRESSION) {
+      comp = FH5_LOSSLESS;
+    } else if (comp == FH5_QUANTIZED && !(tol > 0.0)) {
+      comp = FH5_LOSSLESS;
+    }
+
     // Write the header for this zone just on the root processor
     if (rank == 0) {
       // Allocate the pre-header to use
       char *pre_header = new char[header_len];
       int pre_int[5];
-      pre_int[0] = data_name;
+      pre_int[0] = data_name | (comp << 8);
       pre_int[1] = total_dim;
       pre_int[2] = dim2;
       pre_int[3] = strlen(zone_name) + 1;
@@ -238,6 +272,49 @@ int TACSFH5File::writeZoneData(char *zone_name, char *var_names,
     // Increment the global file-offset to match
     file_offset += header_len;
 
+    if (comp != FH5_NO_COMPRESSION) {
+      // Encode the local chunk of data
+      unsigned char *buffer = NULL;
+      int64_t nbytes = encodeChunk(data_name, comp, dim1, dim2, data, &buffer);
+
+      // Gather the chunk table on all processors
+      int64_t local[2];
+      local[0] = dim1;
+      local[1] = nbytes;
+      int64_t *table = new int64_t[2 * size + 1];
+      table[0] = size;
+      MPI_Allgather(local, 2, MPI_INT64_T, &table[1], 2, MPI_INT64_T, comm);
+      size_t table_len = (2 * size + 1) * sizeof(int64_t);
+
+      // Write the chunk table from the root processor
+      if (rank == 0) {
+        MPI_File_write(fp, table, table_len, MPI_CHAR, MPI_STATUS_IGNORE);
+      }
+
+      // Compute the offset for this chunk and the total size
+      MPI_Offset chunk_offset = 0, total_bytes = 0;
+      for (int k = 0; k < size; k++) {
+        if (k < rank) {
+          chunk_offset += table[2 * k + 2];
+        }
+        total_bytes += table[2 * k + 2];
+      }
+
+      MPI_File_set_view(fp, file_offset + table_len, MPI_CHAR, MPI_CHAR,
+                        datarep, MPI_INFO_NULL);
+      MPI_File_write_at_all(fp, chunk_offset, buffer, nbytes, MPI_CHAR,
+                            MPI_STATUS_IGNORE);
+      file_offset += table_len + total_bytes;
+
+      delete[] table;
+      delete[] buffer;
+      if (dim_count) {
+        delete[] dim_count;
+      }
+
+      return 1;
+    }
+
     // Prepare to read in the data
     MPI_Datatype dtype = MPI_DOUBLE;
     if (data_name == FH5_INT) {
@@ -269,6 +346,338 @@ int TACSFH5File::writeZoneData(char *zone_name, char *var_names,
   return 0;
 }
 
+/**
+   Set the storage option for the zones written after this call
+
+   Lossless compression applies a byte shuffle followed by an LZ-style
+   codec. Half precision storage shifts and scales each column of
+   floating point data by its mid-point and a power of two before
+   converting it to IEEE half precision, so the absolute error is
+   bounded by 2^-11 times the half-range of the column. Quantized
+   storage converts each column of floating point data to integers
+   such that the absolute error is bounded by tol times the range of
+   the finite values in the column. Non-finite values are stored
+   exactly by both lossy options. Integer data is always stored
+   without loss.
+
+   @param _compression The type of compression to apply
+   @param _tol The relative error tolerance for quantized storage
+*/
+void TACSFH5File::setCompression(FH5Compression _compression, double _tol) {
+  compression = _compression;
+  tol = _tol;
+}
+
+/**
+   Encode a chunk of data for the compressed storage options
+
+   The chunk consists of an optional header with the offset and scale
+   of each column for the lossy options, a flag indicating whether the
+   LZ codec was applied, and the byte-shuffled data itself.
+
+   @param dtype The type of data
+   @param comp The compression type to apply
+   @param rows The number of rows in this chunk
+   @param dim2 The number of columns
+   @param data The data
+   @param buffer The newly allocated encoded buffer
+   @return The length of the encoded buffer in bytes
+*/
+size_t TACSFH5File::encodeChunk(int dtype, int comp, int rows, int dim2,
+                                const void *data, unsigned char **buffer) {
+  size_t n = (size_t)rows * dim2;
+  size_t elem_size = sizeof(double);
+  if (dtype == FH5_INT) {
+    elem_size = sizeof(int);
+  } else if (dtype == FH5_FLOAT) {
+    elem_size = sizeof(float);
+  }
+
+  // Set the pre-header and the values that will be shuffled
+  size_t pre_len = 0;
+  unsigned char *pre = NULL;
+  size_t code_size = elem_size;
+  unsigned char *codes = NULL;
+
+  if (comp == FH5_HALF_PRECISION) {
+    // Compute the offset and scale for each column. The offset is the
+    // mid-point of the finite values in the column and the scale is a
+    // power of two that maps the half-range below 2^15 so that no
+    // value overflows the half precision range.
+    double *center = new double[2 * dim2];
+    double *scale = &center[dim2];
+    for (int j = 0; j < dim2; j++) {
+      int first = 1;
+      double lower = 0.0, upper = 0.0;
+      for (int i = 0; i < rows; i++) {
+        double x = (dtype == FH5_FLOAT ? ((const float *)data)[dim2 * i + j]
+                                       : ((const double *)data)[dim2 * i + j]);
+        if (x - x == 0.0) {
+          if (first || x < lower) {
+            lower = x;
+          }
+          if (first || x > upper) {
+            upper = x;
+          }
+          first = 0;
+        }
+      }
+      center[j] = 0.5 * (upper + lower);
+      scale[j] = 1.0;
+      if (upper > lower) {
+        int exponent;
+        frexp(0.5 * (upper - lower), &exponent);
+        scale[j] = ldexp(1.0, exponent - 15);
+      }
+    }
+
+    pre_len = 2 * dim2 * sizeof(double);
+    pre = new unsigned char[pre_len];
+    memcpy(pre, center, pre_len);
+
+    code_size = sizeof(unsigned short);
+    unsigned short *h = new unsigned short[n];
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < dim2; j++) {
+        double x = (dtype == FH5_FLOAT ? ((const float *)data)[dim2 * i + j]
+                                       : ((const double *)data)[dim2 * i + j]);
+        h[dim2 * i + j] = TacsFH5FloatToHalf((x - center[j]) / scale[j]);
+      }
+    }
+    codes = (unsigned char *)h;
+    delete[] center;
+  } else if (comp == FH5_QUANTIZED) {
+    // Compute the offset and step size for each column from the
+    // range of the finite values in the column
+    double *xmin = new double[2 * dim2];
+    double *step = &xmin[dim2];
+    double max_level = 0.0;
+    for (int j = 0; j < dim2; j++) {
+      int first = 1;
+      double lower = 0.0, upper = 0.0;
+      for (int i = 0; i < rows; i++) {
+        double x = (dtype == FH5_FLOAT ? ((const float *)data)[dim2 * i + j]
+                                       : ((const double *)data)[dim2 * i + j]);
+        if (x - x == 0.0) {
+          if (first || x < lower) {
+            lower = x;
+          }
+          if (first || x > upper) {
+            upper = x;
+          }
+          first = 0;
+        }
+      }
+      xmin[j] = lower;
+      step[j] = 2.0 * tol * (upper - lower);
+      if (step[j] > 0.0) {
+        double level = ceil((upper - lower) / step[j]);
+        if (level > max_level) {
+          max_level = level;
+        }
+      } else {
+        step[j] = 0.0;
+      }
+    }
+
+    // Use 16-bit integers unless more levels are required. Tolerances
+    // below the 32-bit resolution are limited to that resolution. The
+    // reserved codes are never used for finite values.
+    const double max_code16 = 65535.0 - FH5_QUANTIZED_NUM_RESERVED;
+    const double max_code32 = 4294967295.0 - FH5_QUANTIZED_NUM_RESERVED;
+    code_size = sizeof(uint16_t);
+    if (max_level > max_code16) {
+      code_size = sizeof(uint32_t);
+      if (max_level > max_code32) {
+        for (int j = 0; j < dim2; j++) {
+          step[j] *= max_level / (max_code32 - 1.0);
+        }
+      }
+    }
+    const uint32_t max_code = TacsFH5MaxCode(code_size);
+
+    int csize = code_size;
+    pre_len = sizeof(int) + 2 * dim2 * sizeof(double);
+    pre = new unsigned char[pre_len];
+    memcpy(pre, &csize, sizeof(int));
+    memcpy(&pre[sizeof(int)], xmin, 2 * dim2 * sizeof(double));
+
+    codes = new unsigned char[n * code_size];
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < dim2; j++) {
+        double x = (dtype == FH5_FLOAT ? ((const float *)data)[dim2 * i + j]
+                                       : ((const double *)data)[dim2 * i + j]);
+        uint32_t c = 0;
+        if (x != x) {
+          c = max_code;
+        } else if (x - x != 0.0) {
+          c = (x > 0.0 ? max_code - 1 : max_code - 2);
+        } else if (step[j] > 0.0) {
+          c = (uint32_t)floor((x - xmin[j]) / step[j] + 0.5);
+        }
+        size_t index = (size_t)dim2 * i + j;
+        if (code_size == sizeof(uint16_t)) {
+          ((uint16_t *)codes)[index] = (uint16_t)c;
+        } else {
+          ((uint32_t *)codes)[index] = c;
+        }
+      }
+    }
+    delete[] xmin;
+  }
+
+  // Shuffle the bytes
+  size_t len = n * code_size;
+  unsigned char *shuffled = new unsigned char[len];
+  TacsFH5ByteShuffle(n, code_size,
+                     (codes ? codes : (const unsigned char *)data), shuffled);
+  if (codes) {
+    delete[] codes;
+  }
+
+  // Compress the shuffled bytes and store them unless the codec
+  // fails to reduce the size of the data
+  unsigned char *out =
+      new unsigned char[pre_len + 1 + TacsFH5LZCompressBound(len)];
+  if (pre) {
+    memcpy(out, pre, pre_len);
+    delete[] pre;
+  }
+  size_t clen = TacsFH5LZCompress(len, shuffled, &out[pre_len + 1]);
+  if (clen < len) {
+    out[pre_len] = 1;
+  } else {
+    out[pre_len] = 0;
+    memcpy(&out[pre_len + 1], shuffled, len);
+    clen = len;
+  }
+  delete[] shuffled;
+
+  *buffer = out;
+  return pre_len + 1 + clen;
+}
+
+/**
+   Decode a chunk of data created by encodeChunk
+
+   @param dtype The type of data
+   @param comp The compression type that was applied
+   @param rows The number of rows in this chunk
+   @param dim2 The number of columns
+   @param nbytes The length of the encoded buffer
+   @param buffer The encoded buffer
+   @param data The output data
+   @return 0 on success, 1 on failure
+*/
+int TACSFH5File::decodeChunk(int dtype, int comp, int rows, int dim2,
+                             size_t nbytes, const unsigned char *buffer,
+                             void *data) {
+  size_t n = (size_t)rows * dim2;
+  size_t elem_size = sizeof(double);
+  if (dtype == FH5_INT) {
+    elem_size = sizeof(int);
+  } else if (dtype == FH5_FLOAT) {
+    elem_size = sizeof(float);
+  }
+
+  // Read the pre-header
+  size_t pre_len = 0;
+  size_t code_size = elem_size;
+  double *xmin = NULL;
+  if (comp == FH5_HALF_PRECISION) {
+    code_size = sizeof(unsigned short);
+    pre_len = 2 * dim2 * sizeof(double);
+    if (nbytes < pre_len) {
+      return 1;
+    }
+    xmin = new double[2 * dim2];
+    memcpy(xmin, buffer, pre_len);
+  } else if (comp == FH5_QUANTIZED) {
+    int csize = 0;
+    pre_len = sizeof(int) + 2 * dim2 * sizeof(double);
+    if (nbytes < pre_len) {
+      return 1;
+    }
+    memcpy(&csize, buffer, sizeof(int));
+    code_size = csize;
+    if (code_size != sizeof(uint16_t) && code_size != sizeof(uint32_t)) {
+      return 1;
+    }
+    xmin = new double[2 * dim2];
+    memcpy(xmin, &buffer[sizeof(int)], 2 * dim2 * sizeof(double));
+  }
+
+  if (nbytes < pre_len + 1) {
+    if (xmin) {
+      delete[] xmin;
+    }
+    return 1;
+  }
+
+  // Decompress the shuffled bytes
+  size_t len = n * code_size;
+  unsigned char *shuffled = new unsigned char[len];
+  const unsigned char *payload = &buffer[pre_len + 1];
+  size_t clen = nbytes - pre_len - 1;
+  int fail = 0;
+  if (buffer[pre_len] == 1) {
+    fail = TacsFH5LZDecompress(clen, payload, len, shuffled);
+  } else if (clen == len) {
+    memcpy(shuffled, payload, len);
+  } else {
+    fail = 1;
+  }
+
+  if (!fail) {
+    if (comp == FH5_LOSSLESS) {
+      TacsFH5ByteUnshuffle(n, code_size, shuffled, (unsigned char *)data);
+    } else {
+      unsigned char *codes = new unsigned char[len];
+      TacsFH5ByteUnshuffle(n, code_size, shuffled, codes);
+
+      for (size_t index = 0; index < n; index++) {
+        double x = 0.0;
+        int j = index % dim2;
+        if (comp == FH5_HALF_PRECISION) {
+          x = xmin[j] +
+              xmin[dim2 + j] *
+                  TacsFH5HalfToFloat(((unsigned short *)codes)[index]);
+        } else {
+          uint32_t c = 0;
+          if (code_size == sizeof(uint16_t)) {
+            c = ((uint16_t *)codes)[index];
+          } else {
+            c = ((uint32_t *)codes)[index];
+          }
+          uint32_t max_code = TacsFH5MaxCode(code_size);
+          if (c == max_code) {
+            x = NAN;
+          } else if (c == max_code - 1) {
+            x = INFINITY;
+          } else if (c == max_code - 2) {
+            x = -INFINITY;
+          } else {
+            x = xmin[j] + c * xmin[dim2 + j];
+          }
+        }
+        if (dtype == FH5_FLOAT) {
+          ((float *)data)[index] = x;
+        } else {
+          ((double *)data)[index] = x;
+        }
+      }
+      delete[] codes;
+    }
+  }
+
+  delete[] shuffled;
+  if (xmin) {
+    delete[] xmin;
+  }
+
+  return fail;
+}
+
 /**
    Close the file
 */
@@ -417,8 +826,10 @@ int TACSFH5File::scanFH5File() {
       return 1;
     }
 
-    // Record the type of data - one of the FH5DataNames
-    tip->dtype = header[0];
+    // Record the type of data - one of the FH5DataNames - and the
+    // compression type stored in the upper bits
+    tip->dtype = header[0] & 0xff;
+    tip->compression = header[0] >> 8;
     tip->dim1 = header[1];
     tip->dim2 = header[2];
 
@@ -433,7 +844,26 @@ int TACSFH5File::scanFH5File() {
     // Record the file position
     file_pos = ftell(rfp);
     tip->data_offset = file_pos;
-    if (tip->dtype == FH5_INT) {
+    if (tip->compression != FH5_NO_COMPRESSION) {
+      // Skip over the chunk table and the encoded chunks
+      int64_t nchunks = 0;
+      if (fread(&nchunks, sizeof(int64_t), 1, rfp) != 1 || nchunks < 0) {
+        fprintf(stderr, "FH5: Error reading chunk table\n");
+        return 1;
+      }
+      int64_t *table = new int64_t[2 * nchunks];
+      if (fread(table, sizeof(int64_t), 2 * nchunks, rfp) !=
+          (size_t)(2 * nchunks)) {
+        fprintf(stderr, "FH5: Error reading chunk table\n");
+        delete[] table;
+        return 1;
+      }
+      file_pos += (2 * nchunks + 1) * sizeof(int64_t);
+      for (int64_t k = 0; k < nchunks; k++) {
+        file_pos += table[2 * k + 1];
+      }
+      delete[] table;
+    } else if (tip->dtype == FH5_INT) {
       file_pos += sizeof(int) * tip->dim1 * tip->dim2;
     } else if (tip->dtype == FH5_FLOAT) {
       file_pos += sizeof(float) * tip->dim1 * tip->dim2;
@@ -547,8 +977,72 @@ int TACSFH5File::getZoneData(const char **zone_name, const char **var_names,
     *dim2 = current->dim2;
   }
 
-  size_t len = current->dim1 * current->dim2;
-  if (dtype == FH5_INT) {
+  size_t len = (size_t)current->dim1 * current->dim2;
+  if (current->compression != FH5_NO_COMPRESSION) {
+    size_t elem_size = sizeof(double);
+    if (dtype == FH5_INT) {
+      elem_size = sizeof(int);
+    } else if (dtype == FH5_FLOAT) {
+      elem_size = sizeof(float);
+    }
+    if (_dtype) {
+      *_dtype = (FH5DataType)dtype;
+    }
+    if (data) {
+      // Read in the chunk table
+      int64_t nchunks = 0;
+      if (fread(&nchunks, sizeof(int64_t), 1, rfp) != 1 || nchunks < 0) {
+        fprintf(stderr, "FH5: Error reading chunk table\n");
+        return 0;
+      }
+      int64_t *table = new int64_t[2 * nchunks];
+      if (fread(table, sizeof(int64_t), 2 * nchunks, rfp) !=
+          (size_t)(2 * nchunks)) {
+        fprintf(stderr, "FH5: Error reading chunk table\n");
+        delete[] table;
+        return 0;
+      }
+
+      // Allocate the data using the type-specific allocation so that
+      // the data can be freed by the caller
+      if (dtype == FH5_INT) {
+        *data = new int[len];
+      } else if (dtype == FH5_FLOAT) {
+        *data = new float[len];
+      } else {
+        *data = new double[len];
+      }
+
+      // Decode each of the chunks in turn
+      char *ptr = (char *)(*data);
+      size_t row = 0;
+      int fail = 0;
+      for (int64_t k = 0; k < nchunks && !fail; k++) {
+        int rows = table[2 * k];
+        size_t nbytes = table[2 * k + 1];
+        if (row + rows > (size_t)current->dim1) {
+          fail = 1;
+          break;
+        }
+        unsigned char *buffer = new unsigned char[nbytes];
+        if (fread(buffer, sizeof(unsigned char), nbytes, rfp) != nbytes) {
+          fail = 1;
+        } else {
+          fail = decodeChunk(dtype, current->compression, rows, current->dim2,
+                             nbytes, buffer,
+                             &ptr[row * current->dim2 * elem_size]);
+        }
+        delete[] buffer;
+        row += rows;
+      }
+      delete[] table;
+
+      if (fail) {
+        fprintf(stderr, "FH5: Error decompressing zone data\n");
+        return 0;
+      }
+    }
+  } else if (dtype == FH5_INT) {
     if (_dtype) {
       *_dtype = FH5_INT;
     }
@@ -32,6 +32,15 @@ class TACSFH5File : public TACSObject {
   // for backwards compatibility
   enum FH5DataType { FH5_INT = 0, FH5_DOUBLE = 1, FH5_FLOAT = 2 };
 
+  // Storage options for the zone data. Integer zones always fall back
+  // to lossless compression when a lossy option is selected.
+  enum FH5Compression {
+    FH5_NO_COMPRESSION = 0,
+    FH5_LOSSLESS = 1,
+    FH5_HALF_PRECISION = 2,
+    FH5_QUANTIZED = 3
+  };
+
   // Create the FH5 object
   TACSFH5File(MPI_Comm _comm);
   ~TACSFH5File();
@@ -43,6 +52,9 @@ class TACSFH5File : public TACSObject {
                     int dim1, int dim2, void *data, int *dim1_range = NULL);
   void close();
 
+  // Set the storage option applied to subsequent zones
+  void setCompression(FH5Compression _compression, double _tol = 0.0);
+
   // Open a file for reading input
   int openFile(const char *file_name);
 
@@ -67,6 +79,7 @@ class TACSFH5File : public TACSObject {
       next = NULL;
       var_names = NULL;
       dtype = -1;
+      compression = FH5_NO_COMPRESSION;
       dim1 = dim2 = 0;
       data_offset = 0;
     }
@@ -79,6 +92,7 @@ class TACSFH5File : public TACSObject {
       }
     }
     int dtype;
+    int compression;
     char *zone_name;
     char *var_names;
     int dim1, dim2;
@@ -90,6 +104,12 @@ class TACSFH5File : public TACSObject {
   int scanFH5File();
   void deleteFH5FileInfo();
 
+  // Encode/decode a chunk of compressed zone data
+  size_t encodeChunk(int dtype, int comp, int rows, int dim2,
+                     const void *data, unsigned char **buffer);
+  int decodeChunk(int dtype, int comp, int rows, int dim2, size_t nbytes,
+                  const unsigned char *buffer, void *data);
+
   int num_comp;       // The number of components
   char **comp_names;  // The component names
 
@@ -99,6 +119,10 @@ class TACSFH5File : public TACSObject {
   MPI_Offset file_offset;  // The offset into the file
   MPI_Offset file_end;     // The offset at the end of the file
 
+  // Storage options for the zones written to the file
+  FH5Compression compression;  // The compression type
+  double tol;                  // Relative error tolerance for quantization
+
   // Serial file containing the FE solution
   FILE *rfp;
 };
@@ -0,0 +1,283 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#include "TACSFH5Compress.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+  Parameters for the LZ codec. The stream is a series of sequences,
+  each consisting of a token byte, the literal bytes and a back
+  reference. The high nibble of the token stores the number of
+  literals and the low nibble stores the match length minus
+  LZ_MIN_MATCH. A nibble value of 15 indicates that the length is
+  continued in the following bytes (255 indicates more bytes follow).
+  The final sequence contains only literals.
+*/
+static const size_t LZ_MIN_MATCH = 4;
+static const size_t LZ_MAX_OFFSET = 65535;
+static const int LZ_HASH_LOG = 16;
+
+static inline uint32_t TacsFH5Read32(const unsigned char *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(uint32_t));
+  return v;
+}
+
+static inline uint32_t TacsFH5Hash(uint32_t seq) {
+  return (seq * 2654435761U) >> (32 - LZ_HASH_LOG);
+}
+
+static inline unsigned char *TacsFH5WriteLength(unsigned char *op,
+                                                size_t len) {
+  while (len >= 255) {
+    *op++ = 255;
+    len -= 255;
+  }
+  *op++ = (unsigned char)len;
+  return op;
+}
+
+void TacsFH5ByteShuffle(size_t nelems, size_t elem_size,
+                        const unsigned char *in, unsigned char *out) {
+  for (size_t b = 0; b < elem_size; b++) {
+    unsigned char *o = &out[b * nelems];
+    const unsigned char *p = &in[b];
+    for (size_t i = 0; i < nelems; i++, p += elem_size) {
+      o[i] = *p;
+    }
+  }
+}
+
+void TacsFH5ByteUnshuffle(size_t nelems, size_t elem_size,
+                          const unsigned char *in, unsigned char *out) {
+  for (size_t b = 0; b < elem_size; b++) {
+    const unsigned char *p = &in[b * nelems];
+    unsigned char *o = &out[b];
+    for (size_t i = 0; i < nelems; i++, o += elem_size) {
+      *o = p[i];
+    }
+  }
+}
+
+size_t TacsFH5LZCompressBound(size_t len) { return len + len / 255 + 16; }
+
+size_t TacsFH5LZCompress(size_t len, const unsigned char *in,
+                         unsigned char *out) {
+  const size_t hash_size = (size_t)1 << LZ_HASH_LOG;
+  int64_t *table = new int64_t[hash_size];
+  for (size_t i = 0; i < hash_size; i++) {
+    table[i] = -1;
+  }
+
+  unsigned char *op = out;
+  size_t anchor = 0, ip = 0;
+  while (ip + LZ_MIN_MATCH <= len) {
+    uint32_t seq = TacsFH5Read32(&in[ip]);
+    uint32_t h = TacsFH5Hash(seq);
+    int64_t ref = table[h];
+    table[h] = ip;
+
+    if (ref >= 0 && ip - ref <= LZ_MAX_OFFSET &&
+        TacsFH5Read32(&in[ref]) == seq) {
+      // Extend the match as far as possible
+      size_t mlen = LZ_MIN_MATCH;
+      while (ip + mlen < len && in[ref + mlen] == in[ip + mlen]) {
+        mlen++;
+      }
+
+      // Write the token
+      size_t lit = ip - anchor;
+      size_t ml = mlen - LZ_MIN_MATCH;
+      unsigned char *token = op++;
+      *token = (unsigned char)(((lit < 15 ? lit : 15) << 4) |
+                               (ml < 15 ? ml : 15));
+      if (lit >= 15) {
+        op = TacsFH5WriteLength(op, lit - 15);
+      }
+
+      // Copy the literals
+      memcpy(op, &in[anchor], lit);
+      op += lit;
+
+      // Write the offset in little-endian order
+      size_t offset = ip - ref;
+      *op++ = (unsigned char)(offset & 0xff);
+      *op++ = (unsigned char)((offset >> 8) & 0xff);
+      if (ml >= 15) {
+        op = TacsFH5WriteLength(op, ml - 15);
+      }
+
+      // Add a hash entry within the match to improve the ratio
+      if (ip + mlen - 2 + LZ_MIN_MATCH <= len) {
+        table[TacsFH5Hash(TacsFH5Read32(&in[ip + mlen - 2]))] = ip + mlen - 2;
+      }
+
+      ip += mlen;
+      anchor = ip;
+    } else {
+      ip++;
+    }
+  }
+
+  // Write out the final literals
+  size_t lit = len - anchor;
+  *op++ = (unsigned char)((lit < 15 ? lit : 15) << 4);
+  if (lit >= 15) {
+    op = TacsFH5WriteLength(op, lit - 15);
+  }
+  memcpy(op, &in[anchor], lit);
+  op += lit;
+
+  delete[] table;
+
+  return op - out;
+}
+
+int TacsFH5LZDecompress(size_t clen, const unsigned char *in, size_t len,
+                        unsigned char *out) {
+  const unsigned char *ip = in;
+  const unsigned char *iend = in + clen;
+  size_t pos = 0;
+
+  while (ip < iend) {
+    unsigned int token = *ip++;
+
+    // Read the number of literals
+    size_t lit = token >> 4;
+    if (lit == 15) {
+      unsigned int s = 255;
+      while (s == 255) {
+        if (ip >= iend) {
+          return 1;
+        }
+        s = *ip++;
+        lit += s;
+      }
+    }
+    if (lit > (size_t)(iend - ip) || pos + lit > len) {
+      return 1;
+    }
+    memcpy(&out[pos], ip, lit);
+    ip += lit;
+    pos += lit;
+
+    // The last sequence contains only literals
+    if (ip >= iend) {
+      break;
+    }
+
+    // Read the offset and the match length
+    if (iend - ip < 2) {
+      return 1;
+    }
+    size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    size_t mlen = token & 0x0f;
+    if (mlen == 15) {
+      unsigned int s = 255;
+      while (s == 255) {
+        if (ip >= iend) {
+          return 1;
+        }
+        s = *ip++;
+        mlen += s;
+      }
+    }
+    mlen += LZ_MIN_MATCH;
+
+    if (offset == 0 || offset > pos || pos + mlen > len) {
+      return 1;
+    }
+
+    // Copy byte-by-byte since the match may overlap the output
+    const unsigned char *ref = &out[pos - offset];
+    unsigned char *o = &out[pos];
+    for (size_t i = 0; i < mlen; i++) {
+      o[i] = ref[i];
+    }
+    pos += mlen;
+  }
+
+  return (pos == len ? 0 : 1);
+}
+
+unsigned short TacsFH5FloatToHalf(float value) {
+  uint32_t x;
+  memcpy(&x, &value, sizeof(uint32_t));
+
+  uint32_t sign = (x >> 16) & 0x8000;
+  int exponent = (x >> 23) & 0xff;
+  uint32_t mant = x & 0x7fffff;
+
+  // Infinity and NaN
+  if (exponent == 255) {
+    return (unsigned short)(sign | 0x7c00 | (mant ? 0x200 : 0));
+  }
+
+  int e = exponent - 127 + 15;
+  if (e >= 31) {
+    return (unsigned short)(sign | 0x7c00);
+  } else if (e <= 0) {
+    // The result is a sub-normal half precision value or zero
+    if (e < -10) {
+      return (unsigned short)sign;
+    }
+    mant |= 0x800000;
+    int shift = 14 - e;
+    uint32_t h = mant >> shift;
+    uint32_t rem = mant & ((1U << shift) - 1);
+    uint32_t half = 1U << (shift - 1);
+    if (rem > half || (rem == half && (h & 1))) {
+      h++;
+    }
+    return (unsigned short)(sign | h);
+  }
+
+  uint32_t h = (e << 10) | (mant >> 13);
+  uint32_t rem = mant & 0x1fff;
+  if (rem > 0x1000 || (rem == 0x1000 && (h & 1))) {
+    // Note that a carry into the exponent correctly rounds up to inf
+    h++;
+  }
+  return (unsigned short)(sign | h);
+}
+
+float TacsFH5HalfToFloat(unsigned short value) {
+  uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+  uint32_t exponent = (value >> 10) & 0x1f;
+  uint32_t mant = value & 0x3ff;
+
+  if (exponent == 0) {
+    float f = ldexpf((float)mant, -24);
+    return (sign ? -f : f);
+  }
+
+  uint32_t x;
+  if (exponent == 31) {
+    x = sign | 0x7f800000 | (mant << 13);
+  } else {
+    x = sign | ((exponent + 112) << 23) | (mant << 13);
+  }
+
+  float f;
+  memcpy(&f, &x, sizeof(float));
+  return f;
+}
@@ -0,0 +1,101 @@
+/*
+  This file is part of TACS: The Toolkit for the Analysis of Composite
+  Structures, a parallel finite-element code for structural and
+  multidisciplinary design optimization.
+
+  Copyright (C) 2010 University of Toronto
+  Copyright (C) 2012 University of Michigan
+  Copyright (C) 2014 Georgia Tech Research Corporation
+  Additional copyright (C) 2010 Graeme J. Kennedy and Joaquim
+  R.R.A. Martins All rights reserved.
+
+  TACS is licensed under the Apache License, Version 2.0 (the
+  "License"); you may not use this software except in compliance with
+  the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+*/
+
+#ifndef TACS_FH5_COMPRESS_H
+#define TACS_FH5_COMPRESS_H
+
+#include <stddef.h>
+
+/*
+  Simple in-tree codecs used to reduce the size of the .f5 files.
+
+  The lossless path consists of a byte-shuffle that groups the
+  i-th byte of every element together, followed by a fast LZ77-style
+  byte codec with a 64 kB window. The lossy paths shift and scale
+  each column of the data and then convert it to IEEE half precision
+  or quantize it to integers with a bounded error before applying the
+  lossless path.
+*/
+
+/**
+  Shuffle the bytes of an array of fixed-size elements
+
+  out[b*nelems + i] = in[i*elem_size + b]
+
+  @param nelems The number of elements
+  @param elem_size The size of each element in bytes
+  @param in The input array of nelems*elem_size bytes
+  @param out The output array of nelems*elem_size bytes
+*/
+void TacsFH5ByteShuffle(size_t nelems, size_t elem_size,
+                        const unsigned char *in, unsigned char *out);
+
+/**
+  Reverse the byte shuffle
+
+  @param nelems The number of elements
+  @param elem_size The size of each element in bytes
+  @param in The shuffled array of nelems*elem_size bytes
+  @param out The output array of nelems*elem_size bytes
+*/
+void TacsFH5ByteUnshuffle(size_t nelems, size_t elem_size,
+                          const unsigned char *in, unsigned char *out);
+
+/**
+  Compute an upper bound for the size of the LZ-compressed data
+
+  @param len The length of the uncompressed input in bytes
+  @return The maximum size of the compressed output in bytes
+*/
+size_t TacsFH5LZCompressBound(size_t len);
+
+/**
+  Compress the input with the LZ-style codec
+
+  @param len The length of the input in bytes
+  @param in The input data
+  @param out The output buffer of at least TacsFH5LZCompressBound(len) bytes
+  @return The number of bytes written to the output
+*/
+size_t TacsFH5LZCompress(size_t len, const unsigned char *in,
+                         unsigned char *out);
+
+/**
+  Decompress data produced by TacsFH5LZCompress
+
+  @param clen The length of the compressed input in bytes
+  @param in The compressed input
+  @param len The length of the decompressed output in bytes
+  @param out The output buffer
+  @return 0 on success, 1 if the stream is corrupt
+*/
+int TacsFH5LZDecompress(size_t clen, const unsigned char *in, size_t len,
+                        unsigned char *out);
+
+/**
+  Convert a single precision value to IEEE half precision with
+  round-to-nearest-even. Values outside the half range become inf.
+*/
+unsigned short TacsFH5FloatToHalf(float value);
+
+/**
+  Convert an IEEE half precision value to single precision
+*/
+float TacsFH5HalfToFloat(unsigned short value);
+
+#endif  // TACS_FH5_COMPRESS_H
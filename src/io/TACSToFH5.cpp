@@ -18,6 +18,8 @@
 
 #include "TACSToFH5.h"
 
+#include "TACSProfiler.h"
+
 /**
    Create the TACSToFH5 object.
 
@@ -70,6 +72,12 @@ TACSToFH5::TACSToFH5(TACSAssembler *_assembler, ElementType _elem_type,
     snprintf(comp_name, sizeof(comp_name), "Component %d", k);
     setComponentName(k, comp_name);
   }
+
+  // By default, write all zones without compression
+  for (int k = 0; k < 3; k++) {
+    zone_compression[k] = TACSFH5File::FH5_NO_COMPRESSION;
+    zone_tol[k] = 0.0;
+  }
 }
 
 /**
@@ -112,6 +120,28 @@ void TACSToFH5::setComponentName(int comp_num, const char *comp_name) {
   }
 }
 
+/**
+   Set the storage option for a type of zone
+
+   The connectivity zone contains integer data and is always stored
+   without loss. The continuous zone contains the nodes, displacements,
+   loads and reactions while the element zone contains the strains,
+   stresses, extras and coordinate frames. Quantized storage bounds the
+   absolute error by tol times the range of each variable.
+
+   @param zone The type of zone
+   @param compression The compression type to apply
+   @param tol The relative error tolerance for quantized storage
+*/
+void TACSToFH5::setZoneCompression(FH5ZoneType zone,
+                                   TACSFH5File::FH5Compression compression,
+                                   double tol) {
+  if (zone >= CONNECTIVITY_ZONE && zone <= ELEMENT_ZONE) {
+    zone_compression[zone] = compression;
+    zone_tol[zone] = tol;
+  }
+}
+
 /**
    Write the data stored in the TACSAssembler object to a file
 
@@ -125,6 +155,7 @@ void TACSToFH5::setComponentName(int comp_num, const char *comp_name) {
    @param filename The name of the file to write
 */
 int TACSToFH5::writeToFile(const char *filename) {
+  TACS_PROFILE_SCOPE("TACSToFH5::writeToFile");
   int rank, size;
   MPI_Comm_rank(assembler->getMPIComm(), &rank);
   MPI_Comm_size(assembler->getMPIComm(), &size);
@@ -145,6 +176,8 @@ int TACSToFH5::writeToFile(const char *filename) {
   }
 
   if (write_flag & TACS_OUTPUT_CONNECTIVITY) {
+    file->setCompression(zone_compression[CONNECTIVITY_ZONE],
+                         zone_tol[CONNECTIVITY_ZONE]);
     writeConnectivity(file);
   }
 
@@ -394,6 +427,8 @@ int TACSToFH5::writeToFile(const char *filename) {
     char data_name[128];
     double t = assembler->getSimulationTime();
     snprintf(data_name, sizeof(data_name), "continuous data t=%.10e", t);
+    file->setCompression(zone_compression[CONTINUOUS_ZONE],
+                         zone_tol[CONTINUOUS_ZONE]);
     file->writeZoneData(data_name, var_names, TACSFH5File::FH5_FLOAT, dim1,
                         dim2, float_data);
     delete[] float_data;
@@ -424,6 +459,8 @@ int TACSToFH5::writeToFile(const char *filename) {
     char data_name[128];
     double t = assembler->getSimulationTime();
     snprintf(data_name, sizeof(data_name), "element data t=%.10e", t);
+    file->setCompression(zone_compression[ELEMENT_ZONE],
+                         zone_tol[ELEMENT_ZONE]);
     file->writeZoneData(data_name, variable_names, TACSFH5File::FH5_FLOAT, dim1,
                         dim2, float_data);
     delete[] float_data;
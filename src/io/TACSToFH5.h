@@ -36,12 +36,24 @@
 */
 class TACSToFH5 : public TACSObject {
  public:
+  // The zones written to the file
+  enum FH5ZoneType {
+    CONNECTIVITY_ZONE = 0,
+    CONTINUOUS_ZONE = 1,
+    ELEMENT_ZONE = 2
+  };
+
   TACSToFH5(TACSAssembler *assembler, ElementType elem_type, int write_flag);
   ~TACSToFH5();
 
   // Set the group name for each zone
   void setComponentName(int comp_num, const char *group_name);
 
+  // Set the storage option for each type of zone
+  void setZoneCompression(FH5ZoneType zone,
+                          TACSFH5File::FH5Compression compression,
+                          double tol = 0.0);
+
   // Write the data to a file
   int writeToFile(const char *filename);
 
@@ -64,6 +76,10 @@ class TACSToFH5 : public TACSObject {
   int num_components;      // The number of components in the model
   char **component_names;  // The names of each of the components
   char *variable_names;    // The names of all the variables
+
+  // Storage options for the connectivity, continuous and element zones
+  TACSFH5File::FH5Compression zone_compression[3];
+  double zone_tol[3];
 };
 
 #endif  // TACS_TO_FH5
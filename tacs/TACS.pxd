@@ -81,6 +81,15 @@ cdef inline _init_Vec(TACSVec *ptr):
     vec.ptr.incref()
     return vec
 
+cdef class InterleavedVec:
+    cdef TACSInterleavedBVec *ptr
+
+cdef inline _init_InterleavedVec(TACSInterleavedBVec *ptr):
+    vec = InterleavedVec()
+    vec.ptr = ptr
+    vec.ptr.incref()
+    return vec
+
 cdef class Mat:
     cdef TACSMat *ptr
 
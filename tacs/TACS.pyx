@@ -74,6 +74,10 @@ APPROXIMATE_SCHUR = TACS_APPROXIMATE_SCHUR
 DIRECT_SCHUR = TACS_DIRECT_SCHUR
 GAUSS_SEIDEL = TACS_GAUSS_SEIDEL
 
+# Import the element cost types
+ESTIMATED_ELEMENT_COST = TACS_ESTIMATED_ELEMENT_COST
+MEASURED_ELEMENT_COST = TACS_MEASURED_ELEMENT_COST
+
 # JDRecycleType
 SUM_TWO = JD_SUM_TWO
 NUM_RECYCLE = JD_NUM_RECYCLE
@@ -94,6 +98,15 @@ OUTPUT_LOADS = TACS_OUTPUT_LOADS
 OUTPUT_COORDINATE_FRAME = TACS_OUTPUT_COORDINATE_FRAME
 OUTPUT_REACTIONS = TACS_OUTPUT_REACTIONS
 
+# The f5 file zones and storage options
+CONNECTIVITY_ZONE = TACS_CONNECTIVITY_ZONE
+CONTINUOUS_ZONE = TACS_CONTINUOUS_ZONE
+ELEMENT_ZONE = TACS_ELEMENT_ZONE
+FH5_NO_COMPRESSION = TACS_FH5_NO_COMPRESSION
+FH5_LOSSLESS = TACS_FH5_LOSSLESS
+FH5_HALF_PRECISION = TACS_FH5_HALF_PRECISION
+FH5_QUANTIZED = TACS_FH5_QUANTIZED
+
 LAYOUT_NONE = TACS_LAYOUT_NONE
 POINT_ELEMENT = TACS_POINT_ELEMENT
 LINE_ELEMENT = TACS_LINE_ELEMENT
@@ -207,6 +220,92 @@ cdef inplace_array_3d(int nptype, int dim1, int dim2, int dim3, void *data_ptr,
 
     return ndarray
 
+# Control the profiling registry used to time the TACS kernels
+def setProfilingEnabled(flag=True, int max_trace_events=0):
+    """
+    Enable or disable the timing of the named scopes in TACS. When
+    max_trace_events is positive, up to that many individual scope
+    events are stored on each processor for writeProfileChromeTrace.
+    """
+    TACSProfiler.setEnabled(int(flag), max_trace_events)
+
+def isProfilingEnabled():
+    """Check whether the profiling registry is enabled"""
+    return TACSProfiler.isEnabled() != 0
+
+def resetProfiling():
+    """Clear all the recorded scopes and events"""
+    TACSProfiler.reset()
+
+def printProfileSummary(MPI.Comm comm):
+    """Print the min/avg/max scope times over the processors in comm"""
+    TACSProfiler.printSummary(comm.ob_mpi)
+
+def writeProfileJSON(MPI.Comm comm, fname):
+    """Write the aggregated scope statistics to a JSON file"""
+    cdef char *filename = convert_to_chars(fname)
+    return TACSProfiler.writeJSON(comm.ob_mpi, filename)
+
+def writeProfileChromeTrace(MPI.Comm comm, fname):
+    """Write the recorded scope events in the Chrome trace event format"""
+    cdef char *filename = convert_to_chars(fname)
+    return TACSProfiler.writeChromeTrace(comm.ob_mpi, filename)
+
+# Query the memory recorded by the TACS objects on this processor
+def setMemoryDryRun(flag=True):
+    """
+    Enable or disable the dry-run mode. Matrices and preconditioners
+    created in dry-run mode compute their non-zero pattern, including
+    the factorization fill-in, and record the memory they would require
+    without allocating the numerical values. They cannot be factored.
+    """
+    TACSMemoryTracker.setDryRun(int(flag))
+
+def isMemoryDryRun():
+    """Check whether the dry-run mode is enabled"""
+    return TACSMemoryTracker.isDryRun() != 0
+
+def resetMemoryPeak():
+    """Reset the high-water marks to the current memory usage"""
+    TACSMemoryTracker.resetPeak()
+
+def getMemoryUsage():
+    """
+    Get the memory in bytes recorded on this processor. This returns a
+    dictionary keyed by the owner name with the current, peak,
+    predicted and predicted_peak bytes and the number of objects, along
+    with the totals and the peak resident set size of the process.
+    """
+    cdef double current = 0.0, peak = 0.0
+    cdef double predicted = 0.0, predicted_peak = 0.0
+    cdef int num_objects = 0
+    cdef const char *name = NULL
+
+    owners = {}
+    for i in range(TACSMemoryTracker.getNumOwners()):
+        name = TACSMemoryTracker.getOwner(i, &current, &peak, &predicted,
+                                          &predicted_peak, &num_objects)
+        owners[convert_bytes_to_str(name)] = {
+            'current':current, 'peak':peak, 'predicted':predicted,
+            'predicted_peak':predicted_peak, 'num_objects':num_objects}
+
+    usage = {'owners':owners}
+    usage['current'] = TACSMemoryTracker.getCurrentBytes(NULL, 0)
+    usage['peak'] = TACSMemoryTracker.getPeakBytes(NULL, 0)
+    usage['predicted'] = TACSMemoryTracker.getCurrentBytes(NULL, 1)
+    usage['predicted_peak'] = TACSMemoryTracker.getPeakBytes(NULL, 1)
+    usage['process_peak'] = TACSMemoryTracker.getProcessPeakBytes()
+    return usage
+
+def printMemorySummary(MPI.Comm comm):
+    """Print the min/avg/max memory for each owner over comm"""
+    TACSMemoryTracker.printSummary(comm.ob_mpi)
+
+def writeMemoryJSON(MPI.Comm comm, fname):
+    """Write the memory recorded on each processor to a JSON file"""
+    cdef char *filename = convert_to_chars(fname)
+    return TACSMemoryTracker.writeJSON(comm.ob_mpi, filename)
+
 # A generic wrapper class for the TACSFunction object
 cdef class Function:
     def __cinit__(self):
@@ -842,6 +941,54 @@ cdef class Vec:
         cdef TACSBVec *ptr = self.getBVecPtr()
         return ptr.readFromFile(filename)
 
+cdef class InterleavedVec:
+    def __cinit__(self):
+        """
+        A set of design vectors stored together with a sparse pattern. This
+        is created by Assembler.createInterleavedDesignVec.
+        """
+        self.ptr = NULL
+        return
+
+    def __dealloc__(self):
+        if self.ptr:
+            self.ptr.decref()
+        return
+
+    def getNumVecs(self):
+        """
+        Get the number of vectors
+        """
+        return self.ptr.getNumVecs()
+
+    def getNumEntries(self):
+        """
+        Get the number of entries stored on this processor. Each entry
+        stores the values of one vector at one design node.
+        """
+        return self.ptr.getNumEntries(NULL)
+
+    def zeroEntries(self):
+        """
+        Zero all the values
+        """
+        self.ptr.zeroEntries()
+        return
+
+    def beginSetValues(self):
+        """
+        Begin adding the values of all the vectors to their owners
+        """
+        self.ptr.beginSetValues()
+        return
+
+    def endSetValues(self):
+        """
+        Finish adding the values of all the vectors to their owners
+        """
+        self.ptr.endSetValues()
+        return
+
 cdef class NodeMap:
     def __cinit__(self, MPI.Comm comm=None, int owned_size=0):
         if comm is None:
@@ -1738,6 +1885,34 @@ cdef class Assembler:
         self.ptr.initialize()
         return
 
+    def computeElementOrdering(self):
+        """
+        Group the elements by type for the residual and matrix assembly
+        after initialize(). The element numbering is not changed.
+        """
+        self.ptr.computeElementOrdering()
+        return
+
+    def getElementOrdering(self):
+        """
+        Get the pointer into the assembly order for each element group and
+        the element indices in the assembly order, or None if no ordering
+        has been computed. A processor without any elements returns empty
+        arrays once the ordering is computed.
+        """
+        cdef const int *group_ptr = NULL
+        cdef const int *order = NULL
+        cdef int ngroups = self.ptr.getElementOrdering(&group_ptr, &order)
+        if group_ptr == NULL:
+            return None
+        ptr = np.zeros(ngroups+1, dtype=np.intc)
+        for i in range(ngroups+1):
+            ptr[i] = group_ptr[i]
+        elems = np.zeros(group_ptr[ngroups], dtype=np.intc)
+        for i in range(group_ptr[ngroups]):
+            elems[i] = order[i]
+        return ptr, elems
+
     def getNumNodes(self):
         """
         Return the number of nodes in the TACSAssembler
@@ -1847,6 +2022,65 @@ cdef class Assembler:
         """
         return _init_Vec(self.ptr.createDesignVec())
 
+    def createInterleavedDesignVec(self, int numVecs, funclist=None):
+        """
+        Create an interleaved design vector that stores numVecs design vectors.
+
+        The interleaved vector has the same parallel layout as the design
+        vector, but each design node only stores the values of the vectors
+        that are non-zero at the node. This can be used with
+        addDVSensInterleaved and addAdjointResProductsInterleaved to
+        accumulate the derivatives of several functions with a single
+        parallel reduction.
+
+        When funclist is given, vector k is only stored at the design
+        variables of the elements in the domain of funclist[k]. Vectors
+        with a function of None, or all the vectors when funclist is None,
+        are stored at the design variables of all the elements. The vectors
+        used with addAdjointResProductsInterleaved must not have a function.
+        """
+        cdef TACSFunction **funcs = NULL
+        cdef TACSInterleavedBVec *vec = NULL
+
+        if funclist is not None:
+            if len(funclist) != numVecs:
+                raise ValueError("funclist must have numVecs entries")
+            funcs = <TACSFunction**>malloc(numVecs*sizeof(TACSFunction*))
+            for i in range(numVecs):
+                if funclist[i] is not None:
+                    funcs[i] = (<Function>funclist[i]).ptr
+                else:
+                    funcs[i] = NULL
+
+        vec = self.ptr.createInterleavedDesignVec(numVecs, funcs)
+
+        if funcs != NULL:
+            free(funcs)
+
+        return _init_InterleavedVec(vec)
+
+    def splitInterleavedDesignVec(self, InterleavedVec interleaved, veclist):
+        """
+        Copy the locally owned values of an interleaved design vector into a
+        list of design vectors. Entries in veclist that are None are
+        skipped.
+        """
+        cdef int num_vecs = len(veclist)
+        cdef TACSBVec **vecs = NULL
+
+        vecs = <TACSBVec**>malloc(num_vecs*sizeof(TACSBVec*))
+        for i in range(num_vecs):
+            if veclist[i] is not None:
+                vecs[i] = (<Vec>veclist[i]).getBVecPtr()
+            else:
+                vecs[i] = NULL
+
+        self.ptr.splitInterleavedDesignVec(interleaved.ptr, num_vecs, vecs)
+
+        free(vecs)
+
+        return
+
     def getDesignVars(self, Vec x):
         """
         Collect all the design variable values assigned by this
@@ -1912,6 +2146,18 @@ cdef class Assembler:
         self.ptr.setNumThreads(t)
         return
 
+    def computeElementCosts(self, ElementCostType cost_type=TACS_MEASURED_ELEMENT_COST):
+        """
+        Compute the relative cost of each element on this processor.
+        The costs can be passed to Creator.gatherElementCosts and then
+        used to re-partition the mesh with Creator.partitionMesh.
+
+        cost_type:  estimate the cost or time the element Jacobian
+        """
+        cdef np.ndarray costs = np.zeros(self.ptr.getNumElements(), dtype=np.double)
+        self.ptr.computeElementCosts(cost_type, <double*>costs.data)
+        return costs
+
     def setAuxElements(self, AuxElements elems=None):
         """Set the auxiliary elements"""
         cdef TACSAuxElements *ptr = NULL
@@ -2451,6 +2697,53 @@ cdef class Assembler:
 
         return
 
+    def addDVSensInterleaved(self, funclist, InterleavedVec dfdx,
+                             double alpha=1.0):
+        """
+        Evaluate the derivative of a list of functions w.r.t. the design
+        variables and add the result to an interleaved design vector created
+        by createInterleavedDesignVec with len(funclist) vectors.
+        """
+        cdef int num_funcs = len(funclist)
+        cdef TACSFunction **funcs = NULL
+
+        funcs = <TACSFunction**>malloc(num_funcs*sizeof(TACSFunction*))
+        for i in range(num_funcs):
+            if funclist[i] is not None:
+                funcs[i] = (<Function>funclist[i]).ptr
+            else:
+                funcs[i] = NULL
+
+        self.ptr.addDVSensInterleaved(alpha, num_funcs, funcs, dfdx.ptr)
+
+        free(funcs)
+
+        return
+
+    def addAdjointResProductsInterleaved(self, adjlist, InterleavedVec dfdx,
+                                         double alpha=1.0,
+                                         TacsScalar loadScale=1.0):
+        """
+        Compute the product of the derivative of the residual w.r.t. the
+        design variables with several adjoint vectors and add the result
+        to an interleaved design vector created by
+        createInterleavedDesignVec(len(adjlist)) without a function list.
+        """
+        cdef int num_adjoints = len(adjlist)
+        cdef TACSBVec **adjoints = NULL
+
+        adjoints = <TACSBVec**>malloc(num_adjoints*sizeof(TACSBVec*))
+        for i in range(num_adjoints):
+            adjoints[i] = (<Vec>adjlist[i]).getBVecPtr()
+
+        self.ptr.addAdjointResProductsInterleaved(alpha, num_adjoints,
+                                                  adjoints, dfdx.ptr,
+                                                  loadScale)
+
+        free(adjoints)
+
+        return
+
     def addAdjointResXptSensProducts(self, adjlist, dfdXlist, double alpha=1.0, TacsScalar loadScale=1.0):
         """
         This function is collective on all TACSAssembler processes. This
@@ -2482,6 +2775,30 @@ cdef class Assembler:
 
         return
 
+    def addResidualDVSensVecProduct(self, Vec pdx, Vec res, double alpha=1.0,
+                                    TacsScalar loadScale=1.0):
+        """
+        This function is collective on all TACSAssembler processes. This
+        computes the product of the derivative of the residual w.r.t. the
+        design variables with the design direction pdx and adds the result
+        to res. The boundary condition entries of res are zeroed.
+        """
+        self.ptr.addResidualDVSensVecProduct(alpha, pdx.getBVecPtr(),
+                                             res.getBVecPtr(), loadScale)
+        return
+
+    def addResidualXptSensVecProduct(self, Vec pXpts, Vec res, double alpha=1.0,
+                                     TacsScalar loadScale=1.0):
+        """
+        This function is collective on all TACSAssembler processes. This
+        computes the product of the derivative of the residual w.r.t. the
+        node locations with the node direction pXpts and adds the result
+        to res. The boundary condition entries of res are zeroed.
+        """
+        self.ptr.addResidualXptSensVecProduct(alpha, pXpts.getBVecPtr(),
+                                              res.getBVecPtr(), loadScale)
+        return
+
     def addMatDVSensInnerProduct(self, double scale,
                                  ElementMatrixType matType,
                                  Vec psi, Vec phi, Vec dfdx):
@@ -2601,6 +2918,20 @@ cdef class ToFH5:
         cdef char *group_name = convert_to_chars(_group_name)
         self.ptr.setComponentName(comp_num, group_name)
 
+    def setZoneCompression(self, FH5ZoneType zone, FH5Compression compression,
+                           double tol=0.0):
+        """
+        Set the storage option for a zone in the f5 file
+
+        input:
+        zone:         the zone type (CONNECTIVITY_ZONE, CONTINUOUS_ZONE or ELEMENT_ZONE)
+        compression:  the storage option (FH5_NO_COMPRESSION, FH5_LOSSLESS,
+                      FH5_HALF_PRECISION or FH5_QUANTIZED)
+        tol:          the error tolerance relative to the range of each
+                      variable for quantized storage
+        """
+        self.ptr.setZoneCompression(zone, compression, tol)
+
     def writeToFile(self, fname):
         """
         Write the data stored in the TACSAssembler object to filename
@@ -3007,6 +3338,41 @@ cdef class Creator:
         # Retrun the copy of the partition array
         return partition
 
+    def partitionMesh(self, int split_size=0,
+                      np.ndarray[int, ndim=1, mode='c'] part=None,
+                      np.ndarray[double, ndim=1, mode='c'] elem_costs=None):
+        """
+        Partition the mesh on the root processor. When elem_costs is
+        provided, it is used to weight the elements so that the cost on
+        each processor is balanced. Calling createTACS afterwards creates
+        a new Assembler with the new partition.
+        """
+        cdef int *part_ptr = NULL
+        cdef double *cost_ptr = NULL
+        if part is not None:
+            part_ptr = <int*>part.data
+        if elem_costs is not None:
+            cost_ptr = <double*>elem_costs.data
+        self.ptr.partitionMesh(split_size, part_ptr, cost_ptr)
+        return
+
+    def gatherElementCosts(self, np.ndarray[double, ndim=1, mode='c'] local_costs):
+        """
+        Gather the local element costs computed by the last Assembler
+        created by this object. On the root processor, the costs are
+        returned in the global element order, otherwise None is returned.
+        """
+        cdef const int *part = NULL
+        cdef int nelems = 0
+        cdef np.ndarray elem_costs = None
+        cdef double *cost_ptr = NULL
+        nelems = self.ptr.getElementPartition(&part)
+        if part != NULL:
+            elem_costs = np.zeros(nelems, dtype=np.double)
+            cost_ptr = <double*>elem_costs.data
+        self.ptr.gatherElementCosts(<double*>local_costs.data, cost_ptr)
+        return elem_costs
+
     def createTACS(self):
         return _init_Assembler(self.ptr.createTACS())
 
@@ -3600,6 +3966,45 @@ cdef class Integrator:
         self.ptr.setJacAssemblyFreq(freq)
         return
 
+    def setUseMatrixFree(self, use_matrix_free):
+        """
+        setUseMatrixFree(self, use_matrix_free)
+
+        Solve the Newton updates with GMRES using matrix-free
+        Jacobian-vector products, preconditioned with the lagged
+        factored Jacobian
+        """
+        cdef int _use_matrix_free = 0
+        if use_matrix_free:
+            _use_matrix_free = 1
+        self.ptr.setUseMatrixFree(_use_matrix_free)
+        return
+
+    def setMatrixFreeTolerances(self, double mf_rtol, double mf_atol=1e-30):
+        """
+        setMatrixFreeTolerances(self, double mf_rtol, double mf_atol=1e-30)
+
+        Set the relative and absolute tolerances of the GMRES solves
+        used in the matrix-free mode
+        """
+        self.ptr.setMatrixFreeTolerances(mf_rtol, mf_atol)
+        return
+
+    def setAdaptiveJacobian(self, adaptive_jac, double max_contraction=0.5):
+        """
+        setAdaptiveJacobian(self, adaptive_jac, double max_contraction=0.5)
+
+        Reuse the factored Jacobian across Newton iterations and time
+        steps. The Jacobian is refreshed when the time step coefficients
+        change, the linear solve fails, or when the ratio of successive
+        residual norms exceeds max_contraction.
+        """
+        cdef int _adaptive_jac = 0
+        if adaptive_jac:
+            _adaptive_jac = 1
+        self.ptr.setAdaptiveJacobian(_adaptive_jac, max_contraction)
+        return
+
     def setUseLapack(self, use_lapack):
         """
         setUseLapack(self, use_lapack)
@@ -3872,6 +4277,79 @@ cdef class Integrator:
         """
         return self.ptr.getNumTimeSteps()
 
+    def setCheckpointFrequency(self, int checkpoint_freq=0):
+        """
+        setCheckpointFrequency(self, int checkpoint_freq=0)
+
+        Configure how frequently a checkpoint file is written to the
+        output directory during integrate() and integrateAdjoint()
+        """
+        self.ptr.setCheckpointFrequency(checkpoint_freq)
+        return
+
+    def writeCheckpoint(self, fname, int step_num, int adjoint=0):
+        """
+        writeCheckpoint(self, fname, int step_num, int adjoint=0)
+
+        Write a checkpoint file after the completion of step_num
+        """
+        cdef char *filename = convert_to_chars(fname)
+        return self.ptr.writeCheckpoint(filename, step_num, adjoint)
+
+    def readCheckpoint(self, fname):
+        """
+        readCheckpoint(self, fname)
+
+        Read a checkpoint file. The next call to integrate() or
+        integrateAdjoint() resumes from the stored step. Returns the
+        step number and the adjoint flag stored in the file.
+        """
+        cdef char *filename = convert_to_chars(fname)
+        cdef int step_num = 0
+        cdef int adjoint = 0
+        fail = self.ptr.readCheckpoint(filename, &step_num, &adjoint)
+        if fail:
+            raise RuntimeError("Failed to read checkpoint file %s"%(fname))
+        return step_num, adjoint
+
+    def setNumSnapshots(self, int num_snapshots=0):
+        """
+        setNumSnapshots(self, int num_snapshots=0)
+
+        Store only num_snapshots snapshots of the state history and
+        recompute the remaining states during the function evaluation
+        and adjoint using a binomial checkpointing schedule. A value
+        of 0 stores the full state history.
+        """
+        self.ptr.setNumSnapshots(num_snapshots)
+        return
+
+    def setAdaptiveTimeStep(self, adaptive_step, double step_rtol=1e-3,
+                            double step_atol=1e-6):
+        """
+        setAdaptiveTimeStep(self, adaptive_step, double step_rtol=1e-3,
+                            double step_atol=1e-6)
+
+        Adapt the time step within integrate() using the local error
+        estimate of the DIRK or ESDIRK scheme. The number of steps
+        taken is returned by getNumTimeSteps() after the integration.
+        """
+        cdef int _adaptive_step = 0
+        if adaptive_step:
+            _adaptive_step = 1
+        self.ptr.setAdaptiveTimeStep(_adaptive_step, step_rtol, step_atol)
+        return
+
+    def setTimeStepLimits(self, double min_step=0.0, double max_step=0.0):
+        """
+        setTimeStepLimits(self, double min_step=0.0, double max_step=0.0)
+
+        Set the minimum and maximum adaptive time steps. A value of
+        zero selects the default limit.
+        """
+        self.ptr.setTimeStepLimits(min_step, max_step)
+        return
+
     def writeRawSolution(self, fname, int format_flag=2):
         cdef char *filename = convert_to_chars(fname)
         self.ptr.writeRawSolution(filename, format_flag)
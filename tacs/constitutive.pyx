@@ -956,6 +956,18 @@ cdef class ShellConstitutive(Constitutive):
             return self.cptr.getDrillingRegularization()
         return None
 
+    def setUseStiffnessCache(self, bint flag=True):
+        """
+        Cache the tangent stiffness of the shell between calls. The cached values
+        are reused until the design variables are modified. Only valid for linear
+        materials whose stiffness does not vary with position.
+
+        Args:
+            flag (bool): Whether to cache the stiffness. Defaults to True.
+        """
+        if self.cptr:
+            self.cptr.setUseStiffnessCache(flag)
+
     def getThicknessProperties(self):
         """
         Helper function to gather thickness properties and density of the shell based on the current design variable values.
@@ -1594,10 +1606,18 @@ cdef class GaussianProcess:
             specifically: [log_xi1, log_rho01, log_gamma1, log_zeta1, log_xi2, ...]
 
         Returns:
-            Ytest (np.ndarray) : a rank 1 tensor Ytest of size (N_test,) containing the log(N_ij,cr^*) aka log buckling load
+            Ytest (np.ndarray or float) : a rank 1 tensor Ytest of size (N_test,) containing the log(N_ij,cr^*) aka log buckling load
             outputs where N_ij,cr^* is N_11,cr^* for the axial GP, N_12,cr^* for the shear GP.
-        """
-        return self.base_gp.predictMeanTestData(<TacsScalar*>Xtest.data)
+            When Xtest contains a single point (N_test = 1), the prediction is returned as a scalar.
+        """
+        cdef int nparam = self.base_gp.getNparam()
+        cdef int ntest = Xtest.shape[0] // nparam
+        cdef np.ndarray Ytest = np.zeros((ntest,), dtype=dtype)
+        self.base_gp.predictMeanTestDataBatch(ntest, <TacsScalar*>Xtest.data,
+                                              <TacsScalar*>Ytest.data)
+        if ntest == 1:
+            return Ytest[0]
+        return Ytest
 
     def getNparam(self):
         """
@@ -163,11 +163,15 @@ class StiffenerLengthConstraint(TACSConstraint):
                 lengthDVs[conCount] = localDVNum
                 lengthDVsOwnerProc[conCount] = self.comm.rank
 
-            # Get connectivity and find end nodes of the stiffener chain
-            compConn = self.meshLoader.getConnectivityForComp(
-                comp, nastranOrdering=False
-            )
-            endNodeGlobalIDs = self._findChainEnds(compConn)
+            # Get connectivity and find end nodes of the stiffener chain.
+            # Only the root proc is guaranteed to hold the connectivity.
+            endNodeGlobalIDs = None
+            if self.comm.rank == 0:
+                compConn = self.meshLoader.getConnectivityForComp(
+                    comp, nastranOrdering=False
+                )
+                endNodeGlobalIDs = self._findChainEnds(compConn)
+            endNodeGlobalIDs = self.comm.bcast(endNodeGlobalIDs, root=0)
             endNodeLocalIDs = self.meshLoader.getLocalNodeIDsFromGlobal(
                 endNodeGlobalIDs, nastranOrdering=False
             )
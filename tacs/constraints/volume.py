@@ -216,17 +216,20 @@ class VolumeConstraint(TACSConstraint):
         elemIDs = self.meshLoader.getGlobalElementIDsForComps(
             compIDs, nastranOrdering=True
         )
+        # Only the root proc is guaranteed to hold every element card
         allShells = False
         allSolids = False
-        for elemID in elemIDs:
-            elemInfo = self.bdfInfo.elements[elemID]
-            if isinstance(elemInfo, pn.cards.elements.shell.ShellElement):
-                if allShells is False:
-                    allShells = True
-
-            elif isinstance(elemInfo, pn.cards.elements.solid.SolidElement):
-                if allSolids is False:
-                    allSolids = True
+        if self.comm.rank == 0:
+            for elemID in elemIDs:
+                elemInfo = self.bdfInfo.elements[elemID]
+                if isinstance(elemInfo, pn.cards.elements.shell.ShellElement):
+                    if allShells is False:
+                        allShells = True
+
+                elif isinstance(elemInfo, pn.cards.elements.solid.SolidElement):
+                    if allSolids is False:
+                        allSolids = True
+        allShells, allSolids = self.comm.bcast((allShells, allSolids), root=0)
 
         if not (allShells or allSolids):
             self._TACSWarning("No shell or solid elements found in provided compIDs.")
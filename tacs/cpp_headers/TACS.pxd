@@ -110,6 +110,46 @@ cdef extern from "TACSObject.h":
 
     cdef MPI_Datatype TACS_MPI_TYPE
 
+cdef extern from "TACSProfiler.h":
+    cdef cppclass TACSProfiler:
+        @staticmethod
+        void setEnabled(int flag, int max_trace_events)
+        @staticmethod
+        int isEnabled()
+        @staticmethod
+        void reset()
+        @staticmethod
+        void printSummary(MPI_Comm comm)
+        @staticmethod
+        int writeJSON(MPI_Comm comm, const char *file_name)
+        @staticmethod
+        int writeChromeTrace(MPI_Comm comm, const char *file_name)
+
+cdef extern from "TACSMemoryTracker.h":
+    cdef cppclass TACSMemoryTracker:
+        @staticmethod
+        void setDryRun(int flag)
+        @staticmethod
+        int isDryRun()
+        @staticmethod
+        double getCurrentBytes(const char *name, int predicted)
+        @staticmethod
+        double getPeakBytes(const char *name, int predicted)
+        @staticmethod
+        void resetPeak()
+        @staticmethod
+        int getNumOwners()
+        @staticmethod
+        const char *getOwner(int index, double *current, double *peak,
+                             double *predicted, double *predicted_peak,
+                             int *num_objects)
+        @staticmethod
+        double getProcessPeakBytes()
+        @staticmethod
+        void printSummary(MPI_Comm comm)
+        @staticmethod
+        int writeJSON(MPI_Comm comm, const char *file_name)
+
 cdef extern from "KSM.h":
     cdef cppclass TACSVec(TACSObject):
         TacsScalar norm()
@@ -195,6 +235,15 @@ cdef extern from "TACSBVecDistribute.h":
     cdef cppclass TACSBVecDistribute(TACSObject):
         TACSBVecIndices *getIndices()
 
+cdef extern from "TACSInterleavedBVec.h":
+    cdef cppclass TACSInterleavedBVec(TACSObject):
+        int getBlockSize()
+        int getNumVecs()
+        int getNumEntries(int*)
+        void zeroEntries()
+        void beginSetValues()
+        void endSetValues()
+
 cdef extern from "TACSBVecInterp.h":
     cdef cppclass TACSBVecInterp(TACSObject):
         TACSBVecInterp(TACSNodeMap*, TACSNodeMap*, int)
@@ -318,6 +367,10 @@ cdef extern from "TACSAssembler.h":
         TACS_DIRECT_SCHUR"TACSAssembler::DIRECT_SCHUR"
         TACS_GAUSS_SEIDEL"TACSAssembler::GAUSS_SEIDEL"
 
+    enum ElementCostType"TACSAssembler::ElementCostType":
+        TACS_ESTIMATED_ELEMENT_COST"TACSAssembler::ESTIMATED_ELEMENT_COST"
+        TACS_MEASURED_ELEMENT_COST"TACSAssembler::MEASURED_ELEMENT_COST"
+
     cdef cppclass TACSAssembler(TACSObject):
         TACSAssembler(MPI_Comm tacs_comm, int varsPerNode,
                       int numOwnedNodes, int numElements,
@@ -336,6 +389,8 @@ cdef extern from "TACSAssembler.h":
         void setBCValuesFromVec(TACSBVec*)
         void computeReordering(OrderingType, MatrixOrderingType)
         void initialize()
+        void computeElementOrdering()
+        int getElementOrdering(const int **groupPtr, const int **order)
         int getVarsPerNode()
         int getNumNodes()
         int getNumDependentNodes()
@@ -359,6 +414,8 @@ cdef extern from "TACSAssembler.h":
         void setNodes(TACSBVec*)
         void getNodes(TACSBVec*)
         TACSBVec *createDesignVec()
+        TACSInterleavedBVec *createInterleavedDesignVec(int, TACSFunction**)
+        void splitInterleavedDesignVec(TACSInterleavedBVec*, int, TACSBVec**)
         void getDesignVars(TACSBVec*)
         void setDesignVars(TACSBVec*)
         void getDesignVarRange(TACSBVec*, TACSBVec*)
@@ -406,12 +463,23 @@ cdef extern from "TACSAssembler.h":
         void addAdjointResProducts(double scale, int numAdjoints,
                                    TACSBVec **adjoint, TACSBVec **dfdx,
                                    TacsScalar loadScale)
+        void addDVSensInterleaved(double coef, int numFuncs,
+                                  TACSFunction **funcs,
+                                  TACSInterleavedBVec *dfdx)
+        void addAdjointResProductsInterleaved(double scale, int numAdjoints,
+                                              TACSBVec **adjoint,
+                                              TACSInterleavedBVec *dfdx,
+                                              TacsScalar loadScale)
         void addXptSens(double coef, int numFuncs, TACSFunction **funcs,
                         TACSBVec **fXptSens)
         void addAdjointResXptSensProducts(double scale, int numAdjoints,
                                           TACSBVec **adjoint,
                                           TACSBVec **adjXptSens,
                                           TacsScalar loadScale)
+        void addResidualDVSensVecProduct(double scale, TACSBVec *pdx,
+                                         TACSBVec *res, TacsScalar loadScale)
+        void addResidualXptSensVecProduct(double scale, TACSBVec *pXpts,
+                                          TACSBVec *res, TacsScalar loadScale)
         void addMatDVSensInnerProduct(double scale,
                                       ElementMatrixType matType,
                                       TACSBVec *psi, TACSBVec *phi,
@@ -426,6 +494,7 @@ cdef extern from "TACSAssembler.h":
 
         # Set the number of threads
         void setNumThreads(int t)
+        void computeElementCosts(ElementCostType cost_type, double *costs)
 
 cdef extern from "GSEP.h":
     enum OrthoType"SEP::OrthoType":
@@ -568,18 +637,33 @@ cdef extern from "TACSCreator.h":
         void setNodes(TacsScalar *_Xpts)
         void setReorderingType(OrderingType _order_type,
                                MatrixOrderingType _mat_type)
-        void partitionMesh(int split_size, int *part)
+        void partitionMesh(int split_size, int *part, double *elem_costs)
         int getElementPartition(const int **)
         TACSAssembler *createTACS()
         int getNodeNums(const int**)
         int getElementIdNums(int, int *, int **)
         void getAssemblerNodeNums(TACSAssembler*, int, const int*,
                                   int*, int**)
+        void gatherElementCosts(const double *local_costs, double *elem_costs)
+
+cdef extern from "TACSFH5.h":
+    enum FH5Compression"TACSFH5File::FH5Compression":
+        TACS_FH5_NO_COMPRESSION"TACSFH5File::FH5_NO_COMPRESSION"
+        TACS_FH5_LOSSLESS"TACSFH5File::FH5_LOSSLESS"
+        TACS_FH5_HALF_PRECISION"TACSFH5File::FH5_HALF_PRECISION"
+        TACS_FH5_QUANTIZED"TACSFH5File::FH5_QUANTIZED"
 
 cdef extern from "TACSToFH5.h":
+    enum FH5ZoneType"TACSToFH5::FH5ZoneType":
+        TACS_CONNECTIVITY_ZONE"TACSToFH5::CONNECTIVITY_ZONE"
+        TACS_CONTINUOUS_ZONE"TACSToFH5::CONTINUOUS_ZONE"
+        TACS_ELEMENT_ZONE"TACSToFH5::ELEMENT_ZONE"
+
     cdef cppclass TACSToFH5(TACSObject):
         TACSToFH5(TACSAssembler *_tacs, ElementType _elem_type, int _out_type)
         void setComponentName(int comp_num, char *group_name)
+        void setZoneCompression(FH5ZoneType zone, FH5Compression compression,
+                                double tol)
         void writeToFile(char *filename)
 
 cdef extern from "TACSFH5Loader.h":
@@ -611,6 +695,9 @@ cdef extern from "TACSIntegrator.h":
         void setMaxNewtonIters(int)
         void setPrintLevel(int level, const_char *filename)
         void setJacAssemblyFreq(int)
+        void setUseMatrixFree(int)
+        void setMatrixFreeTolerances(double, double)
+        void setAdaptiveJacobian(int, double)
         void setUseLapack(int)
         void setUseSchurMat(int, OrderingType)
         void setInitNewtonDeltaFraction(double)
@@ -648,6 +735,17 @@ cdef extern from "TACSIntegrator.h":
         int getNumTimeSteps()
         void writeRawSolution(const_char *name, int format_flag)
 
+        # Checkpoint/restart
+        void setCheckpointFrequency(int checkpoint_freq)
+        int writeCheckpoint(const_char *filename, int step_num, int adjoint)
+        int readCheckpoint(const_char *filename, int *step_num, int *adjoint)
+
+        # Binomial checkpointing of the state history
+        void setNumSnapshots(int num_snapshots)
+        void setAdaptiveTimeStep(int adaptive_step, double step_rtol,
+                                 double step_atol)
+        void setTimeStepLimits(double min_step, double max_step)
+
         # Debug adjoint
         void checkGradients(double dh)
 
@@ -96,6 +96,7 @@ cdef extern from "TACSShellConstitutive.h":
     cdef cppclass TACSShellConstitutive(TACSConstitutive):
         void setDrillingRegularization(double)
         double getDrillingRegularization()
+        void setUseStiffnessCache(int)
         TacsScalar getShearCorrectionFactor()
         TacsScalar evalDensity(int elemIndex, const double pt[], const TacsScalar X[])
         void evalMassMoments(int elemIndex, const double pt[], const TacsScalar X[], TacsScalar moments[])
@@ -217,6 +218,7 @@ cdef extern from "TACSGaussianProcessModel.h":
         void setKS(TacsScalar ksWeight)
         TacsScalar testAllGPTests(TacsScalar epsilon, int printLevel)
         TacsScalar predictMeanTestData(TacsScalar*)
+        void predictMeanTestDataBatch(int, TacsScalar*, TacsScalar*)
         void setAlpha(TacsScalar*)
         void setTheta(TacsScalar*)
         TacsScalar kernel(TacsScalar*, TacsScalar*)
@@ -66,6 +66,7 @@ cdef extern from "TACSKSTemperature.h":
     cdef cppclass TACSKSTemperature(TACSFunction):
         TACSKSTemperature(TACSAssembler*, double, double)
         void setKSAggregationType(_CKSAggregationType ftype)
+        void setSinglePassEvaluation(int)
         double getParameter()
         void setParameter(double)
         void setMaxFailOffset(TacsScalar)
@@ -74,6 +75,9 @@ cdef extern from "TACSKSFailure.h":
     cdef cppclass TACSKSFailure(TACSFunction):
         TACSKSFailure(TACSAssembler*, double, double, double)
         void setKSAggregationType(_CKSAggregationType ftype)
+        void setSinglePassEvaluation(int)
+        void setFailureScreening(double, double)
+        double getSkippedFraction()
         double getParameter()
         void setParameter(double)
         void setMaxFailOffset(TacsScalar)
@@ -82,6 +86,7 @@ cdef extern from "TACSKSDisplacement.h":
     cdef cppclass TACSKSDisplacement(TACSFunction):
         TACSKSDisplacement(TACSAssembler*, double, const double*, double)
         void setKSAggregationType(_CKSAggregationType ftype)
+        void setSinglePassEvaluation(int)
         double getParameter()
         void setParameter(double)
         void setMaxDispOffset(TacsScalar)
@@ -100,6 +105,8 @@ cdef extern from "TACSInducedFailure.h":
     cdef cppclass TACSInducedFailure(TACSFunction):
         TACSInducedFailure(TACSAssembler*, double)
         void setInducedType(InducedNormType)
+        void setFailureScreening(double, double)
+        double getSkippedFraction()
         void setParameter(double)
         double getParameter()
         void setMaxFailOffset(TacsScalar _max_fail)
@@ -277,6 +277,8 @@ cdef class KSTemperature(Function):
         ksWeight (float, optional): The ks weight used in the calculation (keyword argument). Defaults to 80.0.
         ksAggregationType (functions.KSAggregationType, optional): The type of KS aggregation to be used.
             Defaults to ``functions.KSAggregationType.KS_CONTINUOUS``. ``DISCRETE_AVERAGE`` is not supported.
+        singlePass (bool, optional): Evaluate the KS aggregation in a single pass over the mesh
+            using a running maximum (keyword argument). Defaults to False.
         ftype (str, optional): Deprecated. Use ``ksAggregationType=functions.KSAggregationType.<VALUE>`` instead.
     """
 
@@ -311,6 +313,8 @@ cdef class KSTemperature(Function):
         else:
             ksAggregationType = kwargs.get('ksAggregationType', KSAggregationType.KS_CONTINUOUS)
         self.setKSAggregationType(ksAggregationType)
+        if kwargs.get('singlePass', False):
+            self.setSinglePassEvaluation(True)
 
     def setKSAggregationType(self, ksAggregationType):
         """
@@ -331,6 +335,18 @@ cdef class KSTemperature(Function):
             )
         self.kstptr.setKSAggregationType(<_CKSAggregationType><int>ksAggregationType)
 
+    def setSinglePassEvaluation(self, flag):
+        """
+        Evaluate the KS aggregation in a single pass over the mesh. The
+        maximum value and the sum are accumulated together and the sum is
+        rescaled when the maximum increases. This is ignored for the p-norm
+        aggregation types.
+
+        Args:
+            flag (bool): Flag indicating whether to use a single pass
+        """
+        self.kstptr.setSinglePassEvaluation(int(flag))
+
     def setKSTemperatureType(self, ftype):
         """
         Deprecated. Use :meth:`setKSAggregationType` instead.
@@ -378,6 +394,8 @@ cdef class KSFailure(Function):
             The safety factor to apply to loads before computing the failure (keyword argument). Defaults to 1.0.
         ksAggregationType (functions.KSAggregationType, optional): The type of KS aggregation to be used.
             Defaults to ``functions.KSAggregationType.KS_CONTINUOUS``.
+        singlePass (bool, optional): Evaluate the KS aggregation in a single pass over the mesh
+            using a running maximum (keyword argument). Defaults to False.
         ftype (str, optional): Deprecated. Use ``ksAggregationType=functions.KSAggregationType.<VALUE>`` instead.
     """
 
@@ -416,6 +434,8 @@ cdef class KSFailure(Function):
         else:
             ksAggregationType = kwargs.get('ksAggregationType', KSAggregationType.KS_CONTINUOUS)
         self.setKSAggregationType(ksAggregationType)
+        if kwargs.get('singlePass', False):
+            self.setSinglePassEvaluation(True)
 
     def setKSAggregationType(self, ksAggregationType):
         """
@@ -428,6 +448,48 @@ cdef class KSFailure(Function):
         ksAggregationType = KSAggregationType(ksAggregationType)
         self.ksptr.setKSAggregationType(<_CKSAggregationType><int>ksAggregationType)
 
+    def setSinglePassEvaluation(self, flag):
+        """
+        Evaluate the KS aggregation in a single pass over the mesh. The
+        maximum value and the sum are accumulated together and the sum is
+        rescaled when the maximum increases. This is ignored for the p-norm
+        aggregation types.
+
+        Args:
+            flag (bool): Flag indicating whether to use a single pass
+        """
+        self.ksptr.setSinglePassEvaluation(int(flag))
+
+    def setFailureScreening(self, double tol, double spreadFactor=1.5):
+        """
+        Skip elements whose contribution to the KS aggregate is
+        negligible. The failure index at the element centroid and the
+        spread recorded at the full evaluations of the element are used
+        to estimate an upper bound on the failure index. Elements are
+        skipped while the sum of the bounds on their contributions stays
+        below tol times the KS sum. This holds only while the failure
+        index stays below the estimated bound, so repeated evaluations
+        at the same design agree to within the tolerance, not exactly.
+        This only applies to the ``KS_DISCRETE`` and ``KS_CONTINUOUS``
+        aggregation types.
+
+        Args:
+            tol (float): The screening tolerance. A value <= 0 disables
+                the screening.
+            spreadFactor (float): The factor inflating the recorded
+                spread of the failure index within each element.
+        """
+        self.ksptr.setFailureScreening(tol, spreadFactor)
+
+    def getSkippedFraction(self):
+        """
+        Get the fraction of elements skipped in the last evaluation.
+
+        Returns:
+            float: The skipped fraction
+        """
+        return self.ksptr.getSkippedFraction()
+
     def setKSFailureType(self, ftype):
         """
         Deprecated. Use :meth:`setKSAggregationType` instead.
@@ -469,6 +531,8 @@ cdef class KSDisplacement(Function):
           Defaults to [0.0, 0.0, 0.0].
         ksAggregationType (functions.KSAggregationType, optional): The type of KS aggregation to be used.
           Defaults to ``functions.KSAggregationType.KS_CONTINUOUS``. ``DISCRETE_AVERAGE`` is not supported.
+        singlePass (bool, optional): Evaluate the KS aggregation in a single pass over the mesh
+            using a running maximum (keyword argument). Defaults to False.
         ftype (str, optional): Deprecated. Use ``ksAggregationType=functions.KSAggregationType.<VALUE>`` instead.
     """
 
@@ -513,6 +577,8 @@ cdef class KSDisplacement(Function):
         else:
             ksAggregationType = kwargs.get('ksAggregationType', KSAggregationType.KS_CONTINUOUS)
         self.setKSAggregationType(ksAggregationType)
+        if kwargs.get('singlePass', False):
+            self.setSinglePassEvaluation(True)
 
     def setKSAggregationType(self, ksAggregationType):
         """
@@ -533,6 +599,18 @@ cdef class KSDisplacement(Function):
             )
         self.ksptr.setKSAggregationType(<_CKSAggregationType><int>ksAggregationType)
 
+    def setSinglePassEvaluation(self, flag):
+        """
+        Evaluate the KS aggregation in a single pass over the mesh. The
+        maximum value and the sum are accumulated together and the sum is
+        rescaled when the maximum increases. This is ignored for the p-norm
+        aggregation types.
+
+        Args:
+            flag (bool): Flag indicating whether to use a single pass
+        """
+        self.ksptr.setSinglePassEvaluation(int(flag))
+
     def setKSDisplacementType(self, ftype):
         """
         Deprecated. Use :meth:`setKSAggregationType` instead.
@@ -94,8 +94,9 @@ class TacsBuilder(Builder):
         check_partials : bool, optional
             This flag allows TACS components partial derivative routines to be evaluated in forward mode without raising
             an error. This lets OpenMDAO's check_partials routine run without errors, allowing users to check TACS'
-            reverse derivatives. The forward derivative checks will still not be meaningful since TACS only supports
-            reverse mode. Defaults to False.
+            reverse derivatives. The solver and function components support forward mode, but the buckling
+            component only supports reverse mode, so its forward derivative checks will not be meaningful.
+            Defaults to False.
         conduction : bool, optional
             Flag to determine weather TACS component represents a thermal (True) or structural (False) analysis.
             Defaults to False.
@@ -104,8 +104,29 @@ class TacsFunctions(om.ExplicitComponent):
 
     def compute_jacvec_product(self, inputs, d_inputs, d_outputs, mode):
         if mode == "fwd":
-            if not self.under_check_partials:
-                raise ValueError("TACS forward mode requested but not implemented")
+            self._update_internal(inputs)
+
+            for func_name in d_outputs:
+                # Local contribution to the directional derivative
+                d_func = 0.0
+
+                if "tacs_dvs" in d_inputs:
+                    dv_sens = np.zeros_like(d_inputs["tacs_dvs"])
+                    self.sp.addDVSens([func_name], [dv_sens])
+                    d_func += np.dot(dv_sens, d_inputs["tacs_dvs"])
+
+                if self.coords_name in d_inputs:
+                    xpt_sens = np.zeros_like(d_inputs[self.coords_name])
+                    self.sp.addXptSens([func_name], [xpt_sens])
+                    d_func += np.dot(xpt_sens, d_inputs[self.coords_name])
+
+                if self.states_name in d_inputs:
+                    sv_sens = np.zeros_like(d_inputs[self.states_name])
+                    self.sp.addSVSens([func_name], [sv_sens])
+                    d_func += np.dot(sv_sens, d_inputs[self.states_name])
+
+                d_outputs[func_name] += self.comm.allreduce(d_func)
+
         if mode == "rev":
             # always update internal because same tacs object could be used by multiple scenarios
             # and we need to load this scenario's state back into TACS before doing derivatives
@@ -198,8 +219,24 @@ class MassFunctions(om.ExplicitComponent):
 
     def compute_jacvec_product(self, inputs, d_inputs, d_outputs, mode):
         if mode == "fwd":
-            if not self.under_check_partials:
-                raise ValueError("TACS forward mode requested but not implemented")
+            self._update_internal(inputs)
+
+            for func_name in d_outputs:
+                # Local contribution to the directional derivative
+                d_func = 0.0
+
+                if "tacs_dvs" in d_inputs:
+                    dv_sens = np.zeros_like(d_inputs["tacs_dvs"])
+                    self.sp.addDVSens([func_name], [dv_sens])
+                    d_func += np.dot(dv_sens, d_inputs["tacs_dvs"])
+
+                if self.coords_name in d_inputs:
+                    xpt_sens = np.zeros_like(d_inputs[self.coords_name])
+                    self.sp.addXptSens([func_name], [xpt_sens])
+                    d_func += np.dot(xpt_sens, d_inputs[self.coords_name])
+
+                d_outputs[func_name] += self.comm.allreduce(d_func)
+
         if mode == "rev":
             # always update internal because same tacs object could be used by multiple scenarios
             # and we need to load this scenario's state back into TACS before doing derivatives
@@ -177,16 +177,18 @@ class TacsSolver(om.ImplicitComponent):
                 d_residuals[self.states_name] -= array_w_bcs
             if self.coords_name in d_inputs:
                 # Perturbation in residual due to perturbation in node coordinates
-                if not self.under_check_partials:
-                    raise ValueError(
-                        "TACS forward mode node coordinate sensitivities requested but not implemented"
-                    )
+                self.sp.addResidualXptSensVecProduct(
+                    d_inputs[self.coords_name],
+                    d_residuals[self.states_name],
+                    scale=1.0,
+                )
             if "tacs_dvs" in d_inputs:
                 # Perturbation in residual due to perturbation in design variables
-                if not self.under_check_partials:
-                    raise ValueError(
-                        "TACS forward mode DV sensitivities requested but not implemented"
-                    )
+                self.sp.addResidualDVSensVecProduct(
+                    d_inputs["tacs_dvs"],
+                    d_residuals[self.states_name],
+                    scale=1.0,
+                )
 
         if mode == "rev":
             if self.states_name in d_residuals:
@@ -1,4 +1,5 @@
 from .static import StaticProblem
+from .static_set import StaticProblemSet
 from .transient import TransientProblem
 from .modal import ModalProblem
 from .buckling import BucklingProblem
@@ -6,6 +7,7 @@ from .base import TACSProblem
 
 __all__ = [
     "StaticProblem",
+    "StaticProblemSet",
     "TransientProblem",
     "ModalProblem",
     "BucklingProblem",
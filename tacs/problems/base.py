@@ -914,7 +914,7 @@ class TACSProblem(TACSSystem):
             # get nastran=>local tacs id map for this processor
             # this local_tacs_ids is len(num_nodes) globally with -1 for nodes
             # not on this processor and the local tacs_ids for nodes owned by this processor
-            num_nodes = self.meshLoader.bdfInfo.nnodes
+            num_nodes = self.meshLoader.getNumBDFNodes()
             bdfNodes = range(num_nodes)
             local_tacs_ids = self.meshLoader.getLocalNodeIDsFromGlobal(
                 bdfNodes, nastranOrdering=False
@@ -932,7 +932,7 @@ class TACSProblem(TACSSystem):
         num_funcs = len(evalFuncs)
         assert tacsAim is not None
         num_struct_dvs = len(tacsAim.thickness_variables)
-        num_nodes = self.meshLoader.bdfInfo.nnodes
+        num_nodes = self.meshLoader.getNumBDFNodes()
 
         # uses other proc and broadcast so needed before root-proc check
         sens_file_path = tacsAim.sens_file_path(proc)
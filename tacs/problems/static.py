@@ -14,10 +14,12 @@ other pieces of information.
 import copy
 import os
 import time
+import weakref
 from collections import OrderedDict
 import warnings
 
 import numpy as np
+from mpi4py import MPI
 import pyNastran.bdf as pn
 
 import tacs.TACS
@@ -26,6 +28,195 @@ import tacs.solvers
 from tacs.problems.base import TACSProblem
 
 
+class StaticOperator:
+    """
+    Stiffness matrix and preconditioner that can be shared between linear
+    StaticProblems using the same assembler and solver settings.
+
+    The operator keeps a copy of the design variables and node locations it
+    was assembled with. It is only reassembled and refactored when a problem
+    requests it with different values, so load cases solved at the same
+    design point share a single factorization.
+    """
+
+    def __init__(
+        self,
+        assembler,
+        comm,
+        ordering,
+        fillLevel,
+        fillRatio,
+        alpha,
+        beta,
+        gamma,
+        rbeScale,
+        rbeArtificial,
+    ):
+        """
+        Parameters
+        ----------
+        assembler : tacs.TACS.Assembler
+            Cython object responsible for creating and setting tacs objects used to solve problem
+
+        comm : mpi4py.MPI.Intracomm
+            The comm object the assembler is distributed over.
+
+        ordering : int
+            Ordering type used for the matrix partitioning.
+
+        fillLevel : int
+            Preconditioner fill level.
+
+        fillRatio : float
+            Preconditioner fill ratio.
+
+        alpha, beta, gamma : float
+            TACS Jacobian coefficients for the stiffness matrix.
+
+        rbeScale : float
+            Constraint matrix scaling factor used in the RBE stiffness matrix.
+
+        rbeArtificial : float
+            Artificial stiffness added to the RBE diagonals to stabilize the preconditioner.
+        """
+        self.assembler = assembler
+        self.comm = comm
+        self.alpha = alpha
+        self.beta = beta
+        self.gamma = gamma
+
+        # True stiffness matrix
+        self.K = assembler.createSchurMat(ordering)
+        # Artificial stiffness for RBE numerical stabilization to stabilize PC
+        self.rbeArtificialStiffness = assembler.createSchurMat(ordering)
+
+        # Isolate the artificial stiffness terms
+        tacs.elements.RBE2.setScalingParameters(rbeScale, 0.0)
+        tacs.elements.RBE3.setScalingParameters(rbeScale, 0.0)
+        assembler.assembleJacobian(alpha, beta, gamma, None, self.K)
+        tacs.elements.RBE2.setScalingParameters(rbeScale, rbeArtificial)
+        tacs.elements.RBE3.setScalingParameters(rbeScale, rbeArtificial)
+        assembler.assembleJacobian(
+            alpha, beta, gamma, None, self.rbeArtificialStiffness
+        )
+        self.rbeArtificialStiffness.axpy(-1.0, self.K)
+        tacs.elements.RBE2.setScalingParameters(rbeScale, 0.0)
+        tacs.elements.RBE3.setScalingParameters(rbeScale, 0.0)
+
+        reorderSchur = 1
+        self.PC = tacs.TACS.Pc(
+            self.K,
+            lev_fill=fillLevel,
+            ratio_fill=fillRatio,
+            reorder=reorderSchur,
+        )
+
+        # Design variables, nodes and assembly arguments the operator was
+        # last assembled with
+        self._x = None
+        self._Xpts = None
+        self._loadScale = None
+        self._applyBCs = None
+        self._preconditionerUpdateRequired = True
+
+        # Counter incremented each time the matrix is reassembled
+        self.version = 0
+
+    def hasAssemblyArgs(self, loadScale=1.0, applyBCs=True):
+        """
+        Check whether the operator was last assembled with the given load
+        scale and boundary condition flag. This check is local and does not
+        compare the design variables or nodes.
+
+        Parameters
+        ----------
+        loadScale : float, optional
+            Load scale factor used in the assembly, by default 1.0
+
+        applyBCs : bool, optional
+            Whether the boundary conditions are applied to the matrix, by default True
+
+        Returns
+        -------
+        bool
+            True if the assembly arguments match.
+        """
+        return self._loadScale == loadScale and self._applyBCs == bool(applyBCs)
+
+    def isCurrent(self, x, Xpts, loadScale=1.0, applyBCs=True):
+        """
+        Check whether the operator was assembled with the given design
+        variables, node locations and assembly arguments on all processors.
+
+        Parameters
+        ----------
+        x : tacs.TACS.Vec
+            Design variable vector.
+
+        Xpts : tacs.TACS.Vec
+            Node location vector.
+
+        loadScale : float, optional
+            Load scale factor used in the assembly, by default 1.0
+
+        applyBCs : bool, optional
+            Whether the boundary conditions are applied to the matrix, by default True
+
+        Returns
+        -------
+        bool
+            True if the operator does not need to be reassembled.
+        """
+        if self._x is None or not self.hasAssemblyArgs(loadScale, applyBCs):
+            return False
+        same = np.array_equal(self._x, x.getArray()) and np.array_equal(
+            self._Xpts, Xpts.getArray()
+        )
+        return self.comm.allreduce(same, op=MPI.LAND)
+
+    def updateJacobian(self, x, Xpts, loadScale=1.0, applyBCs=True):
+        """
+        Reassemble the stiffness matrix if the design variables or nodes
+        have changed since the last assembly. The assembler must already
+        be set up with the requesting problem's variables.
+
+        Returns
+        -------
+        bool
+            True if the matrix was reassembled.
+        """
+        if self.isCurrent(x, Xpts, loadScale, applyBCs):
+            return False
+
+        self.assembler.assembleJacobian(
+            self.alpha,
+            self.beta,
+            self.gamma,
+            None,
+            self.K,
+            loadScale=loadScale,
+            applyBCs=applyBCs,
+        )
+        self._x = x.getArray().copy()
+        self._Xpts = Xpts.getArray().copy()
+        self._loadScale = loadScale
+        self._applyBCs = bool(applyBCs)
+        self._preconditionerUpdateRequired = True
+        self.version += 1
+
+        return True
+
+    def updatePreconditioner(self):
+        """
+        Refactor the preconditioner if the matrix has been reassembled.
+        """
+        if self._preconditionerUpdateRequired:
+            self.K.axpy(1.0, self.rbeArtificialStiffness)
+            self.PC.factor()
+            self.K.axpy(-1.0, self.rbeArtificialStiffness)
+            self._preconditionerUpdateRequired = False
+
+
 class StaticProblem(TACSProblem):
     # Default options for class
     defaultOptions = {
@@ -97,6 +288,14 @@ class StaticProblem(TACSProblem):
             10,
             "Print frequency for sub iterations of linear solver.",
         ],
+        "shareOperator": [
+            bool,
+            False,
+            "Flag for sharing the stiffness matrix and preconditioner with other linear problems \n"
+            "\t on the same assembler with the same solver settings. The shared operator is only \n"
+            "\t reassembled and refactored when the design variables or nodes change. \n"
+            "\t Ignored for nonlinear problems and problems with centrifugal loads.",
+        ],
         # Output Options
         "writeSolution": [
             bool,
@@ -133,6 +332,9 @@ class StaticProblem(TACSProblem):
     BETA = 0.0
     GAMMA = 0.0
 
+    # Operators shared between linear problems, keyed by assembler and settings
+    _sharedOperators = weakref.WeakValueDictionary()
+
     def __init__(
         self,
         name,
@@ -176,6 +378,12 @@ class StaticProblem(TACSProblem):
         self.linearSolver = None
         self.nonlinearSolver = None
 
+        # Shared stiffness operator, if one is in use
+        self.operator = None
+        self._operatorVersion = -1
+        # Flag for auxiliary loads that contribute to the stiffness
+        self._auxStiffness = False
+
         # Default setup for common problem class objects, sets up comm and options
         TACSProblem.__init__(
             self, assembler, comm, options, outputViewer, meshLoader, isNonlinear
@@ -285,11 +493,71 @@ class StaticProblem(TACSProblem):
         # Additional Vecs for updates
         self.update = self.assembler.createVec()
 
+        # Temporary vector for the residual derivative products
+        self.resProd = self.assembler.createVec()
+
     def _createSolver(self):
         """Internal to create the solver objects required by TACS"""
 
         opt = self.getOption
 
+        # Linear problems may share a single operator
+        self.operator = None
+        self._operatorVersion = -1
+        if opt("shareOperator") and not self.isNonlinear and not self._auxStiffness:
+            self._getSharedOperator()
+        else:
+            self._createOperator()
+
+        # Operator, fill level, fill ratio, msub, rtol, ataol
+        if opt("linearSolver").upper() == "GMRES":
+            self.linearSolver = tacs.TACS.KSM(
+                self.K,
+                self.PC,
+                opt("subSpaceSize"),
+                opt("nRestarts"),
+                opt("flexible"),
+            )
+        # TODO: Fix this
+        # elif opt('linearSolver').upper() == 'GCROT':
+        #    self.KSM = tacs.TACS.GCROT(
+        #        self.K, self.PC, opt('subSpaceSize'), opt('subSpaceSize'),
+        #        opt('nRestarts'), opt('flexible'))
+        else:
+            raise self._TACSError(
+                "Unknown linearSolver option. Valid options are " "'GMRES' or 'GCROT'"
+            )
+
+        self.linearSolver.setTolerances(
+            self.getOption("L2ConvergenceRel"), self.getOption("L2Convergence")
+        )
+
+        if opt("useMonitor"):
+            self.linearSolver.setMonitor(
+                self.comm,
+                _descript=opt("linearSolver").upper(),
+                freq=opt("monitorFrequency"),
+            )
+
+        # Pass new matrix and preconditioner to nonlinear solver linear solvers
+        if self.nonlinearSolver is not None:
+            self.nonlinearSolver.linearSolver.setOperators(self.K, self.PC)
+            try:
+                self.nonlinearSolver.innerSolver.linearSolver.setOperators(
+                    self.K, self.PC
+                )
+            except AttributeError:
+                pass
+
+        # Linear solver factor flag
+        self._jacobianUpdateRequired = True
+        self._preconditionerUpdateRequired = True
+
+    def _createOperator(self):
+        """Internal to create the stiffness matrix and preconditioner for this problem"""
+
+        opt = self.getOption
+
         # Tangent Stiffness --- process the ordering option here:
         ordering = opt("orderingType")
 
@@ -335,49 +603,40 @@ class StaticProblem(TACSProblem):
             reorder=reorderSchur,
         )
 
-        # Operator, fill level, fill ratio, msub, rtol, ataol
-        if opt("linearSolver").upper() == "GMRES":
-            self.linearSolver = tacs.TACS.KSM(
-                self.K,
-                self.PC,
-                opt("subSpaceSize"),
-                opt("nRestarts"),
-                opt("flexible"),
-            )
-        # TODO: Fix this
-        # elif opt('linearSolver').upper() == 'GCROT':
-        #    self.KSM = tacs.TACS.GCROT(
-        #        self.K, self.PC, opt('subSpaceSize'), opt('subSpaceSize'),
-        #        opt('nRestarts'), opt('flexible'))
-        else:
-            raise self._TACSError(
-                "Unknown linearSolver option. Valid options are " "'GMRES' or 'GCROT'"
-            )
+    def _getSharedOperator(self):
+        """Internal to find or create the operator shared with other linear problems"""
 
-        self.linearSolver.setTolerances(
-            self.getOption("L2ConvergenceRel"), self.getOption("L2Convergence")
+        opt = self.getOption
+
+        key = (
+            id(self.assembler),
+            opt("orderingType"),
+            opt("PCFillLevel"),
+            opt("PCFillRatio"),
+            opt("RBEStiffnessScaleFactor"),
+            opt("RBEArtificialStiffness"),
         )
 
-        if opt("useMonitor"):
-            self.linearSolver.setMonitor(
+        operator = StaticProblem._sharedOperators.get(key)
+        if operator is None or operator.assembler is not self.assembler:
+            operator = StaticOperator(
+                self.assembler,
                 self.comm,
-                _descript=opt("linearSolver").upper(),
-                freq=opt("monitorFrequency"),
+                opt("orderingType"),
+                opt("PCFillLevel"),
+                opt("PCFillRatio"),
+                self.ALPHA,
+                self.BETA,
+                self.GAMMA,
+                opt("RBEStiffnessScaleFactor"),
+                opt("RBEArtificialStiffness"),
             )
+            StaticProblem._sharedOperators[key] = operator
 
-        # Pass new matrix and preconditioner to nonlinear solver linear solvers
-        if self.nonlinearSolver is not None:
-            self.nonlinearSolver.linearSolver.setOperators(self.K, self.PC)
-            try:
-                self.nonlinearSolver.innerSolver.linearSolver.setOperators(
-                    self.K, self.PC
-                )
-            except AttributeError:
-                pass
-
-        # Linear solver factor flag
-        self._jacobianUpdateRequired = True
-        self._preconditionerUpdateRequired = True
+        self.operator = operator
+        self.K = operator.K
+        self.PC = operator.PC
+        self.rbeArtificialStiffness = operator.rbeArtificialStiffness
 
     def setOption(self, name, value):
         """
@@ -789,6 +1048,20 @@ class StaticProblem(TACSProblem):
         """
         self._addCentrifugalLoad(self.auxElems, omegaVector, rotCenter, firstOrder)
 
+    def _addCentrifugalLoad(self, auxElems, omegaVector, rotCenter, firstOrder=False):
+        """
+        Add a centrifugal load to the auxiliary elements. Centrifugal loads
+        contribute to the stiffness matrix, so a problem with these loads
+        stops sharing its operator with other problems.
+        """
+        TACSProblem._addCentrifugalLoad(
+            self, auxElems, omegaVector, rotCenter, firstOrder
+        )
+        if not self._auxStiffness:
+            self._auxStiffness = True
+            if self.operator is not None:
+                self._createSolver()
+
     def addLoadFromBDF(self, loadID, scale=1.0):
         """
         This method is used to add a fixed load set defined in the BDF file to the problem.
@@ -1025,7 +1298,24 @@ class StaticProblem(TACSProblem):
         applyBCs : bool, optional
             Whether to apply boundary conditions to the jacobian, by default True
         """
-        if self._jacobianUpdateRequired:
+        if self.operator is not None:
+            # The shared operator may have been reassembled by another problem
+            # or with different assembly arguments
+            if (
+                self._jacobianUpdateRequired
+                or self._operatorVersion != self.operator.version
+                or not self.operator.hasAssemblyArgs(self._loadScale, applyBCs)
+            ):
+                self.operator.updateJacobian(
+                    self.x, self.Xpts, loadScale=self._loadScale, applyBCs=applyBCs
+                )
+                self._operatorVersion = self.operator.version
+                self._jacobianUpdateRequired = False
+            if res is not None:
+                self.assembler.assembleRes(
+                    res, loadScale=self._loadScale, applyBCs=applyBCs
+                )
+        elif self._jacobianUpdateRequired:
             # Assemble residual and stiffness matrix (w/o artificial terms)
             self.assembler.assembleJacobian(
                 self.ALPHA,
@@ -1048,9 +1338,12 @@ class StaticProblem(TACSProblem):
 
         The preconditioner will only actually be updated if the
         ``_preconditionerUpdateRequired`` flag is set to True. This occurs
-        whenever the Jacobian is updated.
+        whenever the Jacobian is updated. When the operator is shared, the
+        factorization is only recomputed after the shared matrix changes.
         """
-        if self._preconditionerUpdateRequired:
+        if self.operator is not None:
+            self.operator.updatePreconditioner()
+        elif self._preconditionerUpdateRequired:
             # Stiffness matrix must include artificial terms before pc factor
             # to prevent factorization issues w/ zero-diagonals
             self.K.axpy(1.0, self.rbeArtificialStiffness)
@@ -1236,8 +1529,7 @@ class StaticProblem(TACSProblem):
         adjointFinishedTime = time.time()
         # Evaluate all the adjoint res products at the same time for efficiency:
         if includeDVSens:
-            self.addDVSens(evalFuncs, dvSenses)
-            self.addAdjointResProducts(adjoints, dvSenses)
+            self._addInterleavedDVSens(evalFuncs, adjoints, dvSenses)
         if includeXptSens:
             self.addXptSens(evalFuncs, xptSenses)
             self.addAdjointResXptSensProducts(adjoints, xptSenses)
@@ -1374,6 +1666,47 @@ class StaticProblem(TACSProblem):
                 # Copy values to numpy array
                 dvSensArray[:] = dvSensBVec.getArray()
 
+    def _addInterleavedDVSens(self, evalFuncs, adjointlist, dvSensList):
+        """
+        Add the partial design variable sensitivities and the adjoint
+        products for all the functions in evalFuncs. The contributions
+        are accumulated in a single interleaved design vector so that only
+        one parallel reduction is required for all the functions.
+
+        Parameters
+        ----------
+        evalFuncs : list[str]
+            The functions the user wants returned
+
+        adjointlist : list[tacs.TACS.Vec]
+            List of adjoint vectors for each function
+
+        dvSensList : list[tacs.TACS.Vec]
+            List of sensitivity vectors that are set to the total sensitivity
+        """
+        # Set problem vars to assembler
+        self._updateAssemblerVars()
+
+        funcHandles = [self.functionList[f] for f in evalFuncs]
+
+        # Make sure BC terms are zeroed out in adjoint
+        for adjoint in adjointlist:
+            self.assembler.applyBCs(adjoint)
+
+        # The adjoint products are non-zero for all the design variables,
+        # so the vector is created without the function domains
+        interleavedSens = self.assembler.createInterleavedDesignVec(len(evalFuncs))
+        self.assembler.addDVSensInterleaved(funcHandles, interleavedSens, 1.0)
+        self.assembler.addAdjointResProductsInterleaved(
+            adjointlist, interleavedSens, -1.0
+        )
+
+        # Finalize the sensitivities for all the functions across all procs
+        interleavedSens.beginSetValues()
+        interleavedSens.endSetValues()
+
+        self.assembler.splitInterleavedDesignVec(interleavedSens, dvSensList)
+
     def addAdjointResProducts(self, adjointlist, dvSensList, scale=-1.0):
         """
         Add the adjoint product contribution to the design variable sensitivity arrays
@@ -1526,6 +1859,74 @@ class StaticProblem(TACSProblem):
                 # Copy values to numpy array
                 xptSensArray[:] = xptSensBVec.getArray()
 
+    def addResidualDVSensVecProduct(self, pdx, prod, scale=1.0):
+        """
+        Adds product of the residual design variable derivative and input design direction into output vector as shown below:
+        prod += scale * dR/dx . pdx
+
+        Parameters
+        ----------
+        pdx : tacs.TACS.Vec or numpy.ndarray
+            Design variable direction to product with the residual derivative.
+
+        prod : tacs.TACS.Vec or numpy.ndarray
+            Output vector to add product to.
+
+        scale : float
+            Scalar used to scale product by. Defaults to 1.0
+        """
+        # Set problem vars to assembler
+        self._updateAssemblerVars()
+
+        # Create a tacs BVec copy of the direction if the input is a numpy array
+        if isinstance(pdx, tacs.TACS.Vec):
+            pdxBVec = pdx
+        else:
+            pdxBVec = self._arrayToDesignVec(pdx)
+
+        self.resProd.zeroEntries()
+        self.assembler.addResidualDVSensVecProduct(pdxBVec, self.resProd, scale)
+
+        # Output residual product
+        if isinstance(prod, tacs.TACS.Vec):
+            prod.axpy(1.0, self.resProd)
+        else:
+            prod[:] = prod + self.resProd.getArray()
+
+    def addResidualXptSensVecProduct(self, pXpts, prod, scale=1.0):
+        """
+        Adds product of the residual nodal coordinate derivative and input coordinate direction into output vector as shown below:
+        prod += scale * dR/dXpts . pXpts
+
+        Parameters
+        ----------
+        pXpts : tacs.TACS.Vec or numpy.ndarray
+            Nodal coordinate direction to product with the residual derivative.
+
+        prod : tacs.TACS.Vec or numpy.ndarray
+            Output vector to add product to.
+
+        scale : float
+            Scalar used to scale product by. Defaults to 1.0
+        """
+        # Set problem vars to assembler
+        self._updateAssemblerVars()
+
+        # Create a tacs BVec copy of the direction if the input is a numpy array
+        if isinstance(pXpts, tacs.TACS.Vec):
+            pXptsBVec = pXpts
+        else:
+            pXptsBVec = self._arrayToNodeVec(pXpts)
+
+        self.resProd.zeroEntries()
+        self.assembler.addResidualXptSensVecProduct(pXptsBVec, self.resProd, scale)
+
+        # Output residual product
+        if isinstance(prod, tacs.TACS.Vec):
+            prod.axpy(1.0, self.resProd)
+        else:
+            prod[:] = prod + self.resProd.getArray()
+
     def getResidual(self, res, Fext=None):
         """
         This routine is used to evaluate directly the structural
@@ -1663,6 +2064,10 @@ class StaticProblem(TACSProblem):
         # Set problem vars to assembler
         self._updateAssemblerVars()
 
+        # A shared operator may have been reassembled for another design
+        if self.operator is not None:
+            self.updateJacobian()
+
         if transpose:
             self.K.multTranspose(self.phi, self.res)
         else:
@@ -1690,6 +2095,12 @@ class StaticProblem(TACSProblem):
         self.F.zeroEntries()
         self.auxElems = tacs.TACS.AuxElements()
 
+        # Without centrifugal loads the problem can share its operator again
+        if self._auxStiffness:
+            self._auxStiffness = False
+            if self.getOption("shareOperator") and not self.isNonlinear:
+                self._createSolver()
+
     def solveForward(self, rhs, psi):
         """Solve a linear system using the structural Jacobian.
 
@@ -1746,20 +2157,35 @@ class StaticProblem(TACSProblem):
         self.copyToTACSVec(phi, self.phi)
         self.copyToTACSVec(rhs, self.adjRHS)
 
+        # Solve Linear System
+        self._solveAdjointVec(self.adjRHS, self.phi)
+
+        # Copy output values back to user vectors
+        self.copyFromTACSVec(self.phi, phi)
+
+    def _solveAdjointVec(self, rhs, phi):
+        """
+        Solve the structural adjoint in place. The assembler and the
+        stiffness matrix must already be set up for this problem.
+
+        Parameters
+        ----------
+        rhs : tacs.TACS.Vec
+            Right hand side vector for adjoint solve, the BC entries are zeroed on exit
+        phi : tacs.TACS.Vec
+            Initial guess for the adjoint, overwritten by the solution
+        """
         # Tacs doesn't actually transpose the matrix here so keep track of
         # RHS entries that TACS zeros out for BCs.
         bcTerms = self.update
-        bcTerms.copyValues(self.adjRHS)
-        self.assembler.applyBCs(self.adjRHS)
-        bcTerms.axpy(-1.0, self.adjRHS)
+        bcTerms.copyValues(rhs)
+        self.assembler.applyBCs(rhs)
+        bcTerms.axpy(-1.0, rhs)
 
         # Solve Linear System
-        self.linearSolver.solve(self.adjRHS, self.phi)
+        self.linearSolver.solve(rhs, phi)
         # Add bc terms back in
-        self.phi.axpy(1.0, bcTerms)
-
-        # Copy output values back to user vectors
-        self.copyFromTACSVec(self.phi, phi)
+        phi.axpy(1.0, bcTerms)
 
     def getVariables(self, states=None):
         """
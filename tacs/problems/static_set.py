@@ -0,0 +1,276 @@
+"""
+The main purpose of this class is to solve a set of linear static
+load cases and their function adjoints together at a single design
+point. All of the load cases share one stiffness matrix and
+factorization, and the states and sensitivities are gathered into
+pre-allocated blocks with one row per load case or function.
+
+.. note:: This class should be created using the
+    :meth:`pyTACS.createStaticProblemSet <tacs.pytacs.pyTACS.createStaticProblemSet>` method.
+"""
+
+# =============================================================================
+# Imports
+# =============================================================================
+import time
+
+import numpy as np
+
+from tacs.utilities import BaseUI
+
+
+class StaticProblemSet(BaseUI):
+    # Default options for class
+    defaultOptions = {
+        "printTiming": [
+            bool,
+            False,
+            "Flag for printing out timing information for class procedures.",
+        ],
+    }
+
+    def __init__(self, name, problems, comm, options=None):
+        """
+        NOTE: This class should not be initialized directly by the user.
+        Use pyTACS.createStaticProblemSet instead.
+
+        Parameters
+        ----------
+        name : str
+            Name of this problem set
+
+        problems : list[tacs.problems.StaticProblem]
+            Linear static problems created on the same assembler
+
+        comm : mpi4py.MPI.Intracomm
+            The comm object on which to create the pyTACS object.
+
+        options : dict
+            Dictionary holding problem-specific option parameters (case-insensitive).
+        """
+        # Problem set name
+        self.name = name
+
+        # Default setup for common objects, sets up comm and options
+        BaseUI.__init__(self, options=options, comm=comm)
+
+        self.problems = list(problems)
+        if len(self.problems) == 0:
+            raise self._TACSError("StaticProblemSet requires at least one problem.")
+
+        self.assembler = self.problems[0].assembler
+        for problem in self.problems:
+            if problem.isNonlinear:
+                raise self._TACSError(
+                    f"Problem '{problem.name}' is nonlinear. "
+                    "StaticProblemSet only supports linear problems."
+                )
+            if problem.assembler is not self.assembler:
+                raise self._TACSError(
+                    f"Problem '{problem.name}' does not use the same assembler "
+                    "as the other problems in the set."
+                )
+            # All the load cases use the same operator and factorization
+            if not problem.getOption("shareOperator"):
+                problem.setOption("shareOperator", True)
+
+        # Block of states, row i holds the states for problem i
+        self.states = np.zeros(
+            (len(self.problems), self.problems[0].u_array.size), dtype=self.dtype
+        )
+
+        # Blocks of sensitivities, allocated once the number of functions is known
+        self.dvSens = None
+        self.xptSens = None
+
+    def setDesignVars(self, x):
+        """
+        Update the design variables used by all the problems in the set.
+
+        Parameters
+        ----------
+        x : numpy.ndarray or dict or tacs.TACS.Vec
+            The variables (typically from the optimizer) to set.
+        """
+        for problem in self.problems:
+            problem.setDesignVars(x)
+
+    def setNodes(self, Xpts):
+        """
+        Set the mesh coordinates used by all the problems in the set.
+
+        Parameters
+        ----------
+        Xpts : numpy.ndarray
+            Structural coordinate in array of size (N * 3) where N is
+            the number of structural nodes on this processor.
+        """
+        for problem in self.problems:
+            problem.setNodes(Xpts)
+
+    def solve(self, Fext=None):
+        """
+        Solve all the load cases in the set. The stiffness matrix is
+        assembled and factored at most once for the current design.
+
+        Parameters
+        ----------
+        Fext : list or numpy.ndarray, optional
+            Additional loads with one entry (or row) per problem, by default None
+
+        Returns
+        -------
+        bool
+            Flag indicating whether all the load cases converged
+        """
+        hasConverged = True
+        for i, problem in enumerate(self.problems):
+            if Fext is None:
+                converged = problem.solve()
+            else:
+                converged = problem.solve(Fext[i])
+            hasConverged = hasConverged and converged
+
+            # Gather the states into the pre-allocated block
+            self.states[i, :] = problem.u_array
+
+        return hasConverged
+
+    def evalFunctions(self, funcs, evalFuncs=None):
+        """
+        Evaluate the functions of all the problems in the set. The keys
+        are the same as those returned by StaticProblem.evalFunctions.
+
+        Parameters
+        ----------
+        funcs : dict
+            Dictionary into which the functions are saved.
+        evalFuncs : iterable object containing strings, optional
+            The functions to evaluate. Problems without a given function skip it.
+        """
+        for problem, names in zip(self.problems, self._getFunctionNames(evalFuncs)):
+            problem.evalFunctions(funcs, names)
+
+    def evalFunctionsSens(
+        self, funcsSens, evalFuncs=None, includeDVSens=True, includeXptSens=True
+    ):
+        """
+        Evaluate the derivatives of the functions of all the problems in
+        the set. The adjoint right-hand sides for each load case are
+        assembled together and all of the adjoints are solved against
+        the shared factorization.
+
+        The arrays stored in funcsSens are rows of the pre-allocated
+        ``dvSens`` and ``xptSens`` blocks, so they are overwritten by the
+        next call. Copy them if they need to be kept.
+
+        Parameters
+        ----------
+        funcsSens : dict
+            Dictionary into which the derivatives are saved.
+        evalFuncs : iterable object containing strings, optional
+            The functions the user wants returned
+        includeDVSens : bool, optional
+            Flag to include design variable sensitivities in output. Default is True.
+        includeXptSens : bool, optional
+            Flag to include node location sensitivities in output. Default is True.
+        """
+        startTime = time.time()
+
+        funcNames = self._getFunctionNames(evalFuncs)
+        self._allocateSens(sum(len(names) for names in funcNames))
+
+        adjointTime = 0.0
+        row = 0
+        for problem, names in zip(self.problems, funcNames):
+            if len(names) == 0:
+                continue
+
+            # Set the problem vars and factor the shared operator if needed
+            problem._updateAssemblerVars()
+            problem._initializeSolve()
+
+            dIdus = [problem.dIduList[f] for f in names]
+            adjoints = [problem.adjointList[f] for f in names]
+            for dIdu, adjoint in zip(dIdus, adjoints):
+                dIdu.zeroEntries()
+                adjoint.zeroEntries()
+
+            # Assemble the right-hand sides for all the functions at once
+            handles = [problem.functionList[f] for f in names]
+            self.assembler.addSVSens(
+                handles, dIdus, problem.ALPHA, problem.BETA, problem.GAMMA
+            )
+
+            adjointStartTime = time.time()
+            for dIdu, adjoint in zip(dIdus, adjoints):
+                problem._solveAdjointVec(dIdu, adjoint)
+            adjointTime += time.time() - adjointStartTime
+
+            if includeDVSens:
+                dvSenses = [problem.dvSensList[f] for f in names]
+                problem._addPackedDVSens(names, adjoints, dvSenses)
+                for k, dvSens in enumerate(dvSenses):
+                    self.dvSens[row + k, :] = dvSens.getArray()
+
+            if includeXptSens:
+                xptSenses = [problem.xptSensList[f] for f in names]
+                for xptSens in xptSenses:
+                    xptSens.zeroEntries()
+                problem.addXptSens(names, xptSenses)
+                problem.addAdjointResXptSensProducts(adjoints, xptSenses)
+                for k, xptSens in enumerate(xptSenses):
+                    self.xptSens[row + k, :] = xptSens.getArray()
+
+            # Scatter the rows of the blocks into the output dictionary
+            for k, f in enumerate(names):
+                key = problem.name + "_%s" % f
+                funcsSens[key] = {}
+                if includeDVSens:
+                    funcsSens[key][problem.varName] = self.dvSens[row + k]
+                if includeXptSens:
+                    funcsSens[key][problem.coordName] = self.xptSens[row + k]
+
+            row += len(names)
+
+        totalTime = time.time()
+
+        if self.getOption("printTiming"):
+            self._pp("+--------------------------------------------------+")
+            self._pp("|")
+            self._pp("| TACS Problem Set Adjoint Times:")
+            self._pp("|")
+            self._pp("| %-30s: %10d" % ("Number of Adjoints", row))
+            self._pp("| %-30s: %10.3f sec" % ("TACS Adjoint Solve Time", adjointTime))
+            self._pp(
+                "| %-30s: %10.3f sec"
+                % ("Complete Sensitivity Time", totalTime - startTime)
+            )
+            self._pp("+--------------------------------------------------+")
+
+    def _getFunctionNames(self, evalFuncs):
+        """
+        Get the sorted list of function names to evaluate for each problem
+        """
+        funcNames = []
+        for problem in self.problems:
+            if evalFuncs is None:
+                funcNames.append(sorted(problem.functionList))
+            else:
+                funcNames.append(
+                    sorted(f for f in evalFuncs if f in problem.functionList)
+                )
+        return funcNames
+
+    def _allocateSens(self, numFuncs):
+        """
+        Allocate the sensitivity blocks if the number of functions has changed
+        """
+        if self.dvSens is None or self.dvSens.shape[0] != numFuncs:
+            problem = self.problems[0]
+            self.dvSens = np.zeros(
+                (numFuncs, problem.x.getArray().size), dtype=self.dtype
+            )
+            self.xptSens = np.zeros(
+                (numFuncs, problem.Xpts.getArray().size), dtype=self.dtype
+            )
@@ -58,6 +58,30 @@ class TransientProblem(TACSProblem):
             1,
             "How frequently to reassemble Jacobian during time integration process.",
         ],
+        "adaptiveJacobian": [
+            bool,
+            False,
+            "Flag for reusing the factored Jacobian across Newton iterations and time steps.\n"
+            "\t The Jacobian is refreshed when the residual contraction is too slow.",
+        ],
+        "maxContraction": [
+            float,
+            0.5,
+            "Maximum ratio of successive residual norms before the lagged Jacobian is refreshed.",
+        ],
+        "useMatrixFree": [
+            bool,
+            False,
+            "Flag for solving the Newton updates with matrix-free Jacobian-vector products,\n"
+            "\t preconditioned with the lagged Jacobian.",
+        ],
+        "numSnapshots": [
+            int,
+            0,
+            "Number of state snapshots stored for the adjoint. The remaining states are\n"
+            "\t recomputed using binomial checkpointing. 0 stores the full state history.\n"
+            "\t Only supported by the BDF integrator.",
+        ],
         # Output Options
         "writeSolution": [bool, True, "Flag for suppressing all f5 file writing."],
         "numberSolutions": [
@@ -218,6 +242,11 @@ class TransientProblem(TACSProblem):
                 for i in range((self.numSteps + 1) * self.numStages)
             ]
 
+        # Scratch vectors for the loads applied by iterate(). The integrator
+        # copies any forces it must retain, so these are reused every step.
+        self.FVec = self.assembler.createVec()
+        self.FextVec = self.assembler.createVec()
+
         printLevel = self.getOption("printLevel")
         self.integrator.setPrintLevel(printLevel)
         # Set solver tolerances
@@ -228,6 +257,14 @@ class TransientProblem(TACSProblem):
         # Jacobian assembly frequency
         jacFreq = self.getOption("jacAssemblyFreq")
         self.integrator.setJacAssemblyFreq(jacFreq)
+        # Lagged Jacobian and Jacobian-free Newton-Krylov options
+        self.integrator.setAdaptiveJacobian(
+            self.getOption("adaptiveJacobian"), self.getOption("maxContraction")
+        )
+        self.integrator.setUseMatrixFree(self.getOption("useMatrixFree"))
+        # Limit the stored state history
+        if solverType.upper() == "BDF":
+            self.integrator.setNumSnapshots(self.getOption("numSnapshots"))
 
         # Set output viewer for integrator
         self.integrator.setFH5(self.outputViewer)
@@ -974,7 +1011,7 @@ class TransientProblem(TACSProblem):
             timeIndex = timeStep * self.numStages + timeStage
 
         # set the loads - do not change self.F[timeIndex] in place
-        FVec = self.assembler.createVec()
+        FVec = self.FVec
         FVec.copyValues(self.F[timeIndex])
         if Fext is not None:
             if isinstance(Fext, tacs.TACS.Vec):
@@ -982,10 +1019,9 @@ class TransientProblem(TACSProblem):
             elif isinstance(Fext, np.ndarray):
                 if Fext.ndim > 1:
                     Fext = Fext.ravel()
-                FextVec = self.assembler.createVec()
-                Fext_array = FextVec.getArray()
+                Fext_array = self.FextVec.getArray()
                 Fext_array[:] = Fext
-                FVec.axpy(1.0, FextVec)
+                FVec.axpy(1.0, self.FextVec)
 
         # set the auxiliary elements for this time step (tractions/pressures)
         self.assembler.setAuxElements(self.auxElems[timeIndex])
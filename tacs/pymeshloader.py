@@ -10,7 +10,7 @@ functionality.
 # =============================================================================
 # Imports
 # =============================================================================
-from copy import deepcopy
+from copy import copy, deepcopy
 import itertools as it
 
 import numpy as np
@@ -24,11 +24,13 @@ from tacs.utilities import BaseUI, postinitialize_method
 
 
 class pyMeshLoader(BaseUI):
-    def __init__(self, comm, printDebug=False):
+    def __init__(self, comm, printDebug=False, parseOnRoot=False):
         # Set MPI communicator
         BaseUI.__init__(self, comm=comm)
         # Debug printing flag
         self.printDebug = printDebug
+        # Flag for reading the bdf file on the root proc only
+        self.parseOnRoot = parseOnRoot
         self.bdfInfo = None
 
     def scanBdfFile(self, bdf):
@@ -49,12 +51,21 @@ class pyMeshLoader(BaseUI):
             # Read in bdf file as pynastran object
             # By default we avoid cross-referencing unless we actually need it,
             # since its expensive for large models
-            self.bdfInfo = pn.read_bdf(
-                bdf, validate=False, xref=False, debug=debugPrint
-            )
+            if self.parseOnRoot:
+                # Parse the file once on the root proc and distribute the
+                # model, rather than having every proc read the same file
+                self._readBdfOnRoot(bdf, debugPrint)
+            else:
+                self.bdfInfo = pn.read_bdf(
+                    bdf, validate=False, xref=False, debug=debugPrint
+                )
+                self._setNodeData(self.bdfInfo)
+                self._setElementData(self.bdfInfo)
         # Create a copy of the BDF object
         elif isinstance(bdf, pn.BDF):
             self.bdfInfo = deepcopy(bdf)
+            self._setNodeData(self.bdfInfo)
+            self._setElementData(self.bdfInfo)
         else:
             raise self._TACSError(
                 "BDF input must be provided as a file name 'str' or pyNastran 'BDF' object. "
@@ -68,9 +79,10 @@ class pyMeshLoader(BaseUI):
         # so pynastran doesn't through errors when cross-referencing
         # Loop through all elements and add dummy property, as necessary
         self.bdfInfo.missing_properties = False
-        for element_id in self.bdfInfo.elements:
-            element = self.bdfInfo.elements[element_id]
-            if element.pid not in self.bdfInfo.property_ids:
+        for element_id, pid in zip(
+            self.bdfElementIDs.tolist(), self.bdfElementPIDs.tolist()
+        ):
+            if pid not in self.bdfInfo.property_ids:
                 # If no material properties were found,
                 # add dummy properties and materials
                 matID = 1
@@ -78,7 +90,7 @@ class pyMeshLoader(BaseUI):
                 G = 35.0
                 nu = 0.3
                 self.bdfInfo.add_mat1(matID, E, G, nu)
-                self.bdfInfo.add_pbar(element.pid, matID)
+                self.bdfInfo.add_pbar(pid, matID)
                 # Warn the user that the property card is missing
                 # and should not be read in using pytacs elemCallBackFromBDF method
                 self.bdfInfo.missing_properties = True
@@ -86,13 +98,15 @@ class pyMeshLoader(BaseUI):
                     self._TACSWarning(
                         "Element ID %d references undefined property ID %d in bdf file. "
                         "A user-defined elemCallBack function will need to be provided."
-                        % (element_id, element.pid)
+                        % (element_id, pid)
                     )
 
         # We have to remove any empty property groups that may have been read in from the BDF
-        self.propertyIDToElementIDDict = (
-            self.bdfInfo.get_property_id_to_element_ids_map()
-        )
+        self.propertyIDToElementIDDict = {pid: [] for pid in self.bdfInfo.property_ids}
+        for element_id, pid in zip(
+            self.bdfElementIDs.tolist(), self.bdfElementPIDs.tolist()
+        ):
+            self.propertyIDToElementIDDict[pid].append(element_id)
         pidList = list(self.propertyIDToElementIDDict.keys())
         for pid in pidList:
             # If there are no elements referencing this property card, remove it
@@ -103,19 +117,24 @@ class pyMeshLoader(BaseUI):
         # Create dictionaries for mapping between tacs and nastran id numbering
         self._updateNastranToTACSDicts()
 
-        # Try to get the node x,y,z locations from bdf file
-        try:
-            self.bdfXpts = self.bdfInfo.get_xyz_in_coord(
-                fdtype=self.dtype, sort_ids=False
-            )
-        # If this fails, the file may reference multiple coordinate systems
-        # and will have to be cross-referenced to work
-        except:
-            self.bdfInfo.cross_reference()
-            self.bdfInfo.is_xrefed = True
-            self.bdfXpts = self.bdfInfo.get_xyz_in_coord(
-                fdtype=self.dtype, sort_ids=False
-            )
+        # Try to get the node x,y,z locations from bdf file. When the file is
+        # parsed on the root proc, the other procs do not hold the grid cards
+        # and receive their nodes from TACSCreator instead.
+        if self.bdfElementNodes is None:
+            self.bdfXpts = None
+        else:
+            try:
+                self.bdfXpts = self.bdfInfo.get_xyz_in_coord(
+                    fdtype=self.dtype, sort_ids=False
+                )
+            # If this fails, the file may reference multiple coordinate systems
+            # and will have to be cross-referenced to work
+            except:
+                self.bdfInfo.cross_reference()
+                self.bdfInfo.is_xrefed = True
+                self.bdfXpts = self.bdfInfo.get_xyz_in_coord(
+                    fdtype=self.dtype, sort_ids=False
+                )
 
         # element card contained within each property group (may contain multiple per group)
         # Each entry will eventually have its own tacs element object assigned to it
@@ -157,19 +176,26 @@ class pyMeshLoader(BaseUI):
             else:
                 self.compDescripts.append(f"Property group {pID}")
 
-        # Element connectivity information
-        self.elemConnectivity = [None] * self.bdfInfo.nelements
-        self.elemConnectivityPointer = [None] * (self.bdfInfo.nelements + 1)
+        # Element connectivity information. This is only stored on the procs
+        # that hold the element nodes, since it is only used to set up
+        # TACSCreator on the root proc.
+        numElements = len(self.bdfElementIDs)
+        hasConnectivity = self.bdfElementNodes is not None
+        if hasConnectivity:
+            self.elemConnectivity = [None] * numElements
+            self.elemConnectivityPointer = [None] * (numElements + 1)
+        else:
+            self.elemConnectivity = []
+            self.elemConnectivityPointer = [None]
         self.elemConnectivityPointer[0] = 0
         elementObjectCounter = 0
         # List specifying which tacs element object each element in bdf should point to
-        self.elemObjectNumByElem = [None] * (self.bdfInfo.nelements)
+        self.elemObjectNumByElem = [None] * numElements
 
         # Loop through every element and record information needed for tacs
-        for tacsElementID, nastranElementID in enumerate(self.bdfInfo.element_ids):
-            element = self.bdfInfo.elements[nastranElementID]
-            elementType = element.type.upper()
-            propertyID = element.pid
+        for tacsElementID in range(numElements):
+            elementType = self.bdfElementTypeNames[self.bdfElementTypes[tacsElementID]]
+            propertyID = int(self.bdfElementPIDs[tacsElementID])
             componentID = self.idMap(propertyID, self.nastranToTACSCompIDDict)
 
             # This element type has not been added to the list for the component group yet, so we append it
@@ -185,11 +211,13 @@ class pyMeshLoader(BaseUI):
             ][componentTypeIndex]
 
             # We've identified a ICEM property label
-            if "Shell element data for family" in element.comment:
-                componentName = element.comment.split()[-1]
-                self.compDescripts[componentID] = componentName
+            if tacsElementID in self.bdfElementLabels:
+                self.compDescripts[componentID] = self.bdfElementLabels[tacsElementID]
 
-            conn = element.nodes.copy()
+            if not hasConnectivity:
+                continue
+
+            conn = self._getElementNodes(tacsElementID)
 
             # TACS has a different node ordering than Nastran for certain elements,
             # we now perform the reordering (if necessary)
@@ -224,7 +252,7 @@ class pyMeshLoader(BaseUI):
                 conn, self.nastranToTACSNodeIDDict
             )
             self.elemConnectivityPointer[tacsElementID + 1] = (
-                self.elemConnectivityPointer[tacsElementID] + len(element.nodes)
+                self.elemConnectivityPointer[tacsElementID] + len(conn)
             )
 
         # Allocate list for user-specified tacs element objects
@@ -249,8 +277,8 @@ class pyMeshLoader(BaseUI):
         not just those *owned* by this processor
         """
         # Create Node ID map
-        nastranIDs = self.bdfInfo.node_ids
-        tacsIDs = range(self.bdfInfo.nnodes)
+        nastranIDs = self.bdfNodeIDs.tolist()
+        tacsIDs = range(len(self.bdfNodeIDs))
         nodeTuple = zip(nastranIDs, tacsIDs)
         self.nastranToTACSNodeIDDict = dict(nodeTuple)
 
@@ -261,11 +289,183 @@ class pyMeshLoader(BaseUI):
         self.nastranToTACSCompIDDict = dict(propTuple)
 
         # Create Element ID map
-        nastranIDs = self.bdfInfo.element_ids
-        tacsIDs = range(self.bdfInfo.nelements)
+        nastranIDs = self.bdfElementIDs.tolist()
+        tacsIDs = range(len(self.bdfElementIDs))
         elemTuple = zip(nastranIDs, tacsIDs)
         self.nastranToTACSElemIDDict = dict(elemTuple)
 
+    def _setNodeData(self, bdfInfo):
+        """
+        Record the Nastran ID of each grid in a pyNastran bdf object. The
+        TACS node numbering follows the order of the grids in this array.
+        """
+        self.bdfNodeIDs = np.array(bdfInfo.node_ids, dtype=int)
+
+    def _setElementData(self, bdfInfo):
+        """
+        Record the element data needed to set up TACS from the element cards
+        of a pyNastran bdf object. The data is stored in flat arrays:
+            self.bdfElementIDs[i] = Nastran ID of element i
+            self.bdfElementPIDs[i] = Nastran property ID of element i
+            self.bdfElementTypes[i] = index of the card name of element i in self.bdfElementTypeNames
+            self.bdfElementNodes[self.bdfElementNodePtr[i]:self.bdfElementNodePtr[i+1]] = Nastran node IDs of element i
+            self.bdfElementLabels = dict of ICEM component labels keyed by the element index
+        Missing nodes are stored as -1.
+        """
+        numElements = bdfInfo.nelements
+        self.bdfElementIDs = np.array(bdfInfo.element_ids, dtype=int)
+        self.bdfElementPIDs = np.zeros(numElements, dtype=int)
+        self.bdfElementTypes = np.zeros(numElements, dtype=np.intc)
+        self.bdfElementTypeNames = []
+        self.bdfElementNodePtr = np.zeros(numElements + 1, dtype=int)
+        self.bdfElementLabels = {}
+        typeIndex = {}
+        nodes = []
+        for i, elementID in enumerate(self.bdfElementIDs):
+            element = bdfInfo.elements[elementID]
+            elementType = element.type.upper()
+            if elementType not in typeIndex:
+                typeIndex[elementType] = len(self.bdfElementTypeNames)
+                self.bdfElementTypeNames.append(elementType)
+            self.bdfElementTypes[i] = typeIndex[elementType]
+            self.bdfElementPIDs[i] = element.pid
+            nodes.extend(-1 if n is None else n for n in element.nodes)
+            self.bdfElementNodePtr[i + 1] = len(nodes)
+            if "Shell element data for family" in element.comment:
+                self.bdfElementLabels[i] = element.comment.split()[-1]
+        self.bdfElementNodes = np.array(nodes, dtype=int)
+
+    def _getElementNodes(self, tacsElementID):
+        """
+        Get the list of Nastran node IDs of an element from the element data.
+        """
+        if self.bdfElementNodes is None:
+            raise self._TACSError(
+                "Element connectivity is only stored on the root proc "
+                "when the bdf file is parsed on the root proc."
+            )
+        start = self.bdfElementNodePtr[tacsElementID]
+        end = self.bdfElementNodePtr[tacsElementID + 1]
+        return [None if n < 0 else n for n in self.bdfElementNodes[start:end].tolist()]
+
+    def _bcastArray(self, array, dtype):
+        """
+        Broadcast a numpy array from the root proc as a raw buffer.
+        """
+        if self.comm.rank == 0:
+            array = np.ascontiguousarray(array, dtype=dtype)
+            size = self.comm.bcast(array.size, root=0)
+        else:
+            size = self.comm.bcast(None, root=0)
+            array = np.empty(size, dtype=dtype)
+        self.comm.Bcast(array, root=0)
+        return array
+
+    def _getReferencedNodeIDs(self, bdfInfo, cardTypes):
+        """
+        Find the grid IDs that may be referenced by the cards held in a set
+        of card dictionaries of a bdf object. Every integer field of a card
+        that matches a grid ID is included. This may include a few grids that
+        are not referenced, but never misses one.
+        """
+        nodeIDs = set()
+        for cardType in cardTypes:
+            for cards in getattr(bdfInfo, cardType, {}).values():
+                if not isinstance(cards, list):
+                    cards = [cards]
+                for card in cards:
+                    for field in card.raw_fields():
+                        if isinstance(field, (int, np.integer)) and field in bdfInfo.nodes:
+                            nodeIDs.add(field)
+        return nodeIDs
+
+    def _readBdfOnRoot(self, bdf, debugPrint):
+        """
+        Parse the bdf file on the root proc and distribute the model.
+
+        The root proc keeps the full model. The grid coordinates and element
+        connectivity are only used on the root to set up TACSCreator, which
+        then sends each proc the nodes and elements in its own partition, so
+        they are not sent to the other procs.
+
+        The other procs receive the node IDs, element IDs, property IDs and
+        element types as plain arrays, since these are needed to map between
+        the Nastran and TACS numbering on every proc. The remaining cards
+        (properties, materials, coordinate systems, loads, constraints,
+        masses, rigid elements, design variables and case control) are
+        pickled and broadcast. The element cards are limited to the first
+        card of each property, which is used to set up the elements in
+        pyTACS, and the cards referenced by pressure loads. The grid cards
+        are limited to the grids referenced by the cards that are sent, so
+        that the model can still be cross-referenced on every proc.
+        """
+        bdfInfo = None
+        reducedInfo = None
+        elementInfo = None
+        if self.comm.rank == 0:
+            bdfInfo = pn.read_bdf(bdf, validate=False, xref=False, debug=debugPrint)
+            self._setNodeData(bdfInfo)
+            self._setElementData(bdfInfo)
+
+            # Copy the model, keeping the first element card of each
+            # property and the element cards that are referenced by
+            # pressure loads
+            keepIDs = set()
+            for loadCards in bdfInfo.loads.values():
+                for loadCard in loadCards:
+                    if loadCard.type in ["PLOAD2", "PLOAD4"]:
+                        keepIDs.update(loadCard.eids)
+            pids = set()
+            reducedInfo = copy(bdfInfo)
+            reducedInfo.elements = {}
+            for elementID, element in bdfInfo.elements.items():
+                if element.pid not in pids or elementID in keepIDs:
+                    pids.add(element.pid)
+                    reducedInfo.elements[elementID] = element
+
+            # Keep only the grids referenced by the cards that are sent
+            nodeIDs = self._getReferencedNodeIDs(
+                reducedInfo,
+                [
+                    "elements",
+                    "rigid_elements",
+                    "masses",
+                    "coords",
+                    "loads",
+                    "dload_entities",
+                    "dareas",
+                    "spcs",
+                    "mpcs",
+                    "tics",
+                ],
+            )
+            reducedInfo.nodes = {
+                nid: node for nid, node in bdfInfo.nodes.items() if nid in nodeIDs
+            }
+            elementInfo = (self.bdfElementTypeNames, self.bdfElementLabels)
+
+        # Send the small cards and the element labels as pickled objects
+        reducedInfo = self.comm.bcast(reducedInfo, root=0)
+        elementInfo = self.comm.bcast(elementInfo, root=0)
+
+        # Send the ID numbers and types as raw arrays
+        nodeIDs = self._bcastArray(getattr(self, "bdfNodeIDs", None), int)
+        elementIDs = self._bcastArray(getattr(self, "bdfElementIDs", None), int)
+        elementPIDs = self._bcastArray(getattr(self, "bdfElementPIDs", None), int)
+        elementTypes = self._bcastArray(getattr(self, "bdfElementTypes", None), np.intc)
+
+        if self.comm.rank == 0:
+            self.bdfInfo = bdfInfo
+        else:
+            self.bdfInfo = reducedInfo
+            self.bdfNodeIDs = nodeIDs
+            self.bdfElementIDs = elementIDs
+            self.bdfElementPIDs = elementPIDs
+            self.bdfElementTypes = elementTypes
+            self.bdfElementTypeNames, self.bdfElementLabels = elementInfo
+            self.bdfElementNodePtr = None
+            self.bdfElementNodes = None
+
     def getBDFInfo(self):
         """
         Return pynastran bdf object.
@@ -297,7 +497,7 @@ class pyMeshLoader(BaseUI):
         nNodes : int
             Number of nodes found in bdf file.
         """
-        return self.bdfInfo.nnodes
+        return len(self.nastranToTACSNodeIDDict)
 
     def getNumOwnedNodes(self):
         """
@@ -319,7 +519,7 @@ class pyMeshLoader(BaseUI):
         nElems : int
             Number of elements found in bdf file.
         """
-        return self.bdfInfo.nelements
+        return len(self.bdfElementIDs)
 
     def getBDFNodes(self, nodeIDs, nastranOrdering=False):
         """
@@ -330,6 +530,11 @@ class pyMeshLoader(BaseUI):
         xyz : numpy.ndarray
             Coordinates of specified nodes.
         """
+        if self.bdfXpts is None:
+            raise self._TACSError(
+                "Node locations are only stored on the root proc "
+                "when the bdf file is parsed on the root proc."
+            )
         # Convert to tacs numbering, if necessary
         if nastranOrdering:
             nodeIDs = self.idMap(nodeIDs, self.nastranToTACSNodeIDDict)
@@ -344,8 +549,7 @@ class pyMeshLoader(BaseUI):
         compIDList : list[int]
             List containing componentID of each element found in the bdf file.
         """
-        elements = self.bdfInfo.elements
-        propertyIDList = [elements[eID].pid for eID in self.bdfInfo.element_ids]
+        propertyIDList = self.bdfElementPIDs.tolist()
         compIDList = self.idMap(propertyIDList, self.nastranToTACSCompIDDict)
         return compIDList
 
@@ -373,7 +577,8 @@ class pyMeshLoader(BaseUI):
         compConn = []
         for elementID in elementIDs:
             # We've now got the connectivity for this element, but it is in nastrans node numbering
-            nastranConn = self.bdfInfo.elements[elementID].nodes
+            tacsElementID = self.idMap(elementID, self.nastranToTACSElemIDDict)
+            nastranConn = self._getElementNodes(tacsElementID)
             if nastranOrdering:
                 compConn.append(nastranConn)
             else:
@@ -669,10 +874,8 @@ class pyMeshLoader(BaseUI):
         propertyIDs = [0] * len(componentIDs)
         for i, componentID in enumerate(componentIDs):
             propertyIDs[i] = list(self.bdfInfo.property_ids)[componentID]
-        # Get dictionary whose values are the element ids we are looking for
-        elementIDDict = self.bdfInfo.get_element_ids_dict_with_pids(propertyIDs)
-        # Convert to list
-        elementIDs = list(elementIDDict.values())
+        # Get the element ids we are looking for
+        elementIDs = [self.propertyIDToElementIDDict[pid] for pid in propertyIDs]
         # Make sure list is flat
         elementIDs = self._flatten(elementIDs)
         # Convert to tacs element numbering, if necessary
@@ -738,7 +941,7 @@ class pyMeshLoader(BaseUI):
             Dictionary holding mapping from global to local node IDs for this proc
         """
         globalToLocalNodeIDDict = {}
-        for tacsNodeID in range(self.bdfInfo.nnodes):
+        for tacsNodeID in range(self.getNumBDFNodes()):
             # Get the local ID corresponding to the global ID (if owned by this proc)
             lID = self.getLocalNodeIDsFromGlobal(tacsNodeID, nastranOrdering=False)[0]
             # Add the local node ID to the dict if its owned by this proc
@@ -902,7 +1105,7 @@ class pyMeshLoader(BaseUI):
             conn = np.array([*conn], dtype=np.intc)
             objectNums = np.array(self.elemObjectNumByElem, dtype=np.intc)
             self.creator.setGlobalConnectivity(
-                self.bdfInfo.nnodes, ptr, conn, objectNums
+                self.getNumBDFNodes(), ptr, conn, objectNums
             )
 
             # Set up the boundary conditions
@@ -1046,13 +1249,7 @@ class pyMeshLoader(BaseUI):
             depNodes.append(node)
             depConstrainedDOFs.extend(dofsAsList)
             # add dummy nodes for all lagrange multiplier
-            dummyNodeNum = (
-                max(self.bdfInfo.node_ids) + 1
-            )  # Next available nastran node number
-            # Add the dummy node coincident to the dependent node in x,y,z
-            self.bdfInfo.add_grid(dummyNodeNum, self.bdfInfo.nodes[node].xyz)
-            # Update Nastran to TACS ID mapping dicts, since we just added new nodes to model
-            self.nastranToTACSNodeIDDict[dummyNodeNum] = self.bdfInfo.nnodes - 1
+            dummyNodeNum = self._addMultiplierNode(node)
             dummyNodes.append(dummyNodeNum)
 
         conn = indepNode + depNodes + dummyNodes
@@ -1094,11 +1291,7 @@ class pyMeshLoader(BaseUI):
         depConstrainedDOFs = self.dofStringToList(rbeInfo.refc, varsPerNode)
 
         # add dummy node for lagrange multipliers
-        dummyNodeNum = max(self.bdfInfo.node_ids) + 1  # Next available node number
-        # Add the dummy node coincident to the dependent node in x,y,z
-        self.bdfInfo.add_grid(dummyNodeNum, self.bdfInfo.nodes[depNode[0]].xyz)
-        # Update Nastran to TACS ID mapping dicts, since we just added new nodes to model
-        self.nastranToTACSNodeIDDict[dummyNodeNum] = self.bdfInfo.nnodes - 1
+        dummyNodeNum = self._addMultiplierNode(depNode[0])
         dummyNodes = [dummyNodeNum]
         # Add dummy node to lagrange multiplier node list
         self.numMultiplierNodes += len(dummyNodes)
@@ -1136,6 +1329,28 @@ class pyMeshLoader(BaseUI):
         self.elemObjects.append(rbeObj)
         return
 
+    def _addMultiplierNode(self, nastranNodeID):
+        """
+        Add a dummy node to hold lagrange multipliers for a rigid element.
+
+        Parameters
+        ----------
+        nastranNodeID : int
+            Nastran ID of the node that the dummy node is coincident with.
+
+        Returns
+        -------
+        dummyNodeNum : int
+            Nastran ID of the new node.
+        """
+        # Next available nastran node number
+        dummyNodeNum = max(self.nastranToTACSNodeIDDict) + 1
+        # Add the dummy node coincident to the node in x,y,z
+        self.bdfInfo.add_grid(dummyNodeNum, self.bdfInfo.nodes[nastranNodeID].xyz)
+        # Update Nastran to TACS ID mapping dicts, since we just added new nodes to model
+        self.nastranToTACSNodeIDDict[dummyNodeNum] = len(self.nastranToTACSNodeIDDict)
+        return dummyNodeNum
+
     def _addTACSMassElement(self, massInfo, varsPerNode, dvDict, familyID):
         """
         Method to automatically set up TACS mass elements from bdf file for user.
@@ -1307,7 +1522,7 @@ class pyMeshLoader(BaseUI):
         all_struct_ids = None
         local_maps = self.comm.gather(self._local_map, root=0)
         if self.comm.rank == 0:
-            all_struct_ids = np.zeros((self.bdfInfo.nnodes), dtype=int)
+            all_struct_ids = np.zeros((self.getNumBDFNodes()), dtype=int)
             for local_map in local_maps:
                 for key in local_map:
                     all_struct_ids[int(key)] = map[int(key)]
@@ -1321,7 +1536,7 @@ class pyMeshLoader(BaseUI):
         get the local struct ids owned by this processor, full list when comm is None
         -1 for each idx not owned by this processor
         """
-        num_nodes = self.bdfInfo.nnodes
+        num_nodes = self.getNumBDFNodes()
         bdf_nodes = [_ for _ in range(num_nodes)]
         return self.getLocalNodeIDsFromGlobal(bdf_nodes, nastranOrdering=False)
 
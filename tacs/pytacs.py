@@ -58,6 +58,16 @@ class pyTACS(BaseUI):
             False,
             "Flag for whether to print debug information while loading file.",
         ],
+        "parseBDFOnRoot": [
+            bool,
+            False,
+            "Flag for parsing the bdf file on the root proc only and broadcasting the model to the other procs.\n"
+            "\t This avoids having every proc read and parse the same file, which can be slow for large models.\n"
+            "\t The grid locations and element connectivity are kept on the root proc, which sends each proc\n"
+            "\t only its own partition of the mesh. The bdf object on the other procs only holds the first\n"
+            "\t element card of each property, the element cards referenced by pressure loads and the grids\n"
+            "\t referenced by the cards it holds.",
+        ],
         # Output Options
         "outputElement": [
             int,
@@ -117,6 +127,35 @@ class pyTACS(BaseUI):
             False,
             "Flag for whether to include element coordinate frames in f5 file.",
         ],
+        "connectivityCompression": [
+            int,
+            tacs.TACS.FH5_NO_COMPRESSION,
+            "Storage option for the connectivity zone in the f5 file.\n"
+            "\t Integer data is always stored without loss. Acceptable values are:\n"
+            f"\t\t tacs.TACS.FH5_NO_COMPRESSION = {tacs.TACS.FH5_NO_COMPRESSION}\n"
+            f"\t\t tacs.TACS.FH5_LOSSLESS = {tacs.TACS.FH5_LOSSLESS}",
+        ],
+        "continuousDataCompression": [
+            int,
+            tacs.TACS.FH5_NO_COMPRESSION,
+            "Storage option for the nodes, displacements, loads and reactions in the f5 file.\n"
+            "\t Acceptable values are:\n"
+            f"\t\t tacs.TACS.FH5_NO_COMPRESSION = {tacs.TACS.FH5_NO_COMPRESSION}\n"
+            f"\t\t tacs.TACS.FH5_LOSSLESS = {tacs.TACS.FH5_LOSSLESS}\n"
+            f"\t\t tacs.TACS.FH5_HALF_PRECISION = {tacs.TACS.FH5_HALF_PRECISION}\n"
+            f"\t\t tacs.TACS.FH5_QUANTIZED = {tacs.TACS.FH5_QUANTIZED}",
+        ],
+        "elementDataCompression": [
+            int,
+            tacs.TACS.FH5_NO_COMPRESSION,
+            "Storage option for the strains, stresses, extras and coordinate frames in the f5 file.\n"
+            "\t Acceptable values are the same as for continuousDataCompression.",
+        ],
+        "compressionTol": [
+            float,
+            1e-4,
+            "Error tolerance for quantized f5 storage, relative to the range of each output variable.",
+        ],
         "familySeparator": [
             str,
             "/",
@@ -169,7 +208,8 @@ class pyTACS(BaseUI):
 
         # Create and load mesh loader object.
         debugFlag = self.getOption("printDebug")
-        self.meshLoader = pyMeshLoader(self.comm, debugFlag)
+        parseOnRoot = self.getOption("parseBDFOnRoot")
+        self.meshLoader = pyMeshLoader(self.comm, debugFlag, parseOnRoot)
         self.meshLoader.scanBdfFile(bdf)
         # Save pynastran bdf object
         self.bdfInfo = self.meshLoader.getBDFInfo()
@@ -1566,6 +1606,34 @@ class pyTACS(BaseUI):
         problem.setNodes(self.Xpts0)
         return problem
 
+    @postinitialize_method
+    def createStaticProblemSet(self, name, problems, options=None):
+        """
+        Create a new StaticProblemSet for solving several linear static load
+        cases and their function adjoints together at one design point.
+        The problems in the set share a single stiffness matrix and
+        factorization.
+
+        Parameters
+        ----------
+        name : str
+            Name to assign problem set.
+        problems : list[tacs.problems.StaticProblem]
+            Linear static problems created with createStaticProblem.
+        options : dict
+            Problem-specific options to pass to StaticProblemSet instance (case-insensitive).
+            Defaults to None.
+
+        Returns
+        -------
+        problemSet : tacs.problems.StaticProblemSet
+            StaticProblemSet object used to solve the load cases and sensitivities together.
+        """
+        problemSet = tacs.problems.static_set.StaticProblemSet(
+            name, problems, self.comm, options
+        )
+        return problemSet
+
     @postinitialize_method
     def createTransientProblem(self, name, tInit, tFinal, numSteps, options=None):
         """
@@ -2424,6 +2492,18 @@ class pyTACS(BaseUI):
 
         self.outputViewer = tacs.TACS.ToFH5(self.assembler, elementType, write_flag)
 
+        # Set the storage options for each of the zones
+        tol = self.getOption("compressionTol")
+        self.outputViewer.setZoneCompression(
+            tacs.TACS.CONNECTIVITY_ZONE, self.getOption("connectivityCompression"), tol
+        )
+        self.outputViewer.setZoneCompression(
+            tacs.TACS.CONTINUOUS_ZONE, self.getOption("continuousDataCompression"), tol
+        )
+        self.outputViewer.setZoneCompression(
+            tacs.TACS.ELEMENT_ZONE, self.getOption("elementDataCompression"), tol
+        )
+
         # Set the names of each of the output families
         for i in range(len(self.fam)):
             self.outputViewer.setComponentName(i, self.fam[i])
@@ -0,0 +1,255 @@
+/*
+  Test that the design sensitivities accumulated in an interleaved
+  design vector match the sensitivities accumulated in separate design
+  vectors
+
+  The partial derivatives of several functions, including a function
+  restricted to a subset of the elements, and the products of several
+  adjoint vectors with the derivative of the residual are added to an
+  interleaved design vector with a single parallel reduction. After
+  splitting the interleaved vector, each vector is compared against
+  addDVSens and addAdjointResProducts with one design vector per
+  function.
+
+  The partial derivatives are also added to an interleaved vector whose
+  pattern is created from the function domains. This vector must store
+  fewer entries than one value per function at every design variable,
+  and must give the same derivatives as addDVSens.
+*/
+
+#include "TACSCreator.h"
+#include "TACSElement2D.h"
+#include "TACSKSFailure.h"
+#include "TACSLinearElasticity.h"
+#include "TACSQuadBasis.h"
+#include "TACSStructuralMass.h"
+
+/*
+  Create a plane stress model of a cantilever with one design variable
+  for each of the components
+*/
+TACSAssembler *createAssembler(MPI_Comm comm, int nx, int ny, int ncomp) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSCreator *creator = new TACSCreator(comm, 2);
+  creator->incref();
+
+  if (rank == 0) {
+    int num_nodes = (nx + 1) * (ny + 1);
+    int num_elems = nx * ny;
+    int *ptr = new int[num_elems + 1];
+    int *conn = new int[4 * num_elems];
+    int *ids = new int[num_elems];
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int e = i + nx * j;
+        ptr[e] = 4 * e;
+        ids[e] = (ncomp * i) / nx;
+        conn[4 * e] = i + (nx + 1) * j;
+        conn[4 * e + 1] = i + 1 + (nx + 1) * j;
+        conn[4 * e + 2] = i + (nx + 1) * (j + 1);
+        conn[4 * e + 3] = i + 1 + (nx + 1) * (j + 1);
+      }
+    }
+    ptr[num_elems] = 4 * num_elems;
+    creator->setGlobalConnectivity(num_nodes, num_elems, ptr, conn, ids);
+
+    int *bcs = new int[ny + 1];
+    for (int j = 0; j < ny + 1; j++) {
+      bcs[j] = (nx + 1) * j;
+    }
+    creator->setBoundaryConditions(ny + 1, bcs);
+
+    TacsScalar *X = new TacsScalar[3 * num_nodes];
+    for (int j = 0; j < ny + 1; j++) {
+      for (int i = 0; i < nx + 1; i++) {
+        int n = i + (nx + 1) * j;
+        X[3 * n] = 4.0 * i / nx;
+        X[3 * n + 1] = (1.0 * j) / ny + 0.05 * sin(1.0 * i);
+        X[3 * n + 2] = 0.0;
+      }
+    }
+    creator->setNodes(X);
+
+    delete[] ptr;
+    delete[] conn;
+    delete[] ids;
+    delete[] bcs;
+    delete[] X;
+  }
+
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2700.0, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TACSElementBasis *basis = new TACSLinearQuadBasis();
+  TACSElement **elems = new TACSElement *[ncomp];
+  for (int k = 0; k < ncomp; k++) {
+    TacsScalar t = 0.1 + 0.02 * k;
+    TACSPlaneStressConstitutive *con =
+        new TACSPlaneStressConstitutive(props, t, k, 0.01, 1.0);
+    TACSLinearElasticity2D *model =
+        new TACSLinearElasticity2D(con, TACS_NONLINEAR_STRAIN);
+    elems[k] = new TACSElement2D(model, basis);
+  }
+  creator->setElements(ncomp, elems);
+  delete[] elems;
+
+  TACSAssembler *assembler = creator->createTACS();
+  creator->decref();
+
+  return assembler;
+}
+
+/*
+  Compute the relative difference between two vectors
+*/
+double relDiff(TACSBVec *a, TACSBVec *b, TACSBVec *temp) {
+  temp->copyValues(a);
+  temp->axpy(-1.0, b);
+  double norm = TacsRealPart(a->norm());
+  double diff = TacsRealPart(temp->norm());
+  return (norm > 0.0 ? diff / norm : diff);
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  const int ncomp = 5;
+  TACSAssembler *assembler = createAssembler(comm, 20, 6, ncomp);
+  assembler->incref();
+
+  // Set a state that produces non-trivial failure values
+  TACSBVec *ans = assembler->createVec();
+  ans->incref();
+  ans->setRand(-0.01, 0.01);
+  assembler->setBCs(ans);
+  assembler->setVariables(ans, ans, ans);
+
+  // Create the functions. The last failure function only depends on
+  // the design variables of the elements in its domain.
+  const int num_funcs = 3;
+  int sub_domain[] = {0, 1, 20, 21};
+  TACSKSFailure *ks1 = new TACSKSFailure(assembler, 30.0);
+  TACSKSFailure *ks2 = new TACSKSFailure(assembler, 50.0);
+  ks2->setDomain(4, sub_domain);
+  TACSFunction *funcs[num_funcs];
+  funcs[0] = ks1;
+  funcs[1] = new TACSStructuralMass(assembler);
+  funcs[2] = ks2;
+
+  TACSBVec *adjoints[num_funcs], *dfdx[num_funcs], *split[num_funcs];
+  TACSBVec *dfdx_partial[num_funcs];
+  for (int k = 0; k < num_funcs; k++) {
+    funcs[k]->incref();
+    adjoints[k] = assembler->createVec();
+    adjoints[k]->incref();
+    adjoints[k]->setRand(-1.0, 1.0);
+    assembler->applyBCs(adjoints[k]);
+    dfdx[k] = assembler->createDesignVec();
+    dfdx[k]->incref();
+    split[k] = assembler->createDesignVec();
+    split[k]->incref();
+    dfdx_partial[k] = assembler->createDesignVec();
+    dfdx_partial[k]->incref();
+  }
+
+  TacsScalar fvals[num_funcs];
+  assembler->evalFunctions(num_funcs, funcs, fvals);
+
+  // Accumulate the sensitivities in separate design vectors
+  const TacsScalar lambda = 0.75;
+  assembler->addDVSens(1.0, num_funcs, funcs, dfdx_partial);
+  assembler->addDVSens(1.0, num_funcs, funcs, dfdx);
+  assembler->addAdjointResProducts(-1.0, num_funcs, adjoints, dfdx, lambda);
+  for (int k = 0; k < num_funcs; k++) {
+    dfdx[k]->beginSetValues(TACS_ADD_VALUES);
+    dfdx[k]->endSetValues(TACS_ADD_VALUES);
+    dfdx_partial[k]->beginSetValues(TACS_ADD_VALUES);
+    dfdx_partial[k]->endSetValues(TACS_ADD_VALUES);
+  }
+
+  // Accumulate the sensitivities in the interleaved design vector with
+  // the full pattern
+  TACSInterleavedBVec *interleaved =
+      assembler->createInterleavedDesignVec(num_funcs);
+  interleaved->incref();
+  assembler->addDVSensInterleaved(1.0, num_funcs, funcs, interleaved);
+  assembler->addAdjointResProductsInterleaved(-1.0, num_funcs, adjoints,
+                                              interleaved, lambda);
+  interleaved->beginSetValues();
+  interleaved->endSetValues();
+  assembler->splitInterleavedDesignVec(interleaved, num_funcs, split);
+
+  // Compare the derivatives
+  const double tol = 1e-12;
+  int fail = 0;
+  TACSBVec *dx = assembler->createDesignVec();
+  dx->incref();
+  for (int k = 0; k < num_funcs; k++) {
+    double err = relDiff(dfdx[k], split[k], dx);
+    int func_fail = !(err < tol);
+    fail = fail || func_fail;
+    if (rank == 0) {
+      printf("%-20s dfdx %10.3e %s\n", funcs[k]->getObjectName(), err,
+             func_fail ? "FAILED" : "");
+    }
+  }
+
+  // Accumulate the partial derivatives in an interleaved vector with
+  // the pattern from the function domains
+  TACSInterleavedBVec *partial =
+      assembler->createInterleavedDesignVec(num_funcs, funcs);
+  partial->incref();
+  assembler->addDVSensInterleaved(1.0, num_funcs, funcs, partial);
+  partial->beginSetValues();
+  partial->endSetValues();
+  assembler->splitInterleavedDesignVec(partial, num_funcs, split);
+
+  for (int k = 0; k < num_funcs; k++) {
+    double err = relDiff(dfdx_partial[k], split[k], dx);
+    int func_fail = !(err < tol);
+    fail = fail || func_fail;
+    if (rank == 0) {
+      printf("%-20s partial dfdx %10.3e %s\n", funcs[k]->getObjectName(),
+             err, func_fail ? "FAILED" : "");
+    }
+  }
+
+  // Check that the sub-domain function is not stored at every design
+  // variable
+  int num_entries[2], local_entries[2];
+  local_entries[0] = partial->getNumEntries();
+  local_entries[1] = interleaved->getNumEntries();
+  MPI_Allreduce(local_entries, num_entries, 2, MPI_INT, MPI_SUM, comm);
+  int sparse_fail = !(num_entries[0] < num_entries[1]);
+  fail = fail || sparse_fail;
+  if (rank == 0) {
+    printf("Interleaved entries: %d with function domains, %d full %s\n",
+           num_entries[0], num_entries[1], sparse_fail ? "FAILED" : "");
+  }
+
+  if (rank == 0) {
+    printf("Interleaved design sensitivities: %s\n",
+           fail ? "FAILED" : "PASSED");
+  }
+
+  dx->decref();
+  interleaved->decref();
+  partial->decref();
+  for (int k = 0; k < num_funcs; k++) {
+    funcs[k]->decref();
+    adjoints[k]->decref();
+    dfdx[k]->decref();
+    split[k]->decref();
+    dfdx_partial[k]->decref();
+  }
+  ans->decref();
+  assembler->decref();
+
+  MPI_Finalize();
+  return fail;
+}
@@ -0,0 +1,217 @@
+/*
+  Test that the memory predicted in dry-run mode matches the memory
+  used by the preconditioners
+
+  Each of the preconditioners with a factorization is created for the
+  stiffness matrix of a plate, first in dry-run mode and then for real.
+  The bytes predicted in dry-run mode must equal the bytes recorded
+  when the preconditioner is created and factored. The predicted bytes
+  must not be recorded as current memory, and all the bytes must be
+  released when the preconditioners are deleted.
+*/
+
+#include <math.h>
+
+#include "TACSCreator.h"
+#include "TACSElement2D.h"
+#include "TACSLinearElasticity.h"
+#include "TACSMemoryTracker.h"
+#include "TACSQuadBasis.h"
+#include "TACSSchurMat.h"
+
+/*
+  Create a plane stress model of a cantilever plate
+*/
+TACSAssembler *createAssembler(MPI_Comm comm, int nx, int ny) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSCreator *creator = new TACSCreator(comm, 2);
+  creator->incref();
+
+  if (rank == 0) {
+    int num_nodes = (nx + 1) * (ny + 1);
+    int num_elems = nx * ny;
+    int *ptr = new int[num_elems + 1];
+    int *conn = new int[4 * num_elems];
+    int *ids = new int[num_elems];
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int e = i + nx * j;
+        ptr[e] = 4 * e;
+        ids[e] = 0;
+        conn[4 * e] = i + (nx + 1) * j;
+        conn[4 * e + 1] = i + 1 + (nx + 1) * j;
+        conn[4 * e + 2] = i + (nx + 1) * (j + 1);
+        conn[4 * e + 3] = i + 1 + (nx + 1) * (j + 1);
+      }
+    }
+    ptr[num_elems] = 4 * num_elems;
+    creator->setGlobalConnectivity(num_nodes, num_elems, ptr, conn, ids);
+
+    int *bcs = new int[ny + 1];
+    for (int j = 0; j < ny + 1; j++) {
+      bcs[j] = (nx + 1) * j;
+    }
+    creator->setBoundaryConditions(ny + 1, bcs);
+
+    TacsScalar *X = new TacsScalar[3 * num_nodes];
+    for (int j = 0; j < ny + 1; j++) {
+      for (int i = 0; i < nx + 1; i++) {
+        int n = i + (nx + 1) * j;
+        X[3 * n] = 4.0 * i / nx;
+        X[3 * n + 1] = (1.0 * j) / ny;
+        X[3 * n + 2] = 0.0;
+      }
+    }
+    creator->setNodes(X);
+
+    delete[] ptr;
+    delete[] conn;
+    delete[] ids;
+    delete[] bcs;
+    delete[] X;
+  }
+
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2700.0, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TACSPlaneStressConstitutive *con = new TACSPlaneStressConstitutive(props);
+  TACSLinearElasticity2D *model =
+      new TACSLinearElasticity2D(con, TACS_LINEAR_STRAIN);
+  TACSElement *elem = new TACSElement2D(model, new TACSLinearQuadBasis());
+  creator->setElements(1, &elem);
+
+  TACSAssembler *assembler = creator->createTACS();
+  creator->decref();
+
+  return assembler;
+}
+
+/*
+  Create one of the preconditioners
+*/
+TACSPc *createPc(int type, TACSParallelMat *mat, TACSSchurMat *schur_mat) {
+  int lev_fill = 2;
+  double fill = 5.0;
+  if (type == 0) {
+    return new TACSSchurPc(schur_mat, 10000, 10.0, 1);
+  } else if (type == 1) {
+    return new TACSAdditiveSchwarz(mat, lev_fill, fill);
+  } else if (type == 2) {
+    return new TACSApproximateSchur(mat, lev_fill, fill, 10);
+  }
+  return new TACSBlockCyclicPc(mat);
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSAssembler *assembler = createAssembler(comm, 24, 12);
+  assembler->incref();
+
+  TACSParallelMat *mat = assembler->createMat();
+  TACSSchurMat *schur_mat = assembler->createSchurMat();
+  mat->incref();
+  schur_mat->incref();
+  assembler->assembleJacobian(1.0, 0.0, 0.0, NULL, mat);
+  assembler->assembleJacobian(1.0, 0.0, 0.0, NULL, schur_mat);
+
+  const int num_pcs = 4;
+  const char *pc_names[] = {"TACSSchurPc", "TACSAdditiveSchwarz",
+                            "TACSApproximateSchur", "TACSBlockCyclicPc"};
+  int fail = 0;
+  for (int k = 0; k < num_pcs; k++) {
+    double current = TACSMemoryTracker::getCurrentBytes();
+    double predicted = TACSMemoryTracker::getCurrentBytes(NULL, 1);
+
+    // Predict the memory for the preconditioner in dry-run mode
+    TACSMemoryTracker::setDryRun(1);
+    TACSPc *dry_pc = createPc(k, mat, schur_mat);
+    dry_pc->incref();
+    TACSMemoryTracker::setDryRun(0);
+    double dry_bytes = TACSMemoryTracker::getCurrentBytes(NULL, 1) - predicted;
+    double dry_current = TACSMemoryTracker::getCurrentBytes() - current;
+    dry_pc->decref();
+    double dry_left = TACSMemoryTracker::getCurrentBytes(NULL, 1) - predicted;
+
+    // Create and factor the preconditioner
+    TACSPc *pc = createPc(k, mat, schur_mat);
+    pc->incref();
+    double bytes = TACSMemoryTracker::getCurrentBytes() - current;
+    pc->factor();
+    double factor_bytes = TACSMemoryTracker::getCurrentBytes() - current;
+    pc->decref();
+    double left = TACSMemoryTracker::getCurrentBytes() - current;
+
+    int pc_fail = !(dry_bytes > 0.0 && dry_bytes == bytes &&
+                    bytes == factor_bytes && dry_current == 0.0 &&
+                    dry_left == 0.0 && left == 0.0);
+    if (pc_fail) {
+      fprintf(stderr,
+              "[%d] %s: predicted %.0f actual %.0f factored %.0f "
+              "dry-run current %.0f left %.0f %.0f\n",
+              rank, pc_names[k], dry_bytes, bytes, factor_bytes, dry_current,
+              dry_left, left);
+    }
+
+    // Report the total over all processors
+    double local[2] = {dry_bytes, factor_bytes}, total[2];
+    MPI_Allreduce(local, total, 2, MPI_DOUBLE, MPI_SUM, comm);
+    MPI_Allreduce(MPI_IN_PLACE, &pc_fail, 1, MPI_INT, MPI_MAX, comm);
+    if (rank == 0) {
+      printf("%-22s predicted %10.0f actual %10.0f %s\n", pc_names[k],
+             total[0], total[1], pc_fail ? "FAILED" : "");
+    }
+    fail = fail || pc_fail;
+  }
+
+  // Check that a matrix created in dry-run mode refuses the numerical
+  // operations instead of using the values that were never allocated
+  BCSRMat *Aloc, *Bext;
+  mat->getBCSRMat(&Aloc, &Bext);
+  TACSMemoryTracker::setDryRun(1);
+  BCSRMat *dry_mat = new BCSRMat(MPI_COMM_SELF, Aloc, 2, 5.0);
+  dry_mat->incref();
+  TACSMemoryTracker::setDryRun(0);
+
+  int size = dry_mat->getBlockSize() * dry_mat->getRowDim();
+  TacsScalar *x = new TacsScalar[size];
+  TacsScalar *y = new TacsScalar[size];
+  for (int i = 0; i < size; i++) {
+    x[i] = 1.0;
+    y[i] = 0.0;
+  }
+  dry_mat->zeroEntries();
+  dry_mat->copyValues(Aloc);
+  dry_mat->factor();
+  dry_mat->mult(x, y);
+  dry_mat->applyFactor(x, y);
+  int mat_fail = 0;
+  for (int i = 0; i < size; i++) {
+    if (y[i] != 0.0) {
+      mat_fail = 1;
+    }
+  }
+  delete[] x;
+  delete[] y;
+  dry_mat->decref();
+
+  MPI_Allreduce(MPI_IN_PLACE, &mat_fail, 1, MPI_INT, MPI_MAX, comm);
+  fail = fail || mat_fail;
+  if (rank == 0) {
+    printf("Dry-run BCSRMat operations refused %s\n",
+           mat_fail ? "FAILED" : "");
+    printf("Dry-run memory prediction: %s\n", fail ? "FAILED" : "PASSED");
+  }
+
+  mat->decref();
+  schur_mat->decref();
+  assembler->decref();
+
+  MPI_Finalize();
+  return fail;
+}
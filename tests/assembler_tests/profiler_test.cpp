@@ -0,0 +1,354 @@
+/*
+  Test the scopes, the aggregation and the output of the profiler
+
+  Nested scopes with known call counts, bytes and flops are recorded
+  on each processor. The min/max/avg values over the processors are
+  read back from the JSON file, and the events in the Chrome trace
+  file are counted. The flops recorded by the element, matrix-vector
+  product and factorization kernels are then checked for a plane
+  stress model. The matrix-vector product flops must equal 2*b^2 for
+  each non-zero block of the matrix.
+*/
+
+#include "TACSCreator.h"
+#include "TACSElement2D.h"
+#include "TACSLinearElasticity.h"
+#include "TACSProfiler.h"
+#include "TACSQuadBasis.h"
+#include "TACSSchurMat.h"
+
+/*
+  Create a plane stress model of a cantilever plate
+*/
+TACSAssembler *createAssembler(MPI_Comm comm, int nx, int ny) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSCreator *creator = new TACSCreator(comm, 2);
+  creator->incref();
+
+  if (rank == 0) {
+    int num_nodes = (nx + 1) * (ny + 1);
+    int num_elems = nx * ny;
+    int *ptr = new int[num_elems + 1];
+    int *conn = new int[4 * num_elems];
+    int *ids = new int[num_elems];
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int e = i + nx * j;
+        ptr[e] = 4 * e;
+        ids[e] = 0;
+        conn[4 * e] = i + (nx + 1) * j;
+        conn[4 * e + 1] = i + 1 + (nx + 1) * j;
+        conn[4 * e + 2] = i + (nx + 1) * (j + 1);
+        conn[4 * e + 3] = i + 1 + (nx + 1) * (j + 1);
+      }
+    }
+    ptr[num_elems] = 4 * num_elems;
+    creator->setGlobalConnectivity(num_nodes, num_elems, ptr, conn, ids);
+
+    int *bcs = new int[ny + 1];
+    for (int j = 0; j < ny + 1; j++) {
+      bcs[j] = (nx + 1) * j;
+    }
+    creator->setBoundaryConditions(ny + 1, bcs);
+
+    TacsScalar *X = new TacsScalar[3 * num_nodes];
+    for (int j = 0; j < ny + 1; j++) {
+      for (int i = 0; i < nx + 1; i++) {
+        int n = i + (nx + 1) * j;
+        X[3 * n] = 4.0 * i / nx;
+        X[3 * n + 1] = (1.0 * j) / ny;
+        X[3 * n + 2] = 0.0;
+      }
+    }
+    creator->setNodes(X);
+
+    delete[] ptr;
+    delete[] conn;
+    delete[] ids;
+    delete[] bcs;
+    delete[] X;
+  }
+
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2700.0, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TACSPlaneStressConstitutive *con = new TACSPlaneStressConstitutive(props);
+  TACSLinearElasticity2D *model =
+      new TACSLinearElasticity2D(con, TACS_LINEAR_STRAIN);
+  TACSElement *elem = new TACSElement2D(model, new TACSLinearQuadBasis());
+  creator->setElements(1, &elem);
+
+  TACSAssembler *assembler = creator->createTACS();
+  creator->decref();
+
+  return assembler;
+}
+
+/*
+  Read a file into a string
+*/
+char *readFile(const char *file_name) {
+  FILE *fp = fopen(file_name, "r");
+  if (!fp) {
+    return NULL;
+  }
+  fseek(fp, 0, SEEK_END);
+  long size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  char *str = new char[size + 1];
+  size_t len = fread(str, 1, size, fp);
+  str[len] = '\0';
+  fclose(fp);
+  return str;
+}
+
+/*
+  Read the min/max/avg of a value for the scope with the given path
+  from the JSON output. Returns the position of the scope in the file,
+  or -1 if the scope is not found.
+*/
+long getScopeStats(const char *json, const char *path, const char *value,
+                   double stats[]) {
+  char key[256];
+  snprintf(key, sizeof(key), "{\"path\": \"%s\",", path);
+  const char *scope = strstr(json, key);
+  if (!scope) {
+    return -1;
+  }
+  snprintf(key, sizeof(key), "\"%s\": {", value);
+  const char *p = strstr(scope, key);
+  if (!p || sscanf(p + strlen(key), "\"min\": %lf, \"max\": %lf, \"avg\": %lf",
+                   &stats[0], &stats[1], &stats[2]) != 3) {
+    return -1;
+  }
+  return scope - json;
+}
+
+/*
+  Check that the min/max/avg values of a scope match the expected values
+*/
+int checkScope(const char *json, const char *path, const char *value,
+               double vmin, double vmax, double vavg) {
+  double stats[3];
+  int fail = (getScopeStats(json, path, value, stats) < 0);
+  if (!fail) {
+    double expected[] = {vmin, vmax, vavg};
+    for (int k = 0; k < 3; k++) {
+      if (fabs(stats[k] - expected[k]) > 1e-8 * fabs(expected[k])) {
+        fail = 1;
+      }
+    }
+  }
+  printf("%-24s %-6s min %10.3e max %10.3e avg %10.3e %s\n", path, value,
+         stats[0], stats[1], stats[2], fail ? "FAILED" : "");
+  return fail;
+}
+
+/*
+  Count the occurrences of a string
+*/
+int countString(const char *str, const char *key) {
+  int count = 0;
+  for (const char *p = strstr(str, key); p; p = strstr(p + 1, key)) {
+    count++;
+  }
+  return count;
+}
+
+/*
+  Record nested scopes with known counts and check the aggregated
+  results and the trace events
+*/
+int testScopes(MPI_Comm comm) {
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  TACSProfiler::setEnabled(1, 100);
+  {
+    TACS_PROFILE_SCOPE("outer");
+    for (int k = 0; k < 2; k++) {
+      TACS_PROFILE_SCOPE("inner");
+      TACSProfiler::addCounts(8.0, 10.0);
+    }
+    TACSProfiler::addCounts(0.0, rank + 1.0);
+  }
+  TACSProfiler::begin("other");
+  TACSProfiler::begin("inner");
+  TACSProfiler::end();
+  TACSProfiler::end();
+  if (rank == 0) {
+    TACS_PROFILE_SCOPE("root_only");
+  }
+
+  // The scopes with the same name are combined on each processor
+  int count = 0;
+  TACSProfiler::getTime("inner", &count);
+  int fail = (count != 3);
+
+  const char *json_file = "profiler_test.json";
+  const char *trace_file = "profiler_test_trace.json";
+  fail = TACSProfiler::writeJSON(comm, json_file) || fail;
+  fail = TACSProfiler::writeChromeTrace(comm, trace_file) || fail;
+  TACSProfiler::setEnabled(0);
+
+  if (rank == 0) {
+    char *json = readFile(json_file);
+    char *trace = readFile(trace_file);
+    if (!json || !trace) {
+      fail = 1;
+    } else {
+      // Check the nested scopes and the aggregation over the processors
+      double p = size;
+      fail = checkScope(json, "outer", "count", 1.0, 1.0, 1.0) || fail;
+      fail = checkScope(json, "outer", "flops", 1.0, p, 0.5 * (p + 1.0)) ||
+             fail;
+      fail = checkScope(json, "outer/inner", "count", 2.0, 2.0, 2.0) || fail;
+      fail = checkScope(json, "outer/inner", "bytes", 16.0, 16.0, 16.0) ||
+             fail;
+      fail = checkScope(json, "outer/inner", "flops", 20.0, 20.0, 20.0) ||
+             fail;
+      fail = checkScope(json, "other/inner", "count", 1.0, 1.0, 1.0) || fail;
+      fail = checkScope(json, "root_only", "count", (size > 1 ? 0.0 : 1.0),
+                        1.0, 1.0 / p) ||
+             fail;
+
+      // Parents are written before their children
+      double stats[3];
+      long outer = getScopeStats(json, "outer", "count", stats);
+      long inner = getScopeStats(json, "outer/inner", "count", stats);
+      fail = fail || !(outer < inner);
+
+      // Each processor records 5 events, and rank 0 records one more
+      int num_events = countString(trace, "\"ph\": \"X\"");
+      int num_inner = countString(trace, "\"name\": \"inner\"");
+      int num_nested = countString(trace, "\"path\": \"outer/inner\"");
+      int trace_fail =
+          (num_events != 5 * size + 1 || num_inner != 3 * size ||
+           num_nested != 2 * size);
+      fail = fail || trace_fail;
+      printf("Trace events %d inner %d outer/inner %d %s\n", num_events,
+             num_inner, num_nested, trace_fail ? "FAILED" : "");
+    }
+    delete[] json;
+    delete[] trace;
+    remove(json_file);
+    remove(trace_file);
+  }
+
+  MPI_Bcast(&fail, 1, MPI_INT, 0, comm);
+  return fail;
+}
+
+/*
+  Check the flops recorded by the element, product and factorization
+  kernels
+*/
+int testKernelFlops(MPI_Comm comm) {
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  TACSAssembler *assembler = createAssembler(comm, 24, 12);
+  assembler->incref();
+
+  TACSParallelMat *mat = assembler->createMat();
+  TACSSchurMat *schur_mat = assembler->createSchurMat();
+  mat->incref();
+  schur_mat->incref();
+  TACSBVec *x = assembler->createVec();
+  TACSBVec *y = assembler->createVec();
+  x->incref();
+  y->incref();
+  x->setRand(-1.0, 1.0);
+
+  TACSPc *pc = new TACSAdditiveSchwarz(mat, 2, 5.0);
+  TACSPc *schur_pc = new TACSSchurPc(schur_mat, 10000, 10.0, 1);
+  pc->incref();
+  schur_pc->incref();
+
+  TACSProfiler::setEnabled(1);
+  assembler->assembleRes(y);
+  assembler->assembleJacobian(1.0, 0.0, 0.0, NULL, mat);
+  assembler->assembleJacobian(1.0, 0.0, 0.0, NULL, schur_mat);
+  mat->mult(x, y);
+  pc->factor();
+  schur_pc->factor();
+
+  const char *json_file = "profiler_test.json";
+  int fail = TACSProfiler::writeJSON(comm, json_file);
+  TACSProfiler::setEnabled(0);
+
+  // The flops for the product with the local and external blocks
+  BCSRMat *A, *B;
+  mat->getBCSRMat(&A, &B);
+  double mult_flops = A->getMultFlops() + B->getMultFlops();
+  double total_mult_flops = 0.0;
+  MPI_Reduce(&mult_flops, &total_mult_flops, 1, MPI_DOUBLE, MPI_SUM, 0, comm);
+
+  if (rank == 0) {
+    char *json = readFile(json_file);
+    if (!json) {
+      fail = 1;
+    } else {
+      // The product flops are only known on average over the processors
+      double stats[3];
+      double avg = total_mult_flops / size;
+      int mult_fail =
+          (getScopeStats(json, "TACSParallelMat::mult", "flops", stats) < 0 ||
+           fabs(stats[2] - avg) > 1e-8 * avg || !(avg > 0.0));
+      fail = fail || mult_fail;
+      printf("%-40s flops avg %10.3e %10.3e %s\n", "TACSParallelMat::mult",
+             stats[2], avg, mult_fail ? "FAILED" : "");
+
+      const char *paths[] = {"TACSAssembler::assembleRes/elements",
+                             "TACSAssembler::assembleJacobian/elements",
+                             "TACSAdditiveSchwarz::factor",
+                             "TACSSchurPc::factor"};
+      double flops[4];
+      for (int k = 0; k < 4; k++) {
+        int scope_fail = (getScopeStats(json, paths[k], "flops", stats) < 0 ||
+                          !(stats[0] > 0.0));
+        flops[k] = stats[2];
+        fail = fail || scope_fail;
+        printf("%-40s flops avg %10.3e %s\n", paths[k], stats[2],
+               scope_fail ? "FAILED" : "");
+      }
+
+      // The Jacobian kernels cost more than the residual kernels
+      fail = fail || !(flops[1] > flops[0]);
+    }
+    delete[] json;
+    remove(json_file);
+  }
+
+  MPI_Bcast(&fail, 1, MPI_INT, 0, comm);
+
+  pc->decref();
+  schur_pc->decref();
+  x->decref();
+  y->decref();
+  mat->decref();
+  schur_mat->decref();
+  assembler->decref();
+
+  return fail;
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  int fail = testScopes(comm);
+  fail = testKernelFlops(comm) || fail;
+  if (rank == 0) {
+    printf("Profiler: %s\n", fail ? "FAILED" : "PASSED");
+  }
+
+  MPI_Finalize();
+  return fail;
+}
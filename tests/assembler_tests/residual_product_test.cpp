@@ -0,0 +1,264 @@
+/*
+  Dot-product test for the forward-mode residual products
+
+  The forward products with the derivative of the residual w.r.t. the
+  design variables and the node locations must be the transpose of the
+  adjoint-residual products, so that for random directions p and
+  adjoint vectors q
+
+  <q, dR/dx*p> = <dR/dx^T*q, p>
+
+  This is checked for the 2D and 3D continuum elements and for the
+  linear and nonlinear shell elements, at a state with non-zero
+  velocities and accelerations. The shell node location products are
+  finite-difference approximations in the real build, so they are only
+  checked to the accuracy of the finite-difference step.
+*/
+
+#include <math.h>
+
+#include "TACSCreator.h"
+#include "TACSElement2D.h"
+#include "TACSElement3D.h"
+#include "TACSHexaBasis.h"
+#include "TACSIsoShellConstitutive.h"
+#include "TACSLinearElasticity.h"
+#include "TACSQuadBasis.h"
+#include "TACSShellElementDefs.h"
+
+enum ElementCase { PLANE_STRESS, SOLID, LINEAR_SHELL, NONLINEAR_SHELL };
+
+static const int NUM_CASES = 4;
+static const char *case_names[] = {"TACSElement2D", "TACSElement3D",
+                                   "TACSQuad4Shell", "TACSQuad4NonlinearShell"};
+
+/*
+  Create the element with the given design variable number
+*/
+TACSElement *createElement(ElementCase type, int dvNum) {
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2700.0, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TacsScalar t = 0.1 + 0.01 * dvNum;
+
+  if (type == PLANE_STRESS) {
+    TACSPlaneStressConstitutive *con =
+        new TACSPlaneStressConstitutive(props, t, dvNum, 0.01, 1.0);
+    TACSLinearElasticity2D *model =
+        new TACSLinearElasticity2D(con, TACS_NONLINEAR_STRAIN);
+    return new TACSElement2D(model, new TACSLinearQuadBasis());
+  } else if (type == SOLID) {
+    TACSSolidConstitutive *con =
+        new TACSSolidConstitutive(props, t, dvNum, 0.01, 1.0);
+    TACSLinearElasticity3D *model =
+        new TACSLinearElasticity3D(con, TACS_NONLINEAR_STRAIN);
+    return new TACSElement3D(model, new TACSLinearHexaBasis());
+  }
+
+  TACSShellTransform *transform = new TACSShellNaturalTransform();
+  TACSIsoShellConstitutive *con =
+      new TACSIsoShellConstitutive(props, t, dvNum, 0.01, 1.0);
+  if (type == LINEAR_SHELL) {
+    return new TACSQuad4Shell(transform, con);
+  }
+  return new TACSQuad4NonlinearShell(transform, con);
+}
+
+/*
+  Create a distorted block mesh with one design variable for each of
+  the components. The continuum element in 2D and the shells use a
+  single layer of quadrilaterals.
+*/
+TACSAssembler *createAssembler(MPI_Comm comm, ElementCase type, int nx,
+                               int ny, int ncomp) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  int vars_per_node = 2;
+  if (type == SOLID) {
+    vars_per_node = 3;
+  } else if (type == LINEAR_SHELL || type == NONLINEAR_SHELL) {
+    vars_per_node = 6;
+  }
+  TACSCreator *creator = new TACSCreator(comm, vars_per_node);
+  creator->incref();
+
+  if (rank == 0) {
+    int nz = (type == SOLID ? 2 : 0);
+    int nlayers = (type == SOLID ? nz : 1);
+    int nodes_per_elem = (type == SOLID ? 8 : 4);
+    int layer = (nx + 1) * (ny + 1);
+    int num_nodes = layer * (nz + 1);
+    int num_elems = nx * ny * nlayers;
+    int *ptr = new int[num_elems + 1];
+    int *conn = new int[nodes_per_elem * num_elems];
+    int *ids = new int[num_elems];
+    for (int k = 0; k < nlayers; k++) {
+      for (int j = 0; j < ny; j++) {
+        for (int i = 0; i < nx; i++) {
+          int e = i + nx * j + nx * ny * k;
+          int n = i + (nx + 1) * j + layer * k;
+          int *c = &conn[nodes_per_elem * e];
+          ptr[e] = nodes_per_elem * e;
+          ids[e] = (ncomp * i) / nx;
+          c[0] = n;
+          c[1] = n + 1;
+          c[2] = n + nx + 1;
+          c[3] = n + nx + 2;
+          if (type == SOLID) {
+            for (int m = 0; m < 4; m++) {
+              c[4 + m] = c[m] + layer;
+            }
+          }
+        }
+      }
+    }
+    ptr[num_elems] = nodes_per_elem * num_elems;
+    creator->setGlobalConnectivity(num_nodes, num_elems, ptr, conn, ids);
+
+    int *bcs = new int[ny + 1];
+    for (int j = 0; j < ny + 1; j++) {
+      bcs[j] = (nx + 1) * j;
+    }
+    creator->setBoundaryConditions(ny + 1, bcs);
+
+    TacsScalar *X = new TacsScalar[3 * num_nodes];
+    for (int k = 0; k < nz + 1; k++) {
+      for (int j = 0; j < ny + 1; j++) {
+        for (int i = 0; i < nx + 1; i++) {
+          int n = i + (nx + 1) * j + layer * k;
+          X[3 * n] = 4.0 * i / nx + 0.05 * sin(1.0 * j + 2.0 * k);
+          X[3 * n + 1] = (1.0 * j) / ny + 0.05 * sin(1.0 * i);
+          X[3 * n + 2] = 0.25 * k;
+          if (type == LINEAR_SHELL || type == NONLINEAR_SHELL) {
+            X[3 * n + 2] = 0.1 * sin(0.5 * i) * cos(1.0 * j);
+          }
+        }
+      }
+    }
+    creator->setNodes(X);
+
+    delete[] ptr;
+    delete[] conn;
+    delete[] ids;
+    delete[] bcs;
+    delete[] X;
+  }
+
+  TACSElement **elems = new TACSElement *[ncomp];
+  for (int k = 0; k < ncomp; k++) {
+    elems[k] = createElement(type, k);
+  }
+  creator->setElements(ncomp, elems);
+  delete[] elems;
+
+  TACSAssembler *assembler = creator->createTACS();
+  creator->decref();
+
+  return assembler;
+}
+
+/*
+  Compute the relative difference between the two sides of the test
+*/
+double relError(TacsScalar lhs, TacsScalar rhs) {
+  double a = TacsRealPart(lhs), b = TacsRealPart(rhs);
+  double scale = fmax(fabs(a), fabs(b));
+  return (scale > 0.0 ? fabs(a - b) / scale : 0.0);
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  const double tol = 1e-10;
+#ifdef TACS_USE_COMPLEX
+  const double shell_xpt_tol = tol;
+#else
+  const double shell_xpt_tol = 1e-6;
+#endif  // TACS_USE_COMPLEX
+  int fail = 0;
+  for (int k = 0; k < NUM_CASES; k++) {
+    TACSAssembler *assembler = createAssembler(comm, (ElementCase)k, 12, 4, 3);
+    assembler->incref();
+
+    // Set a state with non-zero velocities and accelerations
+    TACSBVec *vars = assembler->createVec();
+    TACSBVec *dvars = assembler->createVec();
+    TACSBVec *ddvars = assembler->createVec();
+    vars->incref();
+    dvars->incref();
+    ddvars->incref();
+    vars->setRand(-0.01, 0.01);
+    dvars->setRand(-0.1, 0.1);
+    ddvars->setRand(-1.0, 1.0);
+    assembler->setBCs(vars);
+    assembler->setVariables(vars, dvars, ddvars);
+
+    // Create the random adjoint vector and directions
+    TACSBVec *q = assembler->createVec();
+    TACSBVec *res = assembler->createVec();
+    TACSBVec *px = assembler->createDesignVec();
+    TACSBVec *dfdx = assembler->createDesignVec();
+    TACSBVec *pX = assembler->createNodeVec();
+    TACSBVec *dfdX = assembler->createNodeVec();
+    q->incref();
+    res->incref();
+    px->incref();
+    dfdx->incref();
+    pX->incref();
+    dfdX->incref();
+    q->setRand(-1.0, 1.0);
+    assembler->setBCs(q);
+    px->setRand(-1.0, 1.0);
+    pX->setRand(-1.0, 1.0);
+
+    // Test the design variable products
+    double err[2];
+    assembler->addResidualDVSensVecProduct(1.0, px, res);
+    assembler->addAdjointResProducts(1.0, 1, &q, &dfdx);
+    dfdx->beginSetValues(TACS_ADD_VALUES);
+    dfdx->endSetValues(TACS_ADD_VALUES);
+    err[0] = relError(q->dot(res), dfdx->dot(px));
+
+    // Test the node location products
+    res->zeroEntries();
+    assembler->addResidualXptSensVecProduct(1.0, pX, res);
+    assembler->addAdjointResXptSensProducts(1.0, 1, &q, &dfdX);
+    dfdX->beginSetValues(TACS_ADD_VALUES);
+    dfdX->endSetValues(TACS_ADD_VALUES);
+    err[1] = relError(q->dot(res), dfdX->dot(pX));
+
+    double xpt_tol = tol;
+    if (k == LINEAR_SHELL || k == NONLINEAR_SHELL) {
+      xpt_tol = shell_xpt_tol;
+    }
+    int case_fail = !(err[0] < tol && err[1] < xpt_tol);
+    fail = fail || case_fail;
+    if (rank == 0) {
+      printf("%-24s dR/dx %10.3e dR/dXpts %10.3e %s\n", case_names[k], err[0],
+             err[1], case_fail ? "FAILED" : "");
+    }
+
+    q->decref();
+    res->decref();
+    px->decref();
+    dfdx->decref();
+    pX->decref();
+    dfdX->decref();
+    vars->decref();
+    dvars->decref();
+    ddvars->decref();
+    assembler->decref();
+  }
+
+  if (rank == 0) {
+    printf("Residual product dot-product test: %s\n",
+           fail ? "FAILED" : "PASSED");
+  }
+
+  MPI_Finalize();
+  return fail;
+}
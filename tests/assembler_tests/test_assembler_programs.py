@@ -0,0 +1,37 @@
+"""
+Run the compiled C++ tests in this directory.
+
+The programs are built into bin/ by running "make" (or "make complex") in
+this directory after the TACS library has been built. See
+compiled_program_base_test.py for how they are run.
+"""
+
+import os
+import sys
+
+base_dir = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(base_dir, "..", "integration_tests"))
+
+from compiled_program_base_test import ProgramTestCase
+
+
+class ProgramTest(ProgramTestCase):
+    program_dir = base_dir
+
+    def test_interleaved_sens(self):
+        self.run_program("interleaved_sens_test", 2)
+
+    def test_residual_product(self):
+        self.run_program("residual_product_test", 2)
+
+    def test_profiler(self):
+        self.run_program("profiler_test", 2)
+
+    def test_weighted_partition(self):
+        self.run_program("weighted_partition_test", 3)
+
+    def test_threaded_assembly(self):
+        self.run_program("threaded_assembly_test", 2)
+
+    def test_memory_dry_run(self):
+        self.run_program("memory_dry_run_test", 2)
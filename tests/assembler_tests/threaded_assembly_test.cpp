@@ -0,0 +1,280 @@
+/*
+  Test that the residual and Jacobian assembled with several threads
+  match the residual and Jacobian assembled with a single thread
+
+  The threaded assembly adds each element contribution to the global
+  residual and matrix as the elements are completed, so the sums are
+  only reordered. The grouped element order computed by
+  computeElementOrdering() also only reorders the sums. Auxiliary
+  elements are added to a subset of the elements, and the assembly is
+  repeated with a load factor that is not one, so that the auxiliary
+  contributions are scaled. All the results must agree to round-off
+  with the single-threaded assembly in the natural element order.
+*/
+
+#include "TACSCreator.h"
+#include "TACSElement2D.h"
+#include "TACSLinearElasticity.h"
+#include "TACSQuadBasis.h"
+#include "TACSTraction2D.h"
+
+/*
+  A plane stress constitutive class of a different type, used to place
+  some of the components in a second assembly group
+*/
+class PlaneStressGroup : public TACSPlaneStressConstitutive {
+ public:
+  PlaneStressGroup(TACSMaterialProperties *props, TacsScalar t, int tNum,
+                   TacsScalar tlb, TacsScalar tub)
+      : TACSPlaneStressConstitutive(props, t, tNum, tlb, tub) {}
+};
+
+/*
+  Create a plane stress model of a cantilever with one design variable
+  for each of the components. The odd components use a constitutive
+  object of a different type.
+*/
+TACSAssembler *createAssembler(MPI_Comm comm, int nx, int ny, int ncomp) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSCreator *creator = new TACSCreator(comm, 2);
+  creator->incref();
+
+  if (rank == 0) {
+    int num_nodes = (nx + 1) * (ny + 1);
+    int num_elems = nx * ny;
+    int *ptr = new int[num_elems + 1];
+    int *conn = new int[4 * num_elems];
+    int *ids = new int[num_elems];
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int e = i + nx * j;
+        ptr[e] = 4 * e;
+        ids[e] = (ncomp * i) / nx;
+        conn[4 * e] = i + (nx + 1) * j;
+        conn[4 * e + 1] = i + 1 + (nx + 1) * j;
+        conn[4 * e + 2] = i + (nx + 1) * (j + 1);
+        conn[4 * e + 3] = i + 1 + (nx + 1) * (j + 1);
+      }
+    }
+    ptr[num_elems] = 4 * num_elems;
+    creator->setGlobalConnectivity(num_nodes, num_elems, ptr, conn, ids);
+
+    int *bcs = new int[ny + 1];
+    for (int j = 0; j < ny + 1; j++) {
+      bcs[j] = (nx + 1) * j;
+    }
+    creator->setBoundaryConditions(ny + 1, bcs);
+
+    TacsScalar *X = new TacsScalar[3 * num_nodes];
+    for (int j = 0; j < ny + 1; j++) {
+      for (int i = 0; i < nx + 1; i++) {
+        int n = i + (nx + 1) * j;
+        X[3 * n] = 4.0 * i / nx;
+        X[3 * n + 1] = (1.0 * j) / ny + 0.05 * sin(1.0 * i);
+        X[3 * n + 2] = 0.0;
+      }
+    }
+    creator->setNodes(X);
+
+    delete[] ptr;
+    delete[] conn;
+    delete[] ids;
+    delete[] bcs;
+    delete[] X;
+  }
+
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2700.0, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TACSElementBasis *basis = new TACSLinearQuadBasis();
+  TACSElement **elems = new TACSElement *[ncomp];
+  for (int k = 0; k < ncomp; k++) {
+    TacsScalar t = 0.1 + 0.02 * k;
+    TACSPlaneStressConstitutive *con = NULL;
+    if (k % 2 == 0) {
+      con = new TACSPlaneStressConstitutive(props, t, k, 0.01, 1.0);
+    } else {
+      con = new PlaneStressGroup(props, t, k, 0.01, 1.0);
+    }
+    TACSLinearElasticity2D *model =
+        new TACSLinearElasticity2D(con, TACS_NONLINEAR_STRAIN);
+    elems[k] = new TACSElement2D(model, basis);
+  }
+  creator->setElements(ncomp, elems);
+  delete[] elems;
+
+  TACSAssembler *assembler = creator->createTACS();
+  creator->decref();
+
+  return assembler;
+}
+
+/*
+  Add a traction and a second plane stress element to every third
+  local element
+*/
+void addAuxElements(TACSAssembler *assembler) {
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2700.0, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TACSElementBasis *basis = new TACSLinearQuadBasis();
+  TACSPlaneStressConstitutive *con =
+      new TACSPlaneStressConstitutive(props, 0.05);
+  TACSLinearElasticity2D *model =
+      new TACSLinearElasticity2D(con, TACS_NONLINEAR_STRAIN);
+  TACSElement *stiff = new TACSElement2D(model, basis);
+  TacsScalar trac[] = {1.0, -2.0};
+  TACSElement *traction = new TACSTraction2D(2, 0, basis, trac);
+
+  TACSAuxElements *aux = new TACSAuxElements();
+  for (int i = assembler->getNumElements() - 1; i >= 0; i -= 3) {
+    aux->addElement(i, traction);
+    aux->addElement(i, stiff);
+  }
+  assembler->setAuxElements(aux);
+}
+
+/*
+  Compute the relative difference between two vectors
+*/
+double relDiff(TACSBVec *a, TACSBVec *b, TACSBVec *temp) {
+  temp->copyValues(a);
+  temp->axpy(-1.0, b);
+  double norm = TacsRealPart(a->norm());
+  double diff = TacsRealPart(temp->norm());
+  return (norm > 0.0 ? diff / norm : diff);
+}
+
+/*
+  Assemble the residual, and the Jacobian and its residual. The
+  Jacobian is returned through its product with the vector x.
+*/
+void assemble(TACSAssembler *assembler, TacsScalar lambda, TACSParallelMat *mat,
+              TACSBVec *x, TACSBVec *res, TACSBVec *jac_res, TACSBVec *prod) {
+  const TacsScalar alpha = 1.0, beta = 0.3, gamma = 0.1;
+  assembler->assembleRes(res, lambda);
+  assembler->assembleJacobian(alpha, beta, gamma, jac_res, mat,
+                              TACS_MAT_NORMAL, lambda);
+  mat->mult(x, prod);
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSAssembler *assembler = createAssembler(comm, 20, 6, 5);
+  assembler->incref();
+  addAuxElements(assembler);
+
+  // Set random states so that every element contributes to the residual
+  TACSBVec *vars = assembler->createVec();
+  TACSBVec *dvars = assembler->createVec();
+  TACSBVec *ddvars = assembler->createVec();
+  vars->incref();
+  dvars->incref();
+  ddvars->incref();
+  vars->setRand(-0.01, 0.01);
+  dvars->setRand(-1.0, 1.0);
+  ddvars->setRand(-1.0, 1.0);
+  assembler->setVariables(vars, dvars, ddvars);
+
+  TACSParallelMat *mat = assembler->createMat();
+  mat->incref();
+  TACSBVec *x = assembler->createVec();
+  x->incref();
+  x->setRand(-1.0, 1.0);
+
+  // Assemble the reference values with a single thread in the
+  // natural element order
+  const int num_lambdas = 2;
+  const TacsScalar lambdas[] = {1.0, 0.75};
+  TACSBVec *res_ref[num_lambdas], *jac_res_ref[num_lambdas];
+  TACSBVec *prod_ref[num_lambdas];
+  assembler->setNumThreads(1);
+  for (int j = 0; j < num_lambdas; j++) {
+    res_ref[j] = assembler->createVec();
+    jac_res_ref[j] = assembler->createVec();
+    prod_ref[j] = assembler->createVec();
+    res_ref[j]->incref();
+    jac_res_ref[j]->incref();
+    prod_ref[j]->incref();
+    assemble(assembler, lambdas[j], mat, x, res_ref[j], jac_res_ref[j],
+             prod_ref[j]);
+  }
+
+  TACSBVec *res = assembler->createVec();
+  TACSBVec *jac_res = assembler->createVec();
+  TACSBVec *prod = assembler->createVec();
+  TACSBVec *temp = assembler->createVec();
+  res->incref();
+  jac_res->incref();
+  prod->incref();
+  temp->incref();
+
+  const double tol = 1e-12;
+  int fail = 0;
+  const int num_threads[] = {1, 2, 4};
+  for (int ordered = 0; ordered < 2; ordered++) {
+    if (ordered) {
+      assembler->computeElementOrdering();
+      int num_groups = assembler->getElementOrdering(NULL, NULL);
+      int max_groups = 0;
+      MPI_Allreduce(&num_groups, &max_groups, 1, MPI_INT, MPI_MAX, comm);
+      fail = fail || (max_groups != 2);
+      if (rank == 0) {
+        printf("Element ordering with %d groups %s\n", max_groups,
+               max_groups != 2 ? "FAILED" : "");
+      }
+    }
+
+    for (int i = 0; i < 3; i++) {
+      assembler->setNumThreads(num_threads[i]);
+      for (int j = 0; j < num_lambdas; j++) {
+        res->setRand(-1.0, 1.0);
+        jac_res->setRand(-1.0, 1.0);
+        prod->setRand(-1.0, 1.0);
+        assemble(assembler, lambdas[j], mat, x, res, jac_res, prod);
+
+        double res_err = relDiff(res_ref[j], res, temp);
+        double jac_res_err = relDiff(jac_res_ref[j], jac_res, temp);
+        double prod_err = relDiff(prod_ref[j], prod, temp);
+        int test_fail =
+            !(res_err < tol && jac_res_err < tol && prod_err < tol);
+        fail = fail || test_fail;
+        if (rank == 0) {
+          printf(
+              "%s threads %d lambda %4.2f: res %10.3e jac res %10.3e "
+              "jac %10.3e %s\n",
+              ordered ? "Grouped" : "Natural", num_threads[i],
+              TacsRealPart(lambdas[j]), res_err, jac_res_err, prod_err,
+              test_fail ? "FAILED" : "");
+        }
+      }
+    }
+  }
+  if (rank == 0) {
+    printf("Threaded assembly: %s\n", fail ? "FAILED" : "PASSED");
+  }
+
+  for (int j = 0; j < num_lambdas; j++) {
+    res_ref[j]->decref();
+    jac_res_ref[j]->decref();
+    prod_ref[j]->decref();
+  }
+  vars->decref();
+  dvars->decref();
+  ddvars->decref();
+  res->decref();
+  jac_res->decref();
+  prod->decref();
+  temp->decref();
+  x->decref();
+  mat->decref();
+  assembler->decref();
+
+  MPI_Finalize();
+  return fail;
+}
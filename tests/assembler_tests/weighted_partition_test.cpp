@@ -0,0 +1,270 @@
+/*
+  Test that the weighted mesh partition is valid and balanced
+
+  A plate is meshed with elements that have a cost of one on the left
+  half and four on the right half. The mesh is partitioned with these
+  costs as weights. Each processor must own at least one element, the
+  TACSAssembler object must contain the elements assigned to the
+  processor, and the total cost on each processor must be within a
+  small tolerance of the average. The element costs are then measured,
+  gathered on the root processor and used to partition the mesh again.
+  The costs must be gathered in the global element order and the new
+  TACSAssembler object must give the same residual as the first one.
+*/
+
+#include <math.h>
+
+#include "TACSCreator.h"
+#include "TACSElement2D.h"
+#include "TACSLinearElasticity.h"
+#include "TACSQuadBasis.h"
+
+/*
+  Set the mesh for a cantilever plate on the root processor
+*/
+void setMesh(TACSCreator *creator, int nx, int ny) {
+  int num_nodes = (nx + 1) * (ny + 1);
+  int num_elems = nx * ny;
+  int *ptr = new int[num_elems + 1];
+  int *conn = new int[4 * num_elems];
+  int *ids = new int[num_elems];
+  for (int j = 0; j < ny; j++) {
+    for (int i = 0; i < nx; i++) {
+      int e = i + nx * j;
+      ptr[e] = 4 * e;
+      ids[e] = 0;
+      conn[4 * e] = i + (nx + 1) * j;
+      conn[4 * e + 1] = i + 1 + (nx + 1) * j;
+      conn[4 * e + 2] = i + (nx + 1) * (j + 1);
+      conn[4 * e + 3] = i + 1 + (nx + 1) * (j + 1);
+    }
+  }
+  ptr[num_elems] = 4 * num_elems;
+  creator->setGlobalConnectivity(num_nodes, num_elems, ptr, conn, ids);
+
+  int *bcs = new int[ny + 1];
+  for (int j = 0; j < ny + 1; j++) {
+    bcs[j] = (nx + 1) * j;
+  }
+  creator->setBoundaryConditions(ny + 1, bcs);
+
+  TacsScalar *X = new TacsScalar[3 * num_nodes];
+  for (int j = 0; j < ny + 1; j++) {
+    for (int i = 0; i < nx + 1; i++) {
+      int n = i + (nx + 1) * j;
+      X[3 * n] = 4.0 * i / nx;
+      X[3 * n + 1] = (1.0 * j) / ny;
+      X[3 * n + 2] = 0.0;
+    }
+  }
+  creator->setNodes(X);
+
+  delete[] ptr;
+  delete[] conn;
+  delete[] ids;
+  delete[] bcs;
+  delete[] X;
+}
+
+/*
+  Check the partition on the root processor and the number of elements
+  in the TACSAssembler object on each processor
+*/
+int checkPartition(MPI_Comm comm, TACSCreator *creator,
+                   TACSAssembler *assembler, const double *costs,
+                   const char *label) {
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  int fail = 0;
+  int *counts = new int[size];
+  memset(counts, 0, size * sizeof(int));
+  if (rank == 0) {
+    const int *partition;
+    int num_elems = creator->getElementPartition(&partition);
+
+    double *weights = new double[size];
+    memset(weights, 0, size * sizeof(double));
+    double total = 0.0;
+    for (int i = 0; i < num_elems; i++) {
+      if (partition[i] < 0 || partition[i] >= size) {
+        fail = 1;
+        break;
+      }
+      counts[partition[i]]++;
+      weights[partition[i]] += costs[i];
+      total += costs[i];
+    }
+
+    // Check that each processor has elements and that the cost on
+    // each processor is close to the average
+    double max_ratio = 0.0;
+    for (int k = 0; !fail && k < size; k++) {
+      if (counts[k] == 0) {
+        fail = 1;
+      }
+      max_ratio = fmax(max_ratio, size * weights[k] / total);
+    }
+    if (!(max_ratio < 1.05)) {
+      fail = 1;
+    }
+    printf("%-18s max cost / average cost %6.4f %s\n", label, max_ratio,
+           fail ? "FAILED" : "");
+
+    delete[] weights;
+  }
+  MPI_Bcast(counts, size, MPI_INT, 0, comm);
+
+  // Check that the assembler holds the elements from the partition
+  if (assembler->getNumElements() != counts[rank]) {
+    fprintf(stderr, "[%d] %s: %d elements in TACSAssembler, expected %d\n",
+            rank, label, assembler->getNumElements(), counts[rank]);
+    fail = 1;
+  }
+  delete[] counts;
+
+  MPI_Allreduce(MPI_IN_PLACE, &fail, 1, MPI_INT, MPI_MAX, comm);
+  return fail;
+}
+
+/*
+  Compute the norm of the residual at a displacement field that is a
+  function of the node locations
+*/
+double residualNorm(TACSAssembler *assembler) {
+  TACSBVec *X = assembler->createNodeVec();
+  TACSBVec *ans = assembler->createVec();
+  TACSBVec *res = assembler->createVec();
+  X->incref();
+  ans->incref();
+  res->incref();
+  assembler->getNodes(X);
+
+  TacsScalar *x, *u;
+  X->getArray(&x);
+  int size = ans->getArray(&u);
+  for (int i = 0; i < size / 2; i++) {
+    u[2 * i] = 1e-3 * x[3 * i] * x[3 * i + 1];
+    u[2 * i + 1] = 1e-3 * x[3 * i] * x[3 * i];
+  }
+  assembler->setVariables(ans);
+  assembler->assembleRes(res);
+  double norm = TacsRealPart(res->norm());
+
+  X->decref();
+  ans->decref();
+  res->decref();
+  return norm;
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  const int nx = 32, ny = 16;
+  const int num_elems = nx * ny;
+  TACSCreator *creator = new TACSCreator(comm, 2);
+  creator->incref();
+  if (rank == 0) {
+    setMesh(creator, nx, ny);
+  }
+
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2700.0, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TACSPlaneStressConstitutive *con = new TACSPlaneStressConstitutive(props);
+  TACSLinearElasticity2D *model =
+      new TACSLinearElasticity2D(con, TACS_LINEAR_STRAIN);
+  TACSElement *elem = new TACSElement2D(model, new TACSLinearQuadBasis());
+  creator->setElements(1, &elem);
+
+  // Partition the mesh with the element costs as weights
+  double *costs = new double[num_elems];
+  for (int e = 0; e < num_elems; e++) {
+    costs[e] = ((e % nx) < nx / 2 ? 1.0 : 4.0);
+  }
+  creator->partitionMesh(0, NULL, costs);
+  TACSAssembler *assembler = creator->createTACS();
+  assembler->incref();
+  int fail = checkPartition(comm, creator, assembler, costs, "given costs");
+  double norm = residualNorm(assembler);
+
+  // Find the global elements owned by this processor. These are stored
+  // in ascending order in the TACSAssembler object.
+  int *partition = new int[num_elems];
+  if (rank == 0) {
+    const int *part;
+    creator->getElementPartition(&part);
+    memcpy(partition, part, num_elems * sizeof(int));
+  }
+  MPI_Bcast(partition, num_elems, MPI_INT, 0, comm);
+
+  // Gather the global element numbers as costs and check the order
+  int num_local = assembler->getNumElements();
+  double *local_costs = new double[num_local];
+  for (int e = 0, i = 0; e < num_elems; e++) {
+    if (partition[e] == rank) {
+      local_costs[i] = 1.0 + e;
+      i++;
+    }
+  }
+  double *elem_costs = new double[num_elems];
+  creator->gatherElementCosts(local_costs, elem_costs);
+  if (rank == 0) {
+    int order_fail = 0;
+    for (int e = 0; e < num_elems; e++) {
+      if (elem_costs[e] != 1.0 + e) {
+        order_fail = 1;
+      }
+    }
+    printf("%-18s %s\n", "gathered order", order_fail ? "FAILED" : "");
+    fail = fail || order_fail;
+  }
+
+  // Partition the mesh again with the measured costs
+  assembler->computeElementCosts(TACSAssembler::MEASURED_ELEMENT_COST,
+                                 local_costs);
+  int cost_fail = 0;
+  for (int i = 0; i < num_local; i++) {
+    if (!(local_costs[i] > 0.0)) {
+      cost_fail = 1;
+    }
+  }
+  MPI_Allreduce(MPI_IN_PLACE, &cost_fail, 1, MPI_INT, MPI_MAX, comm);
+  fail = fail || cost_fail;
+
+  creator->gatherElementCosts(local_costs, elem_costs);
+  creator->partitionMesh(0, NULL, elem_costs);
+  TACSAssembler *balanced = creator->createTACS();
+  balanced->incref();
+  if (checkPartition(comm, creator, balanced, elem_costs, "measured costs")) {
+    fail = 1;
+  }
+
+  // The new assembler must represent the same problem
+  double new_norm = residualNorm(balanced);
+  double err = fabs(new_norm - norm) / norm;
+  if (!(err < 1e-12)) {
+    fail = 1;
+  }
+  MPI_Allreduce(MPI_IN_PLACE, &fail, 1, MPI_INT, MPI_MAX, comm);
+  if (rank == 0) {
+    printf("%-18s relative difference %10.3e\n", "residual norm", err);
+    printf("Weighted partition: %s\n", fail ? "FAILED" : "PASSED");
+  }
+
+  delete[] costs;
+  delete[] partition;
+  delete[] local_costs;
+  delete[] elem_costs;
+  balanced->decref();
+  assembler->decref();
+  creator->decref();
+
+  MPI_Finalize();
+  return fail;
+}
@@ -0,0 +1,172 @@
+/*
+  Test that the batched Gaussian process buckling predictions match
+  the predictions made one test point at a time
+
+  The TACSPanelGPs container groups the test points of a panel by GP
+  model and makes one batched prediction for each model. The batched
+  predictions and jacobians are compared against the single point GP
+  calls, and the test points of a GP blade stiffened panel are
+  compared against the test points built by each of its critical load
+  routines.
+*/
+
+#include "TACSGPBladeStiffenedShellConstitutive.h"
+
+/*
+  Create a buckling GP model with random training data
+*/
+TACSBucklingGaussianProcessModel *createGP(int n_train, bool affine) {
+  const int n_param = 4;
+  TacsScalar *Xtrain = new TacsScalar[n_param * n_train];
+  TacsScalar *alpha = new TacsScalar[n_train];
+  TacsScalar theta[] = {0.1, 0.234, 0.031, 8.374, 0.001, 0.1};
+  for (int i = 0; i < n_param * n_train; i++) {
+    Xtrain[i] = (1.0 * rand()) / RAND_MAX;
+  }
+  for (int i = 0; i < n_train; i++) {
+    alpha[i] = (1.0 * rand()) / RAND_MAX;
+  }
+
+  TACSBucklingGaussianProcessModel *gp = new TACSBucklingGaussianProcessModel(
+      n_train, affine, Xtrain, alpha, theta);
+  delete[] Xtrain;
+  delete[] alpha;
+  return gp;
+}
+
+/*
+  Compute the relative error between two arrays
+*/
+double relError(int n, const TacsScalar a[], const TacsScalar b[]) {
+  double err = 0.0;
+  for (int i = 0; i < n; i++) {
+    double diff = fabs(TacsRealPart(a[i] - b[i]));
+    double scale = fabs(TacsRealPart(b[i]));
+    if (scale > 0.0) {
+      diff /= scale;
+    }
+    if (diff > err) {
+      err = diff;
+    }
+  }
+  return err;
+}
+
+/*
+  Compare the batched predictions of the PanelGPs object against the
+  single point predictions of each GP model
+*/
+double testPanelGPs(TACSPanelGPs *panelGPs) {
+  const int n = 5;
+  int predInds[] = {4, 1, 3, 0, 2};
+  TacsScalar Xtest[4 * n];
+  for (int i = 0; i < 4 * n; i++) {
+    Xtest[i] = -1.0 + (2.0 * rand()) / RAND_MAX;
+  }
+
+  TacsScalar Y[n], Ysens[n], jac[4 * n];
+  panelGPs->resetSavedData();
+  panelGPs->predictMeanTestDataBatch(n, predInds, Xtest, Y);
+  panelGPs->resetSavedData();
+  panelGPs->predictMeanTestDataSensBatch(n, predInds, Xtest, Ysens, jac);
+
+  double err = 0.0;
+  for (int i = 0; i < n; i++) {
+    TACSBucklingGaussianProcessModel *gp = panelGPs->getCripplingGP();
+    if (predInds[i] == 0 || predInds[i] == 1) {
+      gp = panelGPs->getAxialGP();
+    } else if (predInds[i] == 2 || predInds[i] == 3) {
+      gp = panelGPs->getShearGP();
+    }
+
+    TacsScalar Yref = gp->predictMeanTestData(&Xtest[4 * i]);
+    TacsScalar jacRef[4];
+    gp->predictMeanTestDataSens(1.0, &Xtest[4 * i], jacRef);
+
+    double errs[] = {relError(1, &Y[i], &Yref), relError(1, &Ysens[i], &Yref),
+                     relError(4, &jac[4 * i], jacRef)};
+    double e = 0.0;
+    for (int k = 0; k < 3; k++) {
+      if (errs[k] > e) {
+        e = errs[k];
+      }
+    }
+    printf("prediction %d: Ytest %15.8e %15.8e rel err %10.3e\n", predInds[i],
+           TacsRealPart(Y[i]), TacsRealPart(Yref), e);
+    if (e > err) {
+      err = e;
+    }
+  }
+  panelGPs->resetSavedData();
+
+  return err;
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+  srand(0);
+
+  const double tol = 1e-12;
+  int fail = 0;
+
+  TACSMaterialProperties *props = new TACSMaterialProperties(
+      1550.0, 921.096, 54e3, 18e3, 18e3, 0.25, 0.25, 0.25, 9e3, 9e3, 9e3,
+      2410.0, 1040.0, 73.0, 173.0, 73.0, 173.0, 71.0, 71.0, 71.0);
+  TACSOrthotropicPly *ply = new TACSOrthotropicPly(1e-3, props);
+  ply->incref();
+
+  const int n_train = 4;
+  TACSBucklingGaussianProcessModel *axialGP = createGP(n_train, true);
+  TACSBucklingGaussianProcessModel *shearGP = createGP(n_train, false);
+  TACSBucklingGaussianProcessModel *cripplingGP = createGP(n_train, true);
+  axialGP->incref();
+  shearGP->incref();
+  cripplingGP->incref();
+
+  for (int saveData = 0; saveData < 2; saveData++) {
+    TACSPanelGPs *panelGPs =
+        new TACSPanelGPs(axialGP, shearGP, cripplingGP, saveData);
+    panelGPs->incref();
+
+    // Check the batched predictions of the container
+    double err = testPanelGPs(panelGPs);
+    int gp_fail = !(err < tol);
+    fail = fail || gp_fail;
+    printf("PanelGPs saveData = %d max rel err %10.3e %s\n", saveData, err,
+           gp_fail ? "FAILED" : "");
+
+    // Check the batched predictions of a GP blade stiffened panel
+    TacsScalar panelPlyAngles[] = {0.0, M_PI / 4.0, M_PI / 2.0};
+    TacsScalar panelPlyFracs[] = {0.5, 0.3, 0.2};
+    int panelPlyFracNums[] = {5, 6, 7};
+    TacsScalar stiffenerPlyAngles[] = {0.0, M_PI / 3.0};
+    TacsScalar stiffenerPlyFracs[] = {0.6, 0.4};
+    int stiffenerPlyFracNums[] = {8, 9};
+    TACSGPBladeStiffenedShellConstitutive *con =
+        new TACSGPBladeStiffenedShellConstitutive(
+            ply, ply, 5.0 / 6.0, 2.0, 0, 0.2, 1, 1.5e-2, 4, 3, panelPlyAngles,
+            panelPlyFracs, panelPlyFracNums, 0.075, 2, 1e-2, 3, 2,
+            stiffenerPlyAngles, stiffenerPlyFracs, stiffenerPlyFracNums, 1.0,
+            10, 0.8, true, panelGPs);
+    con->incref();
+
+    TacsScalar conErr = con->testPanelGPBatch(1);
+    int con_fail = !(TacsRealPart(conErr) < tol);
+    fail = fail || con_fail;
+    printf("GP blade panel saveData = %d max rel err %10.3e %s\n", saveData,
+           TacsRealPart(conErr), con_fail ? "FAILED" : "");
+
+    con->decref();
+    panelGPs->decref();
+  }
+
+  printf("Batched GP predictions: %s\n", fail ? "FAILED" : "PASSED");
+
+  axialGP->decref();
+  shearGP->decref();
+  cripplingGP->decref();
+  ply->decref();
+
+  MPI_Finalize();
+  return fail;
+}
@@ -0,0 +1,186 @@
+/*
+  Test the eigenvalue computations of the finite-strip panel analysis
+
+  The lowest buckling loads and natural frequencies of a blade
+  stiffened panel are computed with the Lanczos method, which uses the
+  stored Cholesky factor of the stiffness matrix as a shift-invert
+  operator, and compared against the full spectrum computed by LAPACK.
+  The loads are computed for several load cases with the same factor
+  and again after the design variables are modified. Finally, the
+  buckling loads of a list of panels computed with several threads are
+  compared against the loads computed for each panel in turn.
+*/
+
+#include <math.h>
+
+#include "TACSIsoRectangleBeamConstitutive.h"
+#include "TACSIsoShellConstitutive.h"
+#include "TACSPanelAnalysis.h"
+
+#ifndef TACS_USE_COMPLEX
+
+/*
+  Create a panel with a single blade stiffener and a flange beam at
+  the tip of the blade. The skin thickness is design variable 0 and
+  the blade thickness is design variable 1.
+*/
+TACSPanelAnalysis *createPanel(TACSMaterialProperties *props, TacsScalar tskin,
+                               TacsScalar tblade) {
+  const int nnodes = 7, nsegments = 6, nbeams = 1, nmodes = 8;
+  TacsScalar Lx = 0.6;
+  TACSPanelAnalysis *panel =
+      new TACSPanelAnalysis(nnodes, nsegments, nbeams, nmodes, Lx);
+
+  // The skin nodes are along the y-axis and the blade is along z
+  TacsScalar Xpts[] = {0.0, 0.0, 0.1, 0.0, 0.2, 0.0,  0.3,
+                       0.0, 0.4, 0.0, 0.2, 0.02, 0.2, 0.04};
+  panel->setPoints(Xpts, nnodes);
+
+  TACSShellConstitutive *skin =
+      new TACSIsoShellConstitutive(props, tskin, 0, 1e-3, 0.1);
+  TACSShellConstitutive *blade =
+      new TACSIsoShellConstitutive(props, tblade, 1, 1e-3, 0.1);
+  TACSBeamConstitutive *flange = new TACSIsoRectangleBeamConstitutive(
+      props, 0.02, 0.002, 0.0, -1, -1, -1, 0.0, 1.0, 0.0, 1.0);
+
+  for (int k = 0; k < 4; k++) {
+    panel->setSegment(k, TACSPanelAnalysis::SKIN_SEGMENT, skin, k, k + 1);
+  }
+  panel->setSegment(4, TACSPanelAnalysis::STIFFENER_SEGMENT, blade, 2, 5);
+  panel->setSegment(5, TACSPanelAnalysis::STIFFENER_SEGMENT, blade, 5, 6);
+  panel->setBeam(0, flange, 6);
+
+  // Simply support the edges of the skin
+  panel->setFirstNodeBC(0, (4 | 8));
+  panel->setLastNodeBC(4, (4 | 8));
+  panel->initialize();
+
+  return panel;
+}
+
+/*
+  Compute the maximum relative difference between two arrays. A
+  non-finite value in either array gives a non-finite difference.
+*/
+double maxRelDiff(const TacsScalar *a, const TacsScalar *b, int n) {
+  double err = 0.0;
+  for (int i = 0; i < n; i++) {
+    double d = fabs(TacsRealPart(a[i] - b[i])) / fabs(TacsRealPart(b[i]));
+    if (!isfinite(d)) {
+      return d;
+    } else if (d > err) {
+      err = d;
+    }
+  }
+  return err;
+}
+
+/*
+  Print the result of a comparison and return the failure flag
+*/
+int checkDiff(const char *name, double err, double tol) {
+  int fail = !(err < tol);
+  printf("%-36s max rel err %10.3e %s\n", name, err, fail ? "FAILED" : "");
+  return fail;
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2700.0, 921.0, 70e9, 0.3, 270e6, 0.0, 0.0);
+  props->incref();
+
+  TACSPanelAnalysis *panel = createPanel(props, 0.004, 0.003);
+  panel->incref();
+
+  const int nloads = 4;
+  const double tol = 1e-8;
+  TacsScalar loads[nloads], lapack_loads[nloads];
+  TacsScalar pos[nloads], neg[nloads], lapack_pos[nloads], lapack_neg[nloads];
+  TacsScalar freq[nloads], lapack_freq[nloads];
+
+  // Compute the reference values from the full spectrum
+  panel->setUseLapackEigensolver(1);
+  panel->computeBucklingLoads(-1e3, 0.0, lapack_loads, nloads);
+  panel->computeBucklingLoads(1e3, lapack_pos, lapack_neg, nloads);
+  panel->computeFrequencies(lapack_freq, nloads);
+  panel->setUseLapackEigensolver(0);
+
+  int fail = panel->computeBucklingLoads(-1e3, 0.0, loads, nloads);
+  fail |= checkDiff("Axial buckling loads",
+                    maxRelDiff(loads, lapack_loads, nloads), tol);
+  fail |= panel->computeBucklingLoads(1e3, pos, neg, nloads);
+  fail |= checkDiff("Positive shear buckling loads",
+                    maxRelDiff(pos, lapack_pos, nloads), tol);
+  fail |= checkDiff("Negative shear buckling loads",
+                    maxRelDiff(neg, lapack_neg, nloads), tol);
+  fail |= panel->computeFrequencies(freq, nloads);
+  fail |= checkDiff("Natural frequencies",
+                    maxRelDiff(freq, lapack_freq, nloads), tol);
+
+  // The loads for a second load case, computed with the same factor,
+  // are scaled by the ratio of the applied loads
+  TacsScalar scaled[nloads];
+  fail |= panel->computeBucklingLoads(-4e3, 0.0, scaled, nloads);
+  for (int k = 0; k < nloads; k++) {
+    scaled[k] *= 4.0;
+  }
+  fail |= checkDiff("Axial buckling loads, second case",
+                    maxRelDiff(scaled, lapack_loads, nloads), tol);
+
+  // Modify the design variables so that the factor must be recomputed
+  TacsScalar x[2] = {0.005, 0.002};
+  panel->setDesignVars(x, 2);
+  panel->computeBucklingLoads(-1e3, 0.0, loads, nloads);
+  panel->computeFrequencies(freq, nloads);
+  panel->setUseLapackEigensolver(1);
+  panel->computeBucklingLoads(-1e3, 0.0, lapack_loads, nloads);
+  panel->computeFrequencies(lapack_freq, nloads);
+  panel->setUseLapackEigensolver(0);
+  fail |= checkDiff("Axial buckling loads, new design",
+                    maxRelDiff(loads, lapack_loads, nloads), tol);
+  fail |= checkDiff("Natural frequencies, new design",
+                    maxRelDiff(freq, lapack_freq, nloads), tol);
+
+  // Compute the loads for a list of panels with several threads
+  const int npanels = 6;
+  TACSPanelAnalysis *panels[npanels];
+  TacsScalar Nx[npanels], Nxy[npanels];
+  for (int i = 0; i < npanels; i++) {
+    panels[i] = createPanel(props, 0.003 + 0.0005 * i, 0.002 + 0.0002 * i);
+    panels[i]->incref();
+    Nx[i] = -1e3 * (i + 1);
+    Nxy[i] = 2e2 * i;
+  }
+
+  TacsScalar threaded[nloads * npanels], serial[nloads * npanels];
+  fail |= TACSPanelAnalysis::computeBucklingLoads(npanels, panels, Nx, Nxy,
+                                                  threaded, nloads, 4);
+  for (int i = 0; i < npanels; i++) {
+    fail |= panels[i]->computeBucklingLoads(Nx[i], Nxy[i],
+                                            &serial[nloads * i], nloads);
+  }
+  fail |= checkDiff("Threaded buckling loads",
+                    maxRelDiff(threaded, serial, nloads * npanels), 1e-14);
+
+  printf("Panel analysis: %s\n", fail ? "FAILED" : "PASSED");
+
+  for (int i = 0; i < npanels; i++) {
+    panels[i]->decref();
+  }
+  panel->decref();
+  props->decref();
+
+  MPI_Finalize();
+  return fail;
+}
+
+#else
+
+int main(int argc, char *argv[]) {
+  printf("TACSPanelAnalysis is not available with complex TACS\n");
+  return 0;
+}
+
+#endif  // TACS_USE_COMPLEX
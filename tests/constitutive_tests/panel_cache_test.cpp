@@ -0,0 +1,134 @@
+/*
+  Test that the cached critical panel buckling loads of the blade
+  stiffened shell constitutive models match the uncached computations
+
+  The critical local and global panel loads and their design variable
+  sensitivities are cached for each design. The cached values are
+  compared against the values computed directly at the initial design
+  and again after each modification of the design variables, so that a
+  stale cache is detected. Both the closed-form blade stiffened panel
+  and the Gaussian process panel, with and without the GP models, are
+  tested.
+*/
+
+#include "TACSGPBladeStiffenedShellConstitutive.h"
+
+/*
+  Create a buckling GP model with random training data
+*/
+TACSBucklingGaussianProcessModel *createGP(int n_train, bool affine) {
+  const int n_param = 4;
+  TacsScalar *Xtrain = new TacsScalar[n_param * n_train];
+  TacsScalar *alpha = new TacsScalar[n_train];
+  TacsScalar theta[] = {0.1, 0.234, 0.031, 8.374, 0.001, 0.1};
+  for (int i = 0; i < n_param * n_train; i++) {
+    Xtrain[i] = (1.0 * rand()) / RAND_MAX;
+  }
+  for (int i = 0; i < n_train; i++) {
+    alpha[i] = (1.0 * rand()) / RAND_MAX;
+  }
+
+  TACSBucklingGaussianProcessModel *gp = new TACSBucklingGaussianProcessModel(
+      n_train, affine, Xtrain, alpha, theta);
+  delete[] Xtrain;
+  delete[] alpha;
+  return gp;
+}
+
+/*
+  Check the cached critical loads at the current design and after the
+  design variables are modified twice
+*/
+int testPanelCache(const char *name, TACSBladeStiffenedShellConstitutive *con) {
+  const double tol = 1e-12;
+  int ndvs = con->getDesignVarNums(0, 0, NULL);
+  TacsScalar *x = new TacsScalar[ndvs];
+  con->getDesignVars(0, ndvs, x);
+
+  int fail = 0;
+  for (int k = 0; k < 3; k++) {
+    if (k > 0) {
+      for (int i = 0; i < ndvs; i++) {
+        x[i] *= 1.0 + 0.05 * k * (i % 2 == 0 ? 1.0 : -1.0);
+      }
+      con->setDesignVars(0, ndvs, x);
+    }
+
+    TacsScalar err = con->testCriticalPanelLoadCache(0);
+    int test_fail = !(TacsRealPart(err) < tol);
+    fail = fail || test_fail;
+    printf("%-24s design %d: max rel err %10.3e %s\n", name, k,
+           TacsRealPart(err), test_fail ? "FAILED" : "");
+  }
+
+  delete[] x;
+  return fail;
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+  srand(0);
+
+  int fail = 0;
+
+  TACSMaterialProperties *props = new TACSMaterialProperties(
+      1550.0, 921.096, 54e3, 18e3, 18e3, 0.25, 0.25, 0.25, 9e3, 9e3, 9e3,
+      2410.0, 1040.0, 73.0, 173.0, 73.0, 173.0, 71.0, 71.0, 71.0);
+  TACSOrthotropicPly *ply = new TACSOrthotropicPly(1e-3, props);
+  ply->incref();
+
+  TacsScalar panelPlyAngles[] = {0.0, M_PI / 4.0, M_PI / 2.0};
+  TacsScalar panelPlyFracs[] = {0.5, 0.3, 0.2};
+  int panelPlyFracNums[] = {5, 6, 7};
+  TacsScalar stiffenerPlyAngles[] = {0.0, M_PI / 3.0};
+  TacsScalar stiffenerPlyFracs[] = {0.6, 0.4};
+  int stiffenerPlyFracNums[] = {8, 9};
+
+  // Check the closed-form blade stiffened panel
+  TACSBladeStiffenedShellConstitutive *blade =
+      new TACSBladeStiffenedShellConstitutive(
+          ply, ply, 5.0 / 6.0, 2.0, 0, 0.2, 1, 1.5e-2, 4, 3, panelPlyAngles,
+          panelPlyFracs, panelPlyFracNums, 0.075, 2, 1e-2, 3, 2,
+          stiffenerPlyAngles, stiffenerPlyFracs, stiffenerPlyFracNums);
+  blade->incref();
+  fail = testPanelCache("Blade panel", blade) || fail;
+  blade->decref();
+
+  // Check the GP panel without GP models, which uses the closed-form
+  // solutions with the Gaussian process panel parameters
+  TACSGPBladeStiffenedShellConstitutive *gpBlade =
+      new TACSGPBladeStiffenedShellConstitutive(
+          ply, ply, 5.0 / 6.0, 2.0, 0, 0.2, 1, 1.5e-2, 4, 3, panelPlyAngles,
+          panelPlyFracs, panelPlyFracNums, 0.075, 2, 1e-2, 3, 2,
+          stiffenerPlyAngles, stiffenerPlyFracs, stiffenerPlyFracNums, 1.0,
+          10, 0.8, true);
+  gpBlade->incref();
+  fail = testPanelCache("GP blade panel", gpBlade) || fail;
+  gpBlade->decref();
+
+  // Check the GP panel with GP models
+  const int n_train = 4;
+  TACSBucklingGaussianProcessModel *axialGP = createGP(n_train, true);
+  TACSBucklingGaussianProcessModel *shearGP = createGP(n_train, false);
+  TACSBucklingGaussianProcessModel *cripplingGP = createGP(n_train, true);
+  TACSPanelGPs *panelGPs =
+      new TACSPanelGPs(axialGP, shearGP, cripplingGP, true);
+  panelGPs->incref();
+
+  gpBlade = new TACSGPBladeStiffenedShellConstitutive(
+      ply, ply, 5.0 / 6.0, 2.0, 0, 0.2, 1, 1.5e-2, 4, 3, panelPlyAngles,
+      panelPlyFracs, panelPlyFracNums, 0.075, 2, 1e-2, 3, 2,
+      stiffenerPlyAngles, stiffenerPlyFracs, stiffenerPlyFracNums, 1.0, 10,
+      0.8, true, panelGPs);
+  gpBlade->incref();
+  fail = testPanelCache("GP blade panel with GPs", gpBlade) || fail;
+  gpBlade->decref();
+
+  panelGPs->decref();
+  ply->decref();
+
+  printf("Critical panel load cache: %s\n", fail ? "FAILED" : "PASSED");
+
+  MPI_Finalize();
+  return fail;
+}
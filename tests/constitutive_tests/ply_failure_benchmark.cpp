@@ -0,0 +1,210 @@
+/*
+  Microbenchmark for the batched ply failure evaluation
+
+  This compares the single point failure calls in TACSOrthotropicPly
+  with the batched calls that take all the sampling points of a
+  laminate in structure-of-arrays form, and times the composite shell
+  failure evaluation that uses them. The batched results are checked
+  against the single point results for each failure criterion.
+*/
+
+#include "TACSCompositeShellConstitutive.h"
+#include "TACSSmearedCompositeShellConstitutive.h"
+
+/*
+  Evaluate the failure at each point with the single point calls
+*/
+TacsScalar evalFailureScalar(TACSOrthotropicPly *ply, int n,
+                             const TacsScalar angles[], const TacsScalar ex[],
+                             const TacsScalar ey[], const TacsScalar exy[],
+                             double ksWeight, TacsScalar fail[],
+                             TacsScalar dfdex[], TacsScalar dfdey[],
+                             TacsScalar dfdexy[]) {
+  for (int i = 0; i < n; i++) {
+    TacsScalar e[3] = {ex[i], ey[i], exy[i]}, sens[3];
+    fail[i] = ply->failure(angles[i], e);
+    ply->failureStrainSens(angles[i], e, sens);
+    dfdex[i] = sens[0];
+    dfdey[i] = sens[1];
+    dfdexy[i] = sens[2];
+  }
+
+  TacsScalar *dks = new TacsScalar[n];
+  TacsScalar ks = ksAggregationSens(fail, n, ksWeight, dks);
+  for (int i = 0; i < n; i++) {
+    dfdex[i] *= dks[i];
+    dfdey[i] *= dks[i];
+    dfdexy[i] *= dks[i];
+  }
+  delete[] dks;
+
+  return ks;
+}
+
+double maxRelError(int n, const TacsScalar a[], const TacsScalar b[]) {
+  double err = 0.0;
+  for (int i = 0; i < n; i++) {
+    double d = fabs(TacsRealPart(a[i] - b[i])) /
+               (fabs(TacsRealPart(b[i])) + 1e-30);
+    if (d > err) {
+      err = d;
+    }
+  }
+  return err;
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  int num_plies = 24;
+  int num_evals = 20000;
+  for (int k = 0; k < argc; k++) {
+    int val;
+    if (sscanf(argv[k], "plies=%d", &val) == 1 && val > 0) {
+      num_plies = val;
+    }
+    if (sscanf(argv[k], "evals=%d", &val) == 1 && val > 0) {
+      num_evals = val;
+    }
+  }
+
+  // Create the orthotropic material properties
+  TacsScalar rho = 1550.0, specific_heat = 921.096;
+  TacsScalar E1 = 54e3, E2 = 18e3, nu12 = 0.25, G12 = 9e3, G13 = 9e3;
+  TacsScalar Xt = 2410.0, Xc = 1040.0, Yt = 73.0, Yc = 173.0, S12 = 71.0;
+  TacsScalar cte = 24.0e-6, kappa = 230.0;
+  TacsScalar b_tt = 0.3, b_tl = 0.3, muWF = 0.2, m = 2.6;
+  TACSMaterialProperties *props = new TACSMaterialProperties(
+      rho, specific_heat, E1, E2, E2, nu12, nu12, nu12, G12, G13, G13, Xt, Xc,
+      Yt, Yc, Yt, Yc, S12, S12, S12, cte, cte, cte, kappa, kappa, kappa, b_tt,
+      b_tl, muWF, 0.0, 0.0, m);
+  TACSOrthotropicPly *ply = new TACSOrthotropicPly(0.125, props);
+  ply->incref();
+
+  // Create a quasi-isotropic layup with two points per ply
+  int npts = 2 * num_plies;
+  TacsScalar *ply_angles = new TacsScalar[num_plies];
+  TacsScalar *ply_thick = new TacsScalar[num_plies];
+  TacsScalar *ply_fracs = new TacsScalar[num_plies];
+  TACSOrthotropicPly **plies = new TACSOrthotropicPly *[num_plies];
+  for (int i = 0; i < num_plies; i++) {
+    ply_angles[i] = (M_PI / 4.0) * (i % 4);
+    ply_thick[i] = 0.125;
+    ply_fracs[i] = 1.0 / num_plies;
+    plies[i] = ply;
+  }
+
+  TacsScalar *angles = new TacsScalar[npts];
+  TacsScalar *strain = new TacsScalar[3 * npts];
+  TacsScalar *ex = &strain[0], *ey = &strain[npts], *exy = &strain[2 * npts];
+  for (int i = 0; i < npts; i++) {
+    angles[i] = ply_angles[i / 2];
+    ex[i] = 1e-3 * (1.0 - 0.01 * i);
+    ey[i] = -4e-4 * (1.0 + 0.02 * i);
+    exy[i] = 6e-4 * (1.0 - 0.015 * i);
+  }
+
+  TacsScalar *fail = new TacsScalar[4 * npts];
+  TacsScalar *fail0 = new TacsScalar[4 * npts];
+  TacsScalar *sens = &fail[npts], *sens0 = &fail0[npts];
+
+  const char *names[] = {"MAX_STRAIN", "TSAI_WU", "TSAI_WU_MODIFIED",
+                         "CUNTZE_UD", "CUNTZE_WOVEN"};
+  TACSOrthotropicPly::CompositeFailureCriterion criteria[] = {
+      TACSOrthotropicPly::MAX_STRAIN, TACSOrthotropicPly::TSAI_WU,
+      TACSOrthotropicPly::TSAI_WU_MODIFIED, TACSOrthotropicPly::CUNTZE_UD,
+      TACSOrthotropicPly::CUNTZE_WOVEN};
+
+  const double ksWeight = 100.0;
+  int fail_flag = 0;
+
+  printf("%-18s %12s %12s %12s %12s\n", "Criterion", "single [us]",
+         "batch [us]", "speedup", "rel. error");
+  for (int j = 0; j < 5; j++) {
+    ply->setFailureCriterion(criteria[j]);
+
+    // Check the batched values and KS derivatives
+    TacsScalar ks0 =
+        evalFailureScalar(ply, npts, angles, ex, ey, exy, ksWeight, fail0,
+                          &sens0[0], &sens0[npts], &sens0[2 * npts]);
+    TacsScalar ks =
+        ply->failureBatchKS(npts, angles, ex, ey, exy, ksWeight, fail,
+                            &sens[0], &sens[npts], &sens[2 * npts]);
+    double err = maxRelError(4 * npts, fail, fail0);
+    double ks_err = fabs(TacsRealPart(ks - ks0)) / fabs(TacsRealPart(ks0));
+    if (ks_err > err) {
+      err = ks_err;
+    }
+    if (err > 1e-10) {
+      fail_flag = 1;
+    }
+
+    // Time the single point evaluation
+    double t0 = MPI_Wtime();
+    for (int k = 0; k < num_evals; k++) {
+      evalFailureScalar(ply, npts, angles, ex, ey, exy, ksWeight, fail0,
+                        &sens0[0], &sens0[npts], &sens0[2 * npts]);
+    }
+    double tsingle = (MPI_Wtime() - t0) / num_evals;
+
+    // Time the batched evaluation
+    t0 = MPI_Wtime();
+    for (int k = 0; k < num_evals; k++) {
+      ply->failureBatchKS(npts, angles, ex, ey, exy, ksWeight, fail, &sens[0],
+                          &sens[npts], &sens[2 * npts]);
+    }
+    double tbatch = (MPI_Wtime() - t0) / num_evals;
+
+    printf("%-18s %12.4f %12.4f %12.2f %12.3e\n", names[j], 1e6 * tsingle,
+           1e6 * tbatch, tsingle / tbatch, err);
+  }
+
+  // Time the failure evaluation of the shell constitutive classes
+  ply->setFailureCriterion(TACSOrthotropicPly::TSAI_WU_MODIFIED);
+  TACSShellConstitutive *cons[2];
+  cons[0] = new TACSCompositeShellConstitutive(num_plies, plies, ply_thick,
+                                               ply_angles);
+  cons[1] = new TACSSmearedCompositeShellConstitutive(
+      num_plies, plies, 0.125 * num_plies, ply_angles, ply_fracs);
+
+  double pt[3] = {0.0, 0.0, 0.0};
+  TacsScalar X[3] = {0.0, 0.0, 0.0};
+  TacsScalar e[9] = {1e-3, -4e-4, 6e-4, 1e-3, 2e-3, -1e-3, 0.0, 0.0, 0.0};
+  TacsScalar s[9];
+  printf("\n%-40s %12s %12s\n", "Constitutive", "fail [us]", "sens [us]");
+  for (int j = 0; j < 2; j++) {
+    cons[j]->incref();
+    double t0 = MPI_Wtime();
+    for (int k = 0; k < num_evals; k++) {
+      cons[j]->evalFailure(0, pt, X, e);
+    }
+    double tfail = (MPI_Wtime() - t0) / num_evals;
+
+    t0 = MPI_Wtime();
+    for (int k = 0; k < num_evals; k++) {
+      cons[j]->evalFailureStrainSens(0, pt, X, e, s);
+    }
+    double tsens = (MPI_Wtime() - t0) / num_evals;
+
+    printf("%-40s %12.4f %12.4f\n", cons[j]->getObjectName(), 1e6 * tfail,
+           1e6 * tsens);
+    cons[j]->decref();
+  }
+
+  if (fail_flag) {
+    fprintf(stderr, "Batched failure values do not match\n");
+  }
+
+  delete[] ply_angles;
+  delete[] ply_thick;
+  delete[] ply_fracs;
+  delete[] plies;
+  delete[] angles;
+  delete[] strain;
+  delete[] fail;
+  delete[] fail0;
+  ply->decref();
+
+  MPI_Finalize();
+  return fail_flag;
+}
@@ -0,0 +1,168 @@
+/*
+  Test that the cached tangent stiffness of the shell constitutive
+  models matches the uncached stiffness
+
+  Each shell model is created twice, once with the stiffness cache
+  enabled and once without it. The tangent stiffness and the stress
+  for a random strain are compared at the initial design, after each
+  modification of the design variables, so that a stale cache is
+  detected, and after the drilling regularization is changed, when the
+  cache must be bypassed.
+*/
+
+#include "TACSBladeStiffenedShellConstitutive.h"
+#include "TACSCompositeShellConstitutive.h"
+#include "TACSIsoShellConstitutive.h"
+#include "TACSLamParamFullShellConstitutive.h"
+#include "TACSLamParamSmearedShellConstitutive.h"
+#include "TACSSmearedCompositeShellConstitutive.h"
+
+/*
+  Create one of the shell constitutive models with linear stiffness
+*/
+TACSShellConstitutive *createShell(int k, TACSOrthotropicPly *ply,
+                                   TACSMaterialProperties *iso) {
+  TacsScalar angles[] = {0.0, M_PI / 4.0, M_PI / 2.0};
+  TacsScalar fracs[] = {0.5, 0.3, 0.2};
+  int fracNums[] = {1, 2, 3};
+
+  if (k == 0) {
+    return new TACSIsoShellConstitutive(iso, 0.01, 0, 1e-3, 0.1, 1e-3);
+  } else if (k == 1) {
+    TACSOrthotropicPly *plies[] = {ply, ply, ply};
+    TacsScalar thickness[] = {1e-3, 2e-3, 1.5e-3};
+    return new TACSCompositeShellConstitutive(3, plies, thickness, angles);
+  } else if (k == 2) {
+    TACSOrthotropicPly *plies[] = {ply, ply, ply};
+    return new TACSSmearedCompositeShellConstitutive(3, plies, 0.01, angles,
+                                                     fracs, 0, fracNums);
+  } else if (k == 3) {
+    return new TACSLamParamSmearedShellConstitutive(
+        ply, 0.01, 0, 1e-3, 0.1, 0.5, 0.3, 0.2, 1, 2, 3, 0.1, 0.1, 0.1, 0.4,
+        0.3, 4, 5, 30.0, 0.0);
+  } else if (k == 4) {
+    int lpNums[] = {1, 2, 3, 4, 5, 6};
+    return new TACSLamParamFullShellConstitutive(ply, 0.01, 0, 1e-3, 0.1,
+                                                 lpNums, 30.0);
+  }
+
+  TacsScalar stiffenerAngles[] = {0.0, M_PI / 3.0};
+  TacsScalar stiffenerFracs[] = {0.6, 0.4};
+  int panelFracNums[] = {5, 6, 7};
+  int stiffenerFracNums[] = {8, 9};
+  return new TACSBladeStiffenedShellConstitutive(
+      ply, ply, 5.0 / 6.0, 2.0, 0, 0.2, 1, 1.5e-2, 4, 3, angles, fracs,
+      panelFracNums, 0.075, 2, 1e-2, 3, 2, stiffenerAngles, stiffenerFracs,
+      stiffenerFracNums);
+}
+
+/*
+  Compute the maximum difference between two arrays relative to the
+  largest entry of the reference array
+*/
+double relError(int n, const TacsScalar a[], const TacsScalar b[]) {
+  double err = 0.0, scale = 0.0;
+  for (int i = 0; i < n; i++) {
+    double diff = fabs(TacsRealPart(a[i] - b[i]));
+    if (diff > err) {
+      err = diff;
+    }
+    if (fabs(TacsRealPart(b[i])) > scale) {
+      scale = fabs(TacsRealPart(b[i]));
+    }
+  }
+  if (scale > 0.0) {
+    err /= scale;
+  }
+  return err;
+}
+
+/*
+  Compare the stiffness and stress of the cached and uncached models
+*/
+double compareShells(TACSShellConstitutive *cached, TACSShellConstitutive *ref,
+                     const TacsScalar e[]) {
+  const int nc = TACSShellConstitutive::NUM_TANGENT_STIFFNESS_ENTRIES;
+  const int ns = TACSShellConstitutive::NUM_STRESSES;
+  double pt[3] = {0.0, 0.0, 0.0};
+  TacsScalar X[3] = {0.0, 0.0, 0.0};
+  TacsScalar C[nc], Cref[nc], s[ns], sref[ns];
+
+  cached->evalTangentStiffness(0, pt, X, C);
+  ref->evalTangentStiffness(0, pt, X, Cref);
+  cached->evalStress(0, pt, X, e, s);
+  ref->evalStress(0, pt, X, e, sref);
+
+  double errC = relError(nc, C, Cref);
+  double errs = relError(ns, s, sref);
+  return (errC > errs ? errC : errs);
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+  srand(0);
+
+  const double tol = 1e-13;
+  int fail = 0;
+
+  TACSMaterialProperties *props = new TACSMaterialProperties(
+      1550.0, 921.096, 54e3, 18e3, 18e3, 0.25, 0.25, 0.25, 9e3, 9e3, 9e3,
+      2410.0, 1040.0, 73.0, 173.0, 73.0, 173.0, 71.0, 71.0, 71.0);
+  TACSOrthotropicPly *ply = new TACSOrthotropicPly(1e-3, props);
+  ply->incref();
+  TACSMaterialProperties *iso =
+      new TACSMaterialProperties(2700.0, 921.0, 70e9, 0.3, 270e6, 0.0, 0.0);
+  iso->incref();
+
+  TacsScalar e[TACSShellConstitutive::NUM_STRESSES];
+  for (int i = 0; i < TACSShellConstitutive::NUM_STRESSES; i++) {
+    e[i] = -1e-3 + (2e-3 * rand()) / RAND_MAX;
+  }
+
+  const char *stages[] = {"initial design", "design change 1",
+                          "design change 2", "drilling change"};
+  const double drill = TACSShellConstitutive::getDrillingRegularization();
+  for (int k = 0; k < 6; k++) {
+    TACSShellConstitutive *cached = createShell(k, ply, iso);
+    TACSShellConstitutive *ref = createShell(k, ply, iso);
+    cached->incref();
+    ref->incref();
+    cached->setUseStiffnessCache(1);
+
+    int ndvs = ref->getDesignVarNums(0, 0, NULL);
+    TacsScalar *x = new TacsScalar[ndvs > 0 ? ndvs : 1];
+    ref->getDesignVars(0, ndvs, x);
+
+    // Compare at the initial design and after two design changes
+    for (int j = 0; j < 4; j++) {
+      if (j == 1 || j == 2) {
+        for (int i = 0; i < ndvs; i++) {
+          x[i] *= 1.0 + 0.05 * j * (i % 2 == 0 ? 1.0 : -1.0);
+        }
+        cached->setDesignVars(0, ndvs, x);
+        ref->setDesignVars(0, ndvs, x);
+      } else if (j == 3) {
+        TACSShellConstitutive::setDrillingRegularization(10.0 * drill);
+      }
+
+      double err = compareShells(cached, ref, e);
+      int test_fail = !(err < tol);
+      fail = fail || test_fail;
+      printf("%-38s %s: max rel err %10.3e %s\n", ref->getObjectName(),
+             stages[j], err, test_fail ? "FAILED" : "");
+    }
+    TACSShellConstitutive::setDrillingRegularization(drill);
+
+    delete[] x;
+    cached->decref();
+    ref->decref();
+  }
+
+  iso->decref();
+  ply->decref();
+
+  printf("Shell stiffness cache: %s\n", fail ? "FAILED" : "PASSED");
+
+  MPI_Finalize();
+  return fail;
+}
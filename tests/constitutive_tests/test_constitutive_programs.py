@@ -0,0 +1,34 @@
+"""
+Run the compiled C++ tests in this directory.
+
+The programs are built into bin/ by running "make" (or "make complex") in
+this directory after the TACS library has been built. See
+compiled_program_base_test.py for how they are run.
+"""
+
+import os
+import sys
+
+base_dir = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(base_dir, "..", "integration_tests"))
+
+from compiled_program_base_test import ProgramTestCase
+
+
+class ProgramTest(ProgramTestCase):
+    program_dir = base_dir
+
+    def test_gp_batch(self):
+        self.run_program("gp_batch_test")
+
+    def test_panel_cache(self):
+        self.run_program("panel_cache_test")
+
+    def test_stiffness_cache(self):
+        self.run_program("stiffness_cache_test")
+
+    def test_panel_analysis(self):
+        self.run_program("panel_analysis_test")
+
+    def test_ply_failure(self):
+        self.run_program("ply_failure_benchmark")
@@ -0,0 +1,322 @@
+/*
+  Test that the screened failure aggregates match the unscreened values
+
+  A cantilever is loaded by a bending displacement field so that the
+  failure index is concentrated near the root. The KS failure and
+  induced failure functions are evaluated with and without element
+  screening. The screened functions are first fully evaluated at a
+  reference state to record the spread of the failure index in each
+  element. They are then evaluated at a set of perturbed states and at
+  the same state twice. All of these values must agree with the
+  unscreened values to within the bound implied by the tolerance, and
+  the screening must skip some of the elements.
+
+  The functions are then integrated over a sequence of time steps with
+  a decaying load, using the same order of evaluation as the time
+  integrators: the INITIALIZE pass runs over every step before the
+  INTEGRATE pass. The screened values must again agree with the
+  unscreened values.
+*/
+
+#include <math.h>
+
+#include "TACSCreator.h"
+#include "TACSElement2D.h"
+#include "TACSInducedFailure.h"
+#include "TACSKSFailure.h"
+#include "TACSLinearElasticity.h"
+#include "TACSQuadBasis.h"
+
+/*
+  Create a plane stress model of a cantilever with the mesh graded
+  towards the root
+*/
+TACSAssembler *createAssembler(MPI_Comm comm, int nx, int ny) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSCreator *creator = new TACSCreator(comm, 2);
+  creator->incref();
+
+  if (rank == 0) {
+    int num_nodes = (nx + 1) * (ny + 1);
+    int num_elems = nx * ny;
+    int *ptr = new int[num_elems + 1];
+    int *conn = new int[4 * num_elems];
+    int *ids = new int[num_elems];
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int e = i + nx * j;
+        ptr[e] = 4 * e;
+        ids[e] = 0;
+        conn[4 * e] = i + (nx + 1) * j;
+        conn[4 * e + 1] = i + 1 + (nx + 1) * j;
+        conn[4 * e + 2] = i + (nx + 1) * (j + 1);
+        conn[4 * e + 3] = i + 1 + (nx + 1) * (j + 1);
+      }
+    }
+    ptr[num_elems] = 4 * num_elems;
+    creator->setGlobalConnectivity(num_nodes, num_elems, ptr, conn, ids);
+
+    TacsScalar *X = new TacsScalar[3 * num_nodes];
+    for (int j = 0; j < ny + 1; j++) {
+      for (int i = 0; i < nx + 1; i++) {
+        int n = i + (nx + 1) * j;
+        X[3 * n] = 4.0 * pow((1.0 * i) / nx, 1.5);
+        X[3 * n + 1] = (1.0 * j) / ny;
+        X[3 * n + 2] = 0.0;
+      }
+    }
+    creator->setNodes(X);
+
+    delete[] ptr;
+    delete[] conn;
+    delete[] ids;
+    delete[] X;
+  }
+
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2700.0, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TACSPlaneStressConstitutive *con =
+      new TACSPlaneStressConstitutive(props, 0.1, 0);
+  TACSLinearElasticity2D *model =
+      new TACSLinearElasticity2D(con, TACS_LINEAR_STRAIN);
+  TACSElement *elem = new TACSElement2D(model, new TACSLinearQuadBasis());
+  creator->setElements(1, &elem);
+
+  TACSAssembler *assembler = creator->createTACS();
+  creator->decref();
+
+  return assembler;
+}
+
+/*
+  Set a bending displacement field with the largest strain at the root
+*/
+void setBendingState(TACSAssembler *assembler, TACSBVec *ans, double amp,
+                     double noise) {
+  TACSBVec *X = assembler->createNodeVec();
+  X->incref();
+  assembler->getNodes(X);
+
+  TacsScalar *x, *u;
+  X->getArray(&x);
+  int size = ans->getArray(&u);
+  for (int i = 0; i < size / 2; i++) {
+    double xi = TacsRealPart(x[3 * i]), yi = TacsRealPart(x[3 * i + 1]);
+    u[2 * i] = -amp * (yi - 0.5) * (8.0 * xi - xi * xi);
+    u[2 * i + 1] = amp * (4.0 * xi * xi - xi * xi * xi / 3.0);
+  }
+  X->decref();
+
+  // Add a small perturbation to the state
+  if (noise != 0.0) {
+    TACSBVec *temp = assembler->createVec();
+    temp->incref();
+    temp->setRand(-noise, noise);
+    ans->axpy(1.0, temp);
+    temp->decref();
+  }
+  assembler->setVariables(ans);
+}
+
+/*
+  Evaluate the functions over a sequence of states in the same way as
+  TACSIntegrator::evalFunctions: the INITIALIZE pass is completed for
+  all of the states before the INTEGRATE pass begins.
+*/
+void evalTransientFunctions(TACSAssembler *assembler, int num_steps,
+                            const double times[], TACSBVec **states,
+                            int num_funcs, TACSFunction **funcs,
+                            TacsScalar *fvals) {
+  for (int k = 0; k < 2; k++) {
+    TACSFunction::EvaluationType ftype =
+        (k == 0 ? TACSFunction::INITIALIZE : TACSFunction::INTEGRATE);
+    for (int n = 0; n < num_funcs; n++) {
+      funcs[n]->initEvaluation(ftype);
+    }
+    for (int i = 0; i < num_steps; i++) {
+      double tcoeff = 0.0;
+      if (i > 0) {
+        tcoeff += 0.5 * (times[i] - times[i - 1]);
+      }
+      if (i < num_steps - 1) {
+        tcoeff += 0.5 * (times[i + 1] - times[i]);
+      }
+      assembler->setSimulationTime(times[i]);
+      assembler->setVariables(states[i]);
+      assembler->integrateFunctions(tcoeff, ftype, num_funcs, funcs);
+    }
+    for (int n = 0; n < num_funcs; n++) {
+      funcs[n]->finalEvaluation(ftype);
+    }
+  }
+
+  for (int n = 0; n < num_funcs; n++) {
+    fvals[n] = funcs[n]->getFunctionValue();
+  }
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSAssembler *assembler = createAssembler(comm, 64, 8);
+  assembler->incref();
+
+  TACSBVec *ans = assembler->createVec();
+  ans->incref();
+
+  // Create the unscreened (first half) and screened (second half)
+  // functions
+  const double tol = 1e-6;
+  const int num_funcs = 4;
+  const double weights[] = {100.0, 100.0, 100.0, 100.0};
+  TACSFunction *funcs[2 * num_funcs];
+  for (int i = 0; i < 2; i++) {
+    TACSKSFailure *ks1 = new TACSKSFailure(assembler, weights[0]);
+    ks1->setKSAggregationType(KS_DISCRETE);
+    TACSKSFailure *ks2 = new TACSKSFailure(assembler, weights[1]);
+    ks2->setKSAggregationType(KS_CONTINUOUS);
+    TACSInducedFailure *ind1 = new TACSInducedFailure(assembler, weights[2]);
+    ind1->setInducedType(EXPONENTIAL);
+    TACSInducedFailure *ind2 = new TACSInducedFailure(assembler, weights[3]);
+    ind2->setInducedType(DISCRETE_EXPONENTIAL);
+    if (i == 1) {
+      ks1->setFailureScreening(tol);
+      ks2->setFailureScreening(tol);
+      ind1->setFailureScreening(tol);
+      ind2->setFailureScreening(tol);
+    }
+    funcs[num_funcs * i] = ks1;
+    funcs[num_funcs * i + 1] = ks2;
+    funcs[num_funcs * i + 2] = ind1;
+    funcs[num_funcs * i + 3] = ind2;
+  }
+  for (int k = 0; k < 2 * num_funcs; k++) {
+    funcs[k]->incref();
+  }
+
+  // Evaluate the screened functions at the reference state to record
+  // the spread of the failure index within each element
+  TacsScalar fvals[2 * num_funcs];
+  setBendingState(assembler, ans, 2e-3, 0.0);
+  assembler->evalFunctions(num_funcs, &funcs[num_funcs], &fvals[num_funcs]);
+
+  // Evaluate at perturbed states, repeating the last state
+  const int num_states = 4;
+  const double amps[] = {2.02e-3, 1.95e-3, 2.1e-3, 2.1e-3};
+  int fail = 0;
+  double skipped = 0.0;
+  for (int k = 0; k < num_states; k++) {
+    if (k == 0 || amps[k] != amps[k - 1]) {
+      setBendingState(assembler, ans, amps[k], 1e-7);
+    }
+    assembler->evalFunctions(num_funcs, funcs, fvals);
+    assembler->evalFunctions(num_funcs, &funcs[num_funcs], &fvals[num_funcs]);
+
+    for (int i = 0; i < num_funcs; i++) {
+      double fval = TacsRealPart(fvals[i]);
+      double fscreen = TacsRealPart(fvals[num_funcs + i]);
+      double frac = 0.0;
+      if (i < 2) {
+        frac = ((TACSKSFailure *)funcs[num_funcs + i])->getSkippedFraction();
+      } else {
+        frac =
+            ((TACSInducedFailure *)funcs[num_funcs + i])->getSkippedFraction();
+      }
+      skipped += frac / (num_states * num_funcs);
+
+      // The KS value changes by at most log(1 + tol)/weight. The
+      // induced value is a weighted average of the failure values, so
+      // it changes by at most tol times the maximum failure value.
+      double bound = log(1.0 + tol) / weights[i];
+      if (i >= 2) {
+        bound = tol * fabs(fval);
+      }
+      double err = fabs(fscreen - fval);
+      int func_fail = !(err <= bound);
+      fail = fail || func_fail;
+
+      if (rank == 0) {
+        printf("%-20s state %d f %15.10e error %10.3e bound %10.3e "
+               "skipped %5.3f %s\n",
+               funcs[i]->getObjectName(), k, fval, err, bound, frac,
+               func_fail ? "FAILED" : "");
+      }
+    }
+  }
+
+  // Check that the screening is effective
+  if (!(skipped > 0.1)) {
+    fail = 1;
+  }
+
+  // Integrate the functions over a set of steps where the load decays
+  // so that the last step has the lowest failure values
+  const int num_steps = 5;
+  const double times[] = {0.0, 0.1, 0.2, 0.3, 0.4};
+  const double step_amps[] = {2.1e-3, 1.6e-3, 1.1e-3, 0.6e-3, 0.1e-3};
+  TACSBVec *states[num_steps];
+  for (int i = 0; i < num_steps; i++) {
+    states[i] = assembler->createVec();
+    states[i]->incref();
+    setBendingState(assembler, states[i], step_amps[i], 1e-7);
+  }
+
+  // Evaluate twice so that the second evaluation is screened using the
+  // spreads recorded in the first
+  for (int iter = 0; iter < 2; iter++) {
+    evalTransientFunctions(assembler, num_steps, times, states, num_funcs,
+                           funcs, fvals);
+    evalTransientFunctions(assembler, num_steps, times, states, num_funcs,
+                           &funcs[num_funcs], &fvals[num_funcs]);
+  }
+
+  for (int i = 0; i < num_funcs; i++) {
+    double fval = TacsRealPart(fvals[i]);
+    double fscreen = TacsRealPart(fvals[num_funcs + i]);
+    double frac = 0.0;
+    if (i < 2) {
+      frac = ((TACSKSFailure *)funcs[num_funcs + i])->getSkippedFraction();
+    } else {
+      frac = ((TACSInducedFailure *)funcs[num_funcs + i])->getSkippedFraction();
+    }
+
+    double bound = log(1.0 + tol) / weights[i];
+    if (i >= 2) {
+      bound = tol * fabs(fval);
+    }
+    double err = fabs(fscreen - fval);
+    int func_fail = !(err <= bound);
+    fail = fail || func_fail;
+
+    if (rank == 0) {
+      printf("%-20s transient f %15.10e error %10.3e bound %10.3e "
+             "skipped %5.3f %s\n",
+             funcs[i]->getObjectName(), fval, err, bound, frac,
+             func_fail ? "FAILED" : "");
+    }
+  }
+
+  for (int i = 0; i < num_steps; i++) {
+    states[i]->decref();
+  }
+
+  if (rank == 0) {
+    printf("Average skipped fraction %5.3f\n", skipped);
+    printf("Failure screening: %s\n", fail ? "FAILED" : "PASSED");
+  }
+
+  for (int k = 0; k < 2 * num_funcs; k++) {
+    funcs[k]->decref();
+  }
+  ans->decref();
+  assembler->decref();
+
+  MPI_Finalize();
+  return fail;
+}
@@ -0,0 +1,270 @@
+/*
+  Test that the fused function sensitivities match the sensitivities
+  evaluated one function at a time
+
+  The derivatives of several KS failure and KS displacement functions
+  and the structural mass are computed with respect to the design
+  variables, the node locations and the state variables. The fused
+  evaluation of all functions in one call, which shares the point
+  quantities between the KS functions, is compared against separate
+  calls with one function each that use the per-function element
+  routines.
+*/
+
+#include "TACSCreator.h"
+#include "TACSElement2D.h"
+#include "TACSKSDisplacement.h"
+#include "TACSKSFailure.h"
+#include "TACSLinearElasticity.h"
+#include "TACSQuadBasis.h"
+#include "TACSStructuralMass.h"
+
+/*
+  KS failure function that does not provide a point quantity, so that
+  the sensitivities are computed with the per-function element calls
+*/
+class TACSKSFailureRef : public TACSKSFailure {
+ public:
+  TACSKSFailureRef(TACSAssembler *assembler, double ksWeight)
+      : TACSKSFailure(assembler, ksWeight) {}
+  int getPointQuantityType() { return -1; }
+};
+
+/*
+  KS displacement function that does not provide a point quantity
+*/
+class TACSKSDisplacementRef : public TACSKSDisplacement {
+ public:
+  TACSKSDisplacementRef(TACSAssembler *assembler, double ksWeight,
+                        const double *dir)
+      : TACSKSDisplacement(assembler, ksWeight, dir) {}
+  int getPointQuantityType() { return -1; }
+};
+
+/*
+  Create a plane stress model of a cantilever with one design variable
+  for each of the components
+*/
+TACSAssembler *createAssembler(MPI_Comm comm, int nx, int ny, int ncomp) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSCreator *creator = new TACSCreator(comm, 2);
+  creator->incref();
+
+  if (rank == 0) {
+    int num_nodes = (nx + 1) * (ny + 1);
+    int num_elems = nx * ny;
+    int *ptr = new int[num_elems + 1];
+    int *conn = new int[4 * num_elems];
+    int *ids = new int[num_elems];
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int e = i + nx * j;
+        ptr[e] = 4 * e;
+        ids[e] = (ncomp * i) / nx;
+        conn[4 * e] = i + (nx + 1) * j;
+        conn[4 * e + 1] = i + 1 + (nx + 1) * j;
+        conn[4 * e + 2] = i + (nx + 1) * (j + 1);
+        conn[4 * e + 3] = i + 1 + (nx + 1) * (j + 1);
+      }
+    }
+    ptr[num_elems] = 4 * num_elems;
+    creator->setGlobalConnectivity(num_nodes, num_elems, ptr, conn, ids);
+
+    int *bcs = new int[ny + 1];
+    for (int j = 0; j < ny + 1; j++) {
+      bcs[j] = (nx + 1) * j;
+    }
+    creator->setBoundaryConditions(ny + 1, bcs);
+
+    TacsScalar *X = new TacsScalar[3 * num_nodes];
+    for (int j = 0; j < ny + 1; j++) {
+      for (int i = 0; i < nx + 1; i++) {
+        int n = i + (nx + 1) * j;
+        X[3 * n] = 4.0 * i / nx;
+        X[3 * n + 1] = (1.0 * j) / ny + 0.05 * sin(1.0 * i);
+        X[3 * n + 2] = 0.0;
+      }
+    }
+    creator->setNodes(X);
+
+    delete[] ptr;
+    delete[] conn;
+    delete[] ids;
+    delete[] bcs;
+    delete[] X;
+  }
+
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2700.0, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TACSElementBasis *basis = new TACSLinearQuadBasis();
+  TACSElement **elems = new TACSElement *[ncomp];
+  for (int k = 0; k < ncomp; k++) {
+    TacsScalar t = 0.1 + 0.02 * k;
+    TACSPlaneStressConstitutive *con =
+        new TACSPlaneStressConstitutive(props, t, k, 0.01, 1.0);
+    TACSLinearElasticity2D *model =
+        new TACSLinearElasticity2D(con, TACS_NONLINEAR_STRAIN);
+    elems[k] = new TACSElement2D(model, basis);
+  }
+  creator->setElements(ncomp, elems);
+  delete[] elems;
+
+  TACSAssembler *assembler = creator->createTACS();
+  creator->decref();
+
+  return assembler;
+}
+
+/*
+  Compute the relative difference between two vectors
+*/
+double relDiff(TACSBVec *a, TACSBVec *b, TACSBVec *temp) {
+  temp->copyValues(a);
+  temp->axpy(-1.0, b);
+  double norm = TacsRealPart(a->norm());
+  double diff = TacsRealPart(temp->norm());
+  return (norm > 0.0 ? diff / norm : diff);
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  const int ncomp = 4;
+  TACSAssembler *assembler = createAssembler(comm, 16, 6, ncomp);
+  assembler->incref();
+
+  // Set a state that produces non-trivial failure values
+  TACSBVec *ans = assembler->createVec();
+  ans->incref();
+  ans->setRand(-0.01, 0.01);
+  assembler->setBCs(ans);
+  assembler->setVariables(ans, ans, ans);
+
+  // Create the functions evaluated with the point quantities (first
+  // half) and with the per-function element calls (second half)
+  const int num_funcs = 6;
+  double dir1[] = {0.0, 1.0, 0.0};
+  double dir2[] = {1.0, 0.5, 0.0};
+  int sub_domain[] = {0, 2, 5, 7};
+  TACSFunction *funcs[2 * num_funcs];
+  for (int i = 0; i < 2; i++) {
+    TACSFunction **f = &funcs[num_funcs * i];
+    TACSKSFailure *ks1, *ks2, *ks3;
+    TACSKSDisplacement *ksd1, *ksd2;
+    if (i == 0) {
+      ks1 = new TACSKSFailure(assembler, 30.0);
+      ks2 = new TACSKSFailure(assembler, 80.0);
+      ks3 = new TACSKSFailure(assembler, 50.0);
+      ksd1 = new TACSKSDisplacement(assembler, 20.0, dir1);
+      ksd2 = new TACSKSDisplacement(assembler, 20.0, dir2);
+    } else {
+      ks1 = new TACSKSFailureRef(assembler, 30.0);
+      ks2 = new TACSKSFailureRef(assembler, 80.0);
+      ks3 = new TACSKSFailureRef(assembler, 50.0);
+      ksd1 = new TACSKSDisplacementRef(assembler, 20.0, dir1);
+      ksd2 = new TACSKSDisplacementRef(assembler, 20.0, dir2);
+    }
+    ks2->setKSAggregationType(KS_CONTINUOUS);
+    ksd2->setKSAggregationType(PNORM_CONTINUOUS);
+    ks3->setDomain(4, sub_domain);
+    f[0] = ks1;
+    f[1] = ks2;
+    f[2] = ksd1;
+    f[3] = ks3;
+    f[4] = ksd2;
+    f[5] = new TACSStructuralMass(assembler);
+  }
+
+  TACSBVec *dfdx[2 * num_funcs], *dfdXpt[2 * num_funcs], *dfdu[2 * num_funcs];
+  for (int k = 0; k < 2 * num_funcs; k++) {
+    funcs[k]->incref();
+    dfdx[k] = assembler->createDesignVec();
+    dfdx[k]->incref();
+    dfdXpt[k] = assembler->createNodeVec();
+    dfdXpt[k]->incref();
+    dfdu[k] = assembler->createVec();
+    dfdu[k]->incref();
+  }
+
+  // Evaluate the fused sensitivities for all functions at once
+  TacsScalar fvals[2 * num_funcs];
+  assembler->evalFunctions(num_funcs, funcs, fvals);
+  assembler->addDVSens(1.0, num_funcs, funcs, dfdx);
+  assembler->addXptSens(1.0, num_funcs, funcs, dfdXpt);
+  assembler->addSVSens(1.0, 0.5, 0.25, num_funcs, funcs, dfdu);
+
+  // Evaluate the reference sensitivities one function at a time
+  for (int k = num_funcs; k < 2 * num_funcs; k++) {
+    assembler->evalFunctions(1, &funcs[k], &fvals[k]);
+    assembler->addDVSens(1.0, 1, &funcs[k], &dfdx[k]);
+    assembler->addXptSens(1.0, 1, &funcs[k], &dfdXpt[k]);
+    assembler->addSVSens(1.0, 0.5, 0.25, 1, &funcs[k], &dfdu[k]);
+  }
+
+  for (int k = 0; k < 2 * num_funcs; k++) {
+    dfdx[k]->beginSetValues(TACS_ADD_VALUES);
+    dfdXpt[k]->beginSetValues(TACS_ADD_VALUES);
+  }
+  for (int k = 0; k < 2 * num_funcs; k++) {
+    dfdx[k]->endSetValues(TACS_ADD_VALUES);
+    dfdXpt[k]->endSetValues(TACS_ADD_VALUES);
+  }
+
+  // Compare the values and the derivatives
+  const double tol = 1e-10;
+  int fail = 0;
+  TACSBVec *dx = assembler->createDesignVec();
+  TACSBVec *dX = assembler->createNodeVec();
+  TACSBVec *du = assembler->createVec();
+  dx->incref();
+  dX->incref();
+  du->incref();
+  for (int k = 0; k < num_funcs; k++) {
+    double fval = TacsRealPart(fvals[k]);
+    double fref = TacsRealPart(fvals[num_funcs + k]);
+    double err[4];
+    err[0] = fabs(fval - fref) / fabs(fref);
+    err[1] = relDiff(dfdx[num_funcs + k], dfdx[k], dx);
+    err[2] = relDiff(dfdXpt[num_funcs + k], dfdXpt[k], dX);
+    err[3] = relDiff(dfdu[num_funcs + k], dfdu[k], du);
+
+    int func_fail = 0;
+    for (int i = 0; i < 4; i++) {
+      if (!(err[i] < tol)) {
+        func_fail = 1;
+      }
+    }
+    fail = fail || func_fail;
+
+    if (rank == 0) {
+      printf(
+          "%-20s f %10.3e dfdx %10.3e dfdXpt %10.3e dfdu %10.3e %s\n",
+          funcs[k]->getObjectName(), err[0], err[1], err[2], err[3],
+          func_fail ? "FAILED" : "");
+    }
+  }
+  if (rank == 0) {
+    printf("Fused function sensitivities: %s\n", fail ? "FAILED" : "PASSED");
+  }
+
+  dx->decref();
+  dX->decref();
+  du->decref();
+  for (int k = 0; k < 2 * num_funcs; k++) {
+    funcs[k]->decref();
+    dfdx[k]->decref();
+    dfdXpt[k]->decref();
+    dfdu[k]->decref();
+  }
+  ans->decref();
+  assembler->decref();
+
+  MPI_Finalize();
+  return fail;
+}
@@ -0,0 +1,245 @@
+/*
+  Test that the single-pass evaluation of the KS functions matches the
+  two-pass evaluation
+
+  The KS failure and KS displacement functions are evaluated with the
+  single-pass evaluation, which accumulates the maximum and the
+  rescaled sum together, and with the default evaluation that finds
+  the maximum in a separate pass. The function values and the
+  derivatives with respect to the states and the node locations are
+  compared. The test is run before TacsInitialize(), when the partial
+  sums are gathered on every processor, and after it, when they are
+  merged with the KS reduction operation.
+*/
+
+#include "TACSCreator.h"
+#include "TACSElement2D.h"
+#include "TACSKSDisplacement.h"
+#include "TACSKSFailure.h"
+#include "TACSLinearElasticity.h"
+#include "TACSQuadBasis.h"
+
+/*
+  Create a plane stress model of a cantilever with one design variable
+  for each of the components
+*/
+TACSAssembler *createAssembler(MPI_Comm comm, int nx, int ny, int ncomp) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSCreator *creator = new TACSCreator(comm, 2);
+  creator->incref();
+
+  if (rank == 0) {
+    int num_nodes = (nx + 1) * (ny + 1);
+    int num_elems = nx * ny;
+    int *ptr = new int[num_elems + 1];
+    int *conn = new int[4 * num_elems];
+    int *ids = new int[num_elems];
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int e = i + nx * j;
+        ptr[e] = 4 * e;
+        ids[e] = (ncomp * i) / nx;
+        conn[4 * e] = i + (nx + 1) * j;
+        conn[4 * e + 1] = i + 1 + (nx + 1) * j;
+        conn[4 * e + 2] = i + (nx + 1) * (j + 1);
+        conn[4 * e + 3] = i + 1 + (nx + 1) * (j + 1);
+      }
+    }
+    ptr[num_elems] = 4 * num_elems;
+    creator->setGlobalConnectivity(num_nodes, num_elems, ptr, conn, ids);
+
+    int *bcs = new int[ny + 1];
+    for (int j = 0; j < ny + 1; j++) {
+      bcs[j] = (nx + 1) * j;
+    }
+    creator->setBoundaryConditions(ny + 1, bcs);
+
+    TacsScalar *X = new TacsScalar[3 * num_nodes];
+    for (int j = 0; j < ny + 1; j++) {
+      for (int i = 0; i < nx + 1; i++) {
+        int n = i + (nx + 1) * j;
+        X[3 * n] = 4.0 * i / nx;
+        X[3 * n + 1] = (1.0 * j) / ny + 0.05 * sin(1.0 * i);
+        X[3 * n + 2] = 0.0;
+      }
+    }
+    creator->setNodes(X);
+
+    delete[] ptr;
+    delete[] conn;
+    delete[] ids;
+    delete[] bcs;
+    delete[] X;
+  }
+
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2700.0, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TACSElementBasis *basis = new TACSLinearQuadBasis();
+  TACSElement **elems = new TACSElement *[ncomp];
+  for (int k = 0; k < ncomp; k++) {
+    TacsScalar t = 0.1 + 0.02 * k;
+    TACSPlaneStressConstitutive *con =
+        new TACSPlaneStressConstitutive(props, t, k, 0.01, 1.0);
+    TACSLinearElasticity2D *model =
+        new TACSLinearElasticity2D(con, TACS_NONLINEAR_STRAIN);
+    elems[k] = new TACSElement2D(model, basis);
+  }
+  creator->setElements(ncomp, elems);
+  delete[] elems;
+
+  TACSAssembler *assembler = creator->createTACS();
+  creator->decref();
+
+  return assembler;
+}
+
+/*
+  Compute the relative difference between two vectors
+*/
+double relDiff(TACSBVec *a, TACSBVec *b, TACSBVec *temp) {
+  temp->copyValues(a);
+  temp->axpy(-1.0, b);
+  double norm = TacsRealPart(a->norm());
+  double diff = TacsRealPart(temp->norm());
+  return (norm > 0.0 ? diff / norm : diff);
+}
+
+/*
+  Compare the single-pass and two-pass evaluation of the functions.
+  The functions are stored in pairs with the single-pass function
+  first.
+*/
+int testSinglePass(TACSAssembler *assembler, int num_pairs,
+                   TACSFunction **funcs, const char **names) {
+  int rank;
+  MPI_Comm_rank(assembler->getMPIComm(), &rank);
+
+  TACSBVec *dfdu[2], *dfdXpt[2];
+  for (int i = 0; i < 2; i++) {
+    dfdu[i] = assembler->createVec();
+    dfdu[i]->incref();
+    dfdXpt[i] = assembler->createNodeVec();
+    dfdXpt[i]->incref();
+  }
+  TACSBVec *du = assembler->createVec();
+  TACSBVec *dX = assembler->createNodeVec();
+  du->incref();
+  dX->incref();
+
+  const double tol = 1e-12;
+  int fail = 0;
+  for (int k = 0; k < num_pairs; k++) {
+    TacsScalar fvals[2];
+    for (int i = 0; i < 2; i++) {
+      TACSFunction *func = funcs[2 * k + i];
+      assembler->evalFunctions(1, &func, &fvals[i]);
+      dfdu[i]->zeroEntries();
+      dfdXpt[i]->zeroEntries();
+      assembler->addSVSens(1.0, 0.0, 0.0, 1, &func, &dfdu[i]);
+      assembler->addXptSens(1.0, 1, &func, &dfdXpt[i]);
+      dfdXpt[i]->beginSetValues(TACS_ADD_VALUES);
+      dfdXpt[i]->endSetValues(TACS_ADD_VALUES);
+    }
+
+    double err[3];
+    err[0] = fabs(TacsRealPart(fvals[0] - fvals[1])) /
+             fabs(TacsRealPart(fvals[1]));
+    err[1] = relDiff(dfdu[1], dfdu[0], du);
+    err[2] = relDiff(dfdXpt[1], dfdXpt[0], dX);
+
+    int func_fail = 0;
+    for (int i = 0; i < 3; i++) {
+      if (!(err[i] < tol)) {
+        func_fail = 1;
+      }
+    }
+    fail = fail || func_fail;
+
+    if (rank == 0) {
+      printf("%-26s f %10.3e dfdu %10.3e dfdXpt %10.3e %s\n", names[k],
+             err[0], err[1], err[2], func_fail ? "FAILED" : "");
+    }
+  }
+
+  for (int i = 0; i < 2; i++) {
+    dfdu[i]->decref();
+    dfdXpt[i]->decref();
+  }
+  du->decref();
+  dX->decref();
+
+  return fail;
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSAssembler *assembler = createAssembler(comm, 16, 6, 4);
+  assembler->incref();
+
+  // Set a state that produces non-trivial function values
+  TACSBVec *ans = assembler->createVec();
+  ans->incref();
+  ans->setRand(-0.01, 0.01);
+  assembler->setBCs(ans);
+  assembler->setVariables(ans);
+
+  // Create the pairs of single-pass and two-pass functions
+  const int num_pairs = 5;
+  const char *names[] = {"KSFailure discrete", "KSFailure continuous",
+                         "KSFailure average", "KSDisplacement discrete",
+                         "KSDisplacement continuous"};
+  KSAggregationType types[] = {KS_DISCRETE, KS_CONTINUOUS,
+                               KS_DISCRETE_AVERAGE, KS_DISCRETE,
+                               KS_CONTINUOUS};
+  double dir[] = {0.3, 1.0, 0.0};
+  TACSFunction *funcs[2 * num_pairs];
+  for (int k = 0; k < num_pairs; k++) {
+    for (int i = 0; i < 2; i++) {
+      if (k < 3) {
+        TACSKSFailure *ks = new TACSKSFailure(assembler, 100.0);
+        ks->setKSAggregationType(types[k]);
+        ks->setSinglePassEvaluation(i == 0);
+        funcs[2 * k + i] = ks;
+      } else {
+        TACSKSDisplacement *ks = new TACSKSDisplacement(assembler, 100.0, dir);
+        ks->setKSAggregationType(types[k]);
+        ks->setSinglePassEvaluation(i == 0);
+        funcs[2 * k + i] = ks;
+      }
+      funcs[2 * k + i]->incref();
+    }
+  }
+
+  // Merge the partial sums without and with the KS reduction operation
+  if (rank == 0) {
+    printf("Gathered partial sums\n");
+  }
+  int fail = testSinglePass(assembler, num_pairs, funcs, names);
+
+  TacsInitialize();
+  if (rank == 0) {
+    printf("KS reduction operation\n");
+  }
+  fail = testSinglePass(assembler, num_pairs, funcs, names) || fail;
+
+  if (rank == 0) {
+    printf("Single-pass KS evaluation: %s\n", fail ? "FAILED" : "PASSED");
+  }
+
+  for (int k = 0; k < 2 * num_pairs; k++) {
+    funcs[k]->decref();
+  }
+  ans->decref();
+  assembler->decref();
+
+  TacsFinalize();
+  MPI_Finalize();
+  return fail;
+}
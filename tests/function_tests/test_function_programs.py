@@ -0,0 +1,28 @@
+"""
+Run the compiled C++ tests in this directory.
+
+The programs are built into bin/ by running "make" (or "make complex") in
+this directory after the TACS library has been built. See
+compiled_program_base_test.py for how they are run.
+"""
+
+import os
+import sys
+
+base_dir = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(base_dir, "..", "integration_tests"))
+
+from compiled_program_base_test import ProgramTestCase
+
+
+class ProgramTest(ProgramTestCase):
+    program_dir = base_dir
+
+    def test_fused_sens(self):
+        self.run_program("fused_sens_test", 2)
+
+    def test_single_pass_ks(self):
+        self.run_program("single_pass_ks_test", 2)
+
+    def test_failure_screen(self):
+        self.run_program("failure_screen_test", 2)
@@ -0,0 +1,71 @@
+"""
+Base class for the tests that run the compiled C++ test programs.
+
+The programs in each test directory are built into its bin/ directory by
+running "make" (or "make complex") there after the TACS library has been
+built. Each program is run from the bin/ directory, so any files it writes
+are kept out of the source tree. A program prints its results and returns
+a nonzero exit code when a check fails. Programs that have not been built
+are skipped.
+"""
+
+import functools
+import os
+import shutil
+import subprocess
+import unittest
+
+
+@functools.lru_cache(maxsize=None)
+def get_mpirun_command():
+    """
+    Get the command that launches an MPI program, or None if no launcher
+    is available. Open MPI refuses to start more processes than there are
+    slots on the host unless oversubscription is allowed explicitly.
+    """
+    mpirun = shutil.which("mpirun")
+    if mpirun is None:
+        return None
+
+    try:
+        version = subprocess.run(
+            [mpirun, "--version"],
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+            universal_newlines=True,
+            timeout=60,
+        ).stdout
+    except (OSError, subprocess.SubprocessError):
+        version = ""
+
+    if "Open MPI" in version:
+        return (mpirun, "--oversubscribe")
+    return (mpirun,)
+
+
+class ProgramTestCase(unittest.TestCase):
+    # The test directory that contains the bin/ directory of programs
+    program_dir = None
+
+    def run_program(self, name, nprocs=1):
+        bin_dir = os.path.join(self.program_dir, "bin")
+        exe = os.path.join(bin_dir, name)
+        if not os.path.isfile(exe):
+            raise unittest.SkipTest(f"{name} has not been built")
+
+        cmd = [exe]
+        if nprocs > 1:
+            mpirun = get_mpirun_command()
+            if mpirun is None:
+                raise unittest.SkipTest("mpirun was not found")
+            cmd = [*mpirun, "-np", str(nprocs), exe]
+
+        result = subprocess.run(
+            cmd,
+            cwd=bin_dir,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+            universal_newlines=True,
+            timeout=400,
+        )
+        self.assertEqual(result.returncode, 0, msg=f"{name} failed:\n{result.stdout}")
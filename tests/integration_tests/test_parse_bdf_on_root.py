@@ -0,0 +1,114 @@
+import os
+import unittest
+
+import numpy as np
+from mpi4py import MPI
+
+from tacs import pytacs, elements, constitutive
+
+"""
+Test that parsing the bdf file on the root proc produces the same model as
+parsing it on every proc.
+
+With the "parseBDFOnRoot" option set, only the root proc holds the grid
+locations and element connectivity, while the other procs get their part of
+the mesh from TACSCreator. The components, node locations, assembler sizes,
+residuals and solutions of the problems read from the bdf file are compared
+against the default path. The cylinder model uses cylindrical coordinate
+systems, an RBE3 and point forces, while the rbe model uses RBE2 elements.
+"""
+
+base_dir = os.path.dirname(os.path.abspath(__file__))
+bdf_files = [
+    os.path.join(base_dir, "./input_files/cylinder.bdf"),
+    os.path.join(base_dir, "./input_files/rbe_test.bdf"),
+]
+
+
+def elem_call_back(
+    dv_num, comp_id, comp_descript, elem_descripts, global_dvs, **kwargs
+):
+    # Set up property model
+    prop = constitutive.MaterialProperties(rho=2500.0, E=70e9, nu=0.3, ys=464.0e6)
+    # Set up constitutive model
+    con = constitutive.IsoShellConstitutive(prop, t=0.005, tNum=dv_num)
+    # Set up element
+    elem = elements.Quad4Shell(None, con)
+    return elem
+
+
+class ParseBDFOnRootTest(unittest.TestCase):
+    N_PROCS = 2  # this is how many MPI processes to use for this TestCase.
+
+    def setUp(self):
+        self.comm = MPI.COMM_WORLD
+        self.rtol = 1e-10
+        self.atol = 1e-14
+
+    def createAssembler(self, bdf_file, parse_on_root):
+        fea_assembler = pytacs.pyTACS(
+            bdf_file, self.comm, options={"parseBDFOnRoot": parse_on_root}
+        )
+        fea_assembler.initialize(elem_call_back)
+        return fea_assembler
+
+    def test_parse_bdf_on_root(self):
+        for bdf_file in bdf_files:
+            with self.subTest(bdf_file=os.path.basename(bdf_file)):
+                ref = self.createAssembler(bdf_file, False)
+                root = self.createAssembler(bdf_file, True)
+
+                # The components and mesh sizes must match
+                self.assertEqual(ref.getCompNames(), root.getCompNames())
+                self.assertEqual(
+                    ref.meshLoader.getNumBDFNodes(), root.meshLoader.getNumBDFNodes()
+                )
+                self.assertEqual(
+                    ref.meshLoader.getNumBDFElements(),
+                    root.meshLoader.getNumBDFElements(),
+                )
+                self.assertEqual(ref.getNumOwnedNodes(), root.getNumOwnedNodes())
+                self.assertEqual(
+                    ref.getNumOwnedMultiplierNodes(), root.getNumOwnedMultiplierNodes()
+                )
+                self.assertEqual(ref.getVarsPerNode(), root.getVarsPerNode())
+                self.assertEqual(
+                    ref.assembler.getNumElements(), root.assembler.getNumElements()
+                )
+                np.testing.assert_allclose(
+                    ref.getOrigNodes(), root.getOrigNodes(), rtol=0.0, atol=0.0
+                )
+
+                # The problems read from the bdf file must agree
+                ref_probs = ref.createTACSProbsFromBDF()
+                root_probs = root.createTACSProbsFromBDF()
+                self.assertEqual(ref_probs.keys(), root_probs.keys())
+                for key in ref_probs:
+                    ref_prob = ref_probs[key]
+                    root_prob = root_probs[key]
+                    # Evaluate the residuals at the initial state, which hold the loads
+                    ref_res = ref_prob.assembler.createVec()
+                    root_res = root_prob.assembler.createVec()
+                    ref_prob.getResidual(ref_res)
+                    root_prob.getResidual(root_res)
+                    np.testing.assert_allclose(
+                        root_res.getArray(),
+                        ref_res.getArray(),
+                        rtol=self.rtol,
+                        atol=self.atol,
+                        err_msg=f"{key} residual does not match the default path",
+                    )
+
+                    ref_prob.solve()
+                    root_prob.solve()
+                    np.testing.assert_allclose(
+                        root_prob.getVariables(),
+                        ref_prob.getVariables(),
+                        rtol=self.rtol,
+                        atol=self.atol,
+                        err_msg=f"{key} solution does not match the default path",
+                    )
+
+
+if __name__ == "__main__":
+    unittest.main()
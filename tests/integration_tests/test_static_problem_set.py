@@ -0,0 +1,143 @@
+import os
+import unittest
+
+import numpy as np
+from mpi4py import MPI
+
+from tacs import pytacs, elements, constitutive, functions
+
+"""
+Test that a StaticProblemSet gives the same states, functions and
+sensitivities as solving each StaticProblem separately.
+
+Three load cases on the partitioned plate are solved as a set, which shares
+one factorization and packs the adjoint sensitivities, and as separate
+problems with private operators. The load cases have different functions so
+that the packed sensitivity blocks hold a varying number of rows per problem.
+"""
+
+base_dir = os.path.dirname(os.path.abspath(__file__))
+bdf_file = os.path.join(base_dir, "./input_files/partitioned_plate.bdf")
+
+# KS function weight
+ksweight = 10.0
+
+
+def elem_call_back(
+    dv_num, comp_id, comp_descript, elem_descripts, global_dvs, **kwargs
+):
+    # Set up property model
+    prop = constitutive.MaterialProperties(rho=2500.0, E=70e9, nu=0.3, ys=464.0e6)
+    # Set up constitutive model
+    con = constitutive.IsoShellConstitutive(prop, t=0.005, tNum=dv_num)
+    # Set up element
+    elem = elements.Quad4Shell(None, con)
+    return elem
+
+
+class StaticProblemSetTest(unittest.TestCase):
+    N_PROCS = 2  # this is how many MPI processes to use for this TestCase.
+
+    def setUp(self):
+        self.comm = MPI.COMM_WORLD
+        self.rtol = 1e-8
+        self.atol = 1e-10
+
+        self.fea_assembler = pytacs.pyTACS(bdf_file, self.comm)
+        self.fea_assembler.initialize(elem_call_back)
+
+        options = {"L2ConvergenceRel": 1e-14}
+        self.set_probs = []
+        self.ref_probs = []
+        for i in range(3):
+            for probs, prefix in [(self.set_probs, "set"), (self.ref_probs, "ref")]:
+                prob = self.fea_assembler.createStaticProblem(
+                    name=f"{prefix}_{i}", options=options
+                )
+                self.addLoadsAndFunctions(prob, i)
+                probs.append(prob)
+
+        self.problem_set = self.fea_assembler.createStaticProblemSet(
+            "load_cases", self.set_probs
+        )
+
+        # Perturb the design so that the thicknesses differ
+        x = self.fea_assembler.getOrigDesignVars()
+        x[:] = x * (1.0 + 0.1 * np.arange(len(x)))
+        self.problem_set.setDesignVars(x)
+        for prob in self.ref_probs:
+            prob.setDesignVars(x)
+
+    def addLoadsAndFunctions(self, prob, i):
+        compIDs = self.fea_assembler.selectCompIDs(include=f"PLATE.0{i}")
+        if i == 1:
+            prob.addPressureToComponents(compIDs, 1e5)
+        else:
+            F = np.array([0.0, 1e3 * i, 1e4, 0.0, 0.0, 0.0])
+            prob.addLoadToComponents(compIDs, F)
+
+        prob.addFunction("mass", functions.StructuralMass)
+        prob.addFunction("compliance", functions.Compliance)
+        if i != 1:
+            prob.addFunction("ks_vmfailure", functions.KSFailure, ksWeight=ksweight)
+        if i == 2:
+            prob.addFunction(
+                "ks_disp",
+                functions.KSDisplacement,
+                ksWeight=ksweight,
+                direction=[0.0, 0.0, 1.0],
+            )
+
+    def assertClose(self, actual, desired, msg):
+        np.testing.assert_allclose(
+            actual, desired, rtol=self.rtol, atol=self.atol, err_msg=msg
+        )
+
+    def test_problem_set(self):
+        # Solve the load cases together and separately
+        self.assertTrue(self.problem_set.solve())
+        for prob in self.ref_probs:
+            prob.solve()
+
+        for i, (set_prob, ref_prob) in enumerate(zip(self.set_probs, self.ref_probs)):
+            self.assertClose(
+                self.problem_set.states[i],
+                ref_prob.getVariables(),
+                f"states of load case {i}",
+            )
+            self.assertClose(
+                set_prob.getVariables(),
+                ref_prob.getVariables(),
+                f"problem states of load case {i}",
+            )
+
+        # Compare the functions
+        set_funcs = {}
+        ref_funcs = {}
+        self.problem_set.evalFunctions(set_funcs)
+        for prob in self.ref_probs:
+            prob.evalFunctions(ref_funcs)
+        self.assertEqual(len(set_funcs), len(ref_funcs))
+        for key in ref_funcs:
+            set_key = key.replace("ref_", "set_", 1)
+            self.assertClose(set_funcs[set_key], ref_funcs[key], key)
+
+        # Compare the sensitivities
+        set_sens = {}
+        ref_sens = {}
+        self.problem_set.evalFunctionsSens(set_sens)
+        for prob in self.ref_probs:
+            prob.evalFunctionsSens(ref_sens)
+        self.assertEqual(len(set_sens), len(ref_sens))
+        for key in ref_sens:
+            set_key = key.replace("ref_", "set_", 1)
+            for var_name in ref_sens[key]:
+                self.assertClose(
+                    set_sens[set_key][var_name],
+                    ref_sens[key][var_name],
+                    f"{key} {var_name} sensitivity",
+                )
+
+
+if __name__ == "__main__":
+    unittest.main()
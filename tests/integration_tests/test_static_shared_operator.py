@@ -0,0 +1,105 @@
+import os
+import unittest
+
+import numpy as np
+from mpi4py import MPI
+
+from tacs import pytacs, elements, constitutive
+
+"""
+Test that linear static problems sharing a stiffness operator produce the
+same solutions as problems with private operators.
+
+Two load cases on the partitioned plate are solved with the "shareOperator"
+option set and with private operators. The solutions are compared at the
+initial design, after a design change, and after one of the shared problems
+assembles the operator without boundary conditions.
+"""
+
+base_dir = os.path.dirname(os.path.abspath(__file__))
+bdf_file = os.path.join(base_dir, "./input_files/partitioned_plate.bdf")
+
+
+def elem_call_back(
+    dv_num, comp_id, comp_descript, elem_descripts, global_dvs, **kwargs
+):
+    # Set up property model
+    prop = constitutive.MaterialProperties(rho=2500.0, E=70e9, nu=0.3, ys=464.0e6)
+    # Set up constitutive model
+    con = constitutive.IsoShellConstitutive(prop, t=0.005, tNum=dv_num)
+    # Set up element
+    elem = elements.Quad4Shell(None, con)
+    return elem
+
+
+class SharedOperatorTest(unittest.TestCase):
+    N_PROCS = 2  # this is how many MPI processes to use for this TestCase.
+
+    def setUp(self):
+        self.comm = MPI.COMM_WORLD
+        self.rtol = 1e-8
+        self.atol = 1e-12
+
+        self.fea_assembler = pytacs.pyTACS(bdf_file, self.comm)
+        self.fea_assembler.initialize(elem_call_back)
+
+        # Create the load cases with shared and private operators
+        self.shared = []
+        self.private = []
+        for share, probs in [(True, self.shared), (False, self.private)]:
+            for i in range(2):
+                prob = self.fea_assembler.createStaticProblem(
+                    name=f"load_case_{i}_{share}",
+                    options={"shareOperator": share, "L2ConvergenceRel": 1e-14},
+                )
+                self.addLoads(prob, i)
+                probs.append(prob)
+
+    def addLoads(self, prob, i):
+        if i == 0:
+            F = np.array([0.0, 0.0, 1e4, 0.0, 0.0, 0.0])
+            compIDs = self.fea_assembler.selectCompIDs(include="PLATE.00")
+            prob.addLoadToComponents(compIDs, F)
+        else:
+            compIDs = self.fea_assembler.selectCompIDs(include="PLATE.01")
+            prob.addPressureToComponents(compIDs, 1e5)
+
+    def solveAndCompare(self, label):
+        for prob in self.shared + self.private:
+            prob.solve()
+        for shared, private in zip(self.shared, self.private):
+            np.testing.assert_allclose(
+                shared.getVariables(),
+                private.getVariables(),
+                rtol=self.rtol,
+                atol=self.atol,
+                err_msg=f"{shared.name} does not match the private operator {label}",
+            )
+
+    def test_shared_operator(self):
+        # The shared problems use a single operator
+        self.assertIsNotNone(self.shared[0].operator)
+        self.assertIs(self.shared[0].operator, self.shared[1].operator)
+        for prob in self.private:
+            self.assertIsNone(prob.operator)
+
+        self.solveAndCompare("at the initial design")
+
+        # Change the design variables
+        x = self.fea_assembler.getOrigDesignVars()
+        x[:] = 1.5 * x + 0.001 * np.arange(len(x))
+        for prob in self.shared + self.private:
+            prob.setDesignVars(x)
+        self.solveAndCompare("after a design change")
+
+        # Assemble the shared operator without boundary conditions. The
+        # other shared problem must reassemble it with the boundary
+        # conditions before solving.
+        version = self.shared[0].operator.version
+        self.shared[0].updateJacobian(applyBCs=False)
+        self.assertEqual(self.shared[0].operator.version, version + 1)
+        self.solveAndCompare("after an assembly without boundary conditions")
+
+
+if __name__ == "__main__":
+    unittest.main()
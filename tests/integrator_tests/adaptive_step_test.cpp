@@ -0,0 +1,298 @@
+/*
+  Test the adaptive time steps of the DIRK and ESDIRK integrators
+
+  A plane stress cantilever vibrates freely from an initial velocity
+  with the shape of the deflection of a tip-loaded beam. The final states of adaptive DIRK and ESDIRK runs are
+  compared against a reference solution computed with many uniform
+  time steps, and the error must decrease as the tolerance on the
+  local error is tightened.
+
+  The DIRK adjoint integrates over the accepted time steps. Its
+  gradient is checked against a central difference (or complex step)
+  computed on the same, frozen sequence of time steps.
+*/
+
+#include "TACSCreator.h"
+#include "TACSElement2D.h"
+#include "TACSIntegrator.h"
+#include "TACSKSFailure.h"
+#include "TACSLinearElasticity.h"
+#include "TACSQuadBasis.h"
+
+/*
+  Create a plane stress model of a cantilever with one design variable
+  for each of the components. The initial velocity follows the
+  Euler-Bernoulli deflection w(x) of a tip-loaded beam, with the axial
+  component -(y - 1/2)*w'(x) of a plane section. The beam starts from
+  its undeformed shape so that the initial acceleration is zero.
+*/
+TACSAssembler *createAssembler(MPI_Comm comm, int nx, int ny, int ncomp) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSCreator *creator = new TACSCreator(comm, 2);
+  creator->incref();
+
+  if (rank == 0) {
+    int num_nodes = (nx + 1) * (ny + 1);
+    int num_elems = nx * ny;
+    int *ptr = new int[num_elems + 1];
+    int *conn = new int[4 * num_elems];
+    int *ids = new int[num_elems];
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int e = i + nx * j;
+        ptr[e] = 4 * e;
+        ids[e] = (ncomp * i) / nx;
+        conn[4 * e] = i + (nx + 1) * j;
+        conn[4 * e + 1] = i + 1 + (nx + 1) * j;
+        conn[4 * e + 2] = i + (nx + 1) * (j + 1);
+        conn[4 * e + 3] = i + 1 + (nx + 1) * (j + 1);
+      }
+    }
+    ptr[num_elems] = 4 * num_elems;
+    creator->setGlobalConnectivity(num_nodes, num_elems, ptr, conn, ids);
+
+    int *bcs = new int[ny + 1];
+    for (int j = 0; j < ny + 1; j++) {
+      bcs[j] = (nx + 1) * j;
+    }
+    creator->setBoundaryConditions(ny + 1, bcs);
+
+    TacsScalar *X = new TacsScalar[3 * num_nodes];
+    for (int j = 0; j < ny + 1; j++) {
+      for (int i = 0; i < nx + 1; i++) {
+        int n = i + (nx + 1) * j;
+        X[3 * n] = 4.0 * i / nx;
+        X[3 * n + 1] = (1.0 * j) / ny;
+        X[3 * n + 2] = 0.0;
+      }
+    }
+    creator->setNodes(X);
+
+    delete[] ptr;
+    delete[] conn;
+    delete[] ids;
+    delete[] bcs;
+    delete[] X;
+  }
+
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2.7, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TACSElementBasis *basis = new TACSLinearQuadBasis();
+  TACSElement **elems = new TACSElement *[ncomp];
+  for (int k = 0; k < ncomp; k++) {
+    TacsScalar t = 0.1 + 0.02 * k;
+    TACSPlaneStressConstitutive *con =
+        new TACSPlaneStressConstitutive(props, t, k, 0.01, 1.0);
+    TACSLinearElasticity2D *model =
+        new TACSLinearElasticity2D(con, TACS_LINEAR_STRAIN);
+    elems[k] = new TACSElement2D(model, basis);
+  }
+  creator->setElements(ncomp, elems);
+  delete[] elems;
+
+  TACSAssembler *assembler = creator->createTACS();
+  creator->decref();
+
+  // Set the initial velocity from the node locations
+  TACSBVec *X = assembler->createNodeVec();
+  TACSBVec *vel = assembler->createVec();
+  X->incref();
+  vel->incref();
+  assembler->getNodes(X);
+  TacsScalar *Xpts, *v;
+  int size = vel->getArray(&v);
+  X->getArray(&Xpts);
+  for (int i = 0; i < size / 2; i++) {
+    TacsScalar x = 0.25 * Xpts[3 * i];
+    TacsScalar y = Xpts[3 * i + 1] - 0.5;
+    v[2 * i] = -0.0375 * y * x * (2.0 - x);
+    v[2 * i + 1] = 0.05 * x * x * (3.0 - x);
+  }
+  assembler->setBCs(vel);
+  assembler->setInitConditions(NULL, vel, NULL);
+  X->decref();
+  vel->decref();
+
+  return assembler;
+}
+
+/*
+  Compute the relative difference between the final states of two
+  integrations
+*/
+double finalStateError(TACSAssembler *assembler, TACSIntegrator *integrator,
+                       TACSIntegrator *ref) {
+  TACSBVec *q, *qref;
+  integrator->getStates(integrator->getNumTimeSteps(), &q, NULL, NULL);
+  ref->getStates(ref->getNumTimeSteps(), &qref, NULL, NULL);
+
+  TACSBVec *diff = assembler->createVec();
+  diff->incref();
+  diff->copyValues(q);
+  diff->axpy(-1.0, qref);
+  double err = TacsRealPart(diff->norm()) / TacsRealPart(qref->norm());
+  diff->decref();
+  return err;
+}
+
+/*
+  Run an adaptive integration with the given tolerance and return the
+  error in the final state
+*/
+double adaptiveError(TACSAssembler *assembler, TACSIntegrator *integrator,
+                     TACSIntegrator *ref, double rtol, int *num_steps,
+                     int *fail) {
+  integrator->setAdaptiveTimeStep(1, rtol, 0.1 * rtol);
+  *fail = integrator->integrate();
+  *num_steps = integrator->getNumTimeSteps();
+  return finalStateError(assembler, integrator, ref);
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  const int ncomp = 3;
+  TACSAssembler *assembler = createAssembler(comm, 8, 2, ncomp);
+  assembler->incref();
+
+  const double tinit = 0.0, tfinal = 0.5;
+  const int num_steps = 20;
+  int fail = 0;
+
+  // Compute the reference solution with many uniform steps
+  TACSIntegrator *ref =
+      new TACSESDIRKIntegrator(assembler, tinit, tfinal, 100 * num_steps, 8);
+  ref->incref();
+  ref->setPrintLevel(0);
+  ref->setRelTol(1e-12);
+  ref->setAbsTol(1e-14);
+  fail = ref->integrate();
+
+  // Check that the error of the adaptive integrations decreases with
+  // the tolerance. The DIRK error estimate compares the step against a
+  // second-order Taylor expansion and takes more steps for the same
+  // tolerance than the embedded ESDIRK estimates.
+  const char *names[] = {"DIRK3", "ESDIRK4", "ESDIRK6"};
+  const double rtols[][2] = {{1e-2, 1e-3}, {1e-3, 1e-5}, {1e-3, 1e-5}};
+  for (int k = 0; k < 3; k++) {
+    TACSIntegrator *integrator = NULL;
+    if (k == 0) {
+      integrator =
+          new TACSDIRKIntegrator(assembler, tinit, tfinal, num_steps, 3);
+    } else {
+      integrator = new TACSESDIRKIntegrator(assembler, tinit, tfinal,
+                                            num_steps, 2 + 2 * k);
+    }
+    integrator->incref();
+    integrator->setPrintLevel(0);
+    integrator->setRelTol(1e-12);
+    integrator->setAbsTol(1e-14);
+
+    int steps1, steps2, fail1, fail2;
+    double err1 = adaptiveError(assembler, integrator, ref, rtols[k][0],
+                                &steps1, &fail1);
+    double err2 = adaptiveError(assembler, integrator, ref, rtols[k][1],
+                                &steps2, &fail2);
+    int test_fail = (fail1 || fail2 || !(err2 < 0.5 * err1) || !(err1 < 0.1) ||
+                     !(steps2 > steps1));
+    fail = fail || test_fail;
+    if (rank == 0) {
+      printf("%-8s rtol %6.0e: %5d steps err %10.3e\n", names[k],
+             rtols[k][0], steps1, err1);
+      printf("%-8s rtol %6.0e: %5d steps err %10.3e %s\n", names[k],
+             rtols[k][1], steps2, err2, test_fail ? "FAILED" : "");
+    }
+    integrator->decref();
+  }
+
+  // Check the DIRK adjoint over the adaptive time steps
+  TACSKSFailure *ks = new TACSKSFailure(assembler, 20.0);
+  TACSFunction *func = ks;
+  func->incref();
+
+  TACSIntegrator *dirk =
+      new TACSDIRKIntegrator(assembler, tinit, tfinal, num_steps, 3);
+  dirk->incref();
+  dirk->setPrintLevel(0);
+  dirk->setRelTol(1e-12);
+  dirk->setAbsTol(1e-14);
+  dirk->setFunctions(1, &func);
+  dirk->setAdaptiveTimeStep(1, 1e-2, 1e-3);
+  fail = dirk->integrate() || fail;
+
+  TacsScalar fval;
+  dirk->evalFunctions(&fval);
+  dirk->integrateAdjoint();
+  TACSBVec *dfdx;
+  dirk->getGradient(0, &dfdx);
+
+  TACSBVec *x = assembler->createDesignVec();
+  TACSBVec *xpert = assembler->createDesignVec();
+  TACSBVec *xtmp = assembler->createDesignVec();
+  x->incref();
+  xpert->incref();
+  xtmp->incref();
+  assembler->getDesignVars(x);
+  xpert->setRand(-1.0, 1.0);
+  TacsScalar pdfdx = dfdx->dot(xpert);
+
+  // Freeze the accepted time steps for the difference approximation
+  int num_adaptive_steps = dirk->getNumTimeSteps();
+  dirk->setAdaptiveTimeStep(0);
+
+#ifdef TACS_USE_COMPLEX
+  const double dh = 1e-30;
+  xtmp->copyValues(x);
+  xtmp->axpy(TacsScalar(0.0, dh), xpert);
+  assembler->setDesignVars(xtmp);
+  dirk->integrate();
+  TacsScalar fd;
+  dirk->evalFunctions(&fd);
+  fd = TacsImagPart(fd) / dh;
+#else
+  const double dh = 1e-6;
+  TacsScalar f1, f2;
+  xtmp->copyValues(x);
+  xtmp->axpy(dh, xpert);
+  assembler->setDesignVars(xtmp);
+  dirk->integrate();
+  dirk->evalFunctions(&f1);
+
+  xtmp->copyValues(x);
+  xtmp->axpy(-dh, xpert);
+  assembler->setDesignVars(xtmp);
+  dirk->integrate();
+  dirk->evalFunctions(&f2);
+  TacsScalar fd = 0.5 * (f1 - f2) / dh;
+#endif  // TACS_USE_COMPLEX
+  assembler->setDesignVars(x);
+
+  double rel_err = fabs(TacsRealPart((pdfdx - fd) / fd));
+  int adj_fail = !(rel_err < 1e-5) ||
+                 (dirk->getNumTimeSteps() != num_adaptive_steps);
+  fail = fail || adj_fail;
+  if (rank == 0) {
+    printf("DIRK3 adaptive adjoint: %d steps\n", num_adaptive_steps);
+    printf("Adjoint: %25.15e FD: %25.15e rel err %10.3e %s\n",
+           TacsRealPart(pdfdx), TacsRealPart(fd), rel_err,
+           adj_fail ? "FAILED" : "");
+    printf("Adaptive time steps: %s\n", fail ? "FAILED" : "PASSED");
+  }
+
+  x->decref();
+  xpert->decref();
+  xtmp->decref();
+  dirk->decref();
+  func->decref();
+  ref->decref();
+  assembler->decref();
+
+  MPI_Finalize();
+  return fail;
+}
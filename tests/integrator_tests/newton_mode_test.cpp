@@ -0,0 +1,223 @@
+/*
+  Test that the Newton modes of the integrators converge to the same
+  states
+
+  A geometrically nonlinear plane stress cantilever vibrates freely
+  from a large initial velocity. The time history is computed with a
+  full Newton method that factors the Jacobian at every iteration, with
+  the lagged Jacobian that is only refreshed when the Newton iterations
+  stall, and with the Jacobian-free Newton-Krylov (JFNK) mode. The
+  states at every time step must agree to within the tolerance of the
+  Newton solves.
+*/
+
+#include "TACSCreator.h"
+#include "TACSElement2D.h"
+#include "TACSIntegrator.h"
+#include "TACSLinearElasticity.h"
+#include "TACSQuadBasis.h"
+
+/*
+  Create a plane stress model of a cantilever with one design variable
+  for each of the components. The initial velocity follows the
+  Euler-Bernoulli deflection w(x) of a tip-loaded beam, with the axial
+  component -(y - 1/2)*w'(x) of a plane section. The beam starts from
+  its undeformed shape so that the initial acceleration is zero.
+*/
+TACSAssembler *createAssembler(MPI_Comm comm, int nx, int ny, int ncomp) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSCreator *creator = new TACSCreator(comm, 2);
+  creator->incref();
+
+  if (rank == 0) {
+    int num_nodes = (nx + 1) * (ny + 1);
+    int num_elems = nx * ny;
+    int *ptr = new int[num_elems + 1];
+    int *conn = new int[4 * num_elems];
+    int *ids = new int[num_elems];
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int e = i + nx * j;
+        ptr[e] = 4 * e;
+        ids[e] = (ncomp * i) / nx;
+        conn[4 * e] = i + (nx + 1) * j;
+        conn[4 * e + 1] = i + 1 + (nx + 1) * j;
+        conn[4 * e + 2] = i + (nx + 1) * (j + 1);
+        conn[4 * e + 3] = i + 1 + (nx + 1) * (j + 1);
+      }
+    }
+    ptr[num_elems] = 4 * num_elems;
+    creator->setGlobalConnectivity(num_nodes, num_elems, ptr, conn, ids);
+
+    int *bcs = new int[ny + 1];
+    for (int j = 0; j < ny + 1; j++) {
+      bcs[j] = (nx + 1) * j;
+    }
+    creator->setBoundaryConditions(ny + 1, bcs);
+
+    TacsScalar *X = new TacsScalar[3 * num_nodes];
+    for (int j = 0; j < ny + 1; j++) {
+      for (int i = 0; i < nx + 1; i++) {
+        int n = i + (nx + 1) * j;
+        X[3 * n] = 4.0 * i / nx;
+        X[3 * n + 1] = (1.0 * j) / ny;
+        X[3 * n + 2] = 0.0;
+      }
+    }
+    creator->setNodes(X);
+
+    delete[] ptr;
+    delete[] conn;
+    delete[] ids;
+    delete[] bcs;
+    delete[] X;
+  }
+
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2.7, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TACSElementBasis *basis = new TACSLinearQuadBasis();
+  TACSElement **elems = new TACSElement *[ncomp];
+  for (int k = 0; k < ncomp; k++) {
+    TacsScalar t = 0.1 + 0.02 * k;
+    TACSPlaneStressConstitutive *con =
+        new TACSPlaneStressConstitutive(props, t, k, 0.01, 1.0);
+    TACSLinearElasticity2D *model =
+        new TACSLinearElasticity2D(con, TACS_NONLINEAR_STRAIN);
+    elems[k] = new TACSElement2D(model, basis);
+  }
+  creator->setElements(ncomp, elems);
+  delete[] elems;
+
+  TACSAssembler *assembler = creator->createTACS();
+  creator->decref();
+
+  // Set the initial velocity from the node locations
+  TACSBVec *X = assembler->createNodeVec();
+  TACSBVec *vel = assembler->createVec();
+  X->incref();
+  vel->incref();
+  assembler->getNodes(X);
+  TacsScalar *Xpts, *v;
+  int size = vel->getArray(&v);
+  X->getArray(&Xpts);
+  for (int i = 0; i < size / 2; i++) {
+    TacsScalar x = 0.25 * Xpts[3 * i];
+    TacsScalar y = Xpts[3 * i + 1] - 0.5;
+    v[2 * i] = -0.75 * y * x * (2.0 - x);
+    v[2 * i + 1] = x * x * (3.0 - x);
+  }
+  assembler->setBCs(vel);
+  assembler->setInitConditions(NULL, vel, NULL);
+  X->decref();
+  vel->decref();
+
+  return assembler;
+}
+
+/*
+  Compute the maximum relative difference between the states of two
+  integrations over all the time steps
+*/
+double maxStateError(TACSAssembler *assembler, TACSIntegrator *integrator,
+                     TACSIntegrator *ref) {
+  TACSBVec *diff = assembler->createVec();
+  diff->incref();
+
+  double err = 0.0;
+  for (int k = 1; k <= ref->getNumTimeSteps(); k++) {
+    TACSBVec *q, *qref;
+    integrator->getStates(k, &q, NULL, NULL);
+    ref->getStates(k, &qref, NULL, NULL);
+    diff->copyValues(q);
+    diff->axpy(-1.0, qref);
+    double e = TacsRealPart(diff->norm()) / TacsRealPart(qref->norm());
+    if (e > err) {
+      err = e;
+    }
+  }
+
+  diff->decref();
+  return err;
+}
+
+/*
+  Create an integrator with tight Newton tolerances
+*/
+TACSIntegrator *createIntegrator(TACSAssembler *assembler, int type,
+                                 double tinit, double tfinal, int num_steps) {
+  TACSIntegrator *integrator = NULL;
+  if (type == 0) {
+    integrator = new TACSBDFIntegrator(assembler, tinit, tfinal, num_steps, 2);
+  } else {
+    integrator = new TACSDIRKIntegrator(assembler, tinit, tfinal, num_steps, 2);
+  }
+  integrator->incref();
+  integrator->setPrintLevel(0);
+  integrator->setRelTol(1e-12);
+  integrator->setAbsTol(1e-14);
+  return integrator;
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSAssembler *assembler = createAssembler(comm, 8, 2, 3);
+  assembler->incref();
+
+  const double tinit = 0.0, tfinal = 0.5;
+  const int num_steps = 20;
+  const double tol = 1e-8;
+  int fail = 0;
+
+  const char *names[] = {"BDF2", "DIRK2"};
+  for (int type = 0; type < 2; type++) {
+    // Compute the states with a full Newton method
+    TACSIntegrator *ref =
+        createIntegrator(assembler, type, tinit, tfinal, num_steps);
+    int ref_fail = ref->integrate();
+
+    // Reuse the Jacobian until the Newton iterations stall
+    TACSIntegrator *lagged =
+        createIntegrator(assembler, type, tinit, tfinal, num_steps);
+    lagged->setAdaptiveJacobian(1, 0.5);
+    int lagged_fail = lagged->integrate();
+    double lagged_err = maxStateError(assembler, lagged, ref);
+
+    // Solve the Newton updates with Jacobian-vector products
+    TACSIntegrator *jfnk =
+        createIntegrator(assembler, type, tinit, tfinal, num_steps);
+    jfnk->setUseMatrixFree(1);
+    jfnk->setMatrixFreeTolerances(1e-6);
+    int jfnk_fail = jfnk->integrate();
+    double jfnk_err = maxStateError(assembler, jfnk, ref);
+
+    int lagged_test = (ref_fail || lagged_fail || !(lagged_err < tol));
+    int jfnk_test = (ref_fail || jfnk_fail || !(jfnk_err < tol));
+    fail = fail || lagged_test || jfnk_test;
+    if (rank == 0) {
+      printf("%-6s lagged Jacobian max rel err %10.3e %s\n", names[type],
+             lagged_err, lagged_test ? "FAILED" : "");
+      printf("%-6s JFNK            max rel err %10.3e %s\n", names[type],
+             jfnk_err, jfnk_test ? "FAILED" : "");
+    }
+
+    ref->decref();
+    lagged->decref();
+    jfnk->decref();
+  }
+
+  if (rank == 0) {
+    printf("Newton modes: %s\n", fail ? "FAILED" : "PASSED");
+  }
+
+  assembler->decref();
+
+  MPI_Finalize();
+  return fail;
+}
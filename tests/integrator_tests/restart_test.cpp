@@ -0,0 +1,266 @@
+/*
+  Test that an integration restarted from a checkpoint is bit-identical
+  to an uninterrupted integration
+
+  A checkpoint file is written every few steps of the forward and
+  adjoint integrations of a nonlinear cantilever. Fresh integrators,
+  standing in for a run that was interrupted after the last checkpoint,
+  read the file and complete the integrations. The state history, the
+  function values and the gradients of the restarted runs must match
+  the uninterrupted run bit for bit.
+*/
+
+#include "TACSCreator.h"
+#include "TACSElement2D.h"
+#include "TACSIntegrator.h"
+#include "TACSKSFailure.h"
+#include "TACSLinearElasticity.h"
+#include "TACSQuadBasis.h"
+
+/*
+  Create a plane stress model of a cantilever with one design variable
+  for each of the components. The initial velocity follows the
+  Euler-Bernoulli deflection w(x) of a tip-loaded beam, with the axial
+  component -(y - 1/2)*w'(x) of a plane section. The beam starts from
+  its undeformed shape so that the initial acceleration is zero.
+*/
+TACSAssembler *createAssembler(MPI_Comm comm, int nx, int ny, int ncomp) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSCreator *creator = new TACSCreator(comm, 2);
+  creator->incref();
+
+  if (rank == 0) {
+    int num_nodes = (nx + 1) * (ny + 1);
+    int num_elems = nx * ny;
+    int *ptr = new int[num_elems + 1];
+    int *conn = new int[4 * num_elems];
+    int *ids = new int[num_elems];
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int e = i + nx * j;
+        ptr[e] = 4 * e;
+        ids[e] = (ncomp * i) / nx;
+        conn[4 * e] = i + (nx + 1) * j;
+        conn[4 * e + 1] = i + 1 + (nx + 1) * j;
+        conn[4 * e + 2] = i + (nx + 1) * (j + 1);
+        conn[4 * e + 3] = i + 1 + (nx + 1) * (j + 1);
+      }
+    }
+    ptr[num_elems] = 4 * num_elems;
+    creator->setGlobalConnectivity(num_nodes, num_elems, ptr, conn, ids);
+
+    int *bcs = new int[ny + 1];
+    for (int j = 0; j < ny + 1; j++) {
+      bcs[j] = (nx + 1) * j;
+    }
+    creator->setBoundaryConditions(ny + 1, bcs);
+
+    TacsScalar *X = new TacsScalar[3 * num_nodes];
+    for (int j = 0; j < ny + 1; j++) {
+      for (int i = 0; i < nx + 1; i++) {
+        int n = i + (nx + 1) * j;
+        X[3 * n] = 4.0 * i / nx;
+        X[3 * n + 1] = (1.0 * j) / ny;
+        X[3 * n + 2] = 0.0;
+      }
+    }
+    creator->setNodes(X);
+
+    delete[] ptr;
+    delete[] conn;
+    delete[] ids;
+    delete[] bcs;
+    delete[] X;
+  }
+
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2.7, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TACSElementBasis *basis = new TACSLinearQuadBasis();
+  TACSElement **elems = new TACSElement *[ncomp];
+  for (int k = 0; k < ncomp; k++) {
+    TacsScalar t = 0.1 + 0.02 * k;
+    TACSPlaneStressConstitutive *con =
+        new TACSPlaneStressConstitutive(props, t, k, 0.01, 1.0);
+    TACSLinearElasticity2D *model =
+        new TACSLinearElasticity2D(con, TACS_NONLINEAR_STRAIN);
+    elems[k] = new TACSElement2D(model, basis);
+  }
+  creator->setElements(ncomp, elems);
+  delete[] elems;
+
+  TACSAssembler *assembler = creator->createTACS();
+  creator->decref();
+
+  // Set the initial velocity from the node locations
+  TACSBVec *X = assembler->createNodeVec();
+  TACSBVec *vel = assembler->createVec();
+  X->incref();
+  vel->incref();
+  assembler->getNodes(X);
+  TacsScalar *Xpts, *v;
+  int size = vel->getArray(&v);
+  X->getArray(&Xpts);
+  for (int i = 0; i < size / 2; i++) {
+    TacsScalar x = 0.25 * Xpts[3 * i];
+    TacsScalar y = Xpts[3 * i + 1] - 0.5;
+    v[2 * i] = -0.75 * y * x * (2.0 - x);
+    v[2 * i + 1] = x * x * (3.0 - x);
+  }
+  assembler->setBCs(vel);
+  assembler->setInitConditions(NULL, vel, NULL);
+  X->decref();
+  vel->decref();
+
+  return assembler;
+}
+
+/*
+  Check whether two vectors are bit-identical on all processors
+*/
+int isIdentical(TACSBVec *a, TACSBVec *b) {
+  TacsScalar *x, *y;
+  int size = a->getArray(&x);
+  b->getArray(&y);
+  int diff = (memcmp(x, y, size * sizeof(TacsScalar)) != 0);
+
+  int all_diff = 0;
+  MPI_Allreduce(&diff, &all_diff, 1, MPI_INT, MPI_MAX, a->getMPIComm());
+  return !all_diff;
+}
+
+/*
+  Count the time steps at which the states of two integrations differ
+*/
+int countDifferentSteps(TACSIntegrator *integrator, TACSIntegrator *ref) {
+  int count = 0;
+  for (int k = 0; k <= ref->getNumTimeSteps(); k++) {
+    TACSBVec *q, *qdot, *qddot, *qref, *qdotref, *qddotref;
+    integrator->getStates(k, &q, &qdot, &qddot);
+    ref->getStates(k, &qref, &qdotref, &qddotref);
+    if (!isIdentical(q, qref) || !isIdentical(qdot, qdotref) ||
+        !isIdentical(qddot, qddotref)) {
+      count++;
+    }
+  }
+  return count;
+}
+
+/*
+  Create an integrator with a KS failure function
+*/
+TACSIntegrator *createIntegrator(TACSAssembler *assembler, int type,
+                                 TACSFunction *func, double tinit,
+                                 double tfinal, int num_steps) {
+  TACSIntegrator *integrator = NULL;
+  if (type == 0) {
+    integrator = new TACSBDFIntegrator(assembler, tinit, tfinal, num_steps, 2);
+  } else {
+    integrator = new TACSDIRKIntegrator(assembler, tinit, tfinal, num_steps, 2);
+  }
+  integrator->incref();
+  integrator->setPrintLevel(0);
+  integrator->setFunctions(1, &func);
+  return integrator;
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSAssembler *assembler = createAssembler(comm, 8, 2, 3);
+  assembler->incref();
+
+  TACSFunction *func = new TACSKSFailure(assembler, 20.0);
+  func->incref();
+
+  const double tinit = 0.0, tfinal = 0.5;
+  const int num_steps = 20, checkpoint_freq = 6;
+  const char *prefix = "./";
+  const char *fname = "./checkpoint.bin";
+  int fail = 0;
+
+  const char *names[] = {"BDF2", "DIRK2"};
+  for (int type = 0; type < 2; type++) {
+    // Integrate forward and backward without interruption
+    TACSIntegrator *ref =
+        createIntegrator(assembler, type, func, tinit, tfinal, num_steps);
+    ref->integrate();
+    TacsScalar fref;
+    ref->evalFunctions(&fref);
+    ref->integrateAdjoint();
+    TACSBVec *dfdx_ref;
+    ref->getGradient(0, &dfdx_ref);
+
+    // Write checkpoints during the forward integration
+    TACSIntegrator *first =
+        createIntegrator(assembler, type, func, tinit, tfinal, num_steps);
+    first->setOutputPrefix(prefix);
+    first->setCheckpointFrequency(checkpoint_freq);
+    first->integrate();
+
+    // Restart the forward integration from the last forward checkpoint
+    // and write checkpoints during the adjoint integration
+    TACSIntegrator *second =
+        createIntegrator(assembler, type, func, tinit, tfinal, num_steps);
+    second->setOutputPrefix(prefix);
+    second->setCheckpointFrequency(checkpoint_freq);
+    int fwd_step, fwd_adjoint;
+    int read_fail = second->readCheckpoint(fname, &fwd_step, &fwd_adjoint);
+    second->integrate();
+    int fwd_diff = countDifferentSteps(second, ref);
+    TacsScalar fval;
+    second->evalFunctions(&fval);
+    second->integrateAdjoint();
+
+    // Restart the adjoint integration from the last adjoint checkpoint
+    TACSIntegrator *third =
+        createIntegrator(assembler, type, func, tinit, tfinal, num_steps);
+    int adj_step, adj_adjoint;
+    read_fail =
+        third->readCheckpoint(fname, &adj_step, &adj_adjoint) || read_fail;
+    int adj_diff = countDifferentSteps(third, ref);
+    TacsScalar fadj;
+    third->evalFunctions(&fadj);
+    third->integrateAdjoint();
+    TACSBVec *dfdx;
+    third->getGradient(0, &dfdx);
+
+    int grad_same = isIdentical(dfdx, dfdx_ref);
+    int test_fail =
+        (read_fail || fwd_step != 18 || fwd_adjoint || adj_step != 6 ||
+         !adj_adjoint || fwd_diff != 0 || adj_diff != 0 ||
+         memcmp(&fval, &fref, sizeof(TacsScalar)) != 0 ||
+         memcmp(&fadj, &fref, sizeof(TacsScalar)) != 0 ||
+         !grad_same);
+    fail = fail || test_fail;
+    if (rank == 0) {
+      printf("%-6s forward restart from step %2d: %d steps differ\n",
+             names[type], fwd_step, fwd_diff);
+      printf("%-6s adjoint restart from step %2d: gradient %s %s\n",
+             names[type], adj_step,
+             grad_same ? "identical" : "differs",
+             test_fail ? "FAILED" : "");
+    }
+
+    ref->decref();
+    first->decref();
+    second->decref();
+    third->decref();
+  }
+
+  if (rank == 0) {
+    remove(fname);
+    printf("Checkpoint restart: %s\n", fail ? "FAILED" : "PASSED");
+  }
+
+  func->decref();
+  assembler->decref();
+
+  MPI_Finalize();
+  return fail;
+}
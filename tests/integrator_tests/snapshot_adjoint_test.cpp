@@ -0,0 +1,279 @@
+/*
+  Test that the adjoint computed from snapshots of the state history
+  matches the adjoint computed from the full state history
+
+  A geometrically nonlinear plane stress cantilever vibrates under a
+  time-varying tip load. The BDF integrators store only a few snapshots
+  of the states and recompute the remaining steps from the nearest
+  snapshot during the adjoint. The loads are set in one vector that is
+  reused at every step. The states, the function value and the
+  gradients must match an integration that stores every step, bit for
+  bit.
+*/
+
+#include "TACSCreator.h"
+#include "TACSElement2D.h"
+#include "TACSIntegrator.h"
+#include "TACSKSFailure.h"
+#include "TACSLinearElasticity.h"
+#include "TACSQuadBasis.h"
+
+/*
+  Create a plane stress model of a cantilever with one design variable
+  for each of the components. The initial velocity follows the
+  Euler-Bernoulli deflection w(x) of a tip-loaded beam, with the axial
+  component -(y - 1/2)*w'(x) of a plane section. The beam starts from
+  its undeformed shape so that the initial acceleration is zero.
+*/
+TACSAssembler *createAssembler(MPI_Comm comm, int nx, int ny, int ncomp) {
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSCreator *creator = new TACSCreator(comm, 2);
+  creator->incref();
+
+  if (rank == 0) {
+    int num_nodes = (nx + 1) * (ny + 1);
+    int num_elems = nx * ny;
+    int *ptr = new int[num_elems + 1];
+    int *conn = new int[4 * num_elems];
+    int *ids = new int[num_elems];
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int e = i + nx * j;
+        ptr[e] = 4 * e;
+        ids[e] = (ncomp * i) / nx;
+        conn[4 * e] = i + (nx + 1) * j;
+        conn[4 * e + 1] = i + 1 + (nx + 1) * j;
+        conn[4 * e + 2] = i + (nx + 1) * (j + 1);
+        conn[4 * e + 3] = i + 1 + (nx + 1) * (j + 1);
+      }
+    }
+    ptr[num_elems] = 4 * num_elems;
+    creator->setGlobalConnectivity(num_nodes, num_elems, ptr, conn, ids);
+
+    int *bcs = new int[ny + 1];
+    for (int j = 0; j < ny + 1; j++) {
+      bcs[j] = (nx + 1) * j;
+    }
+    creator->setBoundaryConditions(ny + 1, bcs);
+
+    TacsScalar *X = new TacsScalar[3 * num_nodes];
+    for (int j = 0; j < ny + 1; j++) {
+      for (int i = 0; i < nx + 1; i++) {
+        int n = i + (nx + 1) * j;
+        X[3 * n] = 4.0 * i / nx;
+        X[3 * n + 1] = (1.0 * j) / ny;
+        X[3 * n + 2] = 0.0;
+      }
+    }
+    creator->setNodes(X);
+
+    delete[] ptr;
+    delete[] conn;
+    delete[] ids;
+    delete[] bcs;
+    delete[] X;
+  }
+
+  TACSMaterialProperties *props =
+      new TACSMaterialProperties(2.7, 900.0, 70e3, 0.3, 350.0, 0.0, 0.0);
+  TACSElementBasis *basis = new TACSLinearQuadBasis();
+  TACSElement **elems = new TACSElement *[ncomp];
+  for (int k = 0; k < ncomp; k++) {
+    TacsScalar t = 0.1 + 0.02 * k;
+    TACSPlaneStressConstitutive *con =
+        new TACSPlaneStressConstitutive(props, t, k, 0.01, 1.0);
+    TACSLinearElasticity2D *model =
+        new TACSLinearElasticity2D(con, TACS_NONLINEAR_STRAIN);
+    elems[k] = new TACSElement2D(model, basis);
+  }
+  creator->setElements(ncomp, elems);
+  delete[] elems;
+
+  TACSAssembler *assembler = creator->createTACS();
+  creator->decref();
+
+  // Set the initial velocity from the node locations
+  TACSBVec *X = assembler->createNodeVec();
+  TACSBVec *vel = assembler->createVec();
+  X->incref();
+  vel->incref();
+  assembler->getNodes(X);
+  TacsScalar *Xpts, *v;
+  int size = vel->getArray(&v);
+  X->getArray(&Xpts);
+  for (int i = 0; i < size / 2; i++) {
+    TacsScalar x = 0.25 * Xpts[3 * i];
+    TacsScalar y = Xpts[3 * i + 1] - 0.5;
+    v[2 * i] = -0.75 * y * x * (2.0 - x);
+    v[2 * i + 1] = x * x * (3.0 - x);
+  }
+  assembler->setBCs(vel);
+  assembler->setInitConditions(NULL, vel, NULL);
+  X->decref();
+  vel->decref();
+
+  return assembler;
+}
+
+/*
+  Check whether two vectors are bit-identical on all processors
+*/
+int isIdentical(TACSBVec *a, TACSBVec *b) {
+  TacsScalar *x, *y;
+  int size = a->getArray(&x);
+  b->getArray(&y);
+  int diff = (memcmp(x, y, size * sizeof(TacsScalar)) != 0);
+
+  int all_diff = 0;
+  MPI_Allreduce(&diff, &all_diff, 1, MPI_INT, MPI_MAX, a->getMPIComm());
+  return !all_diff;
+}
+
+/*
+  Count the time steps at which the states of two integrations differ
+*/
+int countDifferentSteps(TACSIntegrator *integrator, TACSIntegrator *ref) {
+  int count = 0;
+  for (int k = 0; k <= ref->getNumTimeSteps(); k++) {
+    TACSBVec *q, *qdot, *qddot, *qref, *qdotref, *qddotref;
+    integrator->getStates(k, &q, &qdot, &qddot);
+    ref->getStates(k, &qref, &qdotref, &qddotref);
+    if (!isIdentical(q, qref) || !isIdentical(qdot, qdotref) ||
+        !isIdentical(qddot, qddotref)) {
+      count++;
+    }
+  }
+  return count;
+}
+
+/*
+  Set the tip load at the given time
+*/
+void setTipLoad(TACSBVec *X, TACSBVec *forces, double t) {
+  TacsScalar *Xpts, *f;
+  int size = forces->getArray(&f);
+  X->getArray(&Xpts);
+  for (int i = 0; i < size / 2; i++) {
+    f[2 * i] = 0.0;
+    f[2 * i + 1] = 0.0;
+    if (TacsRealPart(Xpts[3 * i]) > 3.999) {
+      f[2 * i + 1] = 2.0 * sin(4.0 * M_PI * t);
+    }
+  }
+}
+
+/*
+  Integrate forward and backward in time under the tip load and return
+  the function value
+*/
+TacsScalar integrateWithLoads(TACSIntegrator *integrator, TACSBVec *X,
+                              TACSBVec *forces, double tinit, double tfinal,
+                              int *fail) {
+  int num_steps = integrator->getNumTimeSteps();
+  for (int k = 0; k <= num_steps; k++) {
+    setTipLoad(X, forces, tinit + (tfinal - tinit) * k / num_steps);
+    *fail = integrator->iterate(k, forces) || *fail;
+  }
+
+  TacsScalar fval;
+  integrator->evalFunctions(&fval);
+  integrator->integrateAdjoint();
+  return fval;
+}
+
+/*
+  Create a BDF integrator with a KS failure function
+*/
+TACSIntegrator *createIntegrator(TACSAssembler *assembler, int order,
+                                 TACSFunction *func, double tinit,
+                                 double tfinal, int num_steps) {
+  TACSIntegrator *integrator =
+      new TACSBDFIntegrator(assembler, tinit, tfinal, num_steps, order);
+  integrator->incref();
+  integrator->setPrintLevel(0);
+  integrator->setRelTol(1e-12);
+  integrator->setAbsTol(1e-14);
+  integrator->setFunctions(1, &func);
+  return integrator;
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  TACSAssembler *assembler = createAssembler(comm, 8, 2, 3);
+  assembler->incref();
+
+  TACSKSFailure *ks = new TACSKSFailure(assembler, 20.0);
+  TACSFunction *func = ks;
+  func->incref();
+
+  TACSBVec *X = assembler->createNodeVec();
+  TACSBVec *forces = assembler->createVec();
+  X->incref();
+  forces->incref();
+  assembler->getNodes(X);
+
+  const double tinit = 0.0, tfinal = 0.5;
+  const int num_steps = 30;
+  int fail = 0;
+
+  const int num_snapshots[] = {1, 2, 5};
+  for (int order = 2; order <= 3; order++) {
+    // Store the full state history
+    TACSIntegrator *ref =
+        createIntegrator(assembler, order, func, tinit, tfinal, num_steps);
+    int ref_fail = 0;
+    TacsScalar fref =
+        integrateWithLoads(ref, X, forces, tinit, tfinal, &ref_fail);
+    TACSBVec *dfdx_ref, *dfdXpt_ref;
+    ref->getGradient(0, &dfdx_ref);
+    ref->getXptGradient(0, &dfdXpt_ref);
+    fail = fail || ref_fail;
+
+    for (int i = 0; i < 3; i++) {
+      // Store only a few snapshots and recompute the remaining steps
+      TACSIntegrator *snap =
+          createIntegrator(assembler, order, func, tinit, tfinal, num_steps);
+      snap->setNumSnapshots(num_snapshots[i]);
+      int snap_fail = 0;
+      TacsScalar fval =
+          integrateWithLoads(snap, X, forces, tinit, tfinal, &snap_fail);
+      TACSBVec *dfdx, *dfdXpt;
+      snap->getGradient(0, &dfdx);
+      snap->getXptGradient(0, &dfdXpt);
+
+      int grad_same = isIdentical(dfdx, dfdx_ref);
+      int xpt_same = isIdentical(dfdXpt, dfdXpt_ref);
+      int num_diff = countDifferentSteps(snap, ref);
+      int test_fail = (snap_fail || num_diff != 0 || !grad_same || !xpt_same ||
+                       memcmp(&fval, &fref, sizeof(TacsScalar)) != 0);
+      fail = fail || test_fail;
+      if (rank == 0) {
+        printf("BDF%d %d snapshots: %d steps differ, dfdx %s, dfdXpt %s %s\n",
+               order, num_snapshots[i], num_diff,
+               grad_same ? "identical" : "differs",
+               xpt_same ? "identical" : "differs", test_fail ? "FAILED" : "");
+      }
+      snap->decref();
+    }
+    ref->decref();
+  }
+
+  if (rank == 0) {
+    printf("Snapshot adjoint: %s\n", fail ? "FAILED" : "PASSED");
+  }
+
+  X->decref();
+  forces->decref();
+  func->decref();
+  assembler->decref();
+
+  MPI_Finalize();
+  return fail;
+}
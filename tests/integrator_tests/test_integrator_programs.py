@@ -0,0 +1,31 @@
+"""
+Run the compiled C++ tests in this directory.
+
+The programs are built into bin/ by running "make" (or "make complex") in
+this directory after the TACS library has been built. See
+compiled_program_base_test.py for how they are run.
+"""
+
+import os
+import sys
+
+base_dir = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(base_dir, "..", "integration_tests"))
+
+from compiled_program_base_test import ProgramTestCase
+
+
+class ProgramTest(ProgramTestCase):
+    program_dir = base_dir
+
+    def test_restart(self):
+        self.run_program("restart_test", 2)
+
+    def test_snapshot_adjoint(self):
+        self.run_program("snapshot_adjoint_test", 2)
+
+    def test_newton_mode(self):
+        self.run_program("newton_mode_test", 2)
+
+    def test_adaptive_step(self):
+        self.run_program("adaptive_step_test", 2)
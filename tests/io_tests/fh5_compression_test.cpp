@@ -0,0 +1,213 @@
+/*
+  Round-trip test for the compressed zone storage in the F5 format
+
+  Integer and floating point zones are written from every processor
+  with each of the storage options and read back on the root
+  processor. Lossless storage must reproduce the data exactly, half
+  precision storage must agree to the precision of the format
+  relative to the range of each column and quantized storage must
+  agree to within the tolerance times the range of each column. The
+  last column has the magnitude of stresses in Pa, which lies far
+  outside the range of half precision values. The middle column
+  contains NaN and infinite values, including a NaN in the first row,
+  which must be excluded from the range and stored exactly.
+*/
+
+#include <math.h>
+
+#include "TACSFH5.h"
+
+// The storage options that are tested
+static const int NUM_OPTIONS = 4;
+static const TACSFH5File::FH5Compression options[] = {
+    TACSFH5File::FH5_NO_COMPRESSION, TACSFH5File::FH5_LOSSLESS,
+    TACSFH5File::FH5_HALF_PRECISION, TACSFH5File::FH5_QUANTIZED};
+static const char *option_names[] = {"none", "lossless", "half", "quantized"};
+
+/*
+  Generate the data that is stored on a processor. The integer data
+  has long runs that the codec can compress, while the double data
+  varies smoothly with a different range in each column. The last
+  column is offset from zero by more than its range and the middle
+  column contains non-finite values.
+*/
+void generateData(int offset, int rows, int cols, int *idata,
+                  double *ddata) {
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      int row = offset + i;
+      idata[cols * i + j] = (row / 7) * cols + j;
+      if (j == cols - 1) {
+        ddata[cols * i + j] = 2.5e8 + 1.0e8 * sin(0.002 * row);
+      } else if (j == cols / 2 && row % 97 == 0) {
+        ddata[cols * i + j] = NAN;
+      } else if (j == cols / 2 && row % 97 == 31) {
+        ddata[cols * i + j] = INFINITY;
+      } else if (j == cols / 2 && row % 97 == 62) {
+        ddata[cols * i + j] = -INFINITY;
+      } else {
+        ddata[cols * i + j] = pow(10.0, j - 1) * sin(0.01 * row + j) +
+                              0.5 * j * cos(0.003 * row);
+      }
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  const int cols = 5;
+  const int local_rows = 1000 + 37 * rank;
+  const double tol = 1e-4;
+  const char *file_name = "fh5_compression_test.f5";
+
+  // Find the offset of the rows on this processor
+  int offset = 0, total_rows = 0;
+  MPI_Exscan(&local_rows, &offset, 1, MPI_INT, MPI_SUM, comm);
+  MPI_Allreduce(&local_rows, &total_rows, 1, MPI_INT, MPI_SUM, comm);
+  if (rank == 0) {
+    offset = 0;
+  }
+
+  int *idata = new int[cols * local_rows];
+  double *ddata = new double[cols * local_rows];
+  generateData(offset, local_rows, cols, idata, ddata);
+
+  // Write an integer and a double zone with each option
+  TACSFH5File *file = new TACSFH5File(comm);
+  file->incref();
+  char comp_name[] = "component";
+  char *comp_names[] = {comp_name};
+  file->createFile(file_name, 1, comp_names);
+  for (int k = 0; k < NUM_OPTIONS; k++) {
+    char zone_name[64], var_names[] = "a,b,c,d,e";
+    file->setCompression(options[k], tol);
+    snprintf(zone_name, sizeof(zone_name), "int_%s", option_names[k]);
+    file->writeZoneData(zone_name, var_names, TACSFH5File::FH5_INT,
+                        local_rows, cols, idata);
+    snprintf(zone_name, sizeof(zone_name), "double_%s", option_names[k]);
+    file->writeZoneData(zone_name, var_names, TACSFH5File::FH5_DOUBLE,
+                        local_rows, cols, ddata);
+  }
+  file->close();
+  file->decref();
+
+  delete[] idata;
+  delete[] ddata;
+
+  // Read the data back on the root processor and compare
+  int fail = 0;
+  if (rank == 0) {
+    int *iexact = new int[cols * total_rows];
+    double *dexact = new double[cols * total_rows];
+    generateData(0, total_rows, cols, iexact, dexact);
+
+    // Find the range of the finite values in each column
+    double range[cols];
+    for (int j = 0; j < cols; j++) {
+      double low = INFINITY, high = -INFINITY;
+      for (int i = 0; i < total_rows; i++) {
+        if (isfinite(dexact[cols * i + j])) {
+          low = fmin(low, dexact[cols * i + j]);
+          high = fmax(high, dexact[cols * i + j]);
+        }
+      }
+      range[j] = high - low;
+    }
+
+    TACSFH5File *loader = new TACSFH5File(MPI_COMM_SELF);
+    loader->incref();
+    if (loader->openFile(file_name)) {
+      fprintf(stderr, "Failed to open %s\n", file_name);
+      fail = 1;
+    }
+
+    int num_zones = 0;
+    loader->firstZone();
+    for (int iter = 0; !fail && iter < 2 * NUM_OPTIONS; iter++) {
+      const char *zone_name, *var_names;
+      TACSFH5File::FH5DataType dtype;
+      int dim1, dim2;
+      void *data;
+      if (!loader->getZoneData(&zone_name, &var_names, &dtype, &dim1, &dim2,
+                               &data)) {
+        fprintf(stderr, "Failed to read zone %d\n", iter);
+        fail = 1;
+        break;
+      }
+      num_zones++;
+
+      if (dim1 != total_rows || dim2 != cols) {
+        fprintf(stderr, "%s: wrong dimensions %d x %d\n", zone_name, dim1,
+                dim2);
+        fail = 1;
+      } else if (dtype == TACSFH5File::FH5_INT) {
+        int *values = (int *)data;
+        for (int i = 0; i < cols * total_rows; i++) {
+          if (values[i] != iexact[i]) {
+            fprintf(stderr, "%s: integer data does not match\n", zone_name);
+            fail = 1;
+            break;
+          }
+        }
+        delete[] values;
+      } else {
+        // Set the error bound for the option stored in this zone
+        int k = iter / 2;
+        double *values = (double *)data;
+        double max_err = 0.0;
+        for (int i = 0; i < total_rows; i++) {
+          for (int j = 0; j < cols; j++) {
+            double value = values[cols * i + j];
+            double exact = dexact[cols * i + j];
+            if (!isfinite(exact)) {
+              // Non-finite values must be stored exactly
+              if (isnan(exact) ? !isnan(value) : value != exact) {
+                fail = 1;
+              }
+              continue;
+            }
+            double err = fabs(value - exact);
+            double bound = 0.0;
+            if (options[k] == TACSFH5File::FH5_HALF_PRECISION) {
+              bound = 1e-3 * range[j];
+            } else if (options[k] == TACSFH5File::FH5_QUANTIZED) {
+              bound = tol * range[j];
+            }
+            if (!(err <= bound)) {
+              fail = 1;
+            }
+            max_err = fmax(max_err, err);
+          }
+        }
+        printf("%-18s max error %10.3e %s\n", zone_name, max_err,
+               fail ? "FAILED" : "");
+        delete[] values;
+      }
+
+      if (iter < 2 * NUM_OPTIONS - 1 && !loader->nextZone()) {
+        fprintf(stderr, "Missing zones after %s\n", zone_name);
+        fail = 1;
+      }
+    }
+    if (num_zones != 2 * NUM_OPTIONS) {
+      fail = 1;
+    }
+
+    loader->close();
+    loader->decref();
+    delete[] iexact;
+    delete[] dexact;
+
+    printf("FH5 compression round-trip: %s\n", fail ? "FAILED" : "PASSED");
+  }
+
+  MPI_Bcast(&fail, 1, MPI_INT, 0, comm);
+  MPI_Finalize();
+  return fail;
+}